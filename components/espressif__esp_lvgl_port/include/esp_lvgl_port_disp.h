@@ -58,6 +58,7 @@ typedef struct {
     struct {
         unsigned int buff_dma : 1;    /*!< Allocated LVGL buffer will be DMA capable */
         unsigned int buff_spiram : 1; /*!< Allocated LVGL buffer will be in PSRAM */
+        unsigned int buff_internal : 1; /*!< Allocated LVGL buffer will be in internal RAM */
         unsigned int sw_rotate : 1;   /*!< Use software rotation (slower) or PPA if available */
 #if LVGL_VERSION_MAJOR >= 9
         unsigned int swap_bytes : 1; /*!< Swap bytes in RGB656 (16-bit) color format before send to LCD driver */
@@ -137,6 +138,54 @@ lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg,
  */
 esp_err_t lvgl_port_remove_disp(lv_display_t *disp);
 
+#if LVGL_VERSION_MAJOR >= 9
+/**
+ * @brief Draw buffer layout of a display
+ */
+typedef struct {
+    uint32_t buffer_size; /*!< Size of one draw buffer in pixels */
+    bool double_buffer;   /*!< True, if two draw buffers are used */
+    uint32_t caps;        /*!< Heap capabilities the buffers are allocated with (MALLOC_CAP_*) */
+} lvgl_port_disp_buffers_t;
+
+/**
+ * @brief Get the draw buffer layout of a display
+ *
+ * @return
+ *      - ESP_OK                    on success
+ *      - ESP_ERR_INVALID_ARG       if a parameter is NULL
+ */
+esp_err_t lvgl_port_disp_get_buffers(lv_display_t *disp, lvgl_port_disp_buffers_t *buffers);
+
+/**
+ * @brief Replace the draw buffers of a display
+ *
+ * @note Only for partial render mode with buffers allocated by this port (not full refresh, direct mode,
+ *       avoid tearing or monochrome). Call it from the LVGL task or with the port locked. It waits for the
+ *       ongoing flush, allocates the new buffers (and the SW rotation buffer) and only then frees the old
+ *       ones, so on failure the display keeps drawing with its old buffers.
+ *
+ * @return
+ *      - ESP_OK                    on success
+ *      - ESP_ERR_INVALID_ARG       if a parameter is wrong or the buffer is smaller than one line
+ *      - ESP_ERR_NOT_SUPPORTED     if the display doesn't render in partial mode into its own buffers
+ *      - ESP_ERR_TIMEOUT           if the ongoing flush did not finish
+ *      - ESP_ERR_NO_MEM            if the new buffers could not be allocated
+ */
+esp_err_t lvgl_port_disp_set_buffers(lv_display_t *disp, const lvgl_port_disp_buffers_t *buffers);
+
+/**
+ * @brief Wait until the last buffer handed to the panel has been transferred
+ *
+ * @note With double buffering lv_refr_now() returns while the last band is still being copied.
+ *
+ * @return
+ *      - ESP_OK                    on success
+ *      - ESP_ERR_TIMEOUT           if the flush did not finish in time
+ */
+esp_err_t lvgl_port_disp_wait_flush(lv_display_t *disp, uint32_t timeout_ms);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
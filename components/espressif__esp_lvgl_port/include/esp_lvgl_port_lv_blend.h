@@ -22,20 +22,46 @@ extern "C" {
  *      DEFINES
  *********************/
 
+/*
+ * LVGL 9.2 renamed the blend descriptors (_lv_draw_sw_blend_fill_dsc_t became lv_draw_sw_blend_fill_dsc_t)
+ * but kept their fields, so the hooks read the fields by name and never spell the type: the same header
+ * works from LVGL 9.1 on.
+ */
+#define ESP_LV_BLEND_FILL_DSC(dsc) (&(asm_dsc_t) {   \
+        .dst_buf    = (dsc)->dest_buf,              \
+        .dst_w      = (dsc)->dest_w,                \
+        .dst_h      = (dsc)->dest_h,                \
+        .dst_stride = (dsc)->dest_stride,           \
+        .src_buf    = &(dsc)->color,                \
+    })
+
+#define ESP_LV_BLEND_IMAGE_DSC(dsc) (&(asm_dsc_t) {  \
+        .dst_buf    = (dsc)->dest_buf,              \
+        .dst_w      = (dsc)->dest_w,                \
+        .dst_h      = (dsc)->dest_h,                \
+        .dst_stride = (dsc)->dest_stride,           \
+        .src_buf    = (dsc)->src_buf,               \
+        .src_stride = (dsc)->src_stride,            \
+    })
+
 #ifndef LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888
-#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888(dsc) _lv_color_blend_to_argb8888_esp(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888(dsc) \
+    ((lv_result_t)lv_color_blend_to_argb8888_esp(ESP_LV_BLEND_FILL_DSC(dsc)))
 #endif
 
 #ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565
-#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) _lv_color_blend_to_rgb565_esp(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) \
+    ((lv_result_t)lv_color_blend_to_rgb565_esp(ESP_LV_BLEND_FILL_DSC(dsc)))
 #endif
 
 #ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB888
-#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888(dsc, dest_px_size) _lv_color_blend_to_rgb888_esp(dsc, dest_px_size)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888(dsc, dest_px_size) \
+    ((dest_px_size) == 3 ? (lv_result_t)lv_color_blend_to_rgb888_esp(ESP_LV_BLEND_FILL_DSC(dsc)) : LV_RESULT_INVALID)
 #endif
 
 #ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565
-#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc) _lv_rgb565_blend_normal_to_rgb565_esp(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc) \
+    ((lv_result_t)lv_rgb565_blend_normal_to_rgb565_esp(ESP_LV_BLEND_IMAGE_DSC(dsc)))
 #endif
 
 /**********************
@@ -59,67 +85,10 @@ typedef struct {
  **********************/
 
 extern int lv_color_blend_to_argb8888_esp(asm_dsc_t *asm_dsc);
-
-static inline lv_result_t _lv_color_blend_to_argb8888_esp(_lv_draw_sw_blend_fill_dsc_t *dsc)
-{
-    asm_dsc_t asm_dsc = {
-        .dst_buf    = dsc->dest_buf,
-        .dst_w      = dsc->dest_w,
-        .dst_h      = dsc->dest_h,
-        .dst_stride = dsc->dest_stride,
-        .src_buf    = &dsc->color,
-    };
-
-    return lv_color_blend_to_argb8888_esp(&asm_dsc);
-}
-
 extern int lv_color_blend_to_rgb565_esp(asm_dsc_t *asm_dsc);
-
-static inline lv_result_t _lv_color_blend_to_rgb565_esp(_lv_draw_sw_blend_fill_dsc_t *dsc)
-{
-    asm_dsc_t asm_dsc = {
-        .dst_buf    = dsc->dest_buf,
-        .dst_w      = dsc->dest_w,
-        .dst_h      = dsc->dest_h,
-        .dst_stride = dsc->dest_stride,
-        .src_buf    = &dsc->color,
-    };
-
-    return lv_color_blend_to_rgb565_esp(&asm_dsc);
-}
-
 extern int lv_color_blend_to_rgb888_esp(asm_dsc_t *asm_dsc);
-
-static inline lv_result_t _lv_color_blend_to_rgb888_esp(_lv_draw_sw_blend_fill_dsc_t *dsc, uint32_t dest_px_size)
-{
-    if (dest_px_size != 3) {
-        return LV_RESULT_INVALID;
-    }
-    asm_dsc_t asm_dsc = {
-        .dst_buf    = dsc->dest_buf,
-        .dst_w      = dsc->dest_w,
-        .dst_h      = dsc->dest_h,
-        .dst_stride = dsc->dest_stride,
-        .src_buf    = &dsc->color,
-    };
-
-    return lv_color_blend_to_rgb888_esp(&asm_dsc);
-}
-
 extern int lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc_t *asm_dsc);
 
-static inline lv_result_t _lv_rgb565_blend_normal_to_rgb565_esp(_lv_draw_sw_blend_image_dsc_t *dsc)
-{
-    asm_dsc_t asm_dsc = {.dst_buf    = dsc->dest_buf,
-                         .dst_w      = dsc->dest_w,
-                         .dst_h      = dsc->dest_h,
-                         .dst_stride = dsc->dest_stride,
-                         .src_buf    = dsc->src_buf,
-                         .src_stride = dsc->src_stride};
-
-    return lv_rgb565_blend_normal_to_rgb565_esp(&asm_dsc);
-}
-
 #endif  // CONFIG_LV_DRAW_SW_ASM_CUSTOM
 
 #ifdef __cplusplus
@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief ESP LVGL port software rotation kernels
+ *
+ * Cache-blocked replacements for lv_draw_sw_rotate() on the flush path, with the RGB565 byte swap
+ * done in the same pass. Output is bit-exact with lv_draw_sw_rotate() followed by
+ * lv_draw_sw_rgb565_swap(). No LVGL or ESP-IDF dependencies, so they also build on the host
+ * (test_apps/rotate).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Side of the square tiles, in pixels
+ *
+ * 32x32 RGB565 tiles keep both the source rows and the destination rows of a tile in cache (2 kB each).
+ */
+#ifndef LVGL_PORT_ROTATE_TILE
+#define LVGL_PORT_ROTATE_TILE (32)
+#endif
+
+/**
+ * @brief Rotate an RGB565 image, optionally swapping the bytes of every pixel
+ *
+ * Same geometry and arguments as lv_draw_sw_rotate(): width and height are the source size, strides are in
+ * bytes and angle is 90, 180 or 270 (LV_DISPLAY_ROTATION_90/180/270).
+ *
+ * @return
+ *      - true  the image was rotated
+ *      - false angle is not supported, nothing was written
+ */
+bool lvgl_port_rotate_rgb565(const uint16_t *src, uint16_t *dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride, uint16_t angle, bool swap_bytes);
+
+/**
+ * @brief Rotate an RGB888 image
+ *
+ * Same as lvgl_port_rotate_rgb565(), without byte swap (only RGB565 can be swapped).
+ */
+bool lvgl_port_rotate_rgb888(const uint8_t *src, uint8_t *dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride, uint16_t angle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -14,13 +14,16 @@
 #include "freertos/semphr.h"
 #include "esp_heap_caps.h"
 #include "esp_idf_version.h"
+#include "esp_timer.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lvgl_port.h"
 #include "esp_lvgl_port_priv.h"
+#include "esp_lvgl_port_rotate.h"
 #include "driver/ppa.h"
 #include "esp_heap_caps.h"
 #include "esp_private/esp_cache_private.h"
+#include "src/display/lv_display_private.h"
 
 #define ALIGN_UP_BY(num, align) (((num) + ((align)-1)) & ~((align)-1))
 #define BLOCK_SIZE_SMALL        (32)
@@ -59,6 +62,8 @@ typedef struct {
     esp_lcd_panel_handle_t control_handle; /* LCD panel control handle */
     lvgl_port_rotation_cfg_t rotation;     /* Default values of the screen rotation */
     lv_color_t* draw_buffs[3];             /* Display draw buffers */
+    uint32_t buffer_size;                  /* Size of one draw buffer in pixels */
+    uint32_t buff_caps;                    /* Heap capabilities of the draw buffers */
     uint8_t* oled_buffer;
     lv_display_t* disp_drv; /* LVGL display driver */
     lv_display_rotation_t current_rotation;
@@ -257,6 +262,84 @@ void lvgl_port_flush_ready(lv_display_t* disp)
     lv_disp_flush_ready(disp);
 }
 
+esp_err_t lvgl_port_disp_get_buffers(lv_display_t* disp, lvgl_port_disp_buffers_t* buffers)
+{
+    ESP_RETURN_ON_FALSE(disp && buffers, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    lvgl_port_display_ctx_t* disp_ctx = (lvgl_port_display_ctx_t*)lv_display_get_driver_data(disp);
+    ESP_RETURN_ON_FALSE(disp_ctx, ESP_ERR_INVALID_ARG, TAG, "Display not added by the port");
+
+    buffers->buffer_size   = disp_ctx->buffer_size;
+    buffers->double_buffer = disp_ctx->draw_buffs[1] != NULL;
+    buffers->caps          = disp_ctx->buff_caps;
+    return ESP_OK;
+}
+
+esp_err_t lvgl_port_disp_wait_flush(lv_display_t* disp, uint32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(disp, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    /* Cleared by the transfer done callback; LVGL itself spins on it the same way */
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (disp->flushing) {
+        if (esp_timer_get_time() > deadline) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t lvgl_port_disp_set_buffers(lv_display_t* disp, const lvgl_port_disp_buffers_t* buffers)
+{
+    esp_err_t ret      = ESP_OK;
+    lv_color_t* buf1   = NULL;
+    lv_color_t* buf2   = NULL;
+    lv_color_t* rotbuf = NULL;
+    ESP_RETURN_ON_FALSE(disp && buffers, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    lvgl_port_display_ctx_t* disp_ctx = (lvgl_port_display_ctx_t*)lv_display_get_driver_data(disp);
+    ESP_RETURN_ON_FALSE(disp_ctx, ESP_ERR_INVALID_ARG, TAG, "Display not added by the port");
+    ESP_RETURN_ON_FALSE(lv_display_get_render_mode(disp) == LV_DISPLAY_RENDER_MODE_PARTIAL &&
+                            !disp_ctx->flags.monochrome && !disp_ctx->trans_sem && disp_ctx->draw_buffs[0],
+                        ESP_ERR_NOT_SUPPORTED, TAG, "Only partial mode buffers of the port can be replaced");
+
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    uint32_t size_bytes  = buffers->buffer_size * lv_color_format_get_size(cf);
+    uint32_t line_bytes  = lv_draw_buf_width_to_stride(lv_display_get_original_horizontal_resolution(disp), cf);
+    ESP_RETURN_ON_FALSE(size_bytes >= line_bytes, ESP_ERR_INVALID_ARG, TAG, "Draw buffer smaller than one line");
+    uint32_t caps = buffers->caps ? buffers->caps : MALLOC_CAP_DEFAULT;
+
+    /* Allocate everything first, so a failure leaves the display as it was */
+    buf1 = heap_caps_aligned_alloc(CONFIG_LV_DRAW_BUF_ALIGN, size_bytes, caps);
+    ESP_GOTO_ON_FALSE(buf1, ESP_ERR_NO_MEM, err, TAG, "Not enough memory for LVGL buffer (buf1) allocation!");
+    if (buffers->double_buffer) {
+        buf2 = heap_caps_aligned_alloc(CONFIG_LV_DRAW_BUF_ALIGN, size_bytes, caps);
+        ESP_GOTO_ON_FALSE(buf2, ESP_ERR_NO_MEM, err, TAG, "Not enough memory for LVGL buffer (buf2) allocation!");
+    }
+    if (disp_ctx->flags.sw_rotate) {
+        rotbuf = heap_caps_malloc(size_bytes, caps);
+        ESP_GOTO_ON_FALSE(rotbuf, ESP_ERR_NO_MEM, err, TAG,
+                          "Not enough memory for LVGL buffer (rotation buffer) allocation!");
+    }
+
+    /* The panel may still be reading the old buffer */
+    ESP_GOTO_ON_ERROR(lvgl_port_disp_wait_flush(disp, 1000), err, TAG, "Flush did not finish");
+    lv_display_set_buffers(disp, buf1, buf2, size_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    for (int i = 0; i < 3; i++) {
+        free(disp_ctx->draw_buffs[i]);
+    }
+    disp_ctx->draw_buffs[0] = buf1;
+    disp_ctx->draw_buffs[1] = buf2;
+    disp_ctx->draw_buffs[2] = rotbuf;
+    disp_ctx->buffer_size   = buffers->buffer_size;
+    disp_ctx->buff_caps     = caps;
+    return ESP_OK;
+
+err:
+    free(buf1);
+    free(buf2);
+    free(rotbuf);
+    return ret;
+}
+
 /*******************************************************************************
  * Private functions
  *******************************************************************************/
@@ -327,6 +410,11 @@ static lv_display_t* lvgl_port_add_disp_priv(const lvgl_port_display_cfg_t* disp
     if (disp_cfg->flags.buff_spiram) {
         buff_caps |= MALLOC_CAP_SPIRAM;
     }
+    if (disp_cfg->flags.buff_internal) {
+        ESP_GOTO_ON_FALSE(!disp_cfg->flags.buff_spiram, ESP_ERR_INVALID_ARG, err, TAG,
+                          "LVGL buffer can't be both in PSRAM and internal RAM!");
+        buff_caps |= MALLOC_CAP_INTERNAL;
+    }
     if (buff_caps == 0) {
         buff_caps |= MALLOC_CAP_DEFAULT;
     }
@@ -416,7 +504,9 @@ static lv_display_t* lvgl_port_add_disp_priv(const lvgl_port_display_cfg_t* disp
     lv_display_add_event_cb(disp, lvgl_port_display_invalidate_callback, LV_EVENT_REFR_REQUEST, disp_ctx);
 
     lv_display_set_driver_data(disp, disp_ctx);
-    disp_ctx->disp_drv = disp;
+    disp_ctx->disp_drv    = disp;
+    disp_ctx->buffer_size = buffer_size;
+    disp_ctx->buff_caps   = buff_caps;
 
     /* Use SW rotation */
     if (disp_cfg->flags.sw_rotate) {
@@ -665,6 +755,26 @@ IRAM_ATTR static void rotate_copy_pixel(const uint16_t* from, uint16_t* to, uint
     ESP_ERROR_CHECK(ppa_do_scale_rotate_mirror(ppa_srm_handle, &oper_config));
 }
 
+/*
+ * Rotate with the port's cache-blocked kernels, swapping the bytes in the same pass when asked.
+ * Returns false for color formats they don't handle, the caller falls back to lv_draw_sw_rotate() then.
+ */
+static bool sw_rotate(const uint8_t* src, void* dst, int32_t w, int32_t h, int32_t src_stride, int32_t dst_stride,
+                      uint16_t angle, lv_color_format_t cf, bool swap_bytes, bool* swapped)
+{
+    if (cf == LV_COLOR_FORMAT_RGB565) {
+        if (!lvgl_port_rotate_rgb565((const uint16_t*)src, dst, w, h, src_stride, dst_stride, angle, swap_bytes)) {
+            return false;
+        }
+        *swapped = swap_bytes;
+        return true;
+    }
+    if (cf == LV_COLOR_FORMAT_RGB888) {
+        return lvgl_port_rotate_rgb888(src, dst, w, h, src_stride, dst_stride, angle);
+    }
+    return false;
+}
+
 static void lvgl_port_flush_callback(lv_display_t* drv, const lv_area_t* area, uint8_t* color_map)
 {
     assert(drv != NULL);
@@ -680,6 +790,9 @@ static void lvgl_port_flush_callback(lv_display_t* drv, const lv_area_t* area, u
 
     // printf("%d %d %d %d\n", offsetx1, offsetx2, offsety1, offsety2);
 
+    /* Set when the rotation already swapped the bytes */
+    bool swapped = false;
+
     /* SW rotation enabled */
     if (disp_ctx->flags.sw_rotate && (disp_ctx->current_rotation > LV_DISPLAY_ROTATION_0)) {
         /* SW rotation */
@@ -690,8 +803,11 @@ static void lvgl_port_flush_callback(lv_display_t* drv, const lv_area_t* area, u
             uint32_t w_stride    = lv_draw_buf_width_to_stride(ww, cf);
             uint32_t h_stride    = lv_draw_buf_width_to_stride(hh, cf);
             if (disp_ctx->current_rotation == LV_DISPLAY_ROTATION_180) {
-                lv_draw_sw_rotate(color_map, disp_ctx->draw_buffs[2], hh, ww, h_stride, h_stride,
-                                  LV_DISPLAY_ROTATION_180, cf);
+                if (!sw_rotate(color_map, disp_ctx->draw_buffs[2], hh, ww, h_stride, h_stride, 180, cf,
+                               disp_ctx->flags.swap_bytes, &swapped)) {
+                    lv_draw_sw_rotate(color_map, disp_ctx->draw_buffs[2], hh, ww, h_stride, h_stride,
+                                      LV_DISPLAY_ROTATION_180, cf);
+                }
             } else if (disp_ctx->current_rotation == LV_DISPLAY_ROTATION_90) {
                 // printf("%ld %ld\n", w_stride, h_stride);
                 // lv_draw_sw_rotate(color_map, disp_ctx->draw_buffs[2], ww, hh, w_stride, h_stride,
@@ -701,8 +817,11 @@ static void lvgl_port_flush_callback(lv_display_t* drv, const lv_area_t* area, u
                 rotate_copy_pixel((uint16_t*)color_map, (uint16_t*)disp_ctx->draw_buffs[2], 0, 0, offsetx2 - offsetx1,
                                   offsety2 - offsety1, offsetx2 - offsetx1 + 1, offsety2 - offsety1 + 1, 270);
             } else if (disp_ctx->current_rotation == LV_DISPLAY_ROTATION_270) {
-                lv_draw_sw_rotate(color_map, disp_ctx->draw_buffs[2], ww, hh, w_stride, h_stride,
-                                  LV_DISPLAY_ROTATION_270, cf);
+                if (!sw_rotate(color_map, disp_ctx->draw_buffs[2], ww, hh, w_stride, h_stride, 270, cf,
+                               disp_ctx->flags.swap_bytes, &swapped)) {
+                    lv_draw_sw_rotate(color_map, disp_ctx->draw_buffs[2], ww, hh, w_stride, h_stride,
+                                      LV_DISPLAY_ROTATION_270, cf);
+                }
             }
             color_map = (uint8_t*)disp_ctx->draw_buffs[2];
             lvgl_port_rotate_area(drv, (lv_area_t*)area);
@@ -713,7 +832,7 @@ static void lvgl_port_flush_callback(lv_display_t* drv, const lv_area_t* area, u
         }
     }
 
-    if (disp_ctx->flags.swap_bytes) {
+    if (disp_ctx->flags.swap_bytes && !swapped) {
         size_t len = lv_area_get_size(area);
         lv_draw_sw_rgb565_swap(color_map, len);
     }
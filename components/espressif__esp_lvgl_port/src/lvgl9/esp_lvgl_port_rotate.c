@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "esp_lvgl_port_rotate.h"
+
+/*
+ * lv_draw_sw_rotate() walks the whole source column by column for 90/270, so every pixel read touches
+ * another source row (another cache line, in PSRAM) and the byte swap needs a second pass over the
+ * result. Here 90/270 go tile by tile: the rows of one tile stay in cache while it is transposed, and
+ * every destination row segment is written in one go. 180 is a reversed copy of each row, which is
+ * already sequential on both sides. RGB565 moves pixel pairs as words where the alignment allows,
+ * which halves the memory accesses, and the swap is done on the way.
+ *
+ * The generic kernels are always inlined with constant angle and swap flags, so each
+ * (format, angle, swap) combination below compiles to its own loop without run-time branches.
+ */
+
+#define ROTATE_INLINE static inline __attribute__((always_inline))
+#define ROTATE_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define ROW(type, base, stride, y) ((type *)((const uint8_t *)(base) + (y) * (stride)))
+
+typedef void (*rotate_kernel_t)(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                                int32_t dst_stride);
+
+/* Two RGB565 pixels, read and written through the uint16_t buffers */
+typedef uint32_t __attribute__((may_alias)) uint32_a;
+
+/* RGB888 pixel, copied as a whole */
+typedef struct {
+    uint8_t c[3];
+} px888_t;
+
+ROTATE_INLINE uint16_t px565(uint16_t v, const bool swap)
+{
+    return swap ? (uint16_t)((v >> 8) | (v << 8)) : v;
+}
+
+ROTATE_INLINE uint32_t pair565(uint16_t first, uint16_t second, const bool swap)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return px565(first, swap) | ((uint32_t)px565(second, swap) << 16);
+#else
+    return ((uint32_t)px565(first, swap) << 16) | px565(second, swap);
+#endif
+}
+
+/*
+ * Source (x, y) goes to destination row w-1-x, column y (90), or row x, column h-1-y (270).
+ * Each tile is read row by row and written as one contiguous segment per destination row. With word aligned
+ * destination rows and an even height, two source rows are done at once and every write is a pixel pair.
+ */
+ROTATE_INLINE void rotate_quarter_rgb565(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h,
+                                         int32_t src_stride, int32_t dst_stride, const bool cw270, const bool swap)
+{
+    const bool pairs = (h & 1) == 0 && (((uintptr_t)dst | (uint32_t)dst_stride) & 3) == 0;
+    for (int32_t y0 = 0; y0 < h; y0 += LVGL_PORT_ROTATE_TILE) {
+        const int32_t th = ROTATE_MIN(LVGL_PORT_ROTATE_TILE, h - y0);
+        for (int32_t x0 = 0; x0 < w; x0 += LVGL_PORT_ROTATE_TILE) {
+            const int32_t x_end = x0 + ROTATE_MIN(LVGL_PORT_ROTATE_TILE, w - x0);
+            for (int32_t x = x0; x < x_end; x++) {
+                const uint16_t *s = ROW(const uint16_t, src, src_stride, y0) + x;
+                uint16_t *d = ROW(uint16_t, dst, dst_stride, cw270 ? x : w - 1 - x) + (cw270 ? h - 1 - y0 : y0);
+                if (pairs) {
+                    /* The pair of rows y0 + i, y0 + i + 1 lands on one word, in reverse order for 270 */
+                    uint32_a *dw = (uint32_a *)(cw270 ? d - 1 : d);
+                    for (int32_t i = 0; i < th; i += 2) {
+                        const uint16_t a = *s;
+                        const uint16_t b = *ROW(const uint16_t, s, src_stride, 1);
+                        *dw = cw270 ? pair565(b, a, swap) : pair565(a, b, swap);
+                        s = ROW(const uint16_t, s, src_stride, 2);
+                        dw += cw270 ? -1 : 1;
+                    }
+                } else {
+                    for (int32_t i = 0; i < th; i++) {
+                        *d = px565(*s, swap);
+                        s = ROW(const uint16_t, s, src_stride, 1);
+                        d += cw270 ? -1 : 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+ROTATE_INLINE void rotate_quarter_rgb888(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h,
+                                         int32_t src_stride, int32_t dst_stride, const bool cw270)
+{
+    for (int32_t y0 = 0; y0 < h; y0 += LVGL_PORT_ROTATE_TILE) {
+        const int32_t y_end = y0 + ROTATE_MIN(LVGL_PORT_ROTATE_TILE, h - y0);
+        for (int32_t x0 = 0; x0 < w; x0 += LVGL_PORT_ROTATE_TILE) {
+            const int32_t x_end = x0 + ROTATE_MIN(LVGL_PORT_ROTATE_TILE, w - x0);
+            for (int32_t x = x0; x < x_end; x++) {
+                px888_t *restrict d = ROW(px888_t, dst, dst_stride, cw270 ? x : w - 1 - x);
+                for (int32_t y = y0; y < y_end; y++) {
+                    d[cw270 ? h - 1 - y : y] = ROW(const px888_t, src, src_stride, y)[x];
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Source (x, y) goes to destination row h-1-y, column w-1-x.
+ * With word aligned rows and an even width, pixels are moved in pairs: turning a pair around is a 16-bit
+ * rotate, or a byte reverse of the whole word when the bytes are swapped as well.
+ */
+ROTATE_INLINE void rotate_half_rgb565(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                                      int32_t dst_stride, const bool swap)
+{
+    const bool pairs = (w & 1) == 0 && (((uintptr_t)src | (uintptr_t)dst | (uint32_t)src_stride |
+                                          (uint32_t)dst_stride) & 3) == 0;
+    for (int32_t y = 0; y < h; y++) {
+        if (pairs) {
+            const uint32_a *restrict s = ROW(const uint32_a, src, src_stride, y);
+            uint32_a *restrict d = ROW(uint32_a, dst, dst_stride, h - 1 - y);
+            const int32_t n = w / 2;
+            for (int32_t i = 0; i < n; i++) {
+                uint32_t v = s[i];
+                d[n - 1 - i] = swap ? __builtin_bswap32(v) : (v >> 16) | (v << 16);
+            }
+        } else {
+            const uint16_t *restrict s = ROW(const uint16_t, src, src_stride, y);
+            uint16_t *restrict d = ROW(uint16_t, dst, dst_stride, h - 1 - y);
+            for (int32_t x = 0; x < w; x++) {
+                d[w - 1 - x] = px565(s[x], swap);
+            }
+        }
+    }
+}
+
+ROTATE_INLINE void rotate_half_rgb888(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                                      int32_t dst_stride)
+{
+    for (int32_t y = 0; y < h; y++) {
+        const px888_t *restrict s = ROW(const px888_t, src, src_stride, y);
+        px888_t *restrict d = ROW(px888_t, dst, dst_stride, h - 1 - y);
+        for (int32_t x = 0; x < w; x++) {
+            d[w - 1 - x] = s[x];
+        }
+    }
+}
+
+#define ROTATE_KERNEL(name, call)                                                                              \
+    static void name(const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,              \
+                     int32_t dst_stride)                                                                       \
+    {                                                                                                          \
+        call;                                                                                                  \
+    }
+
+ROTATE_KERNEL(rotate90_rgb565, rotate_quarter_rgb565(src, dst, w, h, src_stride, dst_stride, false, false))
+ROTATE_KERNEL(rotate180_rgb565, rotate_half_rgb565(src, dst, w, h, src_stride, dst_stride, false))
+ROTATE_KERNEL(rotate270_rgb565, rotate_quarter_rgb565(src, dst, w, h, src_stride, dst_stride, true, false))
+ROTATE_KERNEL(rotate90_rgb565_swap, rotate_quarter_rgb565(src, dst, w, h, src_stride, dst_stride, false, true))
+ROTATE_KERNEL(rotate180_rgb565_swap, rotate_half_rgb565(src, dst, w, h, src_stride, dst_stride, true))
+ROTATE_KERNEL(rotate270_rgb565_swap, rotate_quarter_rgb565(src, dst, w, h, src_stride, dst_stride, true, true))
+ROTATE_KERNEL(rotate90_rgb888, rotate_quarter_rgb888(src, dst, w, h, src_stride, dst_stride, false))
+ROTATE_KERNEL(rotate180_rgb888, rotate_half_rgb888(src, dst, w, h, src_stride, dst_stride))
+ROTATE_KERNEL(rotate270_rgb888, rotate_quarter_rgb888(src, dst, w, h, src_stride, dst_stride, true))
+
+/* Indexed by angle / 90 - 1 */
+static const rotate_kernel_t rgb565_kernels[2][3] = {
+    {rotate90_rgb565, rotate180_rgb565, rotate270_rgb565},
+    {rotate90_rgb565_swap, rotate180_rgb565_swap, rotate270_rgb565_swap},
+};
+static const rotate_kernel_t rgb888_kernels[3] = {rotate90_rgb888, rotate180_rgb888, rotate270_rgb888};
+
+static int angle_index(uint16_t angle)
+{
+    switch (angle) {
+        case 90:
+            return 0;
+        case 180:
+            return 1;
+        case 270:
+            return 2;
+        default:
+            return -1;
+    }
+}
+
+bool lvgl_port_rotate_rgb565(const uint16_t *src, uint16_t *dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride, uint16_t angle, bool swap_bytes)
+{
+    int i = angle_index(angle);
+    if (i < 0) {
+        return false;
+    }
+    rgb565_kernels[swap_bytes ? 1 : 0][i]((const uint8_t *)src, (uint8_t *)dst, width, height, src_stride,
+                                          dst_stride);
+    return true;
+}
+
+bool lvgl_port_rotate_rgb888(const uint8_t *src, uint8_t *dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride, uint16_t angle)
+{
+    int i = angle_index(angle);
+    if (i < 0) {
+        return false;
+    }
+    rgb888_kernels[i](src, dst, width, height, src_stride, dst_stride);
+    return true;
+}
@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// This is the portable C version of the LVGL simple fill (ARGB8888, RGB565, RGB888) and RGB565 normal blend,
+// for the targets without an assembly version (and for the host build of test_apps/simd).
+// It exports the same functions as the assembly files, so esp_lvgl_port_lv_blend.h works unchanged.
+//
+// Written with GCC vector extensions: every row is brought to a 16-byte boundary with byte stores, the middle is
+// done with aligned 16-byte vector stores, the tail with byte stores again; rows under SHORT_ROW bytes are written
+// pixel by pixel. The compiler maps the vectors to the target's SIMD registers where there are any, and to word
+// stores elsewhere.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LV_RESULT_OK    1
+#define VEC_SIZE        16
+#define PATTERN_PERIOD  48      // bytes, multiple of every pixel size (2, 3, 4) and of VEC_SIZE
+#define SHORT_ROW       32      // bytes, rows shorter than this are done one pixel at a time
+#define BLEND_INLINE    static inline __attribute__((always_inline))
+
+typedef uint8_t vec_t __attribute__((vector_size(VEC_SIZE), may_alias));
+typedef uint8_t vec_unaligned_t __attribute__((vector_size(VEC_SIZE), aligned(1), may_alias));
+
+// Same layout as asm_dsc_t in esp_lvgl_port_lv_blend.h
+typedef struct {
+    uint32_t opa;
+    void *dst_buf;
+    uint32_t dst_w;
+    uint32_t dst_h;
+    uint32_t dst_stride;
+    const void *src_buf;
+    uint32_t src_stride;
+    const uint8_t *mask_buf;
+    uint32_t mask_stride;
+} asm_dsc_t;
+
+// Pixel bytes repeated: pattern[i] is byte i of a row filled with the pixel, for any i < PATTERN_PERIOD + VEC_SIZE
+typedef union {
+    uint8_t bytes[PATTERN_PERIOD + 2 * VEC_SIZE];
+    uint32_t words[(PATTERN_PERIOD + 2 * VEC_SIZE) / sizeof(uint32_t)];
+} fill_pattern_t;
+
+int lv_color_blend_to_argb8888_esp(asm_dsc_t *asm_dsc);
+int lv_color_blend_to_rgb565_esp(asm_dsc_t *asm_dsc);
+int lv_color_blend_to_rgb888_esp(asm_dsc_t *asm_dsc);
+int lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc_t *asm_dsc);
+
+BLEND_INLINE void pattern_init(fill_pattern_t *pattern, const uint8_t *px, size_t px_size)
+{
+    // Four pixels are px_size words: build them byte by byte, then repeat them word by word
+    for (size_t i = 0; i < 4 * px_size; i++) {
+        pattern->bytes[i] = px[i % px_size];
+    }
+    for (size_t i = px_size; i < sizeof(pattern->words) / sizeof(pattern->words[0]); i++) {
+        pattern->words[i] = pattern->words[i - px_size];
+    }
+}
+
+BLEND_INLINE void fill_row(uint8_t *dest, size_t len, const fill_pattern_t *pattern, size_t px_size)
+{
+    if (len < SHORT_ROW) {
+        for (size_t i = 0; i < len; i += px_size) {
+            memcpy(dest + i, pattern->bytes, px_size);
+        }
+        return;
+    }
+
+    // Head: up to the first 16-byte boundary
+    size_t head = (VEC_SIZE - ((uintptr_t)dest & (VEC_SIZE - 1))) & (VEC_SIZE - 1);
+    for (size_t i = 0; i < head; i++) {
+        dest[i] = pattern->bytes[i];
+    }
+
+    // Body: the pattern continues at byte `head` of the row, which is byte head % px_size of a pixel
+    const uint8_t *phase = pattern->bytes + head % px_size;
+    const vec_t v0 = *(const vec_unaligned_t *)(phase);
+    const vec_t v1 = *(const vec_unaligned_t *)(phase + VEC_SIZE);
+    const vec_t v2 = *(const vec_unaligned_t *)(phase + 2 * VEC_SIZE);
+    uint8_t *d = dest + head;
+    size_t left = len - head;
+    for (; left >= PATTERN_PERIOD; left -= PATTERN_PERIOD, d += PATTERN_PERIOD) {
+        ((vec_t *)d)[0] = v0;
+        ((vec_t *)d)[1] = v1;
+        ((vec_t *)d)[2] = v2;
+    }
+    if (left >= VEC_SIZE) {
+        ((vec_t *)d)[0] = v0;
+        d += VEC_SIZE;
+        left -= VEC_SIZE;
+        phase += VEC_SIZE;
+    }
+    if (left >= VEC_SIZE) {
+        ((vec_t *)d)[0] = v1;
+        d += VEC_SIZE;
+        left -= VEC_SIZE;
+        phase += VEC_SIZE;
+    }
+
+    // Tail
+    for (size_t i = 0; i < left; i++) {
+        d[i] = phase[i];
+    }
+}
+
+// Inlined into each caller, so px_size is a constant and the pattern phase needs no division
+BLEND_INLINE int fill(asm_dsc_t *asm_dsc, const uint8_t *px, size_t px_size)
+{
+    fill_pattern_t pattern;
+    pattern_init(&pattern, px, px_size);
+
+    uint8_t *row = asm_dsc->dst_buf;
+    const size_t len = asm_dsc->dst_w * px_size;
+    for (uint32_t y = 0; y < asm_dsc->dst_h; y++) {
+        fill_row(row, len, &pattern, px_size);
+        row += asm_dsc->dst_stride;
+    }
+    return LV_RESULT_OK;
+}
+
+int lv_color_blend_to_argb8888_esp(asm_dsc_t *asm_dsc)
+{
+    // src_buf points to lv_color_t: blue, green, red
+    const uint8_t *color = asm_dsc->src_buf;
+    const uint8_t px[4] = {color[0], color[1], color[2], 0xFF};
+    return fill(asm_dsc, px, sizeof(px));
+}
+
+int lv_color_blend_to_rgb565_esp(asm_dsc_t *asm_dsc)
+{
+    const uint8_t *color = asm_dsc->src_buf;
+    const uint16_t color16 = ((color[2] & 0xF8) << 8) + ((color[1] & 0xFC) << 3) + ((color[0] & 0xF8) >> 3);
+    const uint8_t px[2] = {color16 & 0xFF, color16 >> 8};
+    return fill(asm_dsc, px, sizeof(px));
+}
+
+int lv_color_blend_to_rgb888_esp(asm_dsc_t *asm_dsc)
+{
+    const uint8_t *color = asm_dsc->src_buf;
+    const uint8_t px[3] = {color[0], color[1], color[2]};
+    return fill(asm_dsc, px, sizeof(px));
+}
+
+BLEND_INLINE void copy_row(uint8_t *dest, const uint8_t *src, size_t len)
+{
+    if (len < SHORT_ROW) {
+        for (size_t i = 0; i < len; i += sizeof(uint16_t)) {
+            memcpy(dest + i, src + i, sizeof(uint16_t));
+        }
+        return;
+    }
+
+    // Head: up to the first 16-byte boundary of the destination; the source is read unaligned
+    size_t head = (VEC_SIZE - ((uintptr_t)dest & (VEC_SIZE - 1))) & (VEC_SIZE - 1);
+    for (size_t i = 0; i < head; i++) {
+        dest[i] = src[i];
+    }
+    dest += head;
+    src += head;
+    len -= head;
+
+    for (; len >= 4 * VEC_SIZE; len -= 4 * VEC_SIZE, dest += 4 * VEC_SIZE, src += 4 * VEC_SIZE) {
+        const vec_t a = ((const vec_unaligned_t *)src)[0];
+        const vec_t b = ((const vec_unaligned_t *)src)[1];
+        const vec_t c = ((const vec_unaligned_t *)src)[2];
+        const vec_t d = ((const vec_unaligned_t *)src)[3];
+        ((vec_t *)dest)[0] = a;
+        ((vec_t *)dest)[1] = b;
+        ((vec_t *)dest)[2] = c;
+        ((vec_t *)dest)[3] = d;
+    }
+    for (; len >= VEC_SIZE; len -= VEC_SIZE, dest += VEC_SIZE, src += VEC_SIZE) {
+        *(vec_t *)dest = *(const vec_unaligned_t *)src;
+    }
+
+    // Tail
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = src[i];
+    }
+}
+
+int lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc_t *asm_dsc)
+{
+    uint8_t *dest = asm_dsc->dst_buf;
+    const uint8_t *src = asm_dsc->src_buf;
+    const size_t len = asm_dsc->dst_w * sizeof(uint16_t);
+    for (uint32_t y = 0; y < asm_dsc->dst_h; y++) {
+        copy_row(dest, src, len);
+        dest += asm_dsc->dst_stride;
+        src += asm_dsc->src_stride;
+    }
+    return LV_RESULT_OK;
+}
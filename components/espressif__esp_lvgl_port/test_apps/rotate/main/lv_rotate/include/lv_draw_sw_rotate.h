@@ -0,0 +1,54 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * This file is derived from the LVGL project.
+ * See https://github.com/lvgl/lvgl for details.
+ */
+
+/**
+ * @file lv_draw_sw_rotate.h
+ *
+ * Hard copy of LVGL 9.5's lv_draw_sw_rotate() and lv_draw_sw_rgb565_swap() for RGB565 and RGB888,
+ * without the assembly hooks: the reference the port's rotation kernels are tested against.
+ */
+
+#ifndef LV_DRAW_SW_ROTATE_H
+#define LV_DRAW_SW_ROTATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    LV_DISPLAY_ROTATION_0 = 0,
+    LV_DISPLAY_ROTATION_90,
+    LV_DISPLAY_ROTATION_180,
+    LV_DISPLAY_ROTATION_270
+} lv_display_rotation_t;
+
+typedef enum {
+    LV_COLOR_FORMAT_RGB565 = 0x12,
+    LV_COLOR_FORMAT_RGB888 = 0x0F,
+} lv_color_format_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t src_height, int32_t src_stride,
+                       int32_t dest_stride, lv_display_rotation_t rotation, lv_color_format_t color_format);
+
+void lv_draw_sw_rgb565_swap(void * buf, uint32_t buf_size_px);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_ROTATE_H*/
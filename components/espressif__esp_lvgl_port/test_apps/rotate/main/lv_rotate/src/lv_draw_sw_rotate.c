@@ -0,0 +1,221 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * This file is derived from the LVGL project.
+ * See https://github.com/lvgl/lvgl for details.
+ */
+
+/**
+ * @file lv_draw_sw_rotate.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_rotate.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rotate90_rgb888(const uint8_t * src, uint8_t * dst, int32_t src_width, int32_t src_height,
+                            int32_t src_stride, int32_t dst_stride);
+static void rotate180_rgb888(const uint8_t * src, uint8_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dest_stride);
+static void rotate270_rgb888(const uint8_t * src, uint8_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride);
+static void rotate90_rgb565(const uint16_t * src, uint16_t * dst, int32_t src_width, int32_t src_height,
+                            int32_t src_stride, int32_t dst_stride);
+static void rotate180_rgb565(const uint16_t * src, uint16_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dest_stride);
+static void rotate270_rgb565(const uint16_t * src, uint16_t * dst, int32_t src_width, int32_t src_height,
+                             int32_t src_stride, int32_t dst_stride);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_sw_rgb565_swap(void * buf, uint32_t buf_size_px)
+{
+    uint16_t * buf16 = buf;
+
+    /*2 pixels will be processed later, so handle 1 pixel alignment*/
+    if((uintptr_t)buf16 & 0x2) {
+        buf16[0] = ((buf16[0] & 0xff00) >> 8) | ((buf16[0] & 0x00ff) << 8);
+        buf16++;
+        buf_size_px--;
+    }
+
+    uint32_t * buf32 = (uint32_t *)buf16;
+    uint32_t u32_cnt = buf_size_px / 2;
+
+    while(u32_cnt >= 8) {
+        buf32[0] = ((buf32[0] & 0xff00ff00) >> 8) | ((buf32[0] & 0x00ff00ff) << 8);
+        buf32[1] = ((buf32[1] & 0xff00ff00) >> 8) | ((buf32[1] & 0x00ff00ff) << 8);
+        buf32[2] = ((buf32[2] & 0xff00ff00) >> 8) | ((buf32[2] & 0x00ff00ff) << 8);
+        buf32[3] = ((buf32[3] & 0xff00ff00) >> 8) | ((buf32[3] & 0x00ff00ff) << 8);
+        buf32[4] = ((buf32[4] & 0xff00ff00) >> 8) | ((buf32[4] & 0x00ff00ff) << 8);
+        buf32[5] = ((buf32[5] & 0xff00ff00) >> 8) | ((buf32[5] & 0x00ff00ff) << 8);
+        buf32[6] = ((buf32[6] & 0xff00ff00) >> 8) | ((buf32[6] & 0x00ff00ff) << 8);
+        buf32[7] = ((buf32[7] & 0xff00ff00) >> 8) | ((buf32[7] & 0x00ff00ff) << 8);
+        buf32 += 8;
+        u32_cnt -= 8;
+    }
+
+    while(u32_cnt) {
+        *buf32 = ((*buf32 & 0xff00ff00) >> 8) | ((*buf32 & 0x00ff00ff) << 8);
+        buf32++;
+        u32_cnt--;
+    }
+
+    /*Process the last pixel if needed*/
+    if(buf_size_px & 0x1) {
+        uint32_t e = buf_size_px - 1;
+        buf16[e] = ((buf16[e] & 0xff00) >> 8) | ((buf16[e] & 0x00ff) << 8);
+    }
+}
+
+void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t src_height, int32_t src_stride,
+                       int32_t dest_stride, lv_display_rotation_t rotation, lv_color_format_t color_format)
+{
+    if(rotation == LV_DISPLAY_ROTATION_90) {
+        switch(color_format) {
+            case LV_COLOR_FORMAT_RGB565:
+                rotate90_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            case LV_COLOR_FORMAT_RGB888:
+                rotate90_rgb888(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            default:
+                break;
+        }
+
+        return;
+    }
+
+    if(rotation == LV_DISPLAY_ROTATION_180) {
+        switch(color_format) {
+            case LV_COLOR_FORMAT_RGB565:
+                rotate180_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            case LV_COLOR_FORMAT_RGB888:
+                rotate180_rgb888(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            default:
+                break;
+        }
+
+        return;
+    }
+
+    if(rotation == LV_DISPLAY_ROTATION_270) {
+        switch(color_format) {
+            case LV_COLOR_FORMAT_RGB565:
+                rotate270_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            case LV_COLOR_FORMAT_RGB888:
+                rotate270_rgb888(src, dest, src_width, src_height, src_stride, dest_stride);
+                break;
+            default:
+                break;
+        }
+
+        return;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void rotate90_rgb888(const uint8_t * src, uint8_t * dst, int32_t src_width, int32_t src_height,
+                            int32_t src_stride,
+                            int32_t dst_stride)
+{
+    for(int32_t x = 0; x < src_width; ++x) {
+        for(int32_t y = 0; y < src_height; ++y) {
+            int32_t srcIndex = y * src_stride + x * 3;
+            int32_t dstIndex = (src_width - x - 1) * dst_stride + y * 3;
+            dst[dstIndex] = src[srcIndex];       /*Red*/
+            dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
+            dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+        }
+    }
+}
+
+static void rotate180_rgb888(const uint8_t * src, uint8_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dest_stride)
+{
+    for(int32_t y = 0; y < height; ++y) {
+        for(int32_t x = 0; x < width; ++x) {
+            int32_t srcIndex = y * src_stride + x * 3;
+            int32_t dstIndex = (height - y - 1) * dest_stride + (width - x - 1) * 3;
+            dst[dstIndex] = src[srcIndex];
+            dst[dstIndex + 1] = src[srcIndex + 1];
+            dst[dstIndex + 2] = src[srcIndex + 2];
+        }
+    }
+}
+
+static void rotate270_rgb888(const uint8_t * src, uint8_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dst_stride)
+{
+    for(int32_t x = 0; x < width; ++x) {
+        for(int32_t y = 0; y < height; ++y) {
+            int32_t srcIndex = y * src_stride + x * 3;
+            int32_t dstIndex = x * dst_stride + (height - y - 1) * 3;
+            dst[dstIndex] = src[srcIndex];       /*Red*/
+            dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
+            dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+        }
+    }
+}
+
+static void rotate270_rgb565(const uint16_t * src, uint16_t * dst, int32_t src_width, int32_t src_height,
+                             int32_t src_stride,
+                             int32_t dst_stride)
+{
+    src_stride /= sizeof(uint16_t);
+    dst_stride /= sizeof(uint16_t);
+
+    for(int32_t x = 0; x < src_width; ++x) {
+        int32_t dstIndex = x * dst_stride;
+        int32_t srcIndex = x;
+        for(int32_t y = 0; y < src_height; ++y) {
+            dst[dstIndex + (src_height - y - 1)] = src[srcIndex];
+            srcIndex += src_stride;
+        }
+    }
+}
+
+static void rotate180_rgb565(const uint16_t * src, uint16_t * dst, int32_t width, int32_t height, int32_t src_stride,
+                             int32_t dest_stride)
+{
+    src_stride /= sizeof(uint16_t);
+    dest_stride /= sizeof(uint16_t);
+
+    for(int32_t y = 0; y < height; ++y) {
+        int32_t dstIndex = (height - y - 1) * dest_stride;
+        int32_t srcIndex = y * src_stride;
+        for(int32_t x = 0; x < width; ++x) {
+            dst[dstIndex + width - x - 1] = src[srcIndex + x];
+        }
+    }
+}
+
+static void rotate90_rgb565(const uint16_t * src, uint16_t * dst, int32_t src_width, int32_t src_height,
+                            int32_t src_stride,
+                            int32_t dst_stride)
+{
+    src_stride /= sizeof(uint16_t);
+    dst_stride /= sizeof(uint16_t);
+
+    for(int32_t x = 0; x < src_width; ++x) {
+        int32_t dstIndex = (src_width - x - 1);
+        int32_t srcIndex = x;
+        for(int32_t y = 0; y < src_height; ++y) {
+            dst[dstIndex * dst_stride + y] = src[srcIndex];
+            srcIndex += src_stride;
+        }
+    }
+}
@@ -0,0 +1,258 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the port's software rotation kernels (esp_lvgl_port_rotate.c).
+ *
+ *   test_rotate          functionality test: every format, angle and swap setting against the hard copy of
+ *                        lv_draw_sw_rotate() + lv_draw_sw_rgb565_swap(), on odd sizes, sizes around the tile
+ *                        size and padded strides. The whole destination buffer is compared, so writes outside
+ *                        the image are caught too.
+ *   test_rotate bench    benchmark at the Tab5 geometry (720x1280), full frames and partial render bands
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lv_draw_sw_rotate.h"
+#include "esp_lvgl_port_rotate.h"
+
+#define CANARY              0xA5
+#define BENCH_MIN_NS        (200 * 1000 * 1000LL)   // per timing round
+#define BENCH_ROUNDS        5
+
+typedef enum {
+    FMT_RGB565,
+    FMT_RGB565_SWAP,
+    FMT_RGB888,
+} test_fmt_t;
+
+static const char *fmt_name[] = {"RGB565", "RGB565+swap", "RGB888"};
+
+static uint32_t rng_state = 0x12345678;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int px_size(test_fmt_t fmt)
+{
+    return fmt == FMT_RGB888 ? 3 : 2;
+}
+
+static lv_display_rotation_t lv_rotation(uint16_t angle)
+{
+    return angle == 90 ? LV_DISPLAY_ROTATION_90 : angle == 180 ? LV_DISPLAY_ROTATION_180 : LV_DISPLAY_ROTATION_270;
+}
+
+// Destination size of a w x h source
+static void dest_size(uint16_t angle, int32_t w, int32_t h, int32_t *dw, int32_t *dh)
+{
+    *dw = angle == 180 ? w : h;
+    *dh = angle == 180 ? h : w;
+}
+
+// What the flush path did before: lv_draw_sw_rotate(), then the byte swap as a second pass
+static void reference(test_fmt_t fmt, const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                      int32_t dst_stride, uint16_t angle)
+{
+    lv_draw_sw_rotate(src, dst, w, h, src_stride, dst_stride, lv_rotation(angle),
+                      fmt == FMT_RGB888 ? LV_COLOR_FORMAT_RGB888 : LV_COLOR_FORMAT_RGB565);
+    if (fmt == FMT_RGB565_SWAP) {
+        int32_t dw, dh;
+        dest_size(angle, w, h, &dw, &dh);
+        for (int32_t y = 0; y < dh; y++) {
+            lv_draw_sw_rgb565_swap(dst + y * dst_stride, dw);
+        }
+    }
+}
+
+static bool port(test_fmt_t fmt, const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                 int32_t dst_stride, uint16_t angle)
+{
+    if (fmt == FMT_RGB888) {
+        return lvgl_port_rotate_rgb888(src, dst, w, h, src_stride, dst_stride, angle);
+    }
+    return lvgl_port_rotate_rgb565((const uint16_t *)src, (uint16_t *)dst, w, h, src_stride, dst_stride, angle,
+                                   fmt == FMT_RGB565_SWAP);
+}
+
+static bool test_case(test_fmt_t fmt, uint16_t angle, int32_t w, int32_t h, int32_t src_pad, int32_t dst_pad)
+{
+    const int px = px_size(fmt);
+    int32_t dw, dh;
+    dest_size(angle, w, h, &dw, &dh);
+    // RGB565 strides stay 2-byte aligned, like every LVGL draw buffer
+    const int32_t src_stride = w * px + src_pad * (fmt == FMT_RGB888 ? 1 : 2);
+    const int32_t dst_stride = dw * px + dst_pad * (fmt == FMT_RGB888 ? 1 : 2);
+    const size_t src_len = (size_t)src_stride * h;
+    const size_t dst_len = (size_t)dst_stride * dh;
+
+    uint8_t *src = malloc(src_len);
+    uint8_t *ref = malloc(dst_len);
+    uint8_t *dut = malloc(dst_len);
+    for (size_t i = 0; i < src_len; i++) {
+        src[i] = (uint8_t)rng();
+    }
+    memset(ref, CANARY, dst_len);
+    memset(dut, CANARY, dst_len);
+
+    reference(fmt, src, ref, w, h, src_stride, dst_stride, angle);
+    bool ok = port(fmt, src, dut, w, h, src_stride, dst_stride, angle);
+    if (!ok) {
+        printf("FAIL %s %u %dx%d: angle rejected\n", fmt_name[fmt], angle, (int)w, (int)h);
+    } else if (memcmp(ref, dut, dst_len) != 0) {
+        size_t i = 0;
+        while (ref[i] == dut[i]) {
+            i++;
+        }
+        printf("FAIL %s %u %dx%d pad %d/%d: byte %zu (row %zu) is %02x, expected %02x\n", fmt_name[fmt], angle,
+               (int)w, (int)h, (int)src_pad, (int)dst_pad, i, i / dst_stride, dut[i], ref[i]);
+        ok = false;
+    }
+
+    free(src);
+    free(ref);
+    free(dut);
+    return ok;
+}
+
+static int run_functionality(void)
+{
+    static const int32_t sizes[][2] = {
+        {1, 1}, {1, 9}, {9, 1}, {2, 3}, {7, 5},
+        {31, 31}, {32, 32}, {33, 33}, {31, 33}, {33, 64}, {64, 33},
+        {100, 3}, {3, 100}, {127, 65},
+        {720, 50}, {50, 720}, {1280, 28},
+    };
+    static const int32_t pads[][2] = {{0, 0}, {3, 0}, {0, 5}, {8, 16}};
+    static const uint16_t angles[] = {90, 180, 270};
+
+    int cases = 0;
+    int failed = 0;
+    for (int f = FMT_RGB565; f <= FMT_RGB888; f++) {
+        for (size_t a = 0; a < sizeof(angles) / sizeof(angles[0]); a++) {
+            for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                for (size_t p = 0; p < sizeof(pads) / sizeof(pads[0]); p++) {
+                    cases++;
+                    if (!test_case(f, angles[a], sizes[s][0], sizes[s][1], pads[p][0], pads[p][1])) {
+                        failed++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Unsupported angles are refused without touching the destination
+    uint16_t dst[4] = {0x1234, 0x1234, 0x1234, 0x1234};
+    const uint16_t src[4] = {0};
+    cases++;
+    if (lvgl_port_rotate_rgb565(src, dst, 2, 2, 4, 4, 0, true) ||
+            lvgl_port_rotate_rgb565(src, dst, 2, 2, 4, 4, 45, false) ||
+            lvgl_port_rotate_rgb888((const uint8_t *)src, (uint8_t *)dst, 1, 1, 3, 3, 360) || dst[0] != 0x1234) {
+        printf("FAIL unsupported angle accepted\n");
+        failed++;
+    }
+
+    printf("%d cases, %d failed\n", cases, failed);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+typedef void (*bench_fn_t)(test_fmt_t fmt, const uint8_t *src, uint8_t *dst, int32_t w, int32_t h,
+                           int32_t src_stride, int32_t dst_stride, uint16_t angle);
+
+static void bench_port(test_fmt_t fmt, const uint8_t *src, uint8_t *dst, int32_t w, int32_t h, int32_t src_stride,
+                       int32_t dst_stride, uint16_t angle)
+{
+    port(fmt, src, dst, w, h, src_stride, dst_stride, angle);
+}
+
+// One timing round, at least BENCH_MIN_NS long; microseconds per call
+static double bench_round(bench_fn_t fn, test_fmt_t fmt, const uint8_t *src, uint8_t *dst, int32_t w, int32_t h,
+                          uint16_t angle)
+{
+    const int px = px_size(fmt);
+    int32_t dw, dh;
+    dest_size(angle, w, h, &dw, &dh);
+    int64_t start = now_ns();
+    int64_t elapsed;
+    long calls = 0;
+    do {
+        fn(fmt, src, dst, w, h, w * px, dw * px, angle);
+        calls++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    return (double)elapsed / calls / 1000.0;
+}
+
+static int run_benchmark(void)
+{
+    // Source sizes as LVGL hands them to the flush callback on a 720x1280 panel with 720 x 50 line buffers:
+    // rotated 90/270 the display is 1280 wide, so a band is 28 lines
+    static const struct {
+        const char *name;
+        int32_t w;
+        int32_t h;
+        uint16_t angle;
+    } cases[] = {
+        {"frame 180", 720, 1280, 180},
+        {"band  180", 720, 50, 180},
+        {"frame 270", 1280, 720, 270},
+        {"band  270", 1280, 28, 270},
+        {"frame 90", 1280, 720, 90},
+        {"band  90", 1280, 28, 90},
+    };
+
+    const size_t len = 1280 * 720 * 3;
+    uint8_t *src = malloc(len);
+    uint8_t *dst = malloc(len);
+    for (size_t i = 0; i < len; i++) {
+        src[i] = (uint8_t)rng();
+    }
+
+    printf("LVGL_PORT_ROTATE_TILE %d, times in us per call (best of %d)\n", LVGL_PORT_ROTATE_TILE, BENCH_ROUNDS);
+    printf("%-10s %-12s %10s %10s %8s\n", "case", "format", "lv_draw_sw", "port", "speedup");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (int f = FMT_RGB565; f <= FMT_RGB888; f++) {
+            // Rounds alternate between the two, best of each is kept
+            double ref = 0;
+            double dut = 0;
+            for (int r = 0; r < BENCH_ROUNDS; r++) {
+                double t = bench_round(reference, f, src, dst, cases[c].w, cases[c].h, cases[c].angle);
+                ref = r == 0 || t < ref ? t : ref;
+                t = bench_round(bench_port, f, src, dst, cases[c].w, cases[c].h, cases[c].angle);
+                dut = r == 0 || t < dut ? t : dut;
+            }
+            printf("%-10s %-12s %10.1f %10.1f %7.2fx\n", cases[c].name, fmt_name[f], ref, dut, ref / dut);
+        }
+    }
+
+    free(src);
+    free(dst);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
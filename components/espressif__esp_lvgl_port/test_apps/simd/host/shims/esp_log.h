@@ -0,0 +1,14 @@
+#ifndef SHIM_ESP_LOG_H
+#define SHIM_ESP_LOG_H
+
+#include <stdio.h>
+
+// The tests log their results, so everything is printed
+#define ESP_LOG_SHIM(letter, tag, fmt, ...) printf(letter " (%s): " fmt "\n", tag, ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, fmt, ...) ESP_LOG_SHIM("E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_SHIM("W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_SHIM("I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_SHIM("D", tag, fmt, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef SHIM_SDKCONFIG_H
+#define SHIM_SDKCONFIG_H
+
+// What `idf.py --preview set-target linux` gives the app
+#define CONFIG_IDF_TARGET               "linux"
+#define CONFIG_IDF_TARGET_LINUX         1
+#define CONFIG_LV_DRAW_SW_ASM_CUSTOM    1
+
+#endif
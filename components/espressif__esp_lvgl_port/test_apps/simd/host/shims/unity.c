@@ -0,0 +1,123 @@
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+
+#define UNITY_MAX_TESTS 32
+
+typedef struct {
+    const char *name;
+    const char *tags;
+    const char *file;
+    int line;
+    unity_test_fn_t fn;
+} unity_test_t;
+
+static unity_test_t s_tests[UNITY_MAX_TESTS];
+static int s_test_count;
+static const char *s_filter;    // from the command line, NULL runs all
+static int s_run;
+static int s_failures;
+static jmp_buf s_abort;
+
+void unity_register(const char *name, const char *tags, unity_test_fn_t fn, const char *file, int line)
+{
+    if (s_test_count == UNITY_MAX_TESTS) {
+        fprintf(stderr, "%s:%d: more than %d tests, raise UNITY_MAX_TESTS\n", file, line, UNITY_MAX_TESTS);
+        return;
+    }
+    s_tests[s_test_count++] = (unity_test_t) {
+        .name = name, .tags = tags, .file = file, .line = line, .fn = fn,
+    };
+}
+
+void unity_fail(const char *file, int line, const char *msg)
+{
+    printf("%s:%d:FAIL: %s\n", file, line, msg ? msg : "");
+    longjmp(s_abort, 1);
+}
+
+static uint32_t element(const void *array, size_t size, size_t i)
+{
+    const uint8_t *p = (const uint8_t *)array + i * size;
+    uint32_t value = 0;
+    memcpy(&value, p, size);    // little endian host
+    return value;
+}
+
+void unity_each_equal(uint32_t expected, const void *actual, size_t size, size_t count,
+                      const char *msg, const char *file, int line)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint32_t got = element(actual, size, i);
+        if (got != expected) {
+            printf("%s:%d:FAIL: Element %zu Expected 0x%X Was 0x%X. %s\n",
+                   file, line, i, (unsigned)expected, (unsigned)got, msg ? msg : "");
+            longjmp(s_abort, 1);
+        }
+    }
+}
+
+void unity_array_equal(const void *expected, const void *actual, size_t size, size_t count,
+                       const char *msg, const char *file, int line)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint32_t want = element(expected, size, i);
+        uint32_t got = element(actual, size, i);
+        if (got != want) {
+            printf("%s:%d:FAIL: Element %zu Expected 0x%X Was 0x%X. %s\n",
+                   file, line, i, (unsigned)want, (unsigned)got, msg ? msg : "");
+            longjmp(s_abort, 1);
+        }
+    }
+}
+
+void unity_begin(void)
+{
+    s_run = 0;
+    s_failures = 0;
+}
+
+int unity_end(void)
+{
+    printf("\n-----------------------\n%d Tests %d Failures 0 Ignored\n%s\n",
+           s_run, s_failures, s_failures ? "FAIL" : "OK");
+    // With a filter that matched nothing the run did not test anything
+    return s_failures + (s_run == 0);
+}
+
+void unity_run_all_tests(void)
+{
+    for (int i = 0; i < s_test_count; i++) {
+        const unity_test_t *t = &s_tests[i];
+        if (s_filter && !strstr(t->tags, s_filter)) {
+            continue;
+        }
+        printf("Running %s...\n", t->name);
+        fflush(stdout);
+        s_run++;
+        if (setjmp(s_abort) == 0) {
+            setUp();
+            t->fn();
+            tearDown();
+            printf("%s:%d:%s:PASS\n", t->file, t->line, t->name);
+        } else {
+            s_failures++;
+        }
+        fflush(stdout);
+    }
+}
+
+void unity_run_menu(void)
+{
+    unity_run_all_tests();
+}
+
+void app_main(void);
+
+int main(int argc, char **argv)
+{
+    s_filter = argc > 1 ? argv[1] : NULL;
+    app_main();     // exits with the result
+    return 1;
+}
@@ -0,0 +1,68 @@
+#ifndef SHIM_UNITY_H
+#define SHIM_UNITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The part of Unity the simd tests use, with IDF's TEST_CASE registration.
+ * A failed assertion prints where and why and leaves the test; the run goes on
+ * with the next one.
+ */
+
+typedef void (*unity_test_fn_t)(void);
+
+void unity_register(const char *name, const char *tags, unity_test_fn_t fn, const char *file, int line);
+void unity_fail(const char *file, int line, const char *msg);
+void unity_each_equal(uint32_t expected, const void *actual, size_t size, size_t count,
+                      const char *msg, const char *file, int line);
+void unity_array_equal(const void *expected, const void *actual, size_t size, size_t count,
+                       const char *msg, const char *file, int line);
+
+void unity_begin(void);
+int unity_end(void);
+void unity_run_all_tests(void);
+void unity_run_menu(void);
+
+void setUp(void);
+void tearDown(void);
+
+#define UNITY_BEGIN() unity_begin()
+#define UNITY_END()   unity_end()
+
+#define UNITY_CAT_(a, b) a##b
+#define UNITY_CAT(a, b)  UNITY_CAT_(a, b)
+
+#define TEST_CASE(name_, tags_)                                                                 \
+    static void UNITY_CAT(unity_test_, __LINE__)(void);                                         \
+    __attribute__((constructor)) static void UNITY_CAT(unity_register_, __LINE__)(void)         \
+    {                                                                                           \
+        unity_register(name_, tags_, UNITY_CAT(unity_test_, __LINE__), __FILE__, __LINE__);     \
+    }                                                                                           \
+    static void UNITY_CAT(unity_test_, __LINE__)(void)
+
+#define TEST_ASSERT_MESSAGE(cond, msg) do { \
+        if (!(cond)) { \
+            unity_fail(__FILE__, __LINE__, msg); \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_TRUE_MESSAGE(cond, msg)        TEST_ASSERT_MESSAGE(cond, msg)
+#define TEST_ASSERT_NOT_NULL_MESSAGE(ptr, msg)     TEST_ASSERT_MESSAGE((ptr) != NULL, msg)
+#define TEST_ASSERT_NOT_EQUAL(expected, actual)    TEST_ASSERT_MESSAGE((expected) != (actual), "Expected not equal")
+
+#define TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(expected, actual, count, msg) \
+    unity_each_equal((uint8_t)(expected), actual, 1, count, msg, __FILE__, __LINE__)
+#define TEST_ASSERT_EACH_EQUAL_UINT16_MESSAGE(expected, actual, count, msg) \
+    unity_each_equal((uint16_t)(expected), actual, 2, count, msg, __FILE__, __LINE__)
+#define TEST_ASSERT_EACH_EQUAL_UINT32_MESSAGE(expected, actual, count, msg) \
+    unity_each_equal((uint32_t)(expected), actual, 4, count, msg, __FILE__, __LINE__)
+
+#define TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expected, actual, count, msg) \
+    unity_array_equal(expected, actual, 1, count, msg, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT16_ARRAY_MESSAGE(expected, actual, count, msg) \
+    unity_array_equal(expected, actual, 2, count, msg, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_UINT32_ARRAY_MESSAGE(expected, actual, count, msg) \
+    unity_array_equal(expected, actual, 4, count, msg, __FILE__, __LINE__)
+
+#endif
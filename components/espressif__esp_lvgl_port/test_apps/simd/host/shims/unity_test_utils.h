@@ -0,0 +1,6 @@
+#ifndef SHIM_UNITY_TEST_UTILS_H
+#define SHIM_UNITY_TEST_UTILS_H
+
+// The leak checks are left out on the linux target
+
+#endif
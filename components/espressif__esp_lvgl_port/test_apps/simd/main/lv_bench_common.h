@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_cpu.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ------------------------------------------------- Macros and Types --------------------------------------------------
+
+/**
+ * @brief Name of the accelerated implementation under test
+ */
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S3
+#define BENCH_ACCEL_NAME "ASM"
+#else
+#define BENCH_ACCEL_NAME "GENERIC"  // Portable C version, lv_blend_generic.c
+#endif
+
+/**
+ * @brief Unit of bench_get_ticks(): CPU cycles on the chips, nanoseconds on the linux target
+ */
+#if CONFIG_IDF_TARGET_LINUX
+#define BENCH_TICKS_UNIT "ns"
+#else
+#define BENCH_TICKS_UNIT "cycles"
+#endif
+
+// ------------------------------------------------- Functions ---------------------------------------------------------
+
+/**
+ * @brief Time stamp for the benchmarks, see BENCH_TICKS_UNIT
+ *
+ * @note Wraps around, only differences over short intervals are meaningful
+ */
+static inline uint32_t bench_get_ticks(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#else
+    return (uint32_t)esp_cpu_get_cycle_count();
+#endif
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
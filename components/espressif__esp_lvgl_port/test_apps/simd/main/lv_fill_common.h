@@ -72,6 +72,46 @@ typedef struct {
                               uint32_t);  // pointer to LVGL API function with dest_px_size argument
 } bench_test_case_params_t;
 
+// ------------------------------------------------- Test matrices -----------------------------------------------------
+
+// Used by the functionality tests and by the benchmark report
+
+static const test_matrix_params_t default_test_matrix_fill_argb8888 = {
+    .min_w            = 8,  // 8 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
+    .min_h            = 1,
+    .max_w            = 16,
+    .max_h            = 16,
+    .min_unalign_byte = 0,
+    .max_unalign_byte = 16,
+    .unalign_step     = 1,
+    .dest_stride_step = 1,
+    .test_combinations_count = 0,
+};
+
+static const test_matrix_params_t default_test_matrix_fill_rgb565 = {
+    .min_w = 16,  // 16 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
+    .min_h = 1,
+    .max_w = 32,
+    .max_h = 16,
+    .min_unalign_byte        = 0,
+    .max_unalign_byte        = 16,
+    .unalign_step            = 1,
+    .dest_stride_step        = 1,
+    .test_combinations_count = 0,
+};
+
+static const test_matrix_params_t default_test_matrix_fill_rgb888 = {
+    .min_w = 12,  // 12 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
+    .min_h = 1,
+    .max_w = 32,
+    .max_h = 3,
+    .min_unalign_byte        = 0,
+    .max_unalign_byte        = 16,
+    .unalign_step            = 1,
+    .dest_stride_step        = 1,
+    .test_combinations_count = 0,
+};
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
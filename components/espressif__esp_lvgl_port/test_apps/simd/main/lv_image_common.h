@@ -7,6 +7,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include "sdkconfig.h"
 #include <stdint.h>
 #include "lv_color.h"
 #include "lv_draw_sw_blend.h"
@@ -112,6 +113,49 @@ typedef struct {
     void (*blend_api_func)(_lv_draw_sw_blend_image_dsc_t *); /*!< pointer to LVGL API function */
 } bench_test_case_lv_image_params_t;
 
+// ------------------------------------------------- Test matrices -----------------------------------------------------
+
+// Used by the functionality test and by the benchmark report
+static const test_matrix_lv_image_params_t default_test_matrix_image_rgb565_blend_rgb565 = {
+#if CONFIG_IDF_TARGET_ESP32S3
+    .min_w                 = 8,  // 8 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
+    .min_h                 = 1,
+    .max_w                 = 24,
+    .max_h                 = 2,
+    .src_max_unalign_byte  = 16,  // Use 16-byte boundary check for Xtensa PIE
+    .dest_max_unalign_byte = 16,
+    .dest_unalign_step     = 1,  // Step 1 as the destination array is being aligned in the assembly code all the time
+    .src_unalign_step      = 3,  // Step 3 (more relaxed) as source array is used unaligned in the assembly code
+    .src_stride_step       = 3,
+    .dest_stride_step      = 3,
+#elif !CONFIG_IDF_TARGET_ESP32
+    .min_w                 = 1,  // Generic C version: up to 80-byte rows, to get through the 16-byte vector loops
+    .min_h                 = 1,
+    .max_w                 = 40,
+    .max_h                 = 2,
+    .src_max_unalign_byte  = 16,
+    .dest_max_unalign_byte = 16,
+    .dest_unalign_step     = 1,
+    .src_unalign_step      = 3,
+    .src_stride_step       = 3,
+    .dest_stride_step      = 3,
+#else
+    .min_w                 = 1,
+    .min_h                 = 1,
+    .max_w                 = 16,
+    .max_h                 = 2,
+    .src_max_unalign_byte  = 4,  // Use 4-byte boundary  check for Xtensa base
+    .dest_max_unalign_byte = 4,
+    .dest_unalign_step     = 1,
+    .src_unalign_step      = 1,
+    .src_stride_step       = 1,
+    .dest_stride_step      = 1,
+#endif
+    .src_min_unalign_byte    = 0,
+    .dest_min_unalign_byte   = 0,
+    .test_combinations_count = 0,
+};
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
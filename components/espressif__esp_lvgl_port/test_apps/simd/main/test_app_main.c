@@ -5,6 +5,8 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include "sdkconfig.h"
 #include "unity.h"
 #include "unity_test_utils.h"
 #include "lv_fill_common.h"
@@ -28,21 +30,31 @@ void app_main(void)
     printf("|___/  \\____/ \\_|      \\__| \\___||___/ \\__|\r\n");
 
     UNITY_BEGIN();
+#if CONFIG_IDF_TARGET_LINUX
+    // Host build: run everything and report through the exit code
+    unity_run_all_tests();
+    exit(UNITY_END() ? EXIT_FAILURE : EXIT_SUCCESS);
+#else
     unity_run_menu();
     UNITY_END();
+#endif
 }
 
 /* setUp runs before every test */
 void setUp(void)
 {
+#if !CONFIG_IDF_TARGET_LINUX
     // Check for memory leaks
     unity_utils_set_leak_level(TEST_MEMORY_LEAK_THRESHOLD);
     unity_utils_record_free_mem();
+#endif
 }
 
 /* tearDown runs after every test */
 void tearDown(void)
 {
+#if !CONFIG_IDF_TARGET_LINUX
     // Evaluate memory leaks
     unity_utils_evaluate_leaks();
+#endif
 }
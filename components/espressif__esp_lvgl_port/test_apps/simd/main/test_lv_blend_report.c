@@ -0,0 +1,336 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <malloc.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "esp_log.h"
+#include "lv_bench_common.h"
+#include "lv_fill_common.h"
+#include "lv_image_common.h"
+#include "lv_draw_sw_blend.h"
+#include "lv_draw_sw_blend_to_argb8888.h"
+#include "lv_draw_sw_blend_to_rgb565.h"
+#include "lv_draw_sw_blend_to_rgb888.h"
+
+// ------------------------------------------------- Defines -----------------------------------------------------------
+
+#define SAMPLES_PER_POINT 65536  // Pixels processed per measurement, the repeat count follows from the matrix size
+#define MIN_REPEATS       16
+
+// ------------------------------------------------- Macros and Types --------------------------------------------------
+
+/**
+ * @brief Matrix dimension stepped by one report table
+ */
+typedef enum {
+    AXIS_WIDTH,
+    AXIS_HEIGHT,
+    AXIS_DEST_STRIDE,
+    AXIS_DEST_UNALIGN,
+    AXIS_SRC_STRIDE,
+    AXIS_SRC_UNALIGN,
+    AXIS_COUNT,
+} report_axis_t;
+
+/**
+ * @brief One measured point
+ */
+typedef struct {
+    unsigned int w;             // Matrix width
+    unsigned int h;             // Matrix height
+    unsigned int dest_stride;   // Destination stride in pixels
+    unsigned int dest_unalign;  // Destination buffer unalignment in bytes
+    unsigned int src_stride;    // Source stride in pixels (image only)
+    unsigned int src_unalign;   // Source buffer unalignment in bytes (image only)
+} report_point_t;
+
+/**
+ * @brief Function under test, one of blend_api_func, blend_api_px_func or image_api_func is set
+ */
+typedef struct {
+    const char *name;
+    size_t px_size;                                           // Destination (and source) pixel size in bytes
+    void (*blend_api_func)(_lv_draw_sw_blend_fill_dsc_t *);   // Fill
+    void (*blend_api_px_func)(_lv_draw_sw_blend_fill_dsc_t *, uint32_t);  // Fill with dest_px_size argument
+    void (*image_api_func)(_lv_draw_sw_blend_image_dsc_t *);  // Image blend
+    lv_color_format_t src_color_format;                       // Image blend source
+} report_dut_t;
+
+/**
+ * @brief Ranges to step, taken from the functionality test matrix
+ */
+typedef struct {
+    unsigned int min_w, max_w;
+    unsigned int min_h, max_h;
+    unsigned int dest_stride_step;
+    unsigned int dest_max_unalign, dest_unalign_step;
+    unsigned int src_stride_step;                     // 0 for fills
+    unsigned int src_max_unalign, src_unalign_step;
+} report_ranges_t;
+
+static const char *TAG_LV_BLEND_REPORT = "LV Blend Report";
+static const char *axis_name[AXIS_COUNT] = {"width", "height", "dest stride", "dest unalign", "src stride",
+                                            "src unalign"
+                                           };
+
+static lv_color_t test_color = {
+    .blue  = 0x56,
+    .green = 0x34,
+    .red   = 0x12,
+};
+
+// ------------------------------------------------ Static function headers --------------------------------------------
+
+/**
+ * @brief Print the report tables of one function
+ *
+ * - every axis of the functionality test matrix is stepped alone, the others stay at their base value:
+ *   largest matrix, packed stride, aligned buffers
+ *
+ * @param[in] dut Function under test
+ * @param[in] ranges Ranges of the functionality test matrix
+ */
+static void blend_report(const report_dut_t *dut, const report_ranges_t *ranges);
+
+/**
+ * @brief Measure one point
+ *
+ * @return Ticks per sample (see BENCH_TICKS_UNIT)
+ */
+static float blend_report_point(const report_dut_t *dut, const report_point_t *point, bool use_asm);
+
+// ------------------------------------------------ Test cases ---------------------------------------------------------
+
+/*
+Benchmark report
+
+Requires:
+    - To pass functionality tests first
+
+Purpose:
+    - Show where the accelerated version gains over the ANSI version, across the widths, heights, strides and memory
+      alignments the functionality tests enumerate, not only for the ideal and the worst case of the benchmark tests
+
+Procedure:
+    - Take the ranges from the functionality test matrix of the function
+    - Step one axis at a time (width, height, strides, unalignments), keeping the others at the base value
+    - For every point, time the accelerated and the ANSI version over about SAMPLES_PER_POINT samples
+    - Print ticks per sample and the speedup for every point, and min / mean speedup per axis
+*/
+
+// ------------------------------------------------ Test cases stages --------------------------------------------------
+
+TEST_CASE("LV Fill report ARGB8888", "[fill][report][ARGB8888]")
+{
+    const test_matrix_params_t *m = &default_test_matrix_fill_argb8888;
+    const report_ranges_t ranges = {
+        .min_w = m->min_w, .max_w = m->max_w, .min_h = m->min_h, .max_h = m->max_h,
+        .dest_stride_step = m->dest_stride_step,
+        .dest_max_unalign = m->max_unalign_byte, .dest_unalign_step = m->unalign_step,
+    };
+    const report_dut_t dut = {
+        .name           = "fill ARGB8888",
+        .px_size        = sizeof(uint32_t),
+        .blend_api_func = &lv_draw_sw_blend_color_to_argb8888,
+    };
+    blend_report(&dut, &ranges);
+}
+
+TEST_CASE("LV Fill report RGB565", "[fill][report][RGB565]")
+{
+    const test_matrix_params_t *m = &default_test_matrix_fill_rgb565;
+    const report_ranges_t ranges = {
+        .min_w = m->min_w, .max_w = m->max_w, .min_h = m->min_h, .max_h = m->max_h,
+        .dest_stride_step = m->dest_stride_step,
+        .dest_max_unalign = m->max_unalign_byte, .dest_unalign_step = m->unalign_step,
+    };
+    const report_dut_t dut = {
+        .name           = "fill RGB565",
+        .px_size        = sizeof(uint16_t),
+        .blend_api_func = &lv_draw_sw_blend_color_to_rgb565,
+    };
+    blend_report(&dut, &ranges);
+}
+
+TEST_CASE("LV Fill report RGB888", "[fill][report][RGB888]")
+{
+    const test_matrix_params_t *m = &default_test_matrix_fill_rgb888;
+    const report_ranges_t ranges = {
+        .min_w = m->min_w, .max_w = m->max_w, .min_h = m->min_h, .max_h = m->max_h,
+        .dest_stride_step = m->dest_stride_step,
+        .dest_max_unalign = m->max_unalign_byte, .dest_unalign_step = m->unalign_step,
+    };
+    const report_dut_t dut = {
+        .name              = "fill RGB888",
+        .px_size           = 3,
+        .blend_api_px_func = &lv_draw_sw_blend_color_to_rgb888,
+    };
+    blend_report(&dut, &ranges);
+}
+
+TEST_CASE("LV Image report RGB565 blend to RGB565", "[image][report][RGB565]")
+{
+    const test_matrix_lv_image_params_t *m = &default_test_matrix_image_rgb565_blend_rgb565;
+    const report_ranges_t ranges = {
+        .min_w = m->min_w, .max_w = m->max_w, .min_h = m->min_h, .max_h = m->max_h,
+        .dest_stride_step = m->dest_stride_step,
+        .dest_max_unalign = m->dest_max_unalign_byte, .dest_unalign_step = m->dest_unalign_step,
+        .src_stride_step = m->src_stride_step,
+        .src_max_unalign = m->src_max_unalign_byte, .src_unalign_step = m->src_unalign_step,
+    };
+    const report_dut_t dut = {
+        .name             = "image RGB565",
+        .px_size          = sizeof(uint16_t),
+        .image_api_func   = &lv_draw_sw_blend_image_to_rgb565,
+        .src_color_format = LV_COLOR_FORMAT_RGB565,
+    };
+    blend_report(&dut, &ranges);
+}
+
+// ------------------------------------------------ Static test functions ----------------------------------------------
+
+static void blend_report(const report_dut_t *dut, const report_ranges_t *ranges)
+{
+    const report_point_t base = {
+        .w           = ranges->max_w,
+        .h           = ranges->max_h,
+        .dest_stride = ranges->max_w,
+        .src_stride  = ranges->max_w,
+    };
+    const report_axis_t last_axis = ranges->src_stride_step ? AXIS_SRC_UNALIGN : AXIS_DEST_UNALIGN;
+
+    ESP_LOGI(TAG_LV_BLEND_REPORT, "%s, " BENCH_ACCEL_NAME " vs ANSI, " BENCH_TICKS_UNIT " per sample", dut->name);
+    for (report_axis_t axis = AXIS_WIDTH; axis <= last_axis; axis++) {
+        unsigned int first, last, step;
+        switch (axis) {
+            case AXIS_WIDTH:
+                first = ranges->min_w, last = ranges->max_w, step = 1;
+                break;
+            case AXIS_HEIGHT:
+                first = ranges->min_h, last = ranges->max_h, step = 1;
+                break;
+            case AXIS_DEST_STRIDE:
+                first = base.w, last = base.w * 2, step = ranges->dest_stride_step;
+                break;
+            case AXIS_DEST_UNALIGN:
+                first = 0, last = ranges->dest_max_unalign, step = ranges->dest_unalign_step;
+                break;
+            case AXIS_SRC_STRIDE:
+                first = base.w, last = base.w * 2, step = ranges->src_stride_step;
+                break;
+            default:
+                first = 0, last = ranges->src_max_unalign, step = ranges->src_unalign_step;
+                break;
+        }
+
+        ESP_LOGI(TAG_LV_BLEND_REPORT, "  %-12s %10s %10s %8s", axis_name[axis], BENCH_ACCEL_NAME, "ANSI", "speedup");
+        float speedup_min = 0;
+        float speedup_sum = 0;
+        unsigned int points = 0;
+        for (unsigned int value = first; value <= last; value += step) {
+            report_point_t point = base;
+            switch (axis) {
+                case AXIS_WIDTH:
+                    point.w = value;
+                    point.dest_stride = value;
+                    point.src_stride = value;
+                    break;
+                case AXIS_HEIGHT:
+                    point.h = value;
+                    break;
+                case AXIS_DEST_STRIDE:
+                    point.dest_stride = value;
+                    break;
+                case AXIS_DEST_UNALIGN:
+                    point.dest_unalign = value;
+                    break;
+                case AXIS_SRC_STRIDE:
+                    point.src_stride = value;
+                    break;
+                default:
+                    point.src_unalign = value;
+                    break;
+            }
+
+            const float accel   = blend_report_point(dut, &point, true);
+            const float ansi    = blend_report_point(dut, &point, false);
+            const float speedup = accel > 0 ? ansi / accel : 0;
+            ESP_LOGI(TAG_LV_BLEND_REPORT, "  %12u %10.3f %10.3f %7.2fx", value, accel, ansi, speedup);
+            speedup_min = (points == 0 || speedup < speedup_min) ? speedup : speedup_min;
+            speedup_sum += speedup;
+            points++;
+        }
+        ESP_LOGI(TAG_LV_BLEND_REPORT, "  %s: speedup min %.2fx, mean %.2fx over %u points\n", axis_name[axis],
+                 speedup_min, speedup_sum / points, points);
+    }
+}
+
+static float blend_report_point(const report_dut_t *dut, const report_point_t *point, bool use_asm)
+{
+    const size_t dest_len = (size_t)point->dest_stride * point->h * dut->px_size;
+    const size_t src_len  = (size_t)point->src_stride * point->h * dut->px_size;
+    uint8_t *dest_mem     = memalign(16, dest_len + point->dest_unalign);
+    uint8_t *src_mem      = dut->image_api_func ? memalign(16, src_len + point->src_unalign) : NULL;
+    TEST_ASSERT_NOT_NULL_MESSAGE(dest_mem, "Lack of memory");
+    TEST_ASSERT_TRUE_MESSAGE(!dut->image_api_func || src_mem, "Lack of memory");
+    memset(dest_mem, 0, dest_len + point->dest_unalign);
+    if (src_mem) {
+        for (size_t i = 0; i < src_len + point->src_unalign; i++) {
+            src_mem[i] = (uint8_t)i;
+        }
+    }
+
+    const unsigned int samples = point->w * point->h;
+    unsigned int repeats = SAMPLES_PER_POINT / samples;
+    repeats = repeats < MIN_REPEATS ? MIN_REPEATS : repeats;
+
+    _lv_draw_sw_blend_fill_dsc_t fill_dsc = {
+        .dest_buf    = dest_mem + point->dest_unalign,
+        .dest_w      = point->w,
+        .dest_h      = point->h,
+        .dest_stride = point->dest_stride * dut->px_size,
+        .mask_buf    = NULL,
+        .color       = test_color,
+        .opa         = LV_OPA_MAX,
+        .use_asm     = use_asm,
+    };
+    _lv_draw_sw_blend_image_dsc_t image_dsc = {
+        .dest_buf         = dest_mem + point->dest_unalign,
+        .dest_w           = point->w,
+        .dest_h           = point->h,
+        .dest_stride      = point->dest_stride * dut->px_size,
+        .mask_buf         = NULL,
+        .mask_stride      = 0,
+        .src_buf          = src_mem ? src_mem + point->src_unalign : NULL,
+        .src_stride       = point->src_stride * dut->px_size,
+        .src_color_format = dut->src_color_format,
+        .opa              = LV_OPA_MAX,
+        .blend_mode       = LV_BLEND_MODE_NORMAL,
+        .use_asm          = use_asm,
+    };
+
+    // The first call warms up the caches, it is not measured
+    uint32_t start = 0;
+    for (unsigned int i = 0; i <= repeats; i++) {
+        if (i == 1) {
+            start = bench_get_ticks();
+        }
+        if (dut->blend_api_func) {
+            dut->blend_api_func(&fill_dsc);
+        } else if (dut->blend_api_px_func) {
+            dut->blend_api_px_func(&fill_dsc, dut->px_size);
+        } else {
+            dut->image_api_func(&image_dsc);
+        }
+    }
+    const uint32_t ticks = bench_get_ticks() - start;
+
+    free(dest_mem);
+    free(src_mem);
+    return (float)ticks / repeats / samples;
+}
@@ -6,11 +6,12 @@
 
 #include <string.h>
 #include <malloc.h>
+#include <inttypes.h>
 #include <sdkconfig.h>
 
 #include "unity.h"
 #include "esp_log.h"
-#include "freertos/FreeRTOS.h"  // for xthal_get_ccount()
+#include "lv_bench_common.h"
 #include "lv_fill_common.h"
 #include "lv_draw_sw_blend.h"
 #include "lv_draw_sw_blend_to_argb8888.h"
@@ -26,7 +27,7 @@
 // ------------------------------------------------- Macros and Types --------------------------------------------------
 
 static const char *TAG_LV_FILL_BENCH = "LV Fill Benchmark";
-static const char *asm_ansi_func[]   = {"ASM", "ANSI"};
+static const char *asm_ansi_func[]   = {BENCH_ACCEL_NAME, "ANSI"};
 static lv_color_t test_color         = {
     .blue  = 0x56,
     .green = 0x34,
@@ -175,7 +176,8 @@ static void lv_fill_benchmark_init(bench_test_case_params_t *test_params)
         float cycles     = lv_fill_benchmark_run(test_params, &dsc);  // Call Benchmark cycle
         float per_sample = cycles / ((float)(dsc.dest_w * dsc.dest_h));
         ESP_LOGI(TAG_LV_FILL_BENCH,
-                 " %s ideal case: %.3f cycles for %" PRIi32 "x%" PRIi32 " matrix, %.3f cycles per sample",
+                 " %s ideal case: %.3f " BENCH_TICKS_UNIT " for %" PRIi32 "x%" PRIi32 " matrix, %.3f " BENCH_TICKS_UNIT
+                 " per sample",
                  asm_ansi_func[i], cycles, dsc.dest_w, dsc.dest_h, per_sample);
 
         // Run benchmark with the corner case input parameters
@@ -183,7 +185,8 @@ static void lv_fill_benchmark_init(bench_test_case_params_t *test_params)
         cycles     = lv_fill_benchmark_run(test_params, &dsc_cc);  // Call Benchmark cycle
         per_sample = cycles / ((float)(dsc_cc.dest_w * dsc_cc.dest_h));
         ESP_LOGI(TAG_LV_FILL_BENCH,
-                 " %s corner case: %.3f cycles for %" PRIi32 "x%" PRIi32 " matrix, %.3f cycles per sample\n",
+                 " %s corner case: %.3f " BENCH_TICKS_UNIT " for %" PRIi32 "x%" PRIi32 " matrix, %.3f " BENCH_TICKS_UNIT
+                 " per sample\n",
                  asm_ansi_func[i], cycles, dsc_cc.dest_w, dsc_cc.dest_h, per_sample);
 
         // change to ANSI
@@ -201,7 +204,7 @@ static float lv_fill_benchmark_run(bench_test_case_params_t *test_params, _lv_dr
         test_params->blend_api_px_func(dsc, 3);
     }
 
-    const unsigned int start_b = xthal_get_ccount();
+    const unsigned int start_b = bench_get_ticks();
     if (test_params->blend_api_func != NULL) {
         for (int i = 0; i < test_params->benchmark_cycles; i++) {
             test_params->blend_api_func(dsc);
@@ -211,7 +214,7 @@ static float lv_fill_benchmark_run(bench_test_case_params_t *test_params, _lv_dr
             test_params->blend_api_px_func(dsc, 3);
         }
     }
-    const unsigned int end_b = xthal_get_ccount();
+    const unsigned int end_b = bench_get_ticks();
 
     const float total_b = end_b - start_b;
     const float cycles  = total_b / (test_params->benchmark_cycles);
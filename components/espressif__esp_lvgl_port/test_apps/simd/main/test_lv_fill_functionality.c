@@ -111,17 +111,7 @@ alignment...
 
 TEST_CASE("Test fill functionality ARGB8888", "[fill][functionality][ARGB8888]")
 {
-    test_matrix_params_t test_matrix = {
-        .min_w            = 8,  // 8 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
-        .min_h            = 1,
-        .max_w            = 16,
-        .max_h            = 16,
-        .min_unalign_byte = 0,
-        .max_unalign_byte = 16,
-        .unalign_step     = 1,
-        .dest_stride_step = 1,
-        .test_combinations_count = 0,
-    };
+    test_matrix_params_t test_matrix = default_test_matrix_fill_argb8888;
 
     func_test_case_params_t test_case = {
         .blend_api_func = &lv_draw_sw_blend_color_to_argb8888,
@@ -135,17 +125,7 @@ TEST_CASE("Test fill functionality ARGB8888", "[fill][functionality][ARGB8888]")
 
 TEST_CASE("Test fill functionality RGB565", "[fill][functionality][RGB565]")
 {
-    test_matrix_params_t test_matrix = {
-        .min_w = 16,  // 16 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
-        .min_h = 1,
-        .max_w = 32,
-        .max_h = 16,
-        .min_unalign_byte        = 0,
-        .max_unalign_byte        = 16,
-        .unalign_step            = 1,
-        .dest_stride_step        = 1,
-        .test_combinations_count = 0,
-    };
+    test_matrix_params_t test_matrix = default_test_matrix_fill_rgb565;
 
     func_test_case_params_t test_case = {
         .blend_api_func = &lv_draw_sw_blend_color_to_rgb565,
@@ -159,17 +139,7 @@ TEST_CASE("Test fill functionality RGB565", "[fill][functionality][RGB565]")
 
 TEST_CASE("Test fill functionality RGB888", "[fill][functionality][RGB888]")
 {
-    test_matrix_params_t test_matrix = {
-        .min_w = 12,  // 12 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
-        .min_h = 1,
-        .max_w = 32,
-        .max_h = 3,
-        .min_unalign_byte        = 0,
-        .max_unalign_byte        = 16,
-        .unalign_step            = 1,
-        .dest_stride_step        = 1,
-        .test_combinations_count = 0,
-    };
+    test_matrix_params_t test_matrix = default_test_matrix_fill_rgb888;
 
     func_test_case_params_t test_case = {
         .blend_api_px_func = &lv_draw_sw_blend_color_to_rgb888,
@@ -6,11 +6,12 @@
 
 #include <string.h>
 #include <malloc.h>
+#include <inttypes.h>
 #include <sdkconfig.h>
 
 #include "unity.h"
 #include "esp_log.h"
-#include "freertos/FreeRTOS.h"  // for xthal_get_ccount()
+#include "lv_bench_common.h"
 #include "lv_image_common.h"
 #include "lv_draw_sw_blend.h"
 #include "lv_draw_sw_blend_to_rgb565.h"
@@ -25,7 +26,7 @@
 // ------------------------------------------------ Static variables ---------------------------------------------------
 
 static const char *TAG_LV_IMAGE_BENCH = "LV Image Benchmark";
-static const char *asm_ansi_func[]    = {"ASM", "ANSI"};
+static const char *asm_ansi_func[]    = {BENCH_ACCEL_NAME, "ANSI"};
 
 // ------------------------------------------------ Static function headers --------------------------------------------
 
@@ -149,14 +150,16 @@ static void lv_image_benchmark_init(bench_test_case_lv_image_params_t *test_para
         float cycles     = lv_image_benchmark_run(test_params, &dsc);  // Call Benchmark cycle
         float per_sample = cycles / ((float)(dsc.dest_w * dsc.dest_h));
         ESP_LOGI(TAG_LV_IMAGE_BENCH,
-                 " %s ideal case: %.3f cycles for %" PRIi32 "x%" PRIi32 " matrix, %.3f cycles per sample",
+                 " %s ideal case: %.3f " BENCH_TICKS_UNIT " for %" PRIi32 "x%" PRIi32 " matrix, %.3f " BENCH_TICKS_UNIT
+                 " per sample",
                  asm_ansi_func[i], cycles, dsc.dest_w, dsc.dest_h, per_sample);
 
         // Run benchmark with the corner case input parameters
         cycles     = lv_image_benchmark_run(test_params, &dsc_cc);  // Call Benchmark cycle
         per_sample = cycles / ((float)(dsc_cc.dest_w * dsc_cc.dest_h));
         ESP_LOGI(TAG_LV_IMAGE_BENCH,
-                 " %s corner case: %.3f cycles for %" PRIi32 "x%" PRIi32 " matrix, %.3f cycles per sample\n",
+                 " %s corner case: %.3f " BENCH_TICKS_UNIT " for %" PRIi32 "x%" PRIi32 " matrix, %.3f " BENCH_TICKS_UNIT
+                 " per sample\n",
                  asm_ansi_func[i], cycles, dsc_cc.dest_w, dsc_cc.dest_h, per_sample);
 
         // change to ANSI
@@ -170,11 +173,11 @@ static float lv_image_benchmark_run(bench_test_case_lv_image_params_t *test_para
     // Call the DUT function for the first time to init the benchmark test
     test_params->blend_api_func(dsc);
 
-    const unsigned int start_b = xthal_get_ccount();
+    const unsigned int start_b = bench_get_ticks();
     for (int i = 0; i < test_params->benchmark_cycles; i++) {
         test_params->blend_api_func(dsc);
     }
-    const unsigned int end_b = xthal_get_ccount();
+    const unsigned int end_b = bench_get_ticks();
 
     const float total_b = end_b - start_b;
     const float cycles  = total_b / (test_params->benchmark_cycles);
@@ -38,35 +38,6 @@
 static const char *TAG_LV_IMAGE_FUNC = "LV Image Functionality";
 static char test_msg_buf[200];
 
-static const test_matrix_lv_image_params_t default_test_matrix_image_rgb565_blend_rgb565 = {
-#if CONFIG_IDF_TARGET_ESP32S3
-    .min_w                 = 8,  // 8 is the lower limit for the esp32s3 asm implementation, otherwise esp32 is executed
-    .min_h                 = 1,
-    .max_w                 = 24,
-    .max_h                 = 2,
-    .src_max_unalign_byte  = 16,  // Use 16-byte boundary check for Xtensa PIE
-    .dest_max_unalign_byte = 16,
-    .dest_unalign_step     = 1,  // Step 1 as the destination array is being aligned in the assembly code all the time
-    .src_unalign_step      = 3,  // Step 3 (more relaxed) as source array is used unaligned in the assembly code
-    .src_stride_step       = 3,
-    .dest_stride_step      = 3,
-#else
-    .min_w                 = 1,
-    .min_h                 = 1,
-    .max_w                 = 16,
-    .max_h                 = 2,
-    .src_max_unalign_byte  = 4,  // Use 4-byte boundary  check for Xtensa base
-    .dest_max_unalign_byte = 4,
-    .dest_unalign_step     = 1,
-    .src_unalign_step      = 1,
-    .src_stride_step       = 1,
-    .dest_stride_step      = 1,
-#endif
-    .src_min_unalign_byte    = 0,
-    .dest_min_unalign_byte   = 0,
-    .test_combinations_count = 0,
-};
-
 // ------------------------------------------------ Static function headers --------------------------------------------
 
 /**
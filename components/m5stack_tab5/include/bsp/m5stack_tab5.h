@@ -295,8 +295,17 @@ esp_err_t bsp_sdcard_deinit(char *mount_point);
 
 #if (BSP_CONFIG_NO_GRAPHIC_LIB == 0)
 
-#define BSP_LCD_DRAW_BUFF_SIZE   (BSP_LCD_H_RES * 50)  // Frame buffer size in pixels
+#ifdef CONFIG_BSP_LCD_DRAW_BUFF_LINES
+#define BSP_LCD_DRAW_BUFF_LINES  CONFIG_BSP_LCD_DRAW_BUFF_LINES
+#else
+#define BSP_LCD_DRAW_BUFF_LINES  (50)
+#endif
+#define BSP_LCD_DRAW_BUFF_SIZE   (BSP_LCD_H_RES * BSP_LCD_DRAW_BUFF_LINES)  // Draw buffer size in pixels
+#if CONFIG_BSP_LCD_DRAW_BUFF_DOUBLE
+#define BSP_LCD_DRAW_BUFF_DOUBLE (1)
+#else
 #define BSP_LCD_DRAW_BUFF_DOUBLE (0)
+#endif
 
 /**
  * @brief BSP display configuration structure
@@ -309,6 +318,7 @@ typedef struct {
     struct {
         unsigned int buff_dma : 1;    /*!< Allocated LVGL buffer will be DMA capable */
         unsigned int buff_spiram : 1; /*!< Allocated LVGL buffer will be in PSRAM */
+        unsigned int buff_internal : 1; /*!< Allocated LVGL buffer will be in internal RAM */
         unsigned int
             sw_rotate : 1; /*!< Use software rotation (slower), The feature is unavailable under avoid-tear mode */
     } flags;
@@ -1576,6 +1576,7 @@ static lv_display_t* bsp_display_lcd_init(const bsp_display_cfg_t* cfg)
      .flags = {
          .buff_dma    = cfg->flags.buff_dma,
          .buff_spiram = cfg->flags.buff_spiram,
+         .buff_internal = cfg->flags.buff_internal,
 #if LVGL_VERSION_MAJOR >= 9
          .swap_bytes = (BSP_LCD_BIGENDIAN ? true : false),
 #endif
@@ -1742,7 +1743,11 @@ lv_display_t* bsp_display_start(void)
 #else
                                  .buff_dma = true,
 #endif
+#if CONFIG_BSP_LCD_DRAW_BUFF_INTERNAL
+                                 .buff_internal = true,
+#else
                                  .buff_spiram = true,
+#endif
                                  .sw_rotate   = true,
                              }};
     // Increase LVGL task stack size for complex UIs with spinners and overlays
@@ -0,0 +1,241 @@
+#include "boot_init.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "perf_trace.h"
+
+static const char *TAG = "boot_init";
+
+#define BOOT_INIT_BAR_WIDTH     40
+
+typedef struct {
+    boot_stage_t *stages;
+    size_t count;
+    size_t finished;
+    size_t running;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t wake;     // given whenever a stage finishes
+    SemaphoreHandle_t exited;   // given by each helper task on its way out
+    uint8_t next_worker;
+} boot_run_t;
+
+static bool is_finished(boot_stage_state_t state)
+{
+    return state == BOOT_STAGE_DONE || state == BOOT_STAGE_FAILED || state == BOOT_STAGE_SKIPPED;
+}
+
+// Lock held. Skip everything waiting on a failed or skipped stage, until nothing changes.
+static void skip_dependents(boot_run_t *run)
+{
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < run->count; i++) {
+            boot_stage_t *stage = &run->stages[i];
+            if (stage->state != BOOT_STAGE_WAITING) {
+                continue;
+            }
+            for (size_t d = 0; d < run->count; d++) {
+                boot_stage_state_t dep = run->stages[d].state;
+                if ((stage->after & BOOT_STAGE(d)) && (dep == BOOT_STAGE_FAILED || dep == BOOT_STAGE_SKIPPED)) {
+                    ESP_LOGW(TAG, "Skipping %s: %s did not complete", stage->name, run->stages[d].name);
+                    stage->state = BOOT_STAGE_SKIPPED;
+                    run->finished++;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Lock held. Index of a stage that may start now, or -1.
+static int take_ready(boot_run_t *run)
+{
+    for (size_t i = 0; i < run->count; i++) {
+        boot_stage_t *stage = &run->stages[i];
+        if (stage->state != BOOT_STAGE_WAITING) {
+            continue;
+        }
+        bool ready = true;
+        for (size_t d = 0; d < run->count && ready; d++) {
+            ready = !(stage->after & BOOT_STAGE(d)) || run->stages[d].state == BOOT_STAGE_DONE;
+        }
+        if (ready) {
+            stage->state = BOOT_STAGE_RUNNING;
+            run->running++;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void wake_all(boot_run_t *run)
+{
+    for (int i = 0; i <= BOOT_INIT_WORKERS; i++) {
+        xSemaphoreGive(run->wake);
+    }
+}
+
+static void boot_worker(boot_run_t *run, uint8_t worker)
+{
+    for (;;) {
+        xSemaphoreTake(run->lock, portMAX_DELAY);
+        if (run->finished == run->count) {
+            xSemaphoreGive(run->lock);
+            break;
+        }
+        int index = take_ready(run);
+        if (index < 0 && run->running == 0) {
+            // Nothing running and nothing startable: the rest wait on each other
+            for (size_t i = 0; i < run->count; i++) {
+                if (run->stages[i].state == BOOT_STAGE_WAITING) {
+                    ESP_LOGE(TAG, "Skipping %s: dependency cycle", run->stages[i].name);
+                    run->stages[i].state = BOOT_STAGE_SKIPPED;
+                    run->finished++;
+                }
+            }
+            xSemaphoreGive(run->lock);
+            wake_all(run);
+            continue;
+        }
+        xSemaphoreGive(run->lock);
+
+        if (index < 0) {
+            xSemaphoreTake(run->wake, portMAX_DELAY);
+            continue;
+        }
+
+        boot_stage_t *stage = &run->stages[index];
+        stage->worker = worker;
+        stage->start_us = esp_timer_get_time();
+        bool ok = stage->run();
+        stage->end_us = esp_timer_get_time();
+        perf_trace_record(stage->name, stage->start_us, stage->end_us);
+        if (!ok) {
+            ESP_LOGE(TAG, "Stage %s failed", stage->name);
+        }
+
+        xSemaphoreTake(run->lock, portMAX_DELAY);
+        stage->state = ok ? BOOT_STAGE_DONE : BOOT_STAGE_FAILED;
+        run->running--;
+        run->finished++;
+        if (!ok) {
+            skip_dependents(run);
+        }
+        xSemaphoreGive(run->lock);
+        wake_all(run);
+    }
+}
+
+static void boot_worker_task(void *arg)
+{
+    boot_run_t *run = (boot_run_t *)arg;
+    xSemaphoreTake(run->lock, portMAX_DELAY);
+    uint8_t worker = ++run->next_worker;
+    xSemaphoreGive(run->lock);
+
+    boot_worker(run, worker);
+    xSemaphoreGive(run->exited);
+    vTaskDelete(NULL);
+}
+
+bool boot_init_run(boot_stage_t *stages, size_t count)
+{
+    if (count > BOOT_INIT_MAX_STAGES) {
+        ESP_LOGE(TAG, "Too many boot stages (%u)", (unsigned)count);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        stages[i].state = BOOT_STAGE_WAITING;
+        stages[i].worker = 0;
+        stages[i].start_us = 0;
+        stages[i].end_us = 0;
+    }
+
+    boot_run_t run = {
+        .stages = stages,
+        .count = count,
+        .lock = xSemaphoreCreateMutex(),
+        .wake = xSemaphoreCreateCounting(2 * (BOOT_INIT_WORKERS + 1), 0),
+        .exited = xSemaphoreCreateCounting(BOOT_INIT_WORKERS, 0),
+    };
+    if (!run.lock || !run.wake || !run.exited) {
+        ESP_LOGE(TAG, "No memory for the boot scheduler");
+        return false;
+    }
+
+    // Helpers inherit the caller's priority, so stages keep the priority app_main gave them
+    int helpers = 0;
+    for (int i = 0; i < BOOT_INIT_WORKERS; i++) {
+        // One name per helper, so each gets its own row in a trace
+        char name[16];
+        snprintf(name, sizeof(name), "boot_init%d", i + 1);
+        if (xTaskCreate(boot_worker_task, name, 8192, &run, uxTaskPriorityGet(NULL), NULL) == pdPASS) {
+            helpers++;
+        }
+    }
+    boot_worker(&run, 0);
+    for (int i = 0; i < helpers; i++) {
+        xSemaphoreTake(run.exited, portMAX_DELAY);
+    }
+
+    vSemaphoreDelete(run.lock);
+    vSemaphoreDelete(run.wake);
+    vSemaphoreDelete(run.exited);
+
+    bool all_done = true;
+    for (size_t i = 0; i < count; i++) {
+        all_done = all_done && stages[i].state == BOOT_STAGE_DONE;
+    }
+    return all_done;
+}
+
+void boot_init_log(const boot_stage_t *stages, size_t count)
+{
+    int64_t first = 0;
+    int64_t last = 0;
+    int64_t busy = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!is_finished(stages[i].state) || stages[i].start_us == 0) {
+            continue;
+        }
+        if (first == 0 || stages[i].start_us < first) {
+            first = stages[i].start_us;
+        }
+        if (stages[i].end_us > last) {
+            last = stages[i].end_us;
+        }
+        busy += stages[i].end_us - stages[i].start_us;
+    }
+    int64_t span = last > first ? last - first : 1;
+
+    ESP_LOGI(TAG, "Boot stages: %lld ms wall, %lld ms of work, starting %lld ms after reset",
+             (long long)(span / 1000), (long long)(busy / 1000), (long long)(first / 1000));
+    for (size_t i = 0; i < count; i++) {
+        const boot_stage_t *stage = &stages[i];
+        if (stage->start_us == 0) {
+            ESP_LOGI(TAG, "  %-12s %s", stage->name, stage->state == BOOT_STAGE_SKIPPED ? "skipped" : "not run");
+            continue;
+        }
+        char bar[BOOT_INIT_BAR_WIDTH + 1];
+        int from = (int)((stage->start_us - first) * BOOT_INIT_BAR_WIDTH / span);
+        int to = (int)((stage->end_us - first) * BOOT_INIT_BAR_WIDTH / span);
+        if (to <= from) {
+            to = from + 1;
+        }
+        for (int c = 0; c < BOOT_INIT_BAR_WIDTH; c++) {
+            bar[c] = (c >= from && c < to) ? '#' : '.';
+        }
+        bar[BOOT_INIT_BAR_WIDTH] = '\0';
+        ESP_LOGI(TAG, "  %-12s %5lld +%5lld ms  w%u %s%s", stage->name,
+                 (long long)((stage->start_us - first) / 1000),
+                 (long long)((stage->end_us - stage->start_us) / 1000),
+                 stage->worker, bar, stage->state == BOOT_STAGE_FAILED ? " FAILED" : "");
+    }
+}
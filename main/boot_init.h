@@ -0,0 +1,60 @@
+#ifndef BOOT_INIT_H
+#define BOOT_INIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dependency-ordered boot stages.
+ *
+ * Each stage names the stages that must finish before it. A stage runs
+ * as soon as they have, on the calling task or one of BOOT_INIT_WORKERS
+ * helper tasks, so independent bring-up (SD mount, USB host, UARTs,
+ * display) overlaps instead of queueing. A stage that fails skips every
+ * stage that depends on it, directly or not.
+ *
+ * Every stage records when it ran and on which worker;
+ * boot_init_log() prints the timeline. Stages also go to perf_trace as
+ * spans named after the stage.
+ */
+
+#define BOOT_INIT_MAX_STAGES    24
+#define BOOT_INIT_WORKERS       2       // helper tasks besides the caller
+#define BOOT_STAGE(index)       (1u << (index))
+
+typedef enum {
+    BOOT_STAGE_WAITING = 0,
+    BOOT_STAGE_RUNNING,
+    BOOT_STAGE_DONE,
+    BOOT_STAGE_FAILED,
+    BOOT_STAGE_SKIPPED,         // something it depends on failed
+} boot_stage_state_t;
+
+typedef struct {
+    const char *name;
+    bool (*run)(void);
+    uint32_t after;             // BOOT_STAGE() bits of the stages that must finish first
+    // Filled in by boot_init_run()
+    boot_stage_state_t state;
+    uint8_t worker;             // 0 = the calling task
+    int64_t start_us;           // esp_timer
+    int64_t end_us;
+} boot_stage_t;
+
+// Run all stages and return once every one has finished or been skipped.
+// False if any stage failed or was skipped.
+bool boot_init_run(boot_stage_t *stages, size_t count);
+
+// Log one line per stage: start, duration and worker, with a bar on a shared time axis.
+void boot_init_log(const boot_stage_t *stages, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,25 @@
+#include "boot_stages.h"
+
+#include <string.h>
+
+static const boot_stage_t s_table[BOOT_STAGE_COUNT] = {
+    [BOOT_NVS]        = { "nvs",        NULL, 0 },
+    [BOOT_I2C]        = { "i2c",        NULL, 0 },
+    [BOOT_DISPLAY]    = { "display",    NULL, BOOT_STAGE(BOOT_I2C) },
+    [BOOT_SDCARD]     = { "sdcard",     NULL, BOOT_STAGE(BOOT_I2C) },
+    [BOOT_USB_HOST]   = { "usb_host",   NULL, 0 },
+    [BOOT_CONTEXTS]   = { "contexts",   NULL, 0 },
+    [BOOT_TRANSPORTS] = { "transports", NULL, BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_CONTEXTS) },
+    [BOOT_CHARGING]   = { "charging",   NULL, BOOT_STAGE(BOOT_I2C) },
+    [BOOT_SETTINGS]   = { "settings",   NULL, BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_SDCARD) },
+    [BOOT_DETECTION]  = { "detection",  NULL,
+                          BOOT_STAGE(BOOT_TRANSPORTS) | BOOT_STAGE(BOOT_USB_HOST) | BOOT_STAGE(BOOT_SDCARD) },
+};
+
+void boot_stages_init(boot_stage_t stages[BOOT_STAGE_COUNT], const boot_stage_fn_t run[BOOT_STAGE_COUNT])
+{
+    memcpy(stages, s_table, sizeof(s_table));
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        stages[i].run = run[i];
+    }
+}
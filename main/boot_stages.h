@@ -0,0 +1,44 @@
+#ifndef BOOT_STAGES_H
+#define BOOT_STAGES_H
+
+#include <stdbool.h>
+#include "boot_init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * app_main's bring-up as boot_init stages.
+ *
+ * The names and dependencies live here rather than in main.c, so the host
+ * test schedules the same table the firmware does. main.c hands in the
+ * function for each stage; the test hands in simulated ones. SD, USB host
+ * and UARTs come up while the display starts. Earlier entries win when
+ * several are ready.
+ */
+
+enum {
+    BOOT_NVS,
+    BOOT_I2C,
+    BOOT_DISPLAY,
+    BOOT_SDCARD,
+    BOOT_USB_HOST,
+    BOOT_CONTEXTS,
+    BOOT_TRANSPORTS,
+    BOOT_CHARGING,
+    BOOT_SETTINGS,
+    BOOT_DETECTION,
+    BOOT_STAGE_COUNT,
+};
+
+typedef bool (*boot_stage_fn_t)(void);
+
+// Fill stages with the table, stage i running run[i]; ready for boot_init_run().
+void boot_stages_init(boot_stage_t stages[BOOT_STAGE_COUNT], const boot_stage_fn_t run[BOOT_STAGE_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
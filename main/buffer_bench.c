@@ -0,0 +1,342 @@
+#include "buffer_bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_lvgl_port.h"
+
+static const char *TAG = "buffer_bench";
+
+// The Kconfig default first, as the baseline
+static const buffer_bench_layout_t s_layouts[] = {
+    { 50, false, false },
+    { 50, true, false },
+    { 100, true, false },
+    { 200, true, false },
+    { 50, false, true },
+    { 50, true, true },
+    { 100, true, true },
+};
+
+typedef enum {
+    STEP_SETUP,
+    STEP_WARMUP,
+    STEP_REDRAW,
+    STEP_SCROLL,
+    STEP_POPUP,
+} buffer_bench_step_t;
+
+typedef struct {
+    uint64_t redraw_us;
+    uint64_t scroll_us;
+    uint64_t popup_us;
+    uint32_t flushes;
+} buffer_bench_sums_t;
+
+typedef struct {
+    lv_display_t *disp;
+    buffer_bench_cfg_t cfg;
+    lv_timer_t *timer;
+    lvgl_port_disp_buffers_t boot;
+    bool on_boot_layout;
+    uint8_t run;
+    buffer_bench_step_t step;
+    uint32_t n;                 // frames done in this step
+    bool scroll_up;
+    bool counting_flushes;
+    int64_t start_us;
+    buffer_bench_sums_t sums[BUFFER_BENCH_MAX_LAYOUTS];
+    buffer_bench_result_t result;
+} buffer_bench_t;
+
+static buffer_bench_t s_bench;
+
+static uint32_t layout_caps(const buffer_bench_layout_t *layout)
+{
+    return MALLOC_CAP_DMA | (layout->internal ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM);
+}
+
+static uint32_t layout_bytes(const buffer_bench_layout_t *layout)
+{
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(s_bench.disp));
+    uint32_t one = (uint32_t)lv_display_get_original_horizontal_resolution(s_bench.disp) * layout->lines * px_size;
+    return layout->double_buffer ? one * 2 : one;
+}
+
+static esp_err_t set_layout(const buffer_bench_layout_t *layout)
+{
+    lvgl_port_disp_buffers_t buffers = {
+        .buffer_size = (uint32_t)lv_display_get_original_horizontal_resolution(s_bench.disp) * layout->lines,
+        .double_buffer = layout->double_buffer,
+        .caps = layout_caps(layout),
+    };
+    return lvgl_port_disp_set_buffers(s_bench.disp, &buffers);
+}
+
+static void restore_boot_layout(void)
+{
+    if (s_bench.on_boot_layout) {
+        return;
+    }
+    esp_err_t err = lvgl_port_disp_set_buffers(s_bench.disp, &s_bench.boot);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Can't restore the boot buffers: %s", esp_err_to_name(err));
+        return;
+    }
+    s_bench.on_boot_layout = true;
+}
+
+static void stat_add(buffer_bench_stat_t *stat, uint64_t *total, uint32_t us)
+{
+    if (stat->count == 0 || us < stat->min_us) {
+        stat->min_us = us;
+    }
+    stat->max_us = LV_MAX(stat->max_us, us);
+    stat->count++;
+    *total += us;
+}
+
+// Refresh now and wait until the last band has been copied out; microseconds since start
+static uint32_t finish_frame(int64_t start_us)
+{
+    lv_refr_now(s_bench.disp);
+    if (lvgl_port_disp_wait_flush(s_bench.disp, BUFFER_BENCH_FLUSH_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGW(TAG, "Flush still running after %d ms", BUFFER_BENCH_FLUSH_TIMEOUT_MS);
+    }
+    return (uint32_t)(esp_timer_get_time() - start_us);
+}
+
+static void flush_start_cb(lv_event_t *e)
+{
+    (void)e;
+    if (s_bench.counting_flushes) {
+        s_bench.sums[s_bench.run].flushes++;
+    }
+}
+
+static void finish(void)
+{
+    lv_timer_delete(s_bench.timer);
+    s_bench.timer = NULL;
+    lv_display_remove_event_cb_with_user_data(s_bench.disp, flush_start_cb, &s_bench);
+    restore_boot_layout();
+    if (s_bench.cfg.scene) {
+        lv_obj_scroll_to_y(s_bench.cfg.scroll_obj, 0, LV_ANIM_OFF);
+    }
+
+    buffer_bench_result_t *r = &s_bench.result;
+    uint64_t best_us = UINT64_MAX;
+    for (uint8_t i = 0; i < r->run_count; i++) {
+        buffer_bench_run_t *run = &r->runs[i];
+        const buffer_bench_sums_t *sums = &s_bench.sums[i];
+        if (run->redraw.count > 0) {
+            run->redraw.avg_us = (uint32_t)(sums->redraw_us / run->redraw.count);
+            run->flushes_per_redraw = sums->flushes / run->redraw.count;
+        }
+        if (run->scroll.count > 0) {
+            run->scroll.avg_us = (uint32_t)(sums->scroll_us / run->scroll.count);
+        }
+        if (run->popup.count > 0) {
+            run->popup.avg_us = (uint32_t)(sums->popup_us / run->popup.count);
+        }
+        if (run->err != ESP_OK || run->redraw.count == 0 || run->scroll.count == 0 || run->popup.count == 0) {
+            continue;
+        }
+        uint64_t total_us = (uint64_t)run->redraw.avg_us + run->scroll.avg_us + run->popup.avg_us;
+        if (total_us < best_us) {
+            best_us = total_us;
+            r->fastest = (int8_t)i;
+        }
+    }
+    r->elapsed_ms = (uint32_t)((esp_timer_get_time() - s_bench.start_us) / 1000);
+
+    buffer_bench_done_cb_t done = s_bench.cfg.done;
+    lv_obj_t *scene = s_bench.cfg.scene;
+    void *user = s_bench.cfg.user;
+    s_bench.cfg.scene = NULL;
+    if (done) {
+        done(scene, r, user);
+    }
+}
+
+static void next_layout(void)
+{
+    s_bench.run++;
+    s_bench.step = STEP_SETUP;
+    s_bench.n = 0;
+}
+
+static void setup_step(buffer_bench_run_t *run)
+{
+    // Start every layout from the boot buffers, so none is starved by the one before
+    restore_boot_layout();
+    if (run->layout.double_buffer == s_bench.boot.double_buffer &&
+        layout_caps(&run->layout) == s_bench.boot.caps &&
+        (uint32_t)lv_display_get_original_horizontal_resolution(s_bench.disp) * run->layout.lines ==
+            s_bench.boot.buffer_size) {
+        s_bench.result.boot = (int8_t)s_bench.run;
+    } else {
+        run->err = set_layout(&run->layout);
+        if (run->err != ESP_OK) {
+            char name[32];
+            buffer_bench_layout_name(&run->layout, name, sizeof(name));
+            ESP_LOGW(TAG, "Skipping %s: %s", name, esp_err_to_name(run->err));
+            next_layout();
+            return;
+        }
+        s_bench.on_boot_layout = false;
+    }
+    lv_obj_scroll_to_y(s_bench.cfg.scroll_obj, 0, LV_ANIM_OFF);
+    s_bench.scroll_up = false;
+    s_bench.step = STEP_WARMUP;
+}
+
+static void bench_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    if (!lv_obj_is_valid(s_bench.cfg.scene) || !lv_obj_is_valid(s_bench.cfg.scroll_obj)) {
+        ESP_LOGW(TAG, "Scene deleted, benchmark stopped");
+        s_bench.cfg.scene = NULL;
+        finish();
+        return;
+    }
+    if (s_bench.run >= s_bench.result.run_count) {
+        finish();
+        return;
+    }
+
+    buffer_bench_run_t *run = &s_bench.result.runs[s_bench.run];
+    buffer_bench_sums_t *sums = &s_bench.sums[s_bench.run];
+    int64_t start_us = esp_timer_get_time();
+    switch (s_bench.step) {
+    case STEP_SETUP:
+        setup_step(run);
+        return;
+
+    case STEP_WARMUP:
+        lv_obj_invalidate(s_bench.cfg.scene);
+        finish_frame(start_us);
+        if (++s_bench.n >= BUFFER_BENCH_WARMUP_FRAMES) {
+            s_bench.step = STEP_REDRAW;
+            s_bench.n = 0;
+        }
+        return;
+
+    case STEP_REDRAW:
+        s_bench.counting_flushes = true;
+        lv_obj_invalidate(s_bench.cfg.scene);
+        stat_add(&run->redraw, &sums->redraw_us, finish_frame(start_us));
+        s_bench.counting_flushes = false;
+        if (++s_bench.n >= BUFFER_BENCH_REDRAWS) {
+            s_bench.step = STEP_SCROLL;
+            s_bench.n = 0;
+        }
+        return;
+
+    case STEP_SCROLL: {
+        // Bounce between the ends so every frame really moves
+        lv_obj_t *obj = s_bench.cfg.scroll_obj;
+        if (!s_bench.scroll_up && lv_obj_get_scroll_bottom(obj) < BUFFER_BENCH_SCROLL_STEP) {
+            s_bench.scroll_up = true;
+        } else if (s_bench.scroll_up && lv_obj_get_scroll_top(obj) < BUFFER_BENCH_SCROLL_STEP) {
+            s_bench.scroll_up = false;
+        }
+        lv_obj_scroll_by(obj, 0, s_bench.scroll_up ? BUFFER_BENCH_SCROLL_STEP : -BUFFER_BENCH_SCROLL_STEP,
+                         LV_ANIM_OFF);
+        stat_add(&run->scroll, &sums->scroll_us, finish_frame(start_us));
+        if (++s_bench.n >= BUFFER_BENCH_SCROLLS) {
+            s_bench.step = STEP_POPUP;
+            s_bench.n = 0;
+        }
+        return;
+    }
+
+    case STEP_POPUP: {
+        // Building the popup counts: that's what a tap waits for
+        lv_obj_t *popup = s_bench.cfg.open_popup(lv_layer_top(), s_bench.cfg.user);
+        if (!popup) {
+            ESP_LOGW(TAG, "No popup to open");
+            next_layout();
+            return;
+        }
+        stat_add(&run->popup, &sums->popup_us, finish_frame(start_us));
+        lv_obj_delete(popup);
+        finish_frame(esp_timer_get_time());
+        if (++s_bench.n >= BUFFER_BENCH_POPUPS) {
+            next_layout();
+        }
+        return;
+    }
+    }
+}
+
+bool buffer_bench_start(lv_display_t *disp, const buffer_bench_cfg_t *cfg)
+{
+    if (s_bench.timer || !disp || !cfg || !cfg->scene || !cfg->scroll_obj || !cfg->open_popup) {
+        return false;
+    }
+    lvgl_port_disp_buffers_t boot;
+    if (lvgl_port_disp_get_buffers(disp, &boot) != ESP_OK) {
+        return false;
+    }
+    if (lv_display_get_render_mode(disp) != LV_DISPLAY_RENDER_MODE_PARTIAL) {
+        ESP_LOGW(TAG, "Display doesn't render in partial mode, nothing to compare");
+        return false;
+    }
+
+    memset(&s_bench, 0, sizeof(s_bench));
+    s_bench.disp = disp;
+    s_bench.cfg = *cfg;
+    s_bench.boot = boot;
+    s_bench.on_boot_layout = true;
+    s_bench.start_us = esp_timer_get_time();
+
+    buffer_bench_result_t *r = &s_bench.result;
+    r->fastest = -1;
+    r->boot = -1;
+    for (size_t i = 0; i < sizeof(s_layouts) / sizeof(s_layouts[0]) && r->run_count < BUFFER_BENCH_MAX_LAYOUTS; i++) {
+        buffer_bench_run_t *run = &r->runs[r->run_count++];
+        run->layout = s_layouts[i];
+        run->buffer_bytes = layout_bytes(&run->layout);
+    }
+
+    lv_display_add_event_cb(disp, flush_start_cb, LV_EVENT_FLUSH_START, &s_bench);
+    s_bench.timer = lv_timer_create(bench_timer_cb, BUFFER_BENCH_PERIOD_MS, NULL);
+    ESP_LOGI(TAG, "Comparing %u draw buffer layouts, boot layout %lu px x%d, caps 0x%lx", (unsigned)r->run_count,
+             (unsigned long)boot.buffer_size, boot.double_buffer ? 2 : 1, (unsigned long)boot.caps);
+    return true;
+}
+
+bool buffer_bench_running(void)
+{
+    return s_bench.timer != NULL;
+}
+
+void buffer_bench_layout_name(const buffer_bench_layout_t *layout, char *buf, size_t len)
+{
+    snprintf(buf, len, "%u lines x%d %s", (unsigned)layout->lines, layout->double_buffer ? 2 : 1,
+             layout->internal ? "internal" : "PSRAM");
+}
+
+void buffer_bench_log(const buffer_bench_result_t *r)
+{
+    ESP_LOGI(TAG, "%u layouts, %lu ms, times in us (avg/max)", (unsigned)r->run_count, (unsigned long)r->elapsed_ms);
+    ESP_LOGI(TAG, "  %-24s %8s %7s %15s %15s %15s", "layout", "bytes", "flushes", "redraw", "scroll", "popup");
+    for (uint8_t i = 0; i < r->run_count; i++) {
+        const buffer_bench_run_t *run = &r->runs[i];
+        char name[32];
+        buffer_bench_layout_name(&run->layout, name, sizeof(name));
+        if (run->err != ESP_OK) {
+            ESP_LOGI(TAG, "  %-24s %8lu   %s", name, (unsigned long)run->buffer_bytes, esp_err_to_name(run->err));
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-24s %8lu %7lu %7lu/%-7lu %7lu/%-7lu %7lu/%-7lu%s%s", name, (unsigned long)run->buffer_bytes,
+                 (unsigned long)run->flushes_per_redraw,
+                 (unsigned long)run->redraw.avg_us, (unsigned long)run->redraw.max_us,
+                 (unsigned long)run->scroll.avg_us, (unsigned long)run->scroll.max_us,
+                 (unsigned long)run->popup.avg_us, (unsigned long)run->popup.max_us,
+                 i == r->boot ? " boot" : "", i == r->fastest ? " fastest" : "");
+    }
+}
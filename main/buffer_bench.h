@@ -0,0 +1,103 @@
+#ifndef BUFFER_BENCH_H
+#define BUFFER_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Draw buffer benchmark: run the same UI work under several draw buffer
+ * layouts (buffer height, single or double, PSRAM or internal RAM) and
+ * compare.
+ *
+ * Each layout is swapped in at runtime (lvgl_port_disp_set_buffers), then
+ * three things are timed, one per timer tick so touch input and other
+ * timers keep running in between:
+ *   redraw  the whole scene invalidated and refreshed
+ *   scroll  the scene's scrollable object moved by BUFFER_BENCH_SCROLL_STEP
+ *   popup   the caller's popup built and refreshed
+ * A time runs from the change until the last band has been handed to the
+ * panel and copied, so with double buffering the overlap of rendering and
+ * transfer shows up. Before each layout the display goes back to the
+ * layout it started with, so every layout is allocated from the same free
+ * memory; a layout that doesn't fit is reported, not fatal. The starting
+ * layout is restored at the end.
+ *
+ * The Kconfig options BSP_LCD_DRAW_BUFF_* pick the layout used at boot.
+ */
+
+#define BUFFER_BENCH_MAX_LAYOUTS        8
+#define BUFFER_BENCH_WARMUP_FRAMES      2       // per layout, not measured
+#define BUFFER_BENCH_REDRAWS            10
+#define BUFFER_BENCH_SCROLLS            20
+#define BUFFER_BENCH_POPUPS             6
+#define BUFFER_BENCH_SCROLL_STEP        48      // px per scroll frame
+#define BUFFER_BENCH_PERIOD_MS          5
+#define BUFFER_BENCH_FLUSH_TIMEOUT_MS   500
+
+typedef struct {
+    uint16_t lines;             // buffer height
+    bool double_buffer;
+    bool internal;              // internal RAM instead of PSRAM
+} buffer_bench_layout_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t avg_us;
+    uint32_t min_us;
+    uint32_t max_us;
+} buffer_bench_stat_t;
+
+typedef struct {
+    buffer_bench_layout_t layout;
+    esp_err_t err;              // ESP_OK, or why the layout could not be set up (ESP_ERR_NO_MEM mostly)
+    uint32_t buffer_bytes;      // draw buffers, without the port's rotation buffer
+    uint32_t flushes_per_redraw;
+    buffer_bench_stat_t redraw;
+    buffer_bench_stat_t scroll;
+    buffer_bench_stat_t popup;
+} buffer_bench_run_t;
+
+typedef struct {
+    uint8_t run_count;
+    buffer_bench_run_t runs[BUFFER_BENCH_MAX_LAYOUTS];
+    int8_t fastest;             // lowest redraw + scroll + popup time, -1 if none ran
+    int8_t boot;                // run with the layout the display started with, -1 if not in the list
+    uint32_t elapsed_ms;
+} buffer_bench_result_t;
+
+// Build the popup under parent and return its root; the benchmark deletes it
+typedef lv_obj_t *(*buffer_bench_popup_fn_t)(lv_obj_t *parent, void *user);
+
+// Called on the LVGL task when the run is over; the scene is still there for the callback to
+// delete, or NULL if it was deleted during the run
+typedef void (*buffer_bench_done_cb_t)(lv_obj_t *scene, const buffer_bench_result_t *result, void *user);
+
+typedef struct {
+    lv_obj_t *scene;            // covers the screen
+    lv_obj_t *scroll_obj;       // inside the scene, with more content than fits
+    buffer_bench_popup_fn_t open_popup;
+    buffer_bench_done_cb_t done;
+    void *user;
+} buffer_bench_cfg_t;
+
+// Start on disp. Call with the display locked. False if a run is in progress or the display's
+// buffers can't be swapped.
+bool buffer_bench_start(lv_display_t *disp, const buffer_bench_cfg_t *cfg);
+bool buffer_bench_running(void);
+
+void buffer_bench_log(const buffer_bench_result_t *result);
+// "50 lines x2 PSRAM"
+void buffer_bench_layout_name(const buffer_bench_layout_t *layout, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
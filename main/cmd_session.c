@@ -0,0 +1,366 @@
+#include "cmd_session.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "cmd_session";
+
+static bool deadline_passed(TickType_t now, TickType_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static bool contains_any(const char *line, const char *const *markers)
+{
+    for (; markers && *markers; markers++) {
+        if (strstr(line, *markers)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The console echoes what it reads, possibly behind a prompt ("> list_sd")
+static bool is_echo(const char *line, const char *command)
+{
+    size_t len = strlen(line);
+    while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\r')) {
+        len--;
+    }
+    size_t cmd_len = strlen(command);
+    if (cmd_len == 0 || len < cmd_len || strncmp(line + len - cmd_len, command, cmd_len) != 0) {
+        return false;
+    }
+    return len == cmd_len || line[len - cmd_len - 1] == ' ' || line[len - cmd_len - 1] == '>';
+}
+
+static cmd_future_t *queue_at(cmd_session_t *session, uint32_t i)
+{
+    return session->queue[(session->queue_head + i) % CMD_SESSION_SLOTS];
+}
+
+// Lock held. Put unsent commands on the wire while the pipeline has room.
+static void send_pending(cmd_session_t *session)
+{
+    uint32_t on_wire = 0;
+    for (uint32_t i = 0; i < session->queue_len; i++) {
+        cmd_future_t *f = queue_at(session, i);
+        if (!f->sent) {
+            if (on_wire >= CMD_SESSION_PIPELINE) {
+                break;
+            }
+            char line[CMD_SESSION_COMMAND_MAX + 2];
+            int len = snprintf(line, sizeof(line), "%s\r\n", f->command);
+            f->sent = true;
+            f->write_failed = session->write(session->write_ctx, line, (size_t)len) <= 0;
+        }
+        on_wire++;
+        // A response that ends by going quiet has no boundary: the next
+        // response would run straight into it
+        if (f->req.quiet_ms > 0) {
+            break;
+        }
+    }
+}
+
+// Lock held. Complete the oldest request and let the next one take over the line stream.
+static void finish_head(cmd_session_t *session, cmd_status_t status)
+{
+    cmd_future_t *f = queue_at(session, 0);
+    TickType_t now = xTaskGetTickCount();
+
+    session->queue_head = (session->queue_head + 1) % CMD_SESSION_SLOTS;
+    session->queue_len--;
+    f->finished = now;
+    f->status = status;
+    if (status != CMD_DONE) {
+        ESP_LOGW(TAG, "[%s] #%lu \"%s\": %s after %lu ms, %lu lines", session->name, (unsigned long)f->id,
+                 f->command, status == CMD_FAILED ? "failed" : status == CMD_TIMEOUT ? "timed out" : "not sent",
+                 (unsigned long)cmd_future_elapsed_ms(f), (unsigned long)f->lines);
+    }
+    if (f->released) {
+        f->in_use = false;
+    } else {
+        xSemaphoreGive(f->done);
+        if (f->req.completed) {
+            xSemaphoreGive(f->req.completed);
+        }
+    }
+
+    if (session->queue_len > 0) {
+        cmd_future_t *next = queue_at(session, 0);
+        next->due = now;
+        next->last_line = now;
+    }
+    send_pending(session);
+    if (session->queue_len == 0 && session->sub) {
+        // Trailing output of the last response has nobody to go to
+        rx_demux_unsubscribe(session->sub);
+        session->sub = NULL;
+    }
+}
+
+// Lock held.
+static void route_line(cmd_session_t *session, const line_view_t *line)
+{
+    const char *text = line->text;
+    for (uint32_t i = 0; i < session->queue_len; i++) {
+        cmd_future_t *q = queue_at(session, i);
+        if (q->sent && is_echo(text, q->command)) {
+            return;
+        }
+    }
+
+    cmd_future_t *f = queue_at(session, 0);
+    f->lines++;
+    f->last_line = xTaskGetTickCount();
+
+    if (f->req.out && f->req.out_cap > 0 && f->out_len + line->len + 2 <= f->req.out_cap) {
+        memcpy(f->req.out + f->out_len, text, line->len);
+        f->out_len += line->len;
+        f->req.out[f->out_len++] = '\n';
+        f->req.out[f->out_len] = '\0';
+    }
+    if (f->req.on_line) {
+        f->req.on_line(text, line->len, f->req.user);
+    }
+
+    if (contains_any(text, f->req.fail_markers)) {
+        finish_head(session, CMD_FAILED);
+    } else if (contains_any(text, f->req.end_markers) ||
+               (f->req.is_last_line && f->req.is_last_line(text, f->req.user))) {
+        finish_head(session, CMD_DONE);
+    } else if (f->req.quiet_ms > 0 && !f->quiet_armed &&
+               (!f->req.quiet_after || strstr(text, f->req.quiet_after))) {
+        f->quiet_armed = true;
+    }
+}
+
+static void cmd_session_task(void *arg)
+{
+    cmd_session_t *session = (cmd_session_t *)arg;
+
+    while (1) {
+        xSemaphoreTake(session->lock, portMAX_DELAY);
+        if (session->queue_len == 0) {
+            xSemaphoreGive(session->lock);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        cmd_future_t *f = queue_at(session, 0);
+        if (f->write_failed) {
+            finish_head(session, CMD_ERROR);
+            xSemaphoreGive(session->lock);
+            continue;
+        }
+
+        TickType_t now = xTaskGetTickCount();
+        TickType_t deadline = f->due + pdMS_TO_TICKS(f->req.timeout_ms);
+        bool quiet_first = false;
+        if (f->quiet_armed) {
+            TickType_t quiet = f->last_line + pdMS_TO_TICKS(f->req.quiet_ms);
+            if ((int32_t)(quiet - deadline) <= 0) {
+                deadline = quiet;
+                quiet_first = true;
+            }
+        }
+        if (deadline_passed(now, deadline)) {
+            finish_head(session, quiet_first ? CMD_DONE : CMD_TIMEOUT);
+            xSemaphoreGive(session->lock);
+            continue;
+        }
+        rx_demux_sub_t *sub = session->sub;
+        xSemaphoreGive(session->lock);
+
+        // Only this task removes requests or the subscription, so both stay valid while unlocked
+        line_view_t line;
+        if (rx_demux_next_line(sub, &line, deadline - now)) {
+            xSemaphoreTake(session->lock, portMAX_DELAY);
+            route_line(session, &line);
+            xSemaphoreGive(session->lock);
+        }
+    }
+}
+
+bool cmd_session_start(cmd_session_t *session, const char *name, rx_demux_t *demux,
+                       cmd_session_write_fn_t write, void *write_ctx, UBaseType_t priority)
+{
+    memset(session, 0, sizeof(*session));
+    session->name = name;
+    session->demux = demux;
+    session->write = write;
+    session->write_ctx = write_ctx;
+
+    session->lock = xSemaphoreCreateMutex();
+    if (!session->lock) {
+        return false;
+    }
+    for (int i = 0; i < CMD_SESSION_SLOTS; i++) {
+        session->slots[i].session = session;
+        session->slots[i].done = xSemaphoreCreateBinary();
+        if (!session->slots[i].done) {
+            return false;
+        }
+    }
+    return xTaskCreate(cmd_session_task, "cmd_session", 3072, session, priority, &session->task) == pdPASS;
+}
+
+cmd_future_t *cmd_session_submit(cmd_session_t *session, const cmd_request_t *req)
+{
+    if (!session || !session->task) {
+        return NULL;
+    }
+
+    xSemaphoreTake(session->lock, portMAX_DELAY);
+    cmd_future_t *f = NULL;
+    for (int i = 0; i < CMD_SESSION_SLOTS && !f; i++) {
+        if (!session->slots[i].in_use) {
+            f = &session->slots[i];
+        }
+    }
+    // Subscribe before sending, so the first line of the response can't be missed
+    if (f && !session->sub) {
+        session->sub = rx_demux_subscribe(session->demux, NULL);
+    }
+    if (!f || !session->sub) {
+        xSemaphoreGive(session->lock);
+        ESP_LOGW(TAG, "[%s] Can't queue \"%s\": %s", session->name, req->command,
+                 f ? "no subscription" : "session full");
+        return NULL;
+    }
+
+    f->req = *req;
+    snprintf(f->command, sizeof(f->command), "%s", req->command);
+    f->id = ++session->next_id;
+    f->status = CMD_PENDING;
+    f->in_use = true;
+    f->sent = false;
+    f->write_failed = false;
+    f->released = false;
+    f->quiet_armed = false;
+    f->out_len = 0;
+    f->lines = 0;
+    f->finished = 0;
+    if (f->req.out && f->req.out_cap > 0) {
+        f->req.out[0] = '\0';
+    }
+    xSemaphoreTake(f->done, 0);     // a give left over from a released request
+
+    session->queue[(session->queue_head + session->queue_len) % CMD_SESSION_SLOTS] = f;
+    session->queue_len++;
+    if (session->queue_len == 1) {
+        f->due = xTaskGetTickCount();
+        f->last_line = f->due;
+    }
+    send_pending(session);
+    xSemaphoreGive(session->lock);
+
+    xTaskNotifyGive(session->task);
+    return f;
+}
+
+cmd_status_t cmd_future_wait(cmd_future_t *future, TickType_t ticks)
+{
+    if (!future) {
+        return CMD_ERROR;
+    }
+    if (future->status == CMD_PENDING) {
+        xSemaphoreTake(future->done, ticks);
+    }
+    return future->status;
+}
+
+uint32_t cmd_future_elapsed_ms(const cmd_future_t *future)
+{
+    if (!future || future->status == CMD_PENDING) {
+        return 0;
+    }
+    return (uint32_t)((future->finished - future->due) * portTICK_PERIOD_MS);
+}
+
+void cmd_future_release(cmd_future_t *future)
+{
+    if (!future) {
+        return;
+    }
+    cmd_session_t *session = future->session;
+    xSemaphoreTake(session->lock, portMAX_DELAY);
+    if (future->status == CMD_PENDING) {
+        future->released = true;
+        future->req.out = NULL;
+        future->req.on_line = NULL;
+        future->req.completed = NULL;
+    } else {
+        future->in_use = false;
+    }
+    xSemaphoreGive(session->lock);
+}
+
+cmd_status_t cmd_session_run(cmd_session_t *session, const cmd_request_t *req)
+{
+    cmd_future_t *f = cmd_session_submit(session, req);
+    if (!f) {
+        return CMD_ERROR;
+    }
+    cmd_status_t status = cmd_future_wait(f, portMAX_DELAY);
+    cmd_future_release(f);
+    return status;
+}
+
+static void fanout_report(cmd_fanout_target_t *target, cmd_future_t *future,
+                          cmd_fanout_result_fn_t on_result, void *user, int *done)
+{
+    target->status = future ? future->status : CMD_ERROR;
+    target->elapsed_ms = cmd_future_elapsed_ms(future);
+    cmd_future_release(future);
+    if (target->status == CMD_DONE) {
+        (*done)++;
+    }
+    if (on_result) {
+        on_result(target, user);
+    }
+}
+
+int cmd_fanout_run(const cmd_request_t *req, cmd_fanout_target_t *targets, size_t count,
+                   cmd_fanout_result_fn_t on_result, void *user)
+{
+    if (count > CMD_FANOUT_MAX) {
+        count = CMD_FANOUT_MAX;
+    }
+    SemaphoreHandle_t completed = xSemaphoreCreateCounting(CMD_FANOUT_MAX, 0);
+    if (!completed) {
+        return 0;
+    }
+
+    cmd_future_t *futures[CMD_FANOUT_MAX] = { 0 };
+    size_t pending = 0;
+    int done = 0;
+    for (size_t i = 0; i < count; i++) {
+        cmd_request_t r = *req;
+        r.out = targets[i].out;
+        r.out_cap = targets[i].out_cap;
+        r.completed = completed;
+        futures[i] = targets[i].session ? cmd_session_submit(targets[i].session, &r) : NULL;
+        if (futures[i]) {
+            pending++;
+        } else {
+            fanout_report(&targets[i], NULL, on_result, user, &done);
+        }
+    }
+
+    // Each completion gives the semaphore once; report whatever has finished since
+    while (pending > 0) {
+        xSemaphoreTake(completed, portMAX_DELAY);
+        for (size_t i = 0; i < count; i++) {
+            if (futures[i] && futures[i]->status != CMD_PENDING) {
+                fanout_report(&targets[i], futures[i], on_result, user, &done);
+                futures[i] = NULL;
+                pending--;
+            }
+        }
+    }
+    vSemaphoreDelete(completed);
+    return done;
+}
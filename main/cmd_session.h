@@ -0,0 +1,146 @@
+#ifndef CMD_SESSION_H
+#define CMD_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "rx_demux.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Command/response sessions on top of a transport's rx_demux.
+ *
+ * A request carries its command and says how its response ends: a line
+ * containing an end or fail marker, a custom last-line test, or the board
+ * going quiet once the response has started. Submitting returns a future
+ * that completes as soon as the response ends, instead of after a fixed
+ * sleep and read timeout.
+ *
+ * The board answers commands in order, so a session keeps its requests
+ * in a FIFO and routes every received line to the oldest unfinished one.
+ * Up to CMD_SESSION_PIPELINE commands are on the wire at once; the next
+ * one is sent as soon as an earlier response ends. Nothing is sent behind
+ * a request that ends by going quiet, as its end can't be told apart from
+ * the start of the next response. Sessions on different
+ * transports run independently, so a query to every board costs the
+ * slowest board's response time rather than the sum.
+ *
+ * Each request gets a session-unique id for logs. One task per session
+ * reads the lines; it only holds a subscription while requests are
+ * outstanding.
+ *
+ * cmd_fanout_run() sends the same request through several sessions at
+ * once and hands each result back as it arrives.
+ */
+
+#define CMD_SESSION_SLOTS           8       // outstanding requests per session
+#define CMD_SESSION_PIPELINE        2       // commands on the wire at once
+#define CMD_SESSION_COMMAND_MAX     96
+#define CMD_FANOUT_MAX              4       // targets per fan-out
+
+typedef enum {
+    CMD_PENDING = 0,
+    CMD_DONE,           // end marker, last-line test or quiet period
+    CMD_FAILED,         // fail marker
+    CMD_TIMEOUT,        // no end within timeout_ms; out holds what arrived
+    CMD_ERROR,          // not sent: no free slot, no subscription or write failed
+} cmd_status_t;
+
+typedef struct {
+    const char *command;                // without line ending
+    const char *const *end_markers;     // NULL terminated; the matching line is part of the response
+    const char *const *fail_markers;    // NULL terminated
+    bool (*is_last_line)(const char *line, void *user);
+    const char *quiet_after;            // arm quiet_ms only after a line containing this; NULL = first line
+    uint32_t quiet_ms;                  // end once no line arrived for this long; 0 = markers only
+    uint32_t timeout_ms;                // from the moment the response is due
+    char *out;                          // response lines, '\n' separated, NUL terminated; may be NULL
+    size_t out_cap;
+    // Called on the session task with the session locked: don't submit from here
+    void (*on_line)(const char *line, size_t len, void *user);
+    void *user;
+    SemaphoreHandle_t completed;        // optional, given once when the request completes
+} cmd_request_t;
+
+typedef int (*cmd_session_write_fn_t)(void *ctx, const char *data, size_t len);
+
+typedef struct cmd_session cmd_session_t;
+
+typedef struct {
+    cmd_session_t *session;
+    uint32_t id;
+    cmd_request_t req;
+    char command[CMD_SESSION_COMMAND_MAX];
+    volatile cmd_status_t status;
+    bool in_use;
+    bool sent;
+    bool write_failed;      // completed with CMD_ERROR once it reaches the head
+    bool released;          // owner gave up the future; free on completion
+    bool quiet_armed;
+    size_t out_len;
+    uint32_t lines;
+    TickType_t due;         // when the response became the one being received
+    TickType_t last_line;
+    TickType_t finished;
+    SemaphoreHandle_t done;
+} cmd_future_t;
+
+struct cmd_session {
+    const char *name;
+    rx_demux_t *demux;
+    cmd_session_write_fn_t write;
+    void *write_ctx;
+    SemaphoreHandle_t lock;
+    TaskHandle_t task;
+    rx_demux_sub_t *sub;
+    cmd_future_t slots[CMD_SESSION_SLOTS];
+    cmd_future_t *queue[CMD_SESSION_SLOTS];    // submission order
+    uint32_t queue_head;
+    uint32_t queue_len;
+    uint32_t next_id;
+};
+
+bool cmd_session_start(cmd_session_t *session, const char *name, rx_demux_t *demux,
+                       cmd_session_write_fn_t write, void *write_ctx, UBaseType_t priority);
+
+// Queue a request and send it as soon as the pipeline allows. NULL if the session is full.
+cmd_future_t *cmd_session_submit(cmd_session_t *session, const cmd_request_t *req);
+// Block until the future completes or ticks pass; CMD_PENDING on a wait timeout.
+cmd_status_t cmd_future_wait(cmd_future_t *future, TickType_t ticks);
+// Milliseconds from the response being due until it ended, 0 while pending.
+uint32_t cmd_future_elapsed_ms(const cmd_future_t *future);
+// Give the slot back. A pending request keeps running but its output is discarded.
+void cmd_future_release(cmd_future_t *future);
+
+// Submit, wait and release in one call.
+cmd_status_t cmd_session_run(cmd_session_t *session, const cmd_request_t *req);
+
+typedef struct {
+    cmd_session_t *session;     // NULL: reported as CMD_ERROR without sending
+    const char *name;
+    char *out;                  // replaces req->out for this target
+    size_t out_cap;
+    void *ctx;                  // the caller's, per target
+    cmd_status_t status;        // filled in before on_result
+    uint32_t elapsed_ms;
+} cmd_fanout_target_t;
+
+typedef void (*cmd_fanout_result_fn_t)(cmd_fanout_target_t *target, void *user);
+
+// Send req through every target's session at once and wait for all of them.
+// on_result runs on the caller for each target as its response ends, fastest
+// first; targets that couldn't be sent come first. Returns how many ended CMD_DONE.
+int cmd_fanout_run(const cmd_request_t *req, cmd_fanout_target_t *targets, size_t count,
+                   cmd_fanout_result_fn_t on_result, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
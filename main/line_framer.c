@@ -0,0 +1,188 @@
+#include "line_framer.h"
+
+#include <string.h>
+
+static bool is_line_delimiter(uint8_t c)
+{
+    return c == '\n' || c == '\r';
+}
+
+static size_t ring_mask(const line_framer_t *framer)
+{
+    return framer->capacity - 1;
+}
+
+static void emit_line(line_framer_t *framer, line_view_t *out, size_t len, bool truncated)
+{
+    size_t start = framer->tail & ring_mask(framer);
+    char *text;
+
+    if (start + len <= framer->capacity) {
+        // Contiguous: terminate in place (delimiter slot or the guard byte)
+        text = (char *)&framer->ring[start];
+        text[len] = '\0';
+    } else {
+        size_t first = framer->capacity - start;
+        memcpy(framer->scratch, &framer->ring[start], first);
+        memcpy(framer->scratch + first, framer->ring, len - first);
+        framer->scratch[len] = '\0';
+        text = framer->scratch;
+        framer->stats.bytes_copied += (uint32_t)len;
+    }
+
+    framer->tail += len + (truncated ? 0 : 1);
+    framer->scan = framer->tail;
+    framer->stats.lines++;
+    if (truncated) {
+        framer->stats.truncated_lines++;
+    }
+
+    out->text = text;
+    out->len = len;
+    out->truncated = truncated;
+}
+
+bool line_framer_init(
+    line_framer_t *framer,
+    uint8_t *ring,
+    char *scratch,
+    size_t capacity,
+    line_framer_read_fn_t read_fn,
+    void *read_ctx)
+{
+    if (!framer || !ring || !scratch || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    memset(framer, 0, sizeof(*framer));
+    framer->ring = ring;
+    framer->scratch = scratch;
+    framer->capacity = capacity;
+    framer->read_fn = read_fn;
+    framer->read_ctx = read_ctx;
+    return true;
+}
+
+void line_framer_reset(line_framer_t *framer)
+{
+    if (!framer) {
+        return;
+    }
+    framer->head = 0;
+    framer->tail = 0;
+    framer->scan = 0;
+    framer->discarding = false;
+}
+
+size_t line_framer_buffered(const line_framer_t *framer)
+{
+    return framer ? framer->head - framer->tail : 0;
+}
+
+size_t line_framer_feed(line_framer_t *framer, const uint8_t *data, size_t len)
+{
+    if (!framer || !data) {
+        return 0;
+    }
+
+    size_t room = framer->capacity - (framer->head - framer->tail);
+    if (len > room) {
+        len = room;
+    }
+
+    size_t idx = framer->head & ring_mask(framer);
+    size_t first = framer->capacity - idx;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&framer->ring[idx], data, first);
+    memcpy(framer->ring, data + first, len - first);
+
+    framer->head += len;
+    framer->stats.bytes_in += (uint32_t)len;
+    return len;
+}
+
+int line_framer_fill(line_framer_t *framer, uint32_t timeout)
+{
+    if (!framer || !framer->read_fn) {
+        return 0;
+    }
+
+    size_t used = framer->head - framer->tail;
+    if (used >= framer->capacity) {
+        return 0;
+    }
+
+    // Read only into the contiguous free span so the driver writes straight into the ring
+    size_t idx = framer->head & ring_mask(framer);
+    size_t room = framer->capacity - used;
+    size_t span = framer->capacity - idx;
+    if (span > room) {
+        span = room;
+    }
+
+    int n = framer->read_fn(framer->read_ctx, &framer->ring[idx], span, timeout);
+    if (n > 0) {
+        framer->head += (size_t)n;
+        framer->stats.bytes_in += (uint32_t)n;
+    }
+    return n;
+}
+
+bool line_framer_pop(line_framer_t *framer, line_view_t *out)
+{
+    if (!framer || !out) {
+        return false;
+    }
+
+    size_t mask = ring_mask(framer);
+
+    // Skip empty lines and, after a truncation, the rest of the overlong line
+    while (framer->tail < framer->head) {
+        uint8_t c = framer->ring[framer->tail & mask];
+        if (framer->discarding) {
+            framer->tail++;
+            if (is_line_delimiter(c)) {
+                framer->discarding = false;
+            }
+            continue;
+        }
+        if (!is_line_delimiter(c)) {
+            break;
+        }
+        framer->tail++;
+    }
+
+    if (framer->scan < framer->tail) {
+        framer->scan = framer->tail;
+    }
+
+    while (framer->scan < framer->head) {
+        if (is_line_delimiter(framer->ring[framer->scan & mask])) {
+            emit_line(framer, out, framer->scan - framer->tail, false);
+            return true;
+        }
+        framer->scan++;
+    }
+
+    if (framer->head - framer->tail >= framer->capacity) {
+        // Ring is full without a delimiter: hand out what we have and drop the tail
+        emit_line(framer, out, framer->capacity, true);
+        framer->discarding = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool line_framer_next_line(line_framer_t *framer, line_view_t *out, uint32_t timeout)
+{
+    if (line_framer_pop(framer, out)) {
+        return true;
+    }
+    if (line_framer_fill(framer, timeout) <= 0) {
+        return false;
+    }
+    return line_framer_pop(framer, out);
+}
@@ -0,0 +1,75 @@
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming CR/LF line framer over a power-of-two ring buffer.
+ *
+ * Bytes are read straight into the ring and lines are handed out as views
+ * into it. The delimiter byte is overwritten with '\0', so a view is a
+ * regular C string without any copy. Only a line that wraps around the end
+ * of the ring is linearized into the scratch buffer.
+ *
+ * The framer has no RTOS dependencies: the read callback owns blocking and
+ * the timeout value is passed through untouched (ticks on target).
+ */
+
+typedef int (*line_framer_read_fn_t)(void *user_data, uint8_t *dst, size_t len, uint32_t timeout);
+
+typedef struct {
+    char *text;         // NUL-terminated, valid until the next call on the framer
+    size_t len;
+    bool truncated;     // line was longer than the ring, the tail was dropped
+} line_view_t;
+
+typedef struct {
+    uint32_t lines;
+    uint32_t bytes_in;
+    uint32_t bytes_copied;      // bytes linearized into scratch for wrapped lines
+    uint32_t truncated_lines;
+} line_framer_stats_t;
+
+typedef struct {
+    uint8_t *ring;              // capacity + 1 bytes, the extra byte holds the NUL of a line ending at the edge
+    char *scratch;              // capacity + 1 bytes
+    size_t capacity;
+    size_t head;                // total bytes written
+    size_t tail;                // total bytes consumed
+    size_t scan;                // bytes already searched for a delimiter
+    bool discarding;            // skipping the remainder of an overlong line
+    line_framer_read_fn_t read_fn;
+    void *read_ctx;
+    line_framer_stats_t stats;
+} line_framer_t;
+
+bool line_framer_init(
+    line_framer_t *framer,
+    uint8_t *ring,
+    char *scratch,
+    size_t capacity,
+    line_framer_read_fn_t read_fn,
+    void *read_ctx);
+void line_framer_reset(line_framer_t *framer);
+size_t line_framer_buffered(const line_framer_t *framer);
+
+// Push bytes from an external source; returns how many fit.
+size_t line_framer_feed(line_framer_t *framer, const uint8_t *data, size_t len);
+// Pull one chunk from the read callback into the ring.
+int line_framer_fill(line_framer_t *framer, uint32_t timeout);
+// Return the next complete line already in the ring, no I/O.
+bool line_framer_pop(line_framer_t *framer, line_view_t *out);
+// Pop, or fill once and pop; false when no full line arrived within the timeout.
+bool line_framer_next_line(line_framer_t *framer, line_view_t *out, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
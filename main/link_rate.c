@@ -0,0 +1,115 @@
+#include "link_rate.h"
+
+#include <string.h>
+#include "wire_codec.h"
+
+// Rates both the ESP32 UARTs and the CP2102N divide cleanly
+const uint32_t link_rate_ladder[] = {
+    LINK_RATE_DEFAULT, 230400, 460800, 921600, 1500000, 2000000, 3000000,
+};
+const size_t link_rate_ladder_count = sizeof(link_rate_ladder) / sizeof(link_rate_ladder[0]);
+
+uint32_t link_rate_next(uint32_t current, uint32_t limit)
+{
+    for (size_t i = 0; i < link_rate_ladder_count; i++) {
+        if (link_rate_ladder[i] > current) {
+            return link_rate_ladder[i] <= limit ? link_rate_ladder[i] : 0;
+        }
+    }
+    return 0;
+}
+
+uint32_t link_rate_lower(uint32_t current)
+{
+    uint32_t lower = LINK_RATE_DEFAULT;
+    for (size_t i = 0; i < link_rate_ladder_count && link_rate_ladder[i] < current; i++) {
+        lower = link_rate_ladder[i];
+    }
+    return lower;
+}
+
+size_t link_rate_pattern(uint32_t seed, char *out, size_t len)
+{
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    // xorshift32; a zero state would stay zero
+    uint32_t x = seed ? seed : 0x9E3779B9u;
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        out[i] = alphabet[x & 63];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool link_rate_check_echo(const char *line, const char *sent, size_t sent_len)
+{
+    static const char prefix[] = "baudtest ";
+    const size_t prefix_len = sizeof(prefix) - 1;
+
+    if (!line || strncmp(line, prefix, prefix_len) != 0) {
+        return false;
+    }
+    line += prefix_len;
+    if (strlen(line) < sent_len + 5 || memcmp(line, sent, sent_len) != 0 || line[sent_len] != ' ') {
+        return false;
+    }
+    line += sent_len + 1;
+
+    uint32_t crc = 0;
+    for (int i = 0; i < 4; i++) {
+        int v = hex_value(line[i]);
+        if (v < 0) {
+            return false;
+        }
+        crc = (crc << 4) | (uint32_t)v;
+    }
+    // Trailing '\r' or spaces are fine, anything else means a corrupted line
+    for (const char *p = line + 4; *p; p++) {
+        if (*p != '\r' && *p != ' ') {
+            return false;
+        }
+    }
+    return crc == wire_crc16(0xFFFF, (const uint8_t *)sent, sent_len);
+}
+
+void link_rate_meter_reset(link_rate_meter_t *meter, uint32_t now_ms)
+{
+    memset(meter, 0, sizeof(*meter));
+    meter->window_start_ms = now_ms;
+}
+
+void link_rate_meter_add(link_rate_meter_t *meter, size_t bytes, uint32_t now_ms)
+{
+    uint32_t elapsed = now_ms - meter->window_start_ms;
+    if (elapsed >= 1000) {
+        // A window that ran on past two seconds was mostly idle; it says nothing about the link
+        meter->rate = elapsed < 2000 ? (uint32_t)((uint64_t)meter->window_bytes * 1000u / elapsed) : 0;
+        if (meter->rate > meter->peak) {
+            meter->peak = meter->rate;
+        }
+        meter->window_bytes = 0;
+        meter->window_start_ms = now_ms;
+    }
+    meter->window_bytes += (uint32_t)bytes;
+
+    uint32_t rem = meter->total_rem + (uint32_t)bytes;
+    meter->total_kb += rem / 1024u;
+    meter->total_rem = rem % 1024u;
+}
+
+uint32_t link_rate_meter_rate(const link_rate_meter_t *meter, uint32_t now_ms)
+{
+    return (now_ms - meter->window_start_ms) < 2000 ? meter->rate : 0;
+}
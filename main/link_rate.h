@@ -0,0 +1,75 @@
+#ifndef LINK_RATE_H
+#define LINK_RATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Line-rate negotiation between the Tab5 and a JanOS board.
+ *
+ * Every link starts at LINK_RATE_DEFAULT. A board that can run faster
+ * appends "baud=<max>" to its pong; the Tab5 then walks the ladder one
+ * rung at a time:
+ *
+ *     Tab5  -> "baud <rate>"            (old rate)
+ *     board -> "baud ok <rate>"         (old rate, then both ends switch)
+ *     Tab5  -> "baudtest <pattern>"     (new rate, LINK_RATE_TEST_ROUNDS times)
+ *     board -> "baudtest <pattern> <crc16 of what it received, 4 hex>"
+ *     Tab5  -> "baud commit"
+ *
+ * The echo proves the board-to-Tab5 direction, the CRC the other one. A
+ * board that sees no "baud commit" within LINK_RATE_COMMIT_TIMEOUT_MS falls
+ * back to the rate it had, so a failed step needs no working link to undo.
+ * "baud reset" returns the board to LINK_RATE_DEFAULT at once.
+ *
+ * No RTOS dependencies; the same code builds for host tests.
+ */
+
+#define LINK_RATE_DEFAULT               115200
+#define LINK_RATE_PONG_CAPABILITY       "baud="
+#define LINK_RATE_TEST_LEN              192     // pattern characters per round
+#define LINK_RATE_TEST_ROUNDS           4
+#define LINK_RATE_COMMIT_TIMEOUT_MS     1000
+#define LINK_RATE_SWITCH_DELAY_MS       20      // after "baud ok", before talking at the new rate
+
+extern const uint32_t link_rate_ladder[];
+extern const size_t link_rate_ladder_count;
+
+// Next rung above current that does not exceed limit, 0 if there is none.
+uint32_t link_rate_next(uint32_t current, uint32_t limit);
+// Rung below current, LINK_RATE_DEFAULT at the bottom.
+uint32_t link_rate_lower(uint32_t current);
+
+// Fill out with len printable, space-free characters derived from seed; NUL terminated (cap > len).
+size_t link_rate_pattern(uint32_t seed, char *out, size_t len);
+// True if line is the board's echo of the sent pattern with a matching CRC.
+bool link_rate_check_echo(const char *line, const char *sent, size_t sent_len);
+
+/*
+ * Received-bytes meter. Counts in one-second windows; rate is the last
+ * complete window, so it reads 0 once the link has been idle for a window.
+ * One writer, any number of readers: all fields are single 32-bit words.
+ */
+typedef struct {
+    uint32_t window_start_ms;
+    uint32_t window_bytes;
+    uint32_t rate;              // bytes/s, last complete window
+    uint32_t peak;              // bytes/s, best window since reset
+    uint32_t total_kb;
+    uint32_t total_rem;
+} link_rate_meter_t;
+
+void link_rate_meter_reset(link_rate_meter_t *meter, uint32_t now_ms);
+void link_rate_meter_add(link_rate_meter_t *meter, size_t bytes, uint32_t now_ms);
+uint32_t link_rate_meter_rate(const link_rate_meter_t *meter, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
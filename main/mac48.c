@@ -0,0 +1,79 @@
+#include "mac48.h"
+
+// 0x10 | nibble for hex digits, 0 for everything else
+#define HEX_ENTRY(c, v) [c] = 0x10 | (v)
+
+static const uint8_t s_hex_decode[256] = {
+    HEX_ENTRY('0', 0x0), HEX_ENTRY('1', 0x1), HEX_ENTRY('2', 0x2), HEX_ENTRY('3', 0x3),
+    HEX_ENTRY('4', 0x4), HEX_ENTRY('5', 0x5), HEX_ENTRY('6', 0x6), HEX_ENTRY('7', 0x7),
+    HEX_ENTRY('8', 0x8), HEX_ENTRY('9', 0x9),
+    HEX_ENTRY('a', 0xA), HEX_ENTRY('b', 0xB), HEX_ENTRY('c', 0xC),
+    HEX_ENTRY('d', 0xD), HEX_ENTRY('e', 0xE), HEX_ENTRY('f', 0xF),
+    HEX_ENTRY('A', 0xA), HEX_ENTRY('B', 0xB), HEX_ENTRY('C', 0xC),
+    HEX_ENTRY('D', 0xD), HEX_ENTRY('E', 0xE), HEX_ENTRY('F', 0xF),
+};
+
+static const char s_hex_digits[16] = "0123456789abcdef";
+
+// Caller guarantees 17 readable characters
+static bool parse_unchecked(const uint8_t *p, mac48_t *out)
+{
+    uint32_t valid = 0x10;
+    for (int i = 0; i < 6; i++) {
+        uint8_t hi = s_hex_decode[p[i * 3]];
+        uint8_t lo = s_hex_decode[p[i * 3 + 1]];
+        valid &= hi & lo;
+        out->b[i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+    }
+    for (int i = 2; i < 17; i += 3) {
+        valid &= (uint32_t)((p[i] == ':') | (p[i] == '-')) << 4;
+    }
+    return valid != 0;
+}
+
+bool mac48_parse(const char *text, mac48_t *out)
+{
+    if (!text || !out || strnlen(text, 17) < 17) {
+        return false;
+    }
+
+    mac48_t mac;
+    if (!parse_unchecked((const uint8_t *)text, &mac)) {
+        return false;
+    }
+    *out = mac;
+    return true;
+}
+
+const char *mac48_find(const char *text, mac48_t *out)
+{
+    if (!text || !out) {
+        return NULL;
+    }
+
+    size_t len = strlen(text);
+    const uint8_t *p = (const uint8_t *)text;
+    mac48_t mac;
+    for (size_t i = 0; i + 17 <= len; i++) {
+        // Cheap filter before the full decode
+        if ((p[i + 2] != ':' && p[i + 2] != '-') || !(s_hex_decode[p[i]] & s_hex_decode[p[i + 1]])) {
+            continue;
+        }
+        if (parse_unchecked(p + i, &mac)) {
+            *out = mac;
+            return text + i;
+        }
+    }
+    return NULL;
+}
+
+char *mac48_format(const mac48_t *mac, char *out)
+{
+    for (int i = 0; i < 6; i++) {
+        out[i * 3] = s_hex_digits[mac->b[i] >> 4];
+        out[i * 3 + 1] = s_hex_digits[mac->b[i] & 0x0F];
+        out[i * 3 + 2] = ':';
+    }
+    out[17] = '\0';
+    return out;
+}
@@ -0,0 +1,62 @@
+#ifndef MAC48_H
+#define MAC48_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 48-bit MAC / BSSID in binary form. Six bytes instead of an 18-byte
+ * string, compared as integers. Text in and out uses the firmware's
+ * "aa:bb:cc:dd:ee:ff" form; parsing also takes upper case and '-'.
+ */
+
+typedef struct {
+    uint8_t b[6];
+} mac48_t;
+
+#define MAC48_STR_SIZE  18
+
+// printf helpers, same idea as MACSTR / MAC2STR
+#define MAC48_FMT       "%02x:%02x:%02x:%02x:%02x:%02x"
+#define MAC48_ARGS(m)   (m).b[0], (m).b[1], (m).b[2], (m).b[3], (m).b[4], (m).b[5]
+
+static inline uint64_t mac48_to_u64(const mac48_t *mac)
+{
+    return ((uint64_t)mac->b[0] << 40) | ((uint64_t)mac->b[1] << 32) | ((uint64_t)mac->b[2] << 24) |
+           ((uint64_t)mac->b[3] << 16) | ((uint64_t)mac->b[4] << 8) | (uint64_t)mac->b[5];
+}
+
+static inline bool mac48_equal(const mac48_t *a, const mac48_t *b)
+{
+    // Two loads and one compare on targets with unaligned access
+    uint32_t a_hi, b_hi;
+    uint16_t a_lo, b_lo;
+    memcpy(&a_hi, a->b, 4);
+    memcpy(&b_hi, b->b, 4);
+    memcpy(&a_lo, a->b + 4, 2);
+    memcpy(&b_lo, b->b + 4, 2);
+    return ((a_hi ^ b_hi) | (uint32_t)(a_lo ^ b_lo)) == 0;
+}
+
+static inline bool mac48_is_zero(const mac48_t *mac)
+{
+    return mac48_to_u64(mac) == 0;
+}
+
+// Parse the 17 characters at text; anything after them is ignored.
+bool mac48_parse(const char *text, mac48_t *out);
+// Locate the first MAC address anywhere in text. Returns its start, or NULL.
+const char *mac48_find(const char *text, mac48_t *out);
+// Write "aa:bb:cc:dd:ee:ff" into out (MAC48_STR_SIZE bytes) and return out.
+char *mac48_format(const mac48_t *mac, char *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,6 +13,7 @@
 #include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "freertos/timers.h"
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -28,11 +29,33 @@
 #include "lvgl.h"
 #include "ui_theme.h"
 #include "ui_components.h"
+#include "line_framer.h"
+#include "rx_demux.h"
+#include "mac48.h"
+#include "observer_store.h"
+#include "wardrive_log.h"
+#include "portal_journal.h"
+#include "portal_index.h"
+#include "wire_codec.h"
+#include "link_rate.h"
+#include "transport_trace.h"
+#include "cmd_session.h"
+#include "boot_init.h"
+#include "boot_stages.h"
+#include "perf_trace.h"
+#include "ui_perf.h"
+#include "ui_cmd.h"
+#include "usb_rx_wait.h"
+#include "render_cores.h"
+#include "render_bench.h"
+#include "buffer_bench.h"
+#include "theme_icons.h"
 #include "iot_usbh_cdc.h"
 #include "usb/usb_host.h"
 #include "usb/usb_helpers.h"
 #include "usb/usb_types_ch9.h"
 #include "cJSON.h"
+#include "esp_app_desc.h"
 
 // ESP-Hosted includes for WiFi via ESP32C6 SDIO
 #include "esp_hosted.h"
@@ -59,7 +82,7 @@ LV_IMAGE_DECLARE(splash_bg);
 // Note: TX/RX pins are configured dynamically via get_uart_pins() based on NVS settings
 // M5Bus (default): TX=37, RX=38 | Grove: TX=53, RX=54
 #define UART_NUM          UART_NUM_1
-#define UART_BAUD_RATE    115200
+#define UART_BAUD_RATE    LINK_RATE_DEFAULT  // every link starts here; raised per board after the ping
 #define UART_BUF_SIZE     4096
 #define UART_RX_TIMEOUT   30000  // 30 seconds timeout for scan
 
@@ -97,9 +120,9 @@ LV_IMAGE_DECLARE(splash_bg);
 // Maximum networks to display
 #define MAX_NETWORKS      50
 #define MAX_OBSERVER_NETWORKS  100  // More capacity for background scanning
-#define MAX_CLIENTS_PER_NETWORK  20
+#define OBSERVER_MAX_CLIENTS  1024  // Shared by all networks of a tab
+#define OBSERVER_MAX_ROWS  (MAX_OBSERVER_NETWORKS + OBSERVER_MAX_CLIENTS)
 #define OBSERVER_POLL_INTERVAL_MS  20000  // 20 seconds
-#define OBSERVER_LINE_BUFFER_SIZE  512
 
 // Design-system color aliases (mapped to centralized theme tokens)
 #define COLOR_MATERIAL_BG       ui_theme_color(UI_COLOR_BG)
@@ -138,41 +161,43 @@ LV_IMAGE_DECLARE(splash_bg);
 #define SCREENSHOT_ENABLED true
 #define SCREENSHOT_DIR "/sdcard/SCREENS"
 
+// Transport trace dump - long press on the title
+#define TRANSPORT_TRACE_DIR "/sdcard/TRACE"
+#define TRANSPORT_TRACE_DUMP_LOG_RECORDS 64
+
+// Timeline traces (Chrome trace JSON): the boot report is written once the UI is
+// interactive, the previous boot's is kept next to it for perf_trace_diff.py
+#define PERF_TRACE_DIR "/sdcard/PERF"
+#define PERF_TRACE_BOOT_FILE PERF_TRACE_DIR "/boot.json"
+#define PERF_TRACE_BOOT_PREV_FILE PERF_TRACE_DIR "/boot_prev.json"
+
+// Page entry points: timed in the trace, and named in the frame monitor
+#define UI_PAGE_SCOPE(name) PERF_TRACE_SCOPE(name); ui_perf_set_page(name)
+
 // WiFi network info structure
 typedef struct {
     int index;
     char ssid[33];
-    char bssid[18];
+    mac48_t bssid;
     int rssi;
     char band[8];  // "2.4GHz" or "5GHz"
     char security[24];
 } wifi_network_t;
 
-// Observer network info structure (for sniffer results)
-typedef struct {
-    char ssid[33];
-    char bssid[18];      // MAC address of AP
-    int scan_index;      // 1-based index from scan_networks (for select_networks command)
-    int channel;
-    int rssi;            // Signal strength in dBm
-    char band[8];        // "2.4GHz" or "5GHz"
-    int client_count;
-    char clients[MAX_CLIENTS_PER_NETWORK][18];  // MAC addresses of clients
-} observer_network_t;
-
 // Deauth Detector entry
 #define DEAUTH_DETECTOR_MAX_ENTRIES 200
 typedef struct {
     int channel;
     char ap_name[33];
-    char bssid[18];
+    mac48_t bssid;
     int rssi;
+    uint32_t seq;        // Detection number, keys the table row (one AP can appear many times)
 } deauth_entry_t;
 
 // BT device storage
 #define BT_MAX_DEVICES 50
 typedef struct {
-    char mac[18];
+    mac48_t mac;
     int rssi;
     char name[64];
 } bt_device_t;
@@ -191,23 +216,29 @@ typedef struct {
     char password[65];
 } evil_twin_entry_t;
 
+// Captured credentials page (Evil Twin passwords or portal submissions), backed by
+// an indexed mirror of the board's records on the internal SD card
+#define CAPTURED_MAX_MATCHES 256
+typedef struct {
+    bool evil_twin;                 // "show_pass evil" instead of "show_pass portal"
+    portal_index_t index;
+    lv_obj_t *status_label;
+    lv_obj_t *search_ta;
+    lv_obj_t *keyboard;
+    lv_obj_t *list;
+    uint32_t *matches;              // PSRAM, record numbers of the active search
+    uint32_t match_count;
+    bool searching;
+    TaskHandle_t refresh_task;
+} captured_view_t;
+
 // ARP Host storage
 #define ARP_MAX_HOSTS 64
 typedef struct {
     char ip[20];
-    char mac[18];
+    mac48_t mac;
 } arp_host_t;
 
-// Wardrive network storage
-#define WARDRIVE_MAX_NETWORKS 100
-typedef struct {
-    char ssid[33];
-    char bssid[18];
-    char security[28];
-    char lat[14];
-    char lon[14];
-} wardrive_network_t;
-
 // Karma2 constants (for Observer)
 #define KARMA2_MAX_PROBES 64
 #define KARMA2_MAX_HTML_FILES 20
@@ -228,6 +259,7 @@ typedef struct {
     lv_obj_t *dashboard_handshake_value;
     lv_obj_t *dashboard_gps_value;
     lv_obj_t *dashboard_uptime_value;
+    lv_obj_t *dashboard_link_value;     // line rate and measured receive throughput
     lv_obj_t *dashboard_sd_status_value;
     lv_obj_t *dashboard_sd_percent_value;
     lv_obj_t *dashboard_wpa_sec_value;
@@ -236,6 +268,7 @@ typedef struct {
     lv_obj_t *dashboard_quote_value;
     int dashboard_handshake_count;
     bool dashboard_handshake_known;
+    bool dashboard_handshake_pending;   // count request queued on the dashboard worker
     int64_t dashboard_last_local_handshake_refresh_us;
     int dashboard_sd_file_count;
     bool dashboard_sd_file_known;
@@ -309,8 +342,9 @@ typedef struct {
     lv_obj_t *observer_table;
     lv_obj_t *observer_status_label;
     
-    observer_network_t *observer_networks;  // PSRAM
-    int observer_network_count;
+    observer_store_t observer_store;         // Networks by BSSID and their clients, PSRAM
+    uint32_t *observer_rows;                 // PSRAM, flattened network/client rows of the table
+    int observer_row_count;
     bool observer_running;
     bool observer_page_visible;
     TaskHandle_t observer_task;
@@ -374,15 +408,16 @@ typedef struct {
     lv_obj_t *wardrive_stop_btn;
     lv_obj_t *wardrive_status_label;
     lv_obj_t *wardrive_table;
+    lv_obj_t *wardrive_export_btn;
     lv_obj_t *wardrive_gps_overlay;
     lv_obj_t *wardrive_gps_popup;
     lv_obj_t *wardrive_gps_label;
     volatile bool wardrive_monitoring;
     bool wardrive_gps_fix;
     TaskHandle_t wardrive_task;
-    wardrive_network_t wardrive_networks[WARDRIVE_MAX_NETWORKS];
-    int wardrive_net_count;
-    int wardrive_net_head;
+    TaskHandle_t wardrive_export_task;
+    char wardrive_export_path[64];
+    wardrive_log_t wardrive_log;    // session log on SD, the table pages from it
     lv_obj_t *wardrive_gps_type_btn;
     lv_obj_t *wardrive_gps_type_overlay;
     lv_obj_t *wardrive_gps_type_response_label;
@@ -397,6 +432,8 @@ typedef struct {
     
     evil_twin_entry_t *evil_twin_entries;  // PSRAM
     int evil_twin_entry_count;
+    captured_view_t evil_twin_view;
+    captured_view_t portal_data_view;
     
     // Evil Twin -> ARP integration popup
     lv_obj_t *evil_twin_connect_popup_overlay;
@@ -435,7 +472,7 @@ typedef struct {
     // BT Locator Tracking
     lv_obj_t *bt_locator_page;
     lv_obj_t *bt_locator_rssi_label;
-    char bt_locator_target_mac[18];
+    mac48_t bt_locator_target_mac;
     char bt_locator_target_name[64];
     volatile bool bt_locator_tracking;
     TaskHandle_t bt_locator_task;
@@ -541,8 +578,7 @@ static bool scan_in_progress = false;
 static int selected_network_indices[MAX_NETWORKS];
 static int selected_network_count = 0;
 
-// Observer global variables (large arrays in PSRAM)
-static observer_network_t *observer_networks = NULL;  // Allocated in PSRAM
+// Observer global variables
 static TimerHandle_t observer_timer = NULL;
 // Note: observer_task_handle is now per-context (ctx->observer_task)
 #define POPUP_POLL_INTERVAL_MS  10000  // 10 seconds
@@ -569,10 +605,6 @@ static char evil_twin_html_files[20][64];  // Max 20 files, 64 chars each
 static volatile bool evil_twin_monitoring = false;
 static TaskHandle_t evil_twin_monitor_task_handle = NULL;
 
-// PSRAM buffers for observer (allocated once)
-static char *observer_rx_buffer = NULL;
-static char *observer_line_buffer = NULL;
-
 // LVGL UI elements - pages
 static lv_obj_t *tiles_container = NULL;
 static lv_obj_t *scan_page = NULL;
@@ -712,10 +744,16 @@ static sd_theme_entry_t sd_themes[MAX_SD_THEMES];
 static size_t sd_theme_count = 0;
 static char active_theme_id[MAX_THEME_NAME_LEN] = "default";
 static bool dashboard_enabled_preference = true;
+static bool perf_overlay_enabled = false;    // frame monitor overlay (ui_perf)
+static bool perf_log_enabled = false;        // frame monitor CSV log on SD
 static bool active_theme_has_background_image = false;
 static char active_theme_background_image[MAX_THEME_PATH_LEN];
 static char active_theme_uart_icon_paths[UART_MAIN_TILE_COUNT][MAX_THEME_PATH_LEN];
 static char active_theme_internal_icon_paths[INTERNAL_MAIN_TILE_COUNT][MAX_THEME_PATH_LEN];
+// Icons are decoded into the atlas the first time a tile needs one after a theme is applied
+// (boot applies the theme before LVGL is up); the icon benchmark turns the atlas off for its baseline
+static bool theme_icon_atlas_stale = true;
+static bool theme_icon_atlas_enabled = true;
 static bool active_theme_icon_tint_enabled = false;
 static lv_color_t active_theme_icon_tint;
 static uint8_t active_theme_icon_tint_opa = LV_OPA_COVER;
@@ -932,10 +970,15 @@ static void init_tab_context(tab_context_t *ctx) {
     }
     
     // Observer networks
-    if (!ctx->observer_networks) {
-        ctx->observer_networks = heap_caps_calloc(MAX_OBSERVER_NETWORKS, sizeof(observer_network_t), MALLOC_CAP_SPIRAM);
-        if (!ctx->observer_networks) {
-            ESP_LOGE(TAG, "Failed to allocate observer_networks in PSRAM");
+    if (!ctx->observer_store.networks) {
+        if (!observer_store_init(&ctx->observer_store, MAX_OBSERVER_NETWORKS, OBSERVER_MAX_CLIENTS)) {
+            ESP_LOGE(TAG, "Failed to allocate observer store in PSRAM");
+        }
+    }
+    if (!ctx->observer_rows) {
+        ctx->observer_rows = heap_caps_calloc(OBSERVER_MAX_ROWS, sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+        if (!ctx->observer_rows) {
+            ESP_LOGE(TAG, "Failed to allocate observer_rows in PSRAM");
         }
     }
     
@@ -1014,11 +1057,11 @@ static void restore_tab_context_to_globals(tab_context_t *ctx) {
     }
     
     // Observer now uses ctx-> directly, no need to restore globals
-    // Each tab has its own independent observer data in ctx->observer_networks
+    // Each tab has its own independent observer data in ctx->observer_store
     ESP_LOGI(TAG, "Tab %d observer_running=%d, network_count=%d",
              (int)tab_id_for_ctx(ctx),
              ctx->observer_running,
-             ctx->observer_network_count);
+             ctx->observer_store.network_count);
     
 }
 
@@ -1209,6 +1252,7 @@ static int karma_html_count = 0;
 
 static httpd_handle_t portal_server = NULL;
 static bool portal_active = false;
+static portal_journal_t portal_journal;     // portals.txt writer, fed by the httpd task
 static char *portal_ssid = NULL;
 static char *custom_portal_html = NULL;
 static int dns_server_socket = -1;
@@ -1277,6 +1321,7 @@ static const char *default_portal_html =
 // Deauth Detector (global legacy - type defined earlier)
 static deauth_entry_t deauth_entries[DEAUTH_DETECTOR_MAX_ENTRIES];
 static int deauth_entry_count = 0;
+static uint32_t deauth_entry_seq = 0;
 static lv_obj_t *deauth_detector_page = NULL;
 static lv_obj_t *deauth_table = NULL;
 static lv_obj_t *deauth_start_btn = NULL;
@@ -1297,7 +1342,7 @@ static volatile bool airtag_scanning = false;
 static TaskHandle_t airtag_scan_task_handle = NULL;
 
 // BT Locator tracking
-static char bt_locator_target_mac[18] = {0};
+static mac48_t bt_locator_target_mac = {0};
 static char bt_locator_target_name[64] = {0};
 static lv_obj_t *bt_locator_rssi_label = NULL;
 static volatile bool bt_locator_tracking = false;
@@ -1334,6 +1379,8 @@ static void show_theme_page(void);
 static void theme_back_btn_event_cb(lv_event_t *e);
 static void close_theme_popup(void);
 static void refresh_sd_themes_cache(void);
+static void reset_sd_themes_cache(void);
+static void load_active_sd_theme(const char *theme_id);
 static void apply_selected_theme_index(size_t idx, bool persist);
 static size_t find_theme_index_by_id(const char *theme_id);
 static bool parse_layout_json_file(const char *layout_path, theme_layout_profile_t *out_layout);
@@ -1365,16 +1412,15 @@ static void observer_back_btn_event_cb(lv_event_t *e);
 static void esp_modem_back_btn_event_cb(lv_event_t *e);
 static void esp_modem_scan_btn_click_cb(lv_event_t *e);
 static esp_err_t esp_modem_wifi_init(void);
-static void network_row_click_cb(lv_event_t *e);
-static void client_row_click_cb(lv_event_t *e);
+static void observer_row_click_cb(lv_event_t *e);
 static void show_network_popup(int network_idx);
 static void close_network_popup(void);
 static void show_deauth_popup(int network_idx, int client_idx);
 static void close_deauth_popup(void);
 static void deauth_btn_click_cb(lv_event_t *e);
 static void update_observer_table(tab_context_t *ctx);
-static bool parse_sniffer_network_line(const char *line, observer_network_t *net);
-static bool parse_sniffer_client_line(const char *line, char *mac_out, size_t mac_size);
+static bool parse_sniffer_network_line(const char *line, char *ssid, size_t ssid_size, int *channel);
+static bool parse_sniffer_client_line(const char *line, mac48_t *mac_out);
 static void show_scan_deauth_popup(void);
 static void scan_deauth_popup_close_cb(lv_event_t *e);
 static void fetch_html_files_from_sd(void);
@@ -1390,7 +1436,7 @@ static void handshaker_popup_close_cb(lv_event_t *e);
 static void handshaker_monitor_task(void *arg);
 static void show_arp_poison_page(void);
 static void show_rogue_ap_page(void);
-static void show_rogue_ap_popup(tab_context_t *ctx);
+static void show_rogue_ap_popup(tab_context_t *ctx, rx_demux_sub_t *rx_sub);
 static void arp_poison_back_cb(lv_event_t *e);
 static void arp_connect_cb(lv_event_t *e);
 static void arp_list_hosts_cb(lv_event_t *e);
@@ -1445,7 +1491,7 @@ static esp_err_t captive_detection_handler(httpd_req_t *req);
 static esp_err_t captive_portal_redirect_handler(httpd_req_t *req);
 static void show_karma2_attack_popup(const char *ssid);
 static void karma2_attack_stop_cb(lv_event_t *e);
-static void save_portal_data(const char *ssid, const char *form_data);
+static void save_portal_data(const char *ssid, const char *form_data, const char *password);
 
 static void show_scan_overlay(void);
 static void hide_scan_overlay(void);
@@ -1460,6 +1506,7 @@ static void show_scan_time_popup(void);
 static void show_red_team_settings_page(void);
 static void show_screen_timeout_popup(void);
 static void show_screen_brightness_popup(void);
+static void show_perf_monitor_popup(void);
 static void get_uart1_pins(int *tx_pin, int *rx_pin);
 static void get_uart2_pins(int *tx_pin, int *rx_pin);
 static void init_uart2(void);
@@ -1475,6 +1522,7 @@ static void board_detect_popup_close_cb(lv_event_t *e);
 static void reload_gui_for_detection(void);
 static void show_detection_popup(void);
 static void detection_complete_cb(lv_timer_t *timer);
+static void finish_boot_detection(void);
 static void update_portal_icon(void);
 static void karma2_attack_background_cb(lv_event_t *e);
 
@@ -1487,6 +1535,10 @@ static void show_internal_tiles(void);
 static void update_tab_styles(void);
 static uart_port_t get_current_uart(void);
 static void uart_send_command_for_tab(const char *cmd);
+static rx_demux_sub_t *transport_rx_subscribe_tab(tab_id_t tab, uart_port_t port, const char *prefix);
+static void transport_wire_negotiate(tab_id_t tab, uart_port_t port, const char *pong);
+static void transport_link_negotiate(tab_id_t tab, uart_port_t port, const char *pong);
+static void transport_link_reset(tab_id_t tab, uart_port_t port);
 static void show_blackout_confirm_popup(void);
 static void blackout_confirm_yes_cb(lv_event_t *e);
 static void blackout_confirm_no_cb(lv_event_t *e);
@@ -1705,9 +1757,92 @@ static void update_battery_status(void)
     current_charging_status = get_charging_status();
 }
 
+//==================================================================================
+// UI timing instrumentation
+//==================================================================================
+// Frame stats come from ui_perf once a second; they are folded into a longer window
+// here, together with the periodic status timer. Anything that blocks the LVGL
+// task on I/O shows up as frames over the budget.
+
+#define UI_TIMING_LOG_INTERVAL_US   (30 * 1000 * 1000)
+
+typedef struct {
+    int64_t window_start_us;
+    uint32_t frames;
+    uint32_t slow_frames;
+    int64_t frame_total_us;
+    int64_t frame_max_us;
+    int64_t timer_max_us;
+} ui_timing_stats_t;
+
+static ui_timing_stats_t ui_timing = {0};
+
+static void ui_timing_sample_cb(const ui_perf_sample_t *sample, void *user)
+{
+    (void)user;
+    ui_timing.frames += sample->frames;
+    ui_timing.slow_frames += sample->over_budget;
+    ui_timing.frame_total_us += (int64_t)sample->frame_avg_us * sample->frames;
+    if (sample->frame_max_us > ui_timing.frame_max_us) {
+        ui_timing.frame_max_us = sample->frame_max_us;
+    }
+}
+
+static void ui_timing_init(lv_display_t *disp)
+{
+    if (!disp) {
+        return;
+    }
+    ui_perf_init(disp);
+    ui_perf_set_sample_cb(ui_timing_sample_cb, NULL);
+    ui_timing.window_start_us = esp_timer_get_time();
+}
+
+// Log what an incremental table update dirtied, relative to counters taken before it
+static void ui_log_update_cost(const char *what, const ui_comp_update_counters_t *before)
+{
+    ui_comp_update_counters_t after;
+    ui_comp_get_update_counters(&after);
+    ESP_LOGD(TAG, "%s update: %lu objects touched, %lu px invalidated", what,
+             (unsigned long)(after.objects_touched - before->objects_touched),
+             (unsigned long)(after.invalidated_px - before->invalidated_px));
+}
+
+// Called at the end of the status timer with its start time; also flushes the stats window
+static void ui_timing_note_timer(int64_t start_us)
+{
+    int64_t now_us = esp_timer_get_time();
+    int64_t timer_us = now_us - start_us;
+    if (timer_us > ui_timing.timer_max_us) {
+        ui_timing.timer_max_us = timer_us;
+    }
+
+    if ((now_us - ui_timing.window_start_us) < UI_TIMING_LOG_INTERVAL_US) {
+        return;
+    }
+
+    int64_t avg_us = ui_timing.frames > 0 ? ui_timing.frame_total_us / ui_timing.frames : 0;
+    if (ui_timing.slow_frames > 0) {
+        ESP_LOGW(TAG, "UI timing: %lu/%lu refreshes over %d ms (max %lld us, avg %lld us), status timer max %lld us",
+                 (unsigned long)ui_timing.slow_frames, (unsigned long)ui_timing.frames,
+                 UI_PERF_FRAME_BUDGET_US / 1000, ui_timing.frame_max_us, avg_us, ui_timing.timer_max_us);
+    } else {
+        ESP_LOGD(TAG, "UI timing: %lu refreshes (max %lld us, avg %lld us), status timer max %lld us",
+                 (unsigned long)ui_timing.frames, ui_timing.frame_max_us, avg_us, ui_timing.timer_max_us);
+    }
+
+    ui_timing.window_start_us = now_us;
+    ui_timing.frames = 0;
+    ui_timing.slow_frames = 0;
+    ui_timing.frame_total_us = 0;
+    ui_timing.frame_max_us = 0;
+    ui_timing.timer_max_us = 0;
+}
+
 static void battery_status_timer_cb(lv_timer_t *timer)
 {
     (void)timer;
+    int64_t timer_start_us = esp_timer_get_time();
     
     // Read new values
     update_battery_status();
@@ -1782,6 +1917,7 @@ static void battery_status_timer_cb(lv_timer_t *timer)
     }
 
     update_live_dashboard_for_ctx(get_current_ctx());
+    ui_timing_note_timer(timer_start_us);
 }
 
 // Get screen timeout in milliseconds based on setting
@@ -1897,6 +2033,17 @@ static bool usb_cdc_preferred_valid = false;
 static uint8_t usb_cdc_preferred_itf = 0;
 static uint16_t usb_last_vid = 0;
 static uint16_t usb_last_pid = 0;
+// Woken by the CDC driver task when data lands in its RX ring (and on connect /
+// disconnect), so readers sleep until something happens instead of for a fixed time
+static bool usb_rx_cdc_connected(void *ctx);
+static esp_err_t usb_rx_cdc_rx_size(void *ctx, size_t *size);
+static esp_err_t usb_rx_cdc_read(void *ctx, uint8_t *buf, size_t *len);
+static const usb_rx_cdc_t usb_rx_cdc = {
+    .connected = usb_rx_cdc_connected,
+    .rx_size = usb_rx_cdc_rx_size,
+    .read = usb_rx_cdc_read,
+};
+static usb_rx_wait_t usb_rx = { .cdc = &usb_rx_cdc };
 
 #define CP210X_VID 0x10C4
 #define CP210X_REQTYPE_HOST_TO_DEVICE 0x41
@@ -2182,6 +2329,7 @@ static void usb_cdc_connect_cb(usbh_cdc_handle_t cdc_handle, void *user_data)
     if (usb_last_vid == CP210X_VID) {
         cp210x_init_port(usb_cdc_preferred_itf);
     }
+    usb_rx_wait_notify(&usb_rx);
     
     schedule_board_redetect();
 }
@@ -2201,16 +2349,19 @@ static void usb_cdc_disconnect_cb(usbh_cdc_handle_t cdc_handle, void *user_data)
     usb_last_vid = 0;
     usb_last_pid = 0;
     ESP_LOGW(TAG, "[USB] CDC device disconnected");
+    usb_rx_wait_notify(&usb_rx);
     if (usb_debug_logs) {
         usb_log_cdc_state("disconnect");
     }
     schedule_board_redetect();
 }
 
+// Runs on the USB host client task after the bytes are already in the driver's ring
 static void usb_cdc_recv_cb(usbh_cdc_handle_t cdc_handle, void *user_data)
 {
     (void)cdc_handle;
     (void)user_data;
+    usb_rx_wait_notify(&usb_rx);
 }
 
 static void usb_cdc_notif_cb(usbh_cdc_handle_t cdc_handle, iot_cdc_notification_t *notif, void *user_data)
@@ -2234,6 +2385,7 @@ static void usb_cdc_notif_cb(usbh_cdc_handle_t cdc_handle, iot_cdc_notification_
 
 static void usb_transport_init(void)
 {
+    usb_rx_wait_start(&usb_rx);
     if (usb_transport_ready) {
         return;
     }
@@ -2375,9 +2527,7 @@ static int usb_transport_write(const char *data, size_t len)
         }
         return 0;
     }
-    
-    ESP_LOGD(TAG, "[USB] Writing %zu bytes: %.*s", len, (int)(len > 50 ? 50 : len), data);
-    
+
     esp_err_t err = usbh_cdc_write_bytes(usb_cdc_handle, (const uint8_t *)data, len, pdMS_TO_TICKS(200));
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "[USB] CDC write failed: %s", esp_err_to_name(err));
@@ -2386,155 +2536,611 @@ static int usb_transport_write(const char *data, size_t len)
         }
         return 0;
     }
-    
-    ESP_LOGD(TAG, "[USB] Write successful: %zu bytes", len);
     return (int)len;
 }
 
-static int usb_transport_read(void *data, size_t len, TickType_t ticks_to_wait)
+// usb_rx's view of iot_usbh_cdc
+static bool usb_rx_cdc_connected(void *ctx)
 {
-    if (!usb_transport_ready) {
-        ESP_LOGD(TAG, "[USB] Transport not ready for read, initializing...");
-        usb_transport_init();
+    (void)ctx;
+    return usb_transport_ready && usb_cdc_handle && usb_cdc_connected;
+}
+
+static esp_err_t usb_rx_cdc_rx_size(void *ctx, size_t *size)
+{
+    (void)ctx;
+    return usbh_cdc_get_rx_buffer_size(usb_cdc_handle, size);
+}
+
+static esp_err_t usb_rx_cdc_read(void *ctx, uint8_t *buf, size_t *len)
+{
+    (void)ctx;
+    esp_err_t err = usbh_cdc_read_bytes(usb_cdc_handle, buf, len, 0);
+    // ESP_FAIL often means no data available - treat as timeout (normal during polling)
+    // ESP_ERR_TIMEOUT is also normal
+    // Only log actual unexpected errors
+    if (err != ESP_OK && err != ESP_ERR_TIMEOUT && err != ESP_FAIL) {
+        ESP_LOGW(TAG, "[USB] CDC read error: %s (0x%x)", esp_err_to_name(err), err);
+        if (usb_debug_logs) {
+            usb_log_cdc_state("read_error");
+        }
     }
-    if (!usb_cdc_handle || !usb_cdc_connected) {
-        ESP_LOGD(TAG, "[USB] Read failed: no CDC device (handle=%p, connected=%d)",
-                 (void*)usb_cdc_handle, usb_cdc_connected);
+    return err;
+}
+
+// Grove, USB and MBus, in this order: index into transport_rx[] and trace channel
+static transport_trace_t transport_tracer;
+
+static uint8_t transport_channel(tab_id_t tab, uart_port_t port)
+{
+    if (port == UART2_NUM) {
+        return 2;
+    }
+    return tab == TAB_USB ? 1 : 0;
+}
+
+static int transport_write_bytes_tab(tab_id_t tab, uart_port_t port, const char *data, size_t len)
+{
+    int written = (port == UART_NUM && tab == TAB_USB) ? usb_transport_write(data, len)
+                                                       : uart_write_bytes(port, data, len);
+    if (written > 0) {
+        transport_trace(&transport_tracer, transport_channel(tab, port), TRANSPORT_TRACE_TX, data, (size_t)written);
+    }
+    return written;
+}
+
+static int transport_write_bytes(uart_port_t port, const char *data, size_t len)
+{
+    return transport_write_bytes_tab(current_tab, port, data, len);
+}
+
+//==================================================================================
+// Transport RX demultiplexing
+//==================================================================================
+
+// One reader task per physical transport (Grove UART, USB CDC, MBus UART).
+// It frames lines once and hands them to every subscriber, so several features
+// can listen on the same port without stealing each other's bytes.
+// Ring size must be a power of two; lines longer than this are truncated.
+#define TRANSPORT_RX_RING_SIZE  4096
+#define TRANSPORT_RX_COUNT      3
+#define TRANSPORT_RX_PRIORITY   6
+
+#define TRANSPORT_RX_RAW_SIZE   512
+#define TRANSPORT_SESSION_PRIORITY  5
+
+typedef struct {
+    tab_id_t tab;
+    uart_port_t port;
+    rx_demux_t demux;
+    bool ready;
+    wire_rx_t *wire;            // PSRAM, takes binary frames out of the stream
+    uint8_t *raw;               // PSRAM, bytes read but not yet through the filter
+    size_t raw_len;
+    size_t raw_pos;
+    bool wire_binary;           // board agreed to send framed records
+    uint32_t baud;              // current line rate, 0 until the reader starts
+    link_rate_meter_t meter;    // received bytes, for the dashboard
+    uint32_t link_errors_seen;  // wire CRC/frame errors already accounted for
+    uint32_t link_error_count;  // errors in the current window at a raised rate
+    uint32_t link_error_window_ms;
+    volatile bool link_fallback_running;
+    cmd_session_t session;      // command/response exchanges on this transport
+} transport_rx_t;
+
+static transport_rx_t transport_rx[TRANSPORT_RX_COUNT];
+
+#define TRANSPORT_LINK_ERROR_LIMIT      3       // errors per window before stepping the rate down
+#define TRANSPORT_LINK_ERROR_WINDOW_MS  10000
+
+static uint32_t transport_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static int transport_rx_read_port(transport_rx_t *rx, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    if (rx->tab == TAB_USB) {
+        // Don't let the reader bring up the USB host; wait for a device instead
+        return usb_rx_wait_reader_read(&usb_rx, dst, len, (TickType_t)timeout);
+    }
+
+    if (rx->port == UART2_NUM && !uart2_initialized) {
+        vTaskDelay((TickType_t)timeout);
         return 0;
     }
-    size_t rx_size = 0;
-    esp_err_t rx_err = usbh_cdc_get_rx_buffer_size(usb_cdc_handle, &rx_size);
-    if (rx_err == ESP_OK && rx_size == 0) {
-        if (ticks_to_wait > 0) {
-            vTaskDelay(ticks_to_wait);
-            rx_err = usbh_cdc_get_rx_buffer_size(usb_cdc_handle, &rx_size);
+
+    // Block for the first byte only, then take whatever else is already buffered,
+    // so a line is dispatched as soon as it arrives instead of after the timeout
+    size_t buffered = 0;
+    uart_get_buffered_data_len(rx->port, &buffered);
+    if (buffered == 0) {
+        int n = uart_read_bytes(rx->port, dst, 1, (TickType_t)timeout);
+        if (n <= 0) {
+            return n;
         }
-        if (rx_err == ESP_OK && rx_size == 0) {
-            return 0;
+        uart_get_buffered_data_len(rx->port, &buffered);
+        if (buffered > len - 1) {
+            buffered = len - 1;
         }
+        int more = buffered > 0 ? uart_read_bytes(rx->port, dst + 1, buffered, 0) : 0;
+        return 1 + (more > 0 ? more : 0);
+    }
+    if (buffered > len) {
+        buffered = len;
     }
+    return uart_read_bytes(rx->port, dst, buffered, 0);
+}
 
-    size_t read_len = len;
-    esp_err_t err = usbh_cdc_read_bytes(usb_cdc_handle, (uint8_t *)data, &read_len, 0);
-    if (err != ESP_OK) {
-        // ESP_FAIL often means no data available - treat as timeout (normal during polling)
-        // ESP_ERR_TIMEOUT is also normal
-        // Only log actual unexpected errors
-        if (err != ESP_ERR_TIMEOUT && err != ESP_FAIL) {
-            ESP_LOGW(TAG, "[USB] CDC read error: %s (0x%x)", esp_err_to_name(err), err);
-            if (usb_debug_logs) {
-                usb_log_cdc_state("read_error");
-            }
+// Idle reads are counted too, so the meter closes its window when a burst ends
+static int transport_rx_read_raw(transport_rx_t *rx, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    int n = transport_rx_read_port(rx, dst, len, timeout);
+    link_rate_meter_add(&rx->meter, n > 0 ? (size_t)n : 0, transport_now_ms());
+    if (n > 0) {
+        transport_trace(&transport_tracer, transport_channel(rx->tab, rx->port), TRANSPORT_TRACE_RX, dst, (size_t)n);
+    }
+    return n;
+}
+
+static void transport_link_fallback_task(void *arg);
+
+// Framed records carry a CRC, so a raised rate that garbles them is noticed
+// here; a few errors in a short window step the link one rung down
+static void transport_link_check_errors(transport_rx_t *rx)
+{
+    uint32_t errors = rx->wire->stats.crc_errors + rx->wire->stats.bad_frames;
+    if (errors == rx->link_errors_seen) {
+        return;
+    }
+    uint32_t added = errors - rx->link_errors_seen;
+    rx->link_errors_seen = errors;
+    if (rx->baud <= LINK_RATE_DEFAULT || rx->link_fallback_running) {
+        return;
+    }
+
+    uint32_t now = transport_now_ms();
+    if (now - rx->link_error_window_ms > TRANSPORT_LINK_ERROR_WINDOW_MS) {
+        rx->link_error_window_ms = now;
+        rx->link_error_count = 0;
+    }
+    rx->link_error_count += added;
+    if (rx->link_error_count < TRANSPORT_LINK_ERROR_LIMIT) {
+        return;
+    }
+
+    // The step talks through this reader, so it can't run on the reader task
+    rx->link_error_count = 0;
+    rx->link_fallback_running = true;
+    if (xTaskCreate(transport_link_fallback_task, "link_fallback", 4096, rx, 5, NULL) != pdPASS) {
+        rx->link_fallback_running = false;
+    }
+}
+
+// Frames no subscriber takes as records are decoded into the text lines the board would
+// have sent, so the line framer and every subscriber see the same stream in text and binary mode
+static int transport_rx_read_cb(void *user_data, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    transport_rx_t *rx = (transport_rx_t *)user_data;
+    if (!rx->wire) {
+        return transport_rx_read_raw(rx, dst, len, timeout);
+    }
+
+    size_t produced = 0;
+    bool may_block = true;
+    for (;;) {
+        size_t used = 0;
+        produced += wire_rx_process(rx->wire, rx->raw + rx->raw_pos, rx->raw_len - rx->raw_pos, &used,
+                                    dst + produced, len - produced);
+        rx->raw_pos += used;
+        if (produced > 0 || len == 0) {
+            break;
         }
-        return 0;
+        // Everything so far was part of a frame; only the first read may wait
+        int n = transport_rx_read_raw(rx, rx->raw, TRANSPORT_RX_RAW_SIZE, may_block ? timeout : 0);
+        may_block = false;
+        rx->raw_pos = 0;
+        rx->raw_len = n > 0 ? (size_t)n : 0;
+        if (rx->raw_len == 0) {
+            break;
+        }
+    }
+    transport_link_check_errors(rx);
+    return (int)produced;
+}
+
+static transport_rx_t *transport_rx_for_tab(tab_id_t tab, uart_port_t port)
+{
+    return &transport_rx[transport_channel(tab, port)];
+}
+
+_Static_assert(sizeof(wire_record_t) <= RX_DEMUX_RECORD_MAX, "wire records must fit a demux record");
+
+// Records a subscriber asked for reach it as decoded structs; nobody has to render
+// them to text and parse them back. Declined records become text lines as before.
+static bool transport_rx_record_cb(void *ctx, const wire_record_t *rec)
+{
+    transport_rx_t *rx = (transport_rx_t *)ctx;
+    // Only the type's own fields, so a subscriber's buffer holds several times more scan rows
+    return rx_demux_dispatch_record(&rx->demux, rec->type, rec, wire_record_size(rec));
+}
+
+// Time consumers spend turning board output into their own structs, text lines against
+// wire records; logged when a consumer finishes, to compare the two modes on the device
+typedef struct {
+    uint32_t lines;
+    uint32_t records;
+    int64_t line_us;
+    int64_t record_us;
+} rx_parse_cost_t;
+
+static void rx_parse_cost_add(rx_parse_cost_t *cost, const rx_demux_msg_t *msg, int64_t start_us)
+{
+    int64_t us = esp_timer_get_time() - start_us;
+    if (msg->record) {
+        cost->records++;
+        cost->record_us += us;
+    } else {
+        cost->lines++;
+        cost->line_us += us;
+    }
+}
+
+static void rx_parse_cost_log(const char *name, const char *what, const rx_parse_cost_t *cost)
+{
+    ESP_LOGI(TAG, "[%s] %s parse: %lu lines in %lld us, %lu records in %lld us", name, what,
+             (unsigned long)cost->lines, (long long)cost->line_us,
+             (unsigned long)cost->records, (long long)cost->record_us);
+}
+
+static int transport_session_write_cb(void *ctx, const char *data, size_t len)
+{
+    transport_rx_t *rx = (transport_rx_t *)ctx;
+    return transport_write_bytes_tab(rx->tab, rx->port, data, len);
+}
+
+// NULL for the internal tab or when the transport's reader isn't running;
+// cmd_session_* treat that as CMD_ERROR
+static cmd_session_t *transport_session_for_tab(tab_id_t tab, uart_port_t port)
+{
+    if (tab_is_internal(tab)) {
+        return NULL;
     }
-    if (read_len > 0) {
-        // Log raw bytes received from USB (hex + ASCII for debugging)
-        char hex_buf[128];
-        char ascii_buf[64];
-        size_t log_len = read_len > 32 ? 32 : read_len;  // Limit to 32 bytes in log
-        for (size_t i = 0; i < log_len; i++) {
-            uint8_t b = ((uint8_t*)data)[i];
-            snprintf(hex_buf + i*3, 4, "%02X ", b);
-            ascii_buf[i] = (b >= 32 && b < 127) ? (char)b : '.';
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    return rx->ready && rx->session.task ? &rx->session : NULL;
+}
+
+// JanOS console responses have no terminator of their own. Listings end when the
+// board stops printing, so those requests end after a short quiet period.
+#define TRANSPORT_SESSION_QUIET_MS  250
+
+static const char *const sd_fail_markers[] = { "Failed to initialize SD card", NULL };
+
+// Fan-out targets for every board found by detect_boards(), Grove, USB, MBus order;
+// targets[i] collects its response in bufs[i]. Returns the number of targets.
+static size_t transport_detected_targets(cmd_fanout_target_t targets[TRANSPORT_RX_COUNT],
+                                         char *const bufs[TRANSPORT_RX_COUNT], size_t buf_size)
+{
+    const bool detected[TRANSPORT_RX_COUNT] = { grove_detected, usb_detected, mbus_detected && uart2_initialized };
+    size_t count = 0;
+    for (int i = 0; i < TRANSPORT_RX_COUNT; i++) {
+        if (!detected[i]) {
+            continue;
         }
-        hex_buf[log_len * 3] = '\0';
-        ascii_buf[log_len] = '\0';
-        ESP_LOGI(TAG, "[USB] Read %zu bytes: [%s] \"%s\"%s", 
-                 read_len, hex_buf, ascii_buf, read_len > 32 ? "..." : "");
+        transport_rx_t *rx = &transport_rx[i];
+        bufs[count][0] = '\0';
+        targets[count] = (cmd_fanout_target_t){
+            .session = transport_session_for_tab(rx->tab, rx->port),
+            .name = tab_transport_name(rx->tab),
+            .out = bufs[count],
+            .out_cap = buf_size,
+        };
+        count++;
     }
-    return (int)read_len;
+    return count;
 }
 
-static void usb_flush_input(uint32_t max_ms)
+// Start the reader tasks (after the UART drivers are installed)
+static void transport_rx_init(void)
 {
-    if (!usb_cdc_handle || !usb_cdc_connected) {
+    static const tab_id_t tabs[TRANSPORT_RX_COUNT] = { TAB_GROVE, TAB_USB, TAB_MBUS };
+    static const uart_port_t ports[TRANSPORT_RX_COUNT] = { UART_NUM, UART_NUM, UART2_NUM };
+    static const char *const names[TRANSPORT_TRACE_CHANNELS] = { "Grove", "USB", "MBus" };
+
+    if (!transport_trace_init(&transport_tracer, names)) {
+        ESP_LOGW(TAG, "Transport trace unavailable");
+    }
+
+    for (int i = 0; i < TRANSPORT_RX_COUNT; i++) {
+        transport_rx_t *rx = &transport_rx[i];
+        rx->tab = tabs[i];
+        rx->port = ports[i];
+        rx->baud = UART_BAUD_RATE;
+        link_rate_meter_reset(&rx->meter, transport_now_ms());
+
+        // Without the filter buffers the transport still works, text only
+        rx->wire = heap_caps_malloc(sizeof(wire_rx_t), MALLOC_CAP_SPIRAM);
+        rx->raw = heap_caps_malloc(TRANSPORT_RX_RAW_SIZE, MALLOC_CAP_SPIRAM);
+        if (rx->wire && rx->raw) {
+            wire_rx_init(rx->wire);
+            wire_rx_set_record_fn(rx->wire, transport_rx_record_cb, rx);
+        } else {
+            heap_caps_free(rx->wire);
+            heap_caps_free(rx->raw);
+            rx->wire = NULL;
+            rx->raw = NULL;
+        }
+
+        uint8_t *ring = heap_caps_malloc(TRANSPORT_RX_RING_SIZE + 1, MALLOC_CAP_SPIRAM);
+        char *scratch = heap_caps_malloc(TRANSPORT_RX_RING_SIZE + 1, MALLOC_CAP_SPIRAM);
+        if (!ring || !scratch) {
+            ESP_LOGE(TAG, "Failed to allocate RX framer buffers for %s", tab_transport_name(rx->tab));
+            heap_caps_free(ring);
+            heap_caps_free(scratch);
+            continue;
+        }
+        rx->ready = rx_demux_start(&rx->demux, tab_transport_name(rx->tab), ring, scratch,
+                                   TRANSPORT_RX_RING_SIZE, transport_rx_read_cb, rx, TRANSPORT_RX_PRIORITY);
+        if (!rx->ready) {
+            ESP_LOGE(TAG, "Failed to start RX reader for %s", tab_transport_name(rx->tab));
+            continue;
+        }
+        if (!cmd_session_start(&rx->session, tab_transport_name(rx->tab), &rx->demux,
+                               transport_session_write_cb, rx, TRANSPORT_SESSION_PRIORITY)) {
+            ESP_LOGE(TAG, "Failed to start command session for %s", tab_transport_name(rx->tab));
+        }
+    }
+}
+
+// A board that speaks the framed protocol says so in its pong ("pong wire=1");
+// ask it to switch. Boards without it, or after a reboot, simply keep sending text.
+static void transport_wire_negotiate(tab_id_t tab, uart_port_t port, const char *pong)
+{
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    const char *cap = strstr(pong, WIRE_PONG_CAPABILITY);
+    int version = cap ? atoi(cap + strlen(WIRE_PONG_CAPABILITY)) : 0;
+
+    rx->wire_binary = false;
+    if (!rx->wire || version < WIRE_VERSION) {
         return;
     }
-    uint8_t tmp[64];
-    uint32_t start_ms = esp_timer_get_time() / 1000;
-    while ((esp_timer_get_time() / 1000) - start_ms < max_ms) {
-        size_t rx_size = 0;
-        if (usbh_cdc_get_rx_buffer_size(usb_cdc_handle, &rx_size) != ESP_OK || rx_size == 0) {
-            break;
+
+    char cmd[16];
+    int len = snprintf(cmd, sizeof(cmd), "wire %d\r\n", WIRE_VERSION);
+    if (transport_write_bytes_tab(tab, port, cmd, (size_t)len) > 0) {
+        rx->wire_binary = true;
+        ESP_LOGI(TAG, "[%s] Board supports wire v%d, binary records enabled", tab_transport_name(tab), version);
+    }
+}
+
+// Local end of a link. USB goes through the CP210x bridge; other USB serial chips
+// (and native USB consoles) have no line rate to change.
+static bool transport_link_set_local(transport_rx_t *rx, uint32_t baud)
+{
+    if (rx->tab == TAB_USB) {
+        if (!usb_cdc_handle || usb_last_vid != CP210X_VID) {
+            return false;
+        }
+        cp210x_send_baudrate(baud, usb_cdc_preferred_itf);
+    } else {
+        if (rx->port == UART2_NUM && !uart2_initialized) {
+            return false;
+        }
+        if (uart_set_baudrate(rx->port, baud) != ESP_OK) {
+            return false;
         }
-        size_t read_len = rx_size > sizeof(tmp) ? sizeof(tmp) : rx_size;
-        usbh_cdc_read_bytes(usb_cdc_handle, tmp, &read_len, 0);
+        uart_flush_input(rx->port);
     }
-    if (usb_debug_logs) {
-        ESP_LOGI(TAG, "[USB] Flushed input for %u ms", (unsigned)max_ms);
+    rx->baud = baud;
+    return true;
+}
+
+// Wait for a line starting with expect; other "baud" lines (e.g. a command echo) are skipped
+static bool transport_link_wait(rx_demux_sub_t *sub, const char *expect, const char *pattern,
+                                size_t pattern_len, uint32_t timeout_ms)
+{
+    uint32_t start = transport_now_ms();
+    for (;;) {
+        uint32_t elapsed = transport_now_ms() - start;
+        if (elapsed >= timeout_ms) {
+            return false;
+        }
+        line_view_t line;
+        if (!rx_demux_next_line(sub, &line, pdMS_TO_TICKS(timeout_ms - elapsed))) {
+            return false;
+        }
+        if (pattern ? link_rate_check_echo(line.text, pattern, pattern_len)
+                    : strncmp(line.text, expect, strlen(expect)) == 0) {
+            return true;
+        }
     }
 }
 
-// Ping USB device to verify it responds (similar to ping_uart_direct for Grove/MBus)
-static bool ping_usb(void)
+// One rung: agree on the rate, switch, prove both directions with the test pattern,
+// then commit. On failure the board reverts by itself once the commit timeout passes.
+static bool transport_link_step(transport_rx_t *rx, uint32_t baud)
 {
-    if (!usb_cdc_handle || !usb_cdc_connected) {
-        ESP_LOGW(TAG, "[USB] Cannot ping - no CDC device connected");
+    const char *name = tab_transport_name(rx->tab);
+    uint32_t prev = rx->baud;
+    rx_demux_sub_t *sub = transport_rx_subscribe_tab(rx->tab, rx->port, "baud");
+    if (!sub) {
         return false;
     }
-    
-    // Flush RX buffer before ping (drain any boot/menu spam)
-    usb_flush_input(200);
-    
-    // Send ping command
-    const char *ping_cmd = "ping\r\n";
-    int written = usb_transport_write(ping_cmd, strlen(ping_cmd));
-    if (written <= 0) {
-        ESP_LOGW(TAG, "[USB] Failed to send ping");
+
+    char cmd[LINK_RATE_TEST_LEN + 16];
+    char expect[24];
+    int len = snprintf(cmd, sizeof(cmd), "baud %lu\r\n", (unsigned long)baud);
+    snprintf(expect, sizeof(expect), "baud ok %lu", (unsigned long)baud);
+    transport_write_bytes_tab(rx->tab, rx->port, cmd, (size_t)len);
+    if (!transport_link_wait(sub, expect, NULL, 0, 500)) {
+        rx_demux_unsubscribe(sub);
+        ESP_LOGW(TAG, "[%s] Board declined %lu baud", name, (unsigned long)baud);
         return false;
     }
-    ESP_LOGI(TAG, "[USB] Sent ping");
-    
-    // Wait for pong response (timeout ~500ms, 10 x 50ms reads)
-    char buf[64];
-    int total = 0;
-    for (int i = 0; i < 10; i++) {
-        int n = usb_transport_read(buf + total, sizeof(buf) - total - 1, pdMS_TO_TICKS(50));
-        if (usb_debug_logs && n == 0) {
-            ESP_LOGD(TAG, "[USB] Ping wait %d/10: no data", i + 1);
-        }
-        if (n > 0) {
-            total += n;
-            buf[total] = '\0';
-            if (strstr(buf, "pong")) {
-                ESP_LOGI(TAG, "[USB] Received pong - device detected!");
-                return true;
-            }
-        }
+
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_SWITCH_DELAY_MS));
+    if (!transport_link_set_local(rx, baud)) {
+        rx_demux_unsubscribe(sub);
+        vTaskDelay(pdMS_TO_TICKS(LINK_RATE_COMMIT_TIMEOUT_MS + 100));
+        return false;
     }
-    
-    if (usb_debug_logs && total > 0) {
-        ESP_LOGW(TAG, "[USB] No pong response, partial data: \"%s\"", buf);
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_SWITCH_DELAY_MS));
+
+    char pattern[LINK_RATE_TEST_LEN + 1];
+    bool ok = true;
+    int64_t start_us = esp_timer_get_time();
+    for (int round = 0; round < LINK_RATE_TEST_ROUNDS && ok; round++) {
+        link_rate_pattern((uint32_t)start_us ^ ((uint32_t)round * 0x9E3779B9u), pattern, LINK_RATE_TEST_LEN);
+        len = snprintf(cmd, sizeof(cmd), "baudtest %s\r\n", pattern);
+        transport_write_bytes_tab(rx->tab, rx->port, cmd, (size_t)len);
+        ok = transport_link_wait(sub, NULL, pattern, LINK_RATE_TEST_LEN, 300);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+
+    if (ok) {
+        transport_write_bytes_tab(rx->tab, rx->port, "baud commit\r\n", 13);
+        rx_demux_unsubscribe(sub);
+        // Request and echo both cross the link, so this is round-trip payload per second
+        uint32_t test_bytes = 2u * LINK_RATE_TEST_ROUNDS * (LINK_RATE_TEST_LEN + 16);
+        ESP_LOGI(TAG, "[%s] Link verified at %lu baud, %lu B/s round trip", name, (unsigned long)baud,
+                 (unsigned long)(elapsed_us > 0 ? (int64_t)test_bytes * 1000000 / elapsed_us : 0));
+        return true;
+    }
+
+    rx_demux_unsubscribe(sub);
+    ESP_LOGW(TAG, "[%s] Test pattern failed at %lu baud, back to %lu", name, (unsigned long)baud,
+             (unsigned long)prev);
+    transport_link_set_local(rx, prev);
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_COMMIT_TIMEOUT_MS + 100));
+    if (rx->tab != TAB_USB) {
+        uart_flush_input(rx->port);
     }
-    ESP_LOGW(TAG, "[USB] No pong response - device not detected");
     return false;
 }
 
-static int transport_write_bytes_tab(tab_id_t tab, uart_port_t port, const char *data, size_t len)
+// A board that can run faster says so in its pong ("pong baud=2000000"); climb the
+// ladder until a rung fails its test or the board's limit is reached
+static void transport_link_negotiate(tab_id_t tab, uart_port_t port, const char *pong)
 {
-    if (port == UART_NUM && tab == TAB_USB) {
-        return usb_transport_write(data, len);
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    const char *cap = strstr(pong, LINK_RATE_PONG_CAPABILITY);
+    uint32_t limit = cap ? (uint32_t)strtoul(cap + strlen(LINK_RATE_PONG_CAPABILITY), NULL, 10) : 0;
+
+    if (!rx->ready || limit <= rx->baud) {
+        return;
+    }
+    if (tab == TAB_USB && usb_last_vid != CP210X_VID) {
+        ESP_LOGI(TAG, "[USB] Bridge %04X:%04X has no settable rate, staying at %lu baud",
+                 usb_last_vid, usb_last_pid, (unsigned long)rx->baud);
+        return;
+    }
+
+    uint32_t next;
+    while ((next = link_rate_next(rx->baud, limit)) != 0 && transport_link_step(rx, next)) {
     }
-    return uart_write_bytes(port, data, len);
+    rx->link_error_count = 0;
+    rx->meter.peak = 0;
+    ESP_LOGI(TAG, "[%s] Link running at %lu baud (board limit %lu)", tab_transport_name(tab),
+             (unsigned long)rx->baud, (unsigned long)limit);
 }
 
-static int transport_read_bytes_tab(tab_id_t tab, uart_port_t port, void *data, size_t len, TickType_t ticks_to_wait)
+// Boards come back from a reboot at the default rate, so every ping starts there too.
+// If the board is still at the raised rate, "baud reset" brings it down with us.
+static void transport_link_reset(tab_id_t tab, uart_port_t port)
 {
-    if (port == UART_NUM && tab == TAB_USB) {
-        return usb_transport_read(data, len, ticks_to_wait);
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    if (rx->baud <= LINK_RATE_DEFAULT) {
+        return;
     }
-    return uart_read_bytes(port, (uint8_t *)data, len, ticks_to_wait);
+    transport_write_bytes_tab(tab, port, "baud reset\r\n", 12);
+    vTaskDelay(pdMS_TO_TICKS(LINK_RATE_SWITCH_DELAY_MS));
+    if (!transport_link_set_local(rx, LINK_RATE_DEFAULT)) {
+        rx->baud = LINK_RATE_DEFAULT;
+    }
+    rx->meter.peak = 0;
 }
 
-static int transport_write_bytes(uart_port_t port, const char *data, size_t len)
+static void transport_link_fallback_task(void *arg)
 {
-    return transport_write_bytes_tab(current_tab, port, data, len);
+    transport_rx_t *rx = (transport_rx_t *)arg;
+    uint32_t lower = link_rate_lower(rx->baud);
+    ESP_LOGW(TAG, "[%s] Errors at %lu baud, stepping down to %lu", tab_transport_name(rx->tab),
+             (unsigned long)rx->baud, (unsigned long)lower);
+    if (!transport_link_step(rx, lower)) {
+        // Too garbled to agree on anything; the next ping starts both ends over
+        transport_link_reset(rx->tab, rx->port);
+    }
+    rx->link_fallback_running = false;
+    vTaskDelete(NULL);
+}
+
+// Subscribe to lines from a transport. Only lines received after this call are delivered,
+// so subscribe before sending the command whose response you want. NULL prefix = all lines.
+// Returns NULL if the reader isn't running; the rx_demux_* calls accept NULL and just time out.
+static rx_demux_sub_t *transport_rx_subscribe_tab(tab_id_t tab, uart_port_t port, const char *prefix)
+{
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    if (!rx->ready) {
+        return NULL;
+    }
+    return rx_demux_subscribe(&rx->demux, prefix);
+}
+
+// All lines from the transport uart_send_command_for_tab() writes to when ctx's tab is current
+static rx_demux_sub_t *transport_rx_subscribe_ctx(const tab_context_t *ctx)
+{
+    tab_id_t tab = tab_id_for_ctx(ctx);
+    return transport_rx_subscribe_tab(tab, uart_port_for_tab(tab), NULL);
+}
+
+#define TRANSPORT_RX_RECORDS(type)  (1ULL << (type))
+
+// All lines plus the wire records of the given kinds, read with rx_demux_next(). While the
+// subscription lasts, those records are not rendered as text for anyone else.
+static rx_demux_sub_t *transport_rx_subscribe_records_tab(tab_id_t tab, uart_port_t port, uint64_t kinds)
+{
+    transport_rx_t *rx = transport_rx_for_tab(tab, port);
+    if (!rx->ready) {
+        return NULL;
+    }
+    return rx_demux_subscribe_records(&rx->demux, NULL, kinds);
+}
+
+// Argument of a monitor task that reads a subscription its starter made
+typedef struct {
+    void *arg;
+    rx_demux_sub_t *rx_sub;
+} transport_rx_task_arg_t;
+
+// Start a monitor task on a subscription made before the command was sent, so the first response
+// lines can't arrive while nobody is subscribed. The task takes the subscription over with
+// transport_rx_task_take(); if it can't be started, the subscription is dropped here.
+static BaseType_t transport_rx_task_create(TaskFunction_t task, const char *name, uint32_t stack_depth, void *arg,
+                                           rx_demux_sub_t *rx_sub, UBaseType_t priority, TaskHandle_t *handle)
+{
+    transport_rx_task_arg_t *task_arg = malloc(sizeof(*task_arg));
+    if (!task_arg) {
+        rx_demux_unsubscribe(rx_sub);
+        return pdFAIL;
+    }
+    task_arg->arg = arg;
+    task_arg->rx_sub = rx_sub;
+    if (xTaskCreate(task, name, stack_depth, task_arg, priority, handle) != pdPASS) {
+        free(task_arg);
+        rx_demux_unsubscribe(rx_sub);
+        return pdFAIL;
+    }
+    return pdPASS;
 }
 
-static int transport_read_bytes(uart_port_t port, void *data, size_t len, TickType_t ticks_to_wait)
+// In the task: the starter's argument, and the subscription (which the task now unsubscribes)
+static void *transport_rx_task_take(void *task_arg, rx_demux_sub_t **rx_sub)
 {
-    return transport_read_bytes_tab(current_tab, port, data, len, ticks_to_wait);
+    transport_rx_task_arg_t *start = (transport_rx_task_arg_t *)task_arg;
+    void *arg = start->arg;
+    *rx_sub = start->rx_sub;
+    free(start);
+    return arg;
 }
 
 // UART initialization
@@ -2560,8 +3166,6 @@ static void uart_init(void)
     
     ESP_LOGI(TAG, "[Grove] Initialized: TX=%d, RX=%d, baud=%d (Grove connector)",
              tx_pin, rx_pin, UART_BAUD_RATE);
-
-    usb_transport_init();
 }
 
 // Log memory statistics
@@ -2646,8 +3250,7 @@ static bool parse_network_line(const char *line, wifi_network_t *net)
     strncpy(net->ssid, fields[1], sizeof(net->ssid) - 1);
     net->ssid[sizeof(net->ssid) - 1] = '\0';
     
-    strncpy(net->bssid, fields[3], sizeof(net->bssid) - 1);
-    net->bssid[sizeof(net->bssid) - 1] = '\0';
+    mac48_parse(fields[3], &net->bssid);
     
     strncpy(net->security, fields[5], sizeof(net->security) - 1);
     net->security[sizeof(net->security) - 1] = '\0';
@@ -2661,97 +3264,178 @@ static bool parse_network_line(const char *line, wifi_network_t *net)
 }
 
 // WiFi scan task
-static void wifi_scan_task(void *arg)
+#define SCAN_ROW_HEIGHT 84
+
+static void scan_row_create_cb(lv_obj_t *item, void *user_data)
 {
-    // Save the tab that initiated this scan (so we store results to correct context)
-    tab_id_t scan_tab = current_tab;
-    const char *uart_name = tab_transport_name(scan_tab);
-    
-    ESP_LOGI(TAG, "Starting WiFi scan task for tab %d (%s)", scan_tab, uart_name);
-    
-    // Clear previous results
-    network_count = 0;
-    memset(networks, 0, sizeof(networks));
-    
-    // Get the UART for current tab
-    uart_port_t uart_port = uart_port_for_tab(scan_tab);
-    
-    ESP_LOGI(TAG, "[%s] Using transport on port %d for scan", uart_name, uart_port);
-    
-    // Flush buffer before scan
-    if (scan_tab == TAB_USB && usb_cdc_handle) {
-        usbh_cdc_flush_rx_buffer(usb_cdc_handle);
-        ESP_LOGI(TAG, "[USB] Flushed RX buffer before scan");
-    } else {
-        uart_flush(uart_port);
-    }
-    
-    // Send scan command to the correct transport
-    log_memory_stats("TX-scan");
-    transport_write_bytes_tab(scan_tab, uart_port, "scan_networks\r\n", 15);
-    ESP_LOGI(TAG, "[%s] Sent command: scan_networks", tab_transport_name(scan_tab));
-    
-    // Buffer for receiving data
-    static char rx_buffer[UART_BUF_SIZE];
-    static char line_buffer[512];
-    int line_pos = 0;
-    bool scan_complete = false;
-    
-    TickType_t start_time = xTaskGetTickCount();
-    TickType_t timeout_ticks = pdMS_TO_TICKS(UART_RX_TIMEOUT);
-    
-    while (!scan_complete && (xTaskGetTickCount() - start_time) < timeout_ticks) {
-        int len = transport_read_bytes_tab(scan_tab, uart_port, rx_buffer, UART_BUF_SIZE - 1, pdMS_TO_TICKS(100));
-        
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            ESP_LOGD(TAG, "Received %d bytes", len);
-            
-            // Process received data character by character
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGD(TAG, "Line: %s", line_buffer);
-                        
-                        // Check for scan complete marker
-                        if (strstr(line_buffer, "Scan results printed") != NULL) {
-                            scan_complete = true;
-                            ESP_LOGI(TAG, "Scan complete marker received");
-                            break;
-                        }
-                        
-                        // Try to parse network line
-                        if (line_buffer[0] == '"' && network_count < MAX_NETWORKS) {
-                            wifi_network_t net;
-                            if (parse_network_line(line_buffer, &net)) {
-                                networks[network_count] = net;
-                                network_count++;
-                                ESP_LOGI(TAG, "[%s] Parsed network %d: %s (%s) %s", 
-                                         uart_name, net.index, net.ssid, net.bssid, net.band);
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
-            }
+    (void)user_data;
+
+    // List item with horizontal layout (checkbox + text container + RSSI chip)
+    ui_theme_apply_list_row(item);
+    lv_obj_set_style_bg_color(item, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_bg_grad_color(item, ui_theme_color(UI_COLOR_SURFACE), 0);
+    lv_obj_set_style_bg_grad_dir(item, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_style_border_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_PRIMARY), ui_theme_color(UI_COLOR_BORDER), LV_OPA_30), LV_STATE_CHECKED);
+    lv_obj_set_style_bg_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_PRIMARY), ui_theme_color(UI_COLOR_CARD), LV_OPA_20), LV_STATE_CHECKED);
+    lv_obj_set_style_bg_grad_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_SECONDARY), ui_theme_color(UI_COLOR_SURFACE), LV_OPA_20), LV_STATE_CHECKED);
+    lv_obj_set_flex_flow(item, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(item, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(item, 10, 0);
+    lv_obj_set_style_pad_top(item, 7, 0);
+    lv_obj_set_style_pad_bottom(item, 7, 0);
+    lv_obj_add_flag(item, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_scroll_dir(item, LV_DIR_NONE);
+    lv_obj_set_scrollbar_mode(item, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_border_width(item, 2, LV_STATE_CHECKED);
+    lv_obj_set_style_shadow_width(item, 12, LV_STATE_CHECKED);
+    lv_obj_set_style_shadow_opa(item, 64, LV_STATE_CHECKED);
+    
+    // Checkbox (on the left) - explicit size for better touch accuracy
+    lv_obj_t *cb = lv_checkbox_create(item);
+    lv_checkbox_set_text(cb, "");  // Empty text - we use separate labels
+    lv_obj_set_size(cb, 48, 48);  // Explicit size for touch target
+    lv_obj_set_ext_click_area(cb, 8);
+    lv_obj_set_style_pad_all(cb, 4, 0);
+    lv_obj_set_style_align(cb, LV_ALIGN_LEFT_MID, 0);  // Center vertically in row
+    // Style the indicator - dark when unchecked, green when checked
+    lv_obj_set_style_bg_color(cb, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_PART_INDICATOR);
+    lv_obj_set_style_bg_color(cb, ui_theme_color(UI_COLOR_SUCCESS), LV_PART_INDICATOR | LV_STATE_CHECKED);
+    lv_obj_set_style_border_color(cb, ui_theme_color(UI_COLOR_BORDER), LV_PART_INDICATOR);
+    lv_obj_set_style_border_width(cb, 2, LV_PART_INDICATOR);
+    lv_obj_set_style_radius(cb, 10, LV_PART_INDICATOR);
+    lv_obj_add_event_cb(cb, network_checkbox_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    lv_obj_add_event_cb(item, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+    
+    // Text container (vertical layout for SSID and info)
+    lv_obj_t *text_cont = lv_obj_create(item);
+    lv_obj_set_size(text_cont, 0, LV_SIZE_CONTENT);
+    lv_obj_set_flex_grow(text_cont, 1);
+    lv_obj_set_style_min_width(text_cont, 0, 0);
+    lv_obj_set_style_bg_opa(text_cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(text_cont, 0, 0);
+    lv_obj_set_style_pad_all(text_cont, 0, 0);
+    lv_obj_set_flex_flow(text_cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(text_cont, 2, 0);
+    lv_obj_add_flag(text_cont, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(text_cont, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+    lv_obj_clear_flag(text_cont, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(text_cont, LV_DIR_NONE);
+    lv_obj_set_scrollbar_mode(text_cont, LV_SCROLLBAR_MODE_OFF);
+    
+    // SSID (or "Hidden" if empty)
+    lv_obj_t *ssid_label = lv_label_create(text_cont);
+    lv_obj_set_style_text_font(ssid_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(ssid_label, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
+    lv_obj_set_width(ssid_label, lv_pct(100));
+    lv_label_set_long_mode(ssid_label, LV_LABEL_LONG_DOT);
+    lv_obj_add_flag(ssid_label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(ssid_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+    
+    // BSSID, Band and Security
+    lv_obj_t *info_label = lv_label_create(text_cont);
+    lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(info_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+    lv_obj_set_width(info_label, lv_pct(100));
+    lv_label_set_long_mode(info_label, LV_LABEL_LONG_DOT);
+    lv_obj_add_flag(info_label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(info_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+
+    lv_obj_t *rssi_chip = lv_obj_create(item);
+    ui_theme_apply_chip(rssi_chip, ui_theme_color(UI_COLOR_TEXT_MUTED));
+    lv_obj_set_style_bg_opa(rssi_chip, LV_OPA_20, 0);
+    lv_obj_set_style_pad_left(rssi_chip, 8, 0);
+    lv_obj_set_style_pad_right(rssi_chip, 8, 0);
+    lv_obj_set_style_pad_top(rssi_chip, 3, 0);
+    lv_obj_set_style_pad_bottom(rssi_chip, 3, 0);
+    lv_obj_set_width(rssi_chip, 110);
+    lv_obj_add_flag(rssi_chip, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(rssi_chip, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+    lv_obj_clear_flag(rssi_chip, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(rssi_chip, LV_DIR_NONE);
+    lv_obj_set_scrollbar_mode(rssi_chip, LV_SCROLLBAR_MODE_OFF);
+
+    lv_obj_t *rssi_label = lv_label_create(rssi_chip);
+    lv_obj_set_style_text_font(rssi_label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(rssi_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+    lv_obj_center(rssi_label);
+    lv_obj_add_flag(rssi_label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(rssi_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
+}
+
+static void scan_row_bind_cb(lv_obj_t *item, uint32_t index, void *user_data)
+{
+    (void)user_data;
+    if ((int)index >= network_count) return;
+
+    wifi_network_t *net = &networks[index];
+    lv_obj_t *cb = lv_obj_get_child(item, 0);
+    lv_obj_t *text_cont = lv_obj_get_child(item, 1);
+    lv_obj_t *rssi_chip = lv_obj_get_child(item, 2);
+
+    // Selection lives in selected_network_indices, not in the recycled checkbox
+    bool selected = false;
+    for (int i = 0; i < selected_network_count; i++) {
+        if (selected_network_indices[i] == (int)index) {
+            selected = true;
+            break;
         }
     }
-    
-    if (!scan_complete) {
-        ESP_LOGW(TAG, "[%s] Scan timed out", uart_name);
+    if (selected) {
+        lv_obj_add_state(cb, LV_STATE_CHECKED);
+        lv_obj_add_state(item, LV_STATE_CHECKED);
+    } else {
+        lv_obj_clear_state(cb, LV_STATE_CHECKED);
+        lv_obj_clear_state(item, LV_STATE_CHECKED);
     }
-    
-    log_memory_stats("RX-scan");
-    ESP_LOGI(TAG, "[%s] Scan finished. Found %d networks", uart_name, network_count);
-    
-    // Update UI on main thread
-    bsp_display_lock(0);
+
+    ui_comp_patch_label_text(lv_obj_get_child(text_cont, 0), (net->ssid[0] != '\0') ? net->ssid : "(Hidden)");
+
+    // Sanitize malformed security strings from UART output
+    char security_clean[32];
+    strncpy(security_clean, net->security, sizeof(security_clean) - 1);
+    security_clean[sizeof(security_clean) - 1] = '\0';
+    strip_rssi_suffix(security_clean);
+    ui_comp_patch_label_text_fmt(lv_obj_get_child(text_cont, 1), MAC48_FMT "  |  %s  |  %s",
+                                 MAC48_ARGS(net->bssid), net->band,
+                                 (security_clean[0] != '\0') ? security_clean : "Open");
+
+    lv_color_t rssi_color = wifi_rssi_quality_color(net->rssi);
+    lv_obj_t *rssi_label = lv_obj_get_child(rssi_chip, 0);
+    ui_comp_patch_label_text_fmt(rssi_label, "%d dBm", net->rssi);
+    if (ui_comp_patch_text_color(rssi_label, rssi_color)) {
+        lv_obj_set_style_bg_color(rssi_chip, rssi_color, 0);
+        lv_obj_set_style_border_color(rssi_chip, rssi_color, 0);
+    }
+}
+
+_Static_assert(sizeof(((wifi_network_t *)0)->ssid) == sizeof(((wire_scan_network_t *)0)->ssid) &&
+               sizeof(((wifi_network_t *)0)->security) == sizeof(((wire_scan_network_t *)0)->security),
+               "record strings are copied whole");
+
+// Plain copies: the decoder terminates every string, and snprintf() cost as much as the rest of the record path
+static void scan_network_from_record(const wire_scan_network_t *rec, wifi_network_t *net)
+{
+    memset(net, 0, sizeof(*net));
+    net->index = rec->index;
+    memcpy(net->ssid, rec->ssid, sizeof(net->ssid));
+    net->bssid = rec->bssid;
+    net->rssi = rec->rssi;
+    const char *band = wire_band_text(rec->band);
+    memcpy(net->band, band, strlen(band) + 1);
+    memcpy(net->security, rec->security, sizeof(net->security));
+}
+
+typedef struct {
+    tab_id_t scan_tab;
+    bool scan_complete;
+} wifi_scan_done_t;
+
+// Posted by wifi_scan_task once the results are in networks[]
+static void wifi_scan_done_ui(void *data)
+{
+    const wifi_scan_done_t *done = (const wifi_scan_done_t *)data;
+    tab_id_t scan_tab = done->scan_tab;
+    const char *uart_name = tab_transport_name(scan_tab);
     
     // Hide spinner
     if (spinner) {
@@ -2760,131 +3444,16 @@ static void wifi_scan_task(void *arg)
     
     // Update status
     if (status_label) {
-        if (scan_complete) {
+        if (done->scan_complete) {
             lv_label_set_text_fmt(status_label, "Found %d networks", network_count);
         } else {
             lv_label_set_text(status_label, "Scan timed out");
         }
     }
     
-    // Update network list
+    // Update network list (rows are recycled, see scan_row_bind_cb)
     if (network_list) {
-        lv_obj_clean(network_list);
-        
-        for (int i = 0; i < network_count; i++) {
-            wifi_network_t *net = &networks[i];
-            
-            // Create list item with horizontal layout (checkbox + text container)
-            lv_obj_t *item = lv_obj_create(network_list);
-            lv_obj_set_size(item, lv_pct(100), 84);
-            ui_theme_apply_list_row(item);
-            lv_obj_set_style_bg_color(item, ui_theme_color(UI_COLOR_CARD), 0);
-            lv_obj_set_style_bg_grad_color(item, ui_theme_color(UI_COLOR_SURFACE), 0);
-            lv_obj_set_style_bg_grad_dir(item, LV_GRAD_DIR_VER, 0);
-            lv_obj_set_style_border_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_PRIMARY), ui_theme_color(UI_COLOR_BORDER), LV_OPA_30), LV_STATE_CHECKED);
-            lv_obj_set_style_bg_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_PRIMARY), ui_theme_color(UI_COLOR_CARD), LV_OPA_20), LV_STATE_CHECKED);
-            lv_obj_set_style_bg_grad_color(item, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_SECONDARY), ui_theme_color(UI_COLOR_SURFACE), LV_OPA_20), LV_STATE_CHECKED);
-            lv_obj_set_flex_flow(item, LV_FLEX_FLOW_ROW);
-            lv_obj_set_flex_align(item, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-            lv_obj_set_style_pad_column(item, 10, 0);
-            lv_obj_set_style_pad_top(item, 7, 0);
-            lv_obj_set_style_pad_bottom(item, 7, 0);
-            lv_obj_add_flag(item, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_clear_flag(item, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_set_scroll_dir(item, LV_DIR_NONE);
-            lv_obj_set_scrollbar_mode(item, LV_SCROLLBAR_MODE_OFF);
-            
-            // Checkbox (on the left) - explicit size for better touch accuracy
-            lv_obj_t *cb = lv_checkbox_create(item);
-            lv_checkbox_set_text(cb, "");  // Empty text - we use separate labels
-            lv_obj_set_size(cb, 48, 48);  // Explicit size for touch target
-            lv_obj_set_ext_click_area(cb, 8);
-            lv_obj_set_style_pad_all(cb, 4, 0);
-            lv_obj_set_style_align(cb, LV_ALIGN_LEFT_MID, 0);  // Center vertically in row
-            // Style the indicator - dark when unchecked, green when checked
-            lv_obj_set_style_bg_color(cb, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(cb, ui_theme_color(UI_COLOR_SUCCESS), LV_PART_INDICATOR | LV_STATE_CHECKED);
-            lv_obj_set_style_border_color(cb, ui_theme_color(UI_COLOR_BORDER), LV_PART_INDICATOR);
-            lv_obj_set_style_border_width(cb, 2, LV_PART_INDICATOR);
-            lv_obj_set_style_radius(cb, 10, LV_PART_INDICATOR);
-            // Pass 0-based index as user data
-            lv_obj_add_event_cb(cb, network_checkbox_event_cb, LV_EVENT_VALUE_CHANGED, (void*)(intptr_t)i);
-            lv_obj_add_event_cb(item, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-            
-            // Text container (vertical layout for SSID and info)
-            lv_obj_t *text_cont = lv_obj_create(item);
-            lv_obj_set_size(text_cont, 0, LV_SIZE_CONTENT);
-            lv_obj_set_flex_grow(text_cont, 1);
-            lv_obj_set_style_min_width(text_cont, 0, 0);
-            lv_obj_set_style_bg_opa(text_cont, LV_OPA_TRANSP, 0);
-            lv_obj_set_style_border_width(text_cont, 0, 0);
-            lv_obj_set_style_pad_all(text_cont, 0, 0);
-            lv_obj_set_flex_flow(text_cont, LV_FLEX_FLOW_COLUMN);
-            lv_obj_set_style_pad_row(text_cont, 2, 0);
-            lv_obj_add_flag(text_cont, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(text_cont, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-            lv_obj_clear_flag(text_cont, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_set_scroll_dir(text_cont, LV_DIR_NONE);
-            lv_obj_set_scrollbar_mode(text_cont, LV_SCROLLBAR_MODE_OFF);
-            
-            // SSID (or "Hidden" if empty)
-            lv_obj_t *ssid_label = lv_label_create(text_cont);
-            if (strlen(net->ssid) > 0) {
-                lv_label_set_text(ssid_label, net->ssid);
-            } else {
-                lv_label_set_text(ssid_label, "(Hidden)");
-            }
-            lv_obj_set_style_text_font(ssid_label, &lv_font_montserrat_16, 0);
-            lv_obj_set_style_text_color(ssid_label, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
-            lv_obj_set_width(ssid_label, lv_pct(100));
-            lv_label_set_long_mode(ssid_label, LV_LABEL_LONG_DOT);
-            lv_obj_add_flag(ssid_label, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(ssid_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-            
-            // BSSID, Band and Security (sanitize malformed security strings from UART output)
-            lv_obj_t *info_label = lv_label_create(text_cont);
-            char security_clean[32];
-            strncpy(security_clean, net->security, sizeof(security_clean) - 1);
-            security_clean[sizeof(security_clean) - 1] = '\0';
-            strip_rssi_suffix(security_clean);
-            lv_label_set_text_fmt(info_label, "%s  |  %s  |  %s", 
-                                  net->bssid, net->band,
-                                  (security_clean[0] != '\0') ? security_clean : "Open");
-            lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, 0);
-            lv_obj_set_style_text_color(info_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-            lv_obj_set_width(info_label, lv_pct(100));
-            lv_label_set_long_mode(info_label, LV_LABEL_LONG_DOT);
-            lv_obj_add_flag(info_label, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(info_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-
-            lv_color_t rssi_color = wifi_rssi_quality_color(net->rssi);
-            lv_obj_t *rssi_chip = lv_obj_create(item);
-            ui_theme_apply_chip(rssi_chip, rssi_color);
-            lv_obj_set_style_bg_opa(rssi_chip, LV_OPA_20, 0);
-            lv_obj_set_style_border_color(rssi_chip, rssi_color, 0);
-            lv_obj_set_style_pad_left(rssi_chip, 8, 0);
-            lv_obj_set_style_pad_right(rssi_chip, 8, 0);
-            lv_obj_set_style_pad_top(rssi_chip, 3, 0);
-            lv_obj_set_style_pad_bottom(rssi_chip, 3, 0);
-            lv_obj_set_width(rssi_chip, 110);
-            lv_obj_add_flag(rssi_chip, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(rssi_chip, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-            lv_obj_clear_flag(rssi_chip, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_set_scroll_dir(rssi_chip, LV_DIR_NONE);
-            lv_obj_set_scrollbar_mode(rssi_chip, LV_SCROLLBAR_MODE_OFF);
-
-            lv_obj_t *rssi_label = lv_label_create(rssi_chip);
-            lv_label_set_text_fmt(rssi_label, "%d dBm", net->rssi);
-            lv_obj_set_style_text_font(rssi_label, &lv_font_montserrat_12, 0);
-            lv_obj_set_style_text_color(rssi_label, rssi_color, 0);
-            lv_obj_center(rssi_label);
-            lv_obj_add_flag(rssi_label, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(rssi_label, wifi_scan_row_toggle_cb, LV_EVENT_CLICKED, cb);
-
-            lv_obj_set_style_border_width(item, 2, LV_STATE_CHECKED);
-            lv_obj_set_style_shadow_width(item, 12, LV_STATE_CHECKED);
-            lv_obj_set_style_shadow_opa(item, 64, LV_STATE_CHECKED);
-        }
+        ui_comp_vlist_set_count(network_list, (uint32_t)network_count);
     }
     
     // Re-enable scan button
@@ -2892,11 +3461,6 @@ static void wifi_scan_task(void *arg)
         lv_obj_clear_state(scan_btn, LV_STATE_DISABLED);
     }
     
-    // Hide small spinner
-    if (spinner) {
-        lv_obj_add_flag(spinner, LV_OBJ_FLAG_HIDDEN);
-    }
-    
     // Hide large centered overlay
     hide_scan_overlay();
     
@@ -2913,8 +3477,94 @@ static void wifi_scan_task(void *arg)
         scan_ctx->scan_in_progress = false;
         ESP_LOGI(TAG, "[%s] Copied %d scan results to tab %d context", uart_name, network_count, scan_tab);
     }
+}
+
+static void wifi_scan_task(void *arg)
+{
+    // Save the tab that initiated this scan (so we store results to correct context)
+    tab_id_t scan_tab = current_tab;
+    const char *uart_name = tab_transport_name(scan_tab);
+    
+    ESP_LOGI(TAG, "Starting WiFi scan task for tab %d (%s)", scan_tab, uart_name);
+    
+    // Clear previous results
+    network_count = 0;
+    memset(networks, 0, sizeof(networks));
+    
+    // Get the UART for current tab
+    uart_port_t uart_port = uart_port_for_tab(scan_tab);
+    
+    ESP_LOGI(TAG, "[%s] Using transport on port %d for scan", uart_name, uart_port);
+    
+    // Listen before sending so the response can't be missed
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_records_tab(scan_tab, uart_port,
+                                                                TRANSPORT_RX_RECORDS(WIRE_TYPE_SCAN_NETWORK));
+    
+    // Send scan command to the correct transport
+    log_memory_stats("TX-scan");
+    transport_write_bytes_tab(scan_tab, uart_port, "scan_networks\r\n", 15);
+    ESP_LOGI(TAG, "[%s] Sent command: scan_networks", tab_transport_name(scan_tab));
+    
+    bool scan_complete = false;
+    rx_parse_cost_t parse_cost = {0};
+    
+    TickType_t start_time = xTaskGetTickCount();
+    TickType_t timeout_ticks = pdMS_TO_TICKS(UART_RX_TIMEOUT);
+    
+    while (!scan_complete && (xTaskGetTickCount() - start_time) < timeout_ticks) {
+        rx_demux_msg_t msg;
+        if (!rx_demux_next(rx_sub, &msg, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        if (msg.record) {
+            const wire_record_t *rec = (const wire_record_t *)msg.record;
+            if (rec->type == WIRE_TYPE_SCAN_NETWORK && rec->u.scan.index > 0 && network_count < MAX_NETWORKS) {
+                int64_t parse_start = esp_timer_get_time();
+                wifi_network_t *net = &networks[network_count++];
+                scan_network_from_record(&rec->u.scan, net);
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
+                ESP_LOGI(TAG, "[%s] Network %d: %s (" MAC48_FMT ") %s",
+                         uart_name, net->index, net->ssid, MAC48_ARGS(net->bssid), net->band);
+            }
+            continue;
+        }
+        char *line_buffer = msg.line.text;
+        ESP_LOGD(TAG, "Line: %s", line_buffer);
+        
+        // Check for scan complete marker
+        if (strstr(line_buffer, "Scan results printed") != NULL) {
+            scan_complete = true;
+            ESP_LOGI(TAG, "Scan complete marker received");
+            break;
+        }
+        
+        // Try to parse network line
+        if (line_buffer[0] == '"' && network_count < MAX_NETWORKS) {
+            wifi_network_t net;
+            int64_t parse_start = esp_timer_get_time();
+            bool parsed = parse_network_line(line_buffer, &net);
+            rx_parse_cost_add(&parse_cost, &msg, parse_start);
+            if (parsed) {
+                networks[network_count] = net;
+                network_count++;
+                ESP_LOGI(TAG, "[%s] Parsed network %d: %s (" MAC48_FMT ") %s", 
+                         uart_name, net.index, net.ssid, MAC48_ARGS(net.bssid), net.band);
+            }
+        }
+    }
+    rx_demux_unsubscribe(rx_sub);
+    
+    if (!scan_complete) {
+        ESP_LOGW(TAG, "[%s] Scan timed out", uart_name);
+    }
+    rx_parse_cost_log(uart_name, "Scan", &parse_cost);
+    
+    log_memory_stats("RX-scan");
+    ESP_LOGI(TAG, "[%s] Scan finished. Found %d networks", uart_name, network_count);
     
-    bsp_display_unlock();
+    // Update UI on the LVGL task
+    wifi_scan_done_t done = { .scan_tab = scan_tab, .scan_complete = scan_complete };
+    ui_cmd_post(wifi_scan_done_ui, &done, sizeof(done), portMAX_DELAY);
     
     // Delete this task
     vTaskDelete(NULL);
@@ -3008,6 +3658,33 @@ static void hide_evil_twin_loading_overlay(void) {
 // Startup Splash Screen (Cyber Tech style)
 //==================================================================================
 
+// Board detection starts during boot and runs while the splash plays
+#define BOOT_USB_SETTLE_MS        2500    // longest a USB board takes to enumerate
+#define BOOT_USB_CONNECT_MS       300     // from CDC connect until the board answers
+
+static volatile bool boot_detection_done = false;
+
+static void boot_detection_task(void *arg)
+{
+    (void)arg;
+    int64_t start_us = esp_timer_get_time();
+
+    // Stop waiting for a USB board as soon as one shows up
+    while (!usb_cdc_connected && esp_timer_get_time() - start_us < BOOT_USB_SETTLE_MS * 1000LL) {
+        usb_rx_wait(&usb_rx, pdMS_TO_TICKS(50));
+    }
+    if (usb_cdc_connected) {
+        vTaskDelay(pdMS_TO_TICKS(BOOT_USB_CONNECT_MS));
+    }
+    perf_trace_record("usb_settle", start_us, esp_timer_get_time());
+
+    detect_boards();
+    check_all_sd_cards();
+    ESP_LOGI(TAG, "Boot detection took %lld ms", (long long)((esp_timer_get_time() - start_us) / 1000));
+    boot_detection_done = true;
+    vTaskDelete(NULL);
+}
+
 #define SPLASH_TICK_MS            40
 #define SPLASH_TOTAL_FRAMES       72
 #define SPLASH_TITLE_IN_START     8
@@ -3022,6 +3699,11 @@ static void splash_timer_cb(lv_timer_t *timer)
 
     splash_frame++;
 
+    // Once the boards are known there's nothing to wait for: skip the hold
+    if (boot_detection_done && splash_frame > SPLASH_STABLE_START && splash_frame < SPLASH_FADE_OUT_START) {
+        splash_frame = SPLASH_FADE_OUT_START;
+    }
+
     if (splash_frame >= SPLASH_TOTAL_FRAMES) {
         ESP_LOGI(TAG, "Splash complete, showing detection popup");
 
@@ -3042,8 +3724,12 @@ static void splash_timer_cb(lv_timer_t *timer)
             splash_grid_overlay = NULL;
         }
 
-        // Show detection popup - it will wait for devices and then build UI
-        show_detection_popup();
+        // Detection runs behind the splash; only wait for it if it's still going
+        if (boot_detection_done) {
+            finish_boot_detection();
+        } else {
+            show_detection_popup();
+        }
         return;
     }
 
@@ -3105,20 +3791,45 @@ static void splash_timer_cb(lv_timer_t *timer)
     }
 }
 
-// Detection complete callback - called after waiting for devices to stabilize
-static void detection_complete_cb(lv_timer_t *timer)
+// <dir>/<prefix>_YYYYMMDD_HHMMSS<ext>, local time
+static void format_timestamped_path(char *out, size_t size, const char *dir, const char *prefix, const char *ext)
+{
+    time_t now;
+    struct tm timeinfo;
+    time(&now);
+    localtime_r(&now, &timeinfo);
+    snprintf(out, size, "%s/%s_%04d%02d%02d_%02d%02d%02d%s", dir, prefix,
+             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec, ext);
+}
+
+static bool ensure_perf_trace_dir(void)
+{
+    struct stat st;
+    if (stat(PERF_TRACE_DIR, &st) != 0 && mkdir(PERF_TRACE_DIR, 0755) != 0) {
+        ESP_LOGE(TAG, "Failed to create %s: %s", PERF_TRACE_DIR, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// Write the boot timeline to SD, keeping the previous boot's for comparison
+static void perf_trace_save_boot_task(void *arg)
+{
+    (void)arg;
+    if (ensure_internal_sd_mounted(false) && ensure_perf_trace_dir()) {
+        remove(PERF_TRACE_BOOT_PREV_FILE);
+        rename(PERF_TRACE_BOOT_FILE, PERF_TRACE_BOOT_PREV_FILE);
+        perf_trace_export_chrome(PERF_TRACE_BOOT_FILE, "boot", esp_app_get_description()->version);
+    } else {
+        ESP_LOGW(TAG, "SD card not mounted, boot trace not saved");
+    }
+    vTaskDelete(NULL);
+}
+
+// Board detection results are in: leave the splash/detection UI for the main UI
+static void finish_boot_detection(void)
 {
-    (void)timer;
-    detection_timer = NULL;
-    
-    ESP_LOGI(TAG, "Detection timer complete, running board detection");
-    
-    // Run board detection
-    detect_boards();
-    
-    // Check SD card presence on all detected devices
-    check_all_sd_cards();
-    
     ESP_LOGI(TAG, "Detection complete: uart1=%d, mbus=%d, grove=%d, usb=%d",
              uart1_detected, mbus_detected, grove_detected, usb_detected);
     
@@ -3136,6 +3847,23 @@ static void detection_complete_cb(lv_timer_t *timer)
         ESP_LOGI(TAG, "Board(s) detected - showing main tiles");
         show_main_tiles();
     }
+    perf_trace_mark("interactive");
+    ESP_LOGI(TAG, "Interactive %lld ms after reset", (long long)(esp_timer_get_time() / 1000));
+
+    if (xTaskCreate(perf_trace_save_boot_task, "perf_save", 4096, NULL, 2, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "Boot trace not saved");
+    }
+}
+
+// Polls until the boot detection task is done
+static void detection_complete_cb(lv_timer_t *timer)
+{
+    if (!boot_detection_done) {
+        return;
+    }
+    lv_timer_del(timer);
+    detection_timer = NULL;
+    finish_boot_detection();
 }
 
 // Show detection popup while waiting for devices to stabilize
@@ -3169,11 +3897,7 @@ static void show_detection_popup(void)
     lv_obj_set_style_text_font(label, &lv_font_montserrat_24, 0);
     lv_obj_set_style_pad_top(label, 20, 0);
     
-    // Start timer - wait 2.5 seconds for USB and other devices to stabilize
-    detection_timer = lv_timer_create(detection_complete_cb, 2500, NULL);
-    lv_timer_set_repeat_count(detection_timer, 1);
-    
-    ESP_LOGI(TAG, "Detection timer started (2.5s)");
+    detection_timer = lv_timer_create(detection_complete_cb, 100, NULL);
 }
 
 // Play startup beep (audio disabled due to linker issues - just log)
@@ -3283,7 +4007,7 @@ static void scan_btn_click_cb(lv_event_t *e)
     
     // Clear previous results
     if (network_list) {
-        lv_obj_clean(network_list);
+        ui_comp_vlist_set_count(network_list, 0);
     }
     
     // Start scan task
@@ -3819,35 +4543,16 @@ static int count_remote_handshake_files_for_tab(tab_id_t tab)
         return -1;
     }
 
-    uart_port_t uart_port = uart_port_for_tab(tab);
-    if (!(tab == TAB_USB && uart_port == UART_NUM)) {
-        uart_flush_input(uart_port);
-    }
-
-    const char *cmd = "list_dir /sdcard/lab/handshakes";
-    transport_write_bytes_tab(tab, uart_port, cmd, strlen(cmd));
-    transport_write_bytes_tab(tab, uart_port, "\r\n", 2);
-
     char rx_buffer[4096];
-    int total_len = 0;
-    int retries = 8;
-    int empty_reads = 0;
-
-    while (retries-- > 0 && total_len < (int)sizeof(rx_buffer) - 1 && empty_reads < 3) {
-        int len = transport_read_bytes_tab(tab, uart_port,
-                                           rx_buffer + total_len,
-                                           sizeof(rx_buffer) - total_len - 1,
-                                           pdMS_TO_TICKS(120));
-        if (len > 0) {
-            total_len += len;
-            empty_reads = 0;
-        } else {
-            empty_reads++;
-        }
-    }
-    rx_buffer[total_len] = '\0';
-
-    if (total_len <= 0) {
+    cmd_request_t req = {
+        .command = "list_dir /sdcard/lab/handshakes",
+        .quiet_ms = 150,
+        .timeout_ms = 1000,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    cmd_status_t status = cmd_session_run(transport_session_for_tab(tab, uart_port_for_tab(tab)), &req);
+    if (status == CMD_ERROR || rx_buffer[0] == '\0') {
         return -1;
     }
 
@@ -3911,57 +4616,133 @@ static void strip_rssi_suffix(char *security_text)
     }
 }
 
-static void refresh_dashboard_handshake_cache(tab_context_t *ctx, tab_id_t tab)
+//==================================================================================
+// Dashboard background I/O
+//==================================================================================
+// Handshake counts need an SD directory walk or a transport round-trip of up to a
+// second, so they run on this worker. The LVGL timer only queues a request and the
+// result is applied back on the LVGL task through lv_async_call().
+
+#define DASHBOARD_IO_QUEUE_LEN  4
+
+typedef struct {
+    tab_id_t tab;
+    int count;
+} dashboard_io_result_t;
+
+static QueueHandle_t dashboard_io_queue = NULL;
+// One slot per tab: the pending flag keeps at most one request per tab in flight
+static dashboard_io_result_t dashboard_io_results[TAB_INTERNAL + 1];
+
+static void dashboard_io_apply_cb(void *user_data)
 {
-    if (!ctx) {
-        return;
-    }
+    dashboard_io_result_t *result = (dashboard_io_result_t *)user_data;
+    tab_context_t *ctx = get_ctx_for_tab(result->tab);
 
-    int64_t now_us = esp_timer_get_time();
-    if (ctx->dashboard_last_local_handshake_refresh_us > 0 &&
-        (now_us - ctx->dashboard_last_local_handshake_refresh_us) < DASHBOARD_HANDSHAKE_REFRESH_US) {
-        return;
+    ctx->dashboard_handshake_pending = false;
+    if (result->count >= 0) {
+        ctx->dashboard_handshake_count = result->count;
+        ctx->dashboard_handshake_known = true;
+    } else if (!ctx->dashboard_handshake_known) {
+        ctx->dashboard_handshake_count = -1;
     }
+    update_live_dashboard_for_ctx(ctx);
+}
 
-    if (tab == TAB_INTERNAL) {
-        ctx->dashboard_last_local_handshake_refresh_us = now_us;
-        int local_count = count_local_handshake_files();
-        if (local_count >= 0) {
-            ctx->dashboard_handshake_count = local_count;
-            ctx->dashboard_handshake_known = true;
-        } else if (!ctx->dashboard_handshake_known) {
-            ctx->dashboard_handshake_count = -1;
+static void dashboard_io_task(void *arg)
+{
+    (void)arg;
+    tab_id_t tab;
+
+    while (1) {
+        if (xQueueReceive(dashboard_io_queue, &tab, portMAX_DELAY) != pdTRUE) {
+            continue;
         }
-        return;
+
+        int count = (tab == TAB_INTERNAL) ? count_local_handshake_files()
+                                          : count_remote_handshake_files_for_tab(tab);
+
+        dashboard_io_result_t *result = &dashboard_io_results[tab];
+        result->tab = tab;
+        result->count = count;
+
+        // lv_async_call() is not thread safe, it must run under the display lock
+        ui_perf_lock(0);
+        if (lv_async_call(dashboard_io_apply_cb, result) != LV_RESULT_OK) {
+            get_ctx_for_tab(tab)->dashboard_handshake_pending = false;
+        }
+        ui_perf_unlock();
     }
+}
 
-    // For transport tabs refresh from the active transport only while on main tiles.
-    // This avoids clashing with long-running actions on subpages.
-    if (ctx != get_current_ctx() || ctx->current_visible_page != ctx->tiles) {
+static void dashboard_io_init(void)
+{
+    if (dashboard_io_queue) {
         return;
     }
-    if (scan_in_progress || ctx->scan_in_progress) {
+
+    dashboard_io_queue = xQueueCreate(DASHBOARD_IO_QUEUE_LEN, sizeof(tab_id_t));
+    if (!dashboard_io_queue) {
+        ESP_LOGE(TAG, "Failed to create dashboard I/O queue");
         return;
     }
-
-    ctx->dashboard_last_local_handshake_refresh_us = now_us;
-    int remote_count = count_remote_handshake_files_for_tab(tab);
-    if (remote_count >= 0) {
-        ctx->dashboard_handshake_count = remote_count;
-        ctx->dashboard_handshake_known = true;
-    } else if (!ctx->dashboard_handshake_known) {
-        ctx->dashboard_handshake_count = -1;
+    // count_remote_handshake_files_for_tab() keeps a 4 KB receive buffer on the stack
+    if (xTaskCreate(dashboard_io_task, "dash_io", 8192, NULL, 4, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create dashboard I/O task");
+        vQueueDelete(dashboard_io_queue);
+        dashboard_io_queue = NULL;
     }
 }
 
-static lv_obj_t *create_live_dashboard_panel(lv_obj_t *parent, tab_context_t *ctx)
+static bool dashboard_io_request_handshake_count(tab_context_t *ctx, tab_id_t tab)
 {
-    if (!parent || !ctx) {
-        return NULL;
+    if (!dashboard_io_queue || ctx->dashboard_handshake_pending) {
+        return false;
     }
-
-    lv_obj_t *panel = lv_obj_create(parent);
-    lv_obj_remove_style_all(panel);
+    if (xQueueSend(dashboard_io_queue, &tab, 0) != pdTRUE) {
+        return false;
+    }
+    ctx->dashboard_handshake_pending = true;
+    return true;
+}
+
+// Runs on the LVGL task: never blocks, only schedules a count on the dashboard worker
+static void refresh_dashboard_handshake_cache(tab_context_t *ctx, tab_id_t tab)
+{
+    if (!ctx || ctx->dashboard_handshake_pending) {
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (ctx->dashboard_last_local_handshake_refresh_us > 0 &&
+        (now_us - ctx->dashboard_last_local_handshake_refresh_us) < DASHBOARD_HANDSHAKE_REFRESH_US) {
+        return;
+    }
+
+    if (tab != TAB_INTERNAL) {
+        // For transport tabs refresh from the active transport only while on main tiles.
+        // This avoids clashing with long-running actions on subpages.
+        if (ctx != get_current_ctx() || ctx->current_visible_page != ctx->tiles) {
+            return;
+        }
+        if (scan_in_progress || ctx->scan_in_progress) {
+            return;
+        }
+    }
+
+    if (dashboard_io_request_handshake_count(ctx, tab)) {
+        ctx->dashboard_last_local_handshake_refresh_us = now_us;
+    }
+}
+
+static lv_obj_t *create_live_dashboard_panel(lv_obj_t *parent, tab_context_t *ctx)
+{
+    if (!parent || !ctx) {
+        return NULL;
+    }
+
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_remove_style_all(panel);
     lv_obj_set_width(panel, lv_pct(100));
     lv_obj_set_height(panel, LV_SIZE_CONTENT);
     lv_obj_set_style_min_height(panel, 0, 0);
@@ -4136,6 +4917,13 @@ static lv_obj_t *create_live_dashboard_panel(lv_obj_t *parent, tab_context_t *ct
     lv_obj_set_style_text_font(ctx->dashboard_uptime_value, ui_theme_font_body(), 0);
     lv_obj_set_style_text_color(ctx->dashboard_uptime_value, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
 
+    ctx->dashboard_link_value = lv_label_create(uptime_chip);
+    lv_label_set_text(ctx->dashboard_link_value, "--");
+    lv_obj_set_width(ctx->dashboard_link_value, lv_pct(100));
+    lv_label_set_long_mode(ctx->dashboard_link_value, LV_LABEL_LONG_DOT);
+    lv_obj_set_style_text_font(ctx->dashboard_link_value, ui_theme_font_label(), 0);
+    lv_obj_set_style_text_color(ctx->dashboard_link_value, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+
     lv_obj_t *storage_chip = lv_obj_create(aux_row);
     ui_theme_apply_chip(storage_chip, ui_theme_color(UI_COLOR_SURFACE_ALT));
     lv_obj_set_size(storage_chip, lv_pct(32), chip_h);
@@ -4391,6 +5179,31 @@ static void update_live_dashboard_for_ctx(tab_context_t *ctx)
         lv_obj_set_style_text_color(ctx->dashboard_uptime_value, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
     }
 
+    if (ctx->dashboard_link_value && lv_obj_is_valid(ctx->dashboard_link_value)) {
+        if (tab == TAB_INTERNAL) {
+            lv_label_set_text(ctx->dashboard_link_value, "No link");
+        } else {
+            // "921.6k 12.3/84.1 KB/s": line rate, then received now / best window
+            transport_rx_t *rx = transport_rx_for_tab(tab, tab == TAB_MBUS ? UART2_NUM : UART_NUM);
+            uint32_t baud = rx->baud ? rx->baud : UART_BAUD_RATE;
+            uint32_t now_bps = link_rate_meter_rate(&rx->meter, transport_now_ms());
+            uint32_t peak_bps = rx->meter.peak;
+            char rate[12];
+            if (baud >= 1000000 && baud % 1000000 == 0) {
+                snprintf(rate, sizeof(rate), "%luM", (unsigned long)(baud / 1000000));
+            } else if (baud >= 1000000) {
+                snprintf(rate, sizeof(rate), "%lu.%luM", (unsigned long)(baud / 1000000),
+                         (unsigned long)(baud % 1000000 / 100000));
+            } else {
+                snprintf(rate, sizeof(rate), "%lu.%luk", (unsigned long)(baud / 1000),
+                         (unsigned long)(baud % 1000 / 100));
+            }
+            lv_label_set_text_fmt(ctx->dashboard_link_value, "%s %lu.%lu/%lu.%lu KB/s", rate,
+                                  (unsigned long)(now_bps / 1024), (unsigned long)(now_bps % 1024 * 10 / 1024),
+                                  (unsigned long)(peak_bps / 1024), (unsigned long)(peak_bps % 1024 * 10 / 1024));
+        }
+    }
+
     struct stat wpa1_st = {0};
     struct stat wpa2_st = {0};
     struct stat oui1_st = {0};
@@ -4682,6 +5495,41 @@ static void save_screenshot_to_sd(void) {}
 static void screenshot_click_cb(lv_event_t *e) { (void)e; }
 #endif
 
+// Log the newest trace records and counters, display lock and UI queue stats, then
+// write the whole ring to SD, along with the timeline trace of the session so far
+static void transport_trace_dump_cb(lv_event_t *e)
+{
+    (void)e;
+    transport_trace_dump_log(&transport_tracer, TRANSPORT_TRACE_DUMP_LOG_RECORDS);
+    ui_perf_log_lock_hist();
+
+    ui_cmd_stats_t cmd_stats;
+    ui_cmd_get_stats(&cmd_stats);
+    ESP_LOGI(TAG, "UI commands: %lu posted, %lu run, %lu dropped, max latency %lu ms, max run %lu ms, max depth %u",
+             (unsigned long)cmd_stats.posted, (unsigned long)cmd_stats.run, (unsigned long)cmd_stats.dropped,
+             (unsigned long)(cmd_stats.max_latency_us / 1000), (unsigned long)(cmd_stats.max_run_us / 1000),
+             (unsigned)cmd_stats.max_depth);
+
+    if (!ensure_internal_sd_mounted(true)) {
+        ESP_LOGW(TAG, "SD card not mounted, transport trace not saved");
+        return;
+    }
+    struct stat st;
+    if (stat(TRANSPORT_TRACE_DIR, &st) != 0 && mkdir(TRANSPORT_TRACE_DIR, 0755) != 0) {
+        ESP_LOGE(TAG, "Failed to create trace directory: %s", strerror(errno));
+        return;
+    }
+
+    char filename[64];
+    format_timestamped_path(filename, sizeof(filename), TRANSPORT_TRACE_DIR, "trace", ".ttr");
+    transport_trace_dump_file(&transport_tracer, filename);
+
+    if (ensure_perf_trace_dir()) {
+        format_timestamped_path(filename, sizeof(filename), PERF_TRACE_DIR, "perf", ".json");
+        perf_trace_export_chrome(filename, "session", esp_app_get_description()->version);
+    }
+}
+
 static void appbar_brand_glow_exec_cb(void *obj, int32_t value)
 {
     lv_obj_t *label = (lv_obj_t *)obj;
@@ -4784,11 +5632,13 @@ static void create_status_bar(void)
 #if SCREENSHOT_ENABLED && LV_USE_SNAPSHOT
     // Keep screenshot as hidden "easter egg" on header title
     lv_obj_add_flag(appbar_brand_label, LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_add_event_cb(appbar_brand_label, screenshot_click_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(appbar_brand_label, screenshot_click_cb, LV_EVENT_SHORT_CLICKED, NULL);
     lv_obj_add_flag(app_title_suffix, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_add_event_cb(app_title_suffix, screenshot_click_cb, LV_EVENT_CLICKED, NULL);
     screenshot_title_label = app_title_suffix;  // Store for visual feedback
 #endif
+    lv_obj_add_flag(appbar_brand_label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(appbar_brand_label, transport_trace_dump_cb, LV_EVENT_LONG_PRESSED, NULL);
 
     lv_obj_t *right_cluster = lv_obj_create(status_bar);
     lv_obj_remove_style_all(right_cluster);
@@ -5052,6 +5902,7 @@ static void style_tab_container_common(lv_obj_t *container, lv_coord_t height)
 // Create persistent tab containers (called once at startup)
 static void create_tab_containers(void)
 {
+    PERF_TRACE_SCOPE("create_tab_containers");
     lv_obj_t *scr = lv_scr_act();
     lv_coord_t height = lv_disp_get_ver_res(NULL) - UI_CHROME_HEIGHT;  // Below status and tab bars
     
@@ -5112,6 +5963,7 @@ static void create_tab_containers(void)
 // Reload GUI when hardware config changes (e.g., after board detection)
 static void reload_gui_for_detection(void)
 {
+    PERF_TRACE_SCOPE("reload_gui_for_detection");
     ESP_LOGI(TAG, "Reloading GUI (Grove=%s, USB=%s, MBus=%s)",
              grove_detected ? "YES" : "NO",
              usb_detected ? "YES" : "NO",
@@ -5292,7 +6144,8 @@ static void main_tile_event_cb(lv_event_t *e)
 static void network_checkbox_event_cb(lv_event_t *e)
 {
     lv_obj_t *cb = lv_event_get_target(e);
-    int index = (int)(intptr_t)lv_event_get_user_data(e);  // 0-based index
+    int index = (int)ui_comp_vlist_row_index(cb);  // 0-based index of the row it is bound to
+    if (index < 0) return;
     bool checked = lv_obj_has_state(cb, LV_STATE_CHECKED);
     lv_obj_t *row = lv_obj_get_parent(cb);
     
@@ -5369,7 +6222,7 @@ static void attack_tile_event_cb(lv_event_t *e)
     for (int i = 0; i < selected_network_count; i++) {
         int idx = selected_network_indices[i];
         if (idx >= 0 && idx < network_count) {
-            ESP_LOGI(TAG, "  [%d] %s (%s)", idx, networks[idx].ssid, networks[idx].bssid);
+            ESP_LOGI(TAG, "  [%d] %s (" MAC48_FMT ")", idx, networks[idx].ssid, MAC48_ARGS(networks[idx].bssid));
         }
     }
     
@@ -5451,10 +6304,10 @@ static void attack_tile_event_cb(lv_event_t *e)
         if (selected_network_count != 1) {
             ESP_LOGW(TAG, "ARP Poison requires exactly 1 network, selected: %d", selected_network_count);
             if (status_label) {
-                bsp_display_lock(0);
+                ui_perf_lock(0);
                 lv_label_set_text(status_label, "Select exactly 1 network for ARP Poison");
                 lv_obj_set_style_text_color(status_label, COLOR_MATERIAL_RED, 0);
-                bsp_display_unlock();
+                ui_perf_unlock();
             }
             return;
         }
@@ -5475,10 +6328,10 @@ static void attack_tile_event_cb(lv_event_t *e)
         if (selected_network_count != 1) {
             ESP_LOGW(TAG, "Rogue AP requires exactly 1 network, selected: %d", selected_network_count);
             if (status_label) {
-                bsp_display_lock(0);
+                ui_perf_lock(0);
                 lv_label_set_text(status_label, "Select exactly 1 network for Rogue AP");
                 lv_obj_set_style_text_color(status_label, COLOR_MATERIAL_RED, 0);
-                bsp_display_unlock();
+                ui_perf_unlock();
             }
             return;
         }
@@ -5589,7 +6442,7 @@ static void show_scan_deauth_popup(void)
             
             // BSSID, Band and Security
             lv_obj_t *info_label = lv_label_create(item);
-            lv_label_set_text_fmt(info_label, "BSSID: %s | %s | %s", net->bssid, net->band, net->security);
+            lv_label_set_text_fmt(info_label, "BSSID: " MAC48_FMT " | %s | %s", MAC48_ARGS(net->bssid), net->band, net->security);
             lv_obj_set_style_text_font(info_label, &lv_font_montserrat_12, 0);
             lv_obj_set_style_text_color(info_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
         }
@@ -5677,8 +6530,8 @@ static void show_sae_popup(int network_idx)
     
     // Network info
     lv_obj_t *network_label = lv_label_create(ctx->sae_popup);
-    lv_label_set_text_fmt(network_label, "on network:\n\n%s %s\n%s", 
-                          LV_SYMBOL_WIFI, ssid_display, net->bssid);
+    lv_label_set_text_fmt(network_label, "on network:\n\n%s %s\n" MAC48_FMT, 
+                          LV_SYMBOL_WIFI, ssid_display, MAC48_ARGS(net->bssid));
     lv_obj_set_style_text_font(network_label, &lv_font_montserrat_18, 0);
     lv_obj_set_style_text_color(network_label, lv_color_hex(0xFFFFFF), 0);
     lv_obj_set_style_text_align(network_label, LV_TEXT_ALIGN_CENTER, 0);
@@ -5795,7 +6648,7 @@ static void append_handshaker_log(const char *message, hs_log_type_t log_type)
     strncat(handshaker_log_buffer, message, sizeof(handshaker_log_buffer) - strlen(handshaker_log_buffer) - 1);
     
     // Update UI
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (handshaker_status_label) {
         lv_label_set_text(handshaker_status_label, handshaker_log_buffer);
         // Set color for last message (entire label gets same color - latest determines it)
@@ -5805,240 +6658,222 @@ static void append_handshaker_log(const char *message, hs_log_type_t log_type)
     if (handshaker_log_container) {
         lv_obj_scroll_to_y(handshaker_log_container, LV_COORD_MAX, LV_ANIM_ON);
     }
-    bsp_display_unlock();
+    ui_perf_unlock();
 }
 
 // Handshaker monitor task - reads UART for handshake capture
 static void handshaker_monitor_task(void *arg)
 {
     // Get context passed to task (so we use correct ctx even if tab changes)
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     const char *uart_name = tab_transport_name(task_tab);
     
     ESP_LOGI(TAG, "[%s] Handshaker monitor task started for tab %d", uart_name, task_tab);
     
-    static char rx_buffer[512];
-    static char line_buffer[512];
-    int line_pos = 0;
-    
     // Track state for detecting "already captured" scenario
     int networks_attacked_this_cycle = -1;
     int handshakes_so_far = -1;
     
     // Use context's flag instead of global
     while (ctx && ctx->handshaker_monitoring) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "Handshaker UART: %s", line_buffer);
-                        
-                        // Determine message type and log it
-                        hs_log_type_t log_type = HS_LOG_PROGRESS;
-                        bool should_log = false;
-                        char display_msg[256] = {0};
-                        
-                        // ===== SUCCESS INDICATORS (green) =====
-                        if (strstr(line_buffer, "Handshake captured for") != NULL) {
-                            // Extract SSID: "Handshake captured for 'SSID'"
-                            char *start = strchr(line_buffer, '\'');
-                            if (start) {
-                                char *end = strchr(start + 1, '\'');
-                                if (end) {
-                                    int len = end - start - 1;
-                                    if (len > 0 && len < 64) {
-                                        char ssid[64];
-                                        strncpy(ssid, start + 1, len);
-                                        ssid[len] = '\0';
-                                        snprintf(display_msg, sizeof(display_msg), "Handshake captured: %s", ssid);
-                                    }
-                                }
-                            }
-                            if (display_msg[0] == '\0') {
-                                strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "HANDSHAKE IS COMPLETE AND VALID") != NULL) {
-                            strncpy(display_msg, "Handshake validated!", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "PCAP saved:") != NULL || 
-                                 strstr(line_buffer, "HCCAPX saved:") != NULL) {
-                            // Extract filename from path
-                            char *path = strstr(line_buffer, "/sdcard/");
-                            if (path) {
-                                char *slash = strrchr(path, '/');
-                                if (slash) {
-                                    snprintf(display_msg, sizeof(display_msg), "Saved: %s", slash + 1);
-                                }
-                            }
-                            if (display_msg[0] == '\0') {
-                                strncpy(display_msg, "File saved to SD card", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Handshake #") != NULL && 
-                                 strstr(line_buffer, "captured") != NULL) {
-                            strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "All selected networks captured") != NULL) {
-                            strncpy(display_msg, "All networks captured! Attack complete.", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "handshake saved for SSID:") != NULL) {
-                            // Extract SSID
-                            char *ssid_start = strstr(line_buffer, "SSID:");
-                            if (ssid_start) {
-                                ssid_start += 5;
-                                while (*ssid_start == ' ') ssid_start++;
-                                char ssid[64];
-                                int j = 0;
-                                while (ssid_start[j] && ssid_start[j] != ' ' && ssid_start[j] != '(' && j < 63) {
-                                    ssid[j] = ssid_start[j];
-                                    j++;
-                                }
-                                ssid[j] = '\0';
-                                snprintf(display_msg, sizeof(display_msg), "Handshake saved: %s", ssid);
-                            } else {
-                                strncpy(display_msg, "Handshake saved!", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        
-                        // ===== ALREADY CAPTURED DETECTION (amber) =====
-                        else if (strstr(line_buffer, "Networks attacked this cycle:") != NULL) {
-                            // Parse count: "Networks attacked this cycle: 0"
-                            char *num = strstr(line_buffer, "cycle:");
-                            if (num) {
-                                networks_attacked_this_cycle = atoi(num + 6);
-                            }
-                            // Check if handshake already existed
-                            if (networks_attacked_this_cycle == 0 && handshakes_so_far > 0) {
-                                snprintf(display_msg, sizeof(display_msg), "Handshake already on SD card!");
-                                log_type = HS_LOG_ALREADY;
-                                should_log = true;
-                            }
-                        }
-                        else if (strstr(line_buffer, "Handshakes captured so far:") != NULL) {
-                            // Parse count: "Handshakes captured so far: 1"
-                            char *num = strstr(line_buffer, "so far:");
-                            if (num) {
-                                handshakes_so_far = atoi(num + 7);
-                            }
-                        }
-                        
-                        // ===== PROGRESS INDICATORS (gray) =====
-                        else if (strstr(line_buffer, "Attacking '") != NULL || 
-                                 strstr(line_buffer, ">>> [") != NULL) {
-                            // Extract network being attacked
-                            char *start = strchr(line_buffer, '\'');
-                            if (start) {
-                                char *end = strchr(start + 1, '\'');
-                                if (end) {
-                                    int len = end - start - 1;
-                                    if (len > 0 && len < 64) {
-                                        char ssid[64];
-                                        strncpy(ssid, start + 1, len);
-                                        ssid[len] = '\0';
-                                        snprintf(display_msg, sizeof(display_msg), "Attacking: %s", ssid);
-                                    }
-                                }
-                            }
-                            if (display_msg[0] == '\0') {
-                                strncpy(display_msg, "Attacking network...", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Burst #") != NULL && 
-                                 strstr(line_buffer, "complete") != NULL) {
-                            // Extract burst number
-                            char *num = strstr(line_buffer, "Burst #");
-                            if (num) {
-                                int burst = atoi(num + 7);
-                                snprintf(display_msg, sizeof(display_msg), "Burst #%d sent", burst);
-                            } else {
-                                strncpy(display_msg, "Deauth burst sent", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Handshake attack task started") != NULL) {
-                            strncpy(display_msg, "Attack started...", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Attack Cycle Complete") != NULL) {
-                            strncpy(display_msg, "Attack cycle complete", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        
-                        // ===== ERROR/FAILURE INDICATORS (red) =====
-                        else if (strstr(line_buffer, "No handshake for") != NULL) {
-                            // Extract SSID
-                            char *start = strchr(line_buffer, '\'');
-                            if (start) {
-                                char *end = strchr(start + 1, '\'');
-                                if (end) {
-                                    int len = end - start - 1;
-                                    if (len > 0 && len < 64) {
-                                        char ssid[64];
-                                        strncpy(ssid, start + 1, len);
-                                        ssid[len] = '\0';
-                                        snprintf(display_msg, sizeof(display_msg), "No handshake yet: %s", ssid);
-                                    }
-                                }
-                            }
-                            if (display_msg[0] == '\0') {
-                                strncpy(display_msg, "No handshake captured, retrying...", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_ERROR;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "SAVE FAILED") != NULL) {
-                            strncpy(display_msg, "Save failed - no data available", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_ERROR;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Handshake attack cleanup complete") != NULL) {
-                            strncpy(display_msg, "Attack finished.", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        
-                        // Log the message if it's relevant
-                        if (should_log && display_msg[0] != '\0') {
-                            append_handshaker_log(display_msg, log_type);
-                        }
-                        
-                        line_pos = 0;
+        // Determine message type and log it
+        hs_log_type_t log_type = HS_LOG_PROGRESS;
+        bool should_log = false;
+        char display_msg[256] = {0};
+        
+        // ===== SUCCESS INDICATORS (green) =====
+        if (strstr(line_buffer, "Handshake captured for") != NULL) {
+            // Extract SSID: "Handshake captured for 'SSID'"
+            char *start = strchr(line_buffer, '\'');
+            if (start) {
+                char *end = strchr(start + 1, '\'');
+                if (end) {
+                    int len = end - start - 1;
+                    if (len > 0 && len < 64) {
+                        char ssid[64];
+                        strncpy(ssid, start + 1, len);
+                        ssid[len] = '\0';
+                        snprintf(display_msg, sizeof(display_msg), "Handshake captured: %s", ssid);
+                    }
+                }
+            }
+            if (display_msg[0] == '\0') {
+                strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "HANDSHAKE IS COMPLETE AND VALID") != NULL) {
+            strncpy(display_msg, "Handshake validated!", sizeof(display_msg) - 1);
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "PCAP saved:") != NULL || 
+                 strstr(line_buffer, "HCCAPX saved:") != NULL) {
+            // Extract filename from path
+            char *path = strstr(line_buffer, "/sdcard/");
+            if (path) {
+                char *slash = strrchr(path, '/');
+                if (slash) {
+                    snprintf(display_msg, sizeof(display_msg), "Saved: %s", slash + 1);
+                }
+            }
+            if (display_msg[0] == '\0') {
+                strncpy(display_msg, "File saved to SD card", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Handshake #") != NULL && 
+                 strstr(line_buffer, "captured") != NULL) {
+            strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "All selected networks captured") != NULL) {
+            strncpy(display_msg, "All networks captured! Attack complete.", sizeof(display_msg) - 1);
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "handshake saved for SSID:") != NULL) {
+            // Extract SSID
+            char *ssid_start = strstr(line_buffer, "SSID:");
+            if (ssid_start) {
+                ssid_start += 5;
+                while (*ssid_start == ' ') ssid_start++;
+                char ssid[64];
+                int j = 0;
+                while (ssid_start[j] && ssid_start[j] != ' ' && ssid_start[j] != '(' && j < 63) {
+                    ssid[j] = ssid_start[j];
+                    j++;
+                }
+                ssid[j] = '\0';
+                snprintf(display_msg, sizeof(display_msg), "Handshake saved: %s", ssid);
+            } else {
+                strncpy(display_msg, "Handshake saved!", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        
+        // ===== ALREADY CAPTURED DETECTION (amber) =====
+        else if (strstr(line_buffer, "Networks attacked this cycle:") != NULL) {
+            // Parse count: "Networks attacked this cycle: 0"
+            char *num = strstr(line_buffer, "cycle:");
+            if (num) {
+                networks_attacked_this_cycle = atoi(num + 6);
+            }
+            // Check if handshake already existed
+            if (networks_attacked_this_cycle == 0 && handshakes_so_far > 0) {
+                snprintf(display_msg, sizeof(display_msg), "Handshake already on SD card!");
+                log_type = HS_LOG_ALREADY;
+                should_log = true;
+            }
+        }
+        else if (strstr(line_buffer, "Handshakes captured so far:") != NULL) {
+            // Parse count: "Handshakes captured so far: 1"
+            char *num = strstr(line_buffer, "so far:");
+            if (num) {
+                handshakes_so_far = atoi(num + 7);
+            }
+        }
+        
+        // ===== PROGRESS INDICATORS (gray) =====
+        else if (strstr(line_buffer, "Attacking '") != NULL || 
+                 strstr(line_buffer, ">>> [") != NULL) {
+            // Extract network being attacked
+            char *start = strchr(line_buffer, '\'');
+            if (start) {
+                char *end = strchr(start + 1, '\'');
+                if (end) {
+                    int len = end - start - 1;
+                    if (len > 0 && len < 64) {
+                        char ssid[64];
+                        strncpy(ssid, start + 1, len);
+                        ssid[len] = '\0';
+                        snprintf(display_msg, sizeof(display_msg), "Attacking: %s", ssid);
+                    }
+                }
+            }
+            if (display_msg[0] == '\0') {
+                strncpy(display_msg, "Attacking network...", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Burst #") != NULL && 
+                 strstr(line_buffer, "complete") != NULL) {
+            // Extract burst number
+            char *num = strstr(line_buffer, "Burst #");
+            if (num) {
+                int burst = atoi(num + 7);
+                snprintf(display_msg, sizeof(display_msg), "Burst #%d sent", burst);
+            } else {
+                strncpy(display_msg, "Deauth burst sent", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Handshake attack task started") != NULL) {
+            strncpy(display_msg, "Attack started...", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Attack Cycle Complete") != NULL) {
+            strncpy(display_msg, "Attack cycle complete", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        
+        // ===== ERROR/FAILURE INDICATORS (red) =====
+        else if (strstr(line_buffer, "No handshake for") != NULL) {
+            // Extract SSID
+            char *start = strchr(line_buffer, '\'');
+            if (start) {
+                char *end = strchr(start + 1, '\'');
+                if (end) {
+                    int len = end - start - 1;
+                    if (len > 0 && len < 64) {
+                        char ssid[64];
+                        strncpy(ssid, start + 1, len);
+                        ssid[len] = '\0';
+                        snprintf(display_msg, sizeof(display_msg), "No handshake yet: %s", ssid);
                     }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
                 }
             }
+            if (display_msg[0] == '\0') {
+                strncpy(display_msg, "No handshake captured, retrying...", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_ERROR;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "SAVE FAILED") != NULL) {
+            strncpy(display_msg, "Save failed - no data available", sizeof(display_msg) - 1);
+            log_type = HS_LOG_ERROR;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Handshake attack cleanup complete") != NULL) {
+            strncpy(display_msg, "Attack finished.", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        
+        // Log the message if it's relevant
+        if (should_log && display_msg[0] != '\0') {
+            append_handshaker_log(display_msg, log_type);
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Handshaker monitor task ended");
     handshaker_monitor_task_handle = NULL;
@@ -6110,8 +6945,8 @@ static void show_handshaker_popup(void)
             const char *ssid_display = strlen(net->ssid) > 0 ? net->ssid : "(Hidden)";
             
             lv_obj_t *info_label = lv_label_create(network_scroll);
-            lv_label_set_text_fmt(info_label, "%s %s\nBSSID: %s | %s | %s", 
-                                  LV_SYMBOL_WIFI, ssid_display, net->bssid, net->band, net->security);
+            lv_label_set_text_fmt(info_label, "%s %s\nBSSID: " MAC48_FMT " | %s | %s", 
+                                  LV_SYMBOL_WIFI, ssid_display, MAC48_ARGS(net->bssid), net->band, net->security);
             lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, 0);
             lv_obj_set_style_text_color(info_label, lv_color_hex(0xFFFFFF), 0);
         }
@@ -6154,7 +6989,8 @@ static void show_handshaker_popup(void)
     lv_obj_set_style_text_font(stop_label, &lv_font_montserrat_18, 0);
     lv_obj_center(stop_label);
     
-    // Now send UART commands and start monitoring
+    // Now send UART commands and start monitoring; listen first so no response is missed
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);
     
     // Build select_networks command with 1-based indices
     char cmd[128];
@@ -6183,7 +7019,8 @@ static void show_handshaker_popup(void)
         ctx->handshaker_monitoring = true;
     }
     
-    xTaskCreate(handshaker_monitor_task, "hs_monitor", 4096, (void*)ctx, 5, &handshaker_monitor_task_handle);
+    transport_rx_task_create(handshaker_monitor_task, "hs_monitor", 4096, (void*)ctx, rx_sub, 5,
+                             &handshaker_monitor_task_handle);
 }
 
 // ======================= ARP Poison Attack Functions =======================
@@ -6275,16 +7112,17 @@ static void arp_connect_cb(lv_event_t *e)
     
     // Force UI refresh
     lv_refr_now(NULL);
-    bsp_display_unlock();
+    ui_perf_unlock();
     vTaskDelay(pdMS_TO_TICKS(50));
     
     // Send wifi_connect command to current tab's UART
+    uart_port_t uart_port = get_current_uart();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     char cmd[128];
     snprintf(cmd, sizeof(cmd), "wifi_connect %s %s", arp_target_ssid, password);
     uart_send_command_for_tab(cmd);
     
     // Wait for response (up to 15 seconds)
-    uart_port_t uart_port = get_current_uart();
     static char rx_buffer[2048];
     int total_len = 0;
     bool success = false;
@@ -6292,7 +7130,7 @@ static void arp_connect_cb(lv_event_t *e)
     int elapsed_ms = 0;
     
     while (elapsed_ms < timeout_ms && total_len < (int)sizeof(rx_buffer) - 256) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
             rx_buffer[total_len] = '\0';
@@ -6309,8 +7147,9 @@ static void arp_connect_cb(lv_event_t *e)
         }
         elapsed_ms += 200;
     }
+    rx_demux_unsubscribe(rx_sub);
     
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     if (success) {
         ESP_LOGI(TAG, "ARP Poison: Connected to %s", arp_target_ssid);
@@ -6355,12 +7194,13 @@ static void arp_list_hosts_cb(lv_event_t *e)
     
     // Force UI refresh
     lv_refr_now(NULL);
-    bsp_display_unlock();
+    ui_perf_unlock();
     vTaskDelay(pdMS_TO_TICKS(50));
     
     // Send list_hosts command to current tab's UART
-    uart_send_command_for_tab("list_hosts");
     uart_port_t uart_port = get_current_uart();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
+    uart_send_command_for_tab("list_hosts");
     
     // Wait for response (up to 30 seconds for ARP scan)
     static char rx_buffer[4096];
@@ -6369,7 +7209,7 @@ static void arp_list_hosts_cb(lv_event_t *e)
     int elapsed_ms = 0;
     
     while (elapsed_ms < timeout_ms && total_len < (int)sizeof(rx_buffer) - 256) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
             rx_buffer[total_len] = '\0';
@@ -6378,7 +7218,7 @@ static void arp_list_hosts_cb(lv_event_t *e)
             if (strstr(rx_buffer, "Discovered Hosts") != NULL) {
                 // Wait a bit more for all hosts
                 vTaskDelay(pdMS_TO_TICKS(2000));
-                len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(500));
+                len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(500));
                 if (len > 0) {
                     total_len += len;
                     rx_buffer[total_len] = '\0';
@@ -6388,6 +7228,7 @@ static void arp_list_hosts_cb(lv_event_t *e)
         }
         elapsed_ms += 200;
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "ARP Poison: list_hosts response (%d bytes)", total_len);
     
@@ -6413,7 +7254,7 @@ static void arp_list_hosts_cb(lv_event_t *e)
         // Look for host entries: "  IP  ->  MAC"
         else if (strstr(line, "->") != NULL) {
             char ip[20] = {0};
-            char mac[18] = {0};
+            mac48_t mac;
             
             // Parse: "  192.168.3.61  ->  C4:2B:44:12:29:15"
             char *arrow = strstr(line, "->");
@@ -6430,25 +7271,20 @@ static void arp_list_hosts_cb(lv_event_t *e)
                 // Get MAC (after arrow)
                 p = arrow + 2;
                 while (*p == ' ') p++;
-                int mac_len = 0;
-                while (*p && *p != ' ' && *p != '\n' && mac_len < 17) {
-                    mac[mac_len++] = *p++;
-                }
-                mac[mac_len] = '\0';
                 
                 // Validate and store
-                if (strlen(ip) >= 7 && strlen(mac) == 17) {
+                if (strlen(ip) >= 7 && mac48_parse(p, &mac)) {
                     strncpy(arp_hosts[arp_host_count].ip, ip, sizeof(arp_hosts[0].ip) - 1);
-                    strncpy(arp_hosts[arp_host_count].mac, mac, sizeof(arp_hosts[0].mac) - 1);
+                    arp_hosts[arp_host_count].mac = mac;
                     arp_host_count++;
-                    ESP_LOGI(TAG, "ARP host %d: %s -> %s", arp_host_count, ip, mac);
+                    ESP_LOGI(TAG, "ARP host %d: %s -> " MAC48_FMT, arp_host_count, ip, MAC48_ARGS(mac));
                 }
             }
         }
         line = strtok(NULL, "\n\r");
     }
     
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     // Update status
     if (arp_status_label) {
@@ -6488,7 +7324,7 @@ static void arp_list_hosts_cb(lv_event_t *e)
             
             // MAC
             lv_obj_t *mac_lbl = lv_label_create(row);
-            lv_label_set_text(mac_lbl, arp_hosts[i].mac);
+            lv_label_set_text_fmt(mac_lbl, MAC48_FMT, MAC48_ARGS(arp_hosts[i].mac));
             lv_obj_set_style_text_font(mac_lbl, &lv_font_montserrat_14, 0);
             lv_obj_set_style_text_color(mac_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
         }
@@ -6515,11 +7351,11 @@ static void arp_host_click_cb(lv_event_t *e)
     }
     
     arp_host_t *host = &arp_hosts[idx];
-    ESP_LOGI(TAG, "ARP Poison: Starting attack on %s (%s)", host->ip, host->mac);
+    ESP_LOGI(TAG, "ARP Poison: Starting attack on %s (" MAC48_FMT ")", host->ip, MAC48_ARGS(host->mac));
     
     // Send arp_ban command to current tab's UART
     char cmd[64];
-    snprintf(cmd, sizeof(cmd), "arp_ban %s %s", host->mac, host->ip);
+    snprintf(cmd, sizeof(cmd), "arp_ban " MAC48_FMT " %s", MAC48_ARGS(host->mac), host->ip);
     uart_send_command_for_tab(cmd);
     
     // Create attack popup
@@ -6612,15 +7448,16 @@ static void arp_auto_connect_timer_cb(lv_timer_t *timer)
     }
     
     // Force UI refresh
-    bsp_display_lock(0);
-    bsp_display_unlock();
+    ui_perf_lock(0);
+    ui_perf_unlock();
     vTaskDelay(pdMS_TO_TICKS(50));
     
     // Send wifi_connect command to current tab's UART
+    uart_port_t uart_port = get_current_uart();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     char cmd[128];
     snprintf(cmd, sizeof(cmd), "wifi_connect %s %s", arp_target_ssid, arp_target_password);
     uart_send_command_for_tab(cmd);
-    uart_port_t uart_port = get_current_uart();
     
     // Wait for response (up to 15 seconds)
     static char rx_buffer[1024];
@@ -6630,7 +7467,7 @@ static void arp_auto_connect_timer_cb(lv_timer_t *timer)
     bool success = false;
     
     while (elapsed_ms < timeout_ms) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
             rx_buffer[total_len] = '\0';
@@ -6647,44 +7484,43 @@ static void arp_auto_connect_timer_cb(lv_timer_t *timer)
         }
         elapsed_ms += 200;
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "ARP Auto mode: wifi_connect response: %s", rx_buffer);
     
-    bsp_display_lock(0);
+    {
+        UI_LOCK_SCOPE();
     
-    if (success) {
-        ESP_LOGI(TAG, "ARP Auto mode: Connected successfully");
-        arp_wifi_connected = true;
-        
-        if (arp_status_label) {
-            lv_label_set_text_fmt(arp_status_label, "Connected to %s - Click 'List Hosts' to scan", arp_target_ssid);
-            lv_obj_set_style_text_color(arp_status_label, COLOR_MATERIAL_GREEN, 0);
-        }
+        if (success) {
+            ESP_LOGI(TAG, "ARP Auto mode: Connected successfully");
+            arp_wifi_connected = true;
         
-        // Show List Hosts button
-        if (arp_list_hosts_btn) {
-            lv_obj_clear_flag(arp_list_hosts_btn, LV_OBJ_FLAG_HIDDEN);
-        }
+            if (arp_status_label) {
+                lv_label_set_text_fmt(arp_status_label, "Connected to %s - Click 'List Hosts' to scan", arp_target_ssid);
+                lv_obj_set_style_text_color(arp_status_label, COLOR_MATERIAL_GREEN, 0);
+            }
         
-        // Update placeholder text
-        if (arp_hosts_container) {
-            lv_obj_clean(arp_hosts_container);
-            lv_obj_t *placeholder = lv_label_create(arp_hosts_container);
-            lv_label_set_text(placeholder, "Click 'List Hosts' to scan network for targets");
-            lv_obj_set_style_text_font(placeholder, &lv_font_montserrat_14, 0);
-            lv_obj_set_style_text_color(placeholder, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-        }
+            // Show List Hosts button
+            if (arp_list_hosts_btn) {
+                lv_obj_clear_flag(arp_list_hosts_btn, LV_OBJ_FLAG_HIDDEN);
+            }
         
-        bsp_display_unlock();
-    } else {
-        ESP_LOGW(TAG, "ARP Auto mode: Failed to connect");
+            // Update placeholder text
+            if (arp_hosts_container) {
+                lv_obj_clean(arp_hosts_container);
+                lv_obj_t *placeholder = lv_label_create(arp_hosts_container);
+                lv_label_set_text(placeholder, "Click 'List Hosts' to scan network for targets");
+                lv_obj_set_style_text_font(placeholder, &lv_font_montserrat_14, 0);
+                lv_obj_set_style_text_color(placeholder, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+            }
+        } else {
+            ESP_LOGW(TAG, "ARP Auto mode: Failed to connect");
         
-        if (arp_status_label) {
-            lv_label_set_text(arp_status_label, "Connection failed!");
-            lv_obj_set_style_text_color(arp_status_label, COLOR_MATERIAL_RED, 0);
+            if (arp_status_label) {
+                lv_label_set_text(arp_status_label, "Connection failed!");
+                lv_obj_set_style_text_color(arp_status_label, COLOR_MATERIAL_RED, 0);
+            }
         }
-        
-        bsp_display_unlock();
     }
     
     // Reset auto mode flag
@@ -6695,6 +7531,7 @@ static void arp_auto_connect_timer_cb(lv_timer_t *timer)
 // Show ARP Poison page
 static void show_arp_poison_page(void)
 {
+    UI_PAGE_SCOPE("show_arp_poison_page");
     ESP_LOGI(TAG, "Showing ARP Poison page for SSID: %s", arp_target_ssid);
     
     // Reset state
@@ -6763,7 +7600,7 @@ static void show_arp_poison_page(void)
         memset(evil_twin_entries, 0, sizeof(evil_twin_entries));
         
         uart_port_t uart_port = get_current_uart();
-        uart_flush(uart_port);
+        rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
         uart_send_command_for_tab("show_pass evil");
         
         char rx_buffer[512];
@@ -6772,7 +7609,7 @@ static void show_arp_poison_page(void)
         int empty_reads = 0;
         
         while (retries-- > 0 && evil_twin_entry_count < 50) {
-            int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+            int len = rx_demux_read(rx_sub, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
             
             if (len > 0) {
                 rx_buffer[len] = '\0';
@@ -6809,6 +7646,7 @@ static void show_arp_poison_page(void)
             }
             vTaskDelay(pdMS_TO_TICKS(50));
         }
+        rx_demux_unsubscribe(rx_sub);
         
         ESP_LOGI(TAG, "ARP: Loaded %d Evil Twin password entries", evil_twin_entry_count);
         
@@ -7107,12 +7945,13 @@ static void karma_show_probes_cb(lv_event_t *e)
     
     // Force UI refresh
     lv_refr_now(NULL);
-    bsp_display_unlock();
+    ui_perf_unlock();
     vTaskDelay(pdMS_TO_TICKS(50));
     
     // Send list_probes command to current tab's UART
-    uart_send_command_for_tab("list_probes");
     uart_port_t uart_port = get_current_uart();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
+    uart_send_command_for_tab("list_probes");
     vTaskDelay(pdMS_TO_TICKS(500));
     
     // Read response
@@ -7121,12 +7960,13 @@ static void karma_show_probes_cb(lv_event_t *e)
     int retries = 10;
     
     while (retries-- > 0) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
         }
         if (len <= 0) break;
     }
+    rx_demux_unsubscribe(rx_sub);
     rx_buffer[total_len] = '\0';
     
     ESP_LOGI(TAG, "Karma: list_probes response (%d bytes)", total_len);
@@ -7175,7 +8015,7 @@ static void karma_show_probes_cb(lv_event_t *e)
         line = strtok(NULL, "\n\r");
     }
     
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     // Update status
     if (karma_status_label) {
@@ -7229,51 +8069,34 @@ static void karma_fetch_html_files(void)
     karma_html_count = 0;
     memset(karma_html_files, 0, sizeof(karma_html_files));
     
-    uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush(uart_port);
-    uart_send_command_for_tab("list_sd");
-    
     static char rx_buffer[2048];
-    static char line_buffer[256];
-    int line_pos = 0;
-    bool header_found = false;
+    cmd_request_t req = {
+        .command = "list_sd",
+        .fail_markers = sd_fail_markers,
+        .quiet_after = "HTML files found",
+        .quiet_ms = TRANSPORT_SESSION_QUIET_MS,
+        .timeout_ms = 3000,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    cmd_session_run(transport_session_for_tab(current_tab, uart_port_for_tab(current_tab)), &req);
     
-    TickType_t start_time = xTaskGetTickCount();
-    TickType_t timeout_ticks = pdMS_TO_TICKS(3000);
+    bool header_found = false;
     
-    while ((xTaskGetTickCount() - start_time) < timeout_ticks && karma_html_count < 20) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
-        
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        // Check for header line
-                        if (strstr(line_buffer, "HTML files found") != NULL) {
-                            header_found = true;
-                        } else if (header_found && line_pos > 2) {
-                            // Parse line format: "1 PLAY.html"
-                            int file_num;
-                            char filename[64];
-                            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
-                                snprintf(karma_html_files[karma_html_count], 
-                                         sizeof(karma_html_files[0]), "%s", filename);
-                                ESP_LOGI(TAG, "Karma: Found HTML file %d: %s", file_num, filename);
-                                karma_html_count++;
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+    for (char *line_buffer = strtok(rx_buffer, "\n"); line_buffer && karma_html_count < 20;
+         line_buffer = strtok(NULL, "\n")) {
+        // Check for header line
+        if (strstr(line_buffer, "HTML files found") != NULL) {
+            header_found = true;
+        } else if (header_found && strlen(line_buffer) > 2) {
+            // Parse line format: "1 PLAY.html"
+            int file_num;
+            char filename[64];
+            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
+                snprintf(karma_html_files[karma_html_count], 
+                         sizeof(karma_html_files[0]), "%s", filename);
+                ESP_LOGI(TAG, "Karma: Found HTML file %d: %s", file_num, filename);
+                karma_html_count++;
             }
         }
     }
@@ -7334,12 +8157,12 @@ static void karma_probe_click_cb(lv_event_t *e)
     
     // Force refresh to show loading state
     lv_refr_now(NULL);
-    bsp_display_unlock();
+    ui_perf_unlock();
     
     // Fetch HTML files
     karma_fetch_html_files();
     
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     // Remove loading elements
     lv_obj_del(spinner);
@@ -7447,6 +8270,9 @@ static void do_karma_attack_start(void)
         karma_html_dropdown = NULL;
     }
     
+    // The monitor task reads the responses; listen before sending
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(get_current_ctx());
+    
     // Stop any running operation first
     uart_send_command_for_tab("stop");
     vTaskDelay(pdMS_TO_TICKS(200));
@@ -7463,7 +8289,10 @@ static void do_karma_attack_start(void)
     
     // Create attack popup
     lv_obj_t *container = get_current_tab_container();
-    if (!container) return;
+    if (!container) {
+        rx_demux_unsubscribe(rx_sub);
+        return;
+    }
     
     karma_attack_popup_overlay = lv_obj_create(container);
     lv_obj_remove_style_all(karma_attack_popup_overlay);
@@ -7531,7 +8360,7 @@ static void do_karma_attack_start(void)
         ctx->karma_monitoring = true;
     }
     
-    xTaskCreate(karma_monitor_task, "karma_mon", 4096, (void*)ctx, 5, &karma_monitor_task_handle);
+    transport_rx_task_create(karma_monitor_task, "karma_mon", 4096, (void*)ctx, rx_sub, 5, &karma_monitor_task_handle);
 }
 
 // HTML select callback - start karma attack
@@ -7579,103 +8408,83 @@ static void karma_attack_popup_close_cb(lv_event_t *e)
 static void karma_monitor_task(void *arg)
 {
     // Get context passed to task
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     const char *uart_name = tab_transport_name(task_tab);
     
     ESP_LOGI(TAG, "[%s] Karma monitor task started for tab %d", uart_name, task_tab);
     
-    static char rx_buffer[256];
-    static char line_buffer[256];
-    int line_pos = 0;
-    
     // Use context's flag instead of global
     while (ctx && ctx->karma_monitoring) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        // Check for portal started
+        char *ap_name = strstr(line_buffer, "AP Name:");
+        if (ap_name != NULL) {
+            ap_name += 8;
+            while (*ap_name == ' ') ap_name++;
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "Karma UART: %s", line_buffer);
-                        
-                        // Check for portal started
-                        char *ap_name = strstr(line_buffer, "AP Name:");
-                        if (ap_name != NULL) {
-                            ap_name += 8;
-                            while (*ap_name == ' ') ap_name++;
-                            
-                            bsp_display_lock(0);
-                            if (karma_attack_ssid_label) {
-                                lv_label_set_text_fmt(karma_attack_ssid_label, "Portal started: %s", ap_name);
-                                lv_obj_set_style_text_color(karma_attack_ssid_label, COLOR_MATERIAL_GREEN, 0);
-                            }
-                            bsp_display_unlock();
-                        }
-                        
-                        // Check for client connected
-                        char *mac_ptr = strstr(line_buffer, "Client connected - MAC:");
-                        if (mac_ptr != NULL) {
-                            mac_ptr += 23;
-                            while (*mac_ptr == ' ') mac_ptr++;
-                            
-                            char mac[20] = {0};
-                            int j = 0;
-                            while (mac_ptr[j] && mac_ptr[j] != ' ' && mac_ptr[j] != '\n' && j < 17) {
-                                mac[j] = mac_ptr[j];
-                                j++;
-                            }
-                            mac[j] = '\0';
-                            
-                            bsp_display_lock(0);
-                            if (karma_attack_mac_label) {
-                                lv_label_set_text_fmt(karma_attack_mac_label, "Last MAC connected: %s", mac);
-                                lv_obj_set_style_text_color(karma_attack_mac_label, COLOR_MATERIAL_CYAN, 0);
-                            }
-                            bsp_display_unlock();
-                        }
-                        
-                        // Check for password
-                        char *pass_ptr = strstr(line_buffer, "Password:");
-                        if (pass_ptr != NULL) {
-                            pass_ptr += 9;
-                            while (*pass_ptr == ' ') pass_ptr++;
-                            
-                            // Trim trailing whitespace
-                            char pass[64] = {0};
-                            strncpy(pass, pass_ptr, sizeof(pass) - 1);
-                            size_t pass_len = strlen(pass);
-                            while (pass_len > 0 && isspace((unsigned char)pass[pass_len - 1])) {
-                                pass[--pass_len] = '\0';
-                            }
-                            
-                            if (strlen(pass) > 0) {
-                                bsp_display_lock(0);
-                                if (karma_attack_password_label) {
-                                    lv_label_set_text_fmt(karma_attack_password_label, "Password obtained: %s", pass);
-                                }
-                                bsp_display_unlock();
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+            ui_perf_lock(0);
+            if (karma_attack_ssid_label) {
+                lv_label_set_text_fmt(karma_attack_ssid_label, "Portal started: %s", ap_name);
+                lv_obj_set_style_text_color(karma_attack_ssid_label, COLOR_MATERIAL_GREEN, 0);
+            }
+            ui_perf_unlock();
+        }
+        
+        // Check for client connected
+        char *mac_ptr = strstr(line_buffer, "Client connected - MAC:");
+        if (mac_ptr != NULL) {
+            mac_ptr += 23;
+            while (*mac_ptr == ' ') mac_ptr++;
+            
+            char mac[20] = {0};
+            int j = 0;
+            while (mac_ptr[j] && mac_ptr[j] != ' ' && mac_ptr[j] != '\n' && j < 17) {
+                mac[j] = mac_ptr[j];
+                j++;
+            }
+            mac[j] = '\0';
+            
+            ui_perf_lock(0);
+            if (karma_attack_mac_label) {
+                lv_label_set_text_fmt(karma_attack_mac_label, "Last MAC connected: %s", mac);
+                lv_obj_set_style_text_color(karma_attack_mac_label, COLOR_MATERIAL_CYAN, 0);
             }
+            ui_perf_unlock();
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // Check for password
+        char *pass_ptr = strstr(line_buffer, "Password:");
+        if (pass_ptr != NULL) {
+            pass_ptr += 9;
+            while (*pass_ptr == ' ') pass_ptr++;
+            
+            // Trim trailing whitespace
+            char pass[64] = {0};
+            strncpy(pass, pass_ptr, sizeof(pass) - 1);
+            size_t pass_len = strlen(pass);
+            while (pass_len > 0 && isspace((unsigned char)pass[pass_len - 1])) {
+                pass[--pass_len] = '\0';
+            }
+            
+            if (strlen(pass) > 0) {
+                ui_perf_lock(0);
+                if (karma_attack_password_label) {
+                    lv_label_set_text_fmt(karma_attack_password_label, "Password obtained: %s", pass);
+                }
+                ui_perf_unlock();
+            }
+        }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Karma monitor task ended");
     karma_monitor_task_handle = NULL;
@@ -7685,6 +8494,7 @@ static void karma_monitor_task(void *arg)
 // Show Karma page (inside current tab's container)
 static void show_karma_page(void)
 {
+    UI_PAGE_SCOPE("show_karma_page");
     ESP_LOGI(TAG, "Showing Karma page");
     
     // Reset state
@@ -7841,58 +8651,41 @@ static void fetch_html_files_from_sd(void)
     evil_twin_html_count = 0;
     memset(evil_twin_html_files, 0, sizeof(evil_twin_html_files));
     
-    // Flush UART buffer
+    // Listen before sending so the response can't be missed
     uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush(uart_port);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     
     // Send list_sd command to current tab's UART
     uart_send_command_for_tab("list_sd");
     
-    // Buffer for receiving data
-    static char rx_buffer[2048];
-    static char line_buffer[256];
-    int line_pos = 0;
     bool header_found = false;
     
     TickType_t start_time = xTaskGetTickCount();
     TickType_t timeout_ticks = pdMS_TO_TICKS(3000);  // 3 second timeout
     
     while ((xTaskGetTickCount() - start_time) < timeout_ticks && evil_twin_html_count < 20) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        // Check for header line
-                        if (strstr(line_buffer, "HTML files found") != NULL) {
-                            header_found = true;
-                        } else if (header_found && line_pos > 2) {
-                            // Parse line format: "1 PLAY.html"
-                            int file_num;
-                            char filename[64];
-                            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
-                                snprintf(evil_twin_html_files[evil_twin_html_count], 
-                                         sizeof(evil_twin_html_files[0]), "%s", filename);
-                                ESP_LOGI(TAG, "Found HTML file %d: %s", file_num, filename);
-                                evil_twin_html_count++;
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+        // Check for header line
+        if (strstr(line_buffer, "HTML files found") != NULL) {
+            header_found = true;
+        } else if (header_found && (int)rx_line.len > 2) {
+            // Parse line format: "1 PLAY.html"
+            int file_num;
+            char filename[64];
+            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
+                snprintf(evil_twin_html_files[evil_twin_html_count], 
+                         sizeof(evil_twin_html_files[0]), "%s", filename);
+                ESP_LOGI(TAG, "Found HTML file %d: %s", file_num, filename);
+                evil_twin_html_count++;
             }
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Fetched %d HTML files from SD card", evil_twin_html_count);
 }
@@ -7927,125 +8720,106 @@ static void evil_twin_close_cb(lv_event_t *e)
 static void evil_twin_monitor_task(void *arg)
 {
     // Get context passed to task
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     if (!ctx) {
         ESP_LOGE(TAG, "Evil Twin monitor task: NULL context!");
+        rx_demux_unsubscribe(rx_sub);
         vTaskDelete(NULL);
         return;
     }
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = uart_port_for_tab(task_tab);
     const char *uart_name = tab_transport_name(task_tab);
     
-    static char rx_buffer[1024];
-    static char line_buffer[512];
-    int line_pos = 0;
-    
     ESP_LOGI(TAG, "[%s] Evil Twin monitor task started for tab %d", uart_name, task_tab);
     
     // Use context field instead of global
     while (ctx->evil_twin_monitoring) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(200));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(200))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "[%s] Evil Twin: %s", uart_name, line_buffer);
-                        
-                        // Look for client connection: "Client connected - MAC: XX:XX:XX:XX:XX:XX"
-                        char *client_connected = strstr(line_buffer, "Client connected - MAC:");
-                        if (client_connected && ctx->evil_twin_status_label) {
-                            // Extract MAC address
-                            char mac[20] = {0};
-                            char *mac_start = client_connected + 24;  // Skip "Client connected - MAC: "
-                            int mac_len = 0;
-                            while (mac_start[mac_len] && mac_start[mac_len] != '\n' && mac_start[mac_len] != '\r' && mac_len < 17) {
-                                mac[mac_len] = mac_start[mac_len];
-                                mac_len++;
-                            }
-                            
-                            // Update status with client connected message
-                            char status_text[256];
-                            snprintf(status_text, sizeof(status_text),
-                                "Client connected!\n\n"
-                                "MAC: %s\n\n"
-                                "Waiting for password...", mac);
-                            bsp_display_lock(0);
-                            lv_label_set_text(ctx->evil_twin_status_label, status_text);
-                            lv_obj_set_style_text_color(ctx->evil_twin_status_label, COLOR_MATERIAL_AMBER, 0);
-                            bsp_display_unlock();
-                        }
-                        
-                        // Look for password capture pattern:
-                        // "Wi-Fi: connected to SSID='XXX' with password='YYY'"
-                        // Note: SSID and password may be quoted with single quotes
-                        char *connected = strstr(line_buffer, "connected to SSID=");
-                        char *pwd_start = strstr(line_buffer, "password=");
-                        
-                        if (connected && pwd_start) {
-                            // Extract SSID (skip "connected to SSID=" and possible quote)
-                            char captured_ssid[64] = {0};
-                            char *ssid_start = connected + 18;  // Skip "connected to SSID="
-                            if (*ssid_start == '\'') ssid_start++;  // Skip opening quote
-                            char *ssid_end = strstr(ssid_start, "' with");
-                            if (!ssid_end) ssid_end = strstr(ssid_start, " with");
-                            if (ssid_end) {
-                                int ssid_len = ssid_end - ssid_start;
-                                if (ssid_len > 63) ssid_len = 63;
-                                strncpy(captured_ssid, ssid_start, ssid_len);
-                            }
-                            
-                            // Extract password (skip "password=" and possible quote)
-                            char captured_pwd[128] = {0};
-                            pwd_start += 9;  // Skip "password="
-                            if (*pwd_start == '\'') pwd_start++;  // Skip opening quote
-                            // Find end - either closing quote or end of line
-                            int pwd_len = 0;
-                            while (pwd_start[pwd_len] && pwd_start[pwd_len] != '\'' && pwd_start[pwd_len] != '\n' && pwd_start[pwd_len] != '\r') {
-                                pwd_len++;
-                            }
-                            if (pwd_len > 127) pwd_len = 127;
-                            strncpy(captured_pwd, pwd_start, pwd_len);
-                            
-                            ESP_LOGI(TAG, "[%s] PASSWORD CAPTURED! SSID: %s, Password: %s", uart_name, captured_ssid, captured_pwd);
-                            
-                            // Update UI on main thread
-                            if (ctx->evil_twin_status_label) {
-                                char result_text[512];
-                                snprintf(result_text, sizeof(result_text),
-                                    "PASSWORD CAPTURED!\n\n"
-                                    "SSID: %s\n"
-                                    "Password: %s",
-                                    captured_ssid, captured_pwd);
-                                bsp_display_lock(0);
-                                lv_label_set_text(ctx->evil_twin_status_label, result_text);
-                                lv_obj_set_style_text_color(ctx->evil_twin_status_label, COLOR_MATERIAL_GREEN, 0);
-                                bsp_display_unlock();
-                            }
-                            
-                            // Stop monitoring in context
-                            ctx->evil_twin_monitoring = false;
-                            break;
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+        // Look for client connection: "Client connected - MAC: XX:XX:XX:XX:XX:XX"
+        char *client_connected = strstr(line_buffer, "Client connected - MAC:");
+        if (client_connected && ctx->evil_twin_status_label) {
+            // Extract MAC address
+            char mac[20] = {0};
+            char *mac_start = client_connected + 24;  // Skip "Client connected - MAC: "
+            int mac_len = 0;
+            while (mac_start[mac_len] && mac_start[mac_len] != '\n' && mac_start[mac_len] != '\r' && mac_len < 17) {
+                mac[mac_len] = mac_start[mac_len];
+                mac_len++;
             }
+            
+            // Update status with client connected message
+            char status_text[256];
+            snprintf(status_text, sizeof(status_text),
+                "Client connected!\n\n"
+                "MAC: %s\n\n"
+                "Waiting for password...", mac);
+            ui_perf_lock(0);
+            lv_label_set_text(ctx->evil_twin_status_label, status_text);
+            lv_obj_set_style_text_color(ctx->evil_twin_status_label, COLOR_MATERIAL_AMBER, 0);
+            ui_perf_unlock();
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // Look for password capture pattern:
+        // "Wi-Fi: connected to SSID='XXX' with password='YYY'"
+        // Note: SSID and password may be quoted with single quotes
+        char *connected = strstr(line_buffer, "connected to SSID=");
+        char *pwd_start = strstr(line_buffer, "password=");
+        
+        if (connected && pwd_start) {
+            // Extract SSID (skip "connected to SSID=" and possible quote)
+            char captured_ssid[64] = {0};
+            char *ssid_start = connected + 18;  // Skip "connected to SSID="
+            if (*ssid_start == '\'') ssid_start++;  // Skip opening quote
+            char *ssid_end = strstr(ssid_start, "' with");
+            if (!ssid_end) ssid_end = strstr(ssid_start, " with");
+            if (ssid_end) {
+                int ssid_len = ssid_end - ssid_start;
+                if (ssid_len > 63) ssid_len = 63;
+                strncpy(captured_ssid, ssid_start, ssid_len);
+            }
+            
+            // Extract password (skip "password=" and possible quote)
+            char captured_pwd[128] = {0};
+            pwd_start += 9;  // Skip "password="
+            if (*pwd_start == '\'') pwd_start++;  // Skip opening quote
+            // Find end - either closing quote or end of line
+            int pwd_len = 0;
+            while (pwd_start[pwd_len] && pwd_start[pwd_len] != '\'' && pwd_start[pwd_len] != '\n' && pwd_start[pwd_len] != '\r') {
+                pwd_len++;
+            }
+            if (pwd_len > 127) pwd_len = 127;
+            strncpy(captured_pwd, pwd_start, pwd_len);
+            
+            ESP_LOGI(TAG, "[%s] PASSWORD CAPTURED! SSID: %s, Password: %s", uart_name, captured_ssid, captured_pwd);
+            
+            // Update UI on main thread
+            if (ctx->evil_twin_status_label) {
+                char result_text[512];
+                snprintf(result_text, sizeof(result_text),
+                    "PASSWORD CAPTURED!\n\n"
+                    "SSID: %s\n"
+                    "Password: %s",
+                    captured_ssid, captured_pwd);
+                ui_perf_lock(0);
+                lv_label_set_text(ctx->evil_twin_status_label, result_text);
+                lv_obj_set_style_text_color(ctx->evil_twin_status_label, COLOR_MATERIAL_GREEN, 0);
+                ui_perf_unlock();
+            }
+            
+            // Stop monitoring in context
+            ctx->evil_twin_monitoring = false;
+            break;
+        }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Evil Twin monitor task ended");
     evil_twin_monitor_task_handle = NULL;
@@ -8084,6 +8858,9 @@ static void do_evil_twin_start(void)
     int evil_twin_net_idx = selected_network_indices[selected_dropdown_idx];
     int evil_twin_1based = networks[evil_twin_net_idx].index;  // 1-based for UART
     
+    // The monitor task reads the responses; listen before sending
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);
+    
     // Build select_networks command: evil twin first, then others (no duplicates)
     char cmd[128];
     snprintf(cmd, sizeof(cmd), "select_networks %d", evil_twin_1based);
@@ -8127,7 +8904,7 @@ static void do_evil_twin_start(void)
         wifi_network_t *net = &networks[idx];
         const char *ssid = strlen(net->ssid) > 0 ? net->ssid : "(Hidden)";
         pos += snprintf(status_text + pos, sizeof(status_text) - pos,
-            "  - %s (%s)\n", ssid, net->bssid);
+            "  - %s (" MAC48_FMT ")\n", ssid, MAC48_ARGS(net->bssid));
     }
     
     pos += snprintf(status_text + pos, sizeof(status_text) - pos,
@@ -8145,7 +8922,8 @@ static void do_evil_twin_start(void)
     evil_twin_monitoring = true;
     ctx->evil_twin_monitoring = true;
     
-    xTaskCreate(evil_twin_monitor_task, "et_monitor", 4096, (void*)ctx, 5, &evil_twin_monitor_task_handle);
+    transport_rx_task_create(evil_twin_monitor_task, "et_monitor", 4096, (void*)ctx, rx_sub, 5,
+                             &evil_twin_monitor_task_handle);
 }
 
 // Evil Twin start button callback
@@ -8619,6 +9397,7 @@ static void show_internal_tiles(void)
 // Show main tiles screen with tab bar (persistent containers)
 static void show_main_tiles(void)
 {
+    UI_PAGE_SCOPE("show_main_tiles");
     lv_obj_t *scr = lv_scr_act();
 
     if (!ui_theme_is_initialized()) {
@@ -8687,6 +9466,7 @@ static void show_main_tiles(void)
 // Show WiFi Scanner page with Back button (inside current tab's container)
 static void show_scan_page(void)
 {
+    UI_PAGE_SCOPE("show_scan_page");
     // Get current tab's data and container
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
@@ -8750,7 +9530,7 @@ static void show_scan_page(void)
     lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
 
     // Network list container (scrollable) - fills remaining space above attack bar
-    network_list = lv_obj_create(scan_page);
+    network_list = ui_comp_create_vlist(scan_page, SCAN_ROW_HEIGHT, 10, scan_row_create_cb, scan_row_bind_cb, NULL);
     lv_obj_set_width(network_list, lv_pct(100));
     lv_obj_set_flex_grow(network_list, 1);
     ui_theme_apply_section(network_list);
@@ -8760,9 +9540,6 @@ static void show_scan_page(void)
     lv_obj_set_style_bg_grad_dir(network_list, LV_GRAD_DIR_NONE, 0);
     lv_obj_set_style_border_color(network_list, lv_color_mix(ui_theme_color(UI_COLOR_ACCENT_PRIMARY), ui_theme_color(UI_COLOR_BORDER), LV_OPA_30), 0);
     lv_obj_set_style_pad_all(network_list, 10, 0);
-    lv_obj_set_flex_flow(network_list, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(network_list, 10, 0);
-    lv_obj_set_scroll_dir(network_list, LV_DIR_VER);
 
     // Bottom icon bar for attack tiles
     lv_obj_t *attack_bar = lv_obj_create(scan_page);
@@ -8833,13 +9610,19 @@ static void popup_timer_callback(TimerHandle_t xTimer)
     }
 }
 
+// Observer client timestamps, ms since boot
+static uint32_t observer_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
 // Update popup content with current network data
 static void update_popup_content(tab_context_t *ctx)
 {
     if (!ctx) return;
-    if (!ctx->network_popup || ctx->popup_network_idx < 0 || ctx->popup_network_idx >= ctx->observer_network_count) return;
+    if (!ctx->network_popup || ctx->popup_network_idx < 0 || ctx->popup_network_idx >= ctx->observer_store.network_count) return;
     
-    observer_network_t *net = &ctx->observer_networks[ctx->popup_network_idx];
+    observer_network_t *net = &ctx->observer_store.networks[ctx->popup_network_idx];
     
     // Update clients container
     if (ctx->popup_clients_container) {
@@ -8850,13 +9633,18 @@ static void update_popup_content(tab_context_t *ctx)
             lv_label_set_text(no_clients, "No clients detected yet...");
             lv_obj_set_style_text_color(no_clients, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
         } else {
-            for (int j = 0; j < net->client_count && j < MAX_CLIENTS_PER_NETWORK; j++) {
-                if (net->clients[j][0] != '\0') {
-                    lv_obj_t *client_label = lv_label_create(ctx->popup_clients_container);
-                    lv_label_set_text_fmt(client_label, "  %s", net->clients[j]);
-                    lv_obj_set_style_text_font(client_label, &lv_font_montserrat_14, 0);
-                    lv_obj_set_style_text_color(client_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
-                }
+            uint32_t now = observer_now_ms();
+            for (uint32_t id = net->first_client; id != OBSERVER_STORE_NONE; ) {
+                const observer_client_t *client = observer_store_client(&ctx->observer_store, id);
+                if (!client) break;
+                char mac[MAC48_STR_SIZE];
+                mac48_format(&client->mac, mac);
+                lv_obj_t *client_label = lv_label_create(ctx->popup_clients_container);
+                lv_label_set_text_fmt(client_label, "  %s   seen %lus ago", mac,
+                                      (unsigned long)((now - client->last_seen) / 1000));
+                lv_obj_set_style_text_font(client_label, &lv_font_montserrat_14, 0);
+                lv_obj_set_style_text_color(client_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+                id = client->next;
             }
         }
     }
@@ -8916,10 +9704,10 @@ static void show_network_popup(int network_idx)
     tab_context_t *ctx = get_current_ctx();
     if (!ctx) return;
     
-    if (network_idx < 0 || network_idx >= ctx->observer_network_count) return;
+    if (network_idx < 0 || network_idx >= ctx->observer_store.network_count) return;
     if (ctx->popup_open) return;  // Already showing a popup on this tab
     
-    observer_network_t *net = &ctx->observer_networks[network_idx];
+    observer_network_t *net = &ctx->observer_store.networks[network_idx];
     ESP_LOGI(TAG, "Opening popup for network: %s (scan_index=%d)", net->ssid, net->scan_index);
     
     ctx->popup_open = true;
@@ -9007,8 +9795,10 @@ static void show_network_popup(int network_idx)
     lv_obj_set_style_text_color(ssid_label, lv_color_hex(0xFFFFFF), 0);
     
     // BSSID
+    char bssid[MAC48_STR_SIZE];
+    mac48_format(&net->bssid, bssid);
     lv_obj_t *bssid_label = lv_label_create(info_container);
-    lv_label_set_text_fmt(bssid_label, "BSSID: %s", net->bssid);
+    lv_label_set_text_fmt(bssid_label, "BSSID: %s", bssid);
     lv_obj_set_style_text_font(bssid_label, &lv_font_montserrat_16, 0);
     lv_obj_set_style_text_color(bssid_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
     
@@ -9020,7 +9810,7 @@ static void show_network_popup(int network_idx)
     
     // Clients section header
     lv_obj_t *clients_header = lv_label_create(ctx->network_popup);
-    lv_label_set_text_fmt(clients_header, "Clients (%d):", net->client_count);
+    lv_label_set_text_fmt(clients_header, "Clients (%lu):", (unsigned long)net->client_count);
     lv_obj_set_style_text_font(clients_header, &lv_font_montserrat_16, 0);
     lv_obj_set_style_text_color(clients_header, COLOR_MATERIAL_TEAL, 0);
     
@@ -9060,39 +9850,8 @@ static void show_network_popup(int network_idx)
     }
 }
 
-// Helper: Check if MAC already exists in network's client list
-static bool client_mac_exists(observer_network_t *net, const char *mac)
-{
-    for (int i = 0; i < MAX_CLIENTS_PER_NETWORK; i++) {
-        if (net->clients[i][0] != '\0' && strcmp(net->clients[i], mac) == 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
-// Helper: Add client MAC to network if not already present, returns true if added
-static bool add_client_mac(observer_network_t *net, const char *mac)
-{
-    // Check if already exists
-    if (client_mac_exists(net, mac)) {
-        return false;
-    }
-    
-    // Find empty slot
-    for (int i = 0; i < MAX_CLIENTS_PER_NETWORK; i++) {
-        if (net->clients[i][0] == '\0') {
-            strncpy(net->clients[i], mac, sizeof(net->clients[i]) - 1);
-            net->clients[i][sizeof(net->clients[i]) - 1] = '\0';
-            net->client_count++;
-            return true;
-        }
-    }
-    return false;  // No room
-}
-
-// Popup poll task - similar to observer_poll_task but updates popup content
-static void popup_poll_task(void *arg)
+// Popup poll task - similar to observer_poll_task but updates popup content
+static void popup_poll_task(void *arg)
 {
     tab_context_t *ctx = (tab_context_t *)arg;
     if (!ctx) {
@@ -9103,7 +9862,7 @@ static void popup_poll_task(void *arg)
     
     ESP_LOGI(TAG, "Popup poll task started for network idx %d", ctx->popup_network_idx);
     
-    if (!observer_rx_buffer || !observer_line_buffer || !ctx->observer_networks) {
+    if (!ctx->observer_store.networks) {
         ESP_LOGE(TAG, "PSRAM buffers not allocated!");
         ctx->observer_task = NULL;
         vTaskDelete(NULL);
@@ -9114,13 +9873,10 @@ static void popup_poll_task(void *arg)
     tab_id_t task_tab = tab_id_for_ctx(ctx);
     uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     
-    uart_flush(uart_port);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(task_tab, uart_port, NULL);
     char cmd[] = "show_sniffer_results\r\n";
     transport_write_bytes_tab(task_tab, uart_port, cmd, strlen(cmd));
     
-    char *rx_buffer = observer_rx_buffer;
-    char *line_buffer = observer_line_buffer;
-    int line_pos = 0;
     int current_network_idx = -1;
     
     // DON'T clear client data - accumulate clients over time
@@ -9129,53 +9885,32 @@ static void popup_poll_task(void *arg)
     TickType_t timeout_ticks = pdMS_TO_TICKS(5000);
     
     while ((xTaskGetTickCount() - start_time) < timeout_ticks) {
-        int len = transport_read_bytes_tab(task_tab, uart_port, (uint8_t*)rx_buffer, UART_BUF_SIZE - 1, pdMS_TO_TICKS(100));
-        
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        line_view_t rx_line;
+        if (rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            char *line_buffer = rx_line.text;
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        ESP_LOGD(TAG, "POPUP SNIFFER LINE: '%s'", line_buffer);
-                        
-                        // Check for network line (doesn't start with space)
-                        if (line_buffer[0] != ' ' && line_buffer[0] != '\t') {
-                            observer_network_t parsed_net = {0};
-                            if (parse_sniffer_network_line(line_buffer, &parsed_net)) {
-                                // Find this network in our existing list by SSID
-                                current_network_idx = -1;
-                                for (int n = 0; n < ctx->observer_network_count; n++) {
-                                    if (strcmp(ctx->observer_networks[n].ssid, parsed_net.ssid) == 0) {
-                                        current_network_idx = n;
-                                        // Don't overwrite client_count - we track it via add_client_mac
-                                        break;
-                                    }
-                                }
-                            } else {
-                                current_network_idx = -1;
-                            }
-                        }
-                        // Check for client MAC line (starts with space)
-                        else if ((line_buffer[0] == ' ' || line_buffer[0] == '\t') && current_network_idx >= 0) {
-                            observer_network_t *net = &ctx->observer_networks[current_network_idx];
-                            char mac[18];
-                            if (parse_sniffer_client_line(line_buffer, mac, sizeof(mac))) {
-                                // Add client if not already present (accumulate)
-                                if (add_client_mac(net, mac)) {
-                                    ESP_LOGI(TAG, "  -> NEW client: %s for '%s'", mac, net->ssid);
-                                }
-                            }
-                        }
-                        
-                        line_pos = 0;
+            ESP_LOGD(TAG, "POPUP SNIFFER LINE: '%s'", line_buffer);
+            
+            // Check for network line (doesn't start with space)
+            if (line_buffer[0] != ' ' && line_buffer[0] != '\t') {
+                char ssid[33];
+                int channel = 0;
+                if (parse_sniffer_network_line(line_buffer, ssid, sizeof(ssid), &channel)) {
+                    // Sniffer lines only name the SSID; the channel tells duplicates apart
+                    current_network_idx = observer_store_find_ssid(&ctx->observer_store, ssid, channel);
+                } else {
+                    current_network_idx = -1;
+                }
+            }
+            // Check for client MAC line (starts with space)
+            else if ((line_buffer[0] == ' ' || line_buffer[0] == '\t') && current_network_idx >= 0) {
+                mac48_t mac;
+                if (parse_sniffer_client_line(line_buffer, &mac)) {
+                    // Add client if not already present (accumulate)
+                    if (observer_store_add_client(&ctx->observer_store, current_network_idx, &mac, observer_now_ms())) {
+                        ESP_LOGI(TAG, "  -> NEW client: %s for '%s'", line_buffer + strspn(line_buffer, " \t"),
+                                 ctx->observer_store.networks[current_network_idx].ssid);
                     }
-                } else if (line_pos < OBSERVER_LINE_BUFFER_SIZE - 1) {
-                    line_buffer[line_pos++] = c;
                 }
             }
         }
@@ -9185,12 +9920,13 @@ static void popup_poll_task(void *arg)
             break;
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     // Update popup UI
     if (ctx->popup_open) {
-        bsp_display_lock(0);
+        ui_perf_lock(0);
         update_popup_content(ctx);
-        bsp_display_unlock();
+        ui_perf_unlock();
     }
     
     ESP_LOGI(TAG, "Popup poll task finished");
@@ -9199,114 +9935,139 @@ static void popup_poll_task(void *arg)
 }
 
 // Update observer table UI with current data
-static void update_observer_table(tab_context_t *ctx)
+// Observer table rows pack (network_idx << 16) | client_id; network rows use OBSERVER_ROW_NETWORK
+#define OBSERVER_ROW_NETWORK    0xFFFF
+#define OBSERVER_ROW_HEIGHT     56
+
+static void observer_row_create_cb(lv_obj_t *row, void *user_data)
 {
-    if (!ctx || !ctx->observer_table || !ctx->observer_networks) return;
-    
-    // Save current scroll position before cleaning
-    lv_coord_t scroll_y = lv_obj_get_scroll_y(ctx->observer_table);
-    
-    lv_obj_clean(ctx->observer_table);
-    
-    for (int i = 0; i < ctx->observer_network_count; i++) {
-        observer_network_t *net = &ctx->observer_networks[i];
-        
-        // Create network row (darker background, clickable) - 2 lines like WiFi Scanner
-        lv_obj_t *net_row = lv_obj_create(ctx->observer_table);
-        lv_obj_set_size(net_row, lv_pct(100), LV_SIZE_CONTENT);
-        lv_obj_set_style_pad_all(net_row, 8, 0);
-        lv_obj_set_style_bg_color(net_row, ui_theme_color(UI_COLOR_CARD), 0);
-        lv_obj_set_style_bg_color(net_row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
-        lv_obj_set_style_border_width(net_row, 0, 0);
-        lv_obj_set_style_radius(net_row, 8, 0);
-        lv_obj_set_flex_flow(net_row, LV_FLEX_FLOW_COLUMN);
-        lv_obj_set_style_pad_row(net_row, 4, 0);
-        lv_obj_clear_flag(net_row, LV_OBJ_FLAG_SCROLLABLE);
-        lv_obj_add_flag(net_row, LV_OBJ_FLAG_CLICKABLE);
-        
-        // Add click event with network index as user data
-        lv_obj_add_event_cb(net_row, network_row_click_cb, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-        
-        // First row: SSID (or "Hidden") + client count
-        lv_obj_t *ssid_label = lv_label_create(net_row);
-        if (strlen(net->ssid) > 0) {
-            if (net->client_count > 0) {
-                lv_label_set_text_fmt(ssid_label, "%s  (%d clients)", net->ssid, net->client_count);
-            } else {
-                lv_label_set_text(ssid_label, net->ssid);
-            }
+    (void)user_data;
+
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
+    lv_obj_set_style_pad_row(row, 4, 0);
+    lv_obj_set_style_pad_top(row, 0, 0);
+    lv_obj_set_style_pad_bottom(row, 0, 0);
+    lv_obj_set_style_pad_right(row, 8, 0);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(row, observer_row_click_cb, LV_EVENT_CLICKED, NULL);
+
+    // Title: SSID + client count for networks, MAC for clients
+    lv_obj_t *title_label = lv_label_create(row);
+    lv_obj_set_width(title_label, lv_pct(100));
+    lv_label_set_long_mode(title_label, LV_LABEL_LONG_DOT);
+
+    // BSSID | Band | RSSI, networks only (observer_network_t doesn't have security)
+    lv_obj_t *info_label = lv_label_create(row);
+    lv_obj_set_style_text_font(info_label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(info_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+}
+
+static void observer_row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
+{
+    tab_context_t *ctx = (tab_context_t *)user_data;
+    if (!ctx || !ctx->observer_rows || (int)index >= ctx->observer_row_count) return;
+
+    uint32_t packed = ctx->observer_rows[index];
+    int network_idx = (int)(packed >> 16);
+    uint32_t client_id = packed & 0xFFFF;
+    observer_network_t *net = &ctx->observer_store.networks[network_idx];
+    lv_obj_t *title_label = lv_obj_get_child(row, 0);
+    lv_obj_t *info_label = lv_obj_get_child(row, 1);
+    bool is_client = (client_id != OBSERVER_ROW_NETWORK);
+
+    // Row user data remembers the styled kind (1 = network, 2 = client), restyle only on change
+    intptr_t kind = is_client ? 2 : 1;
+    if ((intptr_t)lv_obj_get_user_data(row) != kind) {
+        lv_obj_set_user_data(row, (void *)kind);
+        if (is_client) {
+            // Client row (indented, lighter background)
+            lv_obj_set_style_pad_left(row, 32, 0);
+            lv_obj_set_style_radius(row, 4, 0);
+            lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+            lv_obj_set_style_text_font(title_label, &lv_font_montserrat_14, 0);
+            lv_obj_set_style_text_color(title_label, COLOR_MATERIAL_TEAL, 0);
         } else {
-            if (net->client_count > 0) {
-                lv_label_set_text_fmt(ssid_label, "(Hidden)  (%d clients)", net->client_count);
-            } else {
-                lv_label_set_text(ssid_label, "(Hidden)");
-            }
+            // Network row (darker background) - 2 lines like WiFi Scanner
+            lv_obj_set_style_pad_left(row, 8, 0);
+            lv_obj_set_style_radius(row, 8, 0);
+            lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+            lv_obj_set_style_text_font(title_label, &lv_font_montserrat_18, 0);
+            lv_obj_set_style_text_color(title_label, lv_color_hex(0xFFFFFF), 0);
         }
-        lv_obj_set_style_text_font(ssid_label, &lv_font_montserrat_18, 0);
-        lv_obj_set_style_text_color(ssid_label, lv_color_hex(0xFFFFFF), 0);
-        
-        // Second row: BSSID | Band | RSSI (observer_network_t doesn't have security)
-        lv_obj_t *info_label = lv_label_create(net_row);
-        lv_label_set_text_fmt(info_label, "%s  |  %s  |  %d dBm", 
-                              net->bssid, net->band, net->rssi);
-        lv_obj_set_style_text_font(info_label, &lv_font_montserrat_12, 0);
-        lv_obj_set_style_text_color(info_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-        
-        // Create client rows (indented, lighter background, clickable)
-        for (int j = 0; j < MAX_CLIENTS_PER_NETWORK; j++) {
-            if (net->clients[j][0] == '\0') continue;
-            
-            lv_obj_t *client_row = lv_obj_create(ctx->observer_table);
-            lv_obj_set_size(client_row, lv_pct(100), LV_SIZE_CONTENT);
-            lv_obj_set_style_pad_all(client_row, 6, 0);
-            lv_obj_set_style_pad_left(client_row, 32, 0);  // Indent
-            lv_obj_set_style_bg_color(client_row, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
-            lv_obj_set_style_bg_color(client_row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
-            lv_obj_set_style_border_width(client_row, 0, 0);
-            lv_obj_set_style_radius(client_row, 4, 0);
-            lv_obj_clear_flag(client_row, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_add_flag(client_row, LV_OBJ_FLAG_CLICKABLE);
-            
-            // Pack network_idx and client_idx into user_data: (network_idx << 16) | client_idx
-            intptr_t packed_data = ((intptr_t)i << 16) | (intptr_t)j;
-            lv_obj_add_event_cb(client_row, client_row_click_cb, LV_EVENT_CLICKED, (void*)packed_data);
-            
-            lv_obj_t *mac_label = lv_label_create(client_row);
-            lv_label_set_text(mac_label, net->clients[j]);
-            lv_obj_set_style_text_font(mac_label, &lv_font_montserrat_14, 0);
-            lv_obj_set_style_text_color(mac_label, COLOR_MATERIAL_TEAL, 0);
+    }
+
+    if (is_client) {
+        const observer_client_t *client = observer_store_client(&ctx->observer_store, client_id);
+        char mac[MAC48_STR_SIZE];
+        if (client) {
+            mac48_format(&client->mac, mac);
+            ui_comp_patch_label_text(title_label, mac);
         }
+        ui_comp_patch_flag(info_label, LV_OBJ_FLAG_HIDDEN, true);
+        return;
     }
-    
-    // Restore scroll position after rebuild
-    lv_obj_scroll_to_y(ctx->observer_table, scroll_y, LV_ANIM_OFF);
+
+    const char *ssid = (net->ssid[0] != '\0') ? net->ssid : "(Hidden)";
+    if (net->client_count > 0) {
+        ui_comp_patch_label_text_fmt(title_label, "%s  (%lu clients)", ssid, (unsigned long)net->client_count);
+    } else {
+        ui_comp_patch_label_text(title_label, ssid);
+    }
+    char bssid[MAC48_STR_SIZE];
+    mac48_format(&net->bssid, bssid);
+    ui_comp_patch_label_text_fmt(info_label, "%s  |  %s  |  %d dBm",
+                                 bssid, net->band, net->rssi);
+    ui_comp_patch_flag(info_label, LV_OBJ_FLAG_HIDDEN, false);
+}
+
+static lv_obj_t *create_observer_table(lv_obj_t *parent, tab_context_t *ctx)
+{
+    return ui_comp_create_vlist(parent, OBSERVER_ROW_HEIGHT, 6, observer_row_create_cb, observer_row_bind_cb, ctx);
 }
 
-// Network row click handler
-static void network_row_click_cb(lv_event_t *e)
+static void update_observer_table(tab_context_t *ctx)
 {
-    int network_idx = (int)(intptr_t)lv_event_get_user_data(e);
-    ESP_LOGI(TAG, "Network row clicked: index %d", network_idx);
+    if (!ctx || !ctx->observer_table || !ctx->observer_store.networks || !ctx->observer_rows) return;
     
-    tab_context_t *ctx = get_current_ctx();
-    if (ctx && network_idx >= 0 && network_idx < ctx->observer_network_count) {
-        show_network_popup(network_idx);
+    // Flatten networks and their clients; the virtual table keeps its row objects and scroll position
+    int row_count = 0;
+    for (int i = 0; i < ctx->observer_store.network_count && row_count < OBSERVER_MAX_ROWS; i++) {
+        observer_network_t *net = &ctx->observer_store.networks[i];
+        ctx->observer_rows[row_count++] = ((uint32_t)i << 16) | OBSERVER_ROW_NETWORK;
+        for (uint32_t id = net->first_client; id != OBSERVER_STORE_NONE && row_count < OBSERVER_MAX_ROWS;
+             id = ctx->observer_store.clients[id].next) {
+            ctx->observer_rows[row_count++] = ((uint32_t)i << 16) | id;
+        }
     }
+    ctx->observer_row_count = row_count;
+    
+    ui_comp_update_counters_t before;
+    ui_comp_get_update_counters(&before);
+    ui_comp_vlist_set_count(ctx->observer_table, (uint32_t)row_count);
+    ui_log_update_cost("Observer table", &before);
 }
 
-// Client row click handler - opens deauth popup
-static void client_row_click_cb(lv_event_t *e)
+// Observer row click handler - network rows open the network popup, client rows the deauth popup
+static void observer_row_click_cb(lv_event_t *e)
 {
-    intptr_t packed_data = (intptr_t)lv_event_get_user_data(e);
-    int network_idx = (int)(packed_data >> 16);
-    int client_idx = (int)(packed_data & 0xFFFF);
+    int32_t row = ui_comp_vlist_row_index(lv_event_get_current_target(e));
+    tab_context_t *ctx = get_current_ctx();
+    if (!ctx || !ctx->observer_rows || row < 0 || row >= ctx->observer_row_count) return;
     
-    ESP_LOGI(TAG, "Client row clicked: network=%d, client=%d", network_idx, client_idx);
+    uint32_t packed = ctx->observer_rows[row];
+    int network_idx = (int)(packed >> 16);
+    uint32_t client_id = packed & 0xFFFF;
+    if (network_idx >= ctx->observer_store.network_count) return;
     
-    tab_context_t *ctx = get_current_ctx();
-    if (ctx && network_idx >= 0 && network_idx < ctx->observer_network_count &&
-        client_idx >= 0 && client_idx < MAX_CLIENTS_PER_NETWORK) {
-        show_deauth_popup(network_idx, client_idx);
+    if (client_id == OBSERVER_ROW_NETWORK) {
+        ESP_LOGI(TAG, "Network row clicked: index %d", network_idx);
+        show_network_popup(network_idx);
+    } else {
+        ESP_LOGI(TAG, "Client row clicked: network=%d, client=%lu", network_idx, (unsigned long)client_id);
+        show_deauth_popup(network_idx, (int)client_id);
     }
 }
 
@@ -9326,13 +10087,15 @@ static void show_deauth_popup(int network_idx, int client_idx)
         return;
     }
     
-    if (network_idx < 0 || network_idx >= ctx->observer_network_count) return;
+    if (network_idx < 0 || network_idx >= ctx->observer_store.network_count) return;
     if (deauth_popup_obj != NULL) return;  // Already showing a popup
     
-    observer_network_t *net = &ctx->observer_networks[network_idx];
-    if (net->clients[client_idx][0] == '\0') return;
+    observer_network_t *net = &ctx->observer_store.networks[network_idx];
+    const observer_client_t *client = observer_store_client(&ctx->observer_store, (uint32_t)client_idx);
+    if (!client || client->network != network_idx) return;
     
-    const char *client_mac = net->clients[client_idx];
+    char client_mac[MAC48_STR_SIZE];
+    mac48_format(&client->mac, client_mac);
     ESP_LOGI(TAG, "Opening deauth popup for client: %s on network: %s", client_mac, net->ssid);
     
     deauth_network_idx = network_idx;
@@ -9410,8 +10173,10 @@ static void show_deauth_popup(int network_idx, int client_idx)
     lv_obj_set_style_text_color(ssid_label, lv_color_hex(0xFFFFFF), 0);
     
     // BSSID + Channel
+    char bssid[MAC48_STR_SIZE];
+    mac48_format(&net->bssid, bssid);
     lv_obj_t *bssid_label = lv_label_create(info_container);
-    lv_label_set_text_fmt(bssid_label, "BSSID: %s  |  CH%d", net->bssid, net->channel);
+    lv_label_set_text_fmt(bssid_label, "BSSID: %s  |  CH%d", bssid, net->channel);
     lv_obj_set_style_text_font(bssid_label, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(bssid_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
     
@@ -9481,11 +10246,14 @@ static void deauth_btn_click_cb(lv_event_t *e)
     
     if (!deauth_active) {
         // Start deauth
-        if (deauth_network_idx >= 0 && deauth_network_idx < ctx->observer_network_count &&
-            deauth_client_idx >= 0 && deauth_client_idx < MAX_CLIENTS_PER_NETWORK) {
+        const observer_client_t *client = deauth_client_idx >= 0
+            ? observer_store_client(&ctx->observer_store, (uint32_t)deauth_client_idx) : NULL;
+        if (deauth_network_idx >= 0 && deauth_network_idx < ctx->observer_store.network_count &&
+            client && client->network == deauth_network_idx) {
             
-            observer_network_t *net = &ctx->observer_networks[deauth_network_idx];
-            const char *client_mac = net->clients[deauth_client_idx];
+            observer_network_t *net = &ctx->observer_store.networks[deauth_network_idx];
+            char client_mac[MAC48_STR_SIZE];
+            mac48_format(&client->mac, client_mac);
             
             ESP_LOGI(TAG, "Starting deauth: network=%d (scan_idx=%d), client=%s", 
                      deauth_network_idx, net->scan_index, client_mac);
@@ -9520,7 +10288,7 @@ static void deauth_btn_click_cb(lv_event_t *e)
 }
 
 // Parse sniffer output line - returns true if network line parsed
-static bool parse_sniffer_network_line(const char *line, observer_network_t *net)
+static bool parse_sniffer_network_line(const char *line, char *ssid, size_t ssid_size, int *channel)
 {
     // Format: "SSID, CHxx: count" or "Unknown_XXXX, CHxx: count"
     // Line should NOT start with space (those are client MACs)
@@ -9531,24 +10299,18 @@ static bool parse_sniffer_network_line(const char *line, observer_network_t *net
     if (!ch_marker) return false;
     
     // Extract SSID (everything before ", CH")
-    int ssid_len = ch_marker - line;
-    if (ssid_len >= (int)sizeof(net->ssid)) ssid_len = sizeof(net->ssid) - 1;
-    strncpy(net->ssid, line, ssid_len);
-    net->ssid[ssid_len] = '\0';
-    
-    // Parse channel and client count: "CHxx: count"
-    int channel = 0, count = 0;
-    if (sscanf(ch_marker, ", CH%d: %d", &channel, &count) == 2) {
-        net->channel = channel;
-        net->client_count = count;
-        return true;
-    }
+    size_t ssid_len = ch_marker - line;
+    if (ssid_len >= ssid_size) ssid_len = ssid_size - 1;
+    memcpy(ssid, line, ssid_len);
+    ssid[ssid_len] = '\0';
     
-    return false;
+    // Parse channel and client count: "CHxx: count" (the count is recomputed from the client lines)
+    int count = 0;
+    return sscanf(ch_marker, ", CH%d: %d", channel, &count) == 2;
 }
 
 // Parse client MAC line (starts with space)
-static bool parse_sniffer_client_line(const char *line, char *mac_out, size_t mac_size)
+static bool parse_sniffer_client_line(const char *line, mac48_t *mac_out)
 {
     // Line starts with space followed by MAC address
     if (line[0] != ' ') return false;
@@ -9557,20 +10319,18 @@ static bool parse_sniffer_client_line(const char *line, char *mac_out, size_t ma
     const char *p = line;
     while (*p == ' ' || *p == '\t') p++;
     
-    // Check if it looks like a MAC address (XX:XX:XX:XX:XX:XX)
-    if (strlen(p) >= 17 && p[2] == ':' && p[5] == ':') {
-        strncpy(mac_out, p, mac_size - 1);
-        mac_out[mac_size - 1] = '\0';
-        // Trim trailing whitespace/newline
-        char *end = mac_out + strlen(mac_out) - 1;
-        while (end > mac_out && (*end == ' ' || *end == '\n' || *end == '\r')) {
-            *end = '\0';
-            end--;
-        }
-        return true;
+    // XX:XX:XX:XX:XX:XX, anything after it is ignored
+    return mac48_parse(p, mac_out);
+}
+
+// Run by observer_poll_task on the LVGL task
+static void observer_poll_ui(void *data)
+{
+    tab_context_t *ctx = *(tab_context_t **)data;
+    if (ctx->observer_status_label) {
+        lv_label_set_text_fmt(ctx->observer_status_label, "Found %d networks", ctx->observer_store.network_count);
     }
-    
-    return false;
+    update_observer_table(ctx);
 }
 
 // Observer poll task - runs show_sniffer_results and parses output
@@ -9591,28 +10351,25 @@ static void observer_poll_task(void *arg)
     ESP_LOGI(TAG, "[%s] Observer poll task started", uart_name);
     
     // Check if PSRAM buffers are allocated
-    if (!observer_rx_buffer || !observer_line_buffer || !ctx->observer_networks) {
+    if (!ctx->observer_store.networks) {
         ESP_LOGE(TAG, "[%s] PSRAM buffers not allocated!", uart_name);
         ctx->observer_task = NULL;
         vTaskDelete(NULL);
         return;
     }
     
-    // Flush UART buffer
-    uart_flush(uart_port);
+    // Listen before sending so the response can't be missed
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_records_tab(task_tab, uart_port,
+                                                                TRANSPORT_RX_RECORDS(WIRE_TYPE_SNIFFER_AP));
     
     // Send show_sniffer_results command to correct UART
     char cmd[] = "show_sniffer_results\r\n";
     transport_write_bytes_tab(task_tab, uart_port, cmd, strlen(cmd));
     ESP_LOGI(TAG, "[%s] Sent: show_sniffer_results", uart_name);
     
-    // Use PSRAM-allocated buffers
-    char *rx_buffer = observer_rx_buffer;
-    char *line_buffer = observer_line_buffer;
-    int line_pos = 0;
-    
-    // Track current network being updated (index into ctx->observer_networks)
+    // Track current network being updated (index into ctx->observer_store.networks)
     int current_network_idx = -1;
+    rx_parse_cost_t parse_cost = {0};
     
     // DON'T clear client data - accumulate clients over time
     
@@ -9620,63 +10377,65 @@ static void observer_poll_task(void *arg)
     TickType_t timeout_ticks = pdMS_TO_TICKS(5000);  // 5 second timeout for response
     
     while ((xTaskGetTickCount() - start_time) < timeout_ticks) {
-        int len = transport_read_bytes_tab(task_tab, uart_port, rx_buffer, UART_BUF_SIZE - 1, pdMS_TO_TICKS(100));
-        
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        rx_demux_msg_t msg;
+        bool received = rx_demux_next(rx_sub, &msg, pdMS_TO_TICKS(100));
+        if (received && msg.record) {
+            // One record carries the network and its clients
+            const wire_record_t *rec = (const wire_record_t *)msg.record;
+            current_network_idx = -1;
+            if (rec->type == WIRE_TYPE_SNIFFER_AP) {
+                const wire_sniffer_ap_t *ap = &rec->u.sniffer;
+                int64_t parse_start = esp_timer_get_time();
+                int idx = observer_store_find_ssid(&ctx->observer_store, ap->ssid, ap->channel);
+                uint32_t added = 0;
+                for (uint8_t i = 0; idx >= 0 && i < ap->clients_listed; i++) {
+                    added += observer_store_add_client(&ctx->observer_store, idx, &ap->clients[i], observer_now_ms());
+                }
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
+                if (idx < 0) {
+                    ESP_LOGW(TAG, "[%s] Network '%s' not in scan list, skipping", uart_name, ap->ssid);
+                } else if (added > 0) {
+                    ESP_LOGI(TAG, "[%s] '%s': %lu new clients (total: %lu)", uart_name, ap->ssid, (unsigned long)added,
+                             (unsigned long)ctx->observer_store.networks[idx].client_count);
+                }
+            }
+        } else if (received) {
+            char *line_buffer = msg.line.text;
+            ESP_LOGD(TAG, "Observer line: %s", line_buffer);
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGD(TAG, "Observer line: %s", line_buffer);
-                        
-                        // Log every line received for debugging
-                        ESP_LOGI(TAG, "SNIFFER LINE: '%s'", line_buffer);
-                        
-                        // Check for network line (doesn't start with space)
-                        if (line_buffer[0] != ' ' && line_buffer[0] != '\t') {
-                            observer_network_t parsed_net = {0};
-                            if (parse_sniffer_network_line(line_buffer, &parsed_net)) {
-                                // Find this network in our existing list by SSID
-                                current_network_idx = -1;
-                                for (int n = 0; n < ctx->observer_network_count; n++) {
-                                    if (strcmp(ctx->observer_networks[n].ssid, parsed_net.ssid) == 0) {
-                                        current_network_idx = n;
-                                        // Don't overwrite client_count - we track it via add_client_mac
-                                        ESP_LOGI(TAG, "[%s] Found network '%s' at idx %d (count: %d)", 
-                                                 uart_name, parsed_net.ssid, n, ctx->observer_networks[n].client_count);
-                                        break;
-                                    }
-                                }
-                                if (current_network_idx < 0) {
-                                    ESP_LOGW(TAG, "[%s] Network '%s' not in scan list, skipping", uart_name, parsed_net.ssid);
-                                }
-                            } else {
-                                // Not a network line (could be command echo, prompt, etc.)
-                                current_network_idx = -1;
-                            }
-                        }
-                        // Check for client MAC line (starts with space)
-                        else if ((line_buffer[0] == ' ' || line_buffer[0] == '\t') && current_network_idx >= 0) {
-                            observer_network_t *net = &ctx->observer_networks[current_network_idx];
-                            char mac[18];
-                            if (parse_sniffer_client_line(line_buffer, mac, sizeof(mac))) {
-                                // Add client if not already present (accumulate)
-                                if (add_client_mac(net, mac)) {
-                                    ESP_LOGI(TAG, "  -> NEW client: %s for '%s' (total: %d)", mac, net->ssid, net->client_count);
-                                }
-                            } else {
-                                ESP_LOGW(TAG, "  -> Failed to parse as client MAC");
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < OBSERVER_LINE_BUFFER_SIZE - 1) {
-                    line_buffer[line_pos++] = c;
+            // Check for network line (doesn't start with space)
+            if (line_buffer[0] != ' ' && line_buffer[0] != '\t') {
+                char ssid[33];
+                int channel = 0;
+                int64_t parse_start = esp_timer_get_time();
+                bool parsed = parse_sniffer_network_line(line_buffer, ssid, sizeof(ssid), &channel);
+                // Sniffer lines only name the SSID; the channel tells duplicates apart.
+                // Anything else (command echo, prompt, etc.) ends the current network.
+                current_network_idx = parsed ? observer_store_find_ssid(&ctx->observer_store, ssid, channel) : -1;
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
+                if (current_network_idx >= 0) {
+                    ESP_LOGI(TAG, "[%s] Found network '%s' at idx %d (count: %lu)", 
+                             uart_name, ssid, current_network_idx,
+                             (unsigned long)ctx->observer_store.networks[current_network_idx].client_count);
+                } else if (parsed) {
+                    ESP_LOGW(TAG, "[%s] Network '%s' not in scan list, skipping", uart_name, ssid);
+                }
+            }
+            // Check for client MAC line (starts with space)
+            else if (current_network_idx >= 0) {
+                observer_network_t *net = &ctx->observer_store.networks[current_network_idx];
+                mac48_t mac;
+                int64_t parse_start = esp_timer_get_time();
+                bool parsed = parse_sniffer_client_line(line_buffer, &mac);
+                // Add client if not already present (accumulate)
+                bool added = parsed &&
+                             observer_store_add_client(&ctx->observer_store, current_network_idx, &mac, observer_now_ms());
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
+                if (added) {
+                    ESP_LOGI(TAG, "  -> NEW client: %s for '%s' (total: %lu)",
+                             line_buffer + strspn(line_buffer, " \t"), net->ssid, (unsigned long)net->client_count);
+                } else if (!parsed) {
+                    ESP_LOGW(TAG, "  -> Failed to parse as client MAC");
                 }
             }
         }
@@ -9687,37 +10446,37 @@ static void observer_poll_task(void *arg)
             break;
         }
     }
+    rx_demux_unsubscribe(rx_sub);
+    rx_parse_cost_log(uart_name, "Sniffer", &parse_cost);
     
     // Log summary of parsed data
     ESP_LOGI(TAG, "[%s] === SNIFFER UPDATE SUMMARY ===", uart_name);
-    ESP_LOGI(TAG, "[%s] Total networks: %d", uart_name, ctx->observer_network_count);
+    ESP_LOGI(TAG, "[%s] Total networks: %d", uart_name, ctx->observer_store.network_count);
     int networks_with_clients = 0;
-    for (int i = 0; i < ctx->observer_network_count; i++) {
-        if (ctx->observer_networks[i].client_count > 0) {
+    for (int i = 0; i < ctx->observer_store.network_count; i++) {
+        observer_network_t *net = &ctx->observer_store.networks[i];
+        if (net->client_count > 0) {
             networks_with_clients++;
-            ESP_LOGI(TAG, "[%s] Network %d: '%s' CH%d clients=%d", 
-                     uart_name, i, ctx->observer_networks[i].ssid, ctx->observer_networks[i].channel, ctx->observer_networks[i].client_count);
-            for (int j = 0; j < MAX_CLIENTS_PER_NETWORK && ctx->observer_networks[i].clients[j][0] != '\0'; j++) {
-                ESP_LOGI(TAG, "[%s]   Client %d: %s", uart_name, j, ctx->observer_networks[i].clients[j]);
+            ESP_LOGI(TAG, "[%s] Network %d: '%s' CH%d clients=%lu", 
+                     uart_name, i, net->ssid, net->channel, (unsigned long)net->client_count);
+            int j = 0;
+            for (uint32_t id = net->first_client; id != OBSERVER_STORE_NONE; id = ctx->observer_store.clients[id].next) {
+                char mac[MAC48_STR_SIZE];
+                mac48_format(&ctx->observer_store.clients[id].mac, mac);
+                ESP_LOGI(TAG, "[%s]   Client %d: %s", uart_name, j++, mac);
             }
         }
     }
-    ESP_LOGI(TAG, "[%s] Networks with clients: %d/%d", uart_name, networks_with_clients, ctx->observer_network_count);
+    ESP_LOGI(TAG, "[%s] Networks with clients: %d/%d, clients: %lu (dropped %lu)", uart_name, networks_with_clients,
+             ctx->observer_store.network_count, (unsigned long)ctx->observer_store.client_count,
+             (unsigned long)ctx->observer_store.dropped_clients);
     ESP_LOGI(TAG, "[%s] ==============================", uart_name);
     
     // Update UI if observer is still running
-    if (ctx->observer_running && ctx->observer_networks) {
+    if (ctx->observer_running && ctx->observer_store.networks) {
         
-        // Update UI
-        bsp_display_lock(0);
-        
-        if (ctx->observer_status_label) {
-            lv_label_set_text_fmt(ctx->observer_status_label, "Found %d networks", ctx->observer_network_count);
-        }
-        
-        update_observer_table(ctx);
-        
-        bsp_display_unlock();
+        // Update UI on the LVGL task; wait for it, the next poll rewrites the store
+        ui_cmd_call(observer_poll_ui, &ctx, sizeof(ctx), portMAX_DELAY);
     }
     
     ESP_LOGI(TAG, "[%s] Observer poll task finished", uart_name);
@@ -9773,26 +10532,37 @@ static bool parse_scan_to_observer(const char *line, observer_network_t *net)
     if (field_idx < 8) return false;
     
     // fields[0] = index, fields[1] = SSID, fields[3] = BSSID, fields[4] = channel, fields[6] = RSSI, fields[7] = band
-    net->scan_index = atoi(fields[0]);  // 1-based index for select_networks command
+    net->scan_index = (uint16_t)atoi(fields[0]);  // 1-based index for select_networks command
     
     strncpy(net->ssid, fields[1], sizeof(net->ssid) - 1);
     net->ssid[sizeof(net->ssid) - 1] = '\0';
     
-    strncpy(net->bssid, fields[3], sizeof(net->bssid) - 1);
-    net->bssid[sizeof(net->bssid) - 1] = '\0';
+    // The BSSID is the store key, a line without one is useless
+    if (!mac48_parse(fields[3], &net->bssid)) return false;
     
-    net->channel = atoi(fields[4]);
-    net->rssi = atoi(fields[6]);
+    net->channel = (uint8_t)atoi(fields[4]);
+    net->rssi = (int8_t)atoi(fields[6]);
     
     strncpy(net->band, fields[7], sizeof(net->band) - 1);
     net->band[sizeof(net->band) - 1] = '\0';
     
-    net->client_count = 0;  // No clients initially
-    memset(net->clients, 0, sizeof(net->clients));
-    
     return true;
 }
 
+_Static_assert(sizeof(((observer_network_t *)0)->ssid) == sizeof(((wire_scan_network_t *)0)->ssid),
+               "record SSIDs are copied whole");
+
+static void scan_observer_from_record(const wire_scan_network_t *rec, observer_network_t *net)
+{
+    net->scan_index = rec->index;
+    memcpy(net->ssid, rec->ssid, sizeof(net->ssid));
+    net->bssid = rec->bssid;
+    net->channel = rec->channel;
+    net->rssi = rec->rssi;
+    const char *band = wire_band_text(rec->band);
+    memcpy(net->band, band, strlen(band) + 1);
+}
+
 static void observer_start_task(void *arg)
 {
     tab_context_t *ctx = (tab_context_t *)arg;
@@ -9810,94 +10580,86 @@ static void observer_start_task(void *arg)
     ESP_LOGI(TAG, "[%s] Observer start task - scanning networks first", uart_name);
     
     // Check if PSRAM buffers are allocated
-    if (!observer_rx_buffer || !observer_line_buffer || !ctx->observer_networks) {
+    if (!ctx->observer_store.networks) {
         ESP_LOGE(TAG, "[%s] PSRAM buffers not allocated!", uart_name);
         vTaskDelete(NULL);
         return;
     }
     
     // Update UI
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (ctx->observer_status_label) {
         lv_label_set_text(ctx->observer_status_label, "Scanning networks...");
     }
-    bsp_display_unlock();
+    ui_perf_unlock();
     
     // Clear previous results in context
-    ctx->observer_network_count = 0;
-    memset(ctx->observer_networks, 0, sizeof(observer_network_t) * MAX_OBSERVER_NETWORKS);
+    observer_store_clear(&ctx->observer_store);
     
-    // Flush UART buffer
-    uart_flush(uart_port);
+    // Listen before sending so the response can't be missed
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_records_tab(task_tab, uart_port,
+                                                                TRANSPORT_RX_RECORDS(WIRE_TYPE_SCAN_NETWORK));
     
     // Step 1: Run scan_networks
     char scan_cmd[] = "scan_networks\r\n";
     transport_write_bytes_tab(task_tab, uart_port, scan_cmd, strlen(scan_cmd));
     ESP_LOGI(TAG, "[%s] Sent: scan_networks", uart_name);
     
-    // Wait for scan to complete - use PSRAM buffers
-    char *rx_buffer = observer_rx_buffer;
-    char *line_buffer = observer_line_buffer;
-    int line_pos = 0;
+    // Wait for scan to complete
     bool scan_complete = false;
-    int scanned_count = 0;
+    rx_parse_cost_t parse_cost = {0};
     
     TickType_t start_time = xTaskGetTickCount();
     TickType_t timeout_ticks = pdMS_TO_TICKS(UART_RX_TIMEOUT);
     
     while (!scan_complete && (xTaskGetTickCount() - start_time) < timeout_ticks && ctx->observer_running) {
-        int len = transport_read_bytes_tab(task_tab, uart_port, rx_buffer, UART_BUF_SIZE - 1, pdMS_TO_TICKS(100));
-        
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        // Log every line during scan for debugging
-                        ESP_LOGI(TAG, "SCAN LINE: '%s'", line_buffer);
-                        
-                        if (strstr(line_buffer, "Scan results printed") != NULL) {
-                            scan_complete = true;
-                            ESP_LOGI(TAG, "Network scan complete marker found");
-                            break;
-                        }
-                        
-                        // Parse network line from scan
-                        if (line_buffer[0] == '"' && scanned_count < MAX_OBSERVER_NETWORKS) {
-                            observer_network_t net = {0};
-                            if (parse_scan_to_observer(line_buffer, &net)) {
-                                ctx->observer_networks[scanned_count] = net;
-                                scanned_count++;
-                                ESP_LOGI(TAG, "[%s] Parsed network #%d: '%s' BSSID=%s CH%d %s %ddBm", 
-                                         uart_name, net.scan_index, net.ssid, net.bssid, net.channel, net.band, net.rssi);
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < OBSERVER_LINE_BUFFER_SIZE - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+        rx_demux_msg_t msg;
+        if (!rx_demux_next(rx_sub, &msg, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        observer_network_t net = {0};
+        bool parsed = false;
+        int64_t parse_start = esp_timer_get_time();
+        if (msg.record) {
+            const wire_record_t *rec = (const wire_record_t *)msg.record;
+            if (rec->type == WIRE_TYPE_SCAN_NETWORK) {
+                scan_observer_from_record(&rec->u.scan, &net);
+                parsed = true;
             }
+        } else {
+            char *line_buffer = msg.line.text;
+            if (strstr(line_buffer, "Scan results printed") != NULL) {
+                scan_complete = true;
+                ESP_LOGI(TAG, "Network scan complete marker found");
+                break;
+            }
+            // Parse network line from scan
+            if (line_buffer[0] != '"') {
+                continue;
+            }
+            parsed = parse_scan_to_observer(line_buffer, &net);
+        }
+        rx_parse_cost_add(&parse_cost, &msg, parse_start);
+        
+        if (parsed && observer_store_put_network(&ctx->observer_store, &net) >= 0) {
+            char bssid[MAC48_STR_SIZE];
+            mac48_format(&net.bssid, bssid);
+            ESP_LOGI(TAG, "[%s] Parsed network #%d: '%s' BSSID=%s CH%d %s %ddBm", 
+                     uart_name, net.scan_index, net.ssid, bssid, net.channel, net.band, net.rssi);
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
-    // Save count of scanned networks directly to context
-    ctx->observer_network_count = scanned_count;
-    ESP_LOGI(TAG, "[%s] Scan complete: %d networks", uart_name, ctx->observer_network_count);
+    ESP_LOGI(TAG, "[%s] Scan complete: %d networks", uart_name, ctx->observer_store.network_count);
+    rx_parse_cost_log(uart_name, "Observer scan", &parse_cost);
     
     // Update UI immediately with scanned networks (all with 0 clients)
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (ctx->observer_status_label) {
-        lv_label_set_text_fmt(ctx->observer_status_label, "Found %d networks, starting sniffer...", ctx->observer_network_count);
+        lv_label_set_text_fmt(ctx->observer_status_label, "Found %d networks, starting sniffer...", ctx->observer_store.network_count);
     }
     update_observer_table(ctx);
-    bsp_display_unlock();
+    ui_perf_unlock();
     
     if (!ctx->observer_running) {
         ESP_LOGI(TAG, "[%s] Observer stopped during scan", uart_name);
@@ -9907,14 +10669,13 @@ static void observer_start_task(void *arg)
     
     // Step 2: Start sniffer
     ESP_LOGI(TAG, "[%s] Starting sniffer...", uart_name);
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (ctx->observer_status_label) {
-        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks, waiting for clients...", ctx->observer_network_count);
+        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks, waiting for clients...", ctx->observer_store.network_count);
     }
-    bsp_display_unlock();
+    ui_perf_unlock();
     
     vTaskDelay(pdMS_TO_TICKS(500));  // Short delay
-    uart_flush(uart_port);
     char sniffer_cmd[] = "start_sniffer_noscan\r\n";
     transport_write_bytes_tab(task_tab, uart_port, sniffer_cmd, strlen(sniffer_cmd));
     ESP_LOGI(TAG, "[%s] Sent: start_sniffer_noscan", uart_name);
@@ -9925,11 +10686,11 @@ static void observer_start_task(void *arg)
     if (ctx->observer_running) {
         ESP_LOGI(TAG, "[%s] Starting observer timer (every %d ms)", uart_name, OBSERVER_POLL_INTERVAL_MS);
         
-        bsp_display_lock(0);
+        ui_perf_lock(0);
         if (ctx->observer_status_label) {
             lv_label_set_text(ctx->observer_status_label, "Observing... (updates every 20s)");
         }
-        bsp_display_unlock();
+        ui_perf_unlock();
         
         // Create timer per-context (store ctx as timer ID for callback)
         if (ctx->observer_timer == NULL) {
@@ -9980,8 +10741,9 @@ static void observer_start_btn_cb(lv_event_t *e)
     }
     
     // Clear table
+    ctx->observer_row_count = 0;
     if (ctx->observer_table) {
-        lv_obj_clean(ctx->observer_table);
+        ui_comp_vlist_set_count(ctx->observer_table, 0);
     }
     
     // Start observer task for current tab's UART, pass ctx
@@ -10066,6 +10828,7 @@ static void observer_back_btn_event_cb(lv_event_t *e)
 // Show Network Observer page (inside current tab's container)
 static void show_observer_page(void)
 {
+    UI_PAGE_SCOPE("show_observer_page");
     // Get current tab's data and container
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
@@ -10186,7 +10949,7 @@ static void show_observer_page(void)
     lv_obj_set_style_text_color(ctx->observer_status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
     
     // Network table container (scrollable) - store in ctx
-    ctx->observer_table = lv_obj_create(ctx->observer_page);
+    ctx->observer_table = create_observer_table(ctx->observer_page, ctx);
     lv_obj_set_size(ctx->observer_table, lv_pct(100), lv_pct(100));
     lv_obj_set_flex_grow(ctx->observer_table, 1);
     lv_obj_set_style_bg_color(ctx->observer_table, ui_theme_color(UI_COLOR_BG_LAYER), 0);
@@ -10194,13 +10957,10 @@ static void show_observer_page(void)
     lv_obj_set_style_border_width(ctx->observer_table, 1, 0);
     lv_obj_set_style_radius(ctx->observer_table, 12, 0);
     lv_obj_set_style_pad_all(ctx->observer_table, 8, 0);
-    lv_obj_set_flex_flow(ctx->observer_table, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(ctx->observer_table, 6, 0);
-    lv_obj_set_scroll_dir(ctx->observer_table, LV_DIR_VER);
     
     // If we have existing data in context, show it
-    if (ctx->observer_network_count > 0) {
-        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks (cached)", ctx->observer_network_count);
+    if (ctx->observer_store.network_count > 0) {
+        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks (cached)", ctx->observer_store.network_count);
         update_observer_table(ctx);
     }
     
@@ -10208,7 +10968,7 @@ static void show_observer_page(void)
     if (ctx->observer_running) {
         lv_obj_add_state(ctx->observer_start_btn, LV_STATE_DISABLED);
         lv_obj_clear_state(ctx->observer_stop_btn, LV_STATE_DISABLED);
-        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks (monitoring...)", ctx->observer_network_count);
+        lv_label_set_text_fmt(ctx->observer_status_label, "%d networks (monitoring...)", ctx->observer_store.network_count);
     }
     
     // Mark observer page as visible in context
@@ -10366,7 +11126,7 @@ static void esp_modem_scan_task(void *arg)
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize WiFi");
         
-        bsp_display_lock(0);
+        ui_perf_lock(0);
         if (esp_modem_status_label) {
             lv_label_set_text(esp_modem_status_label, "WiFi init failed!");
         }
@@ -10377,7 +11137,7 @@ static void esp_modem_scan_task(void *arg)
             lv_obj_clear_state(esp_modem_scan_btn, LV_STATE_DISABLED);
         }
         esp_modem_scan_in_progress = false;
-        bsp_display_unlock();
+        ui_perf_unlock();
         
         vTaskDelete(NULL);
         return;
@@ -10408,7 +11168,7 @@ static void esp_modem_scan_task(void *arg)
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "WiFi scan failed after %d attempts: %s", max_retries, esp_err_to_name(ret));
         
-        bsp_display_lock(0);
+        ui_perf_lock(0);
         if (esp_modem_status_label) {
             lv_label_set_text_fmt(esp_modem_status_label, "Scan failed: %s", esp_err_to_name(ret));
         }
@@ -10419,7 +11179,7 @@ static void esp_modem_scan_task(void *arg)
             lv_obj_clear_state(esp_modem_scan_btn, LV_STATE_DISABLED);
         }
         esp_modem_scan_in_progress = false;
-        bsp_display_unlock();
+        ui_perf_unlock();
         
         vTaskDelete(NULL);
         return;
@@ -10456,7 +11216,7 @@ static void esp_modem_scan_task(void *arg)
     ESP_LOGI(TAG, "Retrieved %d network records", esp_modem_network_count);
     
     // Update UI
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     if (esp_modem_spinner) {
         lv_obj_add_flag(esp_modem_spinner, LV_OBJ_FLAG_HIDDEN);
@@ -10475,7 +11235,7 @@ static void esp_modem_scan_task(void *arg)
     
     esp_modem_scan_in_progress = false;
     
-    bsp_display_unlock();
+    ui_perf_unlock();
     
     ESP_LOGI(TAG, "ESP Modem scan task finished");
     vTaskDelete(NULL);
@@ -10536,6 +11296,7 @@ static void esp_modem_back_btn_event_cb(lv_event_t *e)
 // Show ESP Modem page
 static void show_esp_modem_page(void)
 {
+    UI_PAGE_SCOPE("show_esp_modem_page");
     // Delete tiles container if present
     if (tiles_container) {
         lv_obj_del(tiles_container);
@@ -11419,7 +12180,7 @@ static void append_global_handshaker_log_ctx(tab_context_t *ctx, const char *mes
     strncat(ctx->global_handshaker_log_buffer, message, sizeof(ctx->global_handshaker_log_buffer) - strlen(ctx->global_handshaker_log_buffer) - 1);
     
     // Update UI
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (ctx->global_handshaker_status_label) {
         lv_label_set_text(ctx->global_handshaker_status_label, ctx->global_handshaker_log_buffer);
         lv_obj_set_style_text_color(ctx->global_handshaker_status_label, text_color, 0);
@@ -11428,7 +12189,7 @@ static void append_global_handshaker_log_ctx(tab_context_t *ctx, const char *mes
     if (ctx->global_handshaker_log_container) {
         lv_obj_scroll_to_y(ctx->global_handshaker_log_container, LV_COORD_MAX, LV_ANIM_ON);
     }
-    bsp_display_unlock();
+    ui_perf_unlock();
 }
 
 // Helper to extract SSID from quotes in a line
@@ -11452,9 +12213,11 @@ static bool extract_ssid_from_quotes(const char *line, char *ssid, size_t ssid_s
 // Global handshaker monitor task - reads UART for handshake capture (per-tab context)
 static void global_handshaker_monitor_task(void *arg)
 {
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     if (!ctx) {
         ESP_LOGE(TAG, "Global Handshaker monitor task: no context");
+        rx_demux_unsubscribe(rx_sub);
         vTaskDelete(NULL);
         return;
     }
@@ -11465,198 +12228,178 @@ static void global_handshaker_monitor_task(void *arg)
     
     ESP_LOGI(TAG, "Global Handshaker monitor task started (tab=%d, uart=%d)", active_tab, uart_port);
     
-    static char rx_buffer[512];
-    static char line_buffer[512];
-    int line_pos = 0;
-    
     while (ctx->global_handshaker_monitoring) {
-        int len = transport_read_bytes_tab(active_tab, uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "Global Handshaker UART: %s", line_buffer);
-                        
-                        // Determine message type and log it
-                        hs_log_type_t log_type = HS_LOG_PROGRESS;
-                        bool should_log = false;
-                        char display_msg[256] = {0};
-                        char ssid[64] = {0};
-                        
-                        // ===== PHASE/ATTACK START =====
-                        if (strstr(line_buffer, "PHASE") != NULL && strstr(line_buffer, "Attack") != NULL) {
-                            // "===== PHASE 2: Attack All Networks ====="
-                            strncpy(display_msg, "Starting attack on all networks...", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Attacking") != NULL && strstr(line_buffer, "networks...") != NULL) {
-                            // "Attacking 16 networks..."
-                            char *num = strstr(line_buffer, "Attacking ");
-                            if (num) {
-                                int count = atoi(num + 10);
-                                snprintf(display_msg, sizeof(display_msg), "Attacking %d networks...", count);
-                            }
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        
-                        // ===== CURRENT TARGET (>>> [N/M] Attacking 'SSID' <<<) =====
-                        else if (strstr(line_buffer, ">>> [") != NULL && strstr(line_buffer, "Attacking") != NULL) {
-                            // Parse: ">>> [1/16] Attacking 'Horizon Wi-Free' (Ch 6, RSSI: -51 dBm) <<<"
-                            int current = 0, total = 0;
-                            char *bracket = strstr(line_buffer, "[");
-                            if (bracket) {
-                                sscanf(bracket, "[%d/%d]", &current, &total);
-                            }
-                            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
-                                if (current > 0 && total > 0) {
-                                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Attacking: %s", current, total, ssid);
-                                } else {
-                                    snprintf(display_msg, sizeof(display_msg), "Attacking: %s", ssid);
-                                }
-                            } else {
-                                snprintf(display_msg, sizeof(display_msg), "[%d/%d] Attacking network...", current, total);
-                            }
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        
-                        // ===== SKIPPING (already captured) =====
-                        else if (strstr(line_buffer, "Skipping") != NULL && strstr(line_buffer, "PCAP already exists") != NULL) {
-                            // "[2/16] Skipping 'VMA84A66C-2.4' - PCAP already exists"
-                            int current = 0, total = 0;
-                            char *bracket = strstr(line_buffer, "[");
-                            if (bracket) {
-                                sscanf(bracket, "[%d/%d]", &current, &total);
-                            }
-                            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
-                                if (strlen(ssid) > 0) {
-                                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already have: %s", current, total, ssid);
-                                } else {
-                                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already have (hidden)", current, total);
-                                }
-                            } else {
-                                snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already captured", current, total);
-                            }
-                            log_type = HS_LOG_ALREADY;
-                            should_log = true;
-                        }
-                        
-                        // ===== SUCCESS INDICATORS (green) =====
-                        else if (strstr(line_buffer, "Handshake captured for") != NULL ||
-                                 (strstr(line_buffer, "Handshake captured") != NULL && strstr(line_buffer, "after burst") != NULL)) {
-                            // "✓ Handshake captured for 'SSID' after burst #N!"
-                            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
-                                snprintf(display_msg, sizeof(display_msg), "CAPTURED: %s", ssid);
-                            } else {
-                                strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "HANDSHAKE IS COMPLETE AND VALID") != NULL) {
-                            strncpy(display_msg, "Handshake validated!", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "PCAP saved:") != NULL) {
-                            // Extract filename
-                            char *path = strstr(line_buffer, "/sdcard/");
-                            if (path) {
-                                char *slash = strrchr(path, '/');
-                                if (slash) {
-                                    snprintf(display_msg, sizeof(display_msg), "Saved: %s", slash + 1);
-                                }
-                            }
-                            if (display_msg[0] == '\0') {
-                                strncpy(display_msg, "PCAP saved to SD", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "handshake saved for SSID:") != NULL) {
-                            char *ssid_start = strstr(line_buffer, "SSID:");
-                            if (ssid_start) {
-                                ssid_start += 5;
-                                while (*ssid_start == ' ') ssid_start++;
-                                int j = 0;
-                                while (ssid_start[j] && ssid_start[j] != ' ' && ssid_start[j] != '(' && j < 63) {
-                                    ssid[j] = ssid_start[j];
-                                    j++;
-                                }
-                                ssid[j] = '\0';
-                                snprintf(display_msg, sizeof(display_msg), "SAVED: %s", ssid);
-                            } else {
-                                strncpy(display_msg, "Handshake saved!", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_SUCCESS;
-                            should_log = true;
-                        }
-                        
-                        // ===== FAILURE INDICATORS (red) =====
-                        else if (strstr(line_buffer, "No handshake for") != NULL) {
-                            // "✗ No handshake for 'SSID' after 3 bursts"
-                            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
-                                snprintf(display_msg, sizeof(display_msg), "No handshake: %s", ssid);
-                            } else {
-                                strncpy(display_msg, "No handshake captured", sizeof(display_msg) - 1);
-                            }
-                            log_type = HS_LOG_ERROR;
-                            should_log = true;
-                        }
-                        
-                        // ===== PHASE/SCAN INFO =====
-                        else if (strstr(line_buffer, "PHASE 1") != NULL || strstr(line_buffer, "Scanning") != NULL) {
-                            strncpy(display_msg, "Scanning for networks...", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        else if (strstr(line_buffer, "Found") != NULL && strstr(line_buffer, "networks") != NULL) {
-                            char *num = strstr(line_buffer, "Found ");
-                            if (num) {
-                                int count = atoi(num + 6);
-                                snprintf(display_msg, sizeof(display_msg), "Found %d networks", count);
-                                log_type = HS_LOG_PROGRESS;
-                                should_log = true;
-                            }
-                        }
-                        
-                        // ===== COOLDOWN (just log for awareness) =====
-                        else if (strstr(line_buffer, "Cooling down") != NULL) {
-                            // Don't spam cooldown messages, just skip
-                            should_log = false;
-                        }
-                        
-                        // ===== ATTACK CYCLE INFO =====
-                        else if (strstr(line_buffer, "Attack Cycle Complete") != NULL ||
-                                 strstr(line_buffer, "Restarting attack cycle") != NULL) {
-                            strncpy(display_msg, "Cycle complete, restarting...", sizeof(display_msg) - 1);
-                            log_type = HS_LOG_PROGRESS;
-                            should_log = true;
-                        }
-                        
-                        // Log the message if it's relevant
-                        if (should_log && display_msg[0] != '\0') {
-                            append_global_handshaker_log_ctx(ctx, display_msg, log_type);
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
+        // Determine message type and log it
+        hs_log_type_t log_type = HS_LOG_PROGRESS;
+        bool should_log = false;
+        char display_msg[256] = {0};
+        char ssid[64] = {0};
+        
+        // ===== PHASE/ATTACK START =====
+        if (strstr(line_buffer, "PHASE") != NULL && strstr(line_buffer, "Attack") != NULL) {
+            // "===== PHASE 2: Attack All Networks ====="
+            strncpy(display_msg, "Starting attack on all networks...", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Attacking") != NULL && strstr(line_buffer, "networks...") != NULL) {
+            // "Attacking 16 networks..."
+            char *num = strstr(line_buffer, "Attacking ");
+            if (num) {
+                int count = atoi(num + 10);
+                snprintf(display_msg, sizeof(display_msg), "Attacking %d networks...", count);
+            }
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        
+        // ===== CURRENT TARGET (>>> [N/M] Attacking 'SSID' <<<) =====
+        else if (strstr(line_buffer, ">>> [") != NULL && strstr(line_buffer, "Attacking") != NULL) {
+            // Parse: ">>> [1/16] Attacking 'Horizon Wi-Free' (Ch 6, RSSI: -51 dBm) <<<"
+            int current = 0, total = 0;
+            char *bracket = strstr(line_buffer, "[");
+            if (bracket) {
+                sscanf(bracket, "[%d/%d]", &current, &total);
+            }
+            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
+                if (current > 0 && total > 0) {
+                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Attacking: %s", current, total, ssid);
+                } else {
+                    snprintf(display_msg, sizeof(display_msg), "Attacking: %s", ssid);
+                }
+            } else {
+                snprintf(display_msg, sizeof(display_msg), "[%d/%d] Attacking network...", current, total);
+            }
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        
+        // ===== SKIPPING (already captured) =====
+        else if (strstr(line_buffer, "Skipping") != NULL && strstr(line_buffer, "PCAP already exists") != NULL) {
+            // "[2/16] Skipping 'VMA84A66C-2.4' - PCAP already exists"
+            int current = 0, total = 0;
+            char *bracket = strstr(line_buffer, "[");
+            if (bracket) {
+                sscanf(bracket, "[%d/%d]", &current, &total);
+            }
+            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
+                if (strlen(ssid) > 0) {
+                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already have: %s", current, total, ssid);
+                } else {
+                    snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already have (hidden)", current, total);
+                }
+            } else {
+                snprintf(display_msg, sizeof(display_msg), "[%d/%d] Already captured", current, total);
+            }
+            log_type = HS_LOG_ALREADY;
+            should_log = true;
+        }
+        
+        // ===== SUCCESS INDICATORS (green) =====
+        else if (strstr(line_buffer, "Handshake captured for") != NULL ||
+                 (strstr(line_buffer, "Handshake captured") != NULL && strstr(line_buffer, "after burst") != NULL)) {
+            // "✓ Handshake captured for 'SSID' after burst #N!"
+            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
+                snprintf(display_msg, sizeof(display_msg), "CAPTURED: %s", ssid);
+            } else {
+                strncpy(display_msg, "Handshake captured!", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "HANDSHAKE IS COMPLETE AND VALID") != NULL) {
+            strncpy(display_msg, "Handshake validated!", sizeof(display_msg) - 1);
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "PCAP saved:") != NULL) {
+            // Extract filename
+            char *path = strstr(line_buffer, "/sdcard/");
+            if (path) {
+                char *slash = strrchr(path, '/');
+                if (slash) {
+                    snprintf(display_msg, sizeof(display_msg), "Saved: %s", slash + 1);
+                }
+            }
+            if (display_msg[0] == '\0') {
+                strncpy(display_msg, "PCAP saved to SD", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "handshake saved for SSID:") != NULL) {
+            char *ssid_start = strstr(line_buffer, "SSID:");
+            if (ssid_start) {
+                ssid_start += 5;
+                while (*ssid_start == ' ') ssid_start++;
+                int j = 0;
+                while (ssid_start[j] && ssid_start[j] != ' ' && ssid_start[j] != '(' && j < 63) {
+                    ssid[j] = ssid_start[j];
+                    j++;
                 }
+                ssid[j] = '\0';
+                snprintf(display_msg, sizeof(display_msg), "SAVED: %s", ssid);
+            } else {
+                strncpy(display_msg, "Handshake saved!", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_SUCCESS;
+            should_log = true;
+        }
+        
+        // ===== FAILURE INDICATORS (red) =====
+        else if (strstr(line_buffer, "No handshake for") != NULL) {
+            // "✗ No handshake for 'SSID' after 3 bursts"
+            if (extract_ssid_from_quotes(line_buffer, ssid, sizeof(ssid))) {
+                snprintf(display_msg, sizeof(display_msg), "No handshake: %s", ssid);
+            } else {
+                strncpy(display_msg, "No handshake captured", sizeof(display_msg) - 1);
+            }
+            log_type = HS_LOG_ERROR;
+            should_log = true;
+        }
+        
+        // ===== PHASE/SCAN INFO =====
+        else if (strstr(line_buffer, "PHASE 1") != NULL || strstr(line_buffer, "Scanning") != NULL) {
+            strncpy(display_msg, "Scanning for networks...", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        else if (strstr(line_buffer, "Found") != NULL && strstr(line_buffer, "networks") != NULL) {
+            char *num = strstr(line_buffer, "Found ");
+            if (num) {
+                int count = atoi(num + 6);
+                snprintf(display_msg, sizeof(display_msg), "Found %d networks", count);
+                log_type = HS_LOG_PROGRESS;
+                should_log = true;
             }
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // ===== COOLDOWN (just log for awareness) =====
+        else if (strstr(line_buffer, "Cooling down") != NULL) {
+            // Don't spam cooldown messages, just skip
+            should_log = false;
+        }
+        
+        // ===== ATTACK CYCLE INFO =====
+        else if (strstr(line_buffer, "Attack Cycle Complete") != NULL ||
+                 strstr(line_buffer, "Restarting attack cycle") != NULL) {
+            strncpy(display_msg, "Cycle complete, restarting...", sizeof(display_msg) - 1);
+            log_type = HS_LOG_PROGRESS;
+            should_log = true;
+        }
+        
+        // Log the message if it's relevant
+        if (should_log && display_msg[0] != '\0') {
+            append_global_handshaker_log_ctx(ctx, display_msg, log_type);
+        }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Global Handshaker monitor task ended");
     ctx->global_handshaker_task = NULL;
@@ -11765,7 +12508,8 @@ static void show_global_handshaker_active_popup(void)
     // Determine which UART to use based on this tab
     tab_id_t active_tab = tab_id_for_ctx(ctx);
     
-    // Send start_handshake command to this tab's UART
+    // Send start_handshake command to this tab's UART, listening first for the monitor task
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);
     if (active_tab == TAB_MBUS) {
         uart2_send_command("start_handshake");
     } else {
@@ -11847,7 +12591,8 @@ static void show_global_handshaker_active_popup(void)
     
     // Start monitoring task with context
     ctx->global_handshaker_monitoring = true;
-    xTaskCreate(global_handshaker_monitor_task, "gh_monitor", 4096, (void*)ctx, 5, &ctx->global_handshaker_task);
+    transport_rx_task_create(global_handshaker_monitor_task, "gh_monitor", 4096, (void*)ctx, rx_sub, 5,
+                             &ctx->global_handshaker_task);
 }
 
 //==================================================================================
@@ -11929,7 +12674,7 @@ static void update_phishing_portal_capture(tab_context_t *ctx, const char *captu
     ESP_LOGI(TAG, "Portal captured: %s", captured_text);
 
     // Update UI
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     if (ctx->phishing_portal_status_label) {
         lv_label_set_text(ctx->phishing_portal_status_label, status_msg);
     }
@@ -11937,7 +12682,7 @@ static void update_phishing_portal_capture(tab_context_t *ctx, const char *captu
         lv_label_set_text(ctx->phishing_portal_data_label, data_msg);
         lv_obj_set_style_text_color(ctx->phishing_portal_data_label, COLOR_MATERIAL_GREEN, 0);
     }
-    bsp_display_unlock();
+    ui_perf_unlock();
 }
 
 static void trim_trailing_whitespace(char *s)
@@ -12029,8 +12774,10 @@ static bool parse_post_data(const char *post_data, char *out, size_t out_size)
 // Phishing portal monitor task - reads UART for form submissions
 static void phishing_portal_monitor_task(void *arg)
 {
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     if (!ctx) {
+        rx_demux_unsubscribe(rx_sub);
         vTaskDelete(NULL);
         return;
     }
@@ -12038,97 +12785,77 @@ static void phishing_portal_monitor_task(void *arg)
     
     tab_id_t portal_tab = tab_id_for_ctx(ctx);
     uart_port_t uart_port = uart_port_for_tab(portal_tab);
-    char rx_buffer[512];
-    char line_buffer[512];
-    int line_pos = 0;
 
     ESP_LOGI(TAG, "Portal monitor using tab=%s, uart=%d", tab_transport_name(portal_tab), uart_port);
     
     while (ctx->phishing_portal_monitoring) {
-        int len = transport_read_bytes_tab(portal_tab, uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            ESP_LOGI(TAG, "Portal monitor RX (%d bytes): %s", len, rx_buffer);
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "Portal monitor line: %s", line_buffer);
-                        
-                        // Check for password/form data capture
-                        // Pattern: "Received POST data: ..." or "Portal password received: ..." or "Password: ..."
-                        char *post_ptr = strstr(line_buffer, "Received POST data:");
-                        if (post_ptr != NULL) {
-                            char *value_start = post_ptr + strlen("Received POST data:");
-                            while (*value_start == ' ') value_start++;
-
-                            char parsed[256];
-                            if (parse_post_data(value_start, parsed, sizeof(parsed))) {
-                                trim_trailing_whitespace(parsed);
-                                update_phishing_portal_capture(ctx, parsed);
-                            } else if (value_start[0] != '\0') {
-                                char fallback[256];
-                                snprintf(fallback, sizeof(fallback), "%s", value_start);
-                                trim_trailing_whitespace(fallback);
-                                update_phishing_portal_capture(ctx, fallback);
-                            }
-                        } else {
-                            char *password_ptr = strstr(line_buffer, "Portal password received:");
-                            int skip_len = 25;  // Length of "Portal password received: "
-                            if (password_ptr == NULL) {
-                                password_ptr = strstr(line_buffer, "Password:");
-                                skip_len = 9;  // Length of "Password: "
-                            }
+        // Check for password/form data capture
+        // Pattern: "Received POST data: ..." or "Portal password received: ..." or "Password: ..."
+        char *post_ptr = strstr(line_buffer, "Received POST data:");
+        if (post_ptr != NULL) {
+            char *value_start = post_ptr + strlen("Received POST data:");
+            while (*value_start == ' ') value_start++;
+
+            char parsed[256];
+            if (parse_post_data(value_start, parsed, sizeof(parsed))) {
+                trim_trailing_whitespace(parsed);
+                update_phishing_portal_capture(ctx, parsed);
+            } else if (value_start[0] != '\0') {
+                char fallback[256];
+                snprintf(fallback, sizeof(fallback), "%s", value_start);
+                trim_trailing_whitespace(fallback);
+                update_phishing_portal_capture(ctx, fallback);
+            }
+        } else {
+            char *password_ptr = strstr(line_buffer, "Portal password received:");
+            int skip_len = 25;  // Length of "Portal password received: "
+            if (password_ptr == NULL) {
+                password_ptr = strstr(line_buffer, "Password:");
+                skip_len = 9;  // Length of "Password: "
+            }
 
-                            if (password_ptr != NULL) {
-                                char *value_start = password_ptr + skip_len;
-                                while (*value_start == ' ') value_start++;
+            if (password_ptr != NULL) {
+                char *value_start = password_ptr + skip_len;
+                while (*value_start == ' ') value_start++;
 
-                                char capture[192];
-                                snprintf(capture, sizeof(capture), "password=%s", value_start);
-                                trim_trailing_whitespace(capture);
-                                update_phishing_portal_capture(ctx, capture);
-                            }
-                        }
-                        
-                        // Check for client connection
-                        if (strstr(line_buffer, "Client connected") != NULL) {
-                            ESP_LOGI(TAG, "Portal: %s", line_buffer);
-                        }
-                        
-                        // Check for portal data saved
-                        if (strstr(line_buffer, "Portal data saved") != NULL) {
-                            ESP_LOGI(TAG, "Portal data saved to file");
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+                char capture[192];
+                snprintf(capture, sizeof(capture), "password=%s", value_start);
+                trim_trailing_whitespace(capture);
+                update_phishing_portal_capture(ctx, capture);
             }
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // Check for client connection
+        if (strstr(line_buffer, "Client connected") != NULL) {
+            ESP_LOGI(TAG, "Portal: %s", line_buffer);
+        }
+        
+        // Check for portal data saved
+        if (strstr(line_buffer, "Portal data saved") != NULL) {
+            ESP_LOGI(TAG, "Portal data saved to file");
+        }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Phishing Portal monitor task ended");
     ctx->phishing_portal_task = NULL;
     vTaskDelete(NULL);
 }
 
-// Show active portal popup
-static void show_phishing_portal_active_popup(tab_context_t *ctx)
+// Show active portal popup; the monitor task takes rx_sub over
+static void show_phishing_portal_active_popup(tab_context_t *ctx, rx_demux_sub_t *rx_sub)
 {
-    if (!ctx) return;
-    if (ctx->phishing_portal_popup != NULL) return;
-    
     lv_obj_t *container = get_current_tab_container();
-    if (!container) return;
+    if (!ctx || ctx->phishing_portal_popup != NULL || !container) {
+        rx_demux_unsubscribe(rx_sub);
+        return;
+    }
     
     // Reset submit count
     ctx->phishing_portal_submit_count = 0;
@@ -12202,7 +12929,8 @@ static void show_phishing_portal_active_popup(tab_context_t *ctx)
     
     // Start monitoring task
     ctx->phishing_portal_monitoring = true;
-    xTaskCreate(phishing_portal_monitor_task, "pp_monitor", 4096, ctx, 5, &ctx->phishing_portal_task);
+    transport_rx_task_create(phishing_portal_monitor_task, "pp_monitor", 4096, ctx, rx_sub, 5,
+                             &ctx->phishing_portal_task);
 }
 
 // Phishing Portal actual start logic
@@ -12229,7 +12957,8 @@ static void do_phishing_portal_start(tab_context_t *ctx)
     // Close setup popup first
     close_phishing_portal_popup_ctx(ctx);
     
-    // Send commands to current tab's UART
+    // Send commands to current tab's UART, listening first for the monitor task
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);
     char cmd[128];
     snprintf(cmd, sizeof(cmd), "select_html %d", html_idx);
     uart_send_command_for_tab(cmd);
@@ -12239,7 +12968,7 @@ static void do_phishing_portal_start(tab_context_t *ctx)
     uart_send_command_for_tab(cmd);
     
     // Show active popup
-    show_phishing_portal_active_popup(ctx);
+    show_phishing_portal_active_popup(ctx, rx_sub);
 }
 
 // Callback when user clicks OK to start portal
@@ -12493,138 +13222,127 @@ static void show_wardrive_gps_overlay(tab_context_t *ctx)
 }
 
 // Update wardrive network table (newest first)
-static void update_wardrive_table(tab_context_t *ctx)
-{
-    if (!ctx || !ctx->wardrive_table) return;
-
-    lv_coord_t scroll_y = lv_obj_get_scroll_y(ctx->wardrive_table);
-    lv_obj_clean(ctx->wardrive_table);
+#define WARDRIVE_ROW_HEIGHT 30
 
-    int display_count = ctx->wardrive_net_count < WARDRIVE_MAX_NETWORKS ? ctx->wardrive_net_count : WARDRIVE_MAX_NETWORKS;
+static void wardrive_row_create_cb(lv_obj_t *row, void *user_data)
+{
+    (void)user_data;
 
-    for (int i = 0; i < display_count; i++) {
-        // Walk backwards from head-1 (newest) through ring buffer
-        int idx = (ctx->wardrive_net_head - 1 - i + WARDRIVE_MAX_NETWORKS) % WARDRIVE_MAX_NETWORKS;
-        wardrive_network_t *net = &ctx->wardrive_networks[idx];
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_radius(row, 6, 0);
+    lv_obj_set_style_pad_all(row, 6, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(row, 6, 0);
 
-        // Row container
-        lv_obj_t *row = lv_obj_create(ctx->wardrive_table);
-        lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
-        lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
-        lv_obj_set_style_border_width(row, 0, 0);
-        lv_obj_set_style_radius(row, 6, 0);
-        lv_obj_set_style_pad_all(row, 6, 0);
-        lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
-        lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-        lv_obj_set_style_pad_column(row, 6, 0);
-        lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+    // SSID
+    lv_obj_t *ssid_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(ssid_lbl, &lv_font_montserrat_12, 0);
+    lv_obj_set_flex_grow(ssid_lbl, 1);
+    lv_label_set_long_mode(ssid_lbl, LV_LABEL_LONG_DOT);
 
-        // SSID
-        lv_obj_t *ssid_lbl = lv_label_create(row);
-        if (net->ssid[0] == '\0') {
-            lv_label_set_text(ssid_lbl, "<hidden>");
-            lv_obj_set_style_text_color(ssid_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-        } else {
-            lv_label_set_text(ssid_lbl, net->ssid);
-            lv_obj_set_style_text_color(ssid_lbl, lv_color_hex(0xFFFFFF), 0);
-        }
-        lv_obj_set_style_text_font(ssid_lbl, &lv_font_montserrat_12, 0);
-        lv_obj_set_flex_grow(ssid_lbl, 1);
-        lv_label_set_long_mode(ssid_lbl, LV_LABEL_LONG_DOT);
-
-        // BSSID
-        lv_obj_t *bssid_lbl = lv_label_create(row);
-        lv_label_set_text(bssid_lbl, net->bssid);
-        lv_obj_set_style_text_font(bssid_lbl, &lv_font_montserrat_10, 0);
-        lv_obj_set_style_text_color(bssid_lbl, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
-        lv_obj_set_width(bssid_lbl, 130);
-
-        // Security (color-coded)
-        lv_obj_t *sec_lbl = lv_label_create(row);
-        lv_label_set_text(sec_lbl, net->security);
-        lv_obj_set_style_text_font(sec_lbl, &lv_font_montserrat_10, 0);
-        if (strstr(net->security, "WPA3") != NULL) {
-            lv_obj_set_style_text_color(sec_lbl, COLOR_MATERIAL_GREEN, 0);
-        } else if (strstr(net->security, "WPA2") != NULL || strstr(net->security, "WPA_") != NULL) {
-            lv_obj_set_style_text_color(sec_lbl, COLOR_MATERIAL_AMBER, 0);
-        } else if (strstr(net->security, "OPEN") != NULL || net->security[0] == '\0') {
-            lv_obj_set_style_text_color(sec_lbl, COLOR_MATERIAL_RED, 0);
-        } else {
-            lv_obj_set_style_text_color(sec_lbl, COLOR_MATERIAL_AMBER, 0);
-        }
-        lv_obj_set_width(sec_lbl, 120);
-        lv_label_set_long_mode(sec_lbl, LV_LABEL_LONG_DOT);
+    // BSSID
+    lv_obj_t *bssid_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(bssid_lbl, &lv_font_montserrat_10, 0);
+    lv_obj_set_style_text_color(bssid_lbl, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+    lv_obj_set_width(bssid_lbl, 130);
 
-        // Coordinates
-        lv_obj_t *coord_lbl = lv_label_create(row);
-        lv_label_set_text_fmt(coord_lbl, "%s, %s", net->lat, net->lon);
-        lv_obj_set_style_text_font(coord_lbl, &lv_font_montserrat_10, 0);
-        lv_obj_set_style_text_color(coord_lbl, COLOR_MATERIAL_TEAL, 0);
-        lv_obj_set_width(coord_lbl, 170);
-    }
+    // Security (color-coded on bind)
+    lv_obj_t *sec_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(sec_lbl, &lv_font_montserrat_10, 0);
+    lv_obj_set_width(sec_lbl, 120);
+    lv_label_set_long_mode(sec_lbl, LV_LABEL_LONG_DOT);
 
-    lv_obj_scroll_to_y(ctx->wardrive_table, scroll_y, LV_ANIM_OFF);
+    // Coordinates
+    lv_obj_t *coord_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(coord_lbl, &lv_font_montserrat_10, 0);
+    lv_obj_set_style_text_color(coord_lbl, COLOR_MATERIAL_TEAL, 0);
+    lv_obj_set_width(coord_lbl, 170);
 }
 
-// Parse a wardrive CSV network line and add to ring buffer
-// Format: BSSID,SSID,[SECURITY],timestamp,channel,rssi,lat,lon,alt,acc,WIFI
-static bool parse_wardrive_network_line(tab_context_t *ctx, const char *line)
+static void wardrive_row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
 {
-    // Must end with ,WIFI
-    if (!strstr(line, ",WIFI")) return false;
-
-    // Quick validation: must have MAC-like pattern at start (XX:XX:XX:XX:XX:XX)
-    if (strlen(line) < 17 || line[2] != ':' || line[5] != ':') return false;
+    tab_context_t *ctx = (tab_context_t *)user_data;
+    if (!ctx) return;
 
-    char buf[512];
-    strncpy(buf, line, sizeof(buf) - 1);
-    buf[sizeof(buf) - 1] = '\0';
+    // Newest first, relative to the count the list was last given
+    uint32_t count = ui_comp_vlist_get_count(ctx->wardrive_table);
+    wardrive_record_t rec;
+    if (index >= count || !wardrive_log_read(&ctx->wardrive_log, count - 1 - index, &rec)) {
+        memset(&rec, 0, sizeof(rec));
+    }
+    const wardrive_record_t *net = &rec;
 
-    // Split by commas - we need fields: 0=BSSID, 1=SSID, 2=SECURITY, 6=lat, 7=lon
-    char *fields[12] = {0};
-    int field_count = 0;
-    char *p = buf;
-    fields[0] = p;
-    field_count = 1;
+    // Show the auth mode without its brackets, "[WPA2_PSK][ESS]" -> "WPA2_PSK"
+    char security[sizeof(rec.auth)];
+    snprintf(security, sizeof(security), "%s", net->auth[0] == '[' ? net->auth + 1 : net->auth);
+    char *bracket = strchr(security, ']');
+    if (bracket) *bracket = '\0';
 
-    while (*p && field_count < 12) {
-        if (*p == ',') {
-            *p = '\0';
-            fields[field_count++] = p + 1;
-        }
-        p++;
+    lv_obj_t *ssid_lbl = lv_obj_get_child(row, 0);
+    if (net->ssid[0] == '\0') {
+        ui_comp_patch_label_text(ssid_lbl, "<hidden>");
+        ui_comp_patch_text_color(ssid_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED));
+    } else {
+        ui_comp_patch_label_text(ssid_lbl, net->ssid);
+        ui_comp_patch_text_color(ssid_lbl, lv_color_hex(0xFFFFFF));
     }
 
-    // Need at least 11 fields (0..10)
-    if (field_count < 11) return false;
+    char bssid[MAC48_STR_SIZE];
+    ui_comp_patch_label_text(lv_obj_get_child(row, 1), mac48_format(&net->bssid, bssid));
 
-    wardrive_network_t *net = &ctx->wardrive_networks[ctx->wardrive_net_head];
-
-    // BSSID (field 0) - max 17 chars + null
-    snprintf(net->bssid, sizeof(net->bssid), "%.17s", fields[0]);
+    lv_obj_t *sec_lbl = lv_obj_get_child(row, 2);
+    ui_comp_patch_label_text(sec_lbl, security);
+    if (strstr(security, "WPA3") != NULL) {
+        ui_comp_patch_text_color(sec_lbl, COLOR_MATERIAL_GREEN);
+    } else if (strstr(security, "WPA2") != NULL || strstr(security, "WPA_") != NULL) {
+        ui_comp_patch_text_color(sec_lbl, COLOR_MATERIAL_AMBER);
+    } else if (strstr(security, "OPEN") != NULL || security[0] == '\0') {
+        ui_comp_patch_text_color(sec_lbl, COLOR_MATERIAL_RED);
+    } else {
+        ui_comp_patch_text_color(sec_lbl, COLOR_MATERIAL_AMBER);
+    }
 
-    // SSID (field 1, may be empty) - max 32 chars + null
-    snprintf(net->ssid, sizeof(net->ssid), "%.32s", fields[1]);
+    ui_comp_patch_label_text_fmt(lv_obj_get_child(row, 3), "%.6f, %.6f", net->lat, net->lon);
+}
 
-    // Security (field 2, strip brackets) - max 27 chars + null
-    char *sec = fields[2];
-    if (sec[0] == '[') sec++;
-    snprintf(net->security, sizeof(net->security), "%.27s", sec);
-    // Remove trailing ']'
-    char *bracket = strchr(net->security, ']');
-    if (bracket) *bracket = '\0';
-
-    // Lat (field 6) - max 13 chars + null
-    snprintf(net->lat, sizeof(net->lat), "%.13s", fields[6]);
+static void update_wardrive_table(tab_context_t *ctx)
+{
+    if (!ctx || !ctx->wardrive_table) return;
 
-    // Lon (field 7) - max 13 chars + null
-    snprintf(net->lon, sizeof(net->lon), "%.13s", fields[7]);
+    ui_comp_update_counters_t before;
+    ui_comp_get_update_counters(&before);
+    ui_comp_vlist_set_count(ctx->wardrive_table, wardrive_log_count(&ctx->wardrive_log));
+    ui_log_update_cost("Wardrive table", &before);
+}
 
-    // Advance ring buffer
-    ctx->wardrive_net_head = (ctx->wardrive_net_head + 1) % WARDRIVE_MAX_NETWORKS;
-    ctx->wardrive_net_count++;
+// Parse a wardrive CSV network line and append it to the session log
+// Format: BSSID,SSID,[SECURITY],timestamp,channel,rssi,lat,lon,alt,acc,WIFI
+// Returns true only for networks not seen before in this session.
+static bool parse_wardrive_network_line(tab_context_t *ctx, const char *line)
+{
+    wardrive_record_t rec;
+    if (!wardrive_log_parse_line(line, &rec)) return false;
+    return wardrive_log_append(&ctx->wardrive_log, &rec);
+}
 
-    return true;
+// Same record from a binary wardrive row, no text in between
+static bool append_wardrive_record(tab_context_t *ctx, const wire_wardrive_t *row)
+{
+    wardrive_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.lat = row->lat_e7 / 1e7;
+    rec.lon = row->lon_e7 / 1e7;
+    rec.altitude = row->altitude_cm / 100.0f;
+    rec.accuracy = row->accuracy_cm / 100.0f;
+    rec.bssid = row->bssid;
+    rec.channel = row->channel;
+    rec.rssi = row->rssi;
+    snprintf(rec.ssid, sizeof(rec.ssid), "%s", row->ssid);
+    snprintf(rec.auth, sizeof(rec.auth), "%s", row->auth);
+    snprintf(rec.first_seen, sizeof(rec.first_seen), "%s", row->first_seen);
+    return wardrive_log_append(&ctx->wardrive_log, &rec);
 }
 
 // Close GPS type popup
@@ -12655,6 +13373,8 @@ static void wardrive_gps_set_m5_cb(lv_event_t *e)
     
     // Send command
     tab_id_t active_tab = tab_id_for_ctx(ctx);
+    uart_port_t uart_port = (active_tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(active_tab, uart_port, NULL);
     if (active_tab == TAB_MBUS) {
         uart2_send_command("gps_set m5");
     } else {
@@ -12662,7 +13382,6 @@ static void wardrive_gps_set_m5_cb(lv_event_t *e)
     }
     
     // Read response - try multiple times
-    uart_port_t uart_port = (active_tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
     char rx_buffer[512];
     char response[256] = "";
     int total_len = 0;
@@ -12670,8 +13389,8 @@ static void wardrive_gps_set_m5_cb(lv_event_t *e)
     // Try reading for up to 1.5 seconds
     for (int attempt = 0; attempt < 15 && strlen(response) == 0; attempt++) {
         vTaskDelay(pdMS_TO_TICKS(100));
-        int len = transport_read_bytes_tab(active_tab, uart_port, rx_buffer + total_len, 
-                                           sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(50));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len,
+                                sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(50));
         if (len > 0) {
             total_len += len;
             rx_buffer[total_len] = '\0';
@@ -12688,6 +13407,7 @@ static void wardrive_gps_set_m5_cb(lv_event_t *e)
             }
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     if (ctx->wardrive_gps_type_response_label) {
         if (strlen(response) > 0) {
@@ -12715,6 +13435,8 @@ static void wardrive_gps_set_atgm_cb(lv_event_t *e)
     
     // Send command
     tab_id_t active_tab = tab_id_for_ctx(ctx);
+    uart_port_t uart_port = (active_tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(active_tab, uart_port, NULL);
     if (active_tab == TAB_MBUS) {
         uart2_send_command("gps_set atgm");
     } else {
@@ -12722,7 +13444,6 @@ static void wardrive_gps_set_atgm_cb(lv_event_t *e)
     }
     
     // Read response - try multiple times
-    uart_port_t uart_port = (active_tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
     char rx_buffer[512];
     char response[256] = "";
     int total_len = 0;
@@ -12730,8 +13451,8 @@ static void wardrive_gps_set_atgm_cb(lv_event_t *e)
     // Try reading for up to 1.5 seconds
     for (int attempt = 0; attempt < 15 && strlen(response) == 0; attempt++) {
         vTaskDelay(pdMS_TO_TICKS(100));
-        int len = transport_read_bytes_tab(active_tab, uart_port, rx_buffer + total_len, 
-                                           sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(50));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len,
+                                sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(50));
         if (len > 0) {
             total_len += len;
             rx_buffer[total_len] = '\0';
@@ -12748,6 +13469,7 @@ static void wardrive_gps_set_atgm_cb(lv_event_t *e)
             }
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     if (ctx->wardrive_gps_type_response_label) {
         if (strlen(response) > 0) {
@@ -12892,10 +13614,14 @@ static void wardrive_stop_cb(lv_event_t *e)
     if (ctx->wardrive_stop_btn) lv_obj_add_state(ctx->wardrive_stop_btn, LV_STATE_DISABLED);
     if (ctx->wardrive_gps_type_btn) lv_obj_clear_state(ctx->wardrive_gps_type_btn, LV_STATE_DISABLED);
 
+    // The monitor task may still be draining; write what has arrived so far
+    wardrive_log_flush(&ctx->wardrive_log, true);
+
     // Update status
-    int display_count = ctx->wardrive_net_count < WARDRIVE_MAX_NETWORKS ? ctx->wardrive_net_count : WARDRIVE_MAX_NETWORKS;
     if (ctx->wardrive_status_label) {
-        lv_label_set_text_fmt(ctx->wardrive_status_label, "Wardrive stopped. Networks found: %d", display_count);
+        lv_label_set_text_fmt(ctx->wardrive_status_label, "Wardrive stopped. Networks found: %lu%s",
+                              (unsigned long)wardrive_log_count(&ctx->wardrive_log),
+                              wardrive_log_persistent(&ctx->wardrive_log) ? " (saved to SD)" : "");
         lv_obj_set_style_text_color(ctx->wardrive_status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
     }
 }
@@ -12903,9 +13629,11 @@ static void wardrive_stop_cb(lv_event_t *e)
 // Wardrive monitor task - reads UART for GPS fix, network CSV lines, log messages
 static void wardrive_monitor_task(void *arg)
 {
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     if (!ctx) {
         ESP_LOGE(TAG, "Wardrive monitor task: no context");
+        rx_demux_unsubscribe(rx_sub);
         vTaskDelete(NULL);
         return;
     }
@@ -12914,86 +13642,146 @@ static void wardrive_monitor_task(void *arg)
     uart_port_t uart_port = (active_tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
 
     ESP_LOGI(TAG, "Wardrive monitor task started (tab=%d, uart=%d)", active_tab, uart_port);
-
-    char rx_buffer[512];
-    char line_buffer[512];
-    int line_pos = 0;
-    bool batch_has_new_networks = false;
+    rx_parse_cost_t parse_cost = {0};
 
     while (ctx->wardrive_monitoring) {
-        int len = transport_read_bytes_tab(active_tab, uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
-
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            batch_has_new_networks = false;
-
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-
-                        // GPS fix obtained -> dismiss overlay, update status
-                        if (!ctx->wardrive_gps_fix && strstr(line_buffer, "GPS fix obtained") != NULL) {
-                            ctx->wardrive_gps_fix = true;
-                            ESP_LOGI(TAG, "Wardrive: GPS fix obtained");
-
-                            bsp_display_lock(0);
-                            close_wardrive_gps_overlay(ctx);
-                            if (ctx->wardrive_status_label) {
-                                lv_label_set_text(ctx->wardrive_status_label, "GPS Fix Acquired - Scanning...");
-                                lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
-                            }
-                            bsp_display_unlock();
-                        }
-
-                        // Logged networks message -> update status
-                        if (strstr(line_buffer, "Logged ") != NULL && strstr(line_buffer, " networks to ") != NULL) {
-                            ESP_LOGI(TAG, "Wardrive: %s", line_buffer);
-                            int display_count = ctx->wardrive_net_count < WARDRIVE_MAX_NETWORKS ? ctx->wardrive_net_count : WARDRIVE_MAX_NETWORKS;
-
-                            bsp_display_lock(0);
-                            if (ctx->wardrive_status_label) {
-                                lv_label_set_text_fmt(ctx->wardrive_status_label, "Scanning... Networks: %d", display_count);
-                                lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
-                            }
-                            bsp_display_unlock();
-                        }
+        bool batch_has_new_networks = false;
+        rx_demux_msg_t msg;
+        TickType_t wait = pdMS_TO_TICKS(100);
+
+        // Drain every complete line already buffered, only the first one may block
+        while (ctx->wardrive_monitoring && rx_demux_next(rx_sub, &msg, wait)) {
+            wait = 0;
+            if (msg.record) {
+                const wire_record_t *rec = (const wire_record_t *)msg.record;
+                int64_t parse_start = esp_timer_get_time();
+                if (rec->type == WIRE_TYPE_WARDRIVE && append_wardrive_record(ctx, &rec->u.wardrive)) {
+                    batch_has_new_networks = true;
+                }
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
+                continue;
+            }
+            char *line_buffer = msg.line.text;
 
-                        // Try to parse as CSV network line
-                        if (parse_wardrive_network_line(ctx, line_buffer)) {
-                            batch_has_new_networks = true;
-                        }
+            // GPS fix obtained -> dismiss overlay, update status
+            if (!ctx->wardrive_gps_fix && strstr(line_buffer, "GPS fix obtained") != NULL) {
+                ctx->wardrive_gps_fix = true;
+                ESP_LOGI(TAG, "Wardrive: GPS fix obtained");
 
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
+                ui_perf_lock(0);
+                close_wardrive_gps_overlay(ctx);
+                if (ctx->wardrive_status_label) {
+                    lv_label_set_text(ctx->wardrive_status_label, "GPS Fix Acquired - Scanning...");
+                    lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
                 }
+                ui_perf_unlock();
             }
 
-            // Update table once per batch if we got new networks
-            if (batch_has_new_networks) {
-                bsp_display_lock(0);
-                update_wardrive_table(ctx);
-                int display_count = ctx->wardrive_net_count < WARDRIVE_MAX_NETWORKS ? ctx->wardrive_net_count : WARDRIVE_MAX_NETWORKS;
+            // Logged networks message -> update status
+            if (strstr(line_buffer, "Logged ") != NULL && strstr(line_buffer, " networks to ") != NULL) {
+                ESP_LOGI(TAG, "Wardrive: %s", line_buffer);
+                uint32_t net_count = wardrive_log_count(&ctx->wardrive_log);
+
+                ui_perf_lock(0);
                 if (ctx->wardrive_status_label) {
-                    lv_label_set_text_fmt(ctx->wardrive_status_label, "Scanning... Networks: %d", display_count);
+                    lv_label_set_text_fmt(ctx->wardrive_status_label, "Scanning... Networks: %lu", (unsigned long)net_count);
                     lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
                 }
-                bsp_display_unlock();
+                ui_perf_unlock();
+            }
+
+            // Try to parse as CSV network line
+            int64_t parse_start = esp_timer_get_time();
+            if (parse_wardrive_network_line(ctx, line_buffer)) {
+                batch_has_new_networks = true;
+            }
+            rx_parse_cost_add(&parse_cost, &msg, parse_start);
+        }
+
+        // Update table once per batch if we got new networks
+        if (batch_has_new_networks) {
+            ui_perf_lock(0);
+            update_wardrive_table(ctx);
+            if (ctx->wardrive_status_label) {
+                lv_label_set_text_fmt(ctx->wardrive_status_label, "Scanning... Networks: %lu",
+                                      (unsigned long)wardrive_log_count(&ctx->wardrive_log));
+                lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
             }
+            ui_perf_unlock();
         }
 
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // Partial blocks reach the card at most WARDRIVE_LOG_FLUSH_MS late
+        wardrive_log_flush(&ctx->wardrive_log, false);
     }
+    rx_demux_unsubscribe(rx_sub);
+    wardrive_log_flush(&ctx->wardrive_log, true);
+    rx_parse_cost_log(tab_transport_name(active_tab), "Wardrive", &parse_cost);
 
     ESP_LOGI(TAG, "Wardrive monitor task ended");
     ctx->wardrive_task = NULL;
     vTaskDelete(NULL);
 }
 
+// Create the directory for session logs and exports on the internal SD card
+static bool wardrive_ensure_log_dir(void)
+{
+    if (!ensure_internal_sd_mounted(true)) {
+        return false;
+    }
+    struct stat st;
+    if (stat(WARDRIVE_LOG_DIR, &st) != 0 && mkdir(WARDRIVE_LOG_DIR, 0755) != 0) {
+        ESP_LOGE(TAG, "Failed to create %s: %s", WARDRIVE_LOG_DIR, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// Build WARDRIVE_LOG_DIR/wd_<date>_<time>[_n].<ext> for a file that does not exist yet
+static bool wardrive_new_file_path(char *path, size_t size, const char *ext)
+{
+    time_t now;
+    struct tm timeinfo;
+    time(&now);
+    localtime_r(&now, &timeinfo);
+
+    // Without a time source every session gets the same stamp, so count up
+    for (int n = 0; n < 100; n++) {
+        char suffix[8] = "";
+        if (n > 0) {
+            snprintf(suffix, sizeof(suffix), "_%d", n);
+        }
+        snprintf(path, size, "%s/wd_%04d%02d%02d_%02d%02d%02d%s.%s",
+                 WARDRIVE_LOG_DIR,
+                 timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                 timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec, suffix, ext);
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Start a new session log; falls back to a PSRAM-only log without an SD card
+static bool wardrive_open_session_log(tab_context_t *ctx)
+{
+    if (!ctx->wardrive_log.lock && !wardrive_log_init(&ctx->wardrive_log)) {
+        return false;
+    }
+
+    char path[64];
+    if (wardrive_ensure_log_dir() && wardrive_new_file_path(path, sizeof(path), "bin")) {
+        if (wardrive_log_open(&ctx->wardrive_log, path)) {
+            ESP_LOGI(TAG, "Wardrive session log: %s", path);
+            return true;
+        }
+    } else {
+        wardrive_log_open(&ctx->wardrive_log, NULL);
+    }
+    ESP_LOGW(TAG, "Wardrive session kept in memory only");
+    return false;
+}
+
 // Callback when user clicks Start
 static void wardrive_start_cb(lv_event_t *e)
 {
@@ -13003,22 +13791,23 @@ static void wardrive_start_cb(lv_event_t *e)
 
     ESP_LOGI(TAG, "Wardrive start - sending start_wardrive command");
 
-    // Send start_wardrive command
+    // Send start_wardrive command, listening first for the monitor task
     tab_id_t active_tab = tab_id_for_ctx(ctx);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_records_tab(active_tab, uart_port_for_tab(active_tab),
+                                                                TRANSPORT_RX_RECORDS(WIRE_TYPE_WARDRIVE));
     if (active_tab == TAB_MBUS) {
         uart2_send_command("start_wardrive");
     } else {
         uart_send_command("start_wardrive");
     }
 
-    // Reset ring buffer
-    ctx->wardrive_net_count = 0;
-    ctx->wardrive_net_head = 0;
+    // New session log
+    bool persistent = wardrive_open_session_log(ctx);
     ctx->wardrive_gps_fix = false;
 
     // Clear table
-    bsp_display_lock(0);
-    if (ctx->wardrive_table) lv_obj_clean(ctx->wardrive_table);
+    ui_perf_lock(0);
+    if (ctx->wardrive_table) ui_comp_vlist_set_count(ctx->wardrive_table, 0);
 
     // Toggle buttons
     if (ctx->wardrive_start_btn) lv_obj_add_state(ctx->wardrive_start_btn, LV_STATE_DISABLED);
@@ -13027,17 +13816,83 @@ static void wardrive_start_cb(lv_event_t *e)
 
     // Update status
     if (ctx->wardrive_status_label) {
-        lv_label_set_text(ctx->wardrive_status_label, "Starting wardrive...");
+        lv_label_set_text(ctx->wardrive_status_label,
+                          persistent ? "Starting wardrive..." : "Starting wardrive (no SD card, not saved)...");
         lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_AMBER, 0);
     }
 
     // Show GPS fix overlay
     show_wardrive_gps_overlay(ctx);
-    bsp_display_unlock();
+    ui_perf_unlock();
 
     // Start monitor task
     ctx->wardrive_monitoring = true;
-    xTaskCreate(wardrive_monitor_task, "wd_monitor", 8192, (void*)ctx, 5, &ctx->wardrive_task);
+    transport_rx_task_create(wardrive_monitor_task, "wd_monitor", 8192, (void*)ctx, rx_sub, 5, &ctx->wardrive_task);
+}
+
+// Export task - streams the session log into a WiGLE CSV next to it
+static void wardrive_export_task(void *arg)
+{
+    tab_context_t *ctx = (tab_context_t *)arg;
+
+    int rows = wardrive_log_export_wigle(&ctx->wardrive_log, ctx->wardrive_export_path);
+
+    ui_perf_lock(0);
+    if (ctx->wardrive_status_label) {
+        if (rows >= 0) {
+            lv_label_set_text_fmt(ctx->wardrive_status_label, "Exported %d networks to %s", rows, ctx->wardrive_export_path);
+            lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_GREEN, 0);
+        } else {
+            lv_label_set_text(ctx->wardrive_status_label, "WiGLE export failed");
+            lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_RED, 0);
+        }
+    }
+    if (ctx->wardrive_export_btn) lv_obj_clear_state(ctx->wardrive_export_btn, LV_STATE_DISABLED);
+    ui_perf_unlock();
+
+    ctx->wardrive_export_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// Callback when user clicks Export
+static void wardrive_export_cb(lv_event_t *e)
+{
+    tab_context_t *ctx = (tab_context_t *)lv_event_get_user_data(e);
+    if (!ctx) ctx = get_current_ctx();
+    if (ctx->wardrive_export_task != NULL) return;  // Already exporting
+
+    if (wardrive_log_count(&ctx->wardrive_log) == 0) {
+        if (ctx->wardrive_status_label) {
+            lv_label_set_text(ctx->wardrive_status_label, "Nothing to export yet");
+            lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_AMBER, 0);
+        }
+        return;
+    }
+
+    // The CSV goes next to the session log, or gets its own name for a memory-only session
+    const char *log_path = ctx->wardrive_log.path;
+    size_t log_len = strlen(log_path);
+    if (wardrive_log_persistent(&ctx->wardrive_log) && log_len > 4) {
+        snprintf(ctx->wardrive_export_path, sizeof(ctx->wardrive_export_path), "%.*s.csv", (int)(log_len - 4), log_path);
+    } else if (!wardrive_ensure_log_dir() ||
+               !wardrive_new_file_path(ctx->wardrive_export_path, sizeof(ctx->wardrive_export_path), "csv")) {
+        if (ctx->wardrive_status_label) {
+            lv_label_set_text(ctx->wardrive_status_label, "Insert an SD card to export");
+            lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_RED, 0);
+        }
+        return;
+    }
+
+    if (ctx->wardrive_export_btn) lv_obj_add_state(ctx->wardrive_export_btn, LV_STATE_DISABLED);
+    if (ctx->wardrive_status_label) {
+        lv_label_set_text(ctx->wardrive_status_label, "Exporting WiGLE CSV...");
+        lv_obj_set_style_text_color(ctx->wardrive_status_label, COLOR_MATERIAL_AMBER, 0);
+    }
+    if (xTaskCreate(wardrive_export_task, "wd_export", 4096, (void*)ctx, 3, &ctx->wardrive_export_task) != pdPASS) {
+        ctx->wardrive_export_task = NULL;
+        if (ctx->wardrive_export_btn) lv_obj_clear_state(ctx->wardrive_export_btn, LV_STATE_DISABLED);
+        ESP_LOGE(TAG, "Failed to start wardrive export task");
+    }
 }
 
 // Wardrive back button - stop if running, return to tiles
@@ -13080,6 +13935,7 @@ static void wardrive_back_cb(lv_event_t *e)
 // Show wardrive full page
 static void show_wardrive_page(void)
 {
+    UI_PAGE_SCOPE("show_wardrive_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     if (!container) return;
@@ -13195,6 +14051,19 @@ static void show_wardrive_page(void)
     lv_obj_set_style_text_font(gps_type_label, &lv_font_montserrat_14, 0);
     lv_obj_center(gps_type_label);
 
+    // Export button - WiGLE CSV from the session log, usable while scanning
+    ctx->wardrive_export_btn = lv_btn_create(btn_cont);
+    lv_obj_set_size(ctx->wardrive_export_btn, 110, 40);
+    lv_obj_set_style_bg_color(ctx->wardrive_export_btn, COLOR_MATERIAL_BLUE, 0);
+    lv_obj_set_style_bg_color(ctx->wardrive_export_btn, ui_theme_color(UI_COLOR_BORDER), LV_STATE_DISABLED);
+    lv_obj_set_style_radius(ctx->wardrive_export_btn, 8, 0);
+    lv_obj_add_event_cb(ctx->wardrive_export_btn, wardrive_export_cb, LV_EVENT_CLICKED, ctx);
+
+    lv_obj_t *export_label = lv_label_create(ctx->wardrive_export_btn);
+    lv_label_set_text(export_label, LV_SYMBOL_SAVE " Export");
+    lv_obj_set_style_text_font(export_label, &lv_font_montserrat_14, 0);
+    lv_obj_center(export_label);
+
     // ---- Status label ----
     ctx->wardrive_status_label = lv_label_create(ctx->wardrive_page);
     lv_label_set_text(ctx->wardrive_status_label, "Press Start to begin wardrive");
@@ -13202,15 +14071,15 @@ static void show_wardrive_page(void)
     lv_obj_set_style_text_color(ctx->wardrive_status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
 
     // ---- Scrollable table container ----
-    ctx->wardrive_table = lv_obj_create(ctx->wardrive_page);
-    lv_obj_set_size(ctx->wardrive_table, lv_pct(100), LV_SIZE_CONTENT);
+    ctx->wardrive_table = ui_comp_create_vlist(ctx->wardrive_page, WARDRIVE_ROW_HEIGHT, 6,
+                                               wardrive_row_create_cb, wardrive_row_bind_cb, ctx);
+    // Height comes from flex grow; a content-sized virtual list would grow with its items
+    lv_obj_set_size(ctx->wardrive_table, lv_pct(100), lv_pct(100));
     lv_obj_set_flex_grow(ctx->wardrive_table, 1);
     lv_obj_set_style_bg_color(ctx->wardrive_table, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
     lv_obj_set_style_border_width(ctx->wardrive_table, 0, 0);
     lv_obj_set_style_radius(ctx->wardrive_table, 8, 0);
     lv_obj_set_style_pad_all(ctx->wardrive_table, 8, 0);
-    lv_obj_set_flex_flow(ctx->wardrive_table, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(ctx->wardrive_table, 6, 0);
 
     ctx->current_visible_page = ctx->wardrive_page;
 }
@@ -13264,6 +14133,7 @@ static void compromised_data_tile_event_cb(lv_event_t *e)
 // Show Compromised Data page with 3 tiles (inside current tab's container)
 static void show_compromised_data_page(void)
 {
+    UI_PAGE_SCOPE("show_compromised_data_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     
@@ -13339,39 +14209,357 @@ static void show_compromised_data_page(void)
 }
 
 //==================================================================================
-// Evil Twin Passwords Page
+// Captured credentials pages (Evil Twin Passwords, Portal Data)
 //==================================================================================
 
-static void show_evil_twin_passwords_page(void)
+// The board prints every record on each "show_pass" request. The Tab5 keeps a
+// portals.txt style mirror per tab and page with a sidecar index (portal_index.c),
+// so the pages open with the cached records at once, rows are read from SD only
+// while visible, and only records the board reports beyond the mirror are added.
+#define CAPTURED_CACHE_DIR          "/sdcard/lab/cache"
+#define CAPTURED_LOCAL_PORTALS      "/sdcard/lab/portals.txt"   // written by our own captive portal
+#define CAPTURED_ROW_HEIGHT         58
+#define CAPTURED_FIRST_LINE_MS      3000    // board reads its SD card before answering
+#define CAPTURED_IDLE_MS            600     // response is complete after this much silence
+
+static tab_context_t *captured_view_owner(const captured_view_t *view)
+{
+    tab_context_t *all[] = { &grove_ctx, &usb_ctx, &mbus_ctx, &internal_ctx };
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        if (view == &all[i]->evil_twin_view || view == &all[i]->portal_data_view) {
+            return all[i];
+        }
+    }
+    return NULL;
+}
+
+static bool captured_view_open(captured_view_t *view, tab_id_t tab)
+{
+    if (portal_index_is_open(&view->index)) {
+        return true;
+    }
+    if (!ensure_internal_sd_mounted(true)) {
+        return false;
+    }
+
+    char path[64];
+    if (tab_is_internal(tab) && !view->evil_twin) {
+        snprintf(path, sizeof(path), "%s", CAPTURED_LOCAL_PORTALS);
+    } else {
+        struct stat st;
+        if (stat("/sdcard/lab", &st) != 0) {
+            mkdir("/sdcard/lab", 0755);
+        }
+        if (stat(CAPTURED_CACHE_DIR, &st) != 0 && mkdir(CAPTURED_CACHE_DIR, 0755) != 0) {
+            ESP_LOGE(TAG, "Failed to create %s: %s", CAPTURED_CACHE_DIR, strerror(errno));
+            return false;
+        }
+        snprintf(path, sizeof(path), CAPTURED_CACHE_DIR "/%s_%s.txt",
+                 tab_transport_name(tab), view->evil_twin ? "evil" : "portal");
+    }
+    return portal_index_open(&view->index, path);
+}
+
+// Number of rows the list shows: search results or every record
+static uint32_t captured_view_row_count(captured_view_t *view)
+{
+    return view->searching ? view->match_count : portal_index_count(&view->index);
+}
+
+static void captured_view_update_status(captured_view_t *view, const char *suffix)
+{
+    if (!view->status_label) return;
+
+    uint32_t total = portal_index_count(&view->index);
+    const char *noun = view->evil_twin ? "password(s)" : "submission(s)";
+    if (view->searching) {
+        lv_label_set_text_fmt(view->status_label, "%lu of %lu %s match%s",
+                              (unsigned long)view->match_count, (unsigned long)total, noun, suffix ? suffix : "");
+    } else {
+        lv_label_set_text_fmt(view->status_label, "Found %lu %s%s%s", (unsigned long)total, noun,
+                              view->evil_twin ? " - tap to connect" : "", suffix ? suffix : "");
+    }
+}
+
+static void captured_row_create_cb(lv_obj_t *row, void *user_data)
+{
+    captured_view_t *view = (captured_view_t *)user_data;
+
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_radius(row, 6, 0);
+    lv_obj_set_style_pad_all(row, 8, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(row, 4, 0);
+
+    lv_obj_t *ssid_lbl = lv_label_create(row);
+    lv_obj_set_width(ssid_lbl, lv_pct(100));
+    lv_obj_set_style_text_font(ssid_lbl, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(ssid_lbl, lv_color_hex(0xFFFFFF), 0);
+    lv_label_set_long_mode(ssid_lbl, LV_LABEL_LONG_DOT);
+
+    lv_obj_t *data_lbl = lv_label_create(row);
+    lv_obj_set_width(data_lbl, lv_pct(100));
+    lv_obj_set_style_text_font(data_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(data_lbl, view->evil_twin ? COLOR_MATERIAL_AMBER : COLOR_MATERIAL_TEAL, 0);
+    lv_label_set_long_mode(data_lbl, LV_LABEL_LONG_DOT);
+
+    if (view->evil_twin) {
+        lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
+        lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(row, evil_twin_row_click_cb, LV_EVENT_CLICKED, view);
+    }
+}
+
+// List row -> record number, newest first relative to the count the list was last given
+static bool captured_view_record_for_row(captured_view_t *view, uint32_t row, uint32_t *record)
+{
+    uint32_t count = ui_comp_vlist_get_count(view->list);
+    if (row >= count) return false;
+    if (view->searching) {
+        if (row >= view->match_count) return false;
+        *record = view->matches[row];
+    } else {
+        *record = count - 1 - row;
+    }
+    return true;
+}
+
+static void captured_row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
+{
+    captured_view_t *view = (captured_view_t *)user_data;
+    static portal_index_record_t rec;  // LVGL task only
+
+    uint32_t record;
+    if (!captured_view_record_for_row(view, index, &record) || !portal_index_read(&view->index, record, &rec)) {
+        memset(&rec, 0, sizeof(rec));
+    }
+
+    ui_comp_patch_label_text_fmt(lv_obj_get_child(row, 0), "SSID: %s", rec.ssid);
+    if (view->evil_twin) {
+        ui_comp_patch_label_text_fmt(lv_obj_get_child(row, 1), "Password: %s", rec.data);
+    } else {
+        // Form fields are stored one per line; keep the row to a single line
+        for (char *p = rec.data; *p; p++) {
+            if (*p == '\n') *p = ' ';
+        }
+        ui_comp_patch_label_text(lv_obj_get_child(row, 1), rec.data);
+    }
+}
+
+static void captured_view_apply_search(captured_view_t *view)
+{
+    const char *query = view->search_ta ? lv_textarea_get_text(view->search_ta) : "";
+    view->searching = query && query[0] != '\0' && view->matches;
+    if (view->searching) {
+        view->match_count = portal_index_find_ssid(&view->index, query, view->matches, CAPTURED_MAX_MATCHES);
+    }
+    ui_comp_vlist_set_count(view->list, captured_view_row_count(view));
+    captured_view_update_status(view, NULL);
+}
+
+static void captured_search_keyboard_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    captured_view_t *view = (captured_view_t *)lv_event_get_user_data(e);
+
+    if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
+        lv_obj_add_flag(view->keyboard, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_state(view->search_ta, LV_STATE_FOCUSED);
+        if (code == LV_EVENT_READY) {
+            captured_view_apply_search(view);
+        }
+    }
+}
+
+static void captured_search_ta_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    captured_view_t *view = (captured_view_t *)lv_event_get_user_data(e);
+
+    if (code == LV_EVENT_FOCUSED) {
+        lv_obj_clear_flag(view->keyboard, LV_OBJ_FLAG_HIDDEN);
+    } else if (code == LV_EVENT_DEFOCUSED) {
+        lv_obj_add_flag(view->keyboard, LV_OBJ_FLAG_HIDDEN);
+    } else if (code == LV_EVENT_VALUE_CHANGED && lv_textarea_get_text(view->search_ta)[0] == '\0' && view->searching) {
+        // Clearing the query brings the full list back without pressing Enter
+        captured_view_apply_search(view);
+    }
+}
+
+// Split `"SSID", "field", "field"...` into the SSID and the fields joined by newlines
+static bool captured_parse_line(const char *line, bool evil_twin, char *ssid, size_t ssid_size, char *data, size_t data_size)
+{
+    int field_count = 0;
+    bool have_ssid = false;
+    ssid[0] = '\0';
+    data[0] = '\0';
+
+    const char *p = line;
+    const char *quote_start;
+    while ((quote_start = strchr(p, '"')) != NULL) {
+        quote_start++;
+        const char *quote_end = strchr(quote_start, '"');
+        if (!quote_end) break;
+        int len = (int)(quote_end - quote_start);
+
+        if (!have_ssid) {
+            snprintf(ssid, ssid_size, "%.*s", len, quote_start);
+            have_ssid = true;
+        } else {
+            size_t used = strlen(data);
+            snprintf(data + used, data_size - used, "%s%.*s", field_count > 0 ? "\n" : "", len, quote_start);
+            field_count++;
+        }
+        p = quote_end + 1;
+    }
+    return ssid[0] != '\0' && (evil_twin || field_count > 0);
+}
+
+static void captured_refresh_task(void *arg)
+{
+    captured_view_t *view = (captured_view_t *)arg;
+    tab_context_t *ctx = captured_view_owner(view);
+    tab_id_t tab = tab_id_for_ctx(ctx);
+    uart_port_t uart_port = (tab == TAB_MBUS) ? UART2_NUM : UART_NUM;
+    const char *cmd = view->evil_twin ? "show_pass evil\r\n" : "show_pass portal\r\n";
+
+    struct {
+        char ssid[64];
+        char data[PORTAL_INDEX_DATA_MAX];
+        portal_index_record_t cached;
+    } *work = heap_caps_malloc(sizeof(*work), MALLOC_CAP_SPIRAM);
+
+    uint32_t added = 0;
+    uint32_t seen = 0;
+    bool ok = work != NULL;
+    // Second pass only when the board's records no longer match the mirror
+    for (int pass = 0; ok && pass < 2; pass++) {
+        uint32_t cached_count = portal_index_count(&view->index);
+        bool mismatch = cached_count > 0 && !portal_index_read(&view->index, cached_count - 1, &work->cached);
+        seen = 0;
+
+        rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(tab, uart_port, NULL);
+        transport_write_bytes_tab(tab, uart_port, cmd, strlen(cmd));
+
+        line_view_t rx_line;
+        TickType_t wait = pdMS_TO_TICKS(CAPTURED_FIRST_LINE_MS);
+        while (!mismatch && rx_demux_next_line(rx_sub, &rx_line, wait)) {
+            wait = pdMS_TO_TICKS(CAPTURED_IDLE_MS);
+            if (rx_line.len < 5 || strstr(rx_line.text, "show_pass") != NULL ||
+                !captured_parse_line(rx_line.text, view->evil_twin, work->ssid, sizeof(work->ssid),
+                                     work->data, sizeof(work->data))) {
+                continue;
+            }
+
+            if (seen + 1 == cached_count) {
+                // The newest cached record must still be at the same position on the board
+                mismatch = strncmp(work->cached.ssid, work->ssid, sizeof(work->cached.ssid) - 1) != 0 ||
+                           strncmp(work->cached.data, work->data, sizeof(work->cached.data) - 1) != 0;
+            } else if (seen >= cached_count && portal_index_append(&view->index, work->ssid, work->data)) {
+                added++;
+            }
+            seen++;
+        }
+        rx_demux_unsubscribe(rx_sub);
+
+        // No records at all usually means no answer; keep what is cached
+        if (seen == 0 || (!mismatch && seen >= cached_count)) {
+            break;
+        }
+        // Board file was cleared or replaced: start the mirror over
+        ESP_LOGW(TAG, "%s cache out of date (%lu cached, %lu on board), reloading",
+                 view->evil_twin ? "Evil Twin" : "Portal", (unsigned long)cached_count, (unsigned long)seen);
+        ok = portal_index_clear(&view->index);
+        added = 0;
+    }
+    heap_caps_free(work);
+    portal_index_flush(&view->index);
+
+    ESP_LOGI(TAG, "%s refresh done: %lu new record(s), %lu total", view->evil_twin ? "Evil Twin" : "Portal",
+             (unsigned long)added, (unsigned long)portal_index_count(&view->index));
+
+    ui_perf_lock(0);
+    if (view->list) {
+        if (view->searching) {
+            captured_view_apply_search(view);
+        } else {
+            ui_comp_vlist_set_count(view->list, portal_index_count(&view->index));
+            captured_view_update_status(view, seen == 0 ? " - board did not answer" : NULL);
+        }
+    }
+    ui_perf_unlock();
+
+    view->refresh_task = NULL;
+    vTaskDelete(NULL);
+}
+
+static void captured_view_refresh(captured_view_t *view, tab_id_t tab)
+{
+    if (view->refresh_task) return;
+
+    if (!portal_index_is_open(&view->index)) {
+        if (view->status_label) lv_label_set_text(view->status_label, "Internal SD card required for captured data");
+        return;
+    }
+    if (tab_is_internal(tab)) {
+        // Records come from our own portal journal, just index what it appended
+        portal_index_sync(&view->index);
+        ui_comp_vlist_set_count(view->list, captured_view_row_count(view));
+        captured_view_update_status(view, NULL);
+        return;
+    }
+
+    captured_view_update_status(view, " - checking board...");
+    if (xTaskCreate(captured_refresh_task, "captured_refresh", 4096, view, 4, &view->refresh_task) != pdPASS) {
+        view->refresh_task = NULL;
+        captured_view_update_status(view, NULL);
+    }
+}
+
+// Build (once) and show a captured credentials page, then check the board for new records
+static void show_captured_view_page(lv_obj_t **page_slot, captured_view_t *view, bool evil_twin)
 {
     tab_context_t *ctx = get_current_ctx();
     if (!ctx) return;
-    
+
     lv_obj_t *container = get_current_tab_container();
     if (!container) return;
-    
+
     hide_all_pages(ctx);
-    
-    // If page already exists, just show it (but we need to refresh data, so delete and recreate)
-    if (ctx->evil_twin_passwords_page) {
-        lv_obj_del(ctx->evil_twin_passwords_page);
-        ctx->evil_twin_passwords_page = NULL;
+
+    view->evil_twin = evil_twin;
+    if (!captured_view_open(view, current_tab)) {
+        ESP_LOGW(TAG, "Captured data cache unavailable (internal SD card missing?)");
     }
-    
+
+    // If page already exists, just show it and pick up new records
+    if (*page_slot) {
+        lv_obj_clear_flag(*page_slot, LV_OBJ_FLAG_HIDDEN);
+        ctx->current_visible_page = *page_slot;
+        captured_view_refresh(view, current_tab);
+        return;
+    }
+
+    if (!view->matches) {
+        view->matches = heap_caps_malloc(CAPTURED_MAX_MATCHES * sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+    }
+
     // Create page
-    ctx->evil_twin_passwords_page = lv_obj_create(container);
-    lv_obj_set_size(ctx->evil_twin_passwords_page, lv_pct(100), lv_pct(100));
-    lv_obj_align(ctx->evil_twin_passwords_page, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_bg_color(ctx->evil_twin_passwords_page, ui_theme_color(UI_COLOR_BG), 0);
-    lv_obj_set_style_border_width(ctx->evil_twin_passwords_page, 0, 0);
-    lv_obj_set_style_pad_all(ctx->evil_twin_passwords_page, 10, 0);
-    lv_obj_set_flex_flow(ctx->evil_twin_passwords_page, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(ctx->evil_twin_passwords_page, 8, 0);
-    
-    ctx->current_visible_page = ctx->evil_twin_passwords_page;
-    
+    lv_obj_t *page = lv_obj_create(container);
+    *page_slot = page;
+    lv_obj_set_size(page, lv_pct(100), lv_pct(100));
+    lv_obj_align(page, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_bg_color(page, ui_theme_color(UI_COLOR_BG), 0);
+    lv_obj_set_style_border_width(page, 0, 0);
+    lv_obj_set_style_pad_all(page, 10, 0);
+    lv_obj_set_flex_flow(page, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(page, 8, 0);
+
+    ctx->current_visible_page = page;
+
     // Header
-    lv_obj_t *header = lv_obj_create(ctx->evil_twin_passwords_page);
+    lv_obj_t *header = lv_obj_create(page);
     lv_obj_set_size(header, lv_pct(100), LV_SIZE_CONTENT);
     lv_obj_set_style_bg_opa(header, LV_OPA_TRANSP, 0);
     lv_obj_set_style_border_width(header, 0, 0);
@@ -13379,164 +14567,94 @@ static void show_evil_twin_passwords_page(void)
     lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(header, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
     lv_obj_set_style_pad_column(header, 12, 0);
-    
+    lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
+
     lv_obj_t *back_btn = lv_btn_create(header);
     lv_obj_set_size(back_btn, 72, 60);
     lv_obj_set_style_bg_color(back_btn, ui_theme_color(UI_COLOR_SURFACE), 0);
     lv_obj_set_style_bg_color(back_btn, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
     lv_obj_set_style_radius(back_btn, 8, 0);
     lv_obj_add_event_cb(back_btn, compromised_data_back_btn_event_cb, LV_EVENT_CLICKED, NULL);
-    
+
     lv_obj_t *back_icon = lv_label_create(back_btn);
     lv_label_set_text(back_icon, LV_SYMBOL_LEFT);
     lv_obj_set_style_text_color(back_icon, lv_color_hex(0xFFFFFF), 0);
     lv_obj_center(back_icon);
-    
+
+    lv_color_t accent = evil_twin ? COLOR_MATERIAL_AMBER : COLOR_MATERIAL_TEAL;
     lv_obj_t *title = lv_label_create(header);
-    lv_label_set_text(title, "Evil Twin Passwords");
+    lv_label_set_text(title, evil_twin ? "Evil Twin Passwords" : "Portal Data");
     lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(title, COLOR_MATERIAL_AMBER, 0);
-    
+    lv_obj_set_style_text_color(title, accent, 0);
+
+    // SSID search (exact match, served from the index)
+    view->search_ta = lv_textarea_create(header);
+    lv_obj_set_height(view->search_ta, 45);
+    lv_obj_set_flex_grow(view->search_ta, 1);
+    lv_textarea_set_placeholder_text(view->search_ta, "Search SSID");
+    lv_textarea_set_one_line(view->search_ta, true);
+    lv_textarea_set_max_length(view->search_ta, 32);
+    lv_obj_set_style_bg_color(view->search_ta, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+    lv_obj_set_style_border_color(view->search_ta, accent, 0);
+    lv_obj_set_style_text_color(view->search_ta, lv_color_hex(0xFFFFFF), 0);
+    lv_obj_add_event_cb(view->search_ta, captured_search_ta_cb, LV_EVENT_ALL, view);
+
     // Status label
-    lv_obj_t *status_label = lv_label_create(ctx->evil_twin_passwords_page);
-    lv_label_set_text(status_label, "Loading...");
-    lv_obj_set_style_text_font(status_label, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-    
-    // Scrollable list container
-    lv_obj_t *list_container = lv_obj_create(ctx->evil_twin_passwords_page);
-    lv_obj_set_size(list_container, lv_pct(100), LV_SIZE_CONTENT);
-    lv_obj_set_flex_grow(list_container, 1);
-    lv_obj_set_style_bg_color(list_container, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
-    lv_obj_set_style_border_width(list_container, 0, 0);
-    lv_obj_set_style_radius(list_container, 8, 0);
-    lv_obj_set_style_pad_all(list_container, 10, 0);
-    lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(list_container, 8, 0);
-    
-    // Flush RX buffer to clear any boot messages from ESP32C5
-    uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush_input(uart_port);
-    
-    // Send UART command and read response
-    uart_send_command_for_tab("show_pass evil");
-    vTaskDelay(pdMS_TO_TICKS(1000));  // Wait for ESP32C5 to process and read from SD
-    
-    static char rx_buffer[2048];
-    int total_len = 0;
-    int retries = 10;
-    int empty_reads = 0;
-    
-    while (retries-- > 0 && empty_reads < 3) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
-        if (len > 0) {
-            total_len += len;
-            empty_reads = 0;  // Reset on successful read
-        } else {
-            empty_reads++;  // Only break after 3 consecutive empty reads
-        }
-    }
-    rx_buffer[total_len] = '\0';
-    
-    ESP_LOGI(TAG, "Evil Twin passwords response (%d bytes): %s", total_len, rx_buffer);
-    
-    // Reset entry storage
-    evil_twin_entry_count = 0;
-    memset(evil_twin_entries, 0, sizeof(evil_twin_entries));
-    
-    // Parse response - format: "SSID", "password"
-    int entry_count = 0;
-    char *line = strtok(rx_buffer, "\n\r");
-    while (line != NULL) {
-        // Skip empty lines and command echo
-        if (strlen(line) < 5 || strstr(line, "show_pass") != NULL) {
-            line = strtok(NULL, "\n\r");
-            continue;
-        }
-        
-        // Parse "SSID", "password" format
-        char ssid[64] = {0};
-        char password[64] = {0};
-        
-        // Find first quoted string (SSID)
-        char *p1 = strchr(line, '"');
-        if (p1) {
-            p1++;
-            char *p2 = strchr(p1, '"');
-            if (p2) {
-                size_t len = p2 - p1;
-                if (len < sizeof(ssid)) {
-                    strncpy(ssid, p1, len);
-                    ssid[len] = '\0';
-                }
-                
-                // Find second quoted string (password)
-                char *p3 = strchr(p2 + 1, '"');
-                if (p3) {
-                    p3++;
-                    char *p4 = strchr(p3, '"');
-                    if (p4) {
-                        len = p4 - p3;
-                        if (len < sizeof(password)) {
-                            strncpy(password, p3, len);
-                            password[len] = '\0';
-                        }
-                    }
-                }
-            }
-        }
-        
-        if (strlen(ssid) > 0 && evil_twin_entry_count < EVIL_TWIN_MAX_ENTRIES) {
-            // Store entry for later use (use snprintf to avoid truncation warnings)
-            snprintf(evil_twin_entries[evil_twin_entry_count].ssid, sizeof(evil_twin_entries[0].ssid), "%s", ssid);
-            snprintf(evil_twin_entries[evil_twin_entry_count].password, sizeof(evil_twin_entries[0].password), "%s", password);
-            
-            // Create clickable entry row
-            lv_obj_t *row = lv_obj_create(list_container);
-            lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
-            lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
-            lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
-            lv_obj_set_style_border_width(row, 0, 0);
-            lv_obj_set_style_radius(row, 6, 0);
-            lv_obj_set_style_pad_all(row, 8, 0);
-            lv_obj_set_flex_flow(row, LV_FLEX_FLOW_COLUMN);
-            lv_obj_set_style_pad_row(row, 4, 0);
-            lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(row, evil_twin_row_click_cb, LV_EVENT_CLICKED, (void*)(intptr_t)evil_twin_entry_count);
-            
-            lv_obj_t *ssid_lbl = lv_label_create(row);
-            lv_label_set_text_fmt(ssid_lbl, "SSID: %s", ssid);
-            lv_obj_set_style_text_font(ssid_lbl, &lv_font_montserrat_16, 0);
-            lv_obj_set_style_text_color(ssid_lbl, lv_color_hex(0xFFFFFF), 0);
-            
-            lv_obj_t *pass_lbl = lv_label_create(row);
-            lv_label_set_text_fmt(pass_lbl, "Password: %s", password);
-            lv_obj_set_style_text_font(pass_lbl, &lv_font_montserrat_14, 0);
-            lv_obj_set_style_text_color(pass_lbl, COLOR_MATERIAL_AMBER, 0);
-            
-            evil_twin_entry_count++;
-            entry_count++;
-        }
-        
-        line = strtok(NULL, "\n\r");
-    }
-    
-    lv_label_set_text_fmt(status_label, "Found %d password(s) - tap to connect", entry_count);
+    view->status_label = lv_label_create(page);
+    lv_obj_set_style_text_font(view->status_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(view->status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+
+    // Virtual list: rows are read from the SD mirror only while visible
+    view->list = ui_comp_create_vlist(page, CAPTURED_ROW_HEIGHT, 8, captured_row_create_cb, captured_row_bind_cb, view);
+    lv_obj_set_width(view->list, lv_pct(100));
+    lv_obj_set_flex_grow(view->list, 1);
+    lv_obj_set_style_bg_color(view->list, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+    lv_obj_set_style_border_width(view->list, 0, 0);
+    lv_obj_set_style_radius(view->list, 8, 0);
+    lv_obj_set_style_pad_all(view->list, 10, 0);
+
+    // Keyboard on the page so it overlays the list (hidden by default)
+    view->keyboard = lv_keyboard_create(page);
+    lv_obj_add_flag(view->keyboard, LV_OBJ_FLAG_FLOATING);
+    lv_obj_set_size(view->keyboard, lv_pct(100), 260);
+    lv_obj_align(view->keyboard, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_keyboard_set_textarea(view->keyboard, view->search_ta);
+    lv_obj_add_event_cb(view->keyboard, captured_search_keyboard_cb, LV_EVENT_ALL, view);
+    lv_obj_add_flag(view->keyboard, LV_OBJ_FLAG_HIDDEN);
+
+    // Cached records show immediately, the board is asked for newer ones in the background
+    ui_comp_vlist_set_count(view->list, captured_view_row_count(view));
+    captured_view_refresh(view, current_tab);
+}
+
+//==================================================================================
+// Evil Twin Passwords Page
+//==================================================================================
+
+static void show_evil_twin_passwords_page(void)
+{
+    UI_PAGE_SCOPE("show_evil_twin_passwords_page");
+    tab_context_t *ctx = get_current_ctx();
+    if (!ctx) return;
+    show_captured_view_page(&ctx->evil_twin_passwords_page, &ctx->evil_twin_view, true);
 }
 
 // Evil Twin row click callback - show connect popup
 static void evil_twin_row_click_cb(lv_event_t *e)
 {
-    int idx = (int)(intptr_t)lv_event_get_user_data(e);
-    
-    if (idx < 0 || idx >= evil_twin_entry_count) {
-        ESP_LOGW(TAG, "Evil Twin: Invalid entry index %d", idx);
+    captured_view_t *view = (captured_view_t *)lv_event_get_user_data(e);
+    int32_t row = ui_comp_vlist_row_index(lv_event_get_current_target(e));
+    static portal_index_record_t rec;
+
+    uint32_t record;
+    if (!view || row < 0 || !captured_view_record_for_row(view, (uint32_t)row, &record) ||
+        !portal_index_read(&view->index, record, &rec)) {
+        ESP_LOGW(TAG, "Evil Twin: Invalid entry row %ld", (long)row);
         return;
     }
-    
-    ESP_LOGI(TAG, "Evil Twin: Row clicked - SSID: %s", evil_twin_entries[idx].ssid);
-    show_evil_twin_connect_popup(evil_twin_entries[idx].ssid, evil_twin_entries[idx].password);
+
+    ESP_LOGI(TAG, "Evil Twin: Row clicked - SSID: %s", rec.ssid);
+    show_evil_twin_connect_popup(rec.ssid, rec.data);
 }
 
 // Show connect confirmation popup
@@ -13721,149 +14839,130 @@ static void rogue_ap_password_focus_cb(lv_event_t *e)
 // Rogue AP monitor task - watches UART for client connections and passwords
 static void rogue_ap_monitor_task(void *arg)
 {
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     if (!ctx) {
         ESP_LOGE(TAG, "Rogue AP monitor task: NULL context!");
+        rx_demux_unsubscribe(rx_sub);
         vTaskDelete(NULL);
         return;
     }
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = uart_port_for_tab(task_tab);
     const char *uart_name = tab_transport_name(task_tab);
     
-    static char rx_buffer[512];
-    static char line_buffer[256];
-    int line_pos = 0;
-    
     int client_count = 0;
     char current_mac[20] = {0};
     
     ESP_LOGI(TAG, "[%s] Rogue AP monitor task started for tab %d", uart_name, task_tab);
     
     while (ctx->rogue_ap_monitoring) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(200));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(200))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        // Parse memory info: "[MEM] start_rogueap: Internal=200/257KB, DMA=185/241KB, PSRAM=7436/8192KB"
+        // Parse client connections: "AP: Client connected - MAC: XX:XX:XX:XX:XX:XX"
+        char *mac_ptr = strstr(line_buffer, "Client connected - MAC:");
+        if (mac_ptr != NULL) {
+            mac_ptr += 24;  // Skip "Client connected - MAC: "
+            while (*mac_ptr == ' ') mac_ptr++;
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        ESP_LOGI(TAG, "[%s] RogueAP: %s", uart_name, line_buffer);
-                        
-                        // Parse memory info: "[MEM] start_rogueap: Internal=200/257KB, DMA=185/241KB, PSRAM=7436/8192KB"
-                        // Parse client connections: "AP: Client connected - MAC: XX:XX:XX:XX:XX:XX"
-                        char *mac_ptr = strstr(line_buffer, "Client connected - MAC:");
-                        if (mac_ptr != NULL) {
-                            mac_ptr += 24;  // Skip "Client connected - MAC: "
-                            while (*mac_ptr == ' ') mac_ptr++;
-                            
-                            char mac[20] = {0};
-                            int j = 0;
-                            while (mac_ptr[j] && mac_ptr[j] != ' ' && mac_ptr[j] != '\n' && j < 17) {
-                                mac[j] = mac_ptr[j];
-                                j++;
-                            }
-                            mac[j] = '\0';
-                            snprintf(current_mac, sizeof(current_mac), "%s", mac);
-                            client_count++;
-                            
-                            bsp_display_lock(0);
-                            if (ctx->rogue_ap_status_label) {
-                                char status[512];
-                                snprintf(status, sizeof(status),
-                                    "AP: Rogue AP Running\n\n"
-                                    "SSID: %s\n"
-                                    "Clients Connected: %d\n"
-                                    "Last MAC: %s\n\n"
-                                    "Waiting for password capture...",
-                                    rogue_ap_ssid, client_count, current_mac);
-                                lv_label_set_text(ctx->rogue_ap_status_label, status);
-                            }
-                            bsp_display_unlock();
-                        }
-                        
-                        // Parse client count: "Portal: Client count = X"
-                        char *count_ptr = strstr(line_buffer, "Portal: Client count =");
-                        if (count_ptr != NULL) {
-                            count_ptr += 22;  // Skip "Portal: Client count = "
-                            int parsed_count = atoi(count_ptr);
-                            if (parsed_count != client_count) {
-                                client_count = parsed_count;
-                                bsp_display_lock(0);
-                                if (ctx->rogue_ap_status_label) {
-                                    char status[512];
-                                    snprintf(status, sizeof(status),
-                                        "AP: Rogue AP Running\n\n"
-                                        "SSID: %s\n"
-                                        "Clients Connected: %d\n"
-                                        "Last MAC: %s\n\n"
-                                        "Waiting for password capture...",
-                                        rogue_ap_ssid, client_count, current_mac);
-                                    lv_label_set_text(ctx->rogue_ap_status_label, status);
-                                }
-                                bsp_display_unlock();
-                            }
-                        }
-                        
-                        // Parse password: "Portal password received: XXXX" or "Password: XXXX"
-                        char *pass_ptr = strstr(line_buffer, "Portal password received:");
-                        int skip_len = 25;  // Length of "Portal password received: "
-                        
-                        if (pass_ptr == NULL) {
-                            // Try alternative pattern "Password: "
-                            pass_ptr = strstr(line_buffer, "Password:");
-                            skip_len = 9;  // Length of "Password: "
-                        }
-                        
-                        if (pass_ptr != NULL) {
-                            pass_ptr += skip_len;
-                            while (*pass_ptr == ' ') pass_ptr++;
-                            
-                            char pass[128] = {0};
-                            int j = 0;
-                            while (pass_ptr[j] && pass_ptr[j] != '\n' && pass_ptr[j] != '\r' && j < 127) {
-                                pass[j] = pass_ptr[j];
-                                j++;
-                            }
-                            // Trim trailing whitespace
-                            while (j > 0 && isspace((unsigned char)pass[j - 1])) {
-                                pass[--j] = '\0';
-                            }
-                            
-                            if (strlen(pass) > 0) {
-                                bsp_display_lock(0);
-                                if (ctx->rogue_ap_status_label) {
-                                    char status[512];
-                                    snprintf(status, sizeof(status),
-                                        "PASSWORD CAPTURED!\n\n"
-                                        "SSID: %s\n"
-                                        "Clients Connected: %d\n"
-                                        "Last MAC: %s\n\n"
-                                        "Password: %s",
-                                        rogue_ap_ssid, client_count, current_mac, pass);
-                                    lv_label_set_text(ctx->rogue_ap_status_label, status);
-                                    lv_obj_set_style_text_color(ctx->rogue_ap_status_label, COLOR_MATERIAL_GREEN, 0);
-                                }
-                                bsp_display_unlock();
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
+            char mac[20] = {0};
+            int j = 0;
+            while (mac_ptr[j] && mac_ptr[j] != ' ' && mac_ptr[j] != '\n' && j < 17) {
+                mac[j] = mac_ptr[j];
+                j++;
+            }
+            mac[j] = '\0';
+            snprintf(current_mac, sizeof(current_mac), "%s", mac);
+            client_count++;
+            
+            ui_perf_lock(0);
+            if (ctx->rogue_ap_status_label) {
+                char status[512];
+                snprintf(status, sizeof(status),
+                    "AP: Rogue AP Running\n\n"
+                    "SSID: %s\n"
+                    "Clients Connected: %d\n"
+                    "Last MAC: %s\n\n"
+                    "Waiting for password capture...",
+                    rogue_ap_ssid, client_count, current_mac);
+                lv_label_set_text(ctx->rogue_ap_status_label, status);
+            }
+            ui_perf_unlock();
+        }
+        
+        // Parse client count: "Portal: Client count = X"
+        char *count_ptr = strstr(line_buffer, "Portal: Client count =");
+        if (count_ptr != NULL) {
+            count_ptr += 22;  // Skip "Portal: Client count = "
+            int parsed_count = atoi(count_ptr);
+            if (parsed_count != client_count) {
+                client_count = parsed_count;
+                ui_perf_lock(0);
+                if (ctx->rogue_ap_status_label) {
+                    char status[512];
+                    snprintf(status, sizeof(status),
+                        "AP: Rogue AP Running\n\n"
+                        "SSID: %s\n"
+                        "Clients Connected: %d\n"
+                        "Last MAC: %s\n\n"
+                        "Waiting for password capture...",
+                        rogue_ap_ssid, client_count, current_mac);
+                    lv_label_set_text(ctx->rogue_ap_status_label, status);
                 }
+                ui_perf_unlock();
             }
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // Parse password: "Portal password received: XXXX" or "Password: XXXX"
+        char *pass_ptr = strstr(line_buffer, "Portal password received:");
+        int skip_len = 25;  // Length of "Portal password received: "
+        
+        if (pass_ptr == NULL) {
+            // Try alternative pattern "Password: "
+            pass_ptr = strstr(line_buffer, "Password:");
+            skip_len = 9;  // Length of "Password: "
+        }
+        
+        if (pass_ptr != NULL) {
+            pass_ptr += skip_len;
+            while (*pass_ptr == ' ') pass_ptr++;
+            
+            char pass[128] = {0};
+            int j = 0;
+            while (pass_ptr[j] && pass_ptr[j] != '\n' && pass_ptr[j] != '\r' && j < 127) {
+                pass[j] = pass_ptr[j];
+                j++;
+            }
+            // Trim trailing whitespace
+            while (j > 0 && isspace((unsigned char)pass[j - 1])) {
+                pass[--j] = '\0';
+            }
+            
+            if (strlen(pass) > 0) {
+                ui_perf_lock(0);
+                if (ctx->rogue_ap_status_label) {
+                    char status[512];
+                    snprintf(status, sizeof(status),
+                        "PASSWORD CAPTURED!\n\n"
+                        "SSID: %s\n"
+                        "Clients Connected: %d\n"
+                        "Last MAC: %s\n\n"
+                        "Password: %s",
+                        rogue_ap_ssid, client_count, current_mac, pass);
+                    lv_label_set_text(ctx->rogue_ap_status_label, status);
+                    lv_obj_set_style_text_color(ctx->rogue_ap_status_label, COLOR_MATERIAL_GREEN, 0);
+                }
+                ui_perf_unlock();
+            }
+        }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Rogue AP monitor task ended");
     rogue_ap_monitor_task_handle = NULL;
@@ -13932,6 +15031,9 @@ static void rogue_ap_start_cb(lv_event_t *e)
         rogue_ap_password[sizeof(rogue_ap_password) - 1] = '\0';
     }
     
+    // The monitor task reads the responses; listen before sending
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);
+    
     // Send select_html command (1-based index)
     char html_cmd[32];
     snprintf(html_cmd, sizeof(html_cmd), "select_html %d", html_idx + 1);
@@ -13955,17 +15057,18 @@ static void rogue_ap_start_cb(lv_event_t *e)
     uart_send_command_for_tab(ap_cmd);
     
     // Show monitoring popup
-    show_rogue_ap_popup(ctx);
+    show_rogue_ap_popup(ctx, rx_sub);
 }
 
-// Show Rogue AP monitoring popup
-static void show_rogue_ap_popup(tab_context_t *ctx)
+// Show Rogue AP monitoring popup; the monitor task takes rx_sub over
+static void show_rogue_ap_popup(tab_context_t *ctx, rx_demux_sub_t *rx_sub)
 {
-    if (!ctx) return;
-    if (ctx->rogue_ap_popup_overlay != NULL) return;  // Already showing in this tab
-    
     lv_obj_t *container = get_current_tab_container();
-    if (!container) return;
+    // Already showing in this tab, or nowhere to show it
+    if (!ctx || ctx->rogue_ap_popup_overlay != NULL || !container) {
+        rx_demux_unsubscribe(rx_sub);
+        return;
+    }
     
     // Create modal overlay
     ctx->rogue_ap_popup_overlay = lv_obj_create(container);
@@ -14022,12 +15125,14 @@ static void show_rogue_ap_popup(tab_context_t *ctx)
     
     // Start monitoring task
     ctx->rogue_ap_monitoring = true;
-    xTaskCreate(rogue_ap_monitor_task, "rogue_ap_mon", 4096, (void*)ctx, 5, &rogue_ap_monitor_task_handle);
+    transport_rx_task_create(rogue_ap_monitor_task, "rogue_ap_mon", 4096, (void*)ctx, rx_sub, 5,
+                             &rogue_ap_monitor_task_handle);
 }
 
 // Show Rogue AP page
 static void show_rogue_ap_page(void)
 {
+    UI_PAGE_SCOPE("show_rogue_ap_page");
     ESP_LOGI(TAG, "Showing Rogue AP page");
     
     tab_context_t *ctx = get_current_ctx();
@@ -14100,10 +15205,10 @@ static void show_rogue_ap_page(void)
     }
     memset(rogue_ap_password, 0, sizeof(rogue_ap_password));
     
-    // Flush and get Evil Twin passwords (load known passwords)
+    // Get Evil Twin passwords (load known passwords)
     evil_twin_entry_count = 0;
     uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush(uart_port);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     uart_send_command_for_tab("show_pass evil");
     vTaskDelay(pdMS_TO_TICKS(1000));
     
@@ -14113,7 +15218,7 @@ static void show_rogue_ap_page(void)
     int empty_reads = 0;
     
     while (retries-- > 0 && empty_reads < 3) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
             empty_reads = 0;
@@ -14121,6 +15226,7 @@ static void show_rogue_ap_page(void)
             empty_reads++;
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     rx_buffer[total_len] = '\0';
     
     ESP_LOGI(TAG, "Rogue AP: Evil Twin passwords response (%d bytes)", total_len);
@@ -14243,50 +15349,33 @@ static void show_rogue_ap_page(void)
     evil_twin_html_count = 0;
     memset(evil_twin_html_files, 0, sizeof(evil_twin_html_files));
     
-    uart_flush(uart_port);
+    rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     uart_send_command_for_tab("list_sd");
     
-    total_len = 0;
-    retries = 10;
-    empty_reads = 0;
     bool header_found = false;
-    static char line_buffer[256];
-    static int line_pos = 0;
+    TickType_t list_start = xTaskGetTickCount();
     
-    while (retries-- > 0 && evil_twin_html_count < 20) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+    while ((xTaskGetTickCount() - list_start) < pdMS_TO_TICKS(1000) && evil_twin_html_count < 20) {
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        if (strstr(line_buffer, "HTML files found") != NULL) {
-                            header_found = true;
-                        } else if (header_found && line_pos > 2) {
-                            int file_num;
-                            char filename[64];
-                            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
-                                snprintf(evil_twin_html_files[evil_twin_html_count], 
-                                         sizeof(evil_twin_html_files[0]), "%s", filename);
-                                ESP_LOGI(TAG, "Found HTML file %d: %s", file_num, filename);
-                                evil_twin_html_count++;
-                            }
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+        if (strstr(line_buffer, "HTML files found") != NULL) {
+            header_found = true;
+        } else if (header_found && (int)rx_line.len > 2) {
+            int file_num;
+            char filename[64];
+            if (sscanf(line_buffer, "%d %63s", &file_num, filename) == 2) {
+                snprintf(evil_twin_html_files[evil_twin_html_count], 
+                         sizeof(evil_twin_html_files[0]), "%s", filename);
+                ESP_LOGI(TAG, "Found HTML file %d: %s", file_num, filename);
+                evil_twin_html_count++;
             }
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Rogue AP: Fetched %d HTML files", evil_twin_html_count);
     
@@ -14357,8 +15446,8 @@ static void karma2_fetch_probes(void)
     // Determine which UART to use based on current tab
     uart_port_t uart_port = get_current_uart();
     
-    // Flush UART buffer
-    uart_flush(uart_port);
+    // Listen before sending so the response can't be missed
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     
     // Send list_probes command to current tab's UART
     uart_send_command_for_tab("list_probes");
@@ -14371,12 +15460,13 @@ static void karma2_fetch_probes(void)
     vTaskDelay(pdMS_TO_TICKS(300));
     
     while (retries-- > 0) {
-        int len = transport_read_bytes(uart_port, (uint8_t*)rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, (uint8_t*)rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
         }
         if (len <= 0 && total_len > 0) break;
     }
+    rx_demux_unsubscribe(rx_sub);
     rx_buffer[total_len] = '\0';
     
     ESP_LOGI(TAG, "list_probes response (%d bytes): %s", total_len, rx_buffer);
@@ -14767,23 +15857,50 @@ static void karma2_html_select_cb(lv_event_t *e)
     }
 }
 
-// Save portal data to file
-static void save_portal_data(const char *ssid, const char *form_data)
+// Runs on the journal task once submissions are synced to portals.txt
+static void portal_journal_commit_cb(const portal_journal_entry_t *last, uint32_t count, void *user_data)
+{
+    (void)user_data;
+    ESP_LOGI(TAG, "Portal data saved (%u new)", (unsigned)count);
+
+    // Index the new records now, off the UI task, so an open Portal Data page shows them
+    captured_view_t *view = &internal_ctx.portal_data_view;
+    bool indexed = portal_index_is_open(&view->index) && portal_index_sync(&view->index) > 0;
+
+    ui_perf_lock(0);
+    if (indexed && view->list && !view->refresh_task) {
+        if (!view->searching) {
+            ui_comp_vlist_set_count(view->list, captured_view_row_count(view));
+        }
+        captured_view_update_status(view, NULL);
+    }
+    // Increment new data counter and update portal icon
+    portal_new_data_count += (int)count;
+    update_portal_icon();
+
+    // Update UI if attack popup is visible
+    if (karma2_attack_status_label) {
+        lv_label_set_text_fmt(karma2_attack_status_label, "%s\n\nData saved to portals.txt", last->summary);
+        lv_obj_set_style_text_color(karma2_attack_status_label, COLOR_MATERIAL_GREEN, 0);
+    }
+    ui_perf_unlock();
+}
+
+// Queue portal data for portals.txt; called from the httpd task only
+static void save_portal_data(const char *ssid, const char *form_data, const char *password)
 {
     if (!ssid || !form_data) return;
-    
-    FILE *f = fopen("/sdcard/lab/portals.txt", "a");
-    if (f) {
-        fprintf(f, "SSID: %s\nData: %s\n---\n", ssid, form_data);
-        fclose(f);
-        ESP_LOGI(TAG, "Portal data saved for SSID: %s", ssid);
-        
-        // Increment new data counter and update portal icon
-        portal_new_data_count++;
-        update_portal_icon();
-    } else {
-        ESP_LOGW(TAG, "Cannot open portals.txt for writing");
+
+    // A full queue means the card is stalled; wait briefly rather than lose a submission
+    portal_journal_entry_t *entry = portal_journal_begin(&portal_journal, pdMS_TO_TICKS(200));
+    if (!entry) {
+        ESP_LOGW(TAG, "Portal journal unavailable, submission for %s not saved", ssid);
+        return;
     }
+
+    portal_journal_set_record(entry, ssid, form_data);
+    snprintf(entry->summary, sizeof(entry->summary), "Portal: %.32s\n\nPassword received: %s", ssid, password ? password : "");
+    portal_journal_publish(&portal_journal);
 }
 
 // ============================================================================
@@ -14850,18 +15967,8 @@ static esp_err_t portal_login_handler(httpd_req_t *req)
         
         ESP_LOGI(TAG, "Password: %s", decoded);
         
-        // Save to file
-        save_portal_data(portal_ssid, buf);
-        
-        // Update UI if attack popup is visible
-        if (karma2_attack_status_label) {
-            bsp_display_lock(0);
-            lv_label_set_text_fmt(karma2_attack_status_label, 
-                "Portal: %s\n\nPassword received: %s\n\nData saved to portals.txt", 
-                portal_ssid, decoded);
-            lv_obj_set_style_text_color(karma2_attack_status_label, COLOR_MATERIAL_GREEN, 0);
-            bsp_display_unlock();
-        }
+        // Queue for portals.txt; the journal task updates the UI once it is written
+        save_portal_data(portal_ssid, buf, decoded);
     }
     
     // Response
@@ -14893,8 +16000,14 @@ static esp_err_t portal_get_handler(httpd_req_t *req)
 {
     size_t query_len = httpd_req_get_url_query_len(req);
     if (query_len > 0) {
+        // Nothing past a journal entry would be saved anyway; a longer query is read truncated
+        if (query_len > PORTAL_JOURNAL_ENTRY_MAX) {
+            ESP_LOGW(TAG, "Portal GET query of %u bytes truncated", (unsigned)query_len);
+            query_len = PORTAL_JOURNAL_ENTRY_MAX;
+        }
         char *query = malloc(query_len + 1);
-        if (query && httpd_req_get_url_query_str(req, query, query_len + 1) == ESP_OK) {
+        esp_err_t query_err = query ? httpd_req_get_url_query_str(req, query, query_len + 1) : ESP_ERR_NO_MEM;
+        if (query_err == ESP_OK || query_err == ESP_ERR_HTTPD_RESULT_TRUNC) {
             ESP_LOGI(TAG, "Portal GET query: %s", query);
             
             char password[64];
@@ -14916,20 +16029,10 @@ static esp_err_t portal_get_handler(httpd_req_t *req)
                 decoded[decoded_len] = '\0';
                 
                 ESP_LOGI(TAG, "Password: %s", decoded);
-                save_portal_data(portal_ssid, query);
-                
-                // Update UI
-                if (karma2_attack_status_label) {
-                    bsp_display_lock(0);
-                    lv_label_set_text_fmt(karma2_attack_status_label, 
-                        "Portal: %s\n\nPassword received: %s\n\nData saved to portals.txt", 
-                        portal_ssid, decoded);
-                    lv_obj_set_style_text_color(karma2_attack_status_label, COLOR_MATERIAL_GREEN, 0);
-                    bsp_display_unlock();
-                }
+                save_portal_data(portal_ssid, query, decoded);
             }
-            free(query);
         }
+        free(query);
     }
     
     // Response
@@ -15249,6 +16352,11 @@ static esp_err_t start_captive_portal(const char *ssid)
     
     vTaskDelay(pdMS_TO_TICKS(500));
     
+    // Writer task for portals.txt, started once like the HTTP server
+    if (portal_journal.task == NULL) {
+        portal_journal_start(&portal_journal, "/sdcard/lab/portals.txt", portal_journal_commit_cb, NULL, 3);
+    }
+
     // Start HTTP server only if not already running (we never stop it to avoid TLS crash)
     if (portal_server == NULL) {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
@@ -15616,79 +16724,40 @@ static void parse_probes_from_buffer(char *buffer, const char *source_tag)
     }
 }
 
+// Merged as each board answers; parse_probes_from_buffer() skips duplicates
+static void adhoc_probes_result_cb(cmd_fanout_target_t *target, void *user)
+{
+    (void)user;
+    if (target->out[0] == '\0') {
+        ESP_LOGW(TAG, "[%s] No response received", target->name);
+        return;
+    }
+    ESP_LOGI(TAG, "[%s] Received %u bytes in %lu ms", target->name, (unsigned)strlen(target->out),
+             (unsigned long)target->elapsed_ms);
+    ESP_LOGI(TAG, "[%s] Raw response:\n%s", target->name, target->out);
+    
+    // Parse probes using the same format as karma_show_probes_cb
+    parse_probes_from_buffer(target->out, target->name);
+}
+
 static void adhoc_fetch_probes_from_all_uarts(void)
 {
-    tab_id_t uart1_tab = uart1_preferred_tab();
     ESP_LOGI(TAG, "Fetching probes from all devices...");
     
     adhoc_probe_count = 0;
     memset(adhoc_probes, 0, sizeof(adhoc_probes));
     
-    static char rx_buffer[2048];
-    int total_len = 0;
-    int retries = 0;
-    
-    // ========== Fetch from UART1 ==========
-    uart_flush(UART_NUM);
-    transport_write_bytes_tab(uart1_tab, UART_NUM, "list_probes\r\n", 13);
-    ESP_LOGI(TAG, "[%s] Sent: list_probes", tab_transport_name(uart1_tab));
-    
-    vTaskDelay(pdMS_TO_TICKS(500));
-    
-    // Read with retries to get all data
-    total_len = 0;
-    retries = 10;
-    while (retries-- > 0) {
-        int len = transport_read_bytes_tab(uart1_tab, UART_NUM, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
-        if (len > 0) {
-            total_len += len;
-        }
-        if (len <= 0) break;
-    }
-    
-    if (total_len > 0) {
-        rx_buffer[total_len] = '\0';
-        ESP_LOGI(TAG, "[%s] Received %d bytes", tab_transport_name(uart1_tab), total_len);
-        ESP_LOGI(TAG, "[%s] Raw response:\n%s", tab_transport_name(uart1_tab), rx_buffer);
-        
-        // Parse probes using the same format as karma_show_probes_cb
-        parse_probes_from_buffer(rx_buffer, tab_transport_name(uart1_tab));
-    } else {
-        ESP_LOGW(TAG, "[%s] No response received", tab_transport_name(uart1_tab));
-    }
-    
-    // ========== Fetch from MBus if detected ==========
-    if (mbus_detected && uart2_initialized) {
-        ESP_LOGI(TAG, "Fetching probes from MBus");
-        
-        uart_flush(UART2_NUM);
-        transport_write_bytes(UART2_NUM, "list_probes\r\n", 13);
-        ESP_LOGI(TAG, "[MBus] Sent: list_probes");
-        
-        vTaskDelay(pdMS_TO_TICKS(500));
-        
-        // Read with retries to get all data
-        total_len = 0;
-        retries = 10;
-        while (retries-- > 0) {
-            int len = transport_read_bytes(UART2_NUM, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
-            if (len > 0) {
-                total_len += len;
-            }
-            if (len <= 0) break;
-        }
-        
-        if (total_len > 0) {
-            rx_buffer[total_len] = '\0';
-            ESP_LOGI(TAG, "[MBus] Received %d bytes", total_len);
-            ESP_LOGI(TAG, "[MBus] Raw response:\n%s", rx_buffer);
-            
-            // Parse probes using the same format as karma_show_probes_cb
-            parse_probes_from_buffer(rx_buffer, "MBus");
-        } else {
-            ESP_LOGW(TAG, "[MBus] No response received");
-        }
-    }
+    // Every detected board is asked at once; collecting costs the slowest board's response time
+    static char rx_buffers[TRANSPORT_RX_COUNT][2048];
+    char *const bufs[TRANSPORT_RX_COUNT] = { rx_buffers[0], rx_buffers[1], rx_buffers[2] };
+    cmd_fanout_target_t targets[TRANSPORT_RX_COUNT];
+    size_t count = transport_detected_targets(targets, bufs, sizeof(rx_buffers[0]));
+    cmd_request_t req = {
+        .command = "list_probes",
+        .quiet_ms = 200,
+        .timeout_ms = 2500,
+    };
+    cmd_fanout_run(&req, targets, count, adhoc_probes_result_cb, NULL);
     
     ESP_LOGI(TAG, "Total unique probes collected: %d", adhoc_probe_count);
 }
@@ -15945,6 +17014,7 @@ static void adhoc_html_select_cb(lv_event_t *e)
 
 static void show_adhoc_portal_page(void)
 {
+    UI_PAGE_SCOPE("show_adhoc_portal_page");
     ESP_LOGI(TAG, "Showing Ad Hoc Portal page, portal_active=%d", portal_active);
     
     lv_obj_t *container = internal_container;
@@ -16144,6 +17214,19 @@ static void show_adhoc_portal_page(void)
 
 static void show_portal_data_page(void)
 {
+    UI_PAGE_SCOPE("show_portal_data_page");
+    tab_context_t *ctx = get_current_ctx();
+    if (!ctx) return;
+    show_captured_view_page(&ctx->portal_data_page, &ctx->portal_data_view, false);
+}
+
+//==================================================================================
+// Handshakes Page
+//==================================================================================
+
+static void show_handshakes_page(void)
+{
+    UI_PAGE_SCOPE("show_handshakes_page");
     tab_context_t *ctx = get_current_ctx();
     if (!ctx) return;
     
@@ -16153,25 +17236,25 @@ static void show_portal_data_page(void)
     hide_all_pages(ctx);
     
     // Delete and recreate to refresh data
-    if (ctx->portal_data_page) {
-        lv_obj_del(ctx->portal_data_page);
-        ctx->portal_data_page = NULL;
+    if (ctx->handshakes_page) {
+        lv_obj_del(ctx->handshakes_page);
+        ctx->handshakes_page = NULL;
     }
     
     // Create page
-    ctx->portal_data_page = lv_obj_create(container);
-    lv_obj_set_size(ctx->portal_data_page, lv_pct(100), lv_pct(100));
-    lv_obj_align(ctx->portal_data_page, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_bg_color(ctx->portal_data_page, ui_theme_color(UI_COLOR_BG), 0);
-    lv_obj_set_style_border_width(ctx->portal_data_page, 0, 0);
-    lv_obj_set_style_pad_all(ctx->portal_data_page, 10, 0);
-    lv_obj_set_flex_flow(ctx->portal_data_page, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(ctx->portal_data_page, 8, 0);
+    ctx->handshakes_page = lv_obj_create(container);
+    lv_obj_set_size(ctx->handshakes_page, lv_pct(100), lv_pct(100));
+    lv_obj_align(ctx->handshakes_page, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_bg_color(ctx->handshakes_page, ui_theme_color(UI_COLOR_BG), 0);
+    lv_obj_set_style_border_width(ctx->handshakes_page, 0, 0);
+    lv_obj_set_style_pad_all(ctx->handshakes_page, 10, 0);
+    lv_obj_set_flex_flow(ctx->handshakes_page, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(ctx->handshakes_page, 8, 0);
     
-    ctx->current_visible_page = ctx->portal_data_page;
+    ctx->current_visible_page = ctx->handshakes_page;
     
     // Header
-    lv_obj_t *header = lv_obj_create(ctx->portal_data_page);
+    lv_obj_t *header = lv_obj_create(ctx->handshakes_page);
     lv_obj_set_size(header, lv_pct(100), LV_SIZE_CONTENT);
     lv_obj_set_style_bg_opa(header, LV_OPA_TRANSP, 0);
     lv_obj_set_style_border_width(header, 0, 0);
@@ -16193,18 +17276,18 @@ static void show_portal_data_page(void)
     lv_obj_center(back_icon);
     
     lv_obj_t *title = lv_label_create(header);
-    lv_label_set_text(title, "Portal Data");
+    lv_label_set_text(title, "Captured Handshakes");
     lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(title, COLOR_MATERIAL_TEAL, 0);
+    lv_obj_set_style_text_color(title, COLOR_MATERIAL_PURPLE, 0);
     
     // Status label
-    lv_obj_t *status_label = lv_label_create(ctx->portal_data_page);
+    lv_obj_t *status_label = lv_label_create(ctx->handshakes_page);
     lv_label_set_text(status_label, "Loading...");
     lv_obj_set_style_text_font(status_label, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
     
     // Scrollable list container
-    lv_obj_t *list_container = lv_obj_create(ctx->portal_data_page);
+    lv_obj_t *list_container = lv_obj_create(ctx->handshakes_page);
     lv_obj_set_size(list_container, lv_pct(100), LV_SIZE_CONTENT);
     lv_obj_set_flex_grow(list_container, 1);
     lv_obj_set_style_bg_color(list_container, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
@@ -16214,12 +17297,12 @@ static void show_portal_data_page(void)
     lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_style_pad_row(list_container, 8, 0);
     
-    // Flush RX buffer to clear any boot messages from ESP32C5
+    // Subscribe first so only the response (not earlier boot messages) is collected
     uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush_input(uart_port);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_tab(current_tab, uart_port, NULL);
     
     // Send UART command and read response
-    uart_send_command_for_tab("show_pass portal");
+    uart_send_command_for_tab("list_dir /sdcard/lab/handshakes");
     vTaskDelay(pdMS_TO_TICKS(1000));  // Wait for ESP32C5 to process and read from SD
     
     static char rx_buffer[4096];
@@ -16228,7 +17311,7 @@ static void show_portal_data_page(void)
     int empty_reads = 0;
     
     while (retries-- > 0 && empty_reads < 3) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        int len = rx_demux_read(rx_sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
         if (len > 0) {
             total_len += len;
             empty_reads = 0;  // Reset on successful read
@@ -16236,194 +17319,12 @@ static void show_portal_data_page(void)
             empty_reads++;  // Only break after 3 consecutive empty reads
         }
     }
+    rx_demux_unsubscribe(rx_sub);
     rx_buffer[total_len] = '\0';
     
-    ESP_LOGI(TAG, "Portal data response (%d bytes): %s", total_len, rx_buffer);
+    ESP_LOGI(TAG, "Handshakes list response (%d bytes): %s", total_len, rx_buffer);
     
-    // Parse response - format: "SSID", "field1=val1", "field2=val2"...
-    int entry_count = 0;
-    char *line = strtok(rx_buffer, "\n\r");
-    while (line != NULL) {
-        // Skip empty lines and command echo
-        if (strlen(line) < 5 || strstr(line, "show_pass") != NULL) {
-            line = strtok(NULL, "\n\r");
-            continue;
-        }
-        
-        // Parse quoted strings
-        char ssid[64] = {0};
-        char fields[512] = {0};
-        int field_count = 0;
-        
-        char *p = line;
-        char *quote_start = NULL;
-        bool first_field = true;
-        
-        while ((quote_start = strchr(p, '"')) != NULL) {
-            quote_start++;
-            char *quote_end = strchr(quote_start, '"');
-            if (!quote_end) break;
-            
-            size_t len = quote_end - quote_start;
-            char field[128] = {0};
-            if (len < sizeof(field)) {
-                strncpy(field, quote_start, len);
-                field[len] = '\0';
-            }
-            
-            if (first_field) {
-                size_t copy_len = strlen(field);
-                if (copy_len >= sizeof(ssid)) copy_len = sizeof(ssid) - 1;
-                memcpy(ssid, field, copy_len);
-                ssid[copy_len] = '\0';
-                first_field = false;
-            } else {
-                if (field_count > 0) {
-                    strncat(fields, "\n", sizeof(fields) - strlen(fields) - 1);
-                }
-                strncat(fields, field, sizeof(fields) - strlen(fields) - 1);
-                field_count++;
-            }
-            
-            p = quote_end + 1;
-        }
-        
-        if (strlen(ssid) > 0 && field_count > 0) {
-            // Create entry row
-            lv_obj_t *row = lv_obj_create(list_container);
-            lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
-            lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
-            lv_obj_set_style_border_width(row, 0, 0);
-            lv_obj_set_style_radius(row, 6, 0);
-            lv_obj_set_style_pad_all(row, 8, 0);
-            lv_obj_set_flex_flow(row, LV_FLEX_FLOW_COLUMN);
-            lv_obj_set_style_pad_row(row, 4, 0);
-            lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
-            
-            lv_obj_t *ssid_lbl = lv_label_create(row);
-            lv_label_set_text_fmt(ssid_lbl, "SSID: %s", ssid);
-            lv_obj_set_style_text_font(ssid_lbl, &lv_font_montserrat_16, 0);
-            lv_obj_set_style_text_color(ssid_lbl, lv_color_hex(0xFFFFFF), 0);
-            
-            lv_obj_t *fields_lbl = lv_label_create(row);
-            lv_label_set_text(fields_lbl, fields);
-            lv_obj_set_style_text_font(fields_lbl, &lv_font_montserrat_14, 0);
-            lv_obj_set_style_text_color(fields_lbl, COLOR_MATERIAL_TEAL, 0);
-            lv_obj_set_width(fields_lbl, lv_pct(100));
-            lv_label_set_long_mode(fields_lbl, LV_LABEL_LONG_WRAP);
-            
-            entry_count++;
-        }
-        
-        line = strtok(NULL, "\n\r");
-    }
-    
-    lv_label_set_text_fmt(status_label, "Found %d submission(s)", entry_count);
-}
-
-//==================================================================================
-// Handshakes Page
-//==================================================================================
-
-static void show_handshakes_page(void)
-{
-    tab_context_t *ctx = get_current_ctx();
-    if (!ctx) return;
-    
-    lv_obj_t *container = get_current_tab_container();
-    if (!container) return;
-    
-    hide_all_pages(ctx);
-    
-    // Delete and recreate to refresh data
-    if (ctx->handshakes_page) {
-        lv_obj_del(ctx->handshakes_page);
-        ctx->handshakes_page = NULL;
-    }
-    
-    // Create page
-    ctx->handshakes_page = lv_obj_create(container);
-    lv_obj_set_size(ctx->handshakes_page, lv_pct(100), lv_pct(100));
-    lv_obj_align(ctx->handshakes_page, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_bg_color(ctx->handshakes_page, ui_theme_color(UI_COLOR_BG), 0);
-    lv_obj_set_style_border_width(ctx->handshakes_page, 0, 0);
-    lv_obj_set_style_pad_all(ctx->handshakes_page, 10, 0);
-    lv_obj_set_flex_flow(ctx->handshakes_page, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(ctx->handshakes_page, 8, 0);
-    
-    ctx->current_visible_page = ctx->handshakes_page;
-    
-    // Header
-    lv_obj_t *header = lv_obj_create(ctx->handshakes_page);
-    lv_obj_set_size(header, lv_pct(100), LV_SIZE_CONTENT);
-    lv_obj_set_style_bg_opa(header, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(header, 0, 0);
-    lv_obj_set_style_pad_all(header, 0, 0);
-    lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(header, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_pad_column(header, 12, 0);
-    
-    lv_obj_t *back_btn = lv_btn_create(header);
-    lv_obj_set_size(back_btn, 72, 60);
-    lv_obj_set_style_bg_color(back_btn, ui_theme_color(UI_COLOR_SURFACE), 0);
-    lv_obj_set_style_bg_color(back_btn, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
-    lv_obj_set_style_radius(back_btn, 8, 0);
-    lv_obj_add_event_cb(back_btn, compromised_data_back_btn_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *back_icon = lv_label_create(back_btn);
-    lv_label_set_text(back_icon, LV_SYMBOL_LEFT);
-    lv_obj_set_style_text_color(back_icon, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_center(back_icon);
-    
-    lv_obj_t *title = lv_label_create(header);
-    lv_label_set_text(title, "Captured Handshakes");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(title, COLOR_MATERIAL_PURPLE, 0);
-    
-    // Status label
-    lv_obj_t *status_label = lv_label_create(ctx->handshakes_page);
-    lv_label_set_text(status_label, "Loading...");
-    lv_obj_set_style_text_font(status_label, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(status_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-    
-    // Scrollable list container
-    lv_obj_t *list_container = lv_obj_create(ctx->handshakes_page);
-    lv_obj_set_size(list_container, lv_pct(100), LV_SIZE_CONTENT);
-    lv_obj_set_flex_grow(list_container, 1);
-    lv_obj_set_style_bg_color(list_container, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
-    lv_obj_set_style_border_width(list_container, 0, 0);
-    lv_obj_set_style_radius(list_container, 8, 0);
-    lv_obj_set_style_pad_all(list_container, 10, 0);
-    lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(list_container, 8, 0);
-    
-    // Flush RX buffer to clear any boot messages from ESP32C5
-    uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush_input(uart_port);
-    
-    // Send UART command and read response
-    uart_send_command_for_tab("list_dir /sdcard/lab/handshakes");
-    vTaskDelay(pdMS_TO_TICKS(1000));  // Wait for ESP32C5 to process and read from SD
-    
-    static char rx_buffer[4096];
-    int total_len = 0;
-    int retries = 10;
-    int empty_reads = 0;
-    
-    while (retries-- > 0 && empty_reads < 3) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
-        if (len > 0) {
-            total_len += len;
-            empty_reads = 0;  // Reset on successful read
-        } else {
-            empty_reads++;  // Only break after 3 consecutive empty reads
-        }
-    }
-    rx_buffer[total_len] = '\0';
-    
-    ESP_LOGI(TAG, "Handshakes list response (%d bytes): %s", total_len, rx_buffer);
-    
-    // Parse response - look for lines ending with .pcap
+    // Parse response - look for lines ending with .pcap
     int entry_count = 0;
     char *line = strtok(rx_buffer, "\n\r");
     while (line != NULL) {
@@ -16482,67 +17383,84 @@ static void show_handshakes_page(void)
 // Deauth Detector Page
 //==================================================================================
 
-// Update the deauth table UI with current entries
-static void update_deauth_table(void)
+static const char *deauth_row_key_cb(uint32_t index, void *user_data)
 {
-    if (!deauth_table) return;
+    (void)user_data;
+    static char key[12];
+    snprintf(key, sizeof(key), "%08lx", (unsigned long)deauth_entries[index].seq);
+    return key;
+}
+
+static void deauth_row_create_cb(lv_obj_t *row, void *user_data)
+{
+    (void)user_data;
+
+    lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_radius(row, 6, 0);
+    lv_obj_set_style_pad_all(row, 8, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
     
-    // Save scroll position
-    lv_coord_t scroll_y = lv_obj_get_scroll_y(deauth_table);
+    // Channel
+    lv_obj_t *ch_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(ch_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(ch_lbl, COLOR_MATERIAL_AMBER, 0);
+    lv_obj_set_width(ch_lbl, 50);
     
-    lv_obj_clean(deauth_table);
+    // AP Name
+    lv_obj_t *ap_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(ap_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(ap_lbl, lv_color_hex(0xFFFFFF), 0);
+    lv_obj_set_flex_grow(ap_lbl, 1);
+    lv_label_set_long_mode(ap_lbl, LV_LABEL_LONG_DOT);
     
-    for (int i = 0; i < deauth_entry_count; i++) {
-        deauth_entry_t *entry = &deauth_entries[i];
-        
-        lv_obj_t *row = lv_obj_create(deauth_table);
-        lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
-        lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
-        lv_obj_set_style_border_width(row, 0, 0);
-        lv_obj_set_style_radius(row, 6, 0);
-        lv_obj_set_style_pad_all(row, 8, 0);
-        lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
-        lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-        lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
-        
-        // Channel
-        lv_obj_t *ch_lbl = lv_label_create(row);
-        lv_label_set_text_fmt(ch_lbl, "CH%d", entry->channel);
-        lv_obj_set_style_text_font(ch_lbl, &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(ch_lbl, COLOR_MATERIAL_AMBER, 0);
-        lv_obj_set_width(ch_lbl, 50);
-        
-        // AP Name
-        lv_obj_t *ap_lbl = lv_label_create(row);
-        lv_label_set_text(ap_lbl, entry->ap_name);
-        lv_obj_set_style_text_font(ap_lbl, &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(ap_lbl, lv_color_hex(0xFFFFFF), 0);
-        lv_obj_set_flex_grow(ap_lbl, 1);
-        lv_label_set_long_mode(ap_lbl, LV_LABEL_LONG_DOT);
-        
-        // BSSID
-        lv_obj_t *bssid_lbl = lv_label_create(row);
-        lv_label_set_text(bssid_lbl, entry->bssid);
-        lv_obj_set_style_text_font(bssid_lbl, &lv_font_montserrat_12, 0);
-        lv_obj_set_style_text_color(bssid_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-        lv_obj_set_width(bssid_lbl, 140);
-        
-        // RSSI
-        lv_obj_t *rssi_lbl = lv_label_create(row);
-        lv_label_set_text_fmt(rssi_lbl, "%d", entry->rssi);
-        lv_obj_set_style_text_font(rssi_lbl, &lv_font_montserrat_14, 0);
-        if (entry->rssi > -50) {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_GREEN, 0);
-        } else if (entry->rssi > -70) {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_AMBER, 0);
-        } else {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_RED, 0);
-        }
-        lv_obj_set_width(rssi_lbl, 45);
+    // BSSID
+    lv_obj_t *bssid_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(bssid_lbl, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(bssid_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+    lv_obj_set_width(bssid_lbl, 140);
+    
+    // RSSI (color-coded on bind)
+    lv_obj_t *rssi_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(rssi_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_width(rssi_lbl, 45);
+}
+
+static void deauth_row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
+{
+    (void)user_data;
+    deauth_entry_t *entry = &deauth_entries[index];
+    
+    ui_comp_patch_label_text_fmt(lv_obj_get_child(row, 0), "CH%d", entry->channel);
+    ui_comp_patch_label_text(lv_obj_get_child(row, 1), entry->ap_name);
+    char bssid[MAC48_STR_SIZE];
+    ui_comp_patch_label_text(lv_obj_get_child(row, 2), mac48_format(&entry->bssid, bssid));
+    
+    lv_obj_t *rssi_lbl = lv_obj_get_child(row, 3);
+    ui_comp_patch_label_text_fmt(rssi_lbl, "%d", entry->rssi);
+    if (entry->rssi > -50) {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_GREEN);
+    } else if (entry->rssi > -70) {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_AMBER);
+    } else {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_RED);
     }
+}
+
+// Update the deauth table UI with current entries: rows are keyed by detection,
+// so a new event inserts one row and existing rows are left alone
+static void update_deauth_table(void)
+{
+    if (!deauth_table) return;
     
-    // Restore scroll position
-    lv_obj_scroll_to_y(deauth_table, scroll_y, LV_ANIM_OFF);
+    ui_comp_update_counters_t before;
+    ui_comp_get_update_counters(&before);
+    ui_comp_keyed_list_sync(deauth_table, (uint32_t)deauth_entry_count, deauth_row_key_cb,
+                            deauth_row_create_cb, deauth_row_bind_cb, NULL, NULL);
+    ui_log_update_cost("Deauth table", &before);
 }
 
 // Parse deauth line and add to entries
@@ -16573,13 +17491,12 @@ static bool parse_deauth_line(const char *line, deauth_entry_t *entry)
     
     // Parse BSSID - between "(" and ")"
     paren++;
-    const char *paren_end = strchr(paren, ')');
-    if (!paren_end) return false;
+    if (!strchr(paren, ')')) return false;
     
-    size_t bssid_len = paren_end - paren;
-    if (bssid_len >= sizeof(entry->bssid)) bssid_len = sizeof(entry->bssid) - 1;
-    memcpy(entry->bssid, paren, bssid_len);
-    entry->bssid[bssid_len] = '\0';
+    // Keep the detection even if the firmware printed something odd here
+    if (!mac48_parse(paren, &entry->bssid)) {
+        entry->bssid = (mac48_t){0};
+    }
     
     // Parse RSSI
     const char *rssi_ptr = strstr(line, "RSSI:");
@@ -16593,62 +17510,44 @@ static bool parse_deauth_line(const char *line, deauth_entry_t *entry)
 static void deauth_detector_task(void *arg)
 {
     // Get context passed to task
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     const char *uart_name = tab_transport_name(task_tab);
     
     ESP_LOGI(TAG, "[%s] Deauth detector task started for tab %d", uart_name, task_tab);
     
-    static char rx_buffer[512];
-    static char line_buffer[256];
-    int line_pos = 0;
-    
     // Use context's flag
     while (ctx && ctx->deauth_detector_running) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        deauth_entry_t entry;
+        if (parse_deauth_line(line_buffer, &entry)) {
+            ESP_LOGI(TAG, "Deauth detected: CH%d %s (" MAC48_FMT ") RSSI=%d", 
+                     entry.channel, entry.ap_name, MAC48_ARGS(entry.bssid), entry.rssi);
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        deauth_entry_t entry;
-                        if (parse_deauth_line(line_buffer, &entry)) {
-                            ESP_LOGI(TAG, "Deauth detected: CH%d %s (%s) RSSI=%d", 
-                                     entry.channel, entry.ap_name, entry.bssid, entry.rssi);
-                            
-                            // Shift entries down (newest first)
-                            if (deauth_entry_count < DEAUTH_DETECTOR_MAX_ENTRIES) {
-                                deauth_entry_count++;
-                            }
-                            memmove(&deauth_entries[1], &deauth_entries[0], 
-                                    (deauth_entry_count - 1) * sizeof(deauth_entry_t));
-                            deauth_entries[0] = entry;
-                            
-                            // Update UI
-                            bsp_display_lock(0);
-                            update_deauth_table();
-                            bsp_display_unlock();
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+            // Shift entries down (newest first)
+            if (deauth_entry_count < DEAUTH_DETECTOR_MAX_ENTRIES) {
+                deauth_entry_count++;
             }
+            memmove(&deauth_entries[1], &deauth_entries[0], 
+                    (deauth_entry_count - 1) * sizeof(deauth_entry_t));
+            entry.seq = ++deauth_entry_seq;
+            deauth_entries[0] = entry;
+            
+            // Update UI
+            ui_perf_lock(0);
+            update_deauth_table();
+            ui_perf_unlock();
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "Deauth detector task ended");
     deauth_detector_task_handle = NULL;
@@ -16662,17 +17561,19 @@ static void deauth_detector_start_cb(lv_event_t *e)
     if (deauth_detector_running) return;
     
     ESP_LOGI(TAG, "Starting deauth detector");
+    tab_context_t *ctx = get_current_ctx();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);  // before the command, for the task
     uart_send_command_for_tab("deauth_detector");
     
     deauth_detector_running = true;
     
     // Also mark in context
-    tab_context_t *ctx = get_current_ctx();
     if (ctx) {
         ctx->deauth_detector_running = true;
     }
     
-    xTaskCreate(deauth_detector_task, "deauth_det", 4096, (void*)ctx, 5, &deauth_detector_task_handle);
+    transport_rx_task_create(deauth_detector_task, "deauth_det", 4096, (void*)ctx, rx_sub, 5,
+                             &deauth_detector_task_handle);
     
     // Update button states
     lv_obj_add_state(deauth_start_btn, LV_STATE_DISABLED);
@@ -16745,6 +17646,7 @@ static void deauth_detector_back_btn_event_cb(lv_event_t *e)
 // Show Deauth Detector page (inside current tab's container)
 static void show_deauth_detector_page(void)
 {
+    UI_PAGE_SCOPE("show_deauth_detector_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     
@@ -16917,6 +17819,7 @@ static void bt_menu_tile_event_cb(lv_event_t *e)
 // Show Bluetooth menu page with 3 tiles (inside current tab's container)
 static void show_bluetooth_menu_page(void)
 {
+    UI_PAGE_SCOPE("show_bluetooth_menu_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     
@@ -17025,58 +17928,39 @@ static void airtag_scan_back_btn_event_cb(lv_event_t *e)
 static void airtag_scan_task(void *arg)
 {
     // Get context passed to task
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     const char *uart_name = tab_transport_name(task_tab);
     
     ESP_LOGI(TAG, "[%s] AirTag scan task started for tab %d", uart_name, task_tab);
     
-    static char rx_buffer[256];
-    static char line_buffer[64];
-    int line_pos = 0;
-    
     // Use context's flag
     while (ctx && ctx->airtag_scanning) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
+        // Parse format: airtag_count,smarttag_count
+        int airtag_count = 0, smarttag_count = 0;
+        if (sscanf(line_buffer, "%d,%d", &airtag_count, &smarttag_count) == 2) {
+            ESP_LOGI(TAG, "AirTag scan: %d AirTags, %d SmartTags", airtag_count, smarttag_count);
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        
-                        // Parse format: airtag_count,smarttag_count
-                        int airtag_count = 0, smarttag_count = 0;
-                        if (sscanf(line_buffer, "%d,%d", &airtag_count, &smarttag_count) == 2) {
-                            ESP_LOGI(TAG, "AirTag scan: %d AirTags, %d SmartTags", airtag_count, smarttag_count);
-                            
-                            bsp_display_lock(0);
-                            if (airtag_count_label) {
-                                lv_label_set_text_fmt(airtag_count_label, "%d", airtag_count);
-                            }
-                            if (smarttag_count_label) {
-                                lv_label_set_text_fmt(smarttag_count_label, "%d", smarttag_count);
-                            }
-                            bsp_display_unlock();
-                        }
-                        
-                        line_pos = 0;
-                    }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
-                }
+            ui_perf_lock(0);
+            if (airtag_count_label) {
+                lv_label_set_text_fmt(airtag_count_label, "%d", airtag_count);
             }
+            if (smarttag_count_label) {
+                lv_label_set_text_fmt(smarttag_count_label, "%d", smarttag_count);
+            }
+            ui_perf_unlock();
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
+    rx_demux_unsubscribe(rx_sub);
     
     ESP_LOGI(TAG, "AirTag scan task ended");
     airtag_scan_task_handle = NULL;
@@ -17086,6 +17970,7 @@ static void airtag_scan_task(void *arg)
 // Show AirTag scan page (inside current tab's container)
 static void show_airtag_scan_page(void)
 {
+    UI_PAGE_SCOPE("show_airtag_scan_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     
@@ -17203,6 +18088,7 @@ static void show_airtag_scan_page(void)
     
     // Start scanning
     ESP_LOGI(TAG, "Starting AirTag scan");
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(ctx);  // before the command, for the task
     uart_send_command_for_tab("scan_airtag");
     airtag_scanning = true;
     
@@ -17211,7 +18097,7 @@ static void show_airtag_scan_page(void)
         ctx->airtag_scanning = true;
     }
     
-    xTaskCreate(airtag_scan_task, "airtag_scan", 4096, (void*)ctx, 5, &airtag_scan_task_handle);
+    transport_rx_task_create(airtag_scan_task, "airtag_scan", 4096, (void*)ctx, rx_sub, 5, &airtag_scan_task_handle);
     
     // Set current visible page
     ctx->current_visible_page = ctx->bt_airtag_page;
@@ -17226,37 +18112,7 @@ static void show_airtag_scan_page(void)
 static bool parse_bt_device_line(const char *line, bt_device_t *dev)
 {
     // Find MAC address pattern (XX:XX:XX:XX:XX:XX) in the line
-    // Look for the pattern: two hex digits followed by colon, repeated
-    const char *p = line;
-    const char *mac_start = NULL;
-    
-    while (*p) {
-        // Check if this could be start of a MAC address
-        if (isxdigit((unsigned char)p[0]) && isxdigit((unsigned char)p[1]) && p[2] == ':') {
-            // Verify it's a full MAC (17 chars: XX:XX:XX:XX:XX:XX)
-            int colons = 0;
-            bool valid = true;
-            for (int i = 0; i < 17 && p[i]; i++) {
-                if (i % 3 == 2) {
-                    if (p[i] != ':' && i < 15) { valid = false; break; }
-                    if (p[i] == ':') colons++;
-                } else {
-                    if (!isxdigit((unsigned char)p[i])) { valid = false; break; }
-                }
-            }
-            if (valid && colons == 5) {
-                mac_start = p;
-                break;
-            }
-        }
-        p++;
-    }
-    
-    if (!mac_start) return false;
-    
-    // Copy MAC
-    strncpy(dev->mac, mac_start, 17);
-    dev->mac[17] = '\0';
+    if (!mac48_find(line, &dev->mac)) return false;
     
     // Find RSSI
     const char *rssi_ptr = strstr(line, "RSSI:");
@@ -17314,15 +18170,107 @@ static void bt_scan_rescan_cb(lv_event_t *e)
 // Device click callback - opens locator tracking
 static void bt_scan_device_click_cb(lv_event_t *e)
 {
-    int device_idx = (int)(intptr_t)lv_event_get_user_data(e);
+    // Keyed rows stay in device order, so the row position is the device index
+    int device_idx = (int)lv_obj_get_index(lv_event_get_current_target(e));
     if (device_idx >= 0 && device_idx < bt_device_count) {
         show_bt_locator_page(device_idx);
     }
 }
 
+static const char *bt_scan_row_key_cb(uint32_t index, void *user_data)
+{
+    (void)user_data;
+    // The reconciler copies the key before asking for the next one
+    static char key[MAC48_STR_SIZE];
+    return mac48_format(&bt_devices[index].mac, key);
+}
+
+static void bt_scan_row_create_cb(lv_obj_t *row, void *user_data)
+{
+    (void)user_data;
+
+    lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_radius(row, 6, 0);
+    lv_obj_set_style_pad_all(row, 10, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(row, bt_scan_device_click_cb, LV_EVENT_CLICKED, NULL);
+    
+    // Name or MAC - starts in the unnamed layout, see bt_scan_row_bind_cb
+    lv_obj_t *name_lbl = lv_label_create(row);
+    lv_obj_set_width(name_lbl, 155);  // Fixed width for MAC
+    lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(name_lbl, COLOR_MATERIAL_CYAN, 0);
+    
+    // MAC (only shown when the device has a name)
+    lv_obj_t *mac_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(mac_lbl, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(mac_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+    lv_obj_set_width(mac_lbl, 155);  // Full MAC width (17 chars)
+    lv_obj_add_flag(mac_lbl, LV_OBJ_FLAG_HIDDEN);
+    
+    // RSSI (color-coded on bind)
+    lv_obj_t *rssi_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(rssi_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_width(rssi_lbl, 70);
+}
+
+static void bt_scan_row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
+{
+    (void)user_data;
+    bt_device_t *dev = &bt_devices[index];
+    lv_obj_t *name_lbl = lv_obj_get_child(row, 0);
+    lv_obj_t *mac_lbl = lv_obj_get_child(row, 1);
+    lv_obj_t *rssi_lbl = lv_obj_get_child(row, 2);
+    bool has_name = dev->name[0] != '\0';
+    
+    if (ui_comp_patch_flag(mac_lbl, LV_OBJ_FLAG_HIDDEN, !has_name)) {
+        if (has_name) {
+            lv_obj_set_width(name_lbl, LV_SIZE_CONTENT);
+            lv_obj_set_flex_grow(name_lbl, 1);
+            lv_label_set_long_mode(name_lbl, LV_LABEL_LONG_DOT);
+        } else {
+            // No name - show full MAC address without truncation
+            lv_obj_set_flex_grow(name_lbl, 0);
+            lv_obj_set_width(name_lbl, 155);
+        }
+    }
+    char mac[MAC48_STR_SIZE];
+    mac48_format(&dev->mac, mac);
+    ui_comp_patch_label_text(name_lbl, has_name ? dev->name : mac);
+    ui_comp_patch_label_text(mac_lbl, mac);
+    
+    ui_comp_patch_label_text_fmt(rssi_lbl, "%d dBm", dev->rssi);
+    if (dev->rssi > -50) {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_GREEN);
+    } else if (dev->rssi > -70) {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_AMBER);
+    } else {
+        ui_comp_patch_text_color(rssi_lbl, COLOR_MATERIAL_RED);
+    }
+}
+
+// Reconcile the device rows with bt_devices, keyed by MAC
+static void update_bt_scan_list(lv_obj_t *list_container)
+{
+    if (!list_container) return;
+    
+    ui_comp_update_counters_t before;
+    ui_comp_get_update_counters(&before);
+    ui_comp_keyed_list_sync(list_container, (uint32_t)bt_device_count, bt_scan_row_key_cb,
+                            bt_scan_row_create_cb, bt_scan_row_bind_cb, NULL, NULL);
+    ui_log_update_cost("BT scan list", &before);
+}
+
 // Show BT Scan page (inside current tab's container)
 static void show_bt_scan_page(void)
 {
+    UI_PAGE_SCOPE("show_bt_scan_page");
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
     
@@ -17429,43 +18377,64 @@ static void show_bt_scan_page(void)
     
     // Force UI refresh to show loading state - release display lock briefly
     lv_refr_now(NULL);
-    bsp_display_unlock();
+    ui_perf_unlock();
     vTaskDelay(pdMS_TO_TICKS(100));
     
-    // Flush any stale UART data before scanning
+    // Listen before scanning so stale data is not picked up
     uart_port_t uart_port = uart_port_for_tab(current_tab);
-    uart_flush_input(uart_port);
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_records_tab(current_tab, uart_port,
+                                                                TRANSPORT_RX_RECORDS(WIRE_TYPE_BT_DEVICE));
     
     // Send scan command to current tab's UART
     uart_send_command_for_tab("scan_bt");
     ESP_LOGI(TAG, "BT Scan: waiting for results (up to 15s)...");
     
-    // Read data until we see "Summary:" or timeout
-    static char rx_buffer[8192];
-    int total_len = 0;
+    // Collect devices until we see "Summary:" or timeout
     bool summary_found = false;
-    int timeout_ms = 15000;  // 15 second timeout
-    int elapsed_ms = 0;
+    rx_parse_cost_t parse_cost = {0};
+    TickType_t start_time = xTaskGetTickCount();
+    TickType_t timeout_ticks = pdMS_TO_TICKS(15000);  // 15 second timeout
     
-    while (!summary_found && elapsed_ms < timeout_ms && total_len < (int)sizeof(rx_buffer) - 256) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
-        if (len > 0) {
-            total_len += len;
-            rx_buffer[total_len] = '\0';
-            
-            // Check if we have the complete response
-            if (strstr(rx_buffer, "Summary:") != NULL) {
-                summary_found = true;
-                ESP_LOGI(TAG, "BT Scan: Summary found, scan complete");
+    bt_device_count = 0;
+    while (!summary_found && (xTaskGetTickCount() - start_time) < timeout_ticks) {
+        rx_demux_msg_t msg;
+        if (!rx_demux_next(rx_sub, &msg, pdMS_TO_TICKS(200))) {
+            continue;
+        }
+        if (msg.record) {
+            const wire_record_t *rec = (const wire_record_t *)msg.record;
+            if (rec->type == WIRE_TYPE_BT_DEVICE && bt_device_count < BT_MAX_DEVICES) {
+                int64_t parse_start = esp_timer_get_time();
+                bt_device_t *dev = &bt_devices[bt_device_count++];
+                dev->mac = rec->u.bt.mac;
+                dev->rssi = rec->u.bt.rssi;
+                snprintf(dev->name, sizeof(dev->name), "%s", rec->u.bt.name);
+                rx_parse_cost_add(&parse_cost, &msg, parse_start);
             }
+            continue;
         }
-        elapsed_ms += 200;
-    }
+        
+        const char *line = msg.line.text;
+        if (strstr(line, "Summary:") != NULL) {
+            summary_found = true;
+            ESP_LOGI(TAG, "BT Scan: Summary found, scan complete");
+        } else if (strstr(line, "RSSI:") != NULL && bt_device_count < BT_MAX_DEVICES) {
+            // Device lines contain a MAC pattern and RSSI
+            bt_device_t dev;
+            int64_t parse_start = esp_timer_get_time();
+            if (parse_bt_device_line(line, &dev)) {
+                bt_devices[bt_device_count++] = dev;
+            }
+            rx_parse_cost_add(&parse_cost, &msg, parse_start);
+        }
+    }
+    rx_demux_unsubscribe(rx_sub);
     
-    ESP_LOGI(TAG, "BT Scan response (%d bytes, summary=%s)", total_len, summary_found ? "yes" : "no");
+    ESP_LOGI(TAG, "BT Scan: %d devices (summary=%s)", bt_device_count, summary_found ? "yes" : "no");
+    rx_parse_cost_log(tab_transport_name(current_tab), "BT scan", &parse_cost);
     
     // Re-acquire display lock
-    bsp_display_lock(0);
+    ui_perf_lock(0);
     
     // Remove loading indicator
     lv_obj_del(loading_container);
@@ -17486,73 +18455,8 @@ static void show_bt_scan_page(void)
     lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_style_pad_row(list_container, 6, 0);
     
-    // Parse devices
-    bt_device_count = 0;
-    char *line = strtok(rx_buffer, "\n\r");
-    while (line != NULL && bt_device_count < BT_MAX_DEVICES) {
-        // Look for device lines (contain MAC pattern and RSSI)
-        if (strstr(line, "RSSI:") != NULL && strchr(line, ':') != NULL) {
-            bt_device_t dev;
-            if (parse_bt_device_line(line, &dev)) {
-                bt_devices[bt_device_count++] = dev;
-            }
-        }
-        line = strtok(NULL, "\n\r");
-    }
-    
     // Display clickable devices
-    for (int i = 0; i < bt_device_count; i++) {
-        bt_device_t *dev = &bt_devices[i];
-        
-        lv_obj_t *row = lv_obj_create(list_container);
-        lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
-        lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
-        lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_SURFACE_ALT), LV_STATE_PRESSED);
-        lv_obj_set_style_border_width(row, 0, 0);
-        lv_obj_set_style_radius(row, 6, 0);
-        lv_obj_set_style_pad_all(row, 10, 0);
-        lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
-        lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-        lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
-        lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_event_cb(row, bt_scan_device_click_cb, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-        
-        // Name or MAC
-        lv_obj_t *name_lbl = lv_label_create(row);
-        if (strlen(dev->name) > 0) {
-            lv_label_set_text(name_lbl, dev->name);
-            lv_obj_set_flex_grow(name_lbl, 1);
-            lv_label_set_long_mode(name_lbl, LV_LABEL_LONG_DOT);
-        } else {
-            // No name - show full MAC address without truncation
-            lv_label_set_text(name_lbl, dev->mac);
-            lv_obj_set_width(name_lbl, 155);  // Fixed width for MAC
-        }
-        lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(name_lbl, COLOR_MATERIAL_CYAN, 0);
-        
-        // MAC (if name exists, show MAC too)
-        if (strlen(dev->name) > 0) {
-            lv_obj_t *mac_lbl = lv_label_create(row);
-            lv_label_set_text(mac_lbl, dev->mac);
-            lv_obj_set_style_text_font(mac_lbl, &lv_font_montserrat_12, 0);
-            lv_obj_set_style_text_color(mac_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-            lv_obj_set_width(mac_lbl, 155);  // Full MAC width (17 chars)
-        }
-        
-        // RSSI
-        lv_obj_t *rssi_lbl = lv_label_create(row);
-        lv_label_set_text_fmt(rssi_lbl, "%d dBm", dev->rssi);
-        lv_obj_set_style_text_font(rssi_lbl, &lv_font_montserrat_14, 0);
-        if (dev->rssi > -50) {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_GREEN, 0);
-        } else if (dev->rssi > -70) {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_AMBER, 0);
-        } else {
-            lv_obj_set_style_text_color(rssi_lbl, COLOR_MATERIAL_RED, 0);
-        }
-        lv_obj_set_width(rssi_lbl, 70);
-    }
+    update_bt_scan_list(list_container);
     
     lv_label_set_text_fmt(status_label, "Tap device to locate (%d found)", bt_device_count);
     
@@ -17596,98 +18500,76 @@ static void bt_locator_tracking_back_btn_event_cb(lv_event_t *e)
 static void bt_locator_tracking_task(void *arg)
 {
     // Get context passed to task
-    tab_context_t *ctx = (tab_context_t *)arg;
+    rx_demux_sub_t *rx_sub = NULL;
+    tab_context_t *ctx = (tab_context_t *)transport_rx_task_take(arg, &rx_sub);
     
     // Determine UART from context
     tab_id_t task_tab = tab_id_for_ctx(ctx);
-    uart_port_t uart_port = (task_tab == TAB_MBUS && uart2_initialized) ? UART2_NUM : UART_NUM;
     const char *uart_name = tab_transport_name(task_tab);
     
-    ESP_LOGI(TAG, "[%s][BT_LOC] Task started for tab %d, target MAC: '%s'", uart_name, task_tab, bt_locator_target_mac);
+    ESP_LOGI(TAG, "[%s][BT_LOC] Task started for tab %d, target MAC: '" MAC48_FMT "'", uart_name, task_tab,
+             MAC48_ARGS(bt_locator_target_mac));
     
-    static char rx_buffer[256];
-    static char line_buffer[128];
-    int line_pos = 0;
-    int total_bytes_received = 0;
     int lines_parsed = 0;
     int matches_found = 0;
     
     // Use context's flag
     while (ctx && ctx->bt_locator_tracking) {
-        int len = transport_read_bytes(uart_port, rx_buffer, sizeof(rx_buffer) - 1, pdMS_TO_TICKS(100));
+        line_view_t rx_line;
+        if (!rx_demux_next_line(rx_sub, &rx_line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        char *line_buffer = rx_line.text;
+        lines_parsed++;
         
-        if (len > 0) {
-            rx_buffer[len] = '\0';
-            total_bytes_received += len;
-            ESP_LOGD(TAG, "[BT_LOC] UART RX %d bytes (total: %d)", len, total_bytes_received);
+        // Check if line contains our target MAC
+        mac48_t line_mac;
+        if (mac48_find(line_buffer, &line_mac) && mac48_equal(&line_mac, &bt_locator_target_mac)) {
+            matches_found++;
+            ESP_LOGI(TAG, "[BT_LOC] MAC match #%d found!", matches_found);
             
-            for (int i = 0; i < len; i++) {
-                char c = rx_buffer[i];
-                
-                if (c == '\n' || c == '\r') {
-                    if (line_pos > 0) {
-                        line_buffer[line_pos] = '\0';
-                        lines_parsed++;
-                        
-                        ESP_LOGI(TAG, "[BT_LOC] Line #%d: '%s'", lines_parsed, line_buffer);
-                        
-                        // Check if line contains our target MAC
-                        if (strstr(line_buffer, bt_locator_target_mac) != NULL) {
-                            matches_found++;
-                            ESP_LOGI(TAG, "[BT_LOC] MAC match #%d found!", matches_found);
-                            
-                            // Check if device is out of range
-                            if (strstr(line_buffer, "not found") != NULL) {
-                                ESP_LOGI(TAG, "[BT_LOC] Device out of range");
-                                bsp_display_lock(0);
-                                if (bt_locator_rssi_label) {
-                                    lv_label_set_text(bt_locator_rssi_label, "No signal");
-                                    lv_obj_set_style_text_font(bt_locator_rssi_label, &lv_font_montserrat_32, 0);
-                                    lv_obj_set_style_text_color(bt_locator_rssi_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
-                                }
-                                bsp_display_unlock();
-                            } else {
-                                // Parse RSSI
-                                const char *rssi_ptr = strstr(line_buffer, "RSSI:");
-                                if (rssi_ptr) {
-                                    int rssi = atoi(rssi_ptr + 5);
-                                    ESP_LOGI(TAG, "[BT_LOC] RSSI parsed: %d dBm", rssi);
-                                    
-                                    bsp_display_lock(0);
-                                    if (bt_locator_rssi_label) {
-                                        lv_label_set_text_fmt(bt_locator_rssi_label, "%d dBm", rssi);
-                                        lv_obj_set_style_text_font(bt_locator_rssi_label, &lv_font_montserrat_44, 0);
-                                        if (rssi > -50) {
-                                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_GREEN, 0);
-                                        } else if (rssi > -70) {
-                                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_AMBER, 0);
-                                        } else {
-                                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_RED, 0);
-                                        }
-                                        ESP_LOGI(TAG, "[BT_LOC] UI updated with RSSI %d", rssi);
-                                    } else {
-                                        ESP_LOGW(TAG, "[BT_LOC] bt_locator_rssi_label is NULL!");
-                                    }
-                                    bsp_display_unlock();
-                                } else {
-                                    ESP_LOGW(TAG, "[BT_LOC] MAC matched but no RSSI: found in line '%s'", line_buffer);
-                                }
-                            }
+            // Check if device is out of range
+            if (strstr(line_buffer, "not found") != NULL) {
+                ESP_LOGI(TAG, "[BT_LOC] Device out of range");
+                ui_perf_lock(0);
+                if (bt_locator_rssi_label) {
+                    lv_label_set_text(bt_locator_rssi_label, "No signal");
+                    lv_obj_set_style_text_font(bt_locator_rssi_label, &lv_font_montserrat_32, 0);
+                    lv_obj_set_style_text_color(bt_locator_rssi_label, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
+                }
+                ui_perf_unlock();
+            } else {
+                // Parse RSSI
+                const char *rssi_ptr = strstr(line_buffer, "RSSI:");
+                if (rssi_ptr) {
+                    int rssi = atoi(rssi_ptr + 5);
+                    ESP_LOGI(TAG, "[BT_LOC] RSSI parsed: %d dBm", rssi);
+                    
+                    ui_perf_lock(0);
+                    if (bt_locator_rssi_label) {
+                        lv_label_set_text_fmt(bt_locator_rssi_label, "%d dBm", rssi);
+                        lv_obj_set_style_text_font(bt_locator_rssi_label, &lv_font_montserrat_44, 0);
+                        if (rssi > -50) {
+                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_GREEN, 0);
+                        } else if (rssi > -70) {
+                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_AMBER, 0);
+                        } else {
+                            lv_obj_set_style_text_color(bt_locator_rssi_label, COLOR_MATERIAL_RED, 0);
                         }
-                        
-                        line_pos = 0;
+                        ESP_LOGI(TAG, "[BT_LOC] UI updated with RSSI %d", rssi);
+                    } else {
+                        ESP_LOGW(TAG, "[BT_LOC] bt_locator_rssi_label is NULL!");
                     }
-                } else if (line_pos < (int)sizeof(line_buffer) - 1) {
-                    line_buffer[line_pos++] = c;
+                    ui_perf_unlock();
+                } else {
+                    ESP_LOGW(TAG, "[BT_LOC] MAC matched but no RSSI: found in line '%s'", line_buffer);
                 }
             }
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
+    rx_demux_unsubscribe(rx_sub);
     
-    ESP_LOGI(TAG, "[BT_LOC] Task ended - total bytes: %d, lines: %d, matches: %d", 
-             total_bytes_received, lines_parsed, matches_found);
+    ESP_LOGI(TAG, "[BT_LOC] Task ended - lines: %d, matches: %d", lines_parsed, matches_found);
     bt_locator_task_handle = NULL;
     vTaskDelete(NULL);
 }
@@ -17700,7 +18582,7 @@ static void show_bt_locator_page(int device_idx)
     bt_device_t *dev = &bt_devices[device_idx];
     
     // Save target info
-    strncpy(bt_locator_target_mac, dev->mac, sizeof(bt_locator_target_mac) - 1);
+    bt_locator_target_mac = dev->mac;
     strncpy(bt_locator_target_name, dev->name, sizeof(bt_locator_target_name) - 1);
     
     tab_context_t *ctx = get_current_ctx();
@@ -17774,11 +18656,13 @@ static void show_bt_locator_page(int device_idx)
     lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
     
     // Device name/MAC
+    char target_mac[MAC48_STR_SIZE];
+    mac48_format(&bt_locator_target_mac, target_mac);
     lv_obj_t *name_lbl = lv_label_create(content);
     if (strlen(bt_locator_target_name) > 0) {
         lv_label_set_text(name_lbl, bt_locator_target_name);
     } else {
-        lv_label_set_text(name_lbl, bt_locator_target_mac);
+        lv_label_set_text(name_lbl, target_mac);
     }
     lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_24, 0);
     lv_obj_set_style_text_color(name_lbl, lv_color_hex(0xFFFFFF), 0);
@@ -17787,7 +18671,7 @@ static void show_bt_locator_page(int device_idx)
     // MAC (if name shown)
     if (strlen(bt_locator_target_name) > 0) {
         lv_obj_t *mac_lbl = lv_label_create(content);
-        lv_label_set_text(mac_lbl, bt_locator_target_mac);
+        lv_label_set_text(mac_lbl, target_mac);
         lv_obj_set_style_text_font(mac_lbl, &lv_font_montserrat_16, 0);
         lv_obj_set_style_text_color(mac_lbl, ui_theme_color(UI_COLOR_TEXT_MUTED), 0);
     }
@@ -17822,7 +18706,9 @@ static void show_bt_locator_page(int device_idx)
     
     // Start tracking
     char cmd[64];
-    snprintf(cmd, sizeof(cmd), "scan_bt %s", bt_locator_target_mac);
+    snprintf(cmd, sizeof(cmd), "scan_bt " MAC48_FMT, MAC48_ARGS(bt_locator_target_mac));
+    tab_context_t *loc_ctx = get_current_ctx();
+    rx_demux_sub_t *rx_sub = transport_rx_subscribe_ctx(loc_ctx);  // before the command, for the task
     ESP_LOGI(TAG, "[BT_LOC] Sending UART command: '%s'", cmd);
     uart_send_command_for_tab(cmd);
     ESP_LOGI(TAG, "[BT_LOC] Command sent, starting monitor task");
@@ -17830,12 +18716,12 @@ static void show_bt_locator_page(int device_idx)
     bt_locator_tracking = true;
     
     // Also mark in context
-    tab_context_t *loc_ctx = get_current_ctx();
     if (loc_ctx) {
         loc_ctx->bt_locator_tracking = true;
     }
     
-    xTaskCreate(bt_locator_tracking_task, "bt_locator", 4096, (void*)loc_ctx, 5, &bt_locator_task_handle);
+    transport_rx_task_create(bt_locator_tracking_task, "bt_locator", 4096, (void*)loc_ctx, rx_sub, 5,
+                             &bt_locator_task_handle);
     ESP_LOGI(TAG, "[BT_LOC] Monitor task created, tracking_page=%p, rssi_label=%p", 
              (void*)bt_locator_page, (void*)bt_locator_rssi_label);
     
@@ -17893,6 +18779,7 @@ static void global_attack_tile_event_cb(lv_event_t *e)
 // Show Global WiFi Attacks page
 static void show_global_attacks_page(void)
 {
+    UI_PAGE_SCOPE("show_global_attacks_page");
     // Get current tab's data and container
     tab_context_t *ctx = get_current_ctx();
     lv_obj_t *container = get_current_tab_container();
@@ -18003,6 +18890,9 @@ static __attribute__((unused)) lv_obj_t *settings_popup_obj = NULL;
 #define NVS_KEY_BUTTON_OUTLINE  "btn_outline"
 #define NVS_KEY_ACTIVE_THEME    "theme_id"
 #define NVS_KEY_DASHBOARD       "dash_en"
+#define NVS_KEY_TRACE_LEVEL     "trace_lvl"
+#define NVS_KEY_PERF_OVERLAY    "perf_overlay"
+#define NVS_KEY_PERF_LOG        "perf_log"
 
 // Load Red Team setting from NVS (called on startup)
 // Note: Device detection is automatic via ping/pong
@@ -18027,6 +18917,21 @@ static void load_red_team_from_nvs(void)
     }
 }
 
+// Transport trace level (transport_trace_level_t); absent = ring buffer on, no per-chunk log
+static void load_transport_trace_level_from_nvs(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    uint8_t level = 0;
+    if (nvs_get_u8(nvs, NVS_KEY_TRACE_LEVEL, &level) == ESP_OK && level <= TRANSPORT_TRACE_LOG) {
+        transport_trace_set_level(&transport_tracer, (transport_trace_level_t)level);
+        ESP_LOGI(TAG, "Loaded transport trace level from NVS: %u", (unsigned)level);
+    }
+    nvs_close(nvs);
+}
+
 // Save Red Team setting to NVS
 static void save_red_team_to_nvs(bool enabled)
 {
@@ -18095,7 +19000,6 @@ static void load_screen_settings_from_nvs(void)
 
         ui_theme_set_dark_mode(true);
 
-        refresh_sd_themes_cache();
         size_t theme_len = sizeof(active_theme_id);
         esp_err_t theme_err = nvs_get_str(nvs, NVS_KEY_ACTIVE_THEME, active_theme_id, &theme_len);
         if (theme_err == ESP_OK) {
@@ -18104,6 +19008,7 @@ static void load_screen_settings_from_nvs(void)
             snprintf(active_theme_id, sizeof(active_theme_id), "%s", "default");
             ESP_LOGI(TAG, "No active theme in NVS, using default");
         }
+        load_active_sd_theme(active_theme_id);
         apply_selected_theme_index(find_theme_index_by_id(active_theme_id), false);
         
         nvs_close(nvs);
@@ -18111,7 +19016,7 @@ static void load_screen_settings_from_nvs(void)
         ESP_LOGI(TAG, "NVS not available, using default screen settings");
         dashboard_enabled_preference = true;
         ui_theme_set_dark_mode(true);
-        refresh_sd_themes_cache();
+        reset_sd_themes_cache();
         apply_selected_theme_index(0, false);
     }
 }
@@ -18146,6 +19051,39 @@ static void save_screen_brightness_to_nvs(uint8_t brightness)
     }
 }
 
+// Frame monitor overlay and CSV log; both off unless saved on
+static void load_perf_monitor_from_nvs(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    uint8_t value = 0;
+    if (nvs_get_u8(nvs, NVS_KEY_PERF_OVERLAY, &value) == ESP_OK) {
+        perf_overlay_enabled = (value != 0);
+    }
+    if (nvs_get_u8(nvs, NVS_KEY_PERF_LOG, &value) == ESP_OK) {
+        perf_log_enabled = (value != 0);
+    }
+    nvs_close(nvs);
+    ESP_LOGI(TAG, "Loaded Perf Monitor from NVS: overlay %s, log %s",
+             perf_overlay_enabled ? "ON" : "OFF", perf_log_enabled ? "ON" : "OFF");
+}
+
+static void save_perf_monitor_to_nvs(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        nvs_set_u8(nvs, NVS_KEY_PERF_OVERLAY, perf_overlay_enabled ? 1 : 0);
+        nvs_set_u8(nvs, NVS_KEY_PERF_LOG, perf_log_enabled ? 1 : 0);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    } else {
+        ESP_LOGE(TAG, "Failed to open NVS for writing Perf Monitor: %s", esp_err_to_name(err));
+    }
+}
+
 static void save_dashboard_pref_to_nvs(bool enabled)
 {
     nvs_handle_t nvs;
@@ -18338,9 +19276,10 @@ static lv_obj_t *find_tile_icon_row(lv_obj_t *tile)
     return NULL;
 }
 
-static bool try_build_theme_icon_image(lv_obj_t *icon_row, const char *src, lv_coord_t icon_box)
+// Size and dimension limits a theme icon has to meet before it gets decoded
+static bool theme_icon_src_usable(const char *src)
 {
-    if (!binding_obj_valid(icon_row) || !src || src[0] == '\0') {
+    if (!src || src[0] == '\0') {
         return false;
     }
 
@@ -18366,7 +19305,68 @@ static bool try_build_theme_icon_image(lv_obj_t *icon_row, const char *src, lv_c
                  (int)header.w, (int)header.h, src);
         return false;
     }
+    return true;
+}
+
+// The path as given, or with the default LVGL drive letter in front; false if neither is usable
+static bool resolve_theme_icon_src(const char *path, char *out, size_t out_len)
+{
+    if (!path || path[0] == '\0') {
+        return false;
+    }
+    if (theme_icon_src_usable(path)) {
+        snprintf(out, out_len, "%s", path);
+        return true;
+    }
+#if CONFIG_LV_FS_DEFAULT_DRIVER_LETTER > 0
+    if (path[1] != ':') {
+        int n = snprintf(out, out_len, "%c:%s", (char)CONFIG_LV_FS_DEFAULT_DRIVER_LETTER, path);
+        if (n > 0 && (size_t)n < out_len && theme_icon_src_usable(out)) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+_Static_assert(UART_MAIN_TILE_COUNT + INTERNAL_MAIN_TILE_COUNT <= THEME_ICONS_MAX_SLOTS,
+               "atlas too small for the tiles");
+
+static size_t theme_icon_slot(bool is_internal, size_t idx)
+{
+    return is_internal ? UART_MAIN_TILE_COUNT + idx : idx;
+}
 
+// The tile asking first sets the cell size; on the stock grids every tile has the same icon box
+static void ensure_theme_icon_atlas(lv_coord_t icon_box)
+{
+    if (!theme_icon_atlas_stale) {
+        return;
+    }
+    theme_icon_atlas_stale = false;
+
+    static char srcs[UART_MAIN_TILE_COUNT + INTERNAL_MAIN_TILE_COUNT][MAX_THEME_PATH_LEN + 4];
+    const char *slots[UART_MAIN_TILE_COUNT + INTERNAL_MAIN_TILE_COUNT] = {0};
+    size_t wanted = 0;
+    for (size_t i = 0; i < UART_MAIN_TILE_COUNT + INTERNAL_MAIN_TILE_COUNT; ++i) {
+        bool is_internal = i >= UART_MAIN_TILE_COUNT;
+        const char *path = active_theme_icon_path_for_tile(is_internal, is_internal ? i - UART_MAIN_TILE_COUNT : i);
+        if (path && path[0] != '\0') {
+            wanted++;
+            if (resolve_theme_icon_src(path, srcs[i], sizeof(srcs[i]))) {
+                slots[i] = srcs[i];
+            }
+        }
+    }
+    if (wanted == 0) {
+        theme_icons_atlas_free();
+        return;
+    }
+    theme_icons_atlas_build(slots, UART_MAIN_TILE_COUNT + INTERNAL_MAIN_TILE_COUNT, (uint16_t)icon_box);
+}
+
+static void create_theme_icon_image(lv_obj_t *icon_row, const void *src, lv_coord_t icon_box)
+{
     lv_obj_t *icon_img = lv_image_create(icon_row);
     lv_image_set_src(icon_img, src);
     lv_obj_set_size(icon_img, icon_box, icon_box);
@@ -18380,7 +19380,6 @@ static bool try_build_theme_icon_image(lv_obj_t *icon_row, const char *src, lv_c
         lv_obj_set_style_image_recolor_opa(icon_img, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_ANY);
     }
     lv_obj_center(icon_img);
-    return true;
 }
 
 static void rebuild_tile_icon_widget(lv_obj_t *tile, bool is_internal, size_t idx)
@@ -18407,20 +19406,23 @@ static void rebuild_tile_icon_widget(lv_obj_t *tile, bool is_internal, size_t id
         if (tile_h > 0) {
             icon_box = tile_h / 3;
             if (icon_box < 36) icon_box = 36;
-            if (icon_box > 68) icon_box = 68;
+            if (icon_box > THEME_ICONS_MAX_CELL_PX) icon_box = THEME_ICONS_MAX_CELL_PX;
         }
 
-        used_custom_image = try_build_theme_icon_image(icon_row, custom_path, icon_box);
-#if CONFIG_LV_FS_DEFAULT_DRIVER_LETTER > 0
-        if (!used_custom_image && custom_path[1] != ':') {
-            char lvgl_path[MAX_THEME_PATH_LEN + 4];
-            int n = snprintf(lvgl_path, sizeof(lvgl_path), "%c:%s",
-                             (char)CONFIG_LV_FS_DEFAULT_DRIVER_LETTER, custom_path);
-            if (n > 0 && (size_t)n < sizeof(lvgl_path)) {
-                used_custom_image = try_build_theme_icon_image(icon_row, lvgl_path, icon_box);
-            }
+        // Decoded once per theme; loading from the file is the fallback
+        const lv_image_dsc_t *atlas_icon = NULL;
+        if (theme_icon_atlas_enabled) {
+            ensure_theme_icon_atlas(icon_box);
+            atlas_icon = theme_icons_atlas_get(theme_icon_slot(is_internal, idx));
+        }
+        char src[MAX_THEME_PATH_LEN + 4];
+        if (atlas_icon) {
+            create_theme_icon_image(icon_row, atlas_icon, icon_box);
+            used_custom_image = true;
+        } else if (resolve_theme_icon_src(custom_path, src, sizeof(src))) {
+            create_theme_icon_image(icon_row, src, icon_box);
+            used_custom_image = true;
         }
-#endif
     }
 
     if (!used_custom_image) {
@@ -19186,7 +20188,8 @@ static bool parse_theme_ini_file(const char *config_path,
     return true;
 }
 
-static void refresh_sd_themes_cache(void)
+// Built-in theme only
+static void reset_sd_themes_cache(void)
 {
     memset(sd_themes, 0, sizeof(sd_themes));
     sd_theme_count = 0;
@@ -19208,6 +20211,60 @@ static void refresh_sd_themes_cache(void)
     memset(&sd_themes[0].layout_profile, 0, sizeof(sd_themes[0].layout_profile));
     sd_themes[0].valid = true;
     sd_theme_count = 1;
+}
+
+// Load THEMES_ROOT_DIR/<name> into the next free cache slot
+static bool load_sd_theme_dir(const char *name)
+{
+    if (sd_theme_count >= MAX_SD_THEMES) {
+        return false;
+    }
+
+    char dir_path[320];
+    struct stat st;
+    snprintf(dir_path, sizeof(dir_path), "%s/%s", THEMES_ROOT_DIR, name);
+    if (stat(dir_path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+
+    char config_path[384];
+    snprintf(config_path, sizeof(config_path), "%s/%s", dir_path, THEME_CONFIG_NAME);
+    if (stat(config_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    if (!parse_theme_ini_file(config_path, name, dir_path, &sd_themes[sd_theme_count])) {
+        return false;
+    }
+    load_theme_icon_paths(&sd_themes[sd_theme_count]);
+    char layout_path[MAX_THEME_PATH_LEN + 64];
+    struct stat layout_st;
+    size_t dir_len = strnlen(dir_path, sizeof(dir_path));
+    size_t file_len = strlen(THEME_LAYOUT_FILE_NAME);
+    if (dir_len > 0 && dir_len + 1 + file_len < sizeof(layout_path)) {
+        memcpy(layout_path, dir_path, dir_len);
+        layout_path[dir_len] = '/';
+        memcpy(layout_path + dir_len + 1, THEME_LAYOUT_FILE_NAME, file_len);
+        layout_path[dir_len + 1 + file_len] = '\0';
+        if (stat(layout_path, &layout_st) == 0 && S_ISREG(layout_st.st_mode)) {
+            if (parse_layout_json_file(layout_path, &sd_themes[sd_theme_count].layout_profile)) {
+                ESP_LOGI(TAG, "Loaded layout profile for theme: %s", sd_themes[sd_theme_count].id);
+            } else {
+                ESP_LOGW(TAG, "Invalid %s for theme: %s", THEME_LAYOUT_FILE_NAME, sd_themes[sd_theme_count].id);
+            }
+        }
+    }
+    ESP_LOGI(TAG, "Loaded SD theme: %s (%s)",
+             sd_themes[sd_theme_count].display_name,
+             sd_themes[sd_theme_count].id);
+    ++sd_theme_count;
+    return true;
+}
+
+// Every theme on SD; run when the theme picker opens
+static void refresh_sd_themes_cache(void)
+{
+    reset_sd_themes_cache();
 
     DIR *dir = opendir(THEMES_ROOT_DIR);
     if (!dir) {
@@ -19216,57 +20273,26 @@ static void refresh_sd_themes_cache(void)
     }
 
     struct dirent *entry = NULL;
-    while ((entry = readdir(dir)) != NULL) {
-        if (sd_theme_count >= MAX_SD_THEMES) {
-            break;
-        }
-
+    while ((entry = readdir(dir)) != NULL && sd_theme_count < MAX_SD_THEMES) {
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
             continue;
         }
-
-        char dir_path[320];
-        struct stat st;
-        snprintf(dir_path, sizeof(dir_path), "%s/%s", THEMES_ROOT_DIR, entry->d_name);
-        if (stat(dir_path, &st) != 0 || !S_ISDIR(st.st_mode)) {
-            continue;
-        }
-
-        char config_path[384];
-        snprintf(config_path, sizeof(config_path), "%s/%s", dir_path, THEME_CONFIG_NAME);
-        if (stat(config_path, &st) != 0 || !S_ISREG(st.st_mode)) {
-            continue;
-        }
-
-        if (parse_theme_ini_file(config_path, entry->d_name, dir_path, &sd_themes[sd_theme_count])) {
-            load_theme_icon_paths(&sd_themes[sd_theme_count]);
-            char layout_path[MAX_THEME_PATH_LEN + 64];
-            struct stat layout_st;
-            size_t dir_len = strnlen(dir_path, sizeof(dir_path));
-            size_t file_len = strlen(THEME_LAYOUT_FILE_NAME);
-            if (dir_len > 0 && dir_len + 1 + file_len < sizeof(layout_path)) {
-                memcpy(layout_path, dir_path, dir_len);
-                layout_path[dir_len] = '/';
-                memcpy(layout_path + dir_len + 1, THEME_LAYOUT_FILE_NAME, file_len);
-                layout_path[dir_len + 1 + file_len] = '\0';
-                if (stat(layout_path, &layout_st) == 0 && S_ISREG(layout_st.st_mode)) {
-                    if (parse_layout_json_file(layout_path, &sd_themes[sd_theme_count].layout_profile)) {
-                        ESP_LOGI(TAG, "Loaded layout profile for theme: %s", sd_themes[sd_theme_count].id);
-                    } else {
-                        ESP_LOGW(TAG, "Invalid %s for theme: %s", THEME_LAYOUT_FILE_NAME, sd_themes[sd_theme_count].id);
-                    }
-                }
-            }
-            ESP_LOGI(TAG, "Loaded SD theme: %s (%s)",
-                     sd_themes[sd_theme_count].display_name,
-                     sd_themes[sd_theme_count].id);
-            ++sd_theme_count;
-        }
+        load_sd_theme_dir(entry->d_name);
     }
 
     closedir(dir);
 }
 
+// Boot only needs the active theme. Theme ids are their directory names, so it
+// loads without scanning (and parsing) every theme on the card.
+static void load_active_sd_theme(const char *theme_id)
+{
+    reset_sd_themes_cache();
+    if (theme_id && theme_id[0] && strcmp(theme_id, "default") != 0 && !load_sd_theme_dir(theme_id)) {
+        ESP_LOGW(TAG, "Active theme %s not found on SD, using default", theme_id);
+    }
+}
+
 static size_t find_theme_index_by_id(const char *theme_id)
 {
     if (!theme_id || !theme_id[0]) {
@@ -19296,6 +20322,7 @@ static void apply_selected_theme_index(size_t idx, bool persist)
     active_theme_has_background_image = theme->has_background_image;
     memcpy(active_theme_uart_icon_paths, theme->uart_icon_paths, sizeof(active_theme_uart_icon_paths));
     memcpy(active_theme_internal_icon_paths, theme->internal_icon_paths, sizeof(active_theme_internal_icon_paths));
+    theme_icon_atlas_stale = true;
     if (theme->has_background_image) {
         copy_capped(active_theme_background_image, sizeof(active_theme_background_image), theme->background_image_path);
     } else {
@@ -19401,106 +20428,120 @@ static __attribute__((unused)) void deinit_uart2(void)
 // Board Detection via ping/pong protocol
 //==================================================================================
 
-// Send ping and wait for pong response on specified transport
-static bool ping_uart(uart_port_t uart_port, const char *uart_name)
+typedef struct {
+    tab_id_t tab;
+    uart_port_t port;
+    bool *detected;
+    char reply[64];
+    SemaphoreHandle_t negotiated;   // given when the link negotiation task is done
+} board_ping_t;
+
+static void detect_boards_negotiate(board_ping_t *ping)
 {
-    uint8_t rx_buffer[64];
-    
-    // Flush any existing data
-    uart_flush(uart_port);
-    
-    // Send ping command
-    const char *ping_cmd = "ping\r\n";
-    transport_write_bytes(uart_port, ping_cmd, strlen(ping_cmd));
-    ESP_LOGI(TAG, "[%s] Sent ping", uart_name);
-    
-    // Wait for pong response (up to 500ms)
-    int total_len = 0;
-    int64_t start_time = esp_timer_get_time();
-    int64_t timeout_us = 500000; // 500ms
-    
-    while ((esp_timer_get_time() - start_time) < timeout_us) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, 
-                                   sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(50));
-        if (len > 0) {
-            total_len += len;
-            rx_buffer[total_len] = '\0';
-            
-            // Check if we received "pong"
-            if (strstr((char*)rx_buffer, "pong") != NULL) {
-                log_memory_stats(uart_name);
-                ESP_LOGI(TAG, "[%s] Received pong - board detected!", uart_name);
-                return true;
-            }
-        }
-    }
-    
-    ESP_LOGW(TAG, "[%s] No pong response - board not detected", uart_name);
-    return false;
+    transport_wire_negotiate(ping->tab, ping->port, ping->reply);
+    transport_link_negotiate(ping->tab, ping->port, ping->reply);
 }
 
-// Send ping and wait for pong response using raw UART (bypass USB transport)
-static bool ping_uart_direct(uart_port_t uart_port, const char *uart_name)
+static void detect_boards_negotiate_task(void *arg)
 {
-    uint8_t rx_buffer[64];
-
-    uart_flush(uart_port);
-
-    const char *ping_cmd = "ping\r\n";
-    uart_write_bytes(uart_port, ping_cmd, strlen(ping_cmd));
-    ESP_LOGI(TAG, "[%s] Sent ping (raw)", uart_name);
-
-    int total_len = 0;
-    int64_t start_time = esp_timer_get_time();
-    int64_t timeout_us = 500000;
+    board_ping_t *ping = (board_ping_t *)arg;
+    detect_boards_negotiate(ping);
+    xSemaphoreGive(ping->negotiated);
+    vTaskDelete(NULL);
+}
 
-    while ((esp_timer_get_time() - start_time) < timeout_us) {
-        int len = uart_read_bytes(uart_port, rx_buffer + total_len,
-                                  sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(50));
-        if (len > 0) {
-            total_len += len;
-            rx_buffer[total_len] = '\0';
-            if (strstr((char*)rx_buffer, "pong") != NULL) {
-                log_memory_stats(uart_name);
-                ESP_LOGI(TAG, "[%s] Received pong - board detected!", uart_name);
-                return true;
-            }
+// Runs as each transport answers or times out, fastest first
+static void detect_boards_result_cb(cmd_fanout_target_t *target, void *user)
+{
+    (void)user;
+    board_ping_t *ping = (board_ping_t *)target->ctx;
+    *ping->detected = target->status == CMD_DONE;
+    if (!*ping->detected) {
+        ESP_LOGW(TAG, "[%s] No pong response - board not detected", target->name);
+        if (ping->tab == TAB_USB && usb_debug_logs) {
+            usb_log_cdc_state("detect_boards_usb_ping_failed");
         }
+        return;
     }
-
-    ESP_LOGW(TAG, "[%s] No pong response - board not detected", uart_name);
-    return false;
+    log_memory_stats(target->name);
+    ESP_LOGI(TAG, "[%s] Received pong in %lu ms - board detected!", target->name,
+             (unsigned long)target->elapsed_ms);
 }
 
-// Detect connected boards via ping/pong - 3 independent devices
+// Detect connected boards via ping/pong - 3 independent devices, pinged at once
 static void detect_boards(void)
 {
+    PERF_TRACE_SCOPE("detect_boards");
+    static const char *const pong_markers[] = { "pong", NULL };
+    static board_ping_t pings[3] = {
+        { TAB_GROVE, UART_NUM, &grove_detected },
+        { TAB_USB, UART_NUM, &usb_detected },
+        { TAB_MBUS, UART2_NUM, &mbus_detected },
+    };
+
     ESP_LOGI(TAG, "=== Starting board detection ===");
+    int64_t start_us = esp_timer_get_time();
 
     // Ensure USB CDC host is started before detection
     usb_transport_init();
 
-    // Detect each device independently using ping/pong
-    grove_detected = ping_uart_direct(UART_NUM, "Grove");
-    usb_detected = usb_cdc_connected ? ping_usb() : false;  // Must respond to ping, not just be connected
-    if (usb_cdc_connected && !usb_detected && usb_debug_logs) {
-        usb_log_cdc_state("detect_boards_usb_ping_failed");
+    cmd_fanout_target_t targets[3];
+    size_t count = 0;
+    for (int i = 0; i < 3; i++) {
+        board_ping_t *ping = &pings[i];
+        *ping->detected = false;
+        ping->reply[0] = '\0';
+        // USB must respond to ping, not just be connected
+        if (ping->tab == TAB_USB && !usb_cdc_connected) {
+            continue;
+        }
+        // A board left at a raised rate by an earlier session is back at the default after this
+        transport_link_reset(ping->tab, ping->port);
+        targets[count++] = (cmd_fanout_target_t){
+            .session = transport_session_for_tab(ping->tab, ping->port),
+            .name = tab_transport_name(ping->tab),
+            .out = ping->reply,
+            .out_cap = sizeof(ping->reply),
+            .ctx = ping,
+        };
     }
+
+    cmd_request_t req = {
+        .command = "ping",
+        .end_markers = pong_markers,
+        .timeout_ms = 500,
+    };
+    cmd_fanout_run(&req, targets, count, detect_boards_result_cb, NULL);
     uart1_detected = (grove_detected || usb_detected);  // For legacy compatibility
-    mbus_detected = ping_uart(UART2_NUM, "MBus");
 
-    // Log detection results (ping functions already log success)
-    if (grove_detected) {
-        ESP_LOGI(TAG, "[Grove] Device detected");
+    // Each rate test takes a few hundred ms per rung; the transports climb their ladders side by side
+    SemaphoreHandle_t negotiated = xSemaphoreCreateCounting(3, 0);
+    int negotiating = 0;
+    for (int i = 0; i < 3; i++) {
+        board_ping_t *ping = &pings[i];
+        if (!*ping->detected) {
+            continue;
+        }
+        ping->negotiated = negotiated;
+        if (negotiated && xTaskCreate(detect_boards_negotiate_task, "link_negotiate", 4096, ping, 5, NULL) == pdPASS) {
+            negotiating++;
+        } else {
+            detect_boards_negotiate(ping);
+        }
     }
-    if (mbus_detected) {
-        ESP_LOGI(TAG, "[MBus] Device detected");
+    while (negotiating-- > 0) {
+        xSemaphoreTake(negotiated, portMAX_DELAY);
     }
+    if (negotiated) {
+        vSemaphoreDelete(negotiated);
+    }
+
     if (!grove_detected && !usb_detected && !mbus_detected) {
         ESP_LOGW(TAG, "No devices detected!");
     }
     
-    ESP_LOGI(TAG, "=== Board detection complete: Grove=%s, USB=%s, MBus=%s ===",
+    ESP_LOGI(TAG, "=== Board detection complete in %lld ms: Grove=%s, USB=%s, MBus=%s ===",
+             (long long)((esp_timer_get_time() - start_us) / 1000),
              grove_detected ? "YES" : "NO",
              usb_detected ? "YES" : "NO",
              mbus_detected ? "YES" : "NO");
@@ -19524,6 +20565,10 @@ static bool check_sd_card_for_tab(tab_id_t tab)
     
     ESP_LOGI(TAG, "[%s] Checking SD card presence...", tab_name);
     
+    static const char *const found_markers[] = { "HTML files found on SD card", NULL };
+    static char rx_buffer[512];
+    cmd_session_t *session = transport_session_for_tab(tab, uart_port);
+    
     // Try up to 3 times with 2 second delays between attempts
     for (int attempt = 1; attempt <= 3; attempt++) {
         if (attempt > 1) {
@@ -19531,41 +20576,26 @@ static bool check_sd_card_for_tab(tab_id_t tab)
             vTaskDelay(pdMS_TO_TICKS(2000)); // 2 second delay between retries
         }
         
-        // Send list_sd command
-        const char *cmd = "list_sd\r\n";
-        transport_write_bytes_tab(tab, uart_port, cmd, strlen(cmd));
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        
-        // Read response with timeout (up to 4 seconds, SD init can be slow)
-        static char rx_buffer[512];
-        int total_len = 0;
-        uint32_t start_time = xTaskGetTickCount();
-        uint32_t timeout_ticks = pdMS_TO_TICKS(4000);
-        
-        while ((xTaskGetTickCount() - start_time) < timeout_ticks && total_len < (int)sizeof(rx_buffer) - 1) {
-            int len = transport_read_bytes_tab(tab, uart_port, rx_buffer + total_len, 
-                                               sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(100));
-            if (len > 0) {
-                total_len += len;
-                rx_buffer[total_len] = '\0';
-                ESP_LOGI(TAG, "[%s] Received %d bytes (total: %d): '%.*s'", tab_name, len, total_len, len, rx_buffer + total_len - len);
-                
-                // Check for success or failure patterns
-                if (strstr(rx_buffer, "HTML files found on SD card") != NULL) {
-                    ESP_LOGI(TAG, "[%s] SD card detected (HTML files found) on attempt %d/3", tab_name, attempt);
-                    return true;
-                }
-                if (strstr(rx_buffer, "Failed to initialize SD card") != NULL) {
-                    ESP_LOGW(TAG, "[%s] SD card init failed on attempt %d/3", tab_name, attempt);
-                    ESP_LOGW(TAG, "[%s] Full response buffer (%d bytes): '%s'", tab_name, total_len, rx_buffer);
-                    break; // Try again after delay
-                }
-            }
+        // SD init can be slow; the header line answers the question, the listing isn't needed
+        cmd_request_t req = {
+            .command = "list_sd",
+            .end_markers = found_markers,
+            .fail_markers = sd_fail_markers,
+            .timeout_ms = 5000,
+            .out = rx_buffer,
+            .out_cap = sizeof(rx_buffer),
+        };
+        cmd_status_t status = cmd_session_run(session, &req);
+        if (status == CMD_DONE) {
+            ESP_LOGI(TAG, "[%s] SD card detected (HTML files found) on attempt %d/3", tab_name, attempt);
+            return true;
         }
-        
-        // Timeout without clear response on this attempt
-        ESP_LOGW(TAG, "[%s] SD card check timeout on attempt %d/3", tab_name, attempt);
-        ESP_LOGW(TAG, "[%s] Full response buffer (%d bytes): '%s'", tab_name, total_len, rx_buffer);
+        if (status == CMD_ERROR) {
+            break;
+        }
+        ESP_LOGW(TAG, "[%s] SD card %s on attempt %d/3", tab_name,
+                 status == CMD_FAILED ? "init failed" : "check timeout", attempt);
+        ESP_LOGW(TAG, "[%s] Full response buffer (%u bytes): '%s'", tab_name, (unsigned)strlen(rx_buffer), rx_buffer);
     }
     
     // All 3 attempts failed - assume no SD card
@@ -19576,6 +20606,7 @@ static bool check_sd_card_for_tab(tab_id_t tab)
 // Check SD cards on all detected UARTs and Tab5 internal
 static void check_all_sd_cards(void)
 {
+    PERF_TRACE_SCOPE("check_all_sd_cards");
     ESP_LOGI(TAG, "=== Checking SD cards ===");
     
     // Check each detected UART
@@ -19801,33 +20832,30 @@ static void update_portal_icon(void)
 // ======================= Scan Time Settings =======================
 
 // Helper function to read channel_time value from a specific UART
+static bool line_starts_with_digit(const char *line, void *user)
+{
+    (void)user;
+    while (*line == ' ') line++;
+    return isdigit((unsigned char)*line);
+}
+
 static int read_channel_time_from_uart(uart_port_t uart_port, const char *param)
 {
     char cmd[32];
     snprintf(cmd, sizeof(cmd), "channel_time read %s", param);
     
-    // Flush and send command
-    uart_flush(uart_port);
-    transport_write_bytes(uart_port, cmd, strlen(cmd));
-    transport_write_bytes(uart_port, "\r\n", 2);
-    ESP_LOGI(TAG, "[UART%d] Sent command: %s", uart_port == UART_NUM ? 1 : 2, cmd);
-    
-    // Read response (numeric value expected)
     char rx_buffer[64];
-    int total_len = 0;
-    int retries = 5;
-    
-    while (retries-- > 0 && total_len < (int)sizeof(rx_buffer) - 1) {
-        int len = transport_read_bytes(uart_port, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(100));
-        if (len > 0) {
-            total_len += len;
-        }
-        if (len <= 0 && total_len > 0) break;  // Got data, no more coming
-    }
+    cmd_request_t req = {
+        .command = cmd,
+        .is_last_line = line_starts_with_digit,
+        .timeout_ms = 500,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    ESP_LOGI(TAG, "[UART%d] Sent command: %s", uart_port == UART_NUM ? 1 : 2, cmd);
+    cmd_status_t status = cmd_session_run(transport_session_for_tab(current_tab, uart_port), &req);
     
-    if (total_len > 0) {
-        rx_buffer[total_len] = '\0';
-        
+    if (status == CMD_DONE) {
         // Parse line by line to find the numeric response (skip command echo)
         char *line = strtok(rx_buffer, "\r\n");
         while (line != NULL) {
@@ -19894,15 +20922,14 @@ static void scan_time_save_cb(lv_event_t *e)
         }
         
         // Send to Grove via UART1
-        uart_flush(UART_NUM);
         snprintf(cmd, sizeof(cmd), "channel_time set min %d", min_val);
-        uart_write_bytes(UART_NUM, cmd, strlen(cmd));
-        uart_write_bytes(UART_NUM, "\r\n", 2);
+        transport_write_bytes_tab(TAB_GROVE, UART_NUM, cmd, strlen(cmd));
+        transport_write_bytes_tab(TAB_GROVE, UART_NUM, "\r\n", 2);
         vTaskDelay(pdMS_TO_TICKS(100));
         
         snprintf(cmd, sizeof(cmd), "channel_time set max %d", max_val);
-        uart_write_bytes(UART_NUM, cmd, strlen(cmd));
-        uart_write_bytes(UART_NUM, "\r\n", 2);
+        transport_write_bytes_tab(TAB_GROVE, UART_NUM, cmd, strlen(cmd));
+        transport_write_bytes_tab(TAB_GROVE, UART_NUM, "\r\n", 2);
         
         ESP_LOGI(TAG, "[Grove] Scan time set: min=%d, max=%d", min_val, max_val);
     }
@@ -20206,6 +21233,7 @@ static void invalidate_red_team_dependent_pages(void)
             ctx->dashboard_handshake_value = NULL;
             ctx->dashboard_gps_value = NULL;
             ctx->dashboard_uptime_value = NULL;
+            ctx->dashboard_link_value = NULL;
             ctx->dashboard_sd_status_value = NULL;
             ctx->dashboard_sd_percent_value = NULL;
             ctx->dashboard_wpa_sec_value = NULL;
@@ -20405,6 +21433,7 @@ static void red_team_back_cb(lv_event_t *e)
 // Show Red Team settings page
 static void show_red_team_settings_page(void)
 {
+    UI_PAGE_SCOPE("show_red_team_settings_page");
     if (!internal_container) {
         ESP_LOGE(TAG, "Internal container not initialized!");
         return;
@@ -20629,6 +21658,511 @@ static void show_screen_timeout_popup(void)
     lv_obj_center(close_label);
 }
 
+// Perf Monitor popup variables
+static lv_obj_t *perf_monitor_popup_overlay = NULL;
+static lv_obj_t *perf_monitor_overlay_switch = NULL;
+static lv_obj_t *perf_monitor_log_switch = NULL;
+static lv_obj_t *perf_monitor_bench_label = NULL;
+static lv_obj_t *perf_monitor_buffer_label = NULL;
+static lv_obj_t *perf_monitor_icon_label = NULL;
+static tab_context_t *render_bench_ctx = NULL;
+
+// Bring overlay and CSV log in line with the settings. Display locked.
+static void apply_perf_monitor_settings(void)
+{
+    ui_perf_show_overlay(perf_overlay_enabled);
+
+    if (!perf_log_enabled) {
+        if (ui_perf_logging()) {
+            ui_perf_log_stop();
+        }
+        return;
+    }
+    if (ui_perf_logging()) {
+        return;
+    }
+    if (!ensure_internal_sd_mounted(false) || !ensure_perf_trace_dir()) {
+        ESP_LOGW(TAG, "SD card not mounted, frame log not started");
+        return;
+    }
+    char path[64];
+    format_timestamped_path(path, sizeof(path), PERF_TRACE_DIR, "frames", ".csv");
+    ui_perf_log_start(path);
+}
+
+static void close_perf_monitor_popup(void)
+{
+    if (perf_monitor_popup_overlay) {
+        lv_obj_del(perf_monitor_popup_overlay);
+        perf_monitor_popup_overlay = NULL;
+        perf_monitor_overlay_switch = NULL;
+        perf_monitor_log_switch = NULL;
+        perf_monitor_bench_label = NULL;
+        perf_monitor_buffer_label = NULL;
+        perf_monitor_icon_label = NULL;
+    }
+}
+
+static bool perf_monitor_any_bench_running(void)
+{
+    return render_bench_running() || buffer_bench_running() || theme_icons_bench_running();
+}
+
+// Render benchmark scene: the device tab's tile grid and live dashboard, covering the screen
+static lv_obj_t *create_render_bench_scene(void)
+{
+    // The dashboard binds its labels to a tab context; give it one of its own
+    render_bench_ctx = heap_caps_calloc(1, sizeof(*render_bench_ctx), MALLOC_CAP_SPIRAM);
+    if (!render_bench_ctx) {
+        return NULL;
+    }
+
+    lv_obj_t *scene = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(scene, lv_pct(100), lv_pct(100));
+    ui_theme_apply_page(scene);
+    lv_obj_set_style_bg_color(scene, UI_SURFACE_0, 0);
+    lv_obj_set_style_bg_opa(scene, LV_OPA_COVER, 0);
+    lv_obj_set_style_pad_all(scene, 16, 0);
+    lv_obj_set_style_pad_row(scene, 12, 0);
+    lv_obj_set_flex_flow(scene, LV_FLEX_FLOW_COLUMN);
+    lv_obj_clear_flag(scene, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(scene, LV_OBJ_FLAG_CLICKABLE);     // keep touches off the page underneath
+
+    lv_obj_t *tiles_grid = create_uniform_tile_grid(scene, false);
+    lv_coord_t tile_width = uniform_tile_width_for_columns(3, 16);
+    const struct {
+        const char *icon;
+        const char *text;
+    } tiles[UART_MAIN_TILE_COUNT] = {
+        { LV_SYMBOL_WIFI, "WiFi Scan\n& Attack" },
+        { LV_SYMBOL_WARNING, "Global WiFi\nAttacks" },
+        { LV_SYMBOL_DIRECTORY, "Compromised\nData" },
+        { LV_SYMBOL_EYE_OPEN, "Deauth\nDetector" },
+        { LV_SYMBOL_BLUETOOTH, "Bluetooth" },
+        { LV_SYMBOL_EYE_OPEN, "Network\nObserver" },
+        { LV_SYMBOL_REFRESH, "Karma" },
+    };
+    const lv_color_t colors[UART_MAIN_TILE_COUNT] = {
+        COLOR_MATERIAL_BLUE, COLOR_MATERIAL_RED, COLOR_MATERIAL_GREEN, COLOR_MATERIAL_AMBER,
+        COLOR_MATERIAL_CYAN, COLOR_MATERIAL_TEAL, COLOR_MATERIAL_ORANGE,
+    };
+    for (size_t i = 0; i < UART_MAIN_TILE_COUNT; i++) {
+        lv_obj_t *tile = create_tile(tiles_grid, tiles[i].icon, tiles[i].text, colors[i], NULL, NULL);
+        lv_obj_set_size(tile, tile_width, 182);
+    }
+
+    lv_obj_t *spacer = lv_obj_create(scene);
+    lv_obj_remove_style_all(spacer);
+    lv_obj_set_size(spacer, lv_pct(100), 1);
+    lv_obj_set_flex_grow(spacer, 1);
+
+    lv_obj_t *dashboard_panel = create_live_dashboard_panel(scene, render_bench_ctx);
+    if (dashboard_panel) {
+        lv_obj_set_width(dashboard_panel, lv_pct(100));
+    }
+    lv_obj_update_layout(scene);
+    return scene;
+}
+
+static void render_bench_done(lv_obj_t *scene, const render_bench_result_t *result, void *user)
+{
+    (void)user;
+    if (scene) {
+        lv_obj_del(scene);
+    }
+    free(render_bench_ctx);
+    render_bench_ctx = NULL;
+    render_bench_log(result);
+
+    if (!perf_monitor_bench_label) {
+        return;
+    }
+    const render_bench_run_t *single = &result->runs[0];
+    const render_bench_run_t *tiled = &result->runs[result->run_count - 1];
+    if (result->run_count < 2) {
+        lv_label_set_text_fmt(perf_monitor_bench_label, "Render %lu.%lu ms/frame (one draw thread)",
+                              (unsigned long)(single->render_avg_us / 1000),
+                              (unsigned long)(single->render_avg_us / 100 % 10));
+        return;
+    }
+    lv_label_set_text_fmt(perf_monitor_bench_label, "Render %lu.%lu ms -> %lu.%lu ms on %lu tiles: %lu.%02lux%s",
+                          (unsigned long)(single->render_avg_us / 1000), (unsigned long)(single->render_avg_us / 100 % 10),
+                          (unsigned long)(tiled->render_avg_us / 1000), (unsigned long)(tiled->render_avg_us / 100 % 10),
+                          (unsigned long)tiled->tiles, (unsigned long)(result->speedup_x100 / 100),
+                          (unsigned long)(result->speedup_x100 % 100),
+                          result->output_matches ? "" : "\nTiled output differs!");
+}
+
+static void perf_monitor_bench_cb(lv_event_t *e)
+{
+    (void)e;
+    if (perf_monitor_any_bench_running()) {
+        return;
+    }
+    lv_obj_t *scene = create_render_bench_scene();
+    if (!scene || !render_bench_start(lv_display_get_default(), scene, render_bench_done, NULL)) {
+        if (scene) {
+            lv_obj_del(scene);
+        }
+        free(render_bench_ctx);
+        render_bench_ctx = NULL;
+        return;
+    }
+    if (perf_monitor_bench_label) {
+        lv_label_set_text(perf_monitor_bench_label, "Running...");
+    }
+}
+
+// Buffer benchmark scene: a settings-style list page, taller than the screen so it scrolls
+static lv_obj_t *create_buffer_bench_scene(void)
+{
+    lv_obj_t *scene = ui_comp_create_page(lv_layer_top());
+    lv_obj_set_style_bg_opa(scene, LV_OPA_COVER, 0);
+    lv_obj_add_flag(scene, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(scene, LV_DIR_VER);
+    lv_obj_add_flag(scene, LV_OBJ_FLAG_CLICKABLE);     // keep touches off the page underneath
+
+    ui_comp_create_app_bar(scene, "Buffer benchmark", NULL, NULL, NULL);
+    static const struct {
+        const char *symbol;
+        const char *title;
+        const char *subtitle;
+    } rows[] = {
+        { LV_SYMBOL_WIFI, "WiFi Scan & Attack", "Networks, clients and attacks" },
+        { LV_SYMBOL_WARNING, "Global WiFi Attacks", "Blackout, handshaker, SnifferDog" },
+        { LV_SYMBOL_DIRECTORY, "Compromised Data", "Handshakes, passwords, portals" },
+        { LV_SYMBOL_EYE_OPEN, "Deauth Detector", "Watch for deauth frames" },
+        { LV_SYMBOL_BLUETOOTH, "Bluetooth", "Scan and locate devices" },
+        { LV_SYMBOL_SETTINGS, "Settings", "Screen, time, boards" },
+    };
+    for (int i = 0; i < 5; i++) {
+        for (size_t j = 0; j < sizeof(rows) / sizeof(rows[0]); j++) {
+            ui_comp_create_list_row(scene, rows[j].title, rows[j].subtitle, rows[j].symbol, NULL, NULL);
+        }
+    }
+    lv_obj_update_layout(scene);
+    return scene;
+}
+
+// Buffer benchmark popup: the usual confirm dialog
+static lv_obj_t *open_buffer_bench_popup(lv_obj_t *parent, void *user)
+{
+    (void)user;
+    lv_obj_t *overlay = NULL;
+    lv_obj_t *dialog = NULL;
+    ui_comp_create_modal(parent, 560, 340, &overlay, &dialog);
+
+    lv_obj_t *title = lv_label_create(dialog);
+    lv_label_set_text(title, LV_SYMBOL_WARNING " Start attack?");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
+    lv_obj_set_style_text_color(title, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
+
+    lv_obj_t *body = lv_label_create(dialog);
+    lv_label_set_text(body, "Clients of the selected networks will be disconnected until you stop the attack.");
+    lv_label_set_long_mode(body, LV_LABEL_LONG_WRAP);
+    lv_obj_set_width(body, lv_pct(100));
+    lv_obj_set_style_text_font(body, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(body, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+
+    lv_obj_t *buttons = lv_obj_create(dialog);
+    lv_obj_remove_style_all(buttons);
+    lv_obj_set_size(buttons, lv_pct(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(buttons, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(buttons, LV_FLEX_ALIGN_END, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(buttons, 16, 0);
+    ui_comp_create_secondary_button(buttons, "Cancel", NULL, NULL);
+    ui_comp_create_danger_button(buttons, "Start", NULL, NULL);
+    return overlay;
+}
+
+static void buffer_bench_done(lv_obj_t *scene, const buffer_bench_result_t *result, void *user)
+{
+    (void)user;
+    if (scene) {
+        lv_obj_del(scene);
+    }
+    buffer_bench_log(result);
+
+    if (!perf_monitor_buffer_label) {
+        return;
+    }
+    if (result->fastest < 0) {
+        lv_label_set_text(perf_monitor_buffer_label, "No buffer layout finished");
+        return;
+    }
+    const buffer_bench_run_t *fastest = &result->runs[result->fastest];
+    char name[32];
+    buffer_bench_layout_name(&fastest->layout, name, sizeof(name));
+    if (result->boot < 0 || result->boot == result->fastest) {
+        lv_label_set_text_fmt(perf_monitor_buffer_label, "Fastest: %s (redraw %lu.%lu ms)", name,
+                              (unsigned long)(fastest->redraw.avg_us / 1000),
+                              (unsigned long)(fastest->redraw.avg_us / 100 % 10));
+        return;
+    }
+    const buffer_bench_run_t *boot = &result->runs[result->boot];
+    lv_label_set_text_fmt(perf_monitor_buffer_label, "Fastest: %s\nredraw %lu -> %lu, scroll %lu -> %lu, popup %lu -> %lu ms",
+                          name, (unsigned long)(boot->redraw.avg_us / 1000), (unsigned long)(fastest->redraw.avg_us / 1000),
+                          (unsigned long)(boot->scroll.avg_us / 1000), (unsigned long)(fastest->scroll.avg_us / 1000),
+                          (unsigned long)(boot->popup.avg_us / 1000), (unsigned long)(fastest->popup.avg_us / 1000));
+}
+
+static void perf_monitor_buffer_bench_cb(lv_event_t *e)
+{
+    (void)e;
+    if (perf_monitor_any_bench_running()) {
+        return;
+    }
+    lv_obj_t *scene = create_buffer_bench_scene();
+    buffer_bench_cfg_t cfg = {
+        .scene = scene,
+        .scroll_obj = scene,
+        .open_popup = open_buffer_bench_popup,
+        .done = buffer_bench_done,
+    };
+    if (!buffer_bench_start(lv_display_get_default(), &cfg)) {
+        lv_obj_del(scene);
+        if (perf_monitor_buffer_label) {
+            lv_label_set_text(perf_monitor_buffer_label, "Draw buffers can't be swapped on this display");
+        }
+        return;
+    }
+    if (perf_monitor_buffer_label) {
+        lv_label_set_text(perf_monitor_buffer_label, "Running...");
+    }
+}
+
+// Icon benchmark: the render benchmark scene with its tiles showing the active theme's icons
+static void icon_bench_mode(lv_obj_t *scene, bool atlas, void *user)
+{
+    (void)user;
+    theme_icon_atlas_enabled = atlas;
+    lv_obj_t *tiles_grid = lv_obj_get_child(scene, 0);
+    for (size_t i = 0; i < UART_MAIN_TILE_COUNT; i++) {
+        rebuild_tile_icon_widget(lv_obj_get_child(tiles_grid, (int32_t)i), false, i);
+    }
+}
+
+static void icon_bench_done(lv_obj_t *scene, const theme_icons_bench_result_t *result, void *user)
+{
+    (void)user;
+    theme_icon_atlas_enabled = true;
+    if (scene) {
+        lv_obj_del(scene);
+    }
+    free(render_bench_ctx);
+    render_bench_ctx = NULL;
+    theme_icons_bench_log(result);
+
+    if (!perf_monitor_icon_label) {
+        return;
+    }
+    const theme_icons_bench_run_t *files = &result->runs[0];
+    const theme_icons_bench_run_t *atlas = &result->runs[1];
+    uint32_t files_frames = files->frames ? files->frames : 1;
+    uint32_t atlas_frames = atlas->frames ? atlas->frames : 1;
+    lv_label_set_text_fmt(perf_monitor_icon_label, "Redraw %lu.%lu -> %lu.%lu ms, SD reads %lu -> %lu/frame: %lu.%02lux",
+                          (unsigned long)(files->redraw_avg_us / 1000), (unsigned long)(files->redraw_avg_us / 100 % 10),
+                          (unsigned long)(atlas->redraw_avg_us / 1000), (unsigned long)(atlas->redraw_avg_us / 100 % 10),
+                          (unsigned long)(files->io.reads / files_frames), (unsigned long)(atlas->io.reads / atlas_frames),
+                          (unsigned long)(result->speedup_x100 / 100), (unsigned long)(result->speedup_x100 % 100));
+}
+
+static void perf_monitor_icon_bench_cb(lv_event_t *e)
+{
+    (void)e;
+    if (perf_monitor_any_bench_running()) {
+        return;
+    }
+    bool any_icon = false;
+    for (size_t i = 0; i < UART_MAIN_TILE_COUNT && !any_icon; i++) {
+        const char *path = active_theme_icon_path_for_tile(false, i);
+        any_icon = path && path[0] != '\0';
+    }
+    if (!any_icon) {
+        if (perf_monitor_icon_label) {
+            lv_label_set_text(perf_monitor_icon_label, "The active theme has no tile icons");
+        }
+        return;
+    }
+
+#if CONFIG_LV_FS_DEFAULT_DRIVER_LETTER > 0
+    theme_icons_io_hook((char)CONFIG_LV_FS_DEFAULT_DRIVER_LETTER);
+#endif
+    lv_obj_t *scene = create_render_bench_scene();
+    if (!scene || !theme_icons_bench_start(lv_display_get_default(), scene, icon_bench_mode, icon_bench_done, NULL)) {
+        if (scene) {
+            lv_obj_del(scene);
+        }
+        free(render_bench_ctx);
+        render_bench_ctx = NULL;
+        return;
+    }
+    if (perf_monitor_icon_label) {
+        lv_label_set_text(perf_monitor_icon_label, "Running...");
+    }
+}
+
+static void perf_monitor_switch_cb(lv_event_t *e)
+{
+    lv_obj_t *sw = lv_event_get_target(e);
+    bool on = lv_obj_has_state(sw, LV_STATE_CHECKED);
+    if (sw == perf_monitor_overlay_switch) {
+        perf_overlay_enabled = on;
+    } else if (sw == perf_monitor_log_switch) {
+        perf_log_enabled = on;
+    }
+    save_perf_monitor_to_nvs();
+    apply_perf_monitor_settings();
+
+    // Starting the log can fail without SD; show what actually happened
+    if (sw == perf_monitor_log_switch && on && !ui_perf_logging()) {
+        lv_obj_remove_state(sw, LV_STATE_CHECKED);
+    }
+}
+
+static void perf_monitor_close_cb(lv_event_t *e)
+{
+    (void)e;
+    close_perf_monitor_popup();
+}
+
+static lv_obj_t *perf_monitor_switch_row(lv_obj_t *parent, const char *text, bool on)
+{
+    lv_obj_t *row = lv_obj_create(parent);
+    lv_obj_remove_style_all(row);
+    lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *label = lv_label_create(row);
+    lv_label_set_text(label, text);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(label, ui_theme_color(UI_COLOR_TEXT_PRIMARY), 0);
+
+    lv_obj_t *sw = lv_switch_create(row);
+    lv_obj_set_size(sw, 60, 30);
+    if (on) {
+        lv_obj_add_state(sw, LV_STATE_CHECKED);
+    }
+    lv_obj_add_event_cb(sw, perf_monitor_switch_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    return sw;
+}
+
+// Show Perf Monitor popup: frame-time overlay and CSV log to SD
+static void show_perf_monitor_popup(void)
+{
+    lv_obj_t *container = get_current_tab_container();
+    if (!container) return;
+
+    // Create modal overlay
+    perf_monitor_popup_overlay = lv_obj_create(container);
+    lv_obj_remove_style_all(perf_monitor_popup_overlay);
+    lv_obj_set_size(perf_monitor_popup_overlay, lv_pct(100), lv_pct(100));
+    lv_obj_set_style_bg_color(perf_monitor_popup_overlay, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(perf_monitor_popup_overlay, LV_OPA_50, 0);
+    lv_obj_clear_flag(perf_monitor_popup_overlay, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(perf_monitor_popup_overlay, LV_OBJ_FLAG_CLICKABLE);
+
+    // Create popup
+    lv_obj_t *popup = lv_obj_create(perf_monitor_popup_overlay);
+    lv_obj_set_size(popup, 380, 620);
+    lv_obj_center(popup);
+    lv_obj_set_style_bg_color(popup, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_border_color(popup, COLOR_MATERIAL_BLUE, 0);
+    lv_obj_set_style_border_width(popup, 2, 0);
+    lv_obj_set_style_radius(popup, 12, 0);
+    lv_obj_set_style_pad_all(popup, 20, 0);
+    lv_obj_set_flex_flow(popup, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(popup, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_row(popup, 15, 0);
+    lv_obj_clear_flag(popup, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Title
+    lv_obj_t *title = lv_label_create(popup);
+    lv_label_set_text(title, "Perf Monitor");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
+    lv_obj_set_style_text_color(title, COLOR_MATERIAL_BLUE, 0);
+
+    perf_monitor_overlay_switch = perf_monitor_switch_row(popup, "Frame time overlay", perf_overlay_enabled);
+    perf_monitor_log_switch = perf_monitor_switch_row(popup, "Log to SD (" PERF_TRACE_DIR ")", ui_perf_logging());
+
+    // Render benchmark: tile grid and dashboard drawn on one tile vs one per draw thread
+    lv_obj_t *bench_btn = lv_btn_create(popup);
+    lv_obj_set_size(bench_btn, 220, 40);
+    lv_obj_set_style_bg_color(bench_btn, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+    lv_obj_add_event_cb(bench_btn, perf_monitor_bench_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *bench_btn_label = lv_label_create(bench_btn);
+    lv_label_set_text(bench_btn_label, LV_SYMBOL_PLAY " Render benchmark");
+    lv_obj_set_style_text_font(bench_btn_label, &lv_font_montserrat_16, 0);
+    lv_obj_center(bench_btn_label);
+
+    perf_monitor_bench_label = lv_label_create(popup);
+    lv_label_set_text_fmt(perf_monitor_bench_label, "%u draw threads", (unsigned)render_cores_worker_count());
+    lv_obj_set_width(perf_monitor_bench_label, lv_pct(100));
+    lv_label_set_long_mode(perf_monitor_bench_label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(perf_monitor_bench_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_font(perf_monitor_bench_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(perf_monitor_bench_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+
+    // Buffer benchmark: redraw, scroll and popup-open times per draw buffer layout
+    lv_obj_t *buffer_btn = lv_btn_create(popup);
+    lv_obj_set_size(buffer_btn, 220, 40);
+    lv_obj_set_style_bg_color(buffer_btn, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+    lv_obj_add_event_cb(buffer_btn, perf_monitor_buffer_bench_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *buffer_btn_label = lv_label_create(buffer_btn);
+    lv_label_set_text(buffer_btn_label, LV_SYMBOL_PLAY " Buffer benchmark");
+    lv_obj_set_style_text_font(buffer_btn_label, &lv_font_montserrat_16, 0);
+    lv_obj_center(buffer_btn_label);
+
+    perf_monitor_buffer_label = lv_label_create(popup);
+    lvgl_port_disp_buffers_t buffers;
+    if (lvgl_port_disp_get_buffers(lv_display_get_default(), &buffers) == ESP_OK) {
+        lv_label_set_text_fmt(perf_monitor_buffer_label, "Draw buffer: %lu lines x%d %s",
+                              (unsigned long)(buffers.buffer_size / BSP_LCD_H_RES), buffers.double_buffer ? 2 : 1,
+                              (buffers.caps & MALLOC_CAP_SPIRAM) ? "PSRAM" : "internal");
+    } else {
+        lv_label_set_text(perf_monitor_buffer_label, "");
+    }
+    lv_obj_set_width(perf_monitor_buffer_label, lv_pct(100));
+    lv_label_set_long_mode(perf_monitor_buffer_label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(perf_monitor_buffer_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_font(perf_monitor_buffer_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(perf_monitor_buffer_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+
+    // Icon benchmark: theme tile icons from their files vs from the atlas
+    lv_obj_t *icon_btn = lv_btn_create(popup);
+    lv_obj_set_size(icon_btn, 220, 40);
+    lv_obj_set_style_bg_color(icon_btn, ui_theme_color(UI_COLOR_SURFACE_ALT), 0);
+    lv_obj_add_event_cb(icon_btn, perf_monitor_icon_bench_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *icon_btn_label = lv_label_create(icon_btn);
+    lv_label_set_text(icon_btn_label, LV_SYMBOL_PLAY " Icon benchmark");
+    lv_obj_set_style_text_font(icon_btn_label, &lv_font_montserrat_16, 0);
+    lv_obj_center(icon_btn_label);
+
+    perf_monitor_icon_label = lv_label_create(popup);
+    lv_label_set_text_fmt(perf_monitor_icon_label, "Icon atlas: %u KB", (unsigned)(theme_icons_atlas_bytes() / 1024));
+    lv_obj_set_width(perf_monitor_icon_label, lv_pct(100));
+    lv_label_set_long_mode(perf_monitor_icon_label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(perf_monitor_icon_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_font(perf_monitor_icon_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(perf_monitor_icon_label, ui_theme_color(UI_COLOR_TEXT_SECONDARY), 0);
+
+    // Close button
+    lv_obj_t *close_btn = lv_btn_create(popup);
+    lv_obj_set_size(close_btn, 100, 40);
+    lv_obj_set_style_bg_color(close_btn, COLOR_MATERIAL_BLUE, 0);
+    lv_obj_add_event_cb(close_btn, perf_monitor_close_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *close_label = lv_label_create(close_btn);
+    lv_label_set_text(close_label, "Close");
+    lv_obj_set_style_text_font(close_label, &lv_font_montserrat_16, 0);
+    lv_obj_center(close_label);
+}
+
 // Close Screen Brightness popup
 static void close_screen_brightness_popup(void)
 {
@@ -20808,6 +22342,7 @@ static void theme_reset_default_cb(lv_event_t *e)
 
 static void show_theme_page(void)
 {
+    UI_PAGE_SCOPE("show_theme_page");
     show_theme_popup();
 }
 
@@ -20980,12 +22515,15 @@ static void settings_tile_event_cb(lv_event_t *e)
         show_screen_brightness_popup();
     } else if (strcmp(tile_name, "Theme") == 0) {
         show_theme_page();
+    } else if (strcmp(tile_name, "Perf Monitor") == 0) {
+        show_perf_monitor_popup();
     }
 }
 
 // Show Settings page (inside INTERNAL container)
 static void show_settings_page(void)
 {
+    UI_PAGE_SCOPE("show_settings_page");
     if (!internal_container) {
         ESP_LOGE(TAG, "Internal container not initialized!");
         return;
@@ -21055,32 +22593,81 @@ static void show_settings_page(void)
     lv_obj_set_size(tile, tile_width, 182);
     tile = create_tile(tiles, LV_SYMBOL_IMAGE, "Theme", COLOR_MATERIAL_PURPLE, settings_tile_event_cb, "Theme");
     lv_obj_set_size(tile, tile_width, 182);
+    tile = create_tile(tiles, LV_SYMBOL_CHARGE, "Perf\nMonitor", COLOR_MATERIAL_BLUE, settings_tile_event_cb, "Perf Monitor");
+    lv_obj_set_size(tile, tile_width, 182);
 }
 
-void app_main(void)
+//==================================================================================
+// Boot
+//==================================================================================
+
+// Stages of app_main's bring-up; boot_stages.c has their names and dependencies,
+// boot_init runs each as soon as the ones it needs are done
+
+static lv_display_t *boot_display = NULL;
+
+static bool boot_nvs(void)
 {
-    ESP_LOGI(TAG, "M5Stack Tab5 WiFi Scanner");
-    
-    // Initialize NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         ESP_ERROR_CHECK(nvs_flash_erase());
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
-    
+    return true;
+}
+
+static bool boot_i2c(void)
+{
+    // I2C first, the IO expander (and touch) sit on it
+    ESP_ERROR_CHECK(bsp_i2c_init());
+    bsp_io_expander_pi4ioe_init(bsp_i2c_get_handle());
+    return true;
+}
+
+static bool boot_display_start(void)
+{
+    {
+        PERF_TRACE_SCOPE("bsp_display_start");
+        boot_display = bsp_display_start();
+    }
+    if (boot_display == NULL) {
+        ESP_LOGE(TAG, "Failed to initialize display");
+        return false;
+    }
+
+    // Frame-time instrumentation for the LVGL task, and the queue workers post UI updates to
+    ui_perf_lock(0);
+    ui_timing_init(boot_display);
+    ui_cmd_init();
+    ui_perf_unlock();
+    render_cores_log();
+    return true;
+}
+
+static bool boot_sdcard(void)
+{
+    ESP_LOGI(TAG, "Initializing SD card...");
+    esp_err_t ret = bsp_sdcard_init(CONFIG_BSP_SD_MOUNT_POINT, 5);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "SD card initialization failed: %s (captive portal HTML files won't be available)", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "SD card mounted at %s", CONFIG_BSP_SD_MOUNT_POINT);
+    }
+    return true;    // everything that reads SD copes without it
+}
+
+static bool boot_usb_host(void)
+{
+    usb_transport_init();
+    return true;
+}
+
+static bool boot_contexts(void)
+{
     // Initialize all tab contexts with PSRAM allocations
     init_all_tab_contexts();
     
-    // Legacy observer buffers (shared between tabs for UART I/O)
-    observer_networks = heap_caps_calloc(MAX_OBSERVER_NETWORKS, sizeof(observer_network_t), MALLOC_CAP_SPIRAM);
-    observer_rx_buffer = heap_caps_malloc(UART_BUF_SIZE, MALLOC_CAP_SPIRAM);
-    observer_line_buffer = heap_caps_malloc(OBSERVER_LINE_BUFFER_SIZE, MALLOC_CAP_SPIRAM);
-    
-    if (!observer_networks || !observer_rx_buffer || !observer_line_buffer) {
-        ESP_LOGE(TAG, "Failed to allocate legacy observer PSRAM buffers!");
-    }
-    
     // Allocate buffer for ESP Modem WiFi scan results
     ESP_LOGI(TAG, "Allocating ESP Modem buffers in PSRAM...");
     esp_modem_networks = heap_caps_calloc(ESP_MODEM_MAX_NETWORKS, sizeof(wifi_ap_record_t), MALLOC_CAP_SPIRAM);
@@ -21089,43 +22676,80 @@ void app_main(void)
     } else {
         ESP_LOGI(TAG, "ESP Modem PSRAM buffer allocated successfully");
     }
+    return true;
+}
+
+static bool boot_transports(void)
+{
+    // Initialize both UARTs for board detection
+    // UART1: Grove (TX=53, RX=54) - always initialized
+    // MBus port: M5Bus connector (TX=37, RX=38)
+    uart_init();   // Initialize UART1
+    init_uart2();  // Initialize MBus port (UART2)
     
-    // Initialize I2C (required for IO expander)
-    ESP_ERROR_CHECK(bsp_i2c_init());
-    
-    // Initialize IO expander
-    bsp_io_expander_pi4ioe_init(bsp_i2c_get_handle());
-    
-    // Initialize SD card
-    ESP_LOGI(TAG, "Initializing SD card...");
-    ret = bsp_sdcard_init(CONFIG_BSP_SD_MOUNT_POINT, 5);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "SD card initialization failed: %s (captive portal HTML files won't be available)", esp_err_to_name(ret));
-    } else {
-        ESP_LOGI(TAG, "SD card mounted at %s", CONFIG_BSP_SD_MOUNT_POINT);
-    }
-    
-    // Enable battery charging
+    // Start per-transport RX reader tasks (all serial input goes through them)
+    transport_rx_init();
+    load_transport_trace_level_from_nvs();
+
+    // Worker for dashboard counts that need SD or transport I/O
+    dashboard_io_init();
+    return true;
+}
+
+static bool boot_charging(void)
+{
     ESP_LOGI(TAG, "Enabling battery charging...");
     bsp_set_charge_en(true);
     bsp_set_charge_qc_en(true);
-    
+    return true;
+}
+
+static bool boot_settings(void)
+{
     // Load Red Team setting from NVS (hardware config is now auto-detected)
     load_red_team_from_nvs();
     
-    // Load screen settings from NVS (timeout and brightness)
+    // Load screen settings from NVS (timeout, brightness and the active theme)
     load_screen_settings_from_nvs();
+    load_perf_monitor_from_nvs();
+    return true;
+}
+
+static bool boot_detection(void)
+{
+    // Runs behind the splash; the splash hands over once it's done
+    if (xTaskCreate(boot_detection_task, "boot_detect", 8192, NULL, 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start board detection");
+        boot_detection_done = true;
+    }
+    return true;
+}
+
+static const boot_stage_fn_t app_boot_stage_fns[BOOT_STAGE_COUNT] = {
+    [BOOT_NVS]        = boot_nvs,
+    [BOOT_I2C]        = boot_i2c,
+    [BOOT_DISPLAY]    = boot_display_start,
+    [BOOT_SDCARD]     = boot_sdcard,
+    [BOOT_USB_HOST]   = boot_usb_host,
+    [BOOT_CONTEXTS]   = boot_contexts,
+    [BOOT_TRANSPORTS] = boot_transports,
+    [BOOT_CHARGING]   = boot_charging,
+    [BOOT_SETTINGS]   = boot_settings,
+    [BOOT_DETECTION]  = boot_detection,
+};
+
+static boot_stage_t app_boot_stages[BOOT_STAGE_COUNT];
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "M5Stack Tab5 WiFi Scanner");
+    perf_trace_init();
     
-    // Initialize both UARTs for board detection
-    // UART1: Grove (TX=53, RX=54) - always initialized
-    // MBus port: M5Bus connector (TX=37, RX=38)
-    uart_init();   // Initialize UART1
-    init_uart2();  // Initialize MBus port (UART2)
-    
-    // Initialize display
-    lv_display_t *disp = bsp_display_start();
-    if (disp == NULL) {
-        ESP_LOGE(TAG, "Failed to initialize display");
+    boot_stages_init(app_boot_stages, app_boot_stage_fns);
+    boot_init_run(app_boot_stages, BOOT_STAGE_COUNT);
+    boot_init_log(app_boot_stages, BOOT_STAGE_COUNT);
+    lv_display_t *disp = boot_display;
+    if (app_boot_stages[BOOT_DISPLAY].state != BOOT_STAGE_DONE || disp == NULL) {
         return;
     }
 
@@ -21152,9 +22776,13 @@ void app_main(void)
     screen_timeout_timer = lv_timer_create(screen_timeout_timer_cb, SCREEN_CHECK_INTERVAL, NULL);
     
     // Show splash screen with animation (will transition to main tiles when done)
-    bsp_display_lock(0);
-    show_splash_screen();
-    bsp_display_unlock();
+    ui_perf_lock(0);
+    apply_perf_monitor_settings();
+    {
+        PERF_TRACE_SCOPE("show_splash_screen");
+        show_splash_screen();
+    }
+    ui_perf_unlock();
     
     ESP_LOGI(TAG, "Application started. Ready to scan.");
 }
@@ -0,0 +1,308 @@
+#include "observer_store.h"
+
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "observer_store";
+
+static uint32_t next_pow2(uint32_t v)
+{
+    uint32_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Fibonacci hashing: the high bits of the product mix every input bit
+static uint32_t hash_key(uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static uint32_t hash_ssid(const char *ssid)
+{
+    uint32_t h = 2166136261u;  // FNV-1a
+    while (*ssid) {
+        h ^= (uint8_t)*ssid++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint64_t client_key(int network, const mac48_t *mac)
+{
+    return mac48_to_u64(mac) | ((uint64_t)(uint16_t)network << 48);
+}
+
+static void slot_insert16(uint16_t *slots, uint32_t mask, uint32_t hash, uint16_t value)
+{
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint32_t slot = (hash + probe) & mask;
+        if (slots[slot] == 0) {
+            slots[slot] = value;
+            return;
+        }
+    }
+}
+
+// Backward-shift delete: later entries of the probe run move up so no lookup stops early at the hole
+static void ssid_slot_remove(observer_store_t *store, const char *ssid, uint16_t value)
+{
+    uint16_t *slots = store->ssid_slots;
+    uint32_t mask = store->network_slot_mask;
+    uint32_t hash = hash_ssid(ssid);
+    uint32_t hole = 0;
+    uint32_t probe;
+    for (probe = 0; probe <= mask; probe++) {
+        hole = (hash + probe) & mask;
+        if (slots[hole] == value) {
+            break;
+        }
+        if (slots[hole] == 0) {
+            return;
+        }
+    }
+    if (probe > mask) {
+        return;
+    }
+
+    for (uint32_t slot = (hole + 1) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+        uint32_t home = hash_ssid(store->networks[slots[slot] - 1].ssid) & mask;
+        // Entries whose home lies cyclically in (hole, slot] must stay where they are
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole] = 0;
+}
+
+bool observer_store_init(observer_store_t *store, int max_networks, uint32_t max_clients)
+{
+    if (!store || max_networks <= 0 || max_networks >= UINT16_MAX || max_clients == 0) {
+        return false;
+    }
+
+    memset(store, 0, sizeof(*store));
+    store->max_networks = max_networks;
+    store->max_clients = max_clients;
+
+    // Tables at most half full keep linear probe chains short
+    uint32_t network_slots = next_pow2((uint32_t)max_networks * 2);
+    uint32_t client_slots = next_pow2(max_clients * 2);
+    store->network_slot_mask = network_slots - 1;
+    store->client_slot_mask = client_slots - 1;
+
+    store->networks = heap_caps_calloc(max_networks, sizeof(observer_network_t), MALLOC_CAP_SPIRAM);
+    store->bssid_slots = heap_caps_calloc(network_slots, sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    store->ssid_slots = heap_caps_calloc(network_slots, sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    store->clients = heap_caps_calloc(max_clients, sizeof(observer_client_t), MALLOC_CAP_SPIRAM);
+    store->client_slots = heap_caps_calloc(client_slots, sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+    if (!store->networks || !store->bssid_slots || !store->ssid_slots || !store->clients || !store->client_slots) {
+        ESP_LOGE(TAG, "Failed to allocate store (%d networks, %u clients)",
+                 max_networks, (unsigned)max_clients);
+        observer_store_free(store);
+        return false;
+    }
+    return true;
+}
+
+void observer_store_free(observer_store_t *store)
+{
+    if (!store) {
+        return;
+    }
+    heap_caps_free(store->networks);
+    heap_caps_free(store->bssid_slots);
+    heap_caps_free(store->ssid_slots);
+    heap_caps_free(store->clients);
+    heap_caps_free(store->client_slots);
+    memset(store, 0, sizeof(*store));
+}
+
+void observer_store_clear(observer_store_t *store)
+{
+    if (!store || !store->networks) {
+        return;
+    }
+    memset(store->bssid_slots, 0, (store->network_slot_mask + 1) * sizeof(uint16_t));
+    memset(store->ssid_slots, 0, (store->network_slot_mask + 1) * sizeof(uint16_t));
+    memset(store->client_slots, 0, (store->client_slot_mask + 1) * sizeof(uint32_t));
+    store->network_count = 0;
+    store->client_count = 0;
+    store->dropped_clients = 0;
+}
+
+int observer_store_find_bssid(const observer_store_t *store, const mac48_t *bssid)
+{
+    if (!store || !store->networks || !bssid) {
+        return -1;
+    }
+
+    uint32_t mask = store->network_slot_mask;
+    uint32_t hash = hash_key(mac48_to_u64(bssid));
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint16_t value = store->bssid_slots[(hash + probe) & mask];
+        if (value == 0) {
+            break;
+        }
+        if (mac48_equal(&store->networks[value - 1].bssid, bssid)) {
+            return value - 1;
+        }
+    }
+    return -1;
+}
+
+int observer_store_find_ssid(const observer_store_t *store, const char *ssid, int channel)
+{
+    if (!store || !store->networks || !ssid) {
+        return -1;
+    }
+
+    // Duplicate SSIDs sit in consecutive probe slots; keep walking to find the one on this channel
+    int first_match = -1;
+    uint32_t mask = store->network_slot_mask;
+    uint32_t hash = hash_ssid(ssid);
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint16_t value = store->ssid_slots[(hash + probe) & mask];
+        if (value == 0) {
+            break;
+        }
+        const observer_network_t *net = &store->networks[value - 1];
+        if (strcmp(net->ssid, ssid) != 0) {
+            continue;
+        }
+        if (channel <= 0 || net->channel == channel) {
+            return value - 1;
+        }
+        if (first_match < 0) {
+            first_match = value - 1;
+        }
+    }
+    return first_match;
+}
+
+int observer_store_put_network(observer_store_t *store, const observer_network_t *net)
+{
+    if (!store || !store->networks || !net) {
+        return -1;
+    }
+
+    int index = observer_store_find_bssid(store, &net->bssid);
+    if (index >= 0) {
+        observer_network_t *existing = &store->networks[index];
+        bool ssid_changed = strcmp(existing->ssid, net->ssid) != 0;
+        if (ssid_changed) {
+            // Hashed under the old name, so it goes before the entry is overwritten
+            ssid_slot_remove(store, existing->ssid, (uint16_t)(index + 1));
+        }
+
+        // Refresh scan data, the client list belongs to the store
+        uint32_t client_count = existing->client_count;
+        uint32_t first_client = existing->first_client;
+        uint32_t last_client = existing->last_client;
+        *existing = *net;
+        existing->client_count = client_count;
+        existing->first_client = first_client;
+        existing->last_client = last_client;
+
+        if (ssid_changed) {
+            slot_insert16(store->ssid_slots, store->network_slot_mask, hash_ssid(net->ssid), (uint16_t)(index + 1));
+        }
+        return index;
+    }
+
+    if (store->network_count >= store->max_networks) {
+        return -1;
+    }
+
+    index = store->network_count++;
+    observer_network_t *slot = &store->networks[index];
+    *slot = *net;
+    slot->client_count = 0;
+    slot->first_client = OBSERVER_STORE_NONE;
+    slot->last_client = OBSERVER_STORE_NONE;
+
+    slot_insert16(store->bssid_slots, store->network_slot_mask, hash_key(mac48_to_u64(&net->bssid)), (uint16_t)(index + 1));
+    slot_insert16(store->ssid_slots, store->network_slot_mask, hash_ssid(net->ssid), (uint16_t)(index + 1));
+    return index;
+}
+
+uint32_t observer_store_find_client(const observer_store_t *store, int network, const mac48_t *mac)
+{
+    if (!store || !store->clients || !mac || network < 0 || network >= store->network_count) {
+        return OBSERVER_STORE_NONE;
+    }
+
+    uint32_t mask = store->client_slot_mask;
+    uint32_t hash = hash_key(client_key(network, mac));
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint32_t value = store->client_slots[(hash + probe) & mask];
+        if (value == 0) {
+            break;
+        }
+        const observer_client_t *client = &store->clients[value - 1];
+        if (client->network == (uint16_t)network && mac48_equal(&client->mac, mac)) {
+            return value - 1;
+        }
+    }
+    return OBSERVER_STORE_NONE;
+}
+
+bool observer_store_add_client(observer_store_t *store, int network, const mac48_t *mac, uint32_t now)
+{
+    if (!store || !store->clients || !mac || network < 0 || network >= store->network_count) {
+        return false;
+    }
+
+    uint32_t mask = store->client_slot_mask;
+    uint32_t hash = hash_key(client_key(network, mac));
+    uint32_t slot = 0;
+    uint32_t probe;
+    for (probe = 0; probe <= mask; probe++) {
+        slot = (hash + probe) & mask;
+        uint32_t value = store->client_slots[slot];
+        if (value == 0) {
+            break;
+        }
+        observer_client_t *client = &store->clients[value - 1];
+        if (client->network == (uint16_t)network && mac48_equal(&client->mac, mac)) {
+            client->last_seen = now;
+            return false;
+        }
+    }
+
+    if (probe > mask || store->client_count >= store->max_clients) {
+        store->dropped_clients++;
+        return false;
+    }
+
+    uint32_t index = store->client_count++;
+    observer_client_t *client = &store->clients[index];
+    client->mac = *mac;
+    client->network = (uint16_t)network;
+    client->first_seen = now;
+    client->last_seen = now;
+    client->next = OBSERVER_STORE_NONE;
+    store->client_slots[slot] = index + 1;
+
+    observer_network_t *net = &store->networks[network];
+    if (net->last_client == OBSERVER_STORE_NONE) {
+        net->first_client = index;
+    } else {
+        store->clients[net->last_client].next = index;
+    }
+    net->last_client = index;
+    net->client_count++;
+    return true;
+}
+
+const observer_client_t *observer_store_client(const observer_store_t *store, uint32_t client)
+{
+    if (!store || !store->clients || client >= store->client_count) {
+        return NULL;
+    }
+    return &store->clients[client];
+}
@@ -0,0 +1,83 @@
+#ifndef OBSERVER_STORE_H
+#define OBSERVER_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mac48.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Network observer store: access points keyed by their 48-bit BSSID and,
+ * per access point, the set of client stations seen on it.
+ *
+ * Networks live in a flat array so indices stay stable until the store is
+ * cleared. Two open-addressing tables index them, one by BSSID and one by
+ * SSID (sniffer output only names the SSID and channel). Clients are packed
+ * mac48_t addresses with first/last-seen timestamps in a shared pool, hashed on
+ * (network, MAC) and linked per network in insertion order.
+ */
+
+#define OBSERVER_STORE_NONE     UINT32_MAX
+
+typedef struct {
+    char ssid[33];
+    char band[8];           // "2.4GHz" or "5GHz"
+    mac48_t bssid;
+    uint8_t channel;
+    int8_t rssi;            // dBm
+    uint16_t scan_index;    // 1-based index from scan_networks (for select_networks command)
+    uint32_t client_count;  // clients tracked in the store
+    uint32_t first_client;  // OBSERVER_STORE_NONE when the network has no clients
+    uint32_t last_client;
+} observer_network_t;
+
+typedef struct {
+    mac48_t mac;
+    uint16_t network;       // owning network index
+    uint32_t first_seen;    // caller time base, ms on target
+    uint32_t last_seen;
+    uint32_t next;          // next client of the same network, OBSERVER_STORE_NONE terminated
+} observer_client_t;
+
+typedef struct {
+    observer_network_t *networks;   // PSRAM
+    int network_count;
+    int max_networks;
+    uint16_t *bssid_slots;          // network index + 1, 0 = empty
+    uint16_t *ssid_slots;           // network index + 1, 0 = empty
+    uint32_t network_slot_mask;
+
+    observer_client_t *clients;     // PSRAM
+    uint32_t client_count;
+    uint32_t max_clients;
+    uint32_t *client_slots;         // client index + 1, 0 = empty
+    uint32_t client_slot_mask;
+    uint32_t dropped_clients;       // client pool was full
+} observer_store_t;
+
+bool observer_store_init(observer_store_t *store, int max_networks, uint32_t max_clients);
+void observer_store_free(observer_store_t *store);
+// Forget all networks and clients; buffers are kept.
+void observer_store_clear(observer_store_t *store);
+
+// Insert a network or refresh the existing entry with the same BSSID. Returns its index, -1 when full.
+int observer_store_put_network(observer_store_t *store, const observer_network_t *net);
+int observer_store_find_bssid(const observer_store_t *store, const mac48_t *bssid);
+// Prefer the entry on channel; channel 0 or no channel match returns the first SSID match.
+int observer_store_find_ssid(const observer_store_t *store, const char *ssid, int channel);
+
+// Record a client sighting. Returns true for a new client, false when it was known or the pool is full.
+bool observer_store_add_client(observer_store_t *store, int network, const mac48_t *mac, uint32_t now);
+// Client index, or OBSERVER_STORE_NONE.
+uint32_t observer_store_find_client(const observer_store_t *store, int network, const mac48_t *mac);
+const observer_client_t *observer_store_client(const observer_store_t *store, uint32_t client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+#include "perf_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "perf_trace";
+
+#define PERF_TRACE_MAX_THREADS  32
+
+typedef struct {
+    uint32_t seq;               // claim number + 1 once written, 0 while being written
+    uint8_t core;
+    char task[PERF_TRACE_TASK_NAME];
+    const char *name;
+    int64_t start_us;
+    int64_t dur_us;             // -1 for a marker
+} perf_trace_span_t;
+
+static perf_trace_span_t *s_ring;
+static uint32_t s_head;         // claims so far; slot = claim % PERF_TRACE_CAPACITY
+
+bool perf_trace_init(void)
+{
+    if (s_ring) {
+        return true;
+    }
+    perf_trace_span_t *ring = heap_caps_calloc(PERF_TRACE_CAPACITY, sizeof(*ring), MALLOC_CAP_SPIRAM);
+    if (!ring) {
+        ESP_LOGW(TAG, "No PSRAM for the trace ring");
+        return false;
+    }
+    __atomic_store_n(&s_ring, ring, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void put_span(const char *name, int64_t start_us, int64_t dur_us)
+{
+    perf_trace_span_t *ring = __atomic_load_n(&s_ring, __ATOMIC_ACQUIRE);
+    if (!ring) {
+        return;
+    }
+    uint32_t claim = __atomic_fetch_add(&s_head, 1, __ATOMIC_RELAXED);
+    perf_trace_span_t *span = &ring[claim % PERF_TRACE_CAPACITY];
+
+    // Readers seeing 0, or a seq that changed while they copied, drop the slot
+    __atomic_store_n(&span->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    span->name = name;
+    span->start_us = start_us;
+    span->dur_us = dur_us;
+    span->core = (uint8_t)xPortGetCoreID();
+    const char *task = pcTaskGetName(NULL);
+    strncpy(span->task, task ? task : "?", sizeof(span->task) - 1);
+    span->task[sizeof(span->task) - 1] = '\0';
+    __atomic_store_n(&span->seq, claim + 1, __ATOMIC_RELEASE);
+}
+
+perf_trace_scope_t perf_trace_begin(const char *name)
+{
+    return (perf_trace_scope_t){ .name = name, .start_us = esp_timer_get_time() };
+}
+
+void perf_trace_end(const perf_trace_scope_t *scope)
+{
+    put_span(scope->name, scope->start_us, esp_timer_get_time() - scope->start_us);
+}
+
+void perf_trace_record(const char *name, int64_t start_us, int64_t end_us)
+{
+    put_span(name, start_us, end_us > start_us ? end_us - start_us : 0);
+}
+
+void perf_trace_mark(const char *name)
+{
+    put_span(name, esp_timer_get_time(), -1);
+}
+
+uint32_t perf_trace_count(void)
+{
+    return __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+}
+
+// Copy the slot for claim; false if it was overwritten or is mid-write.
+static bool read_span(const perf_trace_span_t *slot, uint32_t claim, perf_trace_span_t *out)
+{
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != claim + 1) {
+        return false;
+    }
+    memcpy(out, slot, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == claim + 1;
+}
+
+static void write_json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+// Chrome groups events by tid; give each task name its own
+static int thread_id(char names[][PERF_TRACE_TASK_NAME], int *count, const char *task)
+{
+    for (int i = 0; i < *count; i++) {
+        if (strcmp(names[i], task) == 0) {
+            return i + 1;
+        }
+    }
+    if (*count == PERF_TRACE_MAX_THREADS) {
+        return PERF_TRACE_MAX_THREADS + 1;  // "other"
+    }
+    memcpy(names[*count], task, PERF_TRACE_TASK_NAME);
+    return ++(*count);
+}
+
+bool perf_trace_export_chrome(const char *path, const char *label, const char *version)
+{
+    perf_trace_span_t *ring = __atomic_load_n(&s_ring, __ATOMIC_ACQUIRE);
+    if (!ring) {
+        return false;
+    }
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        ESP_LOGE(TAG, "Can't create %s", path);
+        return false;
+    }
+
+    uint32_t head = perf_trace_count();
+    uint32_t first = head > PERF_TRACE_CAPACITY ? head - PERF_TRACE_CAPACITY : 0;
+    char threads[PERF_TRACE_MAX_THREADS][PERF_TRACE_TASK_NAME];
+    int thread_count = 0;
+    uint32_t written = 0;
+
+    fputs("{\"traceEvents\":[\n", f);
+    for (uint32_t claim = first; claim != head; claim++) {
+        perf_trace_span_t span;
+        if (!read_span(&ring[claim % PERF_TRACE_CAPACITY], claim, &span)) {
+            continue;
+        }
+        int tid = thread_id(threads, &thread_count, span.task);
+        fputs(written ? ",\n{\"name\":" : "{\"name\":", f);
+        write_json_string(f, span.name);
+        if (span.dur_us < 0) {
+            fprintf(f, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"core\":%u}}",
+                    (long long)span.start_us, tid, span.core);
+        } else {
+            fprintf(f, ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"core\":%u}}",
+                    (long long)span.start_us, (long long)span.dur_us, tid, span.core);
+        }
+        written++;
+    }
+    for (int i = 0; i < thread_count; i++) {
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                written || i ? ",\n" : "", i + 1);
+        write_json_string(f, threads[i]);
+        fputs("}}", f);
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"label\":", f);
+    write_json_string(f, label);
+    fputs(",\"version\":", f);
+    write_json_string(f, version);
+    fprintf(f, ",\"recorded\":%lu,\"exported\":%lu}}\n", (unsigned long)head, (unsigned long)written);
+
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    if (ok) {
+        ESP_LOGI(TAG, "%lu spans written to %s", (unsigned long)written, path);
+    } else {
+        ESP_LOGE(TAG, "Write to %s failed", path);
+    }
+    return ok;
+}
@@ -0,0 +1,73 @@
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Timeline profiler: named spans recorded into a lock-free ring.
+ *
+ * PERF_TRACE_SCOPE() times the rest of the enclosing block; begin/end
+ * pairs and perf_trace_record() cover spans that don't fit a block. Each
+ * span keeps its start, duration, task and core. Any task may record at
+ * any time: a writer claims a slot with one atomic add and publishes it
+ * with a sequence number, so recording never blocks and an export running
+ * alongside skips slots that are mid-write. Once the ring is full the
+ * oldest spans are overwritten.
+ *
+ * perf_trace_export_chrome() writes the ring as Chrome trace event JSON
+ * (chrome://tracing, ui.perfetto.dev). tools/perf_trace_diff.py compares
+ * two exports span by span.
+ *
+ * Span names are stored by pointer: use string literals.
+ */
+
+#define PERF_TRACE_CAPACITY     2048    // spans, power of two
+#define PERF_TRACE_TASK_NAME    12
+
+#ifndef PERF_TRACE_ENABLED
+#define PERF_TRACE_ENABLED      1
+#endif
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+} perf_trace_scope_t;
+
+// Allocate the ring. Spans recorded before this are dropped.
+bool perf_trace_init(void);
+
+perf_trace_scope_t perf_trace_begin(const char *name);
+void perf_trace_end(const perf_trace_scope_t *scope);
+// A span measured elsewhere, attributed to the calling task. esp_timer times.
+void perf_trace_record(const char *name, int64_t start_us, int64_t end_us);
+// A zero-length marker, e.g. the moment the UI becomes interactive.
+void perf_trace_mark(const char *name);
+
+// Spans recorded since boot, including overwritten ones.
+uint32_t perf_trace_count(void);
+
+// Write every span still in the ring. label and version end up in the
+// trace's metadata; either may be NULL.
+bool perf_trace_export_chrome(const char *path, const char *label, const char *version);
+
+#if PERF_TRACE_ENABLED
+#define PERF_TRACE_CONCAT_(a, b)    a##b
+#define PERF_TRACE_CONCAT(a, b)     PERF_TRACE_CONCAT_(a, b)
+#define PERF_TRACE_SCOPE(name) \
+    perf_trace_scope_t PERF_TRACE_CONCAT(perf_scope_, __LINE__) \
+        __attribute__((cleanup(perf_trace_end))) = perf_trace_begin(name)
+#else
+#define PERF_TRACE_SCOPE(name)      do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
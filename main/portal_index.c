@@ -0,0 +1,470 @@
+#include "portal_index.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "portal_index";
+
+#define INDEX_MAGIC     0x31584950u     // "PIX1"
+#define INDEX_VERSION   1
+#define SSID_PREFIX     "SSID: "
+#define DATA_PREFIX     "Data: "
+#define ENTRY_BATCH     64      // entries per sidecar write while indexing
+
+_Static_assert(sizeof(portal_index_header_t) == PORTAL_INDEX_HEADER_SIZE, "header must fill its block");
+
+static uint32_t hash_ssid(const char *ssid, size_t len)
+{
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)ssid[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static off_t entry_offset(uint32_t record)
+{
+    return PORTAL_INDEX_HEADER_SIZE + (off_t)record * sizeof(portal_index_entry_t);
+}
+
+static bool pwrite_all(int fd, off_t offset, const void *data, size_t len)
+{
+    return lseek(fd, offset, SEEK_SET) == offset && write(fd, data, len) == (ssize_t)len;
+}
+
+static ssize_t pread_some(int fd, off_t offset, void *data, size_t len)
+{
+    if (lseek(fd, offset, SEEK_SET) != offset) {
+        return -1;
+    }
+    return read(fd, data, len);
+}
+
+static void reset_header(portal_index_t *index)
+{
+    memset(index->header, 0, sizeof(*index->header));
+    index->header->magic = INDEX_MAGIC;
+    index->header->version = INDEX_VERSION;
+    index->header->bucket_count = PORTAL_INDEX_BUCKETS;
+    index->header_dirty = true;
+    index->entries_count = 0;
+}
+
+static bool write_header(portal_index_t *index)
+{
+    if (!index->header_dirty) {
+        return true;
+    }
+    if (!pwrite_all(index->index_fd, 0, index->header, sizeof(*index->header))) {
+        ESP_LOGE(TAG, "Cannot write index header for %s: %s", index->path, strerror(errno));
+        return false;
+    }
+    index->header_dirty = false;
+    return true;
+}
+
+// Link a new record into its bucket; the caller writes the entry
+static void link_entry(portal_index_t *index, portal_index_entry_t *entry)
+{
+    uint32_t bucket = entry->ssid_hash % PORTAL_INDEX_BUCKETS;
+    entry->prev = index->header->buckets[bucket];
+    index->header->buckets[bucket] = index->header->count + 1;
+    index->header->count++;
+    index->header->indexed_size = entry->offset + entry->length;
+    index->header_dirty = true;
+}
+
+static bool get_entry(portal_index_t *index, uint32_t record, portal_index_entry_t *out)
+{
+    if (record >= index->header->count) {
+        return false;
+    }
+    if (record < index->entries_first || record >= index->entries_first + index->entries_count) {
+        uint32_t first = record - record % PORTAL_INDEX_ENTRY_RUN;
+        uint32_t want = index->header->count - first;
+        if (want > PORTAL_INDEX_ENTRY_RUN) {
+            want = PORTAL_INDEX_ENTRY_RUN;
+        }
+        ssize_t got = pread_some(index->index_fd, entry_offset(first), index->entries, want * sizeof(portal_index_entry_t));
+        if (got < 0 || (size_t)got < (record - first + 1) * sizeof(portal_index_entry_t)) {
+            index->entries_count = 0;
+            return false;
+        }
+        index->entries_first = first;
+        index->entries_count = (uint32_t)got / sizeof(portal_index_entry_t);
+    }
+    *out = index->entries[record - index->entries_first];
+    return true;
+}
+
+/*
+ * Streaming record splitter: a record ends with a line that is exactly
+ * "---". The first line is kept to hash the SSID.
+ */
+typedef struct {
+    uint32_t record_start;
+    uint32_t line_len;
+    bool line_is_dashes;
+    bool in_first_line;
+    char first_line[40];
+    uint32_t first_len;
+} splitter_t;
+
+static void splitter_reset(splitter_t *s, uint32_t record_start)
+{
+    memset(s, 0, sizeof(*s));
+    s->record_start = record_start;
+    s->line_is_dashes = true;
+    s->in_first_line = true;
+}
+
+static uint32_t first_line_hash(const splitter_t *s)
+{
+    const char *ssid = s->first_line;
+    size_t len = s->first_len;
+    size_t prefix = strlen(SSID_PREFIX);
+    if (len >= prefix && memcmp(ssid, SSID_PREFIX, prefix) == 0) {
+        ssid += prefix;
+        len -= prefix;
+    }
+    return hash_ssid(ssid, len > 32 ? 32 : len);
+}
+
+static uint32_t sync_locked(portal_index_t *index)
+{
+    off_t size = lseek(index->data_fd, 0, SEEK_END);
+    if (size < 0) {
+        return 0;
+    }
+    if ((uint32_t)size < index->header->indexed_size) {
+        // Data file was truncated or replaced; start over
+        ESP_LOGW(TAG, "%s shrank, rebuilding index", index->path);
+        reset_header(index);
+    }
+    if ((uint32_t)size == index->header->indexed_size) {
+        return 0;
+    }
+
+    portal_index_entry_t batch[ENTRY_BATCH];
+    uint32_t batch_count = 0;
+    uint32_t batch_first = index->header->count;
+    uint32_t added = 0;
+    bool ok = true;
+
+    splitter_t s;
+    splitter_reset(&s, index->header->indexed_size);
+    uint32_t pos = index->header->indexed_size;
+    char *chunk = index->scratch;
+
+    while (ok && pos < (uint32_t)size) {
+        ssize_t got = pread_some(index->data_fd, pos, chunk, PORTAL_INDEX_RECORD_MAX);
+        if (got <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < got; i++, pos++) {
+            char c = chunk[i];
+            if (c != '\n') {
+                if (s.in_first_line && s.first_len < sizeof(s.first_line)) {
+                    s.first_line[s.first_len++] = c;
+                }
+                if (c != '-') {
+                    s.line_is_dashes = false;
+                }
+                s.line_len++;
+                continue;
+            }
+
+            bool end_of_record = s.line_is_dashes && s.line_len == 3;
+            s.in_first_line = false;
+            s.line_len = 0;
+            s.line_is_dashes = true;
+            if (!end_of_record) {
+                continue;
+            }
+
+            portal_index_entry_t *entry = &batch[batch_count++];
+            entry->offset = s.record_start;
+            entry->length = pos + 1 - s.record_start;
+            entry->ssid_hash = first_line_hash(&s);
+            link_entry(index, entry);
+            added++;
+            splitter_reset(&s, pos + 1);
+
+            if (batch_count == ENTRY_BATCH) {
+                ok = pwrite_all(index->index_fd, entry_offset(batch_first), batch, sizeof(batch));
+                batch_first += batch_count;
+                batch_count = 0;
+            }
+        }
+    }
+    if (ok && batch_count > 0) {
+        ok = pwrite_all(index->index_fd, entry_offset(batch_first), batch, batch_count * sizeof(portal_index_entry_t));
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "Cannot write index entries for %s: %s", index->path, strerror(errno));
+        reset_header(index);
+        write_header(index);
+        return 0;
+    }
+    // A trailing record without its "---" line stays unindexed until it is complete
+    write_header(index);
+    return added;
+}
+
+bool portal_index_open(portal_index_t *index, const char *data_path)
+{
+    if (!index || !data_path) {
+        return false;
+    }
+
+    memset(index, 0, sizeof(*index));
+    index->data_fd = -1;
+    index->index_fd = -1;
+    snprintf(index->path, sizeof(index->path), "%s", data_path);
+
+    char index_path[72];
+    snprintf(index_path, sizeof(index_path), "%s.idx", data_path);
+
+    index->lock = xSemaphoreCreateMutex();
+    index->header = heap_caps_malloc(sizeof(portal_index_header_t), MALLOC_CAP_SPIRAM);
+    index->entries = heap_caps_malloc(PORTAL_INDEX_ENTRY_RUN * sizeof(portal_index_entry_t), MALLOC_CAP_SPIRAM);
+    index->scratch = heap_caps_malloc(PORTAL_INDEX_RECORD_MAX + 1, MALLOC_CAP_SPIRAM);
+    if (index->lock && index->header && index->entries && index->scratch) {
+        index->data_fd = open(data_path, O_RDWR | O_CREAT, 0644);
+        index->index_fd = open(index_path, O_RDWR | O_CREAT, 0644);
+    }
+    if (index->data_fd < 0 || index->index_fd < 0) {
+        ESP_LOGE(TAG, "Cannot open %s or its index: %s", data_path, strerror(errno));
+        portal_index_close(index);
+        return false;
+    }
+
+    ssize_t got = pread_some(index->index_fd, 0, index->header, sizeof(*index->header));
+    if (got != (ssize_t)sizeof(*index->header) || index->header->magic != INDEX_MAGIC ||
+        index->header->version != INDEX_VERSION || index->header->bucket_count != PORTAL_INDEX_BUCKETS) {
+        ESP_LOGI(TAG, "Building index for %s", data_path);
+        reset_header(index);
+    }
+    uint32_t added = sync_locked(index);
+    if (added > 0) {
+        ESP_LOGI(TAG, "Indexed %u new records in %s", (unsigned)added, data_path);
+    }
+    return true;
+}
+
+void portal_index_close(portal_index_t *index)
+{
+    if (!index) {
+        return;
+    }
+    if (index->index_fd >= 0) {
+        write_header(index);
+        close(index->index_fd);
+    }
+    if (index->data_fd >= 0) {
+        close(index->data_fd);
+    }
+    if (index->lock) {
+        vSemaphoreDelete(index->lock);
+    }
+    heap_caps_free(index->header);
+    heap_caps_free(index->entries);
+    heap_caps_free(index->scratch);
+    memset(index, 0, sizeof(*index));
+    index->data_fd = -1;
+    index->index_fd = -1;
+}
+
+bool portal_index_is_open(portal_index_t *index)
+{
+    return index && index->lock && index->data_fd >= 0;
+}
+
+uint32_t portal_index_sync(portal_index_t *index)
+{
+    if (!portal_index_is_open(index)) {
+        return 0;
+    }
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    // FatFs keeps the file size per handle, so bytes another writer appended are only visible
+    // through a handle opened after that writer synced
+    close(index->data_fd);
+    index->data_fd = open(index->path, O_RDWR | O_CREAT, 0644);
+    uint32_t added = 0;
+    if (index->data_fd < 0) {
+        ESP_LOGE(TAG, "Cannot reopen %s: %s", index->path, strerror(errno));
+    } else {
+        added = sync_locked(index);
+    }
+    xSemaphoreGive(index->lock);
+    return added;
+}
+
+bool portal_index_append(portal_index_t *index, const char *ssid, const char *data)
+{
+    if (!portal_index_is_open(index) || !ssid || !data) {
+        return false;
+    }
+
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    // Anything another writer left behind goes first, so offsets stay in file order
+    sync_locked(index);
+
+    char *text = index->scratch;
+    int len = snprintf(text, PORTAL_INDEX_RECORD_MAX + 1, SSID_PREFIX "%.32s\n" DATA_PREFIX "%s\n---\n", ssid, data);
+    if (len > PORTAL_INDEX_RECORD_MAX) {
+        // Keep the terminator so the record still splits correctly on a rebuild
+        len = PORTAL_INDEX_RECORD_MAX;
+        memcpy(text + len - 5, "\n---\n", 5);
+    }
+
+    // An incomplete record left by another writer is skipped, not overwritten
+    off_t end = lseek(index->data_fd, 0, SEEK_END);
+    portal_index_entry_t entry = {
+        .offset = end < 0 ? index->header->indexed_size : (uint32_t)end,
+        .length = (uint32_t)len,
+        .ssid_hash = hash_ssid(ssid, strnlen(ssid, 32)),
+    };
+    uint32_t record = index->header->count;
+    uint32_t indexed_before = index->header->indexed_size;
+    bool ok = pwrite_all(index->data_fd, entry.offset, text, (size_t)len);
+    if (ok) {
+        link_entry(index, &entry);
+        ok = pwrite_all(index->index_fd, entry_offset(record), &entry, sizeof(entry));
+        if (!ok) {
+            // Header change is not written; the next sync re-indexes the record from the data file
+            index->header->count--;
+            index->header->indexed_size = indexed_before;
+            index->header->buckets[entry.ssid_hash % PORTAL_INDEX_BUCKETS] = entry.prev;
+        }
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "Append to %s failed: %s", index->path, strerror(errno));
+    }
+    xSemaphoreGive(index->lock);
+    return ok;
+}
+
+bool portal_index_flush(portal_index_t *index)
+{
+    if (!portal_index_is_open(index)) {
+        return false;
+    }
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    bool ok = write_header(index);
+    fsync(index->data_fd);
+    fsync(index->index_fd);
+    xSemaphoreGive(index->lock);
+    return ok;
+}
+
+bool portal_index_clear(portal_index_t *index)
+{
+    if (!portal_index_is_open(index)) {
+        return false;
+    }
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    bool ok = ftruncate(index->data_fd, 0) == 0 && ftruncate(index->index_fd, PORTAL_INDEX_HEADER_SIZE) == 0;
+    reset_header(index);
+    ok &= write_header(index);
+    xSemaphoreGive(index->lock);
+    return ok;
+}
+
+uint32_t portal_index_count(portal_index_t *index)
+{
+    if (!portal_index_is_open(index)) {
+        return 0;
+    }
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    uint32_t count = index->header->count;
+    xSemaphoreGive(index->lock);
+    return count;
+}
+
+// Split "SSID: x\nData: y...\n---\n" into its two fields
+static void parse_record(char *text, size_t len, portal_index_record_t *out)
+{
+    text[len] = '\0';
+    if (len >= 5 && memcmp(text + len - 5, "\n---\n", 5) == 0) {
+        text[len - 5] = '\0';
+    }
+
+    char *line_end = strchr(text, '\n');
+    if (line_end) {
+        *line_end = '\0';
+    }
+    const char *ssid = text;
+    if (strncmp(ssid, SSID_PREFIX, strlen(SSID_PREFIX)) == 0) {
+        ssid += strlen(SSID_PREFIX);
+    }
+    snprintf(out->ssid, sizeof(out->ssid), "%s", ssid);
+
+    const char *data = line_end ? line_end + 1 : "";
+    if (strncmp(data, DATA_PREFIX, strlen(DATA_PREFIX)) == 0) {
+        data += strlen(DATA_PREFIX);
+    }
+    snprintf(out->data, sizeof(out->data), "%s", data);
+}
+
+static bool read_locked(portal_index_t *index, uint32_t record, portal_index_record_t *out)
+{
+    portal_index_entry_t entry;
+    if (!get_entry(index, record, &entry)) {
+        return false;
+    }
+    size_t want = entry.length < PORTAL_INDEX_RECORD_MAX ? entry.length : PORTAL_INDEX_RECORD_MAX;
+    ssize_t got = pread_some(index->data_fd, entry.offset, index->scratch, want);
+    if (got <= 0) {
+        return false;
+    }
+    parse_record(index->scratch, (size_t)got, out);
+    return true;
+}
+
+bool portal_index_read(portal_index_t *index, uint32_t record, portal_index_record_t *out)
+{
+    if (!portal_index_is_open(index) || !out) {
+        return false;
+    }
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    bool ok = read_locked(index, record, out);
+    xSemaphoreGive(index->lock);
+    return ok;
+}
+
+uint32_t portal_index_find_ssid(portal_index_t *index, const char *ssid, uint32_t *out, uint32_t max)
+{
+    if (!portal_index_is_open(index) || !ssid || !out || max == 0) {
+        return 0;
+    }
+
+    size_t len = strnlen(ssid, 32);
+    uint32_t hash = hash_ssid(ssid, len);
+    uint32_t found = 0;
+
+    xSemaphoreTake(index->lock, portMAX_DELAY);
+    uint32_t next = index->header->buckets[hash % PORTAL_INDEX_BUCKETS];
+    portal_index_record_t *rec = heap_caps_malloc(sizeof(*rec), MALLOC_CAP_SPIRAM);
+    while (rec && next != 0 && found < max) {
+        uint32_t record = next - 1;
+        portal_index_entry_t entry;
+        if (!get_entry(index, record, &entry)) {
+            break;
+        }
+        // Only records with the same full hash are read back to compare the SSID
+        if (entry.ssid_hash == hash && read_locked(index, record, rec) && strncmp(rec->ssid, ssid, 32) == 0) {
+            out[found++] = record;
+        }
+        next = entry.prev;
+    }
+    xSemaphoreGive(index->lock);
+    heap_caps_free(rec);
+    return found;
+}
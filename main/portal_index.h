@@ -0,0 +1,102 @@
+#ifndef PORTAL_INDEX_H
+#define PORTAL_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Random access to a portals.txt style file:
+ *
+ *     SSID: <ssid>\n
+ *     Data: <data, may span lines>\n
+ *     ---\n
+ *
+ * A sidecar "<file>.idx" holds a 4 KB header followed by one 16-byte entry
+ * per record (offset, length, SSID hash, previous record in the same hash
+ * bucket). The header keeps the record count, how many bytes of the data
+ * file are indexed, and the newest record of each SSID bucket, so opening
+ * costs one header read, reading record i costs an entry read plus one
+ * read of the record, and an SSID search only follows that SSID's bucket
+ * chain.
+ *
+ * Appends through portal_index_append() extend both files; bytes appended
+ * by other writers are picked up by portal_index_sync(), which only parses
+ * what lies beyond the indexed size. The file system keeps the size per open
+ * file, so portal_index_sync() reopens the data file and sees what the other
+ * writer has synced or closed. A missing, foreign or stale sidecar is rebuilt
+ * from the data file.
+ *
+ * All calls are serialised by an internal mutex.
+ */
+
+#define PORTAL_INDEX_HEADER_SIZE    4096
+#define PORTAL_INDEX_BUCKETS        ((PORTAL_INDEX_HEADER_SIZE - 16) / 4)
+#define PORTAL_INDEX_ENTRY_RUN      64      // entries read and cached at a time
+#define PORTAL_INDEX_RECORD_MAX     1024    // longer records are truncated on read
+#define PORTAL_INDEX_DATA_MAX       512
+
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t ssid_hash;
+    uint32_t prev;          // previous record index + 1 in the same bucket, 0 = end
+} portal_index_entry_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bucket_count;
+    uint32_t count;
+    uint32_t indexed_size;  // data file bytes covered by the entries
+    uint32_t buckets[PORTAL_INDEX_BUCKETS];    // newest record index + 1, 0 = empty
+} portal_index_header_t;
+
+typedef struct {
+    char ssid[33];
+    char data[PORTAL_INDEX_DATA_MAX];
+} portal_index_record_t;
+
+typedef struct {
+    SemaphoreHandle_t lock;
+    int data_fd;
+    int index_fd;
+    char path[64];
+    portal_index_header_t *header;      // PSRAM copy of the sidecar header
+    bool header_dirty;
+    portal_index_entry_t *entries;      // one cached run, PSRAM
+    uint32_t entries_first;
+    uint32_t entries_count;
+    char *scratch;                      // PORTAL_INDEX_RECORD_MAX + 1 bytes, PSRAM
+} portal_index_t;
+
+// Open or create data_path and its sidecar, then index any unindexed records.
+bool portal_index_open(portal_index_t *index, const char *data_path);
+void portal_index_close(portal_index_t *index);
+bool portal_index_is_open(portal_index_t *index);
+
+// Index records other writers appended and synced since the last call. Returns how many were added.
+uint32_t portal_index_sync(portal_index_t *index);
+// Append one record to the data file and the index.
+bool portal_index_append(portal_index_t *index, const char *ssid, const char *data);
+// Write the header and sync both files; call after a batch of appends.
+bool portal_index_flush(portal_index_t *index);
+// Truncate the data file and the index.
+bool portal_index_clear(portal_index_t *index);
+
+uint32_t portal_index_count(portal_index_t *index);
+bool portal_index_read(portal_index_t *index, uint32_t record, portal_index_record_t *out);
+// Records whose SSID equals ssid, newest first. Returns the number stored in out.
+uint32_t portal_index_find_ssid(portal_index_t *index, const char *ssid, uint32_t *out, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
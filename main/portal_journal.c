@@ -0,0 +1,266 @@
+#include "portal_journal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "portal_journal";
+
+#define QUEUE_MASK  (PORTAL_JOURNAL_QUEUE_LEN - 1)
+
+_Static_assert((PORTAL_JOURNAL_QUEUE_LEN & QUEUE_MASK) == 0, "queue length must be a power of two");
+
+static bool write_at(portal_journal_t *journal, off_t offset, const uint8_t *data, size_t len)
+{
+    if (lseek(journal->fd, offset, SEEK_SET) != offset || write(journal->fd, data, len) != (ssize_t)len) {
+        journal->stats.write_errors++;
+        ESP_LOGE(TAG, "Write to %s failed: %s", journal->path, strerror(errno));
+        return false;
+    }
+    journal->unsynced = true;
+    return true;
+}
+
+// Open for append and load the partial last block, so later writes can start at a block boundary
+static bool open_file(portal_journal_t *journal)
+{
+    journal->fd = open(journal->path, O_RDWR | O_CREAT, 0644);
+    if (journal->fd < 0) {
+        journal->stats.write_errors++;
+        ESP_LOGW(TAG, "Cannot open %s: %s", journal->path, strerror(errno));
+        return false;
+    }
+
+    off_t size = lseek(journal->fd, 0, SEEK_END);
+    if (size < 0) {
+        size = 0;
+    }
+    journal->block_offset = size & ~(off_t)(PORTAL_JOURNAL_BLOCK_SIZE - 1);
+    journal->block_used = (size_t)(size - journal->block_offset);
+    if (journal->block_used > 0 &&
+        (lseek(journal->fd, journal->block_offset, SEEK_SET) != journal->block_offset ||
+         read(journal->fd, journal->block, journal->block_used) != (ssize_t)journal->block_used)) {
+        // Still correct, just no longer aligned
+        journal->block_offset = size;
+        journal->block_used = 0;
+    }
+    journal->last_sync = xTaskGetTickCount();
+    return true;
+}
+
+// Entries written since the last sync are on the card now, and visible to readers that open the file
+static void report_synced(portal_journal_t *journal)
+{
+    if (journal->pending_count > 0 && journal->commit_cb) {
+        journal->commit_cb(journal->pending, journal->pending_count, journal->user_data);
+    }
+    journal->pending_count = 0;
+}
+
+static void sync_file(portal_journal_t *journal)
+{
+    if (journal->unsynced) {
+        fsync(journal->fd);
+        journal->stats.syncs++;
+        journal->unsynced = false;
+    }
+    journal->last_sync = xTaskGetTickCount();
+    report_synced(journal);
+}
+
+static void close_file(portal_journal_t *journal)
+{
+    sync_file(journal);
+    close(journal->fd);
+    journal->fd = -1;
+}
+
+static bool append_bytes(portal_journal_t *journal, const char *text, size_t len)
+{
+    bool ok = true;
+    while (len > 0) {
+        size_t room = PORTAL_JOURNAL_BLOCK_SIZE - journal->block_used;
+        size_t n = len < room ? len : room;
+        memcpy(journal->block + journal->block_used, text, n);
+        journal->block_used += n;
+        text += n;
+        len -= n;
+
+        if (journal->block_used == PORTAL_JOURNAL_BLOCK_SIZE) {
+            ok &= write_at(journal, journal->block_offset, journal->block, PORTAL_JOURNAL_BLOCK_SIZE);
+            journal->stats.blocks_written++;
+            journal->block_offset += PORTAL_JOURNAL_BLOCK_SIZE;
+            journal->block_used = 0;
+        }
+    }
+    return ok;
+}
+
+static void drain(portal_journal_t *journal)
+{
+    uint32_t tail = atomic_load_explicit(&journal->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&journal->head, memory_order_acquire);
+    if (tail == head) {
+        return;
+    }
+
+    bool ok = journal->fd >= 0 || open_file(journal);
+    size_t tail_before = journal->block_used;
+    off_t offset_before = journal->block_offset;
+    uint32_t count = head - tail;
+
+    for (uint32_t i = tail; ok && i != head; i++) {
+        const portal_journal_entry_t *entry = &journal->slots[i & QUEUE_MASK];
+        ok = append_bytes(journal, entry->text, entry->len);
+    }
+    // One write for whatever of the batch did not fill a whole block
+    if (ok && journal->block_used > 0 && (journal->block_used != tail_before || journal->block_offset != offset_before)) {
+        ok = write_at(journal, journal->block_offset, journal->block, journal->block_used);
+        journal->stats.tail_writes++;
+    }
+
+    if (ok) {
+        // Reported with the next sync; the newest entry is kept so the slots can be reused meanwhile
+        journal->stats.committed += count;
+        *journal->pending = journal->slots[(head - 1) & QUEUE_MASK];
+        journal->pending_count += count;
+    } else {
+        ESP_LOGE(TAG, "Lost %u portal entries", (unsigned)count);
+        if (journal->fd >= 0) {
+            // Reopen next time; the tail block is reloaded from what actually reached the card.
+            // Closing flushes the earlier batches.
+            close(journal->fd);
+            journal->fd = -1;
+            journal->unsynced = false;
+            report_synced(journal);
+        }
+    }
+
+    atomic_store_explicit(&journal->tail, head, memory_order_release);
+}
+
+static void writer_task(void *arg)
+{
+    portal_journal_t *journal = (portal_journal_t *)arg;
+    const TickType_t sync_ticks = pdMS_TO_TICKS(PORTAL_JOURNAL_SYNC_MS);
+
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        if (journal->fd >= 0) {
+            TickType_t since_sync = xTaskGetTickCount() - journal->last_sync;
+            if (journal->unsynced) {
+                wait = since_sync < sync_ticks ? sync_ticks - since_sync : 0;
+            } else {
+                wait = pdMS_TO_TICKS(PORTAL_JOURNAL_IDLE_CLOSE_MS);
+            }
+        }
+
+        bool notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
+        if (notified) {
+            // Let a burst of submissions collect so it lands in one write
+            vTaskDelay(pdMS_TO_TICKS(PORTAL_JOURNAL_COALESCE_MS));
+            drain(journal);
+        }
+        if (journal->fd < 0) {
+            continue;
+        }
+
+        // Checked after every drain too, so steady traffic cannot postpone the sync
+        if (journal->unsynced) {
+            if (xTaskGetTickCount() - journal->last_sync >= sync_ticks) {
+                sync_file(journal);
+            }
+        } else if (!notified) {
+            close_file(journal);
+        }
+    }
+}
+
+bool portal_journal_start(
+    portal_journal_t *journal,
+    const char *path,
+    portal_journal_commit_cb_t commit_cb,
+    void *user_data,
+    UBaseType_t priority)
+{
+    if (!journal || !path) {
+        return false;
+    }
+
+    memset(journal, 0, sizeof(*journal));
+    snprintf(journal->path, sizeof(journal->path), "%s", path);
+    journal->fd = -1;
+    journal->commit_cb = commit_cb;
+    journal->user_data = user_data;
+    atomic_init(&journal->head, 0);
+    atomic_init(&journal->tail, 0);
+
+    // One slot more than the ring: the newest entry not yet reported
+    journal->slots = heap_caps_calloc(PORTAL_JOURNAL_QUEUE_LEN + 1, sizeof(portal_journal_entry_t), MALLOC_CAP_SPIRAM);
+    journal->pending = journal->slots ? &journal->slots[PORTAL_JOURNAL_QUEUE_LEN] : NULL;
+    // Internal DMA-capable memory lets the SD driver write the block without bouncing it
+    journal->block = heap_caps_malloc(PORTAL_JOURNAL_BLOCK_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!journal->slots || !journal->block ||
+        xTaskCreate(writer_task, "portal_journal", 4096, journal, priority, &journal->task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start portal journal");
+        heap_caps_free(journal->slots);
+        heap_caps_free(journal->block);
+        journal->slots = NULL;
+        journal->pending = NULL;
+        journal->block = NULL;
+        journal->task = NULL;
+        return false;
+    }
+    return true;
+}
+
+portal_journal_entry_t *portal_journal_begin(portal_journal_t *journal, TickType_t wait)
+{
+    if (!journal || !journal->task) {
+        return NULL;
+    }
+
+    uint32_t head = atomic_load_explicit(&journal->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&journal->tail, memory_order_acquire) >= PORTAL_JOURNAL_QUEUE_LEN) {
+        if (wait == 0) {
+            journal->stats.dropped++;
+            return NULL;
+        }
+        // The writer frees a whole batch at once, so a short poll is enough
+        vTaskDelay(1);
+        wait--;
+    }
+    portal_journal_entry_t *entry = &journal->slots[head & QUEUE_MASK];
+    entry->len = 0;
+    entry->summary[0] = '\0';
+    return entry;
+}
+
+void portal_journal_set_record(portal_journal_entry_t *entry, const char *ssid, const char *form_data)
+{
+    // Without the terminator the next submission would merge into this one, in the file and in the portal index
+    static const char record_end[] = "\n---\n";
+    int head = snprintf(entry->text, sizeof(entry->text), "SSID: %.32s\nData: ", ssid);
+    size_t room = sizeof(entry->text) - 1 - (size_t)head - (sizeof(record_end) - 1);
+    size_t data_len = strnlen(form_data, room);
+    memcpy(entry->text + head, form_data, data_len);
+    memcpy(entry->text + head + data_len, record_end, sizeof(record_end));
+    entry->len = (uint16_t)(head + data_len + sizeof(record_end) - 1);
+}
+
+void portal_journal_publish(portal_journal_t *journal)
+{
+    uint32_t head = atomic_load_explicit(&journal->head, memory_order_relaxed);
+    portal_journal_entry_t *entry = &journal->slots[head & QUEUE_MASK];
+    if (entry->len > sizeof(entry->text)) {
+        entry->len = sizeof(entry->text);
+    }
+
+    atomic_store_explicit(&journal->head, head + 1, memory_order_release);
+    journal->stats.enqueued++;
+    xTaskNotifyGive(journal->task);
+}
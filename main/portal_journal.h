@@ -0,0 +1,104 @@
+#ifndef PORTAL_JOURNAL_H
+#define PORTAL_JOURNAL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Background writer for captured portal submissions.
+ *
+ * The HTTP handler fills a slot of a lock-free single-producer /
+ * single-consumer ring and returns; it never touches the file system or
+ * the display. The writer task drains the ring after a short coalescing
+ * delay, packs the entries into a 4 KB block that mirrors the file's
+ * block-aligned tail, and writes only whole blocks or the partial tail at
+ * its aligned offset. fsync runs at most every PORTAL_JOURNAL_SYNC_MS and
+ * the file is closed again after PORTAL_JOURNAL_IDLE_CLOSE_MS without
+ * traffic.
+ *
+ * The commit callback reports entries once they are synced: only then does
+ * the file size on the card include them, so a reader that opens the file
+ * from the callback (portal_index_sync()) finds them.
+ *
+ * The producer side must only ever be called from one task (the httpd
+ * server task); the commit callback runs on the writer task.
+ */
+
+#define PORTAL_JOURNAL_QUEUE_LEN        32      // power of two
+#define PORTAL_JOURNAL_ENTRY_MAX        640
+#define PORTAL_JOURNAL_SUMMARY_MAX      160
+#define PORTAL_JOURNAL_BLOCK_SIZE       4096
+#define PORTAL_JOURNAL_COALESCE_MS      50
+#define PORTAL_JOURNAL_SYNC_MS          1000
+#define PORTAL_JOURNAL_IDLE_CLOSE_MS    5000
+
+typedef struct {
+    uint16_t len;
+    char text[PORTAL_JOURNAL_ENTRY_MAX];            // appended to the file as is
+    char summary[PORTAL_JOURNAL_SUMMARY_MAX];       // for the commit callback, not persisted
+} portal_journal_entry_t;
+
+// Called after entries were synced to the file; last is the newest of them.
+typedef void (*portal_journal_commit_cb_t)(const portal_journal_entry_t *last, uint32_t count, void *user_data);
+
+typedef struct {
+    uint32_t enqueued;
+    uint32_t dropped;           // ring stayed full
+    uint32_t committed;
+    uint32_t blocks_written;    // whole 4 KB blocks
+    uint32_t tail_writes;       // partial tail rewrites
+    uint32_t syncs;
+    uint32_t write_errors;
+} portal_journal_stats_t;
+
+typedef struct {
+    char path[64];
+    portal_journal_entry_t *slots;  // PSRAM
+    portal_journal_entry_t *pending;        // newest entry written but not synced yet
+    uint32_t pending_count;
+    _Atomic uint32_t head;          // written by the producer
+    _Atomic uint32_t tail;          // written by the writer task
+    TaskHandle_t task;
+
+    int fd;
+    uint8_t *block;                 // file bytes from block_offset on
+    size_t block_used;
+    off_t block_offset;
+    bool unsynced;
+    TickType_t last_sync;
+
+    portal_journal_commit_cb_t commit_cb;
+    void *user_data;
+    portal_journal_stats_t stats;
+} portal_journal_t;
+
+bool portal_journal_start(
+    portal_journal_t *journal,
+    const char *path,
+    portal_journal_commit_cb_t commit_cb,
+    void *user_data,
+    UBaseType_t priority);
+
+// Producer: claim the next free slot, waiting up to wait ticks for the writer to free one.
+// NULL when the ring stayed full (counted as dropped).
+portal_journal_entry_t *portal_journal_begin(portal_journal_t *journal, TickType_t wait);
+// Producer: fill the slot's text with a portals.txt record ("SSID: ...\nData: ...\n---\n").
+// An oversized form is cut short, never the "---" line that ends the record.
+void portal_journal_set_record(portal_journal_entry_t *entry, const char *ssid, const char *form_data);
+// Producer: hand the slot from portal_journal_begin() to the writer.
+void portal_journal_publish(portal_journal_t *journal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+#include "render_bench.h"
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "ui_perf.h"
+#include "render_cores.h"
+
+static const char *TAG = "render_bench";
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+typedef struct {
+    uint64_t render_total_us;
+    uint64_t flush_total_us;
+    uint64_t frame_total_us;
+} render_bench_sums_t;
+
+typedef struct {
+    lv_display_t *disp;
+    lv_obj_t *scene;
+    lv_timer_t *timer;
+    render_bench_done_cb_t done;
+    void *user;
+    uint32_t saved_tiles;
+    uint32_t frame;             // frames forced so far, over all runs
+    uint8_t run;                // run the frame being drawn belongs to
+    bool measuring;
+    bool checksumming;
+    uint32_t checksum;
+    int64_t start_us;
+    render_bench_sums_t sums[RENDER_BENCH_MAX_RUNS];
+    render_bench_result_t result;
+} render_bench_t;
+
+static render_bench_t s_bench;
+
+static void frame_cb(const ui_perf_frame_t *frame, void *user)
+{
+    (void)user;
+    if (!s_bench.measuring) {
+        return;
+    }
+    render_bench_run_t *run = &s_bench.result.runs[s_bench.run];
+    render_bench_sums_t *sums = &s_bench.sums[s_bench.run];
+    if (run->frames == 0 || frame->render_us < run->render_min_us) {
+        run->render_min_us = frame->render_us;
+    }
+    run->render_max_us = LV_MAX(run->render_max_us, frame->render_us);
+    run->frames++;
+    sums->render_total_us += frame->render_us;
+    sums->flush_total_us += frame->flush_us;
+    sums->frame_total_us += frame->frame_us;
+}
+
+// Hash what is about to be flushed, before the flush callback swaps or rotates it
+static void flush_start_cb(lv_event_t *e)
+{
+    if (!s_bench.checksumming) {
+        return;
+    }
+    const lv_area_t *area = lv_event_get_param(e);
+    lv_draw_buf_t *buf = lv_display_get_buf_active(s_bench.disp);
+    if (!area || !buf || !buf->data) {
+        return;
+    }
+
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(s_bench.disp));
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    const uint8_t *row = buf->data;
+    if (buf->header.w != (uint32_t)w || buf->header.h != (uint32_t)h) {
+        // Screen-sized buffer (full refresh or direct mode): the area sits inside it
+        int32_t x = area->x1 - lv_display_get_offset_x(s_bench.disp);
+        int32_t y = area->y1 - lv_display_get_offset_y(s_bench.disp);
+        row += (size_t)y * buf->header.stride + (size_t)x * px_size;
+    }
+
+    uint32_t hash = s_bench.checksum;
+    for (int32_t y = 0; y < h; y++, row += buf->header.stride) {
+        for (uint32_t i = 0; i < (uint32_t)w * px_size; i++) {
+            hash = (hash ^ row[i]) * FNV_PRIME;
+        }
+    }
+    s_bench.checksum = hash;
+}
+
+static void finish(void)
+{
+    lv_timer_delete(s_bench.timer);
+    s_bench.timer = NULL;
+    ui_perf_set_frame_cb(NULL, NULL);
+    lv_display_remove_event_cb_with_user_data(s_bench.disp, flush_start_cb, &s_bench);
+    lv_display_set_tile_cnt(s_bench.disp, s_bench.saved_tiles);
+
+    render_bench_result_t *r = &s_bench.result;
+    r->output_matches = true;
+    for (uint8_t i = 0; i < r->run_count; i++) {
+        render_bench_run_t *run = &r->runs[i];
+        if (run->frames > 0) {
+            run->render_avg_us = (uint32_t)(s_bench.sums[i].render_total_us / run->frames);
+            run->flush_avg_us = (uint32_t)(s_bench.sums[i].flush_total_us / run->frames);
+            run->frame_avg_us = (uint32_t)(s_bench.sums[i].frame_total_us / run->frames);
+        }
+        if (run->frames > 0 && r->runs[0].frames > 0 && run->checksum != r->runs[0].checksum) {
+            r->output_matches = false;
+        }
+    }
+    const render_bench_run_t *last = &r->runs[r->run_count - 1];
+    r->speedup_x100 = last->render_avg_us > 0
+                      ? (uint32_t)((uint64_t)r->runs[0].render_avg_us * 100 / last->render_avg_us) : 100;
+    r->elapsed_ms = (uint32_t)((esp_timer_get_time() - s_bench.start_us) / 1000);
+
+    render_bench_done_cb_t done = s_bench.done;
+    lv_obj_t *scene = s_bench.scene;
+    void *user = s_bench.user;
+    s_bench.scene = NULL;
+    if (done) {
+        done(scene, r, user);
+    }
+}
+
+static void bench_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    uint8_t runs = s_bench.result.run_count;
+    if (!lv_obj_is_valid(s_bench.scene)) {
+        ESP_LOGW(TAG, "Scene deleted, benchmark stopped");
+        s_bench.scene = NULL;
+        finish();
+        return;
+    }
+    if (s_bench.frame >= runs * (RENDER_BENCH_WARMUP_FRAMES + RENDER_BENCH_FRAMES)) {
+        finish();
+        return;
+    }
+
+    // Runs take turns frame by frame, so both see the same background load
+    uint32_t n = s_bench.frame / runs;
+    s_bench.run = (uint8_t)(s_bench.frame % runs);
+    s_bench.frame++;
+    lv_display_set_tile_cnt(s_bench.disp, s_bench.result.runs[s_bench.run].tiles);
+
+    s_bench.measuring = n >= RENDER_BENCH_WARMUP_FRAMES;
+    s_bench.checksumming = n == RENDER_BENCH_WARMUP_FRAMES;
+    s_bench.checksum = FNV_OFFSET;
+    lv_obj_invalidate(s_bench.scene);
+    lv_refr_now(s_bench.disp);
+    if (s_bench.checksumming) {
+        s_bench.result.runs[s_bench.run].checksum = s_bench.checksum;
+    }
+    s_bench.measuring = false;
+    s_bench.checksumming = false;
+}
+
+bool render_bench_start(lv_display_t *disp, lv_obj_t *scene, render_bench_done_cb_t done, void *user)
+{
+    if (s_bench.timer || !disp || !scene) {
+        return false;
+    }
+    memset(&s_bench, 0, sizeof(s_bench));
+    s_bench.disp = disp;
+    s_bench.scene = scene;
+    s_bench.done = done;
+    s_bench.user = user;
+    s_bench.saved_tiles = lv_display_get_tile_cnt(disp);
+    s_bench.start_us = esp_timer_get_time();
+
+    render_bench_result_t *r = &s_bench.result;
+    r->draw_threads = render_cores_worker_count();
+    r->runs[r->run_count++].tiles = 1;
+    if (r->draw_threads > 1) {
+        r->runs[r->run_count++].tiles = r->draw_threads;
+    }
+
+    ui_perf_set_frame_cb(frame_cb, NULL);
+    lv_display_add_event_cb(disp, flush_start_cb, LV_EVENT_FLUSH_START, &s_bench);
+    s_bench.timer = lv_timer_create(bench_timer_cb, RENDER_BENCH_PERIOD_MS, NULL);
+    ESP_LOGI(TAG, "Rendering the scene %d times at %u tile counts, %u draw threads",
+             RENDER_BENCH_WARMUP_FRAMES + RENDER_BENCH_FRAMES, (unsigned)r->run_count, (unsigned)r->draw_threads);
+    return true;
+}
+
+bool render_bench_running(void)
+{
+    return s_bench.timer != NULL;
+}
+
+void render_bench_log(const render_bench_result_t *r)
+{
+    ESP_LOGI(TAG, "%u draw threads, %lu ms", (unsigned)r->draw_threads, (unsigned long)r->elapsed_ms);
+    ESP_LOGI(TAG, "  %5s %6s %10s %10s %10s %10s %10s %10s", "tiles", "frames",
+             "render_avg", "render_min", "render_max", "flush_avg", "frame_avg", "checksum");
+    for (uint8_t i = 0; i < r->run_count; i++) {
+        const render_bench_run_t *run = &r->runs[i];
+        ESP_LOGI(TAG, "  %5lu %6lu %10lu %10lu %10lu %10lu %10lu   %08lx", (unsigned long)run->tiles,
+                 (unsigned long)run->frames, (unsigned long)run->render_avg_us, (unsigned long)run->render_min_us,
+                 (unsigned long)run->render_max_us, (unsigned long)run->flush_avg_us,
+                 (unsigned long)run->frame_avg_us, (unsigned long)run->checksum);
+    }
+    if (r->run_count > 1) {
+        ESP_LOGI(TAG, "Render speedup %lu.%02lux with %lu tiles", (unsigned long)(r->speedup_x100 / 100),
+                 (unsigned long)(r->speedup_x100 % 100), (unsigned long)r->runs[r->run_count - 1].tiles);
+    }
+    if (!r->output_matches) {
+        ESP_LOGW(TAG, "Tiled output differs from single-tile output");
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Render benchmark: redraw a scene again and again, with the refreshed
+ * area split into 1 tile and into one tile per draw thread, and compare.
+ *
+ * The scene is built by the caller (the real tile grid and dashboard) and
+ * covers the screen. One frame is forced per timer tick with lv_refr_now(),
+ * alternating between the tile counts so both see the same conditions;
+ * touch input and other timers keep running between frames. Render time
+ * is the frame minus flushing (ui_perf's split), which is what the draw
+ * threads can speed up; the flush and rotation run on the LVGL task
+ * either way.
+ *
+ * The first measured frame of every tile count is also checksummed as
+ * it's flushed: the tiled output has to match the single-tile one pixel
+ * for pixel, or the run is flagged.
+ */
+
+#define RENDER_BENCH_MAX_RUNS       2
+#define RENDER_BENCH_WARMUP_FRAMES  2       // per run, not measured
+#define RENDER_BENCH_FRAMES         24      // measured per run
+#define RENDER_BENCH_PERIOD_MS      5
+
+typedef struct {
+    uint32_t tiles;
+    uint32_t frames;
+    uint32_t render_avg_us;
+    uint32_t render_min_us;
+    uint32_t render_max_us;
+    uint32_t flush_avg_us;
+    uint32_t frame_avg_us;
+    uint32_t checksum;
+} render_bench_run_t;
+
+typedef struct {
+    uint8_t run_count;
+    render_bench_run_t runs[RENDER_BENCH_MAX_RUNS];   // single tile first
+    uint8_t draw_threads;
+    uint32_t speedup_x100;      // render time with one tile over the last run's
+    bool output_matches;
+    uint32_t elapsed_ms;
+} render_bench_result_t;
+
+// Called on the LVGL task when the run is over; the scene is still there for the callback to
+// delete, or NULL if it was deleted during the run
+typedef void (*render_bench_done_cb_t)(lv_obj_t *scene, const render_bench_result_t *result, void *user);
+
+// Start measuring scene on disp. Call with the display locked. False if a run is in progress.
+bool render_bench_start(lv_display_t *disp, lv_obj_t *scene, render_bench_done_cb_t done, void *user);
+bool render_bench_running(void);
+
+void render_bench_log(const render_bench_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
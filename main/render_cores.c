@@ -0,0 +1,90 @@
+#include "render_cores.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "lvgl.h"
+#include "src/osal/lv_os_private.h"
+
+static const char *TAG = "render_cores";
+
+static render_cores_worker_t s_workers[RENDER_CORES_MAX_WORKERS];
+static volatile uint8_t s_worker_count;
+
+#if LV_USE_OS == LV_OS_FREERTOS
+
+lv_result_t __real_lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                                  void (*callback)(void *), size_t stack_size, void *user_data);
+
+// Same as LVGL's own thread entry, which is static
+static void run_worker(void *arg)
+{
+    lv_thread_t *thread = (lv_thread_t *)arg;
+    thread->pvStartRoutine(thread->pTaskArg);
+    vTaskDelete(NULL);
+}
+
+lv_result_t __wrap_lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                                  void (*callback)(void *), size_t stack_size, void *user_data)
+{
+    uint8_t index = s_worker_count;
+    if (strcmp(name, "swdraw") != 0 || index >= RENDER_CORES_MAX_WORKERS) {
+        return __real_lv_thread_init(thread, name, prio, callback, stack_size, user_data);
+    }
+
+    uint8_t core = index % portNUM_PROCESSORS;
+    char task_name[configMAX_TASK_NAME_LEN];
+    snprintf(task_name, sizeof(task_name), "swdraw%u", (unsigned)index);
+
+    thread->pvStartRoutine = callback;
+    thread->pTaskArg = user_data;
+    if (xTaskCreatePinnedToCore(run_worker, task_name, (configSTACK_DEPTH_TYPE)(stack_size / sizeof(StackType_t)),
+                                thread, tskIDLE_PRIORITY + prio, &thread->xTaskHandle, core) != pdPASS) {
+        ESP_LOGE(TAG, "Can't start %s on core %u", task_name, (unsigned)core);
+        return LV_RESULT_INVALID;
+    }
+    s_workers[index].task = thread->xTaskHandle;
+    s_workers[index].core = core;
+    s_worker_count = index + 1;
+    return LV_RESULT_OK;
+}
+
+#endif
+
+uint8_t render_cores_worker_count(void)
+{
+    return s_worker_count;
+}
+
+bool render_cores_get_worker(uint8_t index, render_cores_worker_t *out)
+{
+    if (index >= s_worker_count || !out) {
+        return false;
+    }
+    *out = s_workers[index];
+    return true;
+}
+
+bool render_cores_is_worker(TaskHandle_t task)
+{
+    for (uint8_t i = 0; i < s_worker_count; i++) {
+        if (s_workers[i].task == task) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void render_cores_log(void)
+{
+    if (s_worker_count == 0) {
+        ESP_LOGI(TAG, "Rendering on the LVGL task, no draw threads");
+        return;
+    }
+    for (uint8_t i = 0; i < s_worker_count; i++) {
+        ESP_LOGI(TAG, "%s on core %u, priority %u, %u bytes of stack left",
+                 pcTaskGetName(s_workers[i].task), (unsigned)s_workers[i].core,
+                 (unsigned)uxTaskPriorityGet(s_workers[i].task),
+                 (unsigned)uxTaskGetStackHighWaterMark(s_workers[i].task));
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef RENDER_CORES_H
+#define RENDER_CORES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Software draw threads pinned one per core.
+ *
+ * With CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT > 1, LVGL splits each refreshed area
+ * into that many tiles and rasterizes them on its own draw threads, while
+ * the LVGL task waits. LVGL creates those threads unpinned, and IDF
+ * FreeRTOS can't pin a task after it was created, so lv_thread_init() is
+ * wrapped at link time (-Wl,--wrap, see CMakeLists.txt): LVGL's "swdraw"
+ * threads are created here instead, worker N on core N % cores and named
+ * swdrawN. Every other LVGL thread goes to LVGL's own lv_thread_init().
+ *
+ * Locking: the LVGL task takes the display lock, then LVGL's own lock in
+ * lv_timer_handler(), then hands draw tasks to the workers and waits for
+ * them. Workers only touch draw tasks and LVGL's internally locked caches;
+ * they must never take the display lock (it's held by the task waiting
+ * for them), so ui_perf_lock() refuses them. Widgets are only touched by
+ * tasks holding the display lock, as before.
+ */
+
+#define RENDER_CORES_MAX_WORKERS    4
+
+typedef struct {
+    TaskHandle_t task;
+    uint8_t core;
+} render_cores_worker_t;
+
+// Workers started so far; 0 unless LVGL runs on an OS with more than one draw unit
+uint8_t render_cores_worker_count(void);
+bool render_cores_get_worker(uint8_t index, render_cores_worker_t *out);
+bool render_cores_is_worker(TaskHandle_t task);
+
+// One line per worker: name, core and stack left
+void render_cores_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
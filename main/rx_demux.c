@@ -0,0 +1,417 @@
+#include "rx_demux.h"
+
+#include <regex.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/message_buffer.h"
+#include "freertos/stream_buffer.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "rx_demux";
+
+struct rx_demux_sub {
+    rx_demux_sub_t *next;
+    rx_demux_t *demux;
+    char *prefix;
+    size_t prefix_len;
+    bool use_regex;
+    regex_t regex;
+    uint64_t record_kinds;      // non-zero: stream is a message buffer of lines and records
+    StreamBufferHandle_t stream;
+    StaticStreamBuffer_t stream_struct;
+    uint8_t *stream_storage;
+    line_framer_t framer;       // re-frames the stream for rx_demux_next_line()
+    uint8_t *line_ring;
+    char *line_scratch;
+    uint32_t dropped_lines;
+    uint32_t dropped_records;
+};
+
+static bool sub_matches(const rx_demux_sub_t *sub, const char *line)
+{
+    if (sub->use_regex) {
+        return regexec(&sub->regex, line, 0, NULL, 0) == 0;
+    }
+    return sub->prefix_len == 0 || strncmp(line, sub->prefix, sub->prefix_len) == 0;
+}
+
+static void dispatch_line(rx_demux_t *demux, const line_view_t *line)
+{
+    bool claimed = false;
+
+    xSemaphoreTake(demux->lock, portMAX_DELAY);
+    for (rx_demux_sub_t *sub = demux->subs; sub; sub = sub->next) {
+        if (!sub_matches(sub, line->text)) {
+            continue;
+        }
+        claimed = true;
+        if (sub->record_kinds) {
+            // Message of the line and its NUL, which doubles as kind 0
+            size_t len = line->len < RX_DEMUX_SUB_LINE_MAX ? line->len : RX_DEMUX_SUB_LINE_MAX - 1;
+            char end = line->text[len];
+            line->text[len] = '\0';
+            if (xMessageBufferSend(sub->stream, line->text, len + 1, 0) == 0) {
+                sub->dropped_lines++;
+                demux->stats.dropped_lines++;
+            }
+            line->text[len] = end;
+            continue;
+        }
+        // Whole lines only: a partial write would glue two lines together for the reader
+        if (xStreamBufferSpacesAvailable(sub->stream) < line->len + 1) {
+            sub->dropped_lines++;
+            demux->stats.dropped_lines++;
+            continue;
+        }
+        // One send, so a reader never wakes on a line without its terminator. The view's NUL byte
+        // is ours until the next framer call, borrow it for the '\n'.
+        line->text[line->len] = '\n';
+        xStreamBufferSend(sub->stream, line->text, line->len + 1, 0);
+        line->text[line->len] = '\0';
+    }
+    xSemaphoreGive(demux->lock);
+
+    demux->stats.lines++;
+    if (!claimed) {
+        demux->stats.unclaimed_lines++;
+    }
+}
+
+bool rx_demux_dispatch_record(rx_demux_t *demux, uint8_t kind, const void *record, size_t len)
+{
+    if (!demux->record_msg || kind == 0 || kind >= RX_DEMUX_RECORD_KINDS || len > RX_DEMUX_RECORD_MAX) {
+        return false;
+    }
+    bool claimed = false;
+    bool copied = false;
+
+    xSemaphoreTake(demux->lock, portMAX_DELAY);
+    for (rx_demux_sub_t *sub = demux->subs; sub; sub = sub->next) {
+        if (!(sub->record_kinds & (1ULL << kind))) {
+            continue;
+        }
+        // The kind goes last, where a line has its NUL
+        if (!copied) {
+            memcpy(demux->record_msg, record, len);
+            demux->record_msg[len] = kind;
+            copied = true;
+        }
+        claimed = true;
+        if (xMessageBufferSend(sub->stream, demux->record_msg, len + 1, 0) == 0) {
+            sub->dropped_records++;
+            demux->stats.dropped_records++;
+        }
+    }
+    xSemaphoreGive(demux->lock);
+
+    if (claimed) {
+        demux->stats.records++;
+    }
+    return claimed;
+}
+
+static void rx_demux_task(void *arg)
+{
+    rx_demux_t *demux = (rx_demux_t *)arg;
+    line_view_t line;
+
+    ESP_LOGI(TAG, "[%s] Reader task started", demux->name);
+
+    while (1) {
+        if (line_framer_next_line(&demux->framer, &line, demux->read_timeout)) {
+            dispatch_line(demux, &line);
+        }
+    }
+}
+
+bool rx_demux_start(
+    rx_demux_t *demux,
+    const char *name,
+    uint8_t *ring,
+    char *scratch,
+    size_t capacity,
+    line_framer_read_fn_t read_fn,
+    void *read_ctx,
+    UBaseType_t priority)
+{
+    if (!demux) {
+        return false;
+    }
+
+    memset(demux, 0, sizeof(*demux));
+    demux->name = name;
+    demux->read_timeout = pdMS_TO_TICKS(100);
+
+    if (!line_framer_init(&demux->framer, ring, scratch, capacity, read_fn, read_ctx)) {
+        return false;
+    }
+
+    demux->lock = xSemaphoreCreateMutex();
+    if (!demux->lock) {
+        return false;
+    }
+    // Without it records are refused and the caller keeps sending text
+    demux->record_msg = heap_caps_malloc(RX_DEMUX_RECORD_MAX + 1, MALLOC_CAP_SPIRAM);
+
+    if (xTaskCreate(rx_demux_task, "rx_demux", 4096, demux, priority, &demux->task) != pdPASS) {
+        vSemaphoreDelete(demux->lock);
+        demux->lock = NULL;
+        heap_caps_free(demux->record_msg);
+        demux->record_msg = NULL;
+        return false;
+    }
+    return true;
+}
+
+static int sub_stream_read(void *user_data, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    rx_demux_sub_t *sub = (rx_demux_sub_t *)user_data;
+    return (int)xStreamBufferReceive(sub->stream, dst, len, (TickType_t)timeout);
+}
+
+static void sub_free(rx_demux_sub_t *sub)
+{
+    if (sub->stream) {
+        vStreamBufferDelete(sub->stream);
+    }
+    if (sub->use_regex) {
+        regfree(&sub->regex);
+    }
+    free(sub->prefix);
+    heap_caps_free(sub->stream_storage);
+    heap_caps_free(sub->line_ring);
+    heap_caps_free(sub->line_scratch);
+    free(sub);
+}
+
+static rx_demux_sub_t *sub_create(rx_demux_t *demux, uint64_t record_kinds)
+{
+    if (!demux || !demux->lock) {
+        return NULL;
+    }
+
+    rx_demux_sub_t *sub = calloc(1, sizeof(*sub));
+    if (!sub) {
+        return NULL;
+    }
+    sub->demux = demux;
+    sub->record_kinds = record_kinds;
+
+    // Bulk storage goes to PSRAM, only the control blocks stay internal
+    sub->stream_storage = heap_caps_malloc(RX_DEMUX_SUB_BUFFER_SIZE + 1, MALLOC_CAP_SPIRAM);
+    sub->line_ring = heap_caps_malloc(RX_DEMUX_SUB_LINE_MAX + 1, MALLOC_CAP_SPIRAM);
+    sub->line_scratch = heap_caps_malloc(RX_DEMUX_SUB_LINE_MAX + 1, MALLOC_CAP_SPIRAM);
+    if (!sub->stream_storage || !sub->line_ring || !sub->line_scratch) {
+        sub_free(sub);
+        return NULL;
+    }
+
+    if (record_kinds) {
+        sub->stream = xMessageBufferCreateStatic(RX_DEMUX_SUB_BUFFER_SIZE, sub->stream_storage, &sub->stream_struct);
+    } else {
+        sub->stream = xStreamBufferCreateStatic(RX_DEMUX_SUB_BUFFER_SIZE, 1, sub->stream_storage, &sub->stream_struct);
+    }
+    if (!sub->stream) {
+        sub_free(sub);
+        return NULL;
+    }
+    line_framer_init(&sub->framer, sub->line_ring, sub->line_scratch, RX_DEMUX_SUB_LINE_MAX, sub_stream_read, sub);
+    return sub;
+}
+
+static void sub_attach(rx_demux_sub_t *sub)
+{
+    rx_demux_t *demux = sub->demux;
+    xSemaphoreTake(demux->lock, portMAX_DELAY);
+    sub->next = demux->subs;
+    demux->subs = sub;
+    xSemaphoreGive(demux->lock);
+}
+
+static rx_demux_sub_t *subscribe_prefix(rx_demux_t *demux, const char *prefix, uint64_t record_kinds)
+{
+    rx_demux_sub_t *sub = sub_create(demux, record_kinds);
+    if (!sub) {
+        ESP_LOGE(TAG, "Failed to create subscriber");
+        return NULL;
+    }
+
+    if (prefix && prefix[0]) {
+        sub->prefix = strdup(prefix);
+        if (!sub->prefix) {
+            sub_free(sub);
+            return NULL;
+        }
+        sub->prefix_len = strlen(prefix);
+    }
+
+    sub_attach(sub);
+    return sub;
+}
+
+rx_demux_sub_t *rx_demux_subscribe(rx_demux_t *demux, const char *prefix)
+{
+    return subscribe_prefix(demux, prefix, 0);
+}
+
+rx_demux_sub_t *rx_demux_subscribe_records(rx_demux_t *demux, const char *prefix, uint64_t kinds)
+{
+    // Bit 0 would make lines look like records
+    kinds &= ~1ULL;
+    if (kinds == 0) {
+        return NULL;
+    }
+    return subscribe_prefix(demux, prefix, kinds);
+}
+
+rx_demux_sub_t *rx_demux_subscribe_regex(rx_demux_t *demux, const char *pattern)
+{
+    if (!pattern) {
+        return NULL;
+    }
+
+    rx_demux_sub_t *sub = sub_create(demux, 0);
+    if (!sub) {
+        ESP_LOGE(TAG, "Failed to create subscriber");
+        return NULL;
+    }
+
+    if (regcomp(&sub->regex, pattern, REG_EXTENDED | REG_NOSUB) != 0) {
+        ESP_LOGE(TAG, "Invalid subscriber pattern: %s", pattern);
+        sub_free(sub);
+        return NULL;
+    }
+    sub->use_regex = true;
+
+    sub_attach(sub);
+    return sub;
+}
+
+void rx_demux_unsubscribe(rx_demux_sub_t *sub)
+{
+    if (!sub) {
+        return;
+    }
+
+    rx_demux_t *demux = sub->demux;
+    xSemaphoreTake(demux->lock, portMAX_DELAY);
+    for (rx_demux_sub_t **link = &demux->subs; *link; link = &(*link)->next) {
+        if (*link == sub) {
+            *link = sub->next;
+            break;
+        }
+    }
+    xSemaphoreGive(demux->lock);
+
+    if (sub->dropped_lines > 0 || sub->dropped_records > 0) {
+        ESP_LOGW(TAG, "[%s] Subscriber dropped %u lines, %u records", demux->name,
+                 (unsigned)sub->dropped_lines, (unsigned)sub->dropped_records);
+    }
+    sub_free(sub);
+}
+
+// One message of a record subscription; the ring holds RX_DEMUX_SUB_LINE_MAX + 1 bytes
+static bool next_message(rx_demux_sub_t *sub, rx_demux_msg_t *out, TickType_t ticks_to_wait)
+{
+    uint8_t *msg = sub->line_ring;
+    size_t n = xMessageBufferReceive(sub->stream, msg, RX_DEMUX_SUB_LINE_MAX + 1, ticks_to_wait);
+    if (n == 0) {
+        return false;
+    }
+    out->kind = msg[n - 1];
+    out->len = n - 1;
+    if (out->kind == 0) {
+        out->record = NULL;
+        out->line.text = (char *)msg;
+        out->line.len = n - 1;
+        out->line.truncated = false;
+    } else {
+        out->record = msg;
+        out->line.text = NULL;
+        out->line.len = 0;
+        out->line.truncated = false;
+    }
+    return true;
+}
+
+bool rx_demux_next(rx_demux_sub_t *sub, rx_demux_msg_t *out, TickType_t ticks_to_wait)
+{
+    if (!sub) {
+        vTaskDelay(ticks_to_wait > 0 ? ticks_to_wait : 1);
+        return false;
+    }
+    if (sub->record_kinds) {
+        return next_message(sub, out, ticks_to_wait);
+    }
+    if (!line_framer_next_line(&sub->framer, &out->line, (uint32_t)ticks_to_wait)) {
+        return false;
+    }
+    out->record = NULL;
+    out->kind = 0;
+    out->len = out->line.len;
+    return true;
+}
+
+bool rx_demux_next_line(rx_demux_sub_t *sub, line_view_t *out, TickType_t ticks_to_wait)
+{
+    if (!sub) {
+        vTaskDelay(ticks_to_wait > 0 ? ticks_to_wait : 1);
+        return false;
+    }
+    if (!sub->record_kinds) {
+        return line_framer_next_line(&sub->framer, out, (uint32_t)ticks_to_wait);
+    }
+
+    TimeOut_t timeout;
+    TickType_t remaining = ticks_to_wait;
+    rx_demux_msg_t msg;
+    vTaskSetTimeOutState(&timeout);
+    while (next_message(sub, &msg, remaining)) {
+        if (!msg.record) {
+            *out = msg.line;
+            return true;
+        }
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            break;
+        }
+    }
+    return false;
+}
+
+int rx_demux_read(rx_demux_sub_t *sub, void *data, size_t len, TickType_t ticks_to_wait)
+{
+    if (!sub) {
+        vTaskDelay(ticks_to_wait > 0 ? ticks_to_wait : 1);
+        return 0;
+    }
+    if (sub->record_kinds) {
+        return 0;
+    }
+
+    // Same contract as uart_read_bytes(): return when len bytes arrived or the time is up
+    TimeOut_t timeout;
+    TickType_t remaining = ticks_to_wait;
+    size_t got = 0;
+
+    vTaskSetTimeOutState(&timeout);
+    while (got < len) {
+        got += xStreamBufferReceive(sub->stream, (uint8_t *)data + got, len - got, remaining);
+        if (got >= len || xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            break;
+        }
+    }
+    return (int)got;
+}
+
+void rx_demux_clear(rx_demux_sub_t *sub)
+{
+    if (!sub) {
+        return;
+    }
+    // The reader task may be sending to the stream; the reset must not interleave with that
+    xSemaphoreTake(sub->demux->lock, portMAX_DELAY);
+    xStreamBufferReset(sub->stream);
+    line_framer_reset(&sub->framer);
+    xSemaphoreGive(sub->demux->lock);
+}
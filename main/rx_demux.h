@@ -0,0 +1,105 @@
+#ifndef RX_DEMUX_H
+#define RX_DEMUX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "line_framer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Receive demultiplexer: a single reader task owns a transport, frames
+ * incoming bytes into lines once and copies every line to each subscriber
+ * whose filter matches. Subscribers only see lines that arrive after they
+ * subscribed, so subscribing before sending a command replaces flushing
+ * the port.
+ *
+ * Each subscriber has its own stream buffer. Lines are written whole with
+ * a trailing '\n'; when a subscriber falls behind, the line is dropped for
+ * that subscriber only and counted.
+ *
+ * The read callback may also hand over records, structs that arrived in
+ * binary and need no parsing, with rx_demux_dispatch_record(). Only
+ * subscribers that asked for the record's kind receive it. Their lines and
+ * records share one message buffer, so they are read in arrival order with
+ * rx_demux_next().
+ */
+
+#define RX_DEMUX_SUB_BUFFER_SIZE    8192
+#define RX_DEMUX_SUB_LINE_MAX       1024    // power of two, longer lines are truncated
+#define RX_DEMUX_RECORD_MAX         RX_DEMUX_SUB_LINE_MAX
+#define RX_DEMUX_RECORD_KINDS       64      // kinds 1..63, 0 marks a line
+
+typedef struct rx_demux_sub rx_demux_sub_t;
+
+typedef struct {
+    uint32_t lines;
+    uint32_t unclaimed_lines;   // no subscriber matched
+    uint32_t dropped_lines;     // a matching subscriber's buffer was full
+    uint32_t records;           // taken by at least one subscriber
+    uint32_t dropped_records;
+} rx_demux_stats_t;
+
+// A line or a record from rx_demux_next(), valid until the next call on the subscription
+typedef struct {
+    const void *record;         // NULL for a line
+    uint8_t kind;
+    size_t len;
+    line_view_t line;           // when record is NULL
+} rx_demux_msg_t;
+
+typedef struct {
+    const char *name;
+    line_framer_t framer;
+    SemaphoreHandle_t lock;     // guards the subscriber list
+    rx_demux_sub_t *subs;
+    TaskHandle_t task;
+    TickType_t read_timeout;
+    uint8_t *record_msg;        // record plus kind byte, reader task only
+    rx_demux_stats_t stats;
+} rx_demux_t;
+
+// Start the reader task. ring and scratch are handed to the line framer (capacity + 1 bytes each).
+bool rx_demux_start(
+    rx_demux_t *demux,
+    const char *name,
+    uint8_t *ring,
+    char *scratch,
+    size_t capacity,
+    line_framer_read_fn_t read_fn,
+    void *read_ctx,
+    UBaseType_t priority);
+
+// NULL or empty prefix subscribes to every line.
+rx_demux_sub_t *rx_demux_subscribe(rx_demux_t *demux, const char *prefix);
+// POSIX extended regular expression, matched anywhere in the line.
+rx_demux_sub_t *rx_demux_subscribe_regex(rx_demux_t *demux, const char *pattern);
+// Lines like rx_demux_subscribe(), plus records whose kind bit is set in kinds.
+rx_demux_sub_t *rx_demux_subscribe_records(rx_demux_t *demux, const char *prefix, uint64_t kinds);
+void rx_demux_unsubscribe(rx_demux_sub_t *sub);
+
+// Reader side: copy a record to every subscriber of its kind. Returns false when nobody
+// takes that kind, so the caller can pass the data on as text instead.
+bool rx_demux_dispatch_record(rx_demux_t *demux, uint8_t kind, const void *record, size_t len);
+
+// Next matching line, valid until the next call on this subscription. Records are skipped.
+bool rx_demux_next_line(rx_demux_sub_t *sub, line_view_t *out, TickType_t ticks_to_wait);
+// Next line or record.
+bool rx_demux_next(rx_demux_sub_t *sub, rx_demux_msg_t *out, TickType_t ticks_to_wait);
+// Matching lines as a '\n' separated byte stream; waits like uart_read_bytes().
+// Not for record subscriptions, which always return 0.
+int rx_demux_read(rx_demux_sub_t *sub, void *data, size_t len, TickType_t ticks_to_wait);
+// Drop everything queued for this subscription.
+void rx_demux_clear(rx_demux_sub_t *sub);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * LVGL configuration of the host tests: the firmware's color depth and
+ * fonts, no OS, and the heap routed through lv_mem_host.c so that tests
+ * can count allocations. Options not set here keep LVGL's defaults.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH          16
+
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM
+#define LV_USE_STDLIB_STRING    LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF   LV_STDLIB_CLIB
+
+#define LV_USE_OS               LV_OS_NONE
+#define LV_USE_LOG              0
+#define LV_BUILD_EXAMPLES       0
+#define LV_BUILD_DEMOS          0
+
+#define LV_FONT_MONTSERRAT_8    1
+#define LV_FONT_MONTSERRAT_10   1
+#define LV_FONT_MONTSERRAT_12   1
+#define LV_FONT_MONTSERRAT_14   1
+#define LV_FONT_MONTSERRAT_16   1
+#define LV_FONT_MONTSERRAT_18   1
+#define LV_FONT_MONTSERRAT_20   1
+#define LV_FONT_MONTSERRAT_22   1
+#define LV_FONT_MONTSERRAT_24   1
+#define LV_FONT_MONTSERRAT_26   1
+#define LV_FONT_MONTSERRAT_28   1
+#define LV_FONT_MONTSERRAT_30   1
+#define LV_FONT_MONTSERRAT_32   1
+#define LV_FONT_MONTSERRAT_34   1
+#define LV_FONT_MONTSERRAT_36   1
+#define LV_FONT_MONTSERRAT_38   1
+#define LV_FONT_MONTSERRAT_40   1
+#define LV_FONT_MONTSERRAT_42   1
+#define LV_FONT_MONTSERRAT_44   1
+#define LV_FONT_MONTSERRAT_46   1
+#define LV_FONT_MONTSERRAT_48   1
+#define LV_FONT_UNSCII_8        1
+#define LV_FONT_UNSCII_16       1
+
+#endif
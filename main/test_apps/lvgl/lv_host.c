@@ -0,0 +1,125 @@
+#include "lv_host.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <time.h>
+
+static lv_host_heap_t s_heap;
+static void *s_draw_buf;
+
+void lv_mem_init(void)
+{
+}
+
+void lv_mem_deinit(void)
+{
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size)
+{
+    void *p = malloc(size);
+    if (p) {
+        size_t usable = malloc_usable_size(p);
+        s_heap.allocs++;
+        s_heap.bytes_allocated += usable;
+        s_heap.bytes_live += (int64_t)usable;
+    }
+    return p;
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    size_t old = p ? malloc_usable_size(p) : 0;
+    void *q = realloc(p, new_size);
+    if (q) {
+        size_t usable = malloc_usable_size(q);
+        if (!p || usable > old) {
+            s_heap.allocs++;
+            s_heap.bytes_allocated += usable - old;
+        }
+        s_heap.bytes_live += (int64_t)usable - (int64_t)old;
+    }
+    return q;
+}
+
+void lv_free_core(void *p)
+{
+    if (p) {
+        s_heap.frees++;
+        s_heap.bytes_live -= (int64_t)malloc_usable_size(p);
+    }
+    free(p);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    LV_UNUSED(mon_p);
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    return LV_RESULT_OK;
+}
+
+void lv_host_get_heap(lv_host_heap_t *out)
+{
+    *out = s_heap;
+}
+
+static uint32_t host_tick_cb(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)(t.tv_sec * 1000 + t.tv_nsec / 1000000);
+}
+
+static void host_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+    lv_display_flush_ready(disp);
+}
+
+lv_display_t *lv_host_init(int32_t width, int32_t height)
+{
+    lv_init();
+    lv_tick_set_cb(host_tick_cb);
+
+    // A tenth of the screen per flush
+    uint32_t buf_size = (uint32_t)(width * height / 10) * 2;
+    s_draw_buf = malloc(buf_size);
+    lv_display_t *disp = lv_display_create(width, height);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, s_draw_buf, NULL, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, host_flush_cb);
+    return disp;
+}
+
+void lv_host_deinit(void)
+{
+    lv_deinit();
+    free(s_draw_buf);
+    s_draw_buf = NULL;
+}
+
+uint32_t lv_host_count_objects(lv_obj_t *obj)
+{
+    uint32_t n = 1;
+    uint32_t children = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        n += lv_host_count_objects(lv_obj_get_child(obj, (int32_t)i));
+    }
+    return n;
+}
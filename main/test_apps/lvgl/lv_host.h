@@ -0,0 +1,29 @@
+#ifndef LV_HOST_H
+#define LV_HOST_H
+
+/*
+ * LVGL on the host: a headless display that renders into a partial
+ * buffer and throws the pixels away, a millisecond tick from the
+ * monotonic clock, and heap counters for the custom allocator.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+typedef struct {
+    uint64_t allocs;            // lv_malloc and growing lv_realloc calls
+    uint64_t frees;
+    uint64_t bytes_allocated;   // total handed out
+    int64_t bytes_live;
+} lv_host_heap_t;
+
+// lv_init() plus a w x h RGB565 display that is made the default one
+lv_display_t *lv_host_init(int32_t width, int32_t height);
+void lv_host_deinit(void);
+
+void lv_host_get_heap(lv_host_heap_t *out);
+// Number of objects in the tree under obj, obj included
+uint32_t lv_host_count_objects(lv_obj_t *obj);
+
+#endif
@@ -0,0 +1,598 @@
+/*
+ * Host test and benchmark of the boot stage scheduler (boot_init.c) on the pthread FreeRTOS shim.
+ *
+ * Stages sleep for a simulated cost and record what they saw when they started: whether the stages
+ * they need had finished, and how many stages were running at once.
+ *
+ *   test_boot_init          functionality test: app_main's stage table; chains, wide fans, failures
+ *                           that skip their dependents transitively, cycles; 300 random dependency
+ *                           graphs with random failures against a model; the timeline log and the
+ *                           perf_trace spans
+ *   test_boot_init bench    app_main's stages with simulated costs, one after another as app_main
+ *                           ran them before against boot_init_run(); scheduler cost per stage
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "boot_init.h"
+#include "boot_stages.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "perf_trace.h"
+#include "test_common.h"
+
+#define RANDOM_GRAPHS   300
+#define LATE_MS         30      // slack for a loaded host
+
+// ---- instrumented stages ----
+
+typedef struct {
+    uint32_t cost_us;
+    bool fails;
+    uint32_t runs;
+    bool deps_done;             // every stage in after had ended when this one started
+} stage_sim_t;
+
+static boot_stage_t *s_stages;
+static size_t s_count;
+static stage_sim_t s_sim[BOOT_INIT_MAX_STAGES];
+static volatile uint32_t s_running;
+static uint32_t s_max_running;
+
+static bool stage_body(size_t index)
+{
+    stage_sim_t *sim = &s_sim[index];
+    uint32_t running = __atomic_fetch_add(&s_running, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&sim->runs, 1, __ATOMIC_SEQ_CST);
+    uint32_t max = __atomic_load_n(&s_max_running, __ATOMIC_SEQ_CST);
+    while (running + 1 > max && !__atomic_compare_exchange_n(&s_max_running, &max, running + 1, false,
+                                                               __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+    }
+
+    bool deps_done = true;
+    for (size_t d = 0; d < s_count; d++) {
+        if (s_stages[index].after & BOOT_STAGE(d)) {
+            deps_done = deps_done && s_stages[d].state == BOOT_STAGE_DONE && s_stages[d].end_us > 0 &&
+                        s_stages[d].end_us <= s_stages[index].start_us;
+        }
+    }
+    sim->deps_done = deps_done;
+
+    if (sim->cost_us >= 1000) {
+        vTaskDelay(pdMS_TO_TICKS(sim->cost_us / 1000));
+    } else if (sim->cost_us > 0) {
+        usleep(sim->cost_us);
+    }
+    __atomic_fetch_sub(&s_running, 1, __ATOMIC_SEQ_CST);
+    return !sim->fails;
+}
+
+// boot_stage_t.run takes no argument: one function per table index
+#define STAGE_FN(i) static bool stage_fn_##i(void) { return stage_body(i); }
+STAGE_FN(0) STAGE_FN(1) STAGE_FN(2) STAGE_FN(3) STAGE_FN(4) STAGE_FN(5) STAGE_FN(6) STAGE_FN(7)
+STAGE_FN(8) STAGE_FN(9) STAGE_FN(10) STAGE_FN(11) STAGE_FN(12) STAGE_FN(13) STAGE_FN(14) STAGE_FN(15)
+STAGE_FN(16) STAGE_FN(17) STAGE_FN(18) STAGE_FN(19) STAGE_FN(20) STAGE_FN(21) STAGE_FN(22) STAGE_FN(23)
+
+static bool (*const s_stage_fns[BOOT_INIT_MAX_STAGES])(void) = {
+    stage_fn_0, stage_fn_1, stage_fn_2, stage_fn_3, stage_fn_4, stage_fn_5, stage_fn_6, stage_fn_7,
+    stage_fn_8, stage_fn_9, stage_fn_10, stage_fn_11, stage_fn_12, stage_fn_13, stage_fn_14, stage_fn_15,
+    stage_fn_16, stage_fn_17, stage_fn_18, stage_fn_19, stage_fn_20, stage_fn_21, stage_fn_22, stage_fn_23,
+};
+
+static const char *const s_names[BOOT_INIT_MAX_STAGES] = {
+    "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",
+    "s12", "s13", "s14", "s15", "s16", "s17", "s18", "s19", "s20", "s21", "s22", "s23",
+};
+
+// Point stage i at stage_fn_i and reset what the stages record
+static void sim_reset(boot_stage_t *stages, size_t count)
+{
+    s_stages = stages;
+    s_count = count;
+    s_running = 0;
+    s_max_running = 0;
+    for (size_t i = 0; i < BOOT_INIT_MAX_STAGES; i++) {
+        s_sim[i].runs = 0;
+        s_sim[i].deps_done = false;
+    }
+    for (size_t i = 0; i < count && i < BOOT_INIT_MAX_STAGES; i++) {
+        stages[i].run = s_stage_fns[i];
+        if (!stages[i].name) {
+            stages[i].name = s_names[i];
+        }
+    }
+}
+
+static void sim_costs(const uint32_t *cost_ms, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        s_sim[i].cost_us = cost_ms[i] * 1000;
+        s_sim[i].fails = false;
+    }
+}
+
+// app_main's table from boot_stages.c, with stage_fn_i as stage i
+static void app_stages(boot_stage_t *stages)
+{
+    boot_stages_init(stages, s_stage_fns);
+    sim_reset(stages, BOOT_STAGE_COUNT);
+}
+
+// Simulated costs in ms: panel and LVGL bring-up, the SD mount with its retries, USB host install, UART
+// and reader tasks, PSRAM allocations; 476 ms in all
+static const uint32_t s_app_cost_ms[BOOT_STAGE_COUNT] = {
+    [BOOT_NVS] = 30, [BOOT_I2C] = 15, [BOOT_DISPLAY] = 180, [BOOT_SDCARD] = 120, [BOOT_USB_HOST] = 40,
+    [BOOT_CONTEXTS] = 25, [BOOT_TRANSPORTS] = 35, [BOOT_CHARGING] = 5, [BOOT_SETTINGS] = 20,
+    [BOOT_DETECTION] = 6,
+};
+
+static uint32_t wall_ms(const boot_stage_t *stages, size_t count)
+{
+    int64_t first = INT64_MAX;
+    int64_t last = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (stages[i].start_us > 0) {
+            first = stages[i].start_us < first ? stages[i].start_us : first;
+            last = stages[i].end_us > last ? stages[i].end_us : last;
+        }
+    }
+    return last > first ? (uint32_t)((last - first) / 1000) : 0;
+}
+
+// Longest path of costs through the dependencies: no scheduler finishes sooner
+static uint32_t critical_path_ms(const boot_stage_t *stages, const uint32_t *cost_ms, size_t count)
+{
+    uint32_t finish[BOOT_INIT_MAX_STAGES] = {0};
+    uint32_t longest = 0;
+    for (size_t pass = 0; pass < count; pass++) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t start = 0;
+            for (size_t d = 0; d < count; d++) {
+                if ((stages[i].after & BOOT_STAGE(d)) && finish[d] > start) {
+                    start = finish[d];
+                }
+            }
+            finish[i] = start + cost_ms[i];
+            longest = finish[i] > longest ? finish[i] : longest;
+        }
+    }
+    return longest;
+}
+
+static bool every_run_ordered(size_t count)
+{
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        ok = ok && s_sim[i].runs == 1 && s_sim[i].deps_done;
+    }
+    return ok && s_max_running <= BOOT_INIT_WORKERS + 1;
+}
+
+// ---- functionality ----
+
+static void test_app_table(void)
+{
+    boot_stage_t stages[BOOT_STAGE_COUNT];
+    memset(stages, 0xA5, sizeof(stages));
+    boot_stages_init(stages, s_stage_fns);
+
+    // The table as main.c gets it: its functions in place, every stage named once, no run state left over
+    bool filled = true;
+    for (size_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        filled = filled && stages[i].run == s_stage_fns[i] && stages[i].name && stages[i].name[0] &&
+                 stages[i].state == BOOT_STAGE_WAITING && stages[i].start_us == 0 &&
+                 stages[i].after < BOOT_STAGE(BOOT_STAGE_COUNT) && !(stages[i].after & BOOT_STAGE(i));
+        for (size_t j = 0; j < i; j++) {
+            filled = filled && strcmp(stages[i].name, stages[j].name) != 0;
+        }
+    }
+    CHECK(filled);
+    CHECK(strcmp(stages[BOOT_DISPLAY].name, "display") == 0);
+
+    // What the stage functions rely on: the IO expander behind I2C powers the panel, the SD slot and the
+    // charger; the readers take their trace level from NVS and buffers from the contexts; settings come from
+    // NVS and SD; detection starts once every transport and the SD mount are up
+    static const uint32_t needs[BOOT_STAGE_COUNT] = {
+        [BOOT_DISPLAY] = BOOT_STAGE(BOOT_I2C),
+        [BOOT_SDCARD] = BOOT_STAGE(BOOT_I2C),
+        [BOOT_CHARGING] = BOOT_STAGE(BOOT_I2C),
+        [BOOT_TRANSPORTS] = BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_CONTEXTS),
+        [BOOT_SETTINGS] = BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_SDCARD),
+        [BOOT_DETECTION] = BOOT_STAGE(BOOT_TRANSPORTS) | BOOT_STAGE(BOOT_USB_HOST) | BOOT_STAGE(BOOT_SDCARD),
+    };
+    bool needs_met = true;
+    for (size_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        needs_met = needs_met && (stages[i].after & needs[i]) == needs[i];
+    }
+    CHECK(needs_met);
+
+    sim_reset(stages, BOOT_STAGE_COUNT);
+    sim_costs(s_app_cost_ms, BOOT_STAGE_COUNT);
+
+    CHECK(boot_init_run(stages, BOOT_STAGE_COUNT));
+    CHECK(every_run_ordered(BOOT_STAGE_COUNT));
+    bool all_done = true;
+    bool workers_ok = true;
+    for (size_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        all_done = all_done && stages[i].state == BOOT_STAGE_DONE;
+        workers_ok = workers_ok && stages[i].worker <= BOOT_INIT_WORKERS;
+    }
+    CHECK(all_done && workers_ok);
+
+    // Three workers keep the display, the SD mount and the rest apart: close to the critical path
+    uint32_t critical = critical_path_ms(stages, s_app_cost_ms, BOOT_STAGE_COUNT);
+    uint32_t wall = wall_ms(stages, BOOT_STAGE_COUNT);
+    CHECK(critical == 15 + 180);
+    CHECK(wall + 1 >= critical && wall <= critical + 25 + LATE_MS);
+
+    // Earlier entries win: nvs, i2c and usb_host start together, and the display takes the first free
+    // worker after i2c, ahead of the SD mount
+    CHECK(stages[BOOT_NVS].start_us < stages[BOOT_I2C].end_us &&
+          stages[BOOT_USB_HOST].start_us < stages[BOOT_I2C].end_us);
+    CHECK(stages[BOOT_DISPLAY].start_us < stages[BOOT_SDCARD].start_us);
+}
+
+static void test_shapes(void)
+{
+    boot_stage_t stages[BOOT_INIT_MAX_STAGES];
+
+    // A chain runs one after another, whatever the table order
+    memset(stages, 0, sizeof(stages));
+    static const uint8_t chain[6] = {3, 0, 5, 1, 4, 2};   // chain[k] runs k-th
+    for (size_t k = 1; k < 6; k++) {
+        stages[chain[k]].after = BOOT_STAGE(chain[k - 1]);
+    }
+    sim_reset(stages, 6);
+    static const uint32_t ten[BOOT_INIT_MAX_STAGES] = {10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+                                                       10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10};
+    sim_costs(ten, 6);
+    CHECK(boot_init_run(stages, 6) && every_run_ordered(6));
+    bool in_order = true;
+    for (size_t k = 1; k < 6; k++) {
+        in_order = in_order && stages[chain[k]].start_us >= stages[chain[k - 1]].end_us;
+    }
+    CHECK(in_order && s_max_running == 1);
+
+    // Independent stages: three at a time, on the caller and both helpers
+    memset(stages, 0, sizeof(stages));
+    sim_reset(stages, 12);
+    sim_costs(ten, 12);
+    CHECK(boot_init_run(stages, 12) && every_run_ordered(12));
+    uint32_t wall = wall_ms(stages, 12);
+    CHECK(s_max_running == BOOT_INIT_WORKERS + 1);
+    CHECK(wall + 1 >= 40 && wall <= 40 + LATE_MS);
+    bool used[BOOT_INIT_WORKERS + 1] = {false};
+    for (size_t i = 0; i < 12; i++) {
+        used[stages[i].worker] = true;
+    }
+    bool all_used = true;
+    for (int w = 0; w <= BOOT_INIT_WORKERS; w++) {
+        all_used = all_used && used[w];
+    }
+    CHECK(all_used);
+
+    // A failure skips everything below it, directly or not, and nothing else
+    memset(stages, 0, sizeof(stages));
+    stages[1].after = BOOT_STAGE(0);
+    stages[2].after = BOOT_STAGE(1);                    // under the failure
+    stages[3].after = BOOT_STAGE(2) | BOOT_STAGE(4);    // under it through 2
+    stages[5].after = BOOT_STAGE(0) | BOOT_STAGE(4);    // beside it
+    sim_reset(stages, 6);
+    sim_costs(ten, 6);
+    s_sim[1].fails = true;
+    CHECK(!boot_init_run(stages, 6));
+    CHECK(stages[0].state == BOOT_STAGE_DONE && stages[1].state == BOOT_STAGE_FAILED &&
+          stages[2].state == BOOT_STAGE_SKIPPED && stages[3].state == BOOT_STAGE_SKIPPED &&
+          stages[4].state == BOOT_STAGE_DONE && stages[5].state == BOOT_STAGE_DONE);
+    CHECK(s_sim[1].runs == 1 && s_sim[2].runs == 0 && s_sim[3].runs == 0 && s_sim[5].runs == 1);
+    CHECK(stages[2].start_us == 0 && stages[3].start_us == 0);
+
+    // A cycle is skipped instead of hanging, with what waits on it; the rest runs
+    memset(stages, 0, sizeof(stages));
+    stages[0].after = BOOT_STAGE(1);
+    stages[1].after = BOOT_STAGE(2);
+    stages[2].after = BOOT_STAGE(0);
+    stages[3].after = BOOT_STAGE(1);
+    stages[5].after = BOOT_STAGE(5);                    // itself
+    stages[6].after = BOOT_STAGE(4);
+    sim_reset(stages, 7);
+    sim_costs(ten, 7);
+    CHECK(!boot_init_run(stages, 7));
+    bool cycle_ok = stages[4].state == BOOT_STAGE_DONE && stages[6].state == BOOT_STAGE_DONE;
+    for (size_t i = 0; i < 7; i++) {
+        if (i != 4 && i != 6) {
+            cycle_ok = cycle_ok && stages[i].state == BOOT_STAGE_SKIPPED && s_sim[i].runs == 0;
+        }
+    }
+    CHECK(cycle_ok);
+
+    // Nothing to run; too many stages
+    CHECK(boot_init_run(stages, 0));
+    boot_stage_t many[BOOT_INIT_MAX_STAGES + 1];
+    memset(many, 0, sizeof(many));
+    CHECK(!boot_init_run(many, BOOT_INIT_MAX_STAGES + 1) && many[0].state == BOOT_STAGE_WAITING);
+
+    // A full table of stages that cost nothing
+    memset(stages, 0, sizeof(stages));
+    for (size_t i = 1; i < BOOT_INIT_MAX_STAGES; i++) {
+        stages[i].after = BOOT_STAGE(i / 2);
+    }
+    stages[0].after = 0;
+    sim_reset(stages, BOOT_INIT_MAX_STAGES);
+    static const uint32_t zero[BOOT_INIT_MAX_STAGES] = {0};
+    sim_costs(zero, BOOT_INIT_MAX_STAGES);
+    CHECK(boot_init_run(stages, BOOT_INIT_MAX_STAGES) && every_run_ordered(BOOT_INIT_MAX_STAGES));
+}
+
+// Random graphs: acyclic through a random order, sometimes with a cycle or a failure
+static void test_random(void)
+{
+    bool ok = true;
+    for (int g = 0; g < RANDOM_GRAPHS; g++) {
+        boot_stage_t stages[BOOT_INIT_MAX_STAGES];
+        memset(stages, 0, sizeof(stages));
+        size_t count = rng_range(1, BOOT_INIT_MAX_STAGES);
+        uint8_t order[BOOT_INIT_MAX_STAGES];
+        for (size_t i = 0; i < count; i++) {
+            order[i] = (uint8_t)i;
+        }
+        for (size_t i = count - 1; i > 0; i--) {
+            size_t j = rng_range(0, (uint32_t)i);
+            uint8_t t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        for (size_t k = 1; k < count; k++) {
+            for (int e = rng_range(0, 3); e > 0; e--) {
+                stages[order[k]].after |= BOOT_STAGE(order[rng_range(0, (uint32_t)k - 1)]);
+            }
+        }
+        if (count > 1 && rng() % 8 == 0) {
+            // A back edge closes a cycle through everything between the two
+            size_t from = rng_range(0, (uint32_t)count - 2);
+            size_t to = rng_range((uint32_t)from + 1, (uint32_t)count - 1);
+            stages[order[from]].after |= BOOT_STAGE(order[to]);
+            for (size_t k = from + 1; k <= to; k++) {
+                stages[order[k]].after |= BOOT_STAGE(order[k - 1]);
+            }
+        }
+        sim_reset(stages, count);
+        for (size_t i = 0; i < count; i++) {
+            s_sim[i].cost_us = rng_range(0, 3) * 500;
+            s_sim[i].fails = rng() % 16 == 0;
+        }
+
+        bool all_done = boot_init_run(stages, count);
+
+        // Model: a stage runs once every stage it needs is done; it is done unless it fails. What never
+        // becomes ready is skipped.
+        boot_stage_state_t want[BOOT_INIT_MAX_STAGES];
+        for (size_t i = 0; i < count; i++) {
+            want[i] = BOOT_STAGE_WAITING;
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t i = 0; i < count; i++) {
+                bool ready = want[i] == BOOT_STAGE_WAITING;
+                for (size_t d = 0; d < count && ready; d++) {
+                    ready = !(stages[i].after & BOOT_STAGE(d)) || want[d] == BOOT_STAGE_DONE;
+                }
+                if (ready) {
+                    want[i] = s_sim[i].fails ? BOOT_STAGE_FAILED : BOOT_STAGE_DONE;
+                    changed = true;
+                }
+            }
+        }
+        bool want_all_done = true;
+        for (size_t i = 0; i < count; i++) {
+            if (want[i] == BOOT_STAGE_WAITING) {
+                want[i] = BOOT_STAGE_SKIPPED;
+            }
+            want_all_done = want_all_done && want[i] == BOOT_STAGE_DONE;
+            bool ran = want[i] != BOOT_STAGE_SKIPPED;
+            ok = ok && stages[i].state == want[i] && s_sim[i].runs == (ran ? 1u : 0u) &&
+                 (!ran || (s_sim[i].deps_done && stages[i].end_us >= stages[i].start_us)) &&
+                 stages[i].worker <= BOOT_INIT_WORKERS;
+        }
+        ok = ok && all_done == want_all_done && s_max_running <= BOOT_INIT_WORKERS + 1 && s_running == 0;
+    }
+    CHECK(ok);
+}
+
+// The run's warnings, then boot_init_log(): one line per stage, a bar on the shared axis, failed and
+// skipped stages marked
+static void test_log(void)
+{
+    boot_stage_t stages[5];
+    memset(stages, 0, sizeof(stages));
+    stages[1].after = BOOT_STAGE(0);
+    stages[2].after = BOOT_STAGE(1);
+    stages[4].after = BOOT_STAGE(2);
+    sim_reset(stages, 5);
+    static const uint32_t cost[5] = {20, 20, 20, 40, 20};
+    sim_costs(cost, 5);
+    s_sim[1].fails = true;
+
+    FILE *f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) {
+        return;
+    }
+    fflush(stderr);
+    int saved = dup(2);
+    dup2(fileno(f), 2);
+    esp_log_shim_level = ESP_LOG_INFO;
+    boot_init_run(stages, 5);
+    boot_init_log(stages, 5);
+    esp_log_shim_level = ESP_LOG_NONE;
+    fflush(stderr);
+    dup2(saved, 2);
+    close(saved);
+    rewind(f);
+
+    char line[256];
+    int lines = 0;
+    long long wall = -1;
+    long long busy = -1;
+    char name[16];
+    char bar[64];
+    char bar_s0[64] = "";
+    char bar_s1[64] = "";
+    long long start;
+    long long dur;
+    unsigned worker;
+    bool bars_ok = true;
+    int bars = 0;
+    int skipped = 0;
+    bool failed_ok = false;
+    bool run_log_ok = true;
+    int run_lines = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "I (boot_init)", 13) != 0) {
+            // Failure and skips, named after what caused them
+            run_log_ok = run_log_ok && (strcmp(line, "E (boot_init) Stage s1 failed\n") == 0 ||
+                                        strcmp(line, "W (boot_init) Skipping s2: s1 did not complete\n") == 0 ||
+                                        strcmp(line, "W (boot_init) Skipping s4: s2 did not complete\n") == 0);
+            run_lines++;
+            continue;
+        }
+        lines++;
+        if (sscanf(line, "I (boot_init) Boot stages: %lld ms wall, %lld ms of work", &wall, &busy) == 2) {
+            continue;
+        }
+        if (sscanf(line, "I (boot_init)   %15s %lld +%lld ms  w%u %63s", name, &start, &dur, &worker, bar) == 5) {
+            // The bar covers the stage's share of the time axis
+            long long axis = wall > 0 ? wall : 1;
+            int s = (int)strspn(bar, ".");
+            int e = s + (int)strspn(bar + s, "#");
+            bars_ok = bars_ok && strlen(bar) == 40 && strspn(bar + e, ".") == strlen(bar + e) && e > s &&
+                      abs(s - (int)(start * 40 / axis)) <= 2 && abs(e - s - (int)(dur * 40 / axis)) <= 2;
+            failed_ok = failed_ok || (strcmp(name, "s1") == 0 && strstr(line, " FAILED"));
+            if (strcmp(name, "s0") == 0) {
+                strcpy(bar_s0, bar);
+            } else if (strcmp(name, "s1") == 0) {
+                strcpy(bar_s1, bar);
+            }
+            bars++;
+        } else if (sscanf(line, "I (boot_init)   %15s", name) == 1 && strstr(line, " skipped")) {
+            skipped += strcmp(name, "s2") == 0 || strcmp(name, "s4") == 0;
+        }
+    }
+    fclose(f);
+    CHECK(run_log_ok && run_lines == 3);
+    // s0 and s3 overlap, then s1: 40 ms of wall time, 80 of work
+    CHECK(lines == 6 && bars == 3 && skipped == 2);
+    CHECK(wall >= 39 && wall <= 40 + LATE_MS && busy >= 79 && busy <= 80 + LATE_MS);
+    CHECK(bars_ok && failed_ok);
+    // s1 starts where s0 ends: their bars meet without overlapping
+    bool disjoint = strlen(bar_s0) == 40 && strlen(bar_s1) == 40;
+    for (int c = 0; c < 40 && disjoint; c++) {
+        disjoint = !(bar_s0[c] == '#' && bar_s1[c] == '#');
+    }
+    CHECK(disjoint && strchr(bar_s0, '#') && strchr(bar_s1, '#'));
+}
+
+// Every stage that ran is a perf_trace span
+static void test_perf_trace(void)
+{
+    boot_stage_t stages[5];
+    memset(stages, 0, sizeof(stages));
+    stages[4].after = BOOT_STAGE(3);
+    sim_reset(stages, 5);
+    static const uint32_t zero[5] = {0};
+    sim_costs(zero, 5);
+    s_sim[3].fails = true;
+    uint32_t before = perf_trace_count();
+    boot_init_run(stages, 5);
+    CHECK(perf_trace_count() - before == 4);
+}
+
+static int run_functionality(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;      // failures and cycles are expected here
+    CHECK(perf_trace_init());
+    test_app_table();
+    test_shapes();
+    test_random();
+    test_log();
+    test_perf_trace();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+static int run_benchmark(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    boot_stage_t stages[BOOT_STAGE_COUNT];
+
+    // Before: app_main called the same steps one after another
+    double serial_ms = 0;
+    double staged_ms = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        app_stages(stages);
+        sim_costs(s_app_cost_ms, BOOT_STAGE_COUNT);
+        int64_t start = now_ns();
+        for (size_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+            stages[i].run();
+        }
+        double ms = (double)(now_ns() - start) / 1e6;
+        serial_ms = r == 0 || ms < serial_ms ? ms : serial_ms;
+
+        app_stages(stages);
+        start = now_ns();
+        boot_init_run(stages, BOOT_STAGE_COUNT);
+        ms = (double)(now_ns() - start) / 1e6;
+        staged_ms = r == 0 || ms < staged_ms ? ms : staged_ms;
+    }
+    uint32_t work = 0;
+    for (size_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        work += s_app_cost_ms[i];
+    }
+    printf("app_main stages, %u ms of simulated work, critical path %u ms\n", (unsigned)work,
+           (unsigned)critical_path_ms(stages, s_app_cost_ms, BOOT_STAGE_COUNT));
+    printf("  %-18s %7.1f ms\n", "one after another", serial_ms);
+    printf("  %-18s %7.1f ms\n", "boot_init_run", staged_ms);
+
+    // Scheduler cost: stages that do nothing, in a chain and side by side
+    static const uint32_t zero[BOOT_INIT_MAX_STAGES] = {0};
+    for (int shape = 0; shape < 2; shape++) {
+        boot_stage_t table[BOOT_INIT_MAX_STAGES];
+        int64_t best = 0;
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            int64_t total = 0;
+            int runs = 0;
+            while (total < BENCH_MIN_NS) {
+                memset(table, 0, sizeof(table));
+                for (size_t i = 1; shape == 0 && i < BOOT_INIT_MAX_STAGES; i++) {
+                    table[i].after = BOOT_STAGE(i - 1);
+                }
+                sim_reset(table, BOOT_INIT_MAX_STAGES);
+                sim_costs(zero, BOOT_INIT_MAX_STAGES);
+                int64_t start = now_ns();
+                boot_init_run(table, BOOT_INIT_MAX_STAGES);
+                total += now_ns() - start;
+                runs++;
+            }
+            int64_t per_stage = total / runs / BOOT_INIT_MAX_STAGES;
+            best = r == 0 || per_stage < best ? per_stage : best;
+        }
+        printf("  %-18s %7.1f us per stage, helper tasks included\n",
+               shape == 0 ? "empty chain" : "empty, independent", (double)best / 1000);
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
@@ -0,0 +1,935 @@
+/*
+ * Host test and benchmark of the command/response sessions (cmd_session.c) on the pthread FreeRTOS
+ * shim, against a simulated JanOS board behind an rx_demux.
+ *
+ * The board reads commands from what the session writes, answers them strictly in order after a think
+ * time, line by line, and may echo each command first as the console does. Test commands describe their
+ * own response: "t <id> <think ms> <lines> <gap ms> <end>", where end is a marker line, a fail line, a
+ * number, nothing (the response ends by going quiet) or silence (no response at all).
+ *
+ *   test_cmd_session          functionality test: each way a response can end; echoes skipped; at most
+ *                             two commands on the wire and none behind a quiet-terminated one; 400
+ *                             random requests pipelined from a window of six; trailing output, release
+ *                             while pending, a full session, a failing write; fan-out order and timing
+ *   test_cmd_session bench    the five converted call sites: the fixed sleeps and read timeouts they
+ *                             used before against their session requests, on the same board
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmd_session.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "rx_demux.h"
+#include "test_common.h"
+
+#define RING_SIZE           4096
+#define BOARD_OUT_SIZE      (64 * 1024)
+#define BOARD_LINE_MAX      128
+#define RANDOM_REQUESTS     400
+#define RANDOM_WINDOW       6
+#define LATE_MS             40      // slack for a loaded host
+
+// ---- simulated board ----
+
+typedef struct {
+    const char *name;
+    rx_demux_t demux;
+    uint8_t ring[RING_SIZE + 1];
+    char scratch[RING_SIZE + 1];
+
+    // Tab5 -> board
+    char in_line[BOARD_LINE_MAX];
+    size_t in_len;
+    QueueHandle_t commands;
+    volatile bool write_fails;
+    bool echo;
+
+    // board -> Tab5
+    SemaphoreHandle_t out_lock;
+    SemaphoreHandle_t out_ready;
+    uint8_t out[BOARD_OUT_SIZE];
+    size_t out_head;
+    size_t out_len;
+
+    // Commands received but not answered in full, at most seen, and at the arrival of each test id
+    volatile int in_flight;
+    int max_in_flight;
+    int in_flight_at[RANDOM_REQUESTS + 64];
+    uint32_t commands_seen;
+} board_t;
+
+typedef struct {
+    char text[BOARD_LINE_MAX];
+} board_command_t;
+
+static void board_emit(board_t *b, const char *line)
+{
+    xSemaphoreTake(b->out_lock, portMAX_DELAY);
+    size_t len = strlen(line);
+    for (size_t i = 0; i < len + 2 && b->out_len < BOARD_OUT_SIZE; i++) {
+        b->out[(b->out_head + b->out_len++) % BOARD_OUT_SIZE] = i < len ? (uint8_t)line[i] : i == len ? '\r' : '\n';
+    }
+    xSemaphoreGive(b->out_lock);
+    xSemaphoreGive(b->out_ready);
+}
+
+// The rx_demux read callback: whatever the board has printed, or wait for it
+static int board_read(void *user_data, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    board_t *b = user_data;
+    for (int pass = 0; pass < 2; pass++) {
+        xSemaphoreTake(b->out_lock, portMAX_DELAY);
+        size_t n = len < b->out_len ? len : b->out_len;
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = b->out[(b->out_head + i) % BOARD_OUT_SIZE];
+        }
+        b->out_head = (b->out_head + n) % BOARD_OUT_SIZE;
+        b->out_len -= n;
+        xSemaphoreGive(b->out_lock);
+        if (n > 0 || pass > 0) {
+            return (int)n;
+        }
+        xSemaphoreTake(b->out_ready, timeout);
+    }
+    return 0;
+}
+
+// The session's write: split into command lines for the board task
+static int board_write(void *ctx, const char *data, size_t len)
+{
+    board_t *b = ctx;
+    if (b->write_fails) {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\n' || data[i] == '\r') {
+            if (b->in_len > 0) {
+                board_command_t cmd;
+                memcpy(cmd.text, b->in_line, b->in_len);
+                cmd.text[b->in_len] = '\0';
+                b->in_len = 0;
+                int in_flight = __atomic_add_fetch(&b->in_flight, 1, __ATOMIC_SEQ_CST);
+                b->max_in_flight = in_flight > b->max_in_flight ? in_flight : b->max_in_flight;
+                unsigned id;
+                if (sscanf(cmd.text, "t %u", &id) == 1 && id < sizeof(b->in_flight_at) / sizeof(b->in_flight_at[0])) {
+                    b->in_flight_at[id] = in_flight;
+                }
+                xQueueSend(b->commands, &cmd, portMAX_DELAY);
+            }
+        } else if (b->in_len < BOARD_LINE_MAX - 1) {
+            b->in_line[b->in_len++] = data[i];
+        }
+    }
+    return (int)len;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    if (ms > 0) {
+        vTaskDelay(pdMS_TO_TICKS(ms));
+    }
+}
+
+// A JanOS command with a fixed response, for the converted call sites
+typedef struct {
+    const char *command;
+    uint32_t think_ms;
+    uint32_t gap_ms;
+    const char *const *lines;
+} board_script_t;
+
+static const char *const s_list_sd_lines[] = {
+    "HTML files found on SD card:", "1 portal_google.html", "2 portal_facebook.html", "3 portal_hotel.html",
+    "4 portal_airport.html", "5 portal_cafe.html", NULL,
+};
+static const char *const s_list_dir_lines[] = {
+    "Files in /sdcard/lab/handshakes:", "1 HOME_1A2B3C.pcap", "2 HOME_1A2B3C.hccapx", "3 CAFE_4D5E6F.pcap",
+    "4 CAFE_4D5E6F.hccapx", "5 OFFICE_778899.pcap", "6 OFFICE_778899.hccapx", NULL,
+};
+static const char *const s_probe_lines[] = {
+    "Probe requests:", "1 HomeNet (3)", "2 eduroam (5)", "3 Starbucks WiFi (1)", "4 AndroidAP (2)",
+    "5 iPhone (4)", "6 Airport_Free (1)", "7 HotelGuest (2)", NULL,
+};
+static const char *const s_channel_time_lines[] = {"120", NULL};
+
+static const board_script_t s_scripts[] = {
+    {"list_sd", 25, 2, s_list_sd_lines},
+    {"list_dir /sdcard/lab/handshakes", 15, 2, s_list_dir_lines},
+    {"list_probes", 40, 3, s_probe_lines},
+    {"channel_time read min", 5, 0, s_channel_time_lines},
+};
+
+// The response is complete once its last line is out; count it before that line so the next
+// command, sent the moment the session sees it, never finds it still in flight
+static void board_done(board_t *b)
+{
+    __atomic_sub_fetch(&b->in_flight, 1, __ATOMIC_SEQ_CST);
+}
+
+static void board_answer(board_t *b, const char *command)
+{
+    char line[BOARD_LINE_MAX];
+    unsigned id, think, lines, gap;
+    char end[16];
+    if (sscanf(command, "t %u %u %u %u %15s", &id, &think, &lines, &gap, end) == 5) {
+        bool quiet = strcmp(end, "quiet") == 0;
+        if (strcmp(end, "silent") == 0) {
+            board_done(b);
+            return;
+        }
+        sleep_ms(think);
+        for (unsigned i = 0; i < lines; i++) {
+            if (i > 0) {
+                sleep_ms(gap);
+            }
+            if (quiet && i == lines - 1) {
+                board_done(b);
+            }
+            snprintf(line, sizeof(line), "r%u line %u", id, i);
+            board_emit(b, line);
+        }
+        if (quiet) {
+            return;
+        }
+        if (lines > 0) {
+            sleep_ms(gap);
+        }
+        if (strcmp(end, "fail") == 0) {
+            snprintf(line, sizeof(line), "ERROR r%u", id);
+        } else if (strcmp(end, "number") == 0) {
+            snprintf(line, sizeof(line), "%u", id);
+        } else {
+            snprintf(line, sizeof(line), "DONE r%u", id);
+        }
+        board_done(b);
+        board_emit(b, line);
+        if (strcmp(end, "trail") == 0) {
+            // Output the request does not wait for, e.g. a status line printed afterwards
+            sleep_ms(5);
+            snprintf(line, sizeof(line), "r%u trailing", id);
+            board_emit(b, line);
+            board_emit(b, line);
+        }
+        return;
+    }
+
+    for (size_t s = 0; s < sizeof(s_scripts) / sizeof(s_scripts[0]); s++) {
+        if (strcmp(command, s_scripts[s].command) == 0) {
+            sleep_ms(s_scripts[s].think_ms);
+            for (const char *const *l = s_scripts[s].lines; *l; l++) {
+                if (l != s_scripts[s].lines) {
+                    sleep_ms(s_scripts[s].gap_ms);
+                }
+                if (!l[1]) {
+                    board_done(b);
+                }
+                board_emit(b, *l);
+            }
+            return;
+        }
+    }
+    board_done(b);
+}
+
+static void board_task(void *arg)
+{
+    board_t *b = arg;
+    board_command_t cmd;
+    for (;;) {
+        if (!xQueueReceive(b->commands, &cmd, portMAX_DELAY)) {
+            continue;
+        }
+        b->commands_seen++;
+        if (b->echo) {
+            char line[BOARD_LINE_MAX + 2];
+            snprintf(line, sizeof(line), "> %s", cmd.text);
+            board_emit(b, line);
+        }
+        board_answer(b, cmd.text);
+    }
+}
+
+static bool board_start(board_t *b, const char *name, bool echo)
+{
+    memset(b, 0, sizeof(*b));
+    b->name = name;
+    b->echo = echo;
+    b->commands = xQueueCreate(32, sizeof(board_command_t));
+    b->out_lock = xSemaphoreCreateMutex();
+    b->out_ready = xSemaphoreCreateBinary();
+    return b->commands && b->out_lock && b->out_ready &&
+           rx_demux_start(&b->demux, name, b->ring, b->scratch, RING_SIZE, board_read, b, 6) &&
+           xTaskCreate(board_task, name, 4096, b, 5, NULL) == pdPASS;
+}
+
+static bool session_start(cmd_session_t *s, board_t *b)
+{
+    return cmd_session_start(s, b->name, &b->demux, board_write, b, 5);
+}
+
+static int slots_in_use(const cmd_session_t *s)
+{
+    int n = 0;
+    for (int i = 0; i < CMD_SESSION_SLOTS; i++) {
+        n += s->slots[i].in_use;
+    }
+    return n;
+}
+
+// ---- functionality ----
+
+static const char *const s_end_markers[] = {"DONE", NULL};
+static const char *const s_fail_markers[] = {"ERROR", NULL};
+
+static bool starts_with_digit(const char *line, void *user)
+{
+    (void)user;
+    return line[0] >= '0' && line[0] <= '9';
+}
+
+typedef enum {
+    END_MARKER,
+    END_FAIL,
+    END_NUMBER,
+    END_QUIET,
+    END_SILENT,
+    END_TRAIL,
+    END_KINDS,
+} end_kind_t;
+
+static const char *const s_end_names[] = {"end", "fail", "number", "quiet", "silent", "trail"};
+
+typedef struct {
+    unsigned id;
+    unsigned think;
+    unsigned lines;
+    unsigned gap;
+    end_kind_t end;
+    char command[64];
+    char out[1024];
+    char expect[1024];
+    uint32_t on_line_calls;
+    cmd_request_t req;
+    cmd_future_t *future;
+} test_req_t;
+
+#define QUIET_MS    30
+#define TIMEOUT_MS  400
+
+static void count_line(const char *line, size_t len, void *user)
+{
+    (void)line;
+    (void)len;
+    ((test_req_t *)user)->on_line_calls++;
+}
+
+// Fill in the command, the request and the response the session should collect
+static void test_req_init(test_req_t *t, unsigned id, unsigned think, unsigned lines, unsigned gap, end_kind_t end)
+{
+    memset(t, 0, sizeof(*t));
+    t->id = id;
+    t->think = think;
+    t->lines = lines;
+    t->gap = gap;
+    t->end = end;
+    snprintf(t->command, sizeof(t->command), "t %u %u %u %u %s", id, think, lines, gap, s_end_names[end]);
+    size_t n = 0;
+    if (end != END_SILENT) {
+        for (unsigned i = 0; i < lines; i++) {
+            n += (size_t)snprintf(t->expect + n, sizeof(t->expect) - n, "r%u line %u\n", id, i);
+        }
+    }
+    if (end == END_MARKER || end == END_TRAIL) {
+        snprintf(t->expect + n, sizeof(t->expect) - n, "DONE r%u\n", id);
+    } else if (end == END_FAIL) {
+        snprintf(t->expect + n, sizeof(t->expect) - n, "ERROR r%u\n", id);
+    } else if (end == END_NUMBER) {
+        snprintf(t->expect + n, sizeof(t->expect) - n, "%u\n", id);
+    }
+
+    t->req = (cmd_request_t){
+        .command = t->command,
+        .end_markers = s_end_markers,
+        .fail_markers = s_fail_markers,
+        .timeout_ms = end == END_SILENT ? 60 : TIMEOUT_MS,
+        .out = t->out,
+        .out_cap = sizeof(t->out),
+        .on_line = count_line,
+        .user = t,
+    };
+    if (end == END_NUMBER) {
+        t->req.is_last_line = starts_with_digit;
+    } else if (end == END_QUIET) {
+        t->req.quiet_ms = QUIET_MS;
+    }
+}
+
+static cmd_status_t expected_status(const test_req_t *t)
+{
+    return t->end == END_FAIL ? CMD_FAILED : t->end == END_SILENT ? CMD_TIMEOUT : CMD_DONE;
+}
+
+static bool test_req_ok(const test_req_t *t, cmd_status_t status)
+{
+    size_t lines = 0;
+    for (const char *p = t->expect; *p; p++) {
+        lines += *p == '\n';
+    }
+    return status == expected_status(t) && strcmp(t->out, t->expect) == 0 && t->on_line_calls == lines;
+}
+
+static board_t s_board;
+static board_t s_board2;
+static board_t s_board3;
+static cmd_session_t s_session;
+static cmd_session_t s_session2;
+static cmd_session_t s_session3;
+
+// One request of each kind on its own, with its time from due to end
+static void test_single(void)
+{
+    static const struct {
+        end_kind_t end;
+        unsigned think, lines, gap;
+        uint32_t min_ms, max_ms;
+    } cases[] = {
+        {END_MARKER, 10, 5, 2, 20, 20 + LATE_MS},
+        {END_FAIL, 5, 2, 1, 7, 7 + LATE_MS},
+        {END_NUMBER, 3, 0, 0, 3, 3 + LATE_MS},
+        {END_NUMBER, 3, 3, 1, 6, 6 + LATE_MS},
+        {END_QUIET, 5, 4, 2, 11 + QUIET_MS, 11 + QUIET_MS + LATE_MS},
+        {END_SILENT, 0, 0, 0, 60, 60 + LATE_MS},
+        {END_MARKER, 0, 0, 0, 0, LATE_MS},
+    };
+    static test_req_t t;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        test_req_init(&t, 900 + (unsigned)c, cases[c].think, cases[c].lines, cases[c].gap, cases[c].end);
+        cmd_future_t *f = cmd_session_submit(&s_session, &t.req);
+        CHECK(f != NULL);
+        cmd_status_t status = cmd_future_wait(f, pdMS_TO_TICKS(5000));
+        uint32_t ms = cmd_future_elapsed_ms(f);
+        CHECK(test_req_ok(&t, status));
+        CHECK(ms + 1 >= cases[c].min_ms && ms <= cases[c].max_ms);
+        cmd_future_release(f);
+        CHECK(cmd_future_elapsed_ms(NULL) == 0 && cmd_future_wait(NULL, 0) == CMD_ERROR);
+    }
+    // The echo of every command was skipped, and nothing is left subscribed
+    sleep_ms(5);
+    CHECK(slots_in_use(&s_session) == 0 && s_session.sub == NULL);
+
+    // quiet_after: only a line containing it arms the quiet period, the longer gaps before it don't end the response
+    test_req_init(&t, 950, 2, 4, QUIET_MS + 10, END_QUIET);
+    t.req.quiet_after = "line 3";
+    cmd_future_t *f = cmd_session_submit(&s_session, &t.req);
+    CHECK(cmd_future_wait(f, pdMS_TO_TICKS(5000)) == CMD_DONE);
+    CHECK(strcmp(t.out, t.expect) == 0);
+    uint32_t ms = cmd_future_elapsed_ms(f);
+    CHECK(ms + 1 >= 2 + 3 * (QUIET_MS + 10) + QUIET_MS && ms <= 2 + 3 * (QUIET_MS + 10) + QUIET_MS + LATE_MS);
+    cmd_future_release(f);
+
+    // cmd_session_run() and the completed semaphore
+    test_req_init(&t, 951, 1, 2, 1, END_MARKER);
+    t.req.completed = xSemaphoreCreateBinary();
+    CHECK(cmd_session_run(&s_session, &t.req) == CMD_DONE && strcmp(t.out, t.expect) == 0);
+    CHECK(xSemaphoreTake(t.req.completed, 0) == pdTRUE);
+    vSemaphoreDelete(t.req.completed);
+}
+
+// Three requests submitted at once: two go on the wire, the third when the first ends
+static void test_pipeline(void)
+{
+    static test_req_t t[4];
+    s_board.max_in_flight = 0;
+    test_req_init(&t[0], 1, 20, 3, 2, END_MARKER);
+    test_req_init(&t[1], 2, 5, 2, 1, END_NUMBER);
+    test_req_init(&t[2], 3, 5, 2, 1, END_FAIL);
+    cmd_future_t *f[3];
+    for (int i = 0; i < 3; i++) {
+        f[i] = cmd_session_submit(&s_session, &t[i].req);
+        CHECK(f[i] != NULL);
+    }
+    for (int i = 0; i < 3; i++) {
+        CHECK(test_req_ok(&t[i], cmd_future_wait(f[i], pdMS_TO_TICKS(5000))));
+        cmd_future_release(f[i]);
+    }
+    CHECK(s_board.in_flight_at[1] == 1 && s_board.in_flight_at[2] == 2 && s_board.in_flight_at[3] <= 2);
+    CHECK(s_board.max_in_flight == 2);
+
+    // Nothing goes out behind a response that ends by going quiet
+    test_req_init(&t[0], 4, 5, 3, 2, END_MARKER);
+    test_req_init(&t[1], 5, 5, 3, 2, END_QUIET);
+    test_req_init(&t[2], 6, 5, 1, 1, END_MARKER);
+    test_req_init(&t[3], 7, 5, 1, 1, END_MARKER);
+    cmd_future_t *g[4];
+    for (int i = 0; i < 4; i++) {
+        g[i] = cmd_session_submit(&s_session, &t[i].req);
+    }
+    for (int i = 0; i < 4; i++) {
+        CHECK(test_req_ok(&t[i], cmd_future_wait(g[i], pdMS_TO_TICKS(5000))));
+        cmd_future_release(g[i]);
+    }
+    CHECK(s_board.in_flight_at[5] == 2 && s_board.in_flight_at[6] == 1);
+}
+
+// Requests of every kind from a window of six outstanding, checked as they complete
+static void test_random(void)
+{
+    static test_req_t reqs[RANDOM_REQUESTS];
+    int submitted = 0;
+    int completed = 0;
+    bool ok = true;
+    s_board.max_in_flight = 0;
+    while (completed < RANDOM_REQUESTS) {
+        while (submitted < RANDOM_REQUESTS && submitted - completed < RANDOM_WINDOW) {
+            test_req_t *t = &reqs[submitted];
+            uint32_t r = rng() % 100;
+            // No silent requests: the response behind one would be taken for its own
+            end_kind_t end = r < 50 ? END_MARKER : r < 65 ? END_NUMBER : r < 80 ? END_FAIL : END_QUIET;
+            unsigned lines = rng_range(end == END_QUIET ? 1 : 0, 6);
+            test_req_init(t, (unsigned)submitted + 10, rng_range(0, 4), lines, rng_range(0, 2), end);
+            t->future = cmd_session_submit(&s_session, &t->req);
+            ok = ok && t->future != NULL;
+            submitted++;
+        }
+        test_req_t *t = &reqs[completed];
+        cmd_status_t status = cmd_future_wait(t->future, pdMS_TO_TICKS(5000));
+        if (!test_req_ok(t, status)) {
+            printf("request %u \"%s\": status %d, got \"%s\"\n", t->id, t->command, status, t->out);
+            ok = false;
+        }
+        cmd_future_release(t->future);
+        completed++;
+    }
+    CHECK(ok);
+    CHECK(s_board.max_in_flight <= CMD_SESSION_PIPELINE);
+    sleep_ms(5);
+    CHECK(slots_in_use(&s_session) == 0 && s_session.sub == NULL && s_session.queue_len == 0);
+}
+
+static void test_edges(void)
+{
+    static test_req_t t[CMD_SESSION_SLOTS + 1];
+
+    // Output after a response ended goes nowhere once nothing is pending; the next request sees only its own
+    test_req_init(&t[0], 960, 2, 1, 1, END_TRAIL);
+    CHECK(cmd_session_run(&s_session, &t[0].req) == CMD_DONE && strcmp(t[0].out, t[0].expect) == 0);
+    sleep_ms(20);
+    test_req_init(&t[1], 961, 2, 2, 1, END_MARKER);
+    CHECK(cmd_session_run(&s_session, &t[1].req) == CMD_DONE && strcmp(t[1].out, t[1].expect) == 0);
+
+    // A released request keeps its place in the FIFO but writes nowhere
+    test_req_init(&t[0], 962, 10, 3, 2, END_MARKER);
+    test_req_init(&t[1], 963, 2, 2, 1, END_MARKER);
+    cmd_future_t *f0 = cmd_session_submit(&s_session, &t[0].req);
+    cmd_future_t *f1 = cmd_session_submit(&s_session, &t[1].req);
+    cmd_future_release(f0);
+    CHECK(test_req_ok(&t[1], cmd_future_wait(f1, pdMS_TO_TICKS(5000))));
+    CHECK(t[0].out[0] == '\0' && t[0].on_line_calls == 0);
+    CHECK(f0->in_use == false);
+    cmd_future_release(f1);
+
+    // A full session turns the next request away; released requests free their slots as they time out
+    cmd_future_t *f[CMD_SESSION_SLOTS];
+    for (int i = 0; i < CMD_SESSION_SLOTS; i++) {
+        test_req_init(&t[i], 970 + (unsigned)i, 0, 0, 0, END_SILENT);
+        f[i] = cmd_session_submit(&s_session, &t[i].req);
+        CHECK(f[i] != NULL);
+    }
+    test_req_init(&t[CMD_SESSION_SLOTS], 980, 0, 0, 0, END_MARKER);
+    CHECK(cmd_session_submit(&s_session, &t[CMD_SESSION_SLOTS].req) == NULL);
+    CHECK(cmd_session_run(&s_session, &t[CMD_SESSION_SLOTS].req) == CMD_ERROR);
+    for (int i = 0; i < CMD_SESSION_SLOTS; i++) {
+        cmd_future_release(f[i]);
+    }
+    int64_t start = now_ns();
+    while (slots_in_use(&s_session) > 0 && now_ns() - start < 5000000000LL) {
+        sleep_ms(5);
+    }
+    CHECK(slots_in_use(&s_session) == 0);
+    CHECK(cmd_session_run(&s_session, &t[CMD_SESSION_SLOTS].req) == CMD_DONE);
+
+    // A write that fails completes the request with CMD_ERROR, and the session goes on
+    s_board.write_fails = true;
+    test_req_init(&t[0], 981, 0, 1, 0, END_MARKER);
+    CHECK(cmd_session_run(&s_session, &t[0].req) == CMD_ERROR);
+    s_board.write_fails = false;
+    test_req_init(&t[0], 982, 0, 1, 0, END_MARKER);
+    CHECK(cmd_session_run(&s_session, &t[0].req) == CMD_DONE && strcmp(t[0].out, t[0].expect) == 0);
+
+    // Responses longer than out are cut at a line boundary, still NUL terminated
+    char small[20];
+    test_req_init(&t[0], 983, 0, 4, 0, END_MARKER);
+    t[0].req.out = small;
+    t[0].req.out_cap = sizeof(small);
+    CHECK(cmd_session_run(&s_session, &t[0].req) == CMD_DONE);
+    CHECK(strcmp(small, "r983 line 0\n") == 0);
+
+    CHECK(cmd_session_submit(NULL, &t[0].req) == NULL);
+}
+
+// Fan-out: results come back fastest first, behind the targets that could not be sent
+typedef struct {
+    const char *order[CMD_FANOUT_MAX];
+    int n;
+} fanout_log_t;
+
+static void fanout_cb(cmd_fanout_target_t *target, void *user)
+{
+    fanout_log_t *log = user;
+    log->order[log->n++] = target->name;
+}
+
+static void test_fanout(void)
+{
+    static char out[3][256];
+    static const char *const pong[] = {"pong", NULL};
+    cmd_fanout_target_t targets[] = {
+        {.session = &s_session, .name = "slow", .out = out[0], .out_cap = sizeof(out[0])},
+        {.session = NULL, .name = "absent"},
+        {.session = &s_session2, .name = "fast", .out = out[1], .out_cap = sizeof(out[1])},
+        {.session = &s_session3, .name = "mid", .out = out[2], .out_cap = sizeof(out[2])},
+    };
+    // Every board answers "list_probes" in 40 + 7 * 3 ms; two of them have a request ahead of it
+    static test_req_t ahead;
+    test_req_init(&ahead, 990, 60, 1, 0, END_MARKER);
+    cmd_future_t *f = cmd_session_submit(&s_session, &ahead.req);
+    static test_req_t mid_ahead;
+    test_req_init(&mid_ahead, 991, 20, 1, 0, END_MARKER);
+    cmd_future_t *g = cmd_session_submit(&s_session3, &mid_ahead.req);
+
+    cmd_request_t req = {
+        .command = "list_probes",
+        .quiet_after = "Probe requests",
+        .quiet_ms = QUIET_MS,
+        .timeout_ms = 2000,
+    };
+    fanout_log_t log = {0};
+    int64_t start = now_ns();
+    CHECK(cmd_fanout_run(&req, targets, 4, fanout_cb, &log) == 3);
+    int64_t ms = (now_ns() - start) / 1000000;
+    CHECK(log.n == 4 && strcmp(log.order[0], "absent") == 0 && strcmp(log.order[1], "fast") == 0 &&
+          strcmp(log.order[2], "mid") == 0 && strcmp(log.order[3], "slow") == 0);
+    CHECK(targets[1].status == CMD_ERROR && targets[0].status == CMD_DONE && targets[2].status == CMD_DONE &&
+          targets[3].status == CMD_DONE);
+    for (int i = 0; i < 3; i++) {
+        CHECK(strstr(out[i], "Probe requests:\n1 HomeNet (3)\n") == out[i] && strstr(out[i], "7 HotelGuest (2)\n"));
+    }
+    // The slowest board sets the time: its earlier request, then the probes
+    CHECK(ms + 1 >= 60 + 40 + 21 + QUIET_MS && ms < 60 + 40 + 21 + QUIET_MS + 2 * LATE_MS);
+    CHECK(cmd_future_wait(f, 0) == CMD_DONE && cmd_future_wait(g, 0) == CMD_DONE);
+    cmd_future_release(f);
+    cmd_future_release(g);
+
+    // More targets than a fan-out takes are left alone
+    cmd_fanout_target_t many[CMD_FANOUT_MAX + 1];
+    memset(many, 0, sizeof(many));
+    for (int i = 0; i < CMD_FANOUT_MAX + 1; i++) {
+        many[i].name = "none";
+    }
+    many[CMD_FANOUT_MAX].status = CMD_TIMEOUT;
+    cmd_request_t ping = {.command = "ping", .end_markers = pong, .timeout_ms = 50};
+    log.n = 0;
+    CHECK(cmd_fanout_run(&ping, many, CMD_FANOUT_MAX + 1, fanout_cb, &log) == 0);
+    CHECK(log.n == CMD_FANOUT_MAX && many[0].status == CMD_ERROR && many[CMD_FANOUT_MAX].status == CMD_TIMEOUT);
+}
+
+static int run_functionality(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;      // timeouts and refusals are expected here
+    bool ok = board_start(&s_board, "board", true) && board_start(&s_board2, "board2", false) &&
+              board_start(&s_board3, "board3", true) && session_start(&s_session, &s_board) &&
+              session_start(&s_session2, &s_board2) && session_start(&s_session3, &s_board3);
+    CHECK(ok);
+    if (!ok) {
+        return test_result();
+    }
+    test_single();
+    test_pipeline();
+    test_random();
+    test_edges();
+    test_fanout();
+    return test_result();
+}
+
+// ---- benchmark: the converted call sites, before and after ----
+
+static const char *const s_found_markers[] = {"HTML files found on SD card", NULL};
+static const char *const s_sd_fail_markers[] = {"Failed to initialize SD card", NULL};
+
+#define TRANSPORT_SESSION_QUIET_MS  250
+
+static void send_command(board_t *b, const char *cmd)
+{
+    board_write(b, cmd, strlen(cmd));
+    board_write(b, "\r\n", 2);
+}
+
+// karma_fetch_html_files(): lines for 3 s or until 20 files
+static int old_list_sd(board_t *b)
+{
+    rx_demux_sub_t *sub = rx_demux_subscribe(&b->demux, NULL);
+    send_command(b, "list_sd");
+    TickType_t start = xTaskGetTickCount();
+    int files = 0;
+    while ((xTaskGetTickCount() - start) < pdMS_TO_TICKS(3000) && files < 20) {
+        line_view_t line;
+        if (!rx_demux_next_line(sub, &line, pdMS_TO_TICKS(100))) {
+            continue;
+        }
+        files += line.text[0] >= '1' && line.text[0] <= '9';
+    }
+    rx_demux_unsubscribe(sub);
+    return files;
+}
+
+static int new_list_sd(board_t *b, cmd_session_t *s)
+{
+    static char rx_buffer[2048];
+    cmd_request_t req = {
+        .command = "list_sd",
+        .fail_markers = s_sd_fail_markers,
+        .quiet_after = "HTML files found",
+        .quiet_ms = TRANSPORT_SESSION_QUIET_MS,
+        .timeout_ms = 3000,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    (void)b;
+    cmd_session_run(s, &req);
+    int files = 0;
+    for (const char *p = rx_buffer; *p; p = strchr(p, '\n') + 1) {
+        files += *p >= '1' && *p <= '9';
+    }
+    return files;
+}
+
+// check_sd_card_for_tab(): 1 s sleep, then reads until the marker
+static int old_check_sd(board_t *b)
+{
+    rx_demux_sub_t *sub = rx_demux_subscribe(&b->demux, NULL);
+    send_command(b, "list_sd");
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    static char rx_buffer[512];
+    int total_len = 0;
+    TickType_t start = xTaskGetTickCount();
+    int found = 0;
+    while ((xTaskGetTickCount() - start) < pdMS_TO_TICKS(4000) && total_len < (int)sizeof(rx_buffer) - 1) {
+        int len = rx_demux_read(sub, rx_buffer + total_len, sizeof(rx_buffer) - 1 - total_len, pdMS_TO_TICKS(100));
+        if (len > 0) {
+            total_len += len;
+            rx_buffer[total_len] = '\0';
+            if (strstr(rx_buffer, "HTML files found on SD card")) {
+                found = 1;
+                break;
+            }
+        }
+    }
+    rx_demux_unsubscribe(sub);
+    return found;
+}
+
+static int new_check_sd(board_t *b, cmd_session_t *s)
+{
+    static char rx_buffer[512];
+    cmd_request_t req = {
+        .command = "list_sd",
+        .end_markers = s_found_markers,
+        .fail_markers = s_sd_fail_markers,
+        .timeout_ms = 5000,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    (void)b;
+    return cmd_session_run(s, &req) == CMD_DONE;
+}
+
+// count_remote_handshake_files_for_tab(): 120 ms reads until three come back empty
+static int old_list_dir(board_t *b)
+{
+    rx_demux_sub_t *sub = rx_demux_subscribe(&b->demux, NULL);
+    send_command(b, "list_dir /sdcard/lab/handshakes");
+    static char rx_buffer[2048];
+    int total_len = 0;
+    int retries = 8;
+    int empty_reads = 0;
+    while (retries-- > 0 && total_len < (int)sizeof(rx_buffer) - 1 && empty_reads < 3) {
+        int len = rx_demux_read(sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(120));
+        if (len > 0) {
+            total_len += len;
+            empty_reads = 0;
+        } else {
+            empty_reads++;
+        }
+    }
+    rx_demux_unsubscribe(sub);
+    rx_buffer[total_len] = '\0';
+    return (int)(strstr(rx_buffer, ".pcap") != NULL);
+}
+
+static int new_list_dir(board_t *b, cmd_session_t *s)
+{
+    static char rx_buffer[2048];
+    cmd_request_t req = {
+        .command = "list_dir /sdcard/lab/handshakes",
+        .quiet_ms = 150,
+        .timeout_ms = 1000,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    (void)b;
+    cmd_session_run(s, &req);
+    return (int)(strstr(rx_buffer, ".pcap") != NULL);
+}
+
+// read_channel_time_from_uart(): 100 ms reads until one comes back empty after data
+static int old_channel_time(board_t *b)
+{
+    rx_demux_sub_t *sub = rx_demux_subscribe(&b->demux, NULL);
+    send_command(b, "channel_time read min");
+    static char rx_buffer[128];
+    int total_len = 0;
+    int retries = 5;
+    while (retries-- > 0 && total_len < (int)sizeof(rx_buffer) - 1) {
+        int len = rx_demux_read(sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(100));
+        if (len > 0) {
+            total_len += len;
+        }
+        if (len <= 0 && total_len > 0) {
+            break;
+        }
+    }
+    rx_demux_unsubscribe(sub);
+    rx_buffer[total_len] = '\0';
+    return atoi(strstr(rx_buffer, "120") ? "120" : "0");
+}
+
+static int new_channel_time(board_t *b, cmd_session_t *s)
+{
+    static char rx_buffer[128];
+    cmd_request_t req = {
+        .command = "channel_time read min",
+        .is_last_line = starts_with_digit,
+        .timeout_ms = 500,
+        .out = rx_buffer,
+        .out_cap = sizeof(rx_buffer),
+    };
+    (void)b;
+    return cmd_session_run(s, &req) == CMD_DONE ? atoi(strstr(rx_buffer, "120") ? "120" : "0") : 0;
+}
+
+// adhoc_fetch_probes_from_all_uarts(): each board in turn, 500 ms sleep, then 200 ms reads until one is empty
+static int old_probes_one(board_t *b)
+{
+    rx_demux_sub_t *sub = rx_demux_subscribe(&b->demux, NULL);
+    send_command(b, "list_probes");
+    vTaskDelay(pdMS_TO_TICKS(500));
+    static char rx_buffer[2048];
+    int total_len = 0;
+    int retries = 10;
+    while (retries-- > 0) {
+        int len = rx_demux_read(sub, rx_buffer + total_len, sizeof(rx_buffer) - total_len - 1, pdMS_TO_TICKS(200));
+        if (len > 0) {
+            total_len += len;
+        }
+        if (len <= 0) {
+            break;
+        }
+    }
+    rx_demux_unsubscribe(sub);
+    rx_buffer[total_len] = '\0';
+    return (int)(strstr(rx_buffer, "HotelGuest") != NULL);
+}
+
+static int old_probes(board_t *b)
+{
+    (void)b;
+    return old_probes_one(&s_board) + old_probes_one(&s_board2);
+}
+
+static void probes_result(cmd_fanout_target_t *target, void *user)
+{
+    *(int *)user += target->status == CMD_DONE && strstr(target->out, "HotelGuest") != NULL;
+}
+
+static int new_probes(board_t *b, cmd_session_t *s)
+{
+    static char out[2][2048];
+    (void)b;
+    (void)s;
+    cmd_fanout_target_t targets[] = {
+        {.session = &s_session, .name = "UART1", .out = out[0], .out_cap = sizeof(out[0])},
+        {.session = &s_session2, .name = "MBus", .out = out[1], .out_cap = sizeof(out[1])},
+    };
+    cmd_request_t req = {
+        .command = "list_probes",
+        .quiet_ms = 200,
+        .timeout_ms = 2500,
+    };
+    int found = 0;
+    cmd_fanout_run(&req, targets, 2, probes_result, &found);
+    return found;
+}
+
+typedef struct {
+    const char *name;
+    int (*old_fn)(board_t *b);
+    int (*new_fn)(board_t *b, cmd_session_t *s);
+    int expect;
+} bench_case_t;
+
+static int run_benchmark(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    if (!board_start(&s_board, "board", true) || !board_start(&s_board2, "board2", false) ||
+        !session_start(&s_session, &s_board) || !session_start(&s_session2, &s_board2)) {
+        printf("FAIL cannot start the boards\n");
+        return EXIT_FAILURE;
+    }
+    static const bench_case_t cases[] = {
+        {"karma_fetch_html_files (list_sd)", old_list_sd, new_list_sd, 5},
+        {"check_sd_card_for_tab (list_sd)", old_check_sd, new_check_sd, 1},
+        {"count_remote_handshake_files (list_dir)", old_list_dir, new_list_dir, 1},
+        {"read_channel_time (channel_time)", old_channel_time, new_channel_time, 120},
+        {"adhoc_fetch_probes, two boards", old_probes, new_probes, 2},
+    };
+    printf("ms until the result is in hand, best of %d\n", BENCH_ROUNDS);
+    printf("%-42s %10s %10s\n", "call site", "before", "session");
+    bool ok = true;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        double best_old = 0;
+        double best_new = 0;
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            int64_t start = now_ns();
+            ok = ok && cases[c].old_fn(&s_board) == cases[c].expect;
+            double old_ms = (double)(now_ns() - start) / 1e6;
+            sleep_ms(50);
+            start = now_ns();
+            ok = ok && cases[c].new_fn(&s_board, &s_session) == cases[c].expect;
+            double new_ms = (double)(now_ns() - start) / 1e6;
+            sleep_ms(50);
+            best_old = r == 0 || old_ms < best_old ? old_ms : best_old;
+            best_new = r == 0 || new_ms < best_new ? new_ms : best_new;
+        }
+        printf("%-42s %10.1f %10.1f\n", cases[c].name, best_old, best_new);
+    }
+    if (!ok) {
+        printf("FAIL a call site got the wrong result\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
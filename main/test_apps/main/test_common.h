@@ -0,0 +1,58 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+/*
+ * Shared by the host tests: a check macro that keeps going after a
+ * failure, a deterministic xorshift generator and a monotonic clock.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MIN_NS        (200 * 1000 * 1000LL)   // per timing round
+#define BENCH_ROUNDS        5
+
+static int test_checks;
+static int test_failed;
+
+#define CHECK(cond) do { \
+        test_checks++; \
+        if (!(cond)) { \
+            test_failed++; \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+// Per thread, so tests with several tasks stay race free
+static _Thread_local uint32_t rng_state = 0x12345678;
+
+static inline uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Uniform in [lo, hi]
+static inline uint32_t rng_range(uint32_t lo, uint32_t hi)
+{
+    return lo + rng() % (hi - lo + 1);
+}
+
+static inline int64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+static inline int test_result(void)
+{
+    printf("%d checks, %d failed\n", test_checks, test_failed);
+    return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,446 @@
+/*
+ * Host test of the keyed list reconciler and the patch helpers (ui_components.c) on LVGL 9 with a headless
+ * 720x1280 display.
+ *
+ *   test_keyed_list          functionality test: random inserts, deletes, moves and edits; after each sync
+ *                            the rows are in item order, show their item, and rows of surviving keys are the
+ *                            same objects; the patch helpers and the update counters only count real changes
+ *   test_keyed_list bench    objects touched, pixels invalidated and time per update (layout and render
+ *                            included) for a 100-device BT list against cleaning and recreating every row
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lv_host.h"
+#include "ui_components.h"
+#include "ui_theme.h"
+#include "test_common.h"
+
+#define MAX_DEVICES     256
+
+typedef struct {
+    uint32_t id;                // becomes the MAC, so the key
+    char name[24];
+    int rssi;
+} device_t;
+
+static device_t s_devices[MAX_DEVICES];
+static uint32_t s_device_count;
+static uint32_t s_next_id;
+
+static device_t new_device(void)
+{
+    device_t d = {.id = s_next_id++, .rssi = -(int)rng_range(30, 95)};
+    if (rng() % 2) {
+        snprintf(d.name, sizeof(d.name), "dev-%u", (unsigned)d.id);
+    }
+    return d;
+}
+
+static void format_mac(uint32_t id, char out[18])
+{
+    snprintf(out, 18, "C0:FF:EE:%02X:%02X:%02X", (unsigned)(id >> 16) & 0xFF, (unsigned)(id >> 8) & 0xFF,
+             (unsigned)id & 0xFF);
+}
+
+static const char *row_key_cb(uint32_t index, void *user_data)
+{
+    (void)user_data;
+    static char key[18];
+    format_mac(s_devices[index].id, key);
+    return key;
+}
+
+// A BT scan row: name or MAC, MAC when named, RSSI
+static void row_create_cb(lv_obj_t *row, void *user_data)
+{
+    (void)user_data;
+    lv_obj_set_size(row, lv_pct(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_color(row, ui_theme_color(UI_COLOR_CARD), 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_radius(row, 6, 0);
+    lv_obj_set_style_pad_all(row, 10, 0);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *name_lbl = lv_label_create(row);
+    lv_obj_set_width(name_lbl, 155);
+    lv_obj_set_style_text_font(name_lbl, &lv_font_montserrat_14, 0);
+
+    lv_obj_t *mac_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(mac_lbl, &lv_font_montserrat_12, 0);
+    lv_obj_set_width(mac_lbl, 155);
+    lv_obj_add_flag(mac_lbl, LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_t *rssi_lbl = lv_label_create(row);
+    lv_obj_set_style_text_font(rssi_lbl, &lv_font_montserrat_14, 0);
+    lv_obj_set_width(rssi_lbl, 70);
+}
+
+static lv_color_t rssi_color(int rssi)
+{
+    return rssi > -50 ? lv_color_hex(0x4CAF50) : rssi > -70 ? lv_color_hex(0xFFC107) : lv_color_hex(0xF44336);
+}
+
+static void row_bind_cb(lv_obj_t *row, uint32_t index, void *user_data)
+{
+    (void)user_data;
+    const device_t *dev = &s_devices[index];
+    bool has_name = dev->name[0] != '\0';
+    char mac[18];
+    format_mac(dev->id, mac);
+    ui_comp_patch_flag(lv_obj_get_child(row, 1), LV_OBJ_FLAG_HIDDEN, !has_name);
+    ui_comp_patch_label_text(lv_obj_get_child(row, 0), has_name ? dev->name : mac);
+    ui_comp_patch_label_text(lv_obj_get_child(row, 1), mac);
+    lv_obj_t *rssi_lbl = lv_obj_get_child(row, 2);
+    ui_comp_patch_label_text_fmt(rssi_lbl, "%d dBm", dev->rssi);
+    ui_comp_patch_text_color(rssi_lbl, rssi_color(dev->rssi));
+}
+
+static lv_obj_t *create_list(void)
+{
+    lv_obj_t *list = lv_obj_create(lv_screen_active());
+    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_row(list, 6, 0);
+    return list;
+}
+
+static void sync(lv_obj_t *list, ui_comp_keyed_stats_t *stats)
+{
+    ui_comp_keyed_list_sync(list, s_device_count, row_key_cb, row_create_cb, row_bind_cb, NULL, stats);
+}
+
+static bool key_in_devices(const char *key)
+{
+    char mac[18];
+    for (uint32_t i = 0; i < s_device_count; i++) {
+        format_mac(s_devices[i].id, mac);
+        if (strcmp(mac, key) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void random_edit(void)
+{
+    uint32_t n = s_device_count;
+    switch (rng() % 5) {
+        case 0:     // new device at a random position
+            if (n < MAX_DEVICES) {
+                uint32_t at = rng_range(0, n);
+                memmove(&s_devices[at + 1], &s_devices[at], (n - at) * sizeof(device_t));
+                s_devices[at] = new_device();
+                s_device_count++;
+            }
+            break;
+        case 1:     // device gone
+            if (n > 0) {
+                uint32_t at = rng_range(0, n - 1);
+                memmove(&s_devices[at], &s_devices[at + 1], (n - at - 1) * sizeof(device_t));
+                s_device_count--;
+            }
+            break;
+        case 2:     // re-sorted by RSSI: one device moves
+            if (n > 1) {
+                uint32_t from = rng_range(0, n - 1);
+                uint32_t to = rng_range(0, n - 1);
+                device_t d = s_devices[from];
+                memmove(&s_devices[from], &s_devices[from + 1], (n - from - 1) * sizeof(device_t));
+                memmove(&s_devices[to + 1], &s_devices[to], (n - 1 - to) * sizeof(device_t));
+                s_devices[to] = d;
+            }
+            break;
+        case 3:     // RSSI changed
+            if (n > 0) {
+                s_devices[rng_range(0, n - 1)].rssi = -(int)rng_range(30, 95);
+            }
+            break;
+        default:    // name resolved or lost
+            if (n > 0) {
+                device_t *d = &s_devices[rng_range(0, n - 1)];
+                if (d->name[0]) {
+                    d->name[0] = '\0';
+                } else {
+                    snprintf(d->name, sizeof(d->name), "named-%u", (unsigned)d->id);
+                }
+            }
+            break;
+    }
+}
+
+static void test_reconcile(void)
+{
+    lv_obj_t *list = create_list();
+    static lv_obj_t *old_rows[MAX_DEVICES];
+    static char old_keys[MAX_DEVICES][18];
+    uint32_t old_count = 0;
+
+    for (int round = 0; round < 400; round++) {
+        int edits = (int)rng_range(0, 6);
+        for (int e = 0; e < edits; e++) {
+            random_edit();
+        }
+
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < old_count; i++) {
+            kept += key_in_devices(old_keys[i]);
+        }
+
+        ui_comp_keyed_stats_t stats;
+        sync(list, &stats);
+        CHECK(lv_obj_get_child_count(list) == s_device_count);
+        CHECK(stats.created == s_device_count - kept);
+        CHECK(stats.deleted == old_count - kept);
+        CHECK(stats.moved <= kept);
+
+        bool rows_ok = true;
+        for (uint32_t i = 0; i < s_device_count; i++) {
+            lv_obj_t *row = lv_obj_get_child(list, (int32_t)i);
+            char mac[18];
+            format_mac(s_devices[i].id, mac);
+            const device_t *dev = &s_devices[i];
+            rows_ok &= strcmp((const char *)lv_obj_get_user_data(row), mac) == 0;
+            rows_ok &= strcmp(lv_label_get_text(lv_obj_get_child(row, 0)), dev->name[0] ? dev->name : mac) == 0;
+            rows_ok &= lv_obj_has_flag(lv_obj_get_child(row, 1), LV_OBJ_FLAG_HIDDEN) == !dev->name[0];
+            char rssi[16];
+            snprintf(rssi, sizeof(rssi), "%d dBm", dev->rssi);
+            rows_ok &= strcmp(lv_label_get_text(lv_obj_get_child(row, 2)), rssi) == 0;
+            // A surviving key keeps its row object
+            for (uint32_t j = 0; j < old_count; j++) {
+                if (strcmp(old_keys[j], mac) == 0) {
+                    rows_ok &= old_rows[j] == row;
+                    break;
+                }
+            }
+        }
+        CHECK(rows_ok);
+
+        for (uint32_t i = 0; i < s_device_count; i++) {
+            old_rows[i] = lv_obj_get_child(list, (int32_t)i);
+            format_mac(s_devices[i].id, old_keys[i]);
+        }
+        old_count = s_device_count;
+        if (round % 50 == 0) {
+            lv_refr_now(NULL);
+        }
+    }
+
+    // Emptying the list deletes every row
+    uint32_t rows = s_device_count;
+    s_device_count = 0;
+    ui_comp_keyed_stats_t stats;
+    sync(list, &stats);
+    CHECK(stats.deleted == rows && stats.created == 0);
+    CHECK(lv_obj_get_child_count(list) == 0);
+    lv_obj_delete(list);
+}
+
+static void test_unchanged_update(void)
+{
+    lv_obj_t *list = create_list();
+    s_device_count = 0;
+    for (int i = 0; i < 40; i++) {
+        s_devices[s_device_count++] = new_device();
+    }
+    sync(list, NULL);
+    lv_refr_now(NULL);
+
+    // Same data again: nothing is touched, nothing is invalidated
+    ui_comp_update_counters_t before, after;
+    ui_comp_get_update_counters(&before);
+    ui_comp_keyed_stats_t stats;
+    sync(list, &stats);
+    lv_obj_update_layout(list);
+    ui_comp_get_update_counters(&after);
+    CHECK(stats.created == 0 && stats.moved == 0 && stats.deleted == 0);
+    CHECK(after.objects_touched == before.objects_touched);
+    CHECK(after.invalidated_px == before.invalidated_px);
+
+    // One RSSI on screen: its text and color, within the row
+    s_devices[2].rssi = s_devices[2].rssi > -50 ? -80 : -40;
+    ui_comp_get_update_counters(&before);
+    sync(list, &stats);
+    lv_obj_update_layout(list);
+    ui_comp_get_update_counters(&after);
+    CHECK(after.objects_touched - before.objects_touched == 2);
+    lv_obj_t *row = lv_obj_get_child(list, 2);
+    uint32_t row_px = (uint32_t)(lv_obj_get_width(row) * lv_obj_get_height(row));
+    CHECK(after.invalidated_px > before.invalidated_px);
+    CHECK(after.invalidated_px - before.invalidated_px <= row_px);
+
+    // Rendering doesn't count, invalidating the screen counts its area
+    lv_refr_now(NULL);
+    ui_comp_get_update_counters(&before);
+    lv_refr_now(NULL);
+    ui_comp_get_update_counters(&after);
+    CHECK(after.invalidated_px == before.invalidated_px);
+    lv_obj_invalidate(lv_screen_active());
+    ui_comp_get_update_counters(&after);
+    CHECK(after.invalidated_px - before.invalidated_px == 720 * 1280);
+    lv_refr_now(NULL);
+    lv_obj_delete(list);
+}
+
+static void test_patch_helpers(void)
+{
+    lv_obj_t *label = lv_label_create(lv_screen_active());
+    lv_label_set_text(label, "abc");
+    lv_refr_now(NULL);
+
+    ui_comp_update_counters_t before, after;
+    ui_comp_get_update_counters(&before);
+    CHECK(!ui_comp_patch_label_text(label, "abc"));
+    CHECK(!ui_comp_patch_label_text_fmt(label, "%c%s", 'a', "bc"));
+    CHECK(!ui_comp_patch_flag(label, LV_OBJ_FLAG_HIDDEN, false));
+    lv_obj_set_style_text_color(label, lv_color_hex(0x123456), 0);
+    lv_refr_now(NULL);
+    ui_comp_get_update_counters(&before);
+    CHECK(!ui_comp_patch_text_color(label, lv_color_hex(0x123456)));
+    ui_comp_get_update_counters(&after);
+    CHECK(after.objects_touched == before.objects_touched && after.invalidated_px == before.invalidated_px);
+
+    CHECK(ui_comp_patch_label_text(label, "abd"));
+    CHECK(strcmp(lv_label_get_text(label), "abd") == 0);
+    CHECK(ui_comp_patch_label_text_fmt(label, "%d", 42));
+    CHECK(strcmp(lv_label_get_text(label), "42") == 0);
+    CHECK(ui_comp_patch_label_text(label, NULL));
+    CHECK(strcmp(lv_label_get_text(label), "") == 0);
+    CHECK(ui_comp_patch_text_color(label, lv_color_hex(0x654321)));
+    CHECK(ui_comp_patch_flag(label, LV_OBJ_FLAG_HIDDEN, true));
+    CHECK(lv_obj_has_flag(label, LV_OBJ_FLAG_HIDDEN));
+    ui_comp_get_update_counters(&after);
+    CHECK(after.objects_touched - before.objects_touched == 5);
+
+    CHECK(!ui_comp_patch_label_text(NULL, "x"));
+    CHECK(!ui_comp_patch_text_color(NULL, lv_color_hex(0)));
+    CHECK(!ui_comp_patch_flag(NULL, LV_OBJ_FLAG_HIDDEN, true));
+    lv_obj_delete(label);
+}
+
+static int run_functionality(void)
+{
+    test_reconcile();
+    test_unchanged_update();
+    test_patch_helpers();
+    return test_result();
+}
+
+typedef enum {
+    SCENARIO_NONE,              // poll without news
+    SCENARIO_RSSI,              // one RSSI on screen changed
+    SCENARIO_INSERT_DELETE,     // a new device at the top, then gone again
+} scenario_t;
+
+static void scenario_apply(scenario_t scenario, uint32_t round)
+{
+    switch (scenario) {
+        case SCENARIO_RSSI:
+            s_devices[3].rssi = round % 2 ? -42 : -81;
+            break;
+        case SCENARIO_INSERT_DELETE:
+            if (round % 2) {
+                memmove(&s_devices[1], &s_devices[0], s_device_count * sizeof(device_t));
+                s_devices[0] = new_device();
+                s_device_count++;
+            } else {
+                memmove(&s_devices[0], &s_devices[1], (s_device_count - 1) * sizeof(device_t));
+                s_device_count--;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+typedef struct {
+    double ns;
+    double objects;
+    double px;
+} bench_result_t;
+
+static bench_result_t bench_scenario(scenario_t scenario, bool keyed)
+{
+    lv_obj_t *list = create_list();
+    s_device_count = 0;
+    s_next_id = 0;
+    for (int i = 0; i < 100; i++) {
+        s_devices[s_device_count++] = new_device();
+        s_devices[i].name[0] = '\0';
+    }
+    sync(list, NULL);
+    lv_refr_now(NULL);
+
+    bench_result_t best = {0};
+    uint32_t round = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint64_t objects = 0;
+        ui_comp_update_counters_t before, after;
+        ui_comp_get_update_counters(&before);
+        uint32_t n = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            scenario_apply(scenario, ++round);
+            if (keyed) {
+                sync(list, NULL);
+            } else {
+                objects += lv_host_count_objects(list) - 1;
+                lv_obj_clean(list);
+                for (uint32_t i = 0; i < s_device_count; i++) {
+                    lv_obj_t *row = lv_obj_create(list);
+                    row_create_cb(row, NULL);
+                    row_bind_cb(row, i, NULL);
+                }
+                objects += lv_host_count_objects(list) - 1;
+            }
+            lv_refr_now(NULL);
+            n++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS || n % 2);
+        ui_comp_get_update_counters(&after);
+        if (keyed) {
+            objects = after.objects_touched - before.objects_touched;
+        }
+        double ns = (double)elapsed / n;
+        if (r == 0 || ns < best.ns) {
+            best.ns = ns;
+        }
+        best.objects = (double)objects / n;
+        best.px = (double)(after.invalidated_px - before.invalidated_px) / n;
+    }
+    lv_obj_delete(list);
+    lv_refr_now(NULL);
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    printf("100 BT devices, update = sync or clean and recreate, then layout and render; best of %d\n", BENCH_ROUNDS);
+    printf("%-14s %-8s %12s %16s %16s\n", "change", "list", "us/update", "objects/update", "kpx/update");
+    static const char *names[] = {"none", "one RSSI", "insert/delete"};
+    for (int s = SCENARIO_NONE; s <= SCENARIO_INSERT_DELETE; s++) {
+        for (int keyed = 1; keyed >= 0; keyed--) {
+            bench_result_t r = bench_scenario((scenario_t)s, keyed);
+            printf("%-14s %-8s %12.1f %16.1f %16.1f\n", names[s], keyed ? "keyed" : "rebuild", r.ns / 1000.0,
+                   r.objects, r.px / 1000.0);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    lv_display_t *disp = lv_host_init(720, 1280);
+    ui_theme_init(disp);
+    ui_comp_track_invalidations(disp);
+
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    lv_host_deinit();
+    return rc;
+}
@@ -0,0 +1,374 @@
+/*
+ * Host test of the streaming line framer (line_framer.c) behind a fake transport.
+ *
+ *   test_line_framer          functionality test: random lines with mixed CR/LF delimiters and overlong
+ *                             lines, delivered in random chunk sizes through the read callback and through
+ *                             line_framer_feed(), on rings of 16 bytes to 4 KB; every line is compared with
+ *                             a reference split of the input
+ *   test_line_framer bench    lines/s and bytes copied per line against the per-task loop the framer
+ *                             replaced (read into rx_buffer, copy byte by byte into line_buffer)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "line_framer.h"
+#include "test_common.h"
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    size_t max_chunk;           // random read sizes up to this, 0: whatever fits
+    size_t chunk;               // fixed read size, 0: whatever fits
+    uint32_t last_timeout;
+} fake_transport_t;
+
+static int fake_read(void *user_data, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    fake_transport_t *t = (fake_transport_t *)user_data;
+    t->last_timeout = timeout;
+    size_t n = t->len - t->pos;
+    if (n > len) {
+        n = len;
+    }
+    if (t->chunk > 0 && n > t->chunk) {
+        n = t->chunk;
+    }
+    if (t->max_chunk > 0 && n > 1) {
+        size_t chunk = rng_range(1, (uint32_t)t->max_chunk);
+        n = n < chunk ? n : chunk;
+    }
+    memcpy(dst, t->data + t->pos, n);
+    t->pos += n;
+    return (int)n;
+}
+
+typedef struct {
+    size_t start;
+    size_t len;
+} span_t;
+
+typedef struct {
+    char *data;
+    size_t len;
+    span_t *lines;              // non-empty lines as the reference split finds them
+    size_t count;
+} script_t;
+
+static void script_free(script_t *s)
+{
+    free(s->data);
+    free(s->lines);
+}
+
+// Random printable lines of 0..max_line bytes, separated by LF, CR LF, CR or blank lines
+static script_t script_random(size_t count, size_t max_line)
+{
+    static const char *const delims[] = {"\n", "\r\n", "\r", "\n\n", "\r\n\r\n"};
+    script_t s = {0};
+    size_t cap = count * (max_line + 4) + 1;
+    s.data = malloc(cap);
+    s.lines = calloc(count, sizeof(span_t));
+    for (size_t i = 0; i < count; i++) {
+        size_t len = rng_range(0, (uint32_t)max_line);
+        size_t start = s.len;
+        for (size_t j = 0; j < len; j++) {
+            s.data[s.len++] = (char)rng_range(' ', '~');
+        }
+        if (len > 0) {
+            s.lines[s.count++] = (span_t){start, len};
+        }
+        const char *d = delims[rng() % 5];
+        memcpy(s.data + s.len, d, strlen(d));
+        s.len += strlen(d);
+    }
+    return s;
+}
+
+// Compare one framed line with the reference: lines of capacity bytes or more come out truncated to capacity
+static bool check_line(const script_t *s, size_t index, const line_view_t *view, const line_framer_t *framer)
+{
+    if (index >= s->count) {
+        printf("FAIL extra line '%s'\n", view->text);
+        return false;
+    }
+    const span_t *want = &s->lines[index];
+    size_t want_len = want->len < framer->capacity ? want->len : framer->capacity;
+    bool want_truncated = want->len >= framer->capacity;
+    bool in_ring = (uint8_t *)view->text >= framer->ring && (uint8_t *)view->text < framer->ring + framer->capacity;
+    bool in_scratch = view->text == framer->scratch;
+
+    if (view->len != want_len || view->truncated != want_truncated || strlen(view->text) != view->len ||
+            memcmp(view->text, s->data + want->start, want_len) != 0 || !(in_ring || in_scratch)) {
+        printf("FAIL capacity %zu line %zu: got %zu bytes%s, expected %zu%s\n", framer->capacity, index,
+               view->len, view->truncated ? " truncated" : "", want_len, want_truncated ? " truncated" : "");
+        return false;
+    }
+    return true;
+}
+
+static void test_read_path(size_t capacity, size_t max_line, size_t max_chunk)
+{
+    script_t s = script_random(2000, max_line);
+    uint8_t *ring = malloc(capacity + 1);
+    char *scratch = malloc(capacity + 1);
+    fake_transport_t t = {.data = (const uint8_t *)s.data, .len = s.len, .max_chunk = max_chunk};
+    line_framer_t framer;
+    CHECK(line_framer_init(&framer, ring, scratch, capacity, fake_read, &t));
+
+    size_t got = 0;
+    bool ok = true;
+    line_view_t view;
+    while (ok) {
+        if (line_framer_next_line(&framer, &view, 7)) {
+            ok = check_line(&s, got++, &view, &framer);
+        } else if (t.pos == t.len && !line_framer_pop(&framer, &view)) {
+            break;
+        }
+    }
+    CHECK(ok);
+    CHECK(got == s.count);
+    CHECK(t.last_timeout == 7);
+    CHECK(framer.stats.lines == s.count);
+    CHECK(framer.stats.bytes_in == s.len);
+    CHECK(line_framer_buffered(&framer) == 0);
+
+    uint32_t truncated = 0;
+    for (size_t i = 0; i < s.count; i++) {
+        truncated += s.lines[i].len >= capacity;
+    }
+    CHECK(framer.stats.truncated_lines == truncated);
+
+    free(ring);
+    free(scratch);
+    script_free(&s);
+}
+
+static void test_feed_path(size_t capacity, size_t max_line)
+{
+    script_t s = script_random(2000, max_line);
+    uint8_t *ring = malloc(capacity + 1);
+    char *scratch = malloc(capacity + 1);
+    line_framer_t framer;
+    CHECK(line_framer_init(&framer, ring, scratch, capacity, NULL, NULL));
+
+    size_t pos = 0;
+    size_t got = 0;
+    bool ok = true;
+    line_view_t view;
+    while (ok && (pos < s.len || line_framer_buffered(&framer) > 0)) {
+        size_t chunk = rng_range(1, 300);
+        if (chunk > s.len - pos) {
+            chunk = s.len - pos;
+        }
+        pos += line_framer_feed(&framer, (const uint8_t *)s.data + pos, chunk);
+        bool popped = false;
+        while (ok && line_framer_pop(&framer, &view)) {
+            ok = check_line(&s, got++, &view, &framer);
+            popped = true;
+        }
+        if (!popped && pos == s.len) {
+            break;
+        }
+    }
+    CHECK(ok);
+    CHECK(got == s.count);
+    CHECK(line_framer_fill(&framer, 0) == 0);       // no read callback
+
+    free(ring);
+    free(scratch);
+    script_free(&s);
+}
+
+static void test_edges(void)
+{
+    uint8_t ring[17];
+    char scratch[17];
+    line_framer_t framer;
+    line_view_t view;
+
+    CHECK(!line_framer_init(&framer, ring, scratch, 12, NULL, NULL));     // not a power of two
+    CHECK(!line_framer_init(&framer, ring, scratch, 1, NULL, NULL));
+    CHECK(!line_framer_init(&framer, NULL, scratch, 16, NULL, NULL));
+    CHECK(line_framer_init(&framer, ring, scratch, 16, NULL, NULL));
+
+    // A line is only handed out once its delimiter arrived
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"abc", 3) == 3);
+    CHECK(!line_framer_pop(&framer, &view));
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"d\r\n\n\nxy\n", 8) == 8);
+    CHECK(line_framer_pop(&framer, &view) && strcmp(view.text, "abcd") == 0 && !view.truncated);
+    CHECK(line_framer_pop(&framer, &view) && strcmp(view.text, "xy") == 0);
+    CHECK(!line_framer_pop(&framer, &view));
+
+    // The ring never takes more than it can hold
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"0123456789abcdefXYZ", 19) == 16);
+    CHECK(line_framer_pop(&framer, &view) && view.len == 16 && view.truncated);
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"rest\nnext\n", 10) == 10);
+    CHECK(line_framer_pop(&framer, &view) && strcmp(view.text, "next") == 0);
+
+    // Reset drops a partial line
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"partial", 7) == 7);
+    line_framer_reset(&framer);
+    CHECK(line_framer_buffered(&framer) == 0);
+    CHECK(line_framer_feed(&framer, (const uint8_t *)"new\n", 4) == 4);
+    CHECK(line_framer_pop(&framer, &view) && strcmp(view.text, "new") == 0);
+}
+
+static int run_functionality(void)
+{
+    static const size_t capacities[] = {16, 64, 1024, 4096};
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+        size_t cap = capacities[c];
+        // Short lines, lines around the capacity, and far longer ones
+        test_read_path(cap, cap / 2, 0);
+        test_read_path(cap, cap / 2, 1);
+        test_read_path(cap, cap + 2, 37);
+        test_read_path(cap, cap * 3, 0);
+        test_feed_path(cap, cap / 2);
+        test_feed_path(cap, cap * 2);
+    }
+    test_edges();
+    return test_result();
+}
+
+// JanOS style output: scan rows, sniffer rows and log lines, "\n" terminated
+static script_t script_janos(size_t bytes)
+{
+    script_t s = {0};
+    s.data = malloc(bytes + 256);
+    while (s.len < bytes) {
+        int n;
+        switch (rng() % 3) {
+        case 0:
+            n = sprintf(s.data + s.len, "\"%u\",\"Network_%u\",\"\",\"C4:2B:44:%02X:%02X:%02X\",\"%u\",\"WPA2\",\"-%u\","
+                        "\"2.4GHz\"\n", rng() % 200, rng() % 1000, rng() & 0xff, rng() & 0xff, rng() & 0xff,
+                        rng_range(1, 13), rng_range(30, 95));
+            break;
+        case 1:
+            n = sprintf(s.data + s.len, " 3C:71:BF:%02X:%02X:%02X\n", rng() & 0xff, rng() & 0xff, rng() & 0xff);
+            break;
+        default:
+            n = sprintf(s.data + s.len, "I (%u) wifi: channel %u, %u packets\n", rng() % 100000, rng_range(1, 13),
+                        rng() % 500);
+            break;
+        }
+        s.len += (size_t)n;
+        s.count++;
+    }
+    return s;
+}
+
+typedef struct {
+    uint32_t lines;
+    uint64_t bytes_copied;
+    uint32_t checksum;          // keeps the consumer from being optimised away
+} bench_result_t;
+
+// What every monitor task did before: read a chunk, copy it byte by byte into its own line buffer
+static bench_result_t bench_legacy(fake_transport_t *t)
+{
+    static char rx_buffer[512];
+    static char line_buffer[512];
+    bench_result_t r = {0};
+    size_t line_pos = 0;
+    int len;
+    while ((len = fake_read(t, (uint8_t *)rx_buffer, sizeof(rx_buffer) - 1, 0)) > 0) {
+        rx_buffer[len] = '\0';
+        for (int i = 0; i < len; i++) {
+            char c = rx_buffer[i];
+            if (c == '\n' || c == '\r') {
+                if (line_pos > 0) {
+                    line_buffer[line_pos] = '\0';
+                    r.lines++;
+                    r.bytes_copied += line_pos;
+                    r.checksum += (uint8_t)line_buffer[0] + (uint32_t)line_pos;
+                    line_pos = 0;
+                }
+            } else if (line_pos < sizeof(line_buffer) - 1) {
+                line_buffer[line_pos++] = c;
+            }
+        }
+    }
+    return r;
+}
+
+static bench_result_t bench_framer(fake_transport_t *t)
+{
+    static uint8_t ring[4096 + 1];
+    static char scratch[4096 + 1];
+    bench_result_t r = {0};
+    line_framer_t framer;
+    line_framer_init(&framer, ring, scratch, 4096, fake_read, t);
+    line_view_t view = {0};
+    while (line_framer_next_line(&framer, &view, 0) || t->pos < t->len) {
+        if (view.text) {
+            r.lines++;
+            r.checksum += (uint8_t)view.text[0] + (uint32_t)view.len;
+            view.text = NULL;
+        }
+    }
+    r.bytes_copied = framer.stats.bytes_copied;
+    return r;
+}
+
+typedef bench_result_t (*bench_fn_t)(fake_transport_t *t);
+
+// One timing round, at least BENCH_MIN_NS long; nanoseconds per pass over the script
+static double bench_round(bench_fn_t fn, const script_t *s, bench_result_t *result)
+{
+    int64_t start = now_ns();
+    int64_t elapsed;
+    long passes = 0;
+    do {
+        // Reads of up to 512 bytes, like the transport's raw buffer
+        fake_transport_t t = {.data = (const uint8_t *)s->data, .len = s->len, .chunk = 512};
+        *result = fn(&t);
+        passes++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    return (double)elapsed / passes;
+}
+
+static int run_benchmark(void)
+{
+    script_t s = script_janos(1 << 20);
+    printf("%zu lines, %zu bytes of JanOS style output, best of %d\n", s.count, s.len, BENCH_ROUNDS);
+    printf("%-8s %12s %10s %16s\n", "consumer", "Mlines/s", "MB/s", "copied B/line");
+
+    static const struct {
+        const char *name;
+        bench_fn_t fn;
+    } consumers[] = {
+        {"legacy", bench_legacy},
+        {"framer", bench_framer},
+    };
+    uint32_t checksum[2] = {0};
+    for (size_t c = 0; c < 2; c++) {
+        double best = 0;
+        bench_result_t r = {0};
+        for (int i = 0; i < BENCH_ROUNDS; i++) {
+            double ns = bench_round(consumers[c].fn, &s, &r);
+            best = i == 0 || ns < best ? ns : best;
+        }
+        checksum[c] = r.checksum;
+        printf("%-8s %12.1f %10.0f %16.2f\n", consumers[c].name, r.lines / best * 1000.0, s.len / best * 1000.0,
+               (double)r.bytes_copied / r.lines);
+    }
+    script_free(&s);
+    if (checksum[0] != checksum[1]) {
+        printf("FAIL the two consumers saw different lines\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
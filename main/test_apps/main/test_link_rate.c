@@ -0,0 +1,477 @@
+/*
+ * Host test and benchmark of the line-rate ladder, test patterns and receive meter (link_rate.c).
+ *
+ *   test_link_rate          functionality test: next/lower against every rung and the limits between
+ *                           them, and a full climb; pattern determinism and alphabet; echo check against
+ *                           a reference, with every single-bit flip of the echo and of the pattern the
+ *                           board received; the meter against a 64-bit model across the ms-clock wrap,
+ *                           and on a simulated link at every rung
+ *   test_link_rate bench    ns per meter update, pattern and echo check; time per handshake rung and
+ *                           per MB of output at every rung, from the header's constants
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "link_rate.h"
+#include "wire_codec.h"
+#include "test_common.h"
+
+#define BITS_PER_BYTE       10      // 8N1
+#define MODEL_STEPS         200000
+
+static const char s_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static void test_ladder(void)
+{
+    CHECK(link_rate_ladder_count >= 2);
+    CHECK(link_rate_ladder[0] == LINK_RATE_DEFAULT);
+    for (size_t i = 1; i < link_rate_ladder_count; i++) {
+        CHECK(link_rate_ladder[i] > link_rate_ladder[i - 1]);
+    }
+    const uint32_t top = link_rate_ladder[link_rate_ladder_count - 1];
+
+    for (size_t i = 0; i < link_rate_ladder_count; i++) {
+        uint32_t rung = link_rate_ladder[i];
+        uint32_t above = i + 1 < link_rate_ladder_count ? link_rate_ladder[i + 1] : 0;
+        // The limit decides whether the next rung may be taken, nothing else
+        CHECK(link_rate_next(rung, rung) == 0);
+        CHECK(link_rate_next(rung, UINT32_MAX) == above);
+        if (above) {
+            CHECK(link_rate_next(rung, above) == above);
+            CHECK(link_rate_next(rung, above - 1) == 0);
+            // Off the ladder, the next rung is the first one above
+            CHECK(link_rate_next(rung + 1, UINT32_MAX) == above);
+            CHECK(link_rate_next(above - 1, UINT32_MAX) == above);
+            CHECK(link_rate_lower(above) == rung);
+            CHECK(link_rate_lower(above - 1) == rung);
+        }
+        CHECK(link_rate_lower(rung) == (i ? link_rate_ladder[i - 1] : LINK_RATE_DEFAULT));
+    }
+    CHECK(link_rate_next(0, UINT32_MAX) == LINK_RATE_DEFAULT);
+    CHECK(link_rate_next(9600, LINK_RATE_DEFAULT) == LINK_RATE_DEFAULT);
+    CHECK(link_rate_next(top, UINT32_MAX) == 0);
+    CHECK(link_rate_next(UINT32_MAX, UINT32_MAX) == 0);
+    CHECK(link_rate_lower(0) == LINK_RATE_DEFAULT);
+    CHECK(link_rate_lower(9600) == LINK_RATE_DEFAULT);
+    CHECK(link_rate_lower(UINT32_MAX) == top);
+
+    // A climb from the default ends on the highest rung within the board's limit, one rung per step
+    for (int n = 0; n < 2000; n++) {
+        uint32_t limit = n < 1000 ? rng_range(0, top + 500000) : link_rate_ladder[n % link_rate_ladder_count];
+        uint32_t expect = LINK_RATE_DEFAULT;
+        size_t expect_steps = 0;
+        for (size_t i = 1; i < link_rate_ladder_count && link_rate_ladder[i] <= limit; i++) {
+            expect = link_rate_ladder[i];
+            expect_steps++;
+        }
+        uint32_t rate = LINK_RATE_DEFAULT;
+        uint32_t next;
+        size_t steps = 0;
+        while ((next = link_rate_next(rate, limit)) != 0 && steps <= link_rate_ladder_count) {
+            CHECK(link_rate_lower(next) == rate);
+            rate = next;
+            steps++;
+        }
+        CHECK(rate == expect);
+        CHECK(steps == expect_steps);
+        // And stepping down returns to the default the same way
+        while (rate > LINK_RATE_DEFAULT && steps > 0) {
+            rate = link_rate_lower(rate);
+            steps--;
+        }
+        CHECK(rate == LINK_RATE_DEFAULT && steps == 0);
+    }
+}
+
+static void test_pattern(void)
+{
+    char a[LINK_RATE_TEST_LEN + 2];
+    char b[LINK_RATE_TEST_LEN + 2];
+
+    for (int n = 0; n < 1000; n++) {
+        uint32_t seed = n == 0 ? 0 : rng();
+        memset(a, '#', sizeof(a));
+        memset(b, '#', sizeof(b));
+        CHECK(link_rate_pattern(seed, a, LINK_RATE_TEST_LEN) == LINK_RATE_TEST_LEN);
+        link_rate_pattern(seed, b, LINK_RATE_TEST_LEN);
+        CHECK(memcmp(a, b, sizeof(a)) == 0);
+        CHECK(a[LINK_RATE_TEST_LEN] == '\0' && a[LINK_RATE_TEST_LEN + 1] == '#');
+
+        bool ok = strlen(a) == LINK_RATE_TEST_LEN;
+        int distinct[256] = {0};
+        int kinds = 0;
+        for (size_t i = 0; i < LINK_RATE_TEST_LEN; i++) {
+            ok = ok && strchr(s_alphabet, a[i]) != NULL;
+            kinds += distinct[(unsigned char)a[i]]++ == 0;
+        }
+        CHECK(ok);
+        CHECK(kinds >= 32);
+
+        // A shorter pattern is a prefix of the longer one
+        link_rate_pattern(seed, b, 17);
+        CHECK(strlen(b) == 17 && memcmp(a, b, 17) == 0);
+
+        link_rate_pattern(seed + 1, b, LINK_RATE_TEST_LEN);
+        CHECK(strcmp(a, b) != 0);
+    }
+    // A zero seed would keep xorshift at zero, so it stands in for 0x9E3779B9
+    link_rate_pattern(0, a, LINK_RATE_TEST_LEN);
+    link_rate_pattern(0x9E3779B9u, b, LINK_RATE_TEST_LEN);
+    CHECK(strcmp(a, b) == 0);
+    CHECK(strspn(a, "A") < LINK_RATE_TEST_LEN);
+    CHECK(link_rate_pattern(0, a, 0) == 0 && a[0] == '\0');
+}
+
+// The board's reply: "baudtest <what it received> <CRC of what it received>"
+static int board_echo(char *out, size_t size, const char *received, size_t len, bool lower_hex,
+                      const char *trailer)
+{
+    return snprintf(out, size, lower_hex ? "baudtest %.*s %04x%s" : "baudtest %.*s %04X%s", (int)len, received,
+                    wire_crc16(0xFFFF, (const uint8_t *)received, len), trailer);
+}
+
+// Reference check, written from the handshake description rather than from link_rate.c
+static bool ref_check_echo(const char *line, const char *sent, size_t sent_len)
+{
+    size_t n = strlen(line);
+    if (n < 9 + sent_len + 5 || memcmp(line, "baudtest ", 9) != 0 || memcmp(line + 9, sent, sent_len) != 0 ||
+        line[9 + sent_len] != ' ') {
+        return false;
+    }
+    const char *crc = line + 9 + sent_len + 1;
+    char digits[5] = {0};
+    for (int i = 0; i < 4; i++) {
+        if (!strchr("0123456789abcdefABCDEF", crc[i]) || crc[i] == '\0') {
+            return false;
+        }
+        digits[i] = crc[i];
+    }
+    if (strspn(crc + 4, "\r ") != strlen(crc + 4)) {
+        return false;
+    }
+    return strtoul(digits, NULL, 16) == wire_crc16(0xFFFF, (const uint8_t *)sent, sent_len);
+}
+
+static void test_echo(void)
+{
+    static const char *const trailers[] = {"", "\r", "  ", " \r"};
+    char sent[LINK_RATE_TEST_LEN + 1];
+    char received[LINK_RATE_TEST_LEN + 1];
+    char line[LINK_RATE_TEST_LEN + 32];
+
+    for (int n = 0; n < 200; n++) {
+        link_rate_pattern(rng(), sent, LINK_RATE_TEST_LEN);
+        bool lower_hex = n % 2;
+        int len = board_echo(line, sizeof(line), sent, LINK_RATE_TEST_LEN, lower_hex, trailers[n % 4]);
+        CHECK(link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN));
+        CHECK(ref_check_echo(line, sent, LINK_RATE_TEST_LEN));
+
+        // Board to Tab5: every single-bit flip of the echo line. The only flips that survive are case
+        // changes of a hex letter in the CRC, which keep its value, and a trailing space turned into the
+        // end of the line; the reference agrees on each one.
+        int accepted = 0;
+        bool agree = true;
+        bool body_rejected = true;
+        for (int i = 0; i < len; i++) {
+            for (int bit = 0; bit < 8; bit++) {
+                line[i] ^= (char)(1 << bit);
+                bool got = link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN);
+                agree = agree && got == ref_check_echo(line, sent, LINK_RATE_TEST_LEN);
+                accepted += got;
+                if (got && i < 9 + LINK_RATE_TEST_LEN + 1) {
+                    body_rejected = false;
+                }
+                line[i] ^= (char)(1 << bit);
+            }
+        }
+        CHECK(agree);
+        CHECK(body_rejected);
+        int hex_letters = 0;
+        for (int i = 0; i < 4; i++) {
+            hex_letters += strchr("abcdefABCDEF", line[9 + LINK_RATE_TEST_LEN + 1 + i]) != NULL;
+        }
+        CHECK(accepted == hex_letters + (int)strspn(trailers[n % 4], " "));
+
+        // Tab5 to board: a flipped bit on the way out, echoed faithfully, or echoed as sent with the CRC of
+        // what actually arrived. CRC-16 catches every single-bit error.
+        bool rejected = true;
+        for (int i = 0; i < LINK_RATE_TEST_LEN; i++) {
+            for (int bit = 0; bit < 7; bit++) {
+                memcpy(received, sent, sizeof(received));
+                received[i] ^= (char)(1 << bit);
+                if (received[i] == '\0') {
+                    continue;
+                }
+                board_echo(line, sizeof(line), received, LINK_RATE_TEST_LEN, lower_hex, "");
+                rejected = rejected && !link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN);
+                snprintf(line, sizeof(line), "baudtest %s %04X", sent,
+                         wire_crc16(0xFFFF, (const uint8_t *)received, LINK_RATE_TEST_LEN));
+                rejected = rejected && !link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN);
+            }
+        }
+        CHECK(rejected);
+    }
+
+    // Short, truncated and otherwise malformed replies
+    link_rate_pattern(7, sent, LINK_RATE_TEST_LEN);
+    int len = board_echo(line, sizeof(line), sent, LINK_RATE_TEST_LEN, false, "");
+    CHECK(!link_rate_check_echo(NULL, sent, LINK_RATE_TEST_LEN));
+    CHECK(!link_rate_check_echo("", sent, LINK_RATE_TEST_LEN));
+    CHECK(!link_rate_check_echo("baudtest", sent, LINK_RATE_TEST_LEN));
+    CHECK(!link_rate_check_echo("baud ok 230400", sent, LINK_RATE_TEST_LEN));
+    bool truncated_rejected = true;
+    for (int cut = 0; cut < len; cut++) {
+        char saved = line[cut];
+        line[cut] = '\0';
+        truncated_rejected = truncated_rejected && !link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN);
+        line[cut] = saved;
+    }
+    CHECK(truncated_rejected);
+    board_echo(line, sizeof(line), sent, LINK_RATE_TEST_LEN, false, " x");
+    CHECK(!link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN));
+    board_echo(line, sizeof(line), sent, LINK_RATE_TEST_LEN, false, "0");
+    CHECK(!link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN));
+    // A pattern cut short by the board, with the CRC of what it echoed
+    board_echo(line, sizeof(line), sent, LINK_RATE_TEST_LEN - 1, false, "");
+    CHECK(!link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN));
+    snprintf(line, sizeof(line), "Baudtest %s %04X", sent, wire_crc16(0xFFFF, (const uint8_t *)sent, LINK_RATE_TEST_LEN));
+    CHECK(!link_rate_check_echo(line, sent, LINK_RATE_TEST_LEN));
+}
+
+// The meter on an unwrapped 64-bit clock
+typedef struct {
+    uint64_t window_start;
+    uint64_t window_bytes;
+    uint64_t rate;
+    uint64_t peak;
+    uint64_t total;
+} ref_meter_t;
+
+static void ref_add(ref_meter_t *m, size_t bytes, uint64_t now)
+{
+    uint64_t elapsed = now - m->window_start;
+    if (elapsed >= 1000) {
+        m->rate = elapsed < 2000 ? m->window_bytes * 1000 / elapsed : 0;
+        m->peak = m->rate > m->peak ? m->rate : m->peak;
+        m->window_bytes = 0;
+        m->window_start = now;
+    }
+    m->window_bytes += bytes;
+    m->total += bytes;
+}
+
+static void test_meter_model(void)
+{
+    // Starts 100 s before the 32-bit ms clock wraps and runs well past it
+    for (int run = 0; run < 4; run++) {
+        uint64_t now = run < 2 ? 0x100000000ull - 100000 : rng();
+        link_rate_meter_t meter;
+        ref_meter_t ref = {.window_start = now};
+        link_rate_meter_reset(&meter, (uint32_t)now);
+        CHECK(link_rate_meter_rate(&meter, (uint32_t)now) == 0 && meter.peak == 0 && meter.total_kb == 0);
+
+        bool ok = true;
+        for (int i = 0; i < MODEL_STEPS; i++) {
+            // Bursts of reads a few ms apart, idle reads, and now and then a long silence
+            uint32_t r = rng() % 1000;
+            now += r < 2 ? rng_range(1000, 5000) : r < 900 ? rng_range(0, 20) : rng_range(20, 900);
+            size_t bytes = r % 5 == 0 ? 0 : rng_range(1, run == 1 ? 4096 : 600);
+            link_rate_meter_add(&meter, bytes, (uint32_t)now);
+            ref_add(&ref, bytes, now);
+
+            uint64_t later = now + rng_range(0, 2500);
+            uint64_t expect_rate = later - ref.window_start < 2000 ? ref.rate : 0;
+            ok = ok && meter.rate == ref.rate && meter.peak == ref.peak && meter.window_bytes == ref.window_bytes &&
+                 meter.window_start_ms == (uint32_t)ref.window_start &&
+                 (uint64_t)meter.total_kb * 1024 + meter.total_rem == ref.total && meter.total_rem < 1024 &&
+                 link_rate_meter_rate(&meter, (uint32_t)later) == expect_rate;
+        }
+        CHECK(ok);
+        CHECK(ref.peak > 0);
+        CHECK(now > 0x100000000ull || run >= 2);
+    }
+
+    // Known numbers: 1500 B in a window that the next read closes after 1.5 s reads 1000 B/s
+    link_rate_meter_t meter;
+    link_rate_meter_reset(&meter, 0xFFFFFE00u);
+    link_rate_meter_add(&meter, 500, 0xFFFFFE00u);
+    link_rate_meter_add(&meter, 1000, 0xFFFFFE00u + 999);
+    CHECK(meter.rate == 0);
+    link_rate_meter_add(&meter, 0, 0xFFFFFE00u + 1500);
+    CHECK(meter.rate == 1000 && meter.peak == 1000 && meter.total_kb == 1 && meter.total_rem == 476);
+    // A window that closes only after two idle seconds says nothing; the best window is kept
+    link_rate_meter_add(&meter, 0, 0xFFFFFE00u + 3600);
+    CHECK(meter.rate == 0 && meter.peak == 1000);
+    CHECK(link_rate_meter_rate(&meter, 0xFFFFFE00u + 5500) == 0);
+    link_rate_meter_reset(&meter, 42);
+    CHECK(meter.peak == 0 && meter.total_kb == 0 && meter.window_start_ms == 42);
+}
+
+// A link that is kept busy delivers baud/10 bytes a second; the reader takes what arrived every 10 ms
+static void test_meter_link(void)
+{
+    for (size_t i = 0; i < link_rate_ladder_count; i++) {
+        uint32_t baud = link_rate_ladder[i];
+        uint64_t bits = 0;
+        uint64_t delivered = 0;
+        uint32_t now = UINT32_MAX - 3000;
+        link_rate_meter_t meter;
+        link_rate_meter_reset(&meter, now);
+        for (int tick = 0; tick < 500; tick++) {
+            now += 10;
+            bits += (uint64_t)baud * 10 / 1000;
+            uint64_t arrived = bits / BITS_PER_BYTE - delivered;
+            link_rate_meter_add(&meter, (size_t)arrived, now);
+            delivered += arrived;
+        }
+        uint32_t expect = baud / BITS_PER_BYTE;
+        uint32_t rate = link_rate_meter_rate(&meter, now);
+        CHECK(rate >= expect - expect / 100 && rate <= expect + expect / 100);
+        CHECK(meter.peak >= rate && meter.peak <= expect + expect / 100);
+        CHECK((uint64_t)meter.total_kb * 1024 + meter.total_rem == delivered);
+
+        // The link goes quiet: the rate drops to 0 once a window passes without data
+        for (int tick = 0; tick < 250; tick++) {
+            now += 10;
+            link_rate_meter_add(&meter, 0, now);
+        }
+        CHECK(link_rate_meter_rate(&meter, now) == 0);
+        CHECK(meter.peak >= expect - expect / 100);
+    }
+}
+
+static int run_functionality(void)
+{
+    test_ladder();
+    test_pattern();
+    test_echo();
+    test_meter_model();
+    test_meter_link();
+    return test_result();
+}
+
+#define BENCH_ITEMS     4096
+
+static volatile uint64_t s_sink;
+
+typedef struct {
+    uint32_t seeds[BENCH_ITEMS];
+    uint16_t bytes[BENCH_ITEMS];
+    uint32_t times[BENCH_ITEMS];
+    char sent[LINK_RATE_TEST_LEN + 1];
+    char echo[LINK_RATE_TEST_LEN + 32];
+} bench_data_t;
+
+typedef uint64_t (*bench_fn_t)(const bench_data_t *d);
+
+static uint64_t bench_meter(const bench_data_t *d)
+{
+    static link_rate_meter_t meter;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        link_rate_meter_add(&meter, d->bytes[i], d->times[i]);
+    }
+    return meter.total_kb + meter.rate;
+}
+
+static uint64_t bench_pattern(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    char pattern[LINK_RATE_TEST_LEN + 1];
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        link_rate_pattern(d->seeds[i], pattern, LINK_RATE_TEST_LEN);
+        sum += (unsigned char)pattern[i % LINK_RATE_TEST_LEN];
+    }
+    return sum;
+}
+
+static uint64_t bench_echo(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += link_rate_check_echo(d->echo, d->sent, LINK_RATE_TEST_LEN);
+    }
+    return sum;
+}
+
+static double bench_ns_per_item(bench_fn_t fn, const bench_data_t *d)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t passes = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            s_sink += fn(d);
+            passes++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        double ns = (double)elapsed / (double)(passes * BENCH_ITEMS);
+        best = r == 0 || ns < best ? ns : best;
+    }
+    return best;
+}
+
+// One rung of transport_link_step() on the wire: the request and "baud ok" at the old rate, the two
+// switch delays, the test rounds and "baud commit" at the new rate
+static double rung_ms(uint32_t old_rate, uint32_t rate)
+{
+    double old_bytes = (double)strlen("baud 3000000\r\n") + (double)strlen("baud ok 3000000\r\n");
+    double new_bytes = LINK_RATE_TEST_ROUNDS * (2.0 * (strlen("baudtest ") + LINK_RATE_TEST_LEN + 2) + 5) +
+                       (double)strlen("baud commit\r\n");
+    return old_bytes * BITS_PER_BYTE * 1000.0 / old_rate + 2.0 * LINK_RATE_SWITCH_DELAY_MS +
+           new_bytes * BITS_PER_BYTE * 1000.0 / rate;
+}
+
+static int run_benchmark(void)
+{
+    static bench_data_t d;
+    uint32_t now = UINT32_MAX - 100000;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        d.seeds[i] = rng();
+        now += rng_range(0, 12);
+        d.times[i] = now;
+        d.bytes[i] = i % 5 == 0 ? 0 : (uint16_t)rng_range(1, 512);
+    }
+    link_rate_pattern(1, d.sent, LINK_RATE_TEST_LEN);
+    board_echo(d.echo, sizeof(d.echo), d.sent, LINK_RATE_TEST_LEN, false, "\r");
+    if (!link_rate_check_echo(d.echo, d.sent, LINK_RATE_TEST_LEN)) {
+        printf("FAIL the benchmark echo is rejected\n");
+        return EXIT_FAILURE;
+    }
+
+    static const struct {
+        const char *name;
+        bench_fn_t fn;
+    } cases[] = {
+        {"meter_add", bench_meter},
+        {"pattern", bench_pattern},
+        {"check_echo", bench_echo},
+    };
+    printf("best of %d\n", BENCH_ROUNDS);
+    printf("%-20s %8s\n", "operation", "ns");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        printf("%-20s %8.1f\n", cases[c].name, bench_ns_per_item(cases[c].fn, &d));
+    }
+
+    printf("\n%-10s %10s %10s %12s %12s\n", "baud", "KB/s", "rung ms", "climb ms", "s per MB");
+    double climb = 0;
+    for (size_t i = 0; i < link_rate_ladder_count; i++) {
+        uint32_t rate = link_rate_ladder[i];
+        double rung = i ? rung_ms(link_rate_ladder[i - 1], rate) : 0;
+        climb += rung;
+        printf("%-10u %10.1f %10.1f %12.1f %12.2f\n", (unsigned)rate, rate / (double)BITS_PER_BYTE / 1024.0, rung,
+               climb, 1048576.0 * BITS_PER_BYTE / rate);
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
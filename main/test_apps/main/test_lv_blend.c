@@ -0,0 +1,376 @@
+/*
+ * Host test and benchmark of esp_lvgl_port's blend hooks in the firmware's LVGL 9.5: LVGL built with
+ * LV_USE_DRAW_SW_ASM = LV_DRAW_SW_ASM_CUSTOM and esp_lvgl_port_lv_blend.h, the hooks from
+ * lv_blend_generic.c, the version targets without the assembly (the P4 among them) get.
+ *
+ * The hooks are wrapped: the wrappers count the calls and, switched off, return LV_RESULT_INVALID,
+ * so LVGL runs its own C loops on the same call. Those are the reference.
+ *
+ *   test_lv_blend        functionality test: simple fills to RGB565, RGB888, XRGB8888 and ARGB8888
+ *                        and the RGB565 normal image blend, over widths, heights, strides and
+ *                        alignments, give the pixels LVGL's loops give and leave every other byte
+ *                        alone; each call takes its hook once; masked, translucent and XRGB8888 fills,
+ *                        translucent and additive blends never do
+ *   test_lv_blend bench  ns per pixel of the hook and of LVGL's loop, per color format and area
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_argb8888.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb888.h"
+#include "esp_lvgl_port_lv_blend.h"
+#include "test_common.h"
+
+#define MAX_W               130
+#define MAX_H               5
+#define MAX_STRIDE_PAD      7       // pixels
+#define ALIGN_SPAN          16      // every start offset in a 16-byte block
+#define CANARY_BYTES        32
+#define AREA_BYTES          ((MAX_W + MAX_STRIDE_PAD) * 4 * MAX_H + ALIGN_SPAN + 2 * CANARY_BYTES)
+
+// ---- wrapped hooks ----
+
+int __real_lv_color_blend_to_argb8888_esp(asm_dsc_t *asm_dsc);
+int __real_lv_color_blend_to_rgb565_esp(asm_dsc_t *asm_dsc);
+int __real_lv_color_blend_to_rgb888_esp(asm_dsc_t *asm_dsc);
+int __real_lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc_t *asm_dsc);
+
+static bool s_hooks_on = true;
+static uint32_t s_hook_calls;
+
+int __wrap_lv_color_blend_to_argb8888_esp(asm_dsc_t *asm_dsc)
+{
+    s_hook_calls++;
+    return s_hooks_on ? __real_lv_color_blend_to_argb8888_esp(asm_dsc) : LV_RESULT_INVALID;
+}
+
+int __wrap_lv_color_blend_to_rgb565_esp(asm_dsc_t *asm_dsc)
+{
+    s_hook_calls++;
+    return s_hooks_on ? __real_lv_color_blend_to_rgb565_esp(asm_dsc) : LV_RESULT_INVALID;
+}
+
+int __wrap_lv_color_blend_to_rgb888_esp(asm_dsc_t *asm_dsc)
+{
+    s_hook_calls++;
+    return s_hooks_on ? __real_lv_color_blend_to_rgb888_esp(asm_dsc) : LV_RESULT_INVALID;
+}
+
+int __wrap_lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc_t *asm_dsc)
+{
+    s_hook_calls++;
+    return s_hooks_on ? __real_lv_rgb565_blend_normal_to_rgb565_esp(asm_dsc) : LV_RESULT_INVALID;
+}
+
+// ---- blend calls ----
+
+typedef enum {
+    FMT_RGB565,
+    FMT_RGB888,
+    FMT_XRGB8888,
+    FMT_ARGB8888,
+    FMT_IMAGE_RGB565,   // RGB565 image onto RGB565
+    FMT_COUNT,
+} blend_fmt_t;
+
+static const char *const FMT_NAMES[FMT_COUNT] = {
+    "RGB565", "RGB888", "XRGB8888", "ARGB8888", "image RGB565",
+};
+static const uint32_t FMT_PX_SIZE[FMT_COUNT] = {2, 3, 4, 4, 2};
+
+typedef struct {
+    blend_fmt_t fmt;
+    int32_t w;
+    int32_t h;
+    int32_t stride_pad;         // pixels past the area on every row
+    uint32_t dest_offset;       // bytes past a 16-byte boundary, a multiple of the pixel's alignment
+    uint32_t src_offset;
+    lv_opa_t opa;
+    const lv_opa_t *mask;       // one mask row per row, MAX_W wide
+    lv_blend_mode_t blend_mode;
+} blend_case_t;
+
+// The hook is meant to take the call: a simple fill, or a plain copy of RGB565 onto RGB565
+static bool takes_hook(const blend_case_t *c)
+{
+    if (c->fmt == FMT_XRGB8888 || c->mask || c->opa < LV_OPA_MAX) {
+        return false;
+    }
+    return c->fmt != FMT_IMAGE_RGB565 || c->blend_mode == LV_BLEND_MODE_NORMAL;
+}
+
+static int32_t stride_of(const blend_case_t *c)
+{
+    return (c->w + c->stride_pad) * (int32_t)FMT_PX_SIZE[c->fmt];
+}
+
+static void run_blend(const blend_case_t *c, uint8_t *dest, const uint8_t *src)
+{
+    lv_color_t color = lv_color_make(0x9C, 0x3B, 0xE5);
+    if (c->fmt == FMT_IMAGE_RGB565) {
+        lv_draw_sw_blend_image_dsc_t dsc = {
+            .dest_buf = dest,
+            .dest_w = c->w,
+            .dest_h = c->h,
+            .dest_stride = stride_of(c),
+            .mask_buf = c->mask,
+            .mask_stride = c->mask ? MAX_W : 0,
+            .src_buf = src,
+            .src_stride = (c->w + c->stride_pad + 3) * 2,
+            .src_color_format = LV_COLOR_FORMAT_RGB565,
+            .opa = c->opa,
+            .blend_mode = c->blend_mode,
+            .relative_area = {0, 0, c->w - 1, c->h - 1},
+            .src_area = {0, 0, c->w - 1, c->h - 1},
+        };
+        lv_draw_sw_blend_image_to_rgb565(&dsc);
+        return;
+    }
+
+    lv_draw_sw_blend_fill_dsc_t dsc = {
+        .dest_buf = dest,
+        .dest_w = c->w,
+        .dest_h = c->h,
+        .dest_stride = stride_of(c),
+        .mask_buf = c->mask,
+        .mask_stride = c->mask ? MAX_W : 0,
+        .color = color,
+        .opa = c->opa,
+        .relative_area = {0, 0, c->w - 1, c->h - 1},
+    };
+    switch (c->fmt) {
+    case FMT_RGB565:
+        lv_draw_sw_blend_color_to_rgb565(&dsc);
+        break;
+    case FMT_RGB888:
+        lv_draw_sw_blend_color_to_rgb888(&dsc, 3);
+        break;
+    case FMT_XRGB8888:
+        lv_draw_sw_blend_color_to_rgb888(&dsc, 4);
+        break;
+    default:
+        lv_draw_sw_blend_color_to_argb8888(&dsc);
+        break;
+    }
+}
+
+// ---- functionality ----
+
+static uint8_t s_ref_mem[AREA_BYTES] __attribute__((aligned(16)));
+static uint8_t s_dut_mem[AREA_BYTES] __attribute__((aligned(16)));
+static uint8_t s_src_mem[AREA_BYTES] __attribute__((aligned(16)));
+static lv_opa_t s_mask[MAX_W * MAX_H];
+
+typedef struct {
+    uint32_t cases;
+    uint32_t mismatches;
+    uint32_t wrong_calls;
+} check_stats_t;
+
+// Both buffers start from the same random bytes; LVGL's loop writes one, the hook the other
+static void check_case(const blend_case_t *c, check_stats_t *st)
+{
+    for (size_t i = 0; i < AREA_BYTES; i++) {
+        s_ref_mem[i] = s_dut_mem[i] = (uint8_t)rng();
+        s_src_mem[i] = (uint8_t)rng();
+    }
+    uint8_t *ref = s_ref_mem + CANARY_BYTES + c->dest_offset;
+    uint8_t *dut = s_dut_mem + CANARY_BYTES + c->dest_offset;
+    const uint8_t *src = s_src_mem + CANARY_BYTES + c->src_offset;
+
+    s_hooks_on = false;
+    run_blend(c, ref, src);
+    s_hooks_on = true;
+    uint32_t calls = s_hook_calls;
+    run_blend(c, dut, src);
+
+    st->cases++;
+    if (memcmp(s_ref_mem, s_dut_mem, AREA_BYTES) != 0) {
+        if (st->mismatches++ == 0) {
+            printf("FAIL %s %" PRId32 "x%" PRId32 " pad %" PRId32 " offset %" PRIu32 "/%" PRIu32 " opa %u: "
+                   "differs from LVGL's loop\n", FMT_NAMES[c->fmt], c->w, c->h, c->stride_pad,
+                   c->dest_offset, c->src_offset, c->opa);
+        }
+    }
+    if (s_hook_calls - calls != (takes_hook(c) ? 1u : 0u)) {
+        if (st->wrong_calls++ == 0) {
+            printf("FAIL %s %" PRId32 "x%" PRId32 " opa %u mask %d mode %d: %" PRIu32 " hook calls\n",
+                   FMT_NAMES[c->fmt], c->w, c->h, c->opa, c->mask != NULL, c->blend_mode,
+                   s_hook_calls - calls);
+        }
+    }
+}
+
+static const int32_t WIDTHS[] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15, 16, 17, 23, 24, 25, 31, 32, 33, 47, 48, 49, 63, 64, 65, 127, 128,
+    MAX_W,
+};
+static const int32_t HEIGHTS[] = {1, 2, MAX_H};
+static const int32_t STRIDE_PADS[] = {0, 1, 3, MAX_STRIDE_PAD};
+
+static void test_simple(void)
+{
+    for (int f = 0; f < FMT_COUNT; f++) {
+        // RGB888 is bytes; the others start on their pixel's alignment, as LVGL's buffers do
+        uint32_t align = f == FMT_RGB888 ? 1 : (f == FMT_RGB565 || f == FMT_IMAGE_RGB565 ? 2 : 4);
+        check_stats_t st = {0};
+        for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+            for (size_t h = 0; h < sizeof(HEIGHTS) / sizeof(HEIGHTS[0]); h++) {
+                for (size_t p = 0; p < sizeof(STRIDE_PADS) / sizeof(STRIDE_PADS[0]); p++) {
+                    for (uint32_t off = 0; off < ALIGN_SPAN; off += align) {
+                        blend_case_t c = {
+                            .fmt = (blend_fmt_t)f,
+                            .w = WIDTHS[w],
+                            .h = HEIGHTS[h],
+                            .stride_pad = STRIDE_PADS[p],
+                            .dest_offset = off,
+                            // the source drifts against the destination
+                            .src_offset = ((off * 3) % ALIGN_SPAN) & ~(align - 1),
+                            .opa = LV_OPA_COVER,
+                            .blend_mode = LV_BLEND_MODE_NORMAL,
+                        };
+                        check_case(&c, &st);
+                    }
+                }
+            }
+        }
+        printf("%-14s %5" PRIu32 " cases\n", FMT_NAMES[f], st.cases);
+        CHECK(st.cases > 0 && st.mismatches == 0 && st.wrong_calls == 0);
+    }
+}
+
+// What the hooks leave to LVGL: they must not be called, and LVGL's result is the reference anyway
+static void test_not_taken(void)
+{
+    for (int i = 0; i < MAX_W * MAX_H; i++) {
+        s_mask[i] = (lv_opa_t)rng();
+    }
+    for (int f = 0; f < FMT_COUNT; f++) {
+        check_stats_t st = {0};
+        for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w += 3) {
+            blend_case_t c = {
+                .fmt = (blend_fmt_t)f,
+                .w = WIDTHS[w],
+                .h = MAX_H,
+                .stride_pad = 1,
+                .opa = LV_OPA_50,
+                .blend_mode = LV_BLEND_MODE_NORMAL,
+            };
+            check_case(&c, &st);
+            c.opa = LV_OPA_COVER;
+            c.mask = s_mask;
+            check_case(&c, &st);
+            if (f == FMT_IMAGE_RGB565) {
+                c.mask = NULL;
+                c.blend_mode = LV_BLEND_MODE_ADDITIVE;
+                check_case(&c, &st);
+            }
+        }
+        CHECK(st.cases > 0 && st.mismatches == 0 && st.wrong_calls == 0);
+    }
+
+    // The one path left to LVGL that has a hook: XRGB8888 goes through the RGB888 fill hook's macro
+    blend_case_t c = {.fmt = FMT_XRGB8888, .w = 16, .h = 2, .opa = LV_OPA_COVER};
+    uint32_t calls = s_hook_calls;
+    run_blend(&c, s_dut_mem, s_src_mem);
+    CHECK(s_hook_calls == calls);
+}
+
+static int run_functionality(void)
+{
+    test_simple();
+    test_not_taken();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+typedef struct {
+    const char *name;
+    blend_fmt_t fmt;
+    int32_t w;
+    int32_t h;
+    uint32_t offset;
+} bench_case_t;
+
+static volatile uint32_t s_sink;
+
+static double bench_ns_per_px(const blend_case_t *c, uint8_t *dest, const uint8_t *src, bool hooks)
+{
+    s_hooks_on = hooks;
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t passes = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            run_blend(c, dest, src);
+            s_sink += dest[0];
+            passes++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS / 4);
+        double ns = (double)elapsed / (double)(passes * c->w * c->h);
+        best = r == 0 || ns < best ? ns : best;
+    }
+    s_hooks_on = true;
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    static const bench_case_t cases[] = {
+        {"128x128",  FMT_RGB565, 128, 128, 0},
+        {"127x127",  FMT_RGB565, 127, 127, 2},
+        {"720x128",  FMT_RGB565, 720, 128, 0},  // a tenth of the 720x1280 screen, the partial buffer
+        {"8x8",      FMT_RGB565, 8, 8, 2},
+        {"128x128",  FMT_RGB888, 128, 128, 0},
+        {"127x127",  FMT_RGB888, 127, 127, 1},
+        {"128x128",  FMT_ARGB8888, 128, 128, 0},
+        {"127x127",  FMT_ARGB8888, 127, 127, 4},
+        {"128x128",  FMT_IMAGE_RGB565, 128, 128, 0},
+        {"127x128",  FMT_IMAGE_RGB565, 127, 128, 2},
+        {"720x128",  FMT_IMAGE_RGB565, 720, 128, 0},
+    };
+    size_t bytes = 720 * 4 * 128 + 64;
+    uint8_t *dest = aligned_alloc(16, bytes);
+    uint8_t *src = aligned_alloc(16, bytes);
+    if (!dest || !src) {
+        printf("FAIL out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < bytes; i++) {
+        src[i] = (uint8_t)rng();
+    }
+
+    printf("LVGL %d.%d.%d, ns per pixel, best of %d\n", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR,
+           LVGL_VERSION_PATCH, BENCH_ROUNDS);
+    printf("%-14s %-8s %8s %8s %8s\n", "blend", "area", "hook", "LVGL", "speedup");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const bench_case_t *b = &cases[i];
+        blend_case_t c = {
+            .fmt = b->fmt, .w = b->w, .h = b->h, .dest_offset = b->offset, .src_offset = b->offset,
+            .opa = LV_OPA_COVER, .blend_mode = LV_BLEND_MODE_NORMAL,
+        };
+        double hook = bench_ns_per_px(&c, dest + b->offset, src + b->offset, true);
+        double lvgl = bench_ns_per_px(&c, dest + b->offset, src + b->offset, false);
+        printf("%-14s %-8s %8.3f %8.3f %7.2fx\n", FMT_NAMES[b->fmt], b->name, hook, lvgl, lvgl / hook);
+    }
+    free(dest);
+    free(src);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
@@ -0,0 +1,333 @@
+/*
+ * Host fuzz test and benchmark of the binary MAC helpers (mac48.c).
+ *
+ *   test_mac48          fuzz test: random strings over a hex/separator heavy alphabet and mutated valid
+ *                       addresses, embedded in text; mac48_parse(), mac48_find() and mac48_format() are
+ *                       compared with a byte-by-byte reference built on isxdigit()/strtoul(), and the
+ *                       inline compare helpers with memcmp()
+ *   test_mac48 bench    ns per parse against sscanf(), per equality check against strcmp() of the text
+ *                       form, and per find plus compare in a BT scan line against strstr()
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mac48.h"
+#include "test_common.h"
+
+#define FUZZ_INPUTS     1000000
+
+// The reference: 17 characters, hex pairs separated by ':' or '-', either case
+static bool ref_parse(const char *text, mac48_t *out)
+{
+    if (strlen(text) < 17) {
+        return false;
+    }
+    for (int i = 0; i < 17; i++) {
+        if (i % 3 == 2 ? text[i] != ':' && text[i] != '-' : !isxdigit((unsigned char)text[i])) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        char pair[3] = {text[i * 3], text[i * 3 + 1], '\0'};
+        out->b[i] = (uint8_t)strtoul(pair, NULL, 16);
+    }
+    return true;
+}
+
+static const char *ref_find(const char *text, mac48_t *out)
+{
+    for (const char *p = text; strlen(p) >= 17; p++) {
+        if (ref_parse(p, out)) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static char random_char(void)
+{
+    static const char alphabet[] = "0123456789abcdefABCDEF::::----gGxX zZ.,\t";
+    uint32_t r = rng() % 16;
+    if (r == 0) {
+        return (char)rng_range(1, 255);     // anything but NUL, high bytes included
+    }
+    return alphabet[rng() % (sizeof(alphabet) - 1)];
+}
+
+static void random_mac_text(char *out, const mac48_t *mac)
+{
+    for (int i = 0; i < 6; i++) {
+        snprintf(out + i * 3, 4, rng() % 2 ? "%02x%c" : "%02X%c", mac->b[i], rng() % 4 ? ':' : '-');
+    }
+    out[17] = '\0';
+}
+
+static mac48_t random_mac(void)
+{
+    mac48_t m;
+    for (int i = 0; i < 6; i++) {
+        m.b[i] = (uint8_t)rng();
+    }
+    return m;
+}
+
+// Random text, or text around a valid address that is then maybe damaged; half start at the address
+static size_t fuzz_input(char *buf, size_t size)
+{
+    size_t len = 0;
+    size_t prefix = rng() % 2 ? 0 : rng_range(1, 12);
+    for (size_t i = 0; i < prefix; i++) {
+        buf[len++] = random_char();
+    }
+    if (rng() % 4) {
+        mac48_t mac = random_mac();
+        random_mac_text(buf + len, &mac);
+        int mutations = (int)rng_range(0, 2);
+        for (int m = 0; m < mutations; m++) {
+            size_t at = len + rng_range(0, 16);
+            switch (rng() % 3) {
+                case 0: buf[at] = random_char(); break;
+                case 1: buf[at] = (char)(rng() % 2 ? ':' : '-'); break;
+                default: buf[at] = "0123456789abcdefABCDEF"[rng() % 22]; break;
+            }
+        }
+        len += rng() % 8 ? 17 : rng_range(0, 16);   // sometimes cut short
+    }
+    size_t suffix = rng_range(0, 12);
+    for (size_t i = 0; i < suffix && len + 1 < size; i++) {
+        buf[len++] = random_char();
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+static void test_fuzz(void)
+{
+    char buf[64];
+    uint64_t parsed = 0, found = 0;
+    bool parse_ok = true, find_ok = true, format_ok = true, compare_ok = true;
+    for (int n = 0; n < FUZZ_INPUTS; n++) {
+        fuzz_input(buf, sizeof(buf));
+
+        mac48_t want, got;
+        memset(&got, 0xA5, sizeof(got));
+        mac48_t untouched = got;
+        bool ref = ref_parse(buf, &want);
+        bool ok = mac48_parse(buf, &got);
+        parse_ok &= ok == ref;
+        // On failure the output is left alone
+        parse_ok &= ok ? memcmp(&got, &want, sizeof(got)) == 0 : memcmp(&got, &untouched, sizeof(got)) == 0;
+        parsed += ok;
+
+        const char *ref_at = ref_find(buf, &want);
+        const char *at = mac48_find(buf, &got);
+        find_ok &= at == ref_at;
+        if (at && at == ref_at) {
+            find_ok &= memcmp(&got, &want, sizeof(got)) == 0;
+            found++;
+        }
+
+        // Format is lower case with ':' and parses back to the same address
+        mac48_t mac = random_mac();
+        char text[MAC48_STR_SIZE], expect[MAC48_STR_SIZE];
+        snprintf(expect, sizeof(expect), MAC48_FMT, MAC48_ARGS(mac));
+        format_ok &= mac48_format(&mac, text) == text && strcmp(text, expect) == 0;
+        format_ok &= mac48_parse(text, &got) && mac48_equal(&got, &mac);
+
+        mac48_t other = mac;
+        if (rng() % 2) {
+            other.b[rng() % 6] ^= (uint8_t)(1u << (rng() % 8));
+        }
+        compare_ok &= mac48_equal(&mac, &other) == (memcmp(&mac, &other, sizeof(mac)) == 0);
+        uint64_t u = 0;
+        for (int i = 0; i < 6; i++) {
+            u = u << 8 | mac.b[i];
+        }
+        compare_ok &= mac48_to_u64(&mac) == u && mac48_is_zero(&mac) == (u == 0);
+    }
+    CHECK(parse_ok);
+    CHECK(find_ok);
+    CHECK(format_ok);
+    CHECK(compare_ok);
+    // The generator must actually reach both outcomes
+    CHECK(parsed > FUZZ_INPUTS / 10 && parsed < FUZZ_INPUTS * 9 / 10);
+    CHECK(found > parsed);
+}
+
+static void test_cases(void)
+{
+    mac48_t mac;
+    CHECK(mac48_parse("AA:bb:Cc:dD:00:ff", &mac));
+    char text[MAC48_STR_SIZE];
+    CHECK(strcmp(mac48_format(&mac, text), "aa:bb:cc:dd:00:ff") == 0);
+    CHECK(mac48_parse("01-23-45-67-89-ab trailing", &mac));
+    CHECK(mac.b[0] == 0x01 && mac.b[5] == 0xAB);
+    CHECK(mac48_parse("01:23-45:67-89:ab", &mac));
+    CHECK(!mac48_parse("01:23:45:67:89:a", &mac));
+    CHECK(!mac48_parse("01:23:45:67:89:ag", &mac));
+    CHECK(!mac48_parse("01.23.45.67.89.ab", &mac));
+    CHECK(!mac48_parse(" 01:23:45:67:89:ab", &mac));
+    CHECK(!mac48_parse("", &mac));
+    CHECK(!mac48_parse(NULL, &mac));
+    CHECK(!mac48_parse("01:23:45:67:89:ab", NULL));
+
+    const char *line = "  3. not:a:mac  c4:4f:33:0a:0b:0c  RSSI: -61 dBm  Name: Buds";
+    CHECK(mac48_find(line, &mac) == strstr(line, "c4:"));
+    CHECK(strcmp(mac48_format(&mac, text), "c4:4f:33:0a:0b:0c") == 0);
+    CHECK(mac48_find("a:b:c", &mac) == NULL);
+    CHECK(mac48_find("", &mac) == NULL);
+    CHECK(mac48_find(NULL, &mac) == NULL);
+    // An address at the very end of the text
+    CHECK(mac48_find("MAC: 3C:71:BF:12:34:56", &mac) != NULL && mac.b[0] == 0x3C && mac.b[5] == 0x56);
+
+    mac48_t zero = {{0}};
+    CHECK(mac48_is_zero(&zero));
+    CHECK(!mac48_is_zero(&mac));
+}
+
+static int run_functionality(void)
+{
+    test_cases();
+    test_fuzz();
+    return test_result();
+}
+
+#define BENCH_ITEMS     1024
+
+static volatile uint64_t s_sink;
+
+typedef struct {
+    char text[BENCH_ITEMS][MAC48_STR_SIZE];
+    char lines[BENCH_ITEMS][80];
+    mac48_t macs[BENCH_ITEMS];
+    mac48_t target;
+    char target_text[MAC48_STR_SIZE];
+} bench_data_t;
+
+typedef uint64_t (*bench_fn_t)(const bench_data_t *d);
+
+static uint64_t bench_parse(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    mac48_t mac;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += mac48_parse(d->text[i], &mac) ? mac.b[5] : 0;
+    }
+    return sum;
+}
+
+static uint64_t bench_sscanf(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    unsigned int b[6];
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += sscanf(d->text[i], "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) == 6 ? b[5] : 0;
+    }
+    return sum;
+}
+
+static uint64_t bench_equal(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += mac48_equal(&d->macs[i], &d->target);
+    }
+    return sum;
+}
+
+static uint64_t bench_strcmp(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += strcmp(d->text[i], d->target_text) == 0;
+    }
+    return sum;
+}
+
+static uint64_t bench_find(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    mac48_t mac;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += mac48_find(d->lines[i], &mac) && mac48_equal(&mac, &d->target);
+    }
+    return sum;
+}
+
+static uint64_t bench_strstr(const bench_data_t *d)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        sum += strstr(d->lines[i], d->target_text) != NULL;
+    }
+    return sum;
+}
+
+static double bench_ns_per_item(bench_fn_t fn, const bench_data_t *d)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t passes = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            s_sink += fn(d);
+            passes++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        double ns = (double)elapsed / (double)(passes * BENCH_ITEMS);
+        best = r == 0 || ns < best ? ns : best;
+    }
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    static bench_data_t d;
+    d.target = random_mac();
+    mac48_format(&d.target, d.target_text);
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        // One in eight is the target, the rest share its vendor prefix
+        d.macs[i] = d.target;
+        if (i % 8) {
+            d.macs[i].b[3 + i % 3] ^= (uint8_t)rng_range(1, 255);
+        }
+        mac48_format(&d.macs[i], d.text[i]);
+        snprintf(d.lines[i], sizeof(d.lines[i]), "  %d. %s  RSSI: -%u dBm  Name: %s", i + 1, d.text[i],
+                 (unsigned)rng_range(40, 95), i % 3 ? "Galaxy Buds" : "");
+    }
+
+    static const struct {
+        const char *name;
+        bench_fn_t fn;
+    } cases[] = {
+        {"mac48_parse", bench_parse},
+        {"sscanf", bench_sscanf},
+        {"mac48_equal", bench_equal},
+        {"strcmp", bench_strcmp},
+        {"mac48_find + equal", bench_find},
+        {"strstr", bench_strstr},
+    };
+    printf("%d addresses, best of %d\n", BENCH_ITEMS, BENCH_ROUNDS);
+    printf("%-20s %8s\n", "operation", "ns");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        printf("%-20s %8.1f\n", cases[c].name, bench_ns_per_item(cases[c].fn, &d));
+    }
+    if (bench_find(&d) != bench_strstr(&d) || bench_equal(&d) != bench_strcmp(&d)) {
+        printf("FAIL the binary and text forms disagree\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
@@ -0,0 +1,452 @@
+/*
+ * Host test of the network observer store (observer_store.c).
+ *
+ *   test_observer_store          functionality test: random network inserts, refreshes and renames over a
+ *                                small SSID vocabulary (so names repeat across channels) and random client
+ *                                sightings, checked against a plain model after every step: one BSSID and
+ *                                one SSID slot per network, lookups by BSSID, SSID and channel, per-network
+ *                                client lists in arrival order, full tables and the client pool limit
+ *   test_observer_store bench    memory per entry and ns per lookup or sighting with 1000 networks and
+ *                                10000 clients, against the linear strcmp scan the SSID lookup replaced
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "observer_store.h"
+#include "test_common.h"
+
+#define MAX_NETWORKS    200
+#define MAX_CLIENTS     2000
+#define SSID_WORDS      24
+
+static const char *const s_words[SSID_WORDS] = {
+    "HomeNet", "FRITZ!Box 7590", "eduroam", "", "Guest", "TP-Link_2G", "TP-Link_5G", "Office",
+    "iPhone", "AndroidAP", "Starbucks", "xfinitywifi", "NETGEAR42", "linksys", "UPC1234567", "Vodafone",
+    "Orange-ABCD", "dlink", "HUAWEI-5G", "Printer", "CCTV", "Lab", "a", "32-character-ssid-padded-to-max!",
+};
+
+static mac48_t random_mac(void)
+{
+    mac48_t m;
+    uint32_t hi = rng(), lo = rng();
+    memcpy(m.b, &hi, 4);
+    memcpy(m.b + 4, &lo, 2);
+    return m;
+}
+
+static observer_network_t random_network(const mac48_t *bssid)
+{
+    observer_network_t net = {0};
+    snprintf(net.ssid, sizeof(net.ssid), "%s", s_words[rng() % SSID_WORDS]);
+    net.bssid = *bssid;
+    static const uint8_t channels[] = {1, 6, 11, 36, 149};
+    net.channel = channels[rng() % sizeof(channels)];
+    snprintf(net.band, sizeof(net.band), "%s", net.channel > 14 ? "5GHz" : "2.4GHz");
+    net.rssi = (int8_t)-(int)rng_range(20, 95);
+    net.scan_index = (uint16_t)rng_range(1, 500);
+    // The store owns these, whatever the caller passes
+    net.client_count = rng();
+    net.first_client = rng();
+    net.last_client = rng();
+    return net;
+}
+
+typedef struct {
+    mac48_t mac;
+    int network;
+    uint32_t first_seen;
+    uint32_t last_seen;
+} model_client_t;
+
+typedef struct {
+    observer_network_t networks[MAX_NETWORKS];
+    int network_count;
+    model_client_t clients[MAX_CLIENTS];
+    uint32_t client_count;
+    uint32_t dropped;
+} model_t;
+
+static void check_store(const observer_store_t *store, const model_t *model)
+{
+    CHECK(store->network_count == model->network_count);
+    CHECK(store->client_count == model->client_count);
+    CHECK(store->dropped_clients == model->dropped);
+
+    // Every network sits in exactly one BSSID slot and exactly one SSID slot
+    static uint8_t bssid_refs[MAX_NETWORKS], ssid_refs[MAX_NETWORKS];
+    memset(bssid_refs, 0, sizeof(bssid_refs));
+    memset(ssid_refs, 0, sizeof(ssid_refs));
+    bool slots_ok = true;
+    for (uint32_t s = 0; s <= store->network_slot_mask; s++) {
+        uint16_t b = store->bssid_slots[s];
+        uint16_t n = store->ssid_slots[s];
+        slots_ok &= b <= model->network_count && n <= model->network_count;
+        if (b && b <= model->network_count) {
+            bssid_refs[b - 1]++;
+        }
+        if (n && n <= model->network_count) {
+            ssid_refs[n - 1]++;
+        }
+    }
+    for (int i = 0; i < model->network_count; i++) {
+        slots_ok &= bssid_refs[i] == 1 && ssid_refs[i] == 1;
+    }
+    CHECK(slots_ok);
+
+    bool networks_ok = true;
+    for (int i = 0; i < model->network_count; i++) {
+        const observer_network_t *want = &model->networks[i];
+        const observer_network_t *got = &store->networks[i];
+        networks_ok &= observer_store_find_bssid(store, &want->bssid) == i;
+        networks_ok &= strcmp(got->ssid, want->ssid) == 0 && got->channel == want->channel;
+        networks_ok &= got->rssi == want->rssi && got->scan_index == want->scan_index;
+
+        // By SSID and channel: this network or an earlier one with the same name and channel
+        int on_channel = observer_store_find_ssid(store, want->ssid, want->channel);
+        networks_ok &= on_channel >= 0 && on_channel < model->network_count;
+        if (on_channel >= 0 && on_channel < model->network_count) {
+            const observer_network_t *net = &model->networks[on_channel];
+            networks_ok &= strcmp(net->ssid, want->ssid) == 0 && net->channel == want->channel;
+        }
+        int any = observer_store_find_ssid(store, want->ssid, 0);
+        networks_ok &= any >= 0 && any < model->network_count && strcmp(model->networks[any].ssid, want->ssid) == 0;
+    }
+    CHECK(networks_ok);
+
+    // A channel nobody uses falls back to any network of that name
+    if (model->network_count > 0) {
+        const char *ssid = model->networks[0].ssid;
+        int r = observer_store_find_ssid(store, ssid, 200);
+        CHECK(r >= 0 && r < model->network_count && strcmp(model->networks[r].ssid, ssid) == 0);
+    }
+    CHECK(observer_store_find_ssid(store, "not-in-the-vocabulary", 0) == -1);
+    mac48_t unknown = {{0xFE, 0xED, 0, 0, 0, 1}};
+    CHECK(observer_store_find_bssid(store, &unknown) == -1);
+
+    // Clients: found by (network, MAC), linked per network in arrival order
+    bool clients_ok = true;
+    for (uint32_t c = 0; c < model->client_count; c++) {
+        const model_client_t *want = &model->clients[c];
+        uint32_t index = observer_store_find_client(store, want->network, &want->mac);
+        const observer_client_t *got = observer_store_client(store, index);
+        clients_ok &= index == c && got != NULL;
+        if (got) {
+            clients_ok &= got->first_seen == want->first_seen && got->last_seen == want->last_seen;
+        }
+    }
+    CHECK(clients_ok);
+
+    bool lists_ok = true;
+    for (int i = 0; i < model->network_count; i++) {
+        uint32_t expect = 0;
+        uint32_t client = store->networks[i].first_client;
+        for (uint32_t c = 0; c < model->client_count; c++) {
+            if (model->clients[c].network != i) {
+                continue;
+            }
+            lists_ok &= client == c;
+            if (client == c) {
+                client = store->clients[c].next;
+            }
+            expect++;
+        }
+        lists_ok &= client == OBSERVER_STORE_NONE;
+        lists_ok &= store->networks[i].client_count == expect;
+        lists_ok &= expect == 0 ? store->networks[i].last_client == OBSERVER_STORE_NONE
+                                : store->clients[store->networks[i].last_client].next == OBSERVER_STORE_NONE;
+    }
+    CHECK(lists_ok);
+}
+
+static void test_random_operations(void)
+{
+    observer_store_t store;
+    CHECK(observer_store_init(&store, MAX_NETWORKS, MAX_CLIENTS));
+    static model_t model;
+    memset(&model, 0, sizeof(model));
+
+    uint32_t now = 0;
+    for (int step = 0; step < 20000; step++) {
+        now += rng_range(0, 50);
+        uint32_t op = rng() % 100;
+        if (op < 25) {
+            // New network, or a full table
+            mac48_t bssid = random_mac();
+            observer_network_t net = random_network(&bssid);
+            int r = observer_store_put_network(&store, &net);
+            if (model.network_count < MAX_NETWORKS) {
+                CHECK(r == model.network_count);
+                model.networks[model.network_count++] = net;
+            } else {
+                CHECK(r == -1);
+            }
+        } else if (op < 50 && model.network_count > 0) {
+            // Seen again: refreshed, often renamed or on another channel
+            int i = (int)rng_range(0, (uint32_t)model.network_count - 1);
+            observer_network_t net = random_network(&model.networks[i].bssid);
+            if (rng() % 2) {
+                memcpy(net.ssid, model.networks[i].ssid, sizeof(net.ssid));
+            }
+            CHECK(observer_store_put_network(&store, &net) == i);
+            model.networks[i] = net;
+        } else if (op < 75 && model.network_count > 0) {
+            // New client; sometimes a MAC already seen on another network, which is a client of its own there
+            int network = (int)rng_range(0, (uint32_t)model.network_count - 1);
+            mac48_t mac = random_mac();
+            if (model.client_count > 0 && rng() % 4 == 0) {
+                mac = model.clients[rng_range(0, model.client_count - 1)].mac;
+            }
+            model_client_t *known = NULL;
+            for (uint32_t c = 0; c < model.client_count && !known; c++) {
+                if (model.clients[c].network == network && mac48_equal(&model.clients[c].mac, &mac)) {
+                    known = &model.clients[c];
+                }
+            }
+            bool added = observer_store_add_client(&store, network, &mac, now);
+            if (known) {
+                CHECK(!added);
+                known->last_seen = now;
+            } else if (model.client_count < MAX_CLIENTS) {
+                CHECK(added);
+                model.clients[model.client_count++] = (model_client_t){mac, network, now, now};
+            } else {
+                CHECK(!added);
+                model.dropped++;
+            }
+        } else if (op < 99 && model.client_count > 0) {
+            // Known client seen again
+            model_client_t *c = &model.clients[rng_range(0, model.client_count - 1)];
+            CHECK(!observer_store_add_client(&store, c->network, &c->mac, now));
+            c->last_seen = now;
+        } else if (op == 99 && rng() % 10 == 0) {
+            observer_store_clear(&store);
+            memset(&model, 0, sizeof(model));
+        }
+        if (step % 97 == 0 || model.network_count < 20) {
+            check_store(&store, &model);
+        }
+    }
+    check_store(&store, &model);
+
+    mac48_t mac = random_mac();
+    CHECK(!observer_store_add_client(&store, -1, &mac, 0));
+    CHECK(!observer_store_add_client(&store, model.network_count, &mac, 0));
+    CHECK(observer_store_find_client(&store, model.network_count, &mac) == OBSERVER_STORE_NONE);
+    CHECK(observer_store_client(&store, store.client_count) == NULL);
+    observer_store_free(&store);
+}
+
+// Renaming one network many times must not leave stale SSID slots behind
+static void test_renames(void)
+{
+    observer_store_t store;
+    CHECK(observer_store_init(&store, 8, 8));
+    static model_t model;
+    memset(&model, 0, sizeof(model));
+    for (int i = 0; i < 8; i++) {
+        mac48_t bssid = random_mac();
+        model.networks[i] = random_network(&bssid);
+        CHECK(observer_store_put_network(&store, &model.networks[i]) == i);
+    }
+    model.network_count = 8;
+    for (int round = 0; round < 5000; round++) {
+        int i = (int)rng_range(0, 7);
+        observer_network_t net = random_network(&model.networks[i].bssid);
+        CHECK(observer_store_put_network(&store, &net) == i);
+        model.networks[i] = net;
+        check_store(&store, &model);
+    }
+    observer_store_free(&store);
+}
+
+static void test_init(void)
+{
+    observer_store_t store;
+    CHECK(!observer_store_init(&store, 0, 10));
+    CHECK(!observer_store_init(&store, UINT16_MAX, 10));
+    CHECK(!observer_store_init(&store, 10, 0));
+    CHECK(!observer_store_init(NULL, 10, 10));
+    CHECK(observer_store_init(&store, 5, 3));
+    CHECK(store.network_slot_mask + 1 >= 10 && store.client_slot_mask + 1 >= 6);
+    mac48_t bssid = random_mac();
+    observer_network_t net = random_network(&bssid);
+    CHECK(observer_store_put_network(&store, &net) == 0);
+    observer_store_clear(&store);
+    CHECK(store.network_count == 0 && observer_store_find_bssid(&store, &bssid) == -1);
+    CHECK(observer_store_find_ssid(&store, net.ssid, 0) == -1);
+    observer_store_free(&store);
+    CHECK(store.networks == NULL);
+    CHECK(observer_store_put_network(&store, &net) == -1);
+    CHECK(observer_store_find_bssid(&store, &bssid) == -1);
+}
+
+static int run_functionality(void)
+{
+    test_init();
+    test_random_operations();
+    test_renames();
+    return test_result();
+}
+
+#define BENCH_NETWORKS  1000
+#define BENCH_CLIENTS   10000
+
+static volatile int64_t s_sink;
+
+typedef struct {
+    observer_store_t *store;
+    mac48_t *bssids;
+    mac48_t *client_macs;
+    int *client_networks;
+    char (*ssids)[33];
+    uint8_t *channels;
+} bench_data_t;
+
+typedef int64_t (*bench_fn_t)(bench_data_t *d);
+
+static int64_t bench_ssid_linear(bench_data_t *d)
+{
+    int64_t sum = 0;
+    for (int q = 0; q < BENCH_NETWORKS; q++) {
+        for (int i = 0; i < d->store->network_count; i++) {
+            const observer_network_t *net = &d->store->networks[i];
+            if (strcmp(net->ssid, d->ssids[q]) == 0 && net->channel == d->channels[q]) {
+                sum += i;
+                break;
+            }
+        }
+    }
+    return sum;
+}
+
+static int64_t bench_ssid_hash(bench_data_t *d)
+{
+    int64_t sum = 0;
+    for (int q = 0; q < BENCH_NETWORKS; q++) {
+        sum += observer_store_find_ssid(d->store, d->ssids[q], d->channels[q]);
+    }
+    return sum;
+}
+
+static int64_t bench_bssid(bench_data_t *d)
+{
+    int64_t sum = 0;
+    for (int q = 0; q < BENCH_NETWORKS; q++) {
+        sum += observer_store_find_bssid(d->store, &d->bssids[q]);
+    }
+    return sum;
+}
+
+static int64_t bench_new_clients(bench_data_t *d)
+{
+    observer_store_t *store = d->store;
+    // Drop the clients of the previous pass, keep the networks
+    memset(store->client_slots, 0, (store->client_slot_mask + 1) * sizeof(uint32_t));
+    store->client_count = 0;
+    for (int i = 0; i < store->network_count; i++) {
+        store->networks[i].client_count = 0;
+        store->networks[i].first_client = OBSERVER_STORE_NONE;
+        store->networks[i].last_client = OBSERVER_STORE_NONE;
+    }
+    int64_t sum = 0;
+    for (int c = 0; c < BENCH_CLIENTS; c++) {
+        sum += observer_store_add_client(store, d->client_networks[c], &d->client_macs[c], (uint32_t)c);
+    }
+    return sum;
+}
+
+static int64_t bench_repeat_clients(bench_data_t *d)
+{
+    int64_t sum = 0;
+    for (int c = 0; c < BENCH_CLIENTS; c++) {
+        sum += observer_store_add_client(d->store, d->client_networks[c], &d->client_macs[c], (uint32_t)c);
+    }
+    return sum;
+}
+
+// Best of BENCH_ROUNDS rounds of at least BENCH_MIN_NS; ns per operation
+static double bench_ns_per_op(bench_fn_t fn, bench_data_t *d, int ops)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t passes = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            s_sink += fn(d);
+            passes++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        double ns = (double)elapsed / (double)(passes * ops);
+        best = r == 0 || ns < best ? ns : best;
+    }
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    static observer_store_t store;
+    if (!observer_store_init(&store, BENCH_NETWORKS, BENCH_CLIENTS)) {
+        return EXIT_FAILURE;
+    }
+    bench_data_t d = {
+        .store = &store,
+        .bssids = calloc(BENCH_NETWORKS, sizeof(mac48_t)),
+        .client_macs = calloc(BENCH_CLIENTS, sizeof(mac48_t)),
+        .client_networks = calloc(BENCH_CLIENTS, sizeof(int)),
+        .ssids = calloc(BENCH_NETWORKS, 33),
+        .channels = calloc(BENCH_NETWORKS, 1),
+    };
+    for (int i = 0; i < BENCH_NETWORKS; i++) {
+        d.bssids[i] = random_mac();
+        observer_network_t net = random_network(&d.bssids[i]);
+        // Distinct names of a typical length, a few shared ones on different channels
+        snprintf(net.ssid, sizeof(net.ssid), "%s-%03d", s_words[i % SSID_WORDS], i % 900);
+        observer_store_put_network(&store, &net);
+    }
+    for (int q = 0; q < BENCH_NETWORKS; q++) {
+        const observer_network_t *net = &store.networks[rng_range(0, BENCH_NETWORKS - 1)];
+        memcpy(d.ssids[q], net->ssid, 33);
+        d.channels[q] = net->channel;
+    }
+    for (int c = 0; c < BENCH_CLIENTS; c++) {
+        d.client_macs[c] = random_mac();
+        d.client_networks[c] = (int)rng_range(0, BENCH_NETWORKS - 1);
+    }
+    if (bench_ssid_linear(&d) != bench_ssid_hash(&d)) {
+        printf("FAIL SSID lookups disagree\n");
+        return EXIT_FAILURE;
+    }
+
+    uint32_t network_slots = store.network_slot_mask + 1;
+    uint32_t client_slots = store.client_slot_mask + 1;
+    printf("%d networks, %d clients, best of %d\n", BENCH_NETWORKS, BENCH_CLIENTS, BENCH_ROUNDS);
+    printf("memory: %.1f B per network, %.1f B per client (entries and hash slots)\n",
+           sizeof(observer_network_t) + 2.0 * sizeof(uint16_t) * network_slots / BENCH_NETWORKS,
+           sizeof(observer_client_t) + (double)sizeof(uint32_t) * client_slots / BENCH_CLIENTS);
+    printf("%-26s %10s\n", "operation", "ns/op");
+    printf("%-26s %10.1f\n", "SSID lookup, linear scan", bench_ns_per_op(bench_ssid_linear, &d, BENCH_NETWORKS));
+    printf("%-26s %10.1f\n", "SSID lookup, hash", bench_ns_per_op(bench_ssid_hash, &d, BENCH_NETWORKS));
+    printf("%-26s %10.1f\n", "BSSID lookup", bench_ns_per_op(bench_bssid, &d, BENCH_NETWORKS));
+    printf("%-26s %10.1f\n", "new client", bench_ns_per_op(bench_new_clients, &d, BENCH_CLIENTS));
+    printf("%-26s %10.1f\n", "repeated sighting", bench_ns_per_op(bench_repeat_clients, &d, BENCH_CLIENTS));
+
+    observer_store_free(&store);
+    free(d.bssids);
+    free(d.client_macs);
+    free(d.client_networks);
+    free(d.ssids);
+    free(d.channels);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
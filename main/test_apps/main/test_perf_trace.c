@@ -0,0 +1,586 @@
+/*
+ * Host test and benchmark of the timeline profiler (perf_trace.c) on the pthread FreeRTOS shim.
+ *
+ * Exports go to a temporary directory and are read back event by event: the exporter writes one
+ * event per line, so a line parser is enough to check every field.
+ *
+ *   test_perf_trace          functionality test: nothing recorded before init; scopes, begin/end,
+ *                            recorded spans and markers with their task, core and JSON escaping; the
+ *                            ring's newest spans after it wraps; task names past the exporter's limit;
+ *                            four tasks recording while another exports; tools/perf_trace_diff.py on
+ *                            two exports, when python3 is there
+ *   test_perf_trace bench    ns per span from one and four tasks, against formatting a log line per
+ *                            span; ms to export a full ring
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "perf_trace.h"
+#include "test_common.h"
+
+#define WRITERS             4
+#define WRITER_SPANS        20000
+#define EXPORTS_WHILE_BUSY  200
+#define MAX_EVENTS          (PERF_TRACE_CAPACITY + 64)
+
+static char s_dir[64];
+
+static void make_path(char *path, size_t size, const char *file)
+{
+    snprintf(path, size, "%s/%s", s_dir, file);
+}
+
+// ---- reading an export back ----
+
+typedef struct {
+    char name[64];
+    char ph;
+    long long ts;
+    long long dur;
+    int tid;
+    unsigned core;
+    char thread[PERF_TRACE_TASK_NAME + 8];     // ph 'M': the task name
+} event_t;
+
+typedef struct {
+    event_t *events;            // spans and markers, in export order
+    int count;
+    char threads[64][PERF_TRACE_TASK_NAME + 8];  // by tid - 1
+    int thread_count;
+    char label[64];
+    char version[64];
+    unsigned long recorded;
+    unsigned long exported;
+    bool ok;                    // every line parsed, and the file is complete
+} trace_t;
+
+// A JSON string at *p, unescaped into out; *p moves past the closing quote
+static bool parse_string(const char **p, char *out, size_t size)
+{
+    const char *s = *p;
+    if (*s++ != '"') {
+        return false;
+    }
+    size_t n = 0;
+    while (*s && *s != '"') {
+        char c = *s++;
+        if (c == '\\') {
+            if (*s == 'u') {
+                unsigned code;
+                if (sscanf(s + 1, "%4x", &code) != 1) {
+                    return false;
+                }
+                c = (char)code;
+                s += 5;
+            } else {
+                c = *s++;
+            }
+        }
+        if (n + 1 < size) {
+            out[n++] = c;
+        }
+    }
+    out[n] = '\0';
+    if (*s != '"') {
+        return false;
+    }
+    *p = s + 1;
+    return true;
+}
+
+static bool parse_event(const char *line, event_t *ev)
+{
+    memset(ev, 0, sizeof(*ev));
+    const char *p = line + strlen("{\"name\":");
+    if (!parse_string(&p, ev->name, sizeof(ev->name))) {
+        return false;
+    }
+    int used = 0;
+    if (sscanf(p, ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"core\":%u}}%n", &ev->ts,
+               &ev->dur, &ev->tid, &ev->core, &used) == 4 && used > 0) {
+        ev->ph = 'X';
+    } else if (sscanf(p, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"core\":%u}}%n",
+                      &ev->ts, &ev->tid, &ev->core, &used) == 3 && used > 0) {
+        ev->ph = 'i';
+        ev->dur = -1;
+    } else if (sscanf(p, ",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":%n", &ev->tid, &used) == 1 &&
+               used > 0) {
+        ev->ph = 'M';
+        p += used;
+        return parse_string(&p, ev->thread, sizeof(ev->thread)) && strncmp(p, "}}", 2) == 0;
+    } else {
+        return false;
+    }
+    p += used;
+    return *p == '\0' || *p == ',' || *p == '\n';
+}
+
+static bool read_trace(const char *path, trace_t *t)
+{
+    static event_t events[MAX_EVENTS];
+    memset(t, 0, sizeof(*t));
+    t->events = events;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[512];
+    bool ok = fgets(line, sizeof(line), f) && strcmp(line, "{\"traceEvents\":[\n") == 0;
+    bool ended = false;
+    while (ok && fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "{\"name\":", 8) == 0) {
+            event_t ev;
+            ok = parse_event(line, &ev);
+            if (ok && ev.ph == 'M') {
+                ok = ev.tid == t->thread_count + 1 && strcmp(ev.name, "thread_name") == 0;
+                snprintf(t->threads[t->thread_count++], sizeof(t->threads[0]), "%s", ev.thread);
+            } else if (ok) {
+                ok = t->count < MAX_EVENTS && t->thread_count == 0;
+                if (ok) {
+                    t->events[t->count++] = ev;
+                }
+            }
+        } else if (strncmp(line, "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"label\":", 46) == 0) {
+            const char *p = line + 46;
+            ok = parse_string(&p, t->label, sizeof(t->label)) && strncmp(p, ",\"version\":", 11) == 0;
+            p += 11;
+            ok = ok && parse_string(&p, t->version, sizeof(t->version)) &&
+                 sscanf(p, ",\"recorded\":%lu,\"exported\":%lu}}", &t->recorded, &t->exported) == 2;
+            ended = true;
+        } else if (strcmp(line, "\n") != 0) {
+            ok = false;
+        }
+    }
+    fclose(f);
+    t->ok = ok && ended && t->exported == (unsigned long)t->count;
+    return t->ok;
+}
+
+static const char *thread_of(const trace_t *t, int tid)
+{
+    return tid >= 1 && tid <= t->thread_count ? t->threads[tid - 1] : NULL;
+}
+
+static const event_t *find_event(const trace_t *t, const char *name)
+{
+    for (int i = 0; i < t->count; i++) {
+        if (strcmp(t->events[i].name, name) == 0) {
+            return &t->events[i];
+        }
+    }
+    return NULL;
+}
+
+// ---- tasks ----
+
+typedef struct {
+    void (*fn)(void *arg);
+    void *arg;
+    SemaphoreHandle_t done;
+} task_job_t;
+
+static void job_task(void *arg)
+{
+    task_job_t *job = arg;
+    job->fn(job->arg);
+    xSemaphoreGive(job->done);
+    vTaskDelete(NULL);
+}
+
+// Run fn on a task of that name and core, and wait for it
+static void run_on_task(const char *name, BaseType_t core, void (*fn)(void *arg), void *arg)
+{
+    task_job_t job = {.fn = fn, .arg = arg, .done = xSemaphoreCreateBinary()};
+    xTaskCreatePinnedToCore(job_task, name, 4096, &job, 5, NULL, core);
+    xSemaphoreTake(job.done, portMAX_DELAY);
+    vSemaphoreDelete(job.done);
+}
+
+static void record_one(void *arg)
+{
+    perf_trace_record((const char *)arg, 7000, 7100);
+}
+
+// ---- functionality ----
+
+static const char s_odd_name[] = "q\"b\\s\n\x01";
+
+static void test_before_init(void)
+{
+    char path[128];
+    make_path(path, sizeof(path), "early.json");
+    perf_trace_record("early", 1, 2);
+    perf_trace_mark("early");
+    CHECK(perf_trace_count() == 0);
+    CHECK(!perf_trace_export_chrome(path, NULL, NULL) && access(path, F_OK) != 0);
+    CHECK(perf_trace_init());
+}
+
+static void test_kinds(void)
+{
+    int64_t before = esp_timer_get_time();
+    {
+        PERF_TRACE_SCOPE("scope");
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    perf_trace_scope_t pair = perf_trace_begin("pair");
+    vTaskDelay(pdMS_TO_TICKS(3));
+    perf_trace_end(&pair);
+    perf_trace_record("recorded", 1000, 4000);
+    perf_trace_record("backwards", 5000, 4000);
+    perf_trace_mark("interactive");
+    run_on_task("worker", 1, record_one, "on worker");
+    perf_trace_record(s_odd_name, 10, 20);
+    int64_t after = esp_timer_get_time();
+    CHECK(perf_trace_count() == 7);
+    CHECK(perf_trace_init());           // again: keeps the ring and what is in it
+
+    char path[128];
+    make_path(path, sizeof(path), "kinds.json");
+    CHECK(perf_trace_export_chrome(path, "boot \"7\"", NULL));
+    trace_t t;
+    CHECK(read_trace(path, &t));
+    CHECK(t.count == 7 && t.recorded == 7 && strcmp(t.label, "boot \"7\"") == 0 && t.version[0] == '\0');
+    if (t.count != 7) {
+        return;
+    }
+    const event_t *e = t.events;
+    CHECK(strcmp(e[0].name, "scope") == 0 && e[0].ph == 'X' && e[0].ts >= before && e[0].dur >= 5000 &&
+          e[0].dur < 5000 + 30000);
+    CHECK(strcmp(e[1].name, "pair") == 0 && e[1].ph == 'X' && e[1].ts >= e[0].ts + e[0].dur && e[1].dur >= 3000);
+    CHECK(strcmp(e[2].name, "recorded") == 0 && e[2].ts == 1000 && e[2].dur == 3000);
+    CHECK(strcmp(e[3].name, "backwards") == 0 && e[3].ts == 5000 && e[3].dur == 0);
+    CHECK(strcmp(e[4].name, "interactive") == 0 && e[4].ph == 'i' && e[4].ts >= e[1].ts && e[4].ts <= after);
+    CHECK(strcmp(e[5].name, "on worker") == 0 && e[5].core == 1 && e[5].ts == 7000 && e[5].dur == 100);
+    CHECK(strcmp(e[6].name, s_odd_name) == 0 && e[6].core == 0);
+
+    // One row per task, in order of first appearance
+    bool main_rows = true;
+    for (int i = 0; i < 7; i++) {
+        const char *thread = thread_of(&t, e[i].tid);
+        main_rows = main_rows && thread && strcmp(thread, i == 5 ? "worker" : "main") == 0;
+    }
+    CHECK(t.thread_count == 2 && main_rows && e[5].tid == 2);
+
+    // Quotes, backslashes and control characters are escaped in the file itself
+    FILE *f = fopen(path, "r");
+    char buf[4096] = "";
+    size_t n = f ? fread(buf, 1, sizeof(buf) - 1, f) : 0;
+    buf[n] = '\0';
+    if (f) {
+        fclose(f);
+    }
+    CHECK(strstr(buf, "{\"name\":\"q\\\"b\\\\s\\u000a\\u0001\",\"ph\":\"X\"") != NULL);
+    CHECK(strstr(buf, "\"label\":\"boot \\\"7\\\"\",\"version\":\"\"") != NULL);
+}
+
+// Once the ring wraps, the export holds exactly the newest PERF_TRACE_CAPACITY spans, in order
+static void test_wrap(void)
+{
+    uint32_t base = perf_trace_count();
+    const int total = 3 * PERF_TRACE_CAPACITY + 17;
+    for (int i = 0; i < total; i++) {
+        perf_trace_record("w", i, i + i % 7);
+    }
+    CHECK(perf_trace_count() == base + (uint32_t)total);
+
+    char path[128];
+    make_path(path, sizeof(path), "wrap.json");
+    CHECK(perf_trace_export_chrome(path, NULL, "v1.2.3"));
+    trace_t t;
+    CHECK(read_trace(path, &t));
+    CHECK(t.count == PERF_TRACE_CAPACITY && t.recorded == base + (unsigned long)total &&
+          strcmp(t.version, "v1.2.3") == 0);
+    bool newest = t.count == PERF_TRACE_CAPACITY;
+    for (int i = 0; i < t.count && newest; i++) {
+        long long want = total - PERF_TRACE_CAPACITY + i;
+        newest = strcmp(t.events[i].name, "w") == 0 && t.events[i].ts == want && t.events[i].dur == want % 7;
+    }
+    CHECK(newest);
+}
+
+// Task names are cut to PERF_TRACE_TASK_NAME - 1 characters; past 32 tasks, the rest share one row
+static void test_threads(void)
+{
+    run_on_task("averyverylongname", 0, record_one, "long");
+    static char names[40][8];
+    for (int i = 0; i < 40; i++) {
+        snprintf(names[i], sizeof(names[i]), "t%02d", i);
+        run_on_task(names[i], 0, record_one, names[i]);
+    }
+
+    char path[128];
+    make_path(path, sizeof(path), "threads.json");
+    CHECK(perf_trace_export_chrome(path, NULL, NULL));
+    trace_t t;
+    CHECK(read_trace(path, &t));
+    // Rows so far: main, then the long name, then t00 on
+    CHECK(t.thread_count == 32 && strcmp(t.threads[0], "main") == 0 && strcmp(t.threads[1], "averyverylo") == 0);
+    bool rows = true;
+    for (int i = 0; i < 40; i++) {
+        const event_t *e = find_event(&t, names[i]);
+        const char *thread = e ? thread_of(&t, e->tid) : NULL;
+        rows = rows && e && (i < 30 ? thread && strcmp(thread, names[i]) == 0 : e->tid == 33 && !thread);
+    }
+    CHECK(rows);
+}
+
+typedef struct {
+    int writer;
+    int64_t last;               // the writer's last seq, once done
+    SemaphoreHandle_t done;
+} writer_arg_t;
+
+static volatile bool s_stop_writers;
+
+// Record until told to stop, and at least WRITER_SPANS spans
+static void writer_task(void *arg)
+{
+    writer_arg_t *w = arg;
+    int64_t seq = 0;
+    for (; seq < WRITER_SPANS || !s_stop_writers; seq++) {
+        int64_t ts = ((int64_t)w->writer << 40) | seq;
+        perf_trace_record("concurrent", ts, ts + seq % 13);
+    }
+    w->last = seq - 1;
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+// Each export of the busy ring holds whole spans only: the right writer's task, in that writer's order
+static bool trace_consistent(const trace_t *t, const writer_arg_t *finished)
+{
+    bool ok = t->ok && t->count <= PERF_TRACE_CAPACITY;
+    long long last[WRITERS];
+    for (int w = 0; w < WRITERS; w++) {
+        last[w] = -1;
+    }
+    int concurrent = 0;
+    long long missing = 0;
+    for (int i = 0; i < t->count && ok; i++) {
+        const event_t *e = &t->events[i];
+        if (strcmp(e->name, "concurrent") != 0) {
+            continue;
+        }
+        concurrent++;
+        int w = (int)(e->ts >> 40);
+        long long seq = e->ts & ((1LL << 40) - 1);
+        char name[8];
+        snprintf(name, sizeof(name), "pw%d", w < WRITERS && w >= 0 ? w : 0);
+        const char *thread = thread_of(t, e->tid);
+        ok = w >= 0 && w < WRITERS && e->ph == 'X' && e->dur == seq % 13 && thread && strcmp(thread, name) == 0 &&
+             seq > last[w];
+        missing += last[w] < 0 ? 0 : seq - last[w] - 1;
+        last[w] = seq;
+    }
+    if (finished) {
+        // After the writers are done: each writer's newest spans up to its last, and a full ring but for
+        // the spans lost to a writer that stalled mid-write for a whole lap of the ring, at most one each
+        for (int w = 0; w < WRITERS; w++) {
+            missing += last[w] < 0 ? 0 : finished[w].last - last[w];
+        }
+        ok = ok && concurrent + missing == PERF_TRACE_CAPACITY && missing <= WRITERS;
+    }
+    return ok;
+}
+
+static void test_concurrent(void)
+{
+    static writer_arg_t args[WRITERS];
+    static char names[WRITERS][8];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(WRITERS, 0);
+    s_stop_writers = false;
+    for (int w = 0; w < WRITERS; w++) {
+        args[w] = (writer_arg_t){.writer = w, .done = done};
+        snprintf(names[w], sizeof(names[w]), "pw%d", w);
+        xTaskCreatePinnedToCore(writer_task, names[w], 4096, &args[w], 5, NULL, w % 2);
+    }
+    char path[128];
+    make_path(path, sizeof(path), "busy.json");
+    bool ok = true;
+    int exports = 0;
+    for (; exports < EXPORTS_WHILE_BUSY; exports++) {
+        trace_t t;
+        ok = ok && perf_trace_export_chrome(path, "busy", NULL) && read_trace(path, &t) && trace_consistent(&t, NULL);
+    }
+    s_stop_writers = true;
+    for (int w = 0; w < WRITERS; w++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+    CHECK(ok && exports == EXPORTS_WHILE_BUSY);
+
+    trace_t t;
+    CHECK(perf_trace_export_chrome(path, "busy", NULL) && read_trace(path, &t) && trace_consistent(&t, args));
+}
+
+static void test_export_errors(void)
+{
+    CHECK(!perf_trace_export_chrome("/nonexistent-dir/trace.json", NULL, NULL));
+}
+
+// tools/perf_trace_diff.py reads two exports and fails on the span that got slower
+static void test_diff_tool(void)
+{
+    if (system("python3 -c '' 2>/dev/null") != 0) {
+        printf("python3 not found, skipping tools/perf_trace_diff.py\n");
+        return;
+    }
+    char before[128];
+    char after[128];
+    char out[128];
+    char cmd[512];
+    make_path(before, sizeof(before), "diff_before.json");
+    make_path(after, sizeof(after), "diff_after.json");
+    make_path(out, sizeof(out), "diff.txt");
+    perf_trace_record("diff stage", 0, 20000);
+    perf_trace_record("steady", 0, 5000);
+    CHECK(perf_trace_export_chrome(before, "before", NULL));
+    // 20 ms -> 60 ms; the span it pushes out of the ring only gets "concurrent" faster
+    perf_trace_record("diff stage", 0, 40000);
+    CHECK(perf_trace_export_chrome(after, "after", NULL));
+
+    snprintf(cmd, sizeof(cmd), "python3 %s %s %s --fail-above 10 > %s 2>&1", PERF_TRACE_DIFF, before, before, out);
+    int same = system(cmd);
+    CHECK(WIFEXITED(same) && WEXITSTATUS(same) == 0);
+
+    snprintf(cmd, sizeof(cmd), "python3 %s %s %s --fail-above 10 > %s 2>&1", PERF_TRACE_DIFF, before, after, out);
+    int slower = system(cmd);
+    CHECK(WIFEXITED(slower) && WEXITSTATUS(slower) == 1);
+    FILE *f = fopen(out, "r");
+    char buf[8192] = "";
+    size_t n = f ? fread(buf, 1, sizeof(buf) - 1, f) : 0;
+    buf[n] = '\0';
+    if (f) {
+        fclose(f);
+    }
+    CHECK(strstr(buf, "Slower by more than 10%: diff stage\n") != NULL && strstr(buf, "+200%") != NULL);
+}
+
+static int run_functionality(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;      // the failing export is expected
+    test_before_init();
+    test_kinds();
+    test_wrap();
+    test_threads();
+    test_concurrent();
+    test_export_errors();
+    test_diff_tool();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+typedef struct {
+    int spans;
+    SemaphoreHandle_t done;
+} bench_arg_t;
+
+static void bench_writer(void *arg)
+{
+    bench_arg_t *b = arg;
+    for (int i = 0; i < b->spans; i++) {
+        perf_trace_record("bench", i, i + 1);
+    }
+    xSemaphoreGive(b->done);
+    vTaskDelete(NULL);
+}
+
+// What timing a step cost without the profiler: a log line per span
+static volatile size_t s_sink;
+
+static void log_line(int i)
+{
+    char line[96];
+    s_sink += (size_t)snprintf(line, sizeof(line), "I (%lu) main: %s took %lld us", (unsigned long)i, "bench",
+                               (long long)(esp_timer_get_time() - i));
+}
+
+static int run_benchmark(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    perf_trace_init();
+    const int spans = 200000;
+    double best[4] = {0};
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        double ns[4];
+
+        int64_t start = now_ns();
+        for (int i = 0; i < spans; i++) {
+            log_line(i);
+        }
+        ns[0] = (double)(now_ns() - start) / spans;
+
+        start = now_ns();
+        for (int i = 0; i < spans; i++) {
+            PERF_TRACE_SCOPE("bench");
+        }
+        ns[1] = (double)(now_ns() - start) / spans;
+
+        start = now_ns();
+        for (int i = 0; i < spans; i++) {
+            perf_trace_record("bench", i, i + 1);
+        }
+        ns[2] = (double)(now_ns() - start) / spans;
+
+        // Four tasks on two cores at once: per span, over the whole run
+        bench_arg_t arg = {.spans = spans / WRITERS, .done = xSemaphoreCreateCounting(WRITERS, 0)};
+        start = now_ns();
+        for (int w = 0; w < WRITERS; w++) {
+            xTaskCreatePinnedToCore(bench_writer, "bench", 4096, &arg, 5, NULL, w % 2);
+        }
+        for (int w = 0; w < WRITERS; w++) {
+            xSemaphoreTake(arg.done, portMAX_DELAY);
+        }
+        ns[3] = (double)(now_ns() - start) / spans;
+        vSemaphoreDelete(arg.done);
+
+        for (int k = 0; k < 4; k++) {
+            best[k] = r == 0 || ns[k] < best[k] ? ns[k] : best[k];
+        }
+    }
+    printf("ns per span, best of %d rounds of %d\n", BENCH_ROUNDS, spans);
+    printf("  %-28s %7.1f\n", "log line (snprintf only)", best[0]);
+    printf("  %-28s %7.1f\n", "PERF_TRACE_SCOPE", best[1]);
+    printf("  %-28s %7.1f\n", "perf_trace_record", best[2]);
+    printf("  %-28s %7.1f\n", "perf_trace_record, 4 tasks", best[3]);
+
+    char path[128];
+    make_path(path, sizeof(path), "bench.json");
+    double export_ms = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t start = now_ns();
+        perf_trace_export_chrome(path, "bench", "bench");
+        double ms = (double)(now_ns() - start) / 1e6;
+        export_ms = r == 0 || ms < export_ms ? ms : export_ms;
+    }
+    printf("export of %d spans: %.2f ms\n", PERF_TRACE_CAPACITY, export_ms);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    snprintf(s_dir, sizeof(s_dir), "/tmp/test_perf_trace.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    int result = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "could not remove %s\n", s_dir);
+    }
+    return result;
+}
@@ -0,0 +1,548 @@
+/*
+ * Host test of the portals.txt sidecar index (portal_index.c) on a temporary directory.
+ *
+ *   test_portal_index          functionality test: random appends read back and searched by SSID against a
+ *                              plain model; reopening, and a rebuilt sidecar that is byte-identical to the
+ *                              appended one; records appended by another writer, multi-line data and
+ *                              incomplete trailing records; foreign, stale and outrun sidecars; long SSIDs
+ *                              and records; clear
+ *   test_portal_index bench    50000 records: initial build, reopen, random read, a 20-row page, find_ssid
+ *                              with 100 hits, against a linear fgets scan of the file
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "portal_index.h"
+#include "test_common.h"
+
+static char s_dir[64];
+
+static void make_path(char *out, size_t size, const char *name)
+{
+    snprintf(out, size, "%s/%s", s_dir, name);
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        *len = 0;
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    *len = fread(data, 1, (size_t)size, f);
+    data[*len] = '\0';
+    fclose(f);
+    return data;
+}
+
+static void write_file(const char *path, const char *mode, const void *data, size_t len)
+{
+    FILE *f = fopen(path, mode);
+    if (f) {
+        fwrite(data, 1, len, f);
+        fclose(f);
+    }
+}
+
+static off_t file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+// What a record should read back as
+typedef struct {
+    char ssid[33];
+    char data[PORTAL_INDEX_DATA_MAX];
+} model_record_t;
+
+#define MODEL_MAX   4096
+
+typedef struct {
+    model_record_t records[MODEL_MAX];
+    uint32_t count;
+} model_t;
+
+static void model_add(model_t *model, const char *ssid, const char *data)
+{
+    if (model->count < MODEL_MAX) {
+        model_record_t *rec = &model->records[model->count++];
+        snprintf(rec->ssid, sizeof(rec->ssid), "%.32s", ssid);
+        snprintf(rec->data, sizeof(rec->data), "%s", data);
+    }
+}
+
+static bool record_matches(portal_index_t *index, const model_t *model, uint32_t record)
+{
+    static portal_index_record_t rec;
+    return portal_index_read(index, record, &rec) && strcmp(rec.ssid, model->records[record].ssid) == 0 &&
+           strcmp(rec.data, model->records[record].data) == 0;
+}
+
+static void check_all_records(portal_index_t *index, const model_t *model)
+{
+    CHECK(portal_index_count(index) == model->count);
+    uint32_t wrong = 0;
+    // Backwards too, so the cached entry run is refilled in both directions
+    for (uint32_t i = 0; i < model->count; i++) {
+        wrong += !record_matches(index, model, i);
+        wrong += !record_matches(index, model, model->count - 1 - i);
+    }
+    CHECK(wrong == 0);
+    static portal_index_record_t rec;
+    CHECK(!portal_index_read(index, model->count, &rec));
+}
+
+// find_ssid must list the records with that SSID newest first, up to max
+static void check_find(portal_index_t *index, const model_t *model, const char *ssid, uint32_t max)
+{
+    static uint32_t want[MODEL_MAX], got[MODEL_MAX];
+    uint32_t want_count = 0;
+    for (uint32_t i = model->count; i-- > 0 && want_count < max;) {
+        if (strncmp(model->records[i].ssid, ssid, 32) == 0) {
+            want[want_count++] = i;
+        }
+    }
+    uint32_t got_count = portal_index_find_ssid(index, ssid, got, max);
+    CHECK(got_count == want_count && memcmp(got, want, got_count * sizeof(uint32_t)) == 0);
+}
+
+#define SSID_WORDS  48
+
+static char s_ssids[SSID_WORDS][48];
+
+static void init_ssids(void)
+{
+    static const char *words[] = {"Cafe", "Free WiFi", "Airport", "Hotel Guest", "eduroam", "FRITZ!Box 7590"};
+    for (int i = 0; i < SSID_WORDS; i++) {
+        if (i == 0) {
+            s_ssids[i][0] = '\0';
+        } else if (i % 11 == 0) {
+            // Longer than an SSID: only the first 32 characters are kept and compared
+            snprintf(s_ssids[i], sizeof(s_ssids[i]), "%s %d with a name that goes on and on", words[i % 6], i);
+        } else {
+            snprintf(s_ssids[i], sizeof(s_ssids[i]), "%s %d", words[i % 6], i);
+        }
+    }
+}
+
+static void random_data(char *out, size_t size)
+{
+    size_t len = rng() % 16 ? rng_range(0, 120) : rng_range(size / 2, size - 1);
+    for (size_t i = 0; i < len; i++) {
+        out[i] = "abcdefghijklmnopqrstuvwxyz0123456789=&%+- "[rng() % 42];
+    }
+    out[len] = '\0';
+}
+
+static void test_append_read_find(void)
+{
+    static model_t model;
+    static portal_index_t index;
+    char path[96], idx_path[104];
+    make_path(path, sizeof(path), "append.txt");
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+
+    CHECK(portal_index_open(&index, path));
+    CHECK(portal_index_is_open(&index));
+    CHECK(portal_index_count(&index) == 0);
+
+    for (int i = 0; i < 3000; i++) {
+        char data[PORTAL_INDEX_DATA_MAX];
+        random_data(data, sizeof(data));
+        const char *ssid = s_ssids[rng() % SSID_WORDS];
+        CHECK(portal_index_append(&index, ssid, data));
+        model_add(&model, ssid, data);
+        if (i % 500 == 499) {
+            CHECK(portal_index_flush(&index));
+        }
+    }
+    check_all_records(&index, &model);
+    for (int i = 0; i < SSID_WORDS; i++) {
+        check_find(&index, &model, s_ssids[i], MODEL_MAX);
+        check_find(&index, &model, s_ssids[i], 3);
+    }
+    check_find(&index, &model, "Not in the file", MODEL_MAX);
+    portal_index_close(&index);
+    CHECK(!portal_index_is_open(&index));
+
+    // Reopening reads the header, nothing is indexed again
+    CHECK(portal_index_open(&index, path));
+    CHECK(portal_index_sync(&index) == 0);
+    check_all_records(&index, &model);
+    check_find(&index, &model, s_ssids[5], MODEL_MAX);
+    portal_index_close(&index);
+
+    // Without its sidecar the file is indexed from scratch, to the same bytes
+    size_t appended_len, rebuilt_len;
+    char *appended = read_file(idx_path, &appended_len);
+    unlink(idx_path);
+    CHECK(portal_index_open(&index, path));
+    check_all_records(&index, &model);
+    portal_index_close(&index);
+    char *rebuilt = read_file(idx_path, &rebuilt_len);
+    CHECK(appended && rebuilt && appended_len == rebuilt_len && memcmp(appended, rebuilt, appended_len) == 0);
+    CHECK(appended_len == PORTAL_INDEX_HEADER_SIZE + model.count * sizeof(portal_index_entry_t));
+    free(appended);
+    free(rebuilt);
+}
+
+static void external_record(const char *path, model_t *model, const char *ssid, const char *data)
+{
+    char text[1024];
+    int len = snprintf(text, sizeof(text), "SSID: %s\nData: %s\n---\n", ssid, data);
+    write_file(path, "ab", text, (size_t)len);
+    model_add(model, ssid, data);
+}
+
+static void test_external_writer(void)
+{
+    static model_t model;
+    static portal_index_t index;
+    char path[96];
+    make_path(path, sizeof(path), "external.txt");
+
+    CHECK(portal_index_open(&index, path));
+    for (int i = 0; i < 5; i++) {
+        CHECK(portal_index_append(&index, s_ssids[i + 1], "email=a&password=b"));
+        model_add(&model, s_ssids[i + 1], "email=a&password=b");
+    }
+    CHECK(portal_index_flush(&index));
+    CHECK(portal_index_sync(&index) == 0);
+
+    // Multi-line data; lines that only look like the terminator do not end a record
+    external_record(path, &model, "Cafe", "line one\nline two");
+    external_record(path, &model, "Cafe", "a=1\n----\n --- \n--");
+    external_record(path, &model, "Hotel", "");
+    const char *partial = "SSID: Airport\nData: user=x\n";
+    write_file(path, "ab", partial, strlen(partial));
+    CHECK(portal_index_sync(&index) == 3);
+    check_all_records(&index, &model);
+
+    // The incomplete record is picked up once its "---" line arrives
+    write_file(path, "ab", "pass=y\n---\n", strlen("pass=y\n---\n"));
+    model_add(&model, "Airport", "user=x\npass=y");
+    CHECK(portal_index_sync(&index) == 1);
+    CHECK(portal_index_sync(&index) == 0);
+    check_all_records(&index, &model);
+    check_find(&index, &model, "Cafe", MODEL_MAX);
+
+    // An append after an incomplete record from someone else goes behind it without touching it
+    write_file(path, "ab", partial, strlen(partial));
+    off_t before = file_size(path);
+    CHECK(portal_index_append(&index, "Own", "form=1"));
+    model_add(&model, "Own", "form=1");
+    check_all_records(&index, &model);
+    size_t len;
+    char *data = read_file(path, &len);
+    CHECK(data && (off_t)len > before && memcmp(data + before - strlen(partial), partial, strlen(partial)) == 0);
+    free(data);
+    CHECK(portal_index_sync(&index) == 0);
+    portal_index_close(&index);
+}
+
+static void test_stale_sidecar(void)
+{
+    static model_t model;
+    static portal_index_t index;
+    char path[96], idx_path[104];
+    make_path(path, sizeof(path), "stale.txt");
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+
+    // A sidecar that is not ours is replaced
+    for (int i = 0; i < 200; i++) {
+        external_record(path, &model, s_ssids[i % SSID_WORDS], "x=1");
+    }
+    char junk[PORTAL_INDEX_HEADER_SIZE + 64];
+    for (size_t i = 0; i < sizeof(junk); i++) {
+        junk[i] = (char)rng();
+    }
+    write_file(idx_path, "wb", junk, sizeof(junk));
+    CHECK(portal_index_open(&index, path));
+    check_all_records(&index, &model);
+    portal_index_close(&index);
+
+    // A sidecar from before more appends only indexes what it is missing
+    size_t old_len;
+    char *old = read_file(idx_path, &old_len);
+    CHECK(portal_index_open(&index, path));
+    for (int i = 0; i < 100; i++) {
+        CHECK(portal_index_append(&index, s_ssids[i % SSID_WORDS], "y=2"));
+        model_add(&model, s_ssids[i % SSID_WORDS], "y=2");
+    }
+    portal_index_close(&index);
+    write_file(idx_path, "wb", old, old_len);
+    free(old);
+    CHECK(portal_index_open(&index, path));
+    check_all_records(&index, &model);
+    for (int i = 0; i < SSID_WORDS; i++) {
+        check_find(&index, &model, s_ssids[i], MODEL_MAX);
+    }
+
+    // The data file was replaced by a shorter one under the open index
+    model.count = 0;
+    write_file(path, "wb", "", 0);
+    external_record(path, &model, "New", "a=1");
+    external_record(path, &model, "New", "b=2");
+    CHECK(portal_index_sync(&index) == 2);
+    check_all_records(&index, &model);
+    check_find(&index, &model, "New", MODEL_MAX);
+    check_find(&index, &model, s_ssids[1], MODEL_MAX);
+    portal_index_close(&index);
+}
+
+static void test_long_records(void)
+{
+    static portal_index_t index;
+    static portal_index_record_t rec;
+    char path[96], idx_path[104];
+    make_path(path, sizeof(path), "long.txt");
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+    CHECK(portal_index_open(&index, path));
+
+    const char *ssid = "An SSID longer than thirty-two characters";
+    char data[3000];
+    memset(data, 'd', sizeof(data) - 1);
+    data[sizeof(data) - 1] = '\0';
+    CHECK(portal_index_append(&index, ssid, data));
+    // Exactly what a record returns
+    data[PORTAL_INDEX_DATA_MAX - 1] = '\0';
+    CHECK(portal_index_append(&index, "Short", data));
+    CHECK(portal_index_append(&index, "After", "z"));
+
+    CHECK(portal_index_read(&index, 0, &rec));
+    CHECK(strlen(rec.ssid) == 32 && strncmp(rec.ssid, ssid, 32) == 0);
+    CHECK(strcmp(rec.data, data) == 0);
+    CHECK(portal_index_read(&index, 1, &rec));
+    CHECK(strcmp(rec.ssid, "Short") == 0 && strcmp(rec.data, data) == 0);
+    uint32_t found[4];
+    CHECK(portal_index_find_ssid(&index, ssid, found, 4) == 1 && found[0] == 0);
+    portal_index_close(&index);
+
+    // The truncated record kept its terminator, so a rebuild splits the file the same way
+    unlink(idx_path);
+    CHECK(portal_index_open(&index, path));
+    CHECK(portal_index_count(&index) == 3);
+    CHECK(portal_index_read(&index, 2, &rec) && strcmp(rec.ssid, "After") == 0 && strcmp(rec.data, "z") == 0);
+    portal_index_close(&index);
+}
+
+static void test_clear(void)
+{
+    static portal_index_t index;
+    static portal_index_record_t rec;
+    char path[96], idx_path[104];
+    make_path(path, sizeof(path), "clear.txt");
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+    CHECK(portal_index_open(&index, path));
+    for (int i = 0; i < 100; i++) {
+        CHECK(portal_index_append(&index, "Cafe", "q=1"));
+    }
+    CHECK(portal_index_clear(&index));
+    CHECK(portal_index_count(&index) == 0);
+    CHECK(file_size(path) == 0 && file_size(idx_path) == PORTAL_INDEX_HEADER_SIZE);
+    uint32_t found[4];
+    CHECK(portal_index_find_ssid(&index, "Cafe", found, 4) == 0);
+    CHECK(portal_index_append(&index, "Cafe", "q=2"));
+    portal_index_close(&index);
+
+    CHECK(portal_index_open(&index, path));
+    CHECK(portal_index_count(&index) == 1);
+    CHECK(portal_index_read(&index, 0, &rec) && strcmp(rec.data, "q=2") == 0);
+    portal_index_close(&index);
+
+    // Closed or missing indexes refuse every call
+    CHECK(!portal_index_open(NULL, path));
+    CHECK(!portal_index_open(&index, NULL));
+    CHECK(!portal_index_is_open(&index));
+    CHECK(portal_index_count(&index) == 0);
+    CHECK(!portal_index_append(&index, "Cafe", "q=3"));
+    CHECK(!portal_index_read(&index, 0, &rec));
+    CHECK(portal_index_sync(&index) == 0);
+}
+
+static int run_functionality(void)
+{
+    init_ssids();
+    test_append_read_find();
+    test_external_writer();
+    test_stale_sidecar();
+    test_long_records();
+    test_clear();
+    return test_result();
+}
+
+#define BENCH_RECORDS   50000
+#define BENCH_SSIDS     500         // so each SSID has 100 records
+#define BENCH_PAGE      20
+
+static volatile int64_t s_sink;
+
+typedef struct {
+    portal_index_t index;
+    char path[96];
+    char idx_path[104];
+    uint32_t hits[BENCH_RECORDS / BENCH_SSIDS];
+} bench_data_t;
+
+typedef int64_t (*bench_fn_t)(bench_data_t *d);
+
+static void bench_ssid(char *out, size_t size, uint32_t i)
+{
+    snprintf(out, size, "Free WiFi %03u", (unsigned)(i % BENCH_SSIDS));
+}
+
+static int64_t bench_build(bench_data_t *d)
+{
+    unlink(d->idx_path);
+    portal_index_open(&d->index, d->path);
+    int64_t count = portal_index_count(&d->index);
+    portal_index_close(&d->index);
+    return count;
+}
+
+static int64_t bench_reopen(bench_data_t *d)
+{
+    portal_index_open(&d->index, d->path);
+    int64_t count = portal_index_count(&d->index);
+    portal_index_close(&d->index);
+    return count;
+}
+
+static int64_t bench_read(bench_data_t *d)
+{
+    static portal_index_record_t rec;
+    portal_index_read(&d->index, rng() % BENCH_RECORDS, &rec);
+    return rec.data[0];
+}
+
+static int64_t bench_page(bench_data_t *d)
+{
+    static portal_index_record_t rec;
+    uint32_t first = rng() % (BENCH_RECORDS / BENCH_PAGE) * BENCH_PAGE;
+    int64_t sum = 0;
+    for (uint32_t i = first; i < first + BENCH_PAGE; i++) {
+        portal_index_read(&d->index, i, &rec);
+        sum += rec.data[0];
+    }
+    return sum;
+}
+
+static int64_t bench_find(bench_data_t *d)
+{
+    char ssid[33];
+    bench_ssid(ssid, sizeof(ssid), rng());
+    return portal_index_find_ssid(&d->index, ssid, d->hits, BENCH_RECORDS / BENCH_SSIDS);
+}
+
+// Every record whose SSID line matches, reading the file line by line
+static int64_t bench_scan(bench_data_t *d)
+{
+    char want[48], line[640];
+    bench_ssid(want, sizeof(want), rng());
+    size_t want_len = strlen(want);
+    FILE *f = fopen(d->path, "r");
+    if (!f) {
+        return 0;
+    }
+    int64_t found = 0;
+    uint32_t record = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strcmp(line, "---\n") == 0) {
+            record++;
+        } else if (strncmp(line, "SSID: ", 6) == 0 && strncmp(line + 6, want, want_len) == 0 &&
+                   line[6 + want_len] == '\n') {
+            d->hits[found++ % (BENCH_RECORDS / BENCH_SSIDS)] = record;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+// Best of BENCH_ROUNDS rounds of at least BENCH_MIN_NS; us per call
+static double bench_us_per_call(bench_fn_t fn, bench_data_t *d)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t calls = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            s_sink += fn(d);
+            calls++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        double us = (double)elapsed / 1e3 / (double)calls;
+        best = r == 0 || us < best ? us : best;
+    }
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    static bench_data_t d;
+    make_path(d.path, sizeof(d.path), "bench.txt");
+    snprintf(d.idx_path, sizeof(d.idx_path), "%s.idx", d.path);
+    FILE *f = fopen(d.path, "w");
+    if (!f) {
+        perror(d.path);
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        char ssid[33];
+        bench_ssid(ssid, sizeof(ssid), i);
+        fprintf(f, "SSID: %s\nData: email=user%u%%40example.com&password=%08x\n---\n", ssid, (unsigned)i,
+                (unsigned)rng());
+    }
+    fclose(f);
+
+    if (bench_build(&d) != BENCH_RECORDS || !portal_index_open(&d.index, d.path)) {
+        printf("FAIL cannot index %s\n", d.path);
+        return EXIT_FAILURE;
+    }
+    uint32_t state = rng_state;
+    int64_t found = bench_find(&d);
+    rng_state = state;
+    if (found != BENCH_RECORDS / BENCH_SSIDS || bench_scan(&d) != found) {
+        printf("FAIL find_ssid and the scan disagree\n");
+        return EXIT_FAILURE;
+    }
+    portal_index_close(&d.index);
+
+    printf("%d records, %ld bytes, best of %d\n", BENCH_RECORDS, (long)file_size(d.path), BENCH_ROUNDS);
+    printf("%-30s %10s\n", "operation", "us");
+    printf("%-30s %10.1f\n", "initial build", bench_us_per_call(bench_build, &d));
+    printf("%-30s %10.1f\n", "reopen", bench_us_per_call(bench_reopen, &d));
+    portal_index_open(&d.index, d.path);
+    printf("%-30s %10.2f\n", "random record", bench_us_per_call(bench_read, &d));
+    printf("%-30s %10.1f\n", "20-row page", bench_us_per_call(bench_page, &d));
+    printf("%-30s %10.1f\n", "find_ssid, 100 hits", bench_us_per_call(bench_find, &d));
+    printf("%-30s %10.1f\n", "linear scan, 100 hits", bench_us_per_call(bench_scan, &d));
+    portal_index_close(&d.index);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    snprintf(s_dir, sizeof(s_dir), "/tmp/test_portal_index.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    if (system(cmd) != 0) {
+        printf("could not remove %s\n", s_dir);
+    }
+    return rc;
+}
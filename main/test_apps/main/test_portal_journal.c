@@ -0,0 +1,438 @@
+/*
+ * Host test of the batched portal journal (portal_journal.c) on a temporary directory. open/write/fsync/close
+ * are wrapped at link time to count the journal's file calls and, for the benchmark, to add SD card latencies.
+ *
+ *   test_portal_journal          functionality test: bursts of submissions end up in the file byte for byte;
+ *                                the commit callback only reports synced entries and finds them in the file;
+ *                                writes go to block-aligned offsets after an unaligned existing tail; the
+ *                                record format keeps its terminator when the form is too long; a full ring
+ *                                drops or waits; open errors lose the batch without a commit; idle close
+ *   test_portal_journal bench    records/s and file calls for 500 submissions against per-record
+ *                                open/append/close, on a simulated SD card (0.8 ms per write plus 10 MB/s,
+ *                                1.5 ms more when unaligned to 512 bytes, 4 ms fsync or close, 2 ms open)
+ */
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "portal_journal.h"
+#include "test_common.h"
+
+typedef struct {
+    atomic_uint opens;
+    atomic_uint writes;
+    atomic_uint unaligned_writes;   // offset not a multiple of the journal block
+    atomic_uint fsyncs;
+    atomic_uint closes;
+    atomic_uint writes_since_fsync;
+} io_counters_t;
+
+static io_counters_t s_io;
+static bool s_sd_model;
+
+static void sd_delay_us(long us)
+{
+    if (s_sd_model) {
+        struct timespec t = {us / 1000000, (us % 1000000) * 1000};
+        nanosleep(&t, NULL);
+    }
+}
+
+int __real_open(const char *path, int flags, ...);
+ssize_t __real_write(int fd, const void *buf, size_t len);
+int __real_fsync(int fd);
+int __real_close(int fd);
+
+int __wrap_open(const char *path, int flags, ...)
+{
+    mode_t mode = 0;
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = (mode_t)va_arg(args, int);
+        va_end(args);
+    }
+    atomic_fetch_add(&s_io.opens, 1);
+    sd_delay_us(2000);
+    return __real_open(path, flags, mode);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t len)
+{
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    atomic_fetch_add(&s_io.writes, 1);
+    atomic_fetch_add(&s_io.writes_since_fsync, 1);
+    if (offset % PORTAL_JOURNAL_BLOCK_SIZE != 0) {
+        atomic_fetch_add(&s_io.unaligned_writes, 1);
+    }
+    bool sector_aligned = offset % 512 == 0 && len % 512 == 0;
+    sd_delay_us(800 + (long)len / 10 + (sector_aligned ? 0 : 1500));
+    return __real_write(fd, buf, len);
+}
+
+int __wrap_fsync(int fd)
+{
+    atomic_fetch_add(&s_io.fsyncs, 1);
+    atomic_store(&s_io.writes_since_fsync, 0);
+    sd_delay_us(4000);
+    return __real_fsync(fd);
+}
+
+int __wrap_close(int fd)
+{
+    atomic_fetch_add(&s_io.closes, 1);
+    sd_delay_us(4000);
+    return __real_close(fd);
+}
+
+static char s_dir[64];
+
+static void make_path(char *out, size_t size, const char *name)
+{
+    snprintf(out, size, "%s/%s", s_dir, name);
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        *len = 0;
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    *len = fread(data, 1, (size_t)size, f);
+    data[*len] = '\0';
+    fclose(f);
+    return data;
+}
+
+static off_t file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+// What the commit callback saw, written on the journal task
+typedef struct {
+    char path[96];
+    atomic_uint calls;
+    atomic_uint committed;
+    atomic_bool unsynced_report;    // reported while a write was not synced yet
+    atomic_bool missing_in_file;    // reported before the file held the entry
+    size_t expected_size[256];      // file size once submission i is in
+    char last_summary[PORTAL_JOURNAL_SUMMARY_MAX];
+} commit_log_t;
+
+static void commit_cb(const portal_journal_entry_t *last, uint32_t count, void *user_data)
+{
+    commit_log_t *log = (commit_log_t *)user_data;
+    if (atomic_load(&s_io.writes_since_fsync) != 0) {
+        atomic_store(&log->unsynced_report, true);
+    }
+    unsigned index = 0;
+    if (sscanf(last->summary, "entry %u", &index) == 1 && index < 256 &&
+        file_size(log->path) < (off_t)log->expected_size[index]) {
+        atomic_store(&log->missing_in_file, true);
+    }
+    memcpy(log->last_summary, last->summary, sizeof(log->last_summary));
+    atomic_fetch_add(&log->committed, count);
+    atomic_fetch_add(&log->calls, 1);
+}
+
+static bool wait_committed(commit_log_t *log, uint32_t count, TickType_t timeout)
+{
+    TickType_t start = xTaskGetTickCount();
+    while (atomic_load(&log->committed) < count) {
+        if (xTaskGetTickCount() - start > timeout) {
+            return false;
+        }
+        vTaskDelay(5);
+    }
+    return true;
+}
+
+// Random form fields; some are longer than an entry holds
+static void random_form(char *out, size_t size)
+{
+    size_t len = rng() % 8 ? rng_range(10, 200) : rng_range(600, size - 1);
+    for (size_t i = 0; i < len; i++) {
+        out[i] = "abcdefghijklmnopqrstuvwxyz0123456789=&%+"[rng() % 40];
+    }
+    out[len] = '\0';
+}
+
+static void submit(portal_journal_t *journal, commit_log_t *log, unsigned index, char *expected, size_t *expected_len)
+{
+    char form[2048];
+    char ssid[48];
+    snprintf(ssid, sizeof(ssid), "Portal %u%s", index, index % 5 == 0 ? " with a name that is far too long" : "");
+    random_form(form, sizeof(form));
+
+    portal_journal_entry_t *entry = portal_journal_begin(journal, pdMS_TO_TICKS(2000));
+    CHECK(entry != NULL);
+    if (!entry) {
+        return;
+    }
+    portal_journal_set_record(entry, ssid, form);
+    snprintf(entry->summary, sizeof(entry->summary), "entry %u", index);
+    memcpy(expected + *expected_len, entry->text, entry->len);
+    *expected_len += entry->len;
+    log->expected_size[index] = *expected_len;
+    portal_journal_publish(journal);
+}
+
+static void test_bursts(void)
+{
+    static commit_log_t log;
+    static char expected[256 * PORTAL_JOURNAL_ENTRY_MAX];
+    size_t expected_len = 0;
+    make_path(log.path, sizeof(log.path), "bursts.txt");
+
+    static portal_journal_t journal;
+    CHECK(portal_journal_start(&journal, log.path, commit_cb, &log, 5));
+    io_counters_t before = s_io;
+
+    unsigned index = 0;
+    static const unsigned bursts[] = {1, 25, 32, 7, 60};
+    for (size_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+        for (unsigned i = 0; i < bursts[b]; i++) {
+            submit(&journal, &log, index++, expected, &expected_len);
+        }
+        CHECK(wait_committed(&log, index, pdMS_TO_TICKS(5000)));
+    }
+
+    size_t len;
+    char *data = read_file(log.path, &len);
+    CHECK(data && len == expected_len && memcmp(data, expected, len) == 0);
+    free(data);
+
+    CHECK(!atomic_load(&log.unsynced_report));
+    CHECK(!atomic_load(&log.missing_in_file));
+    char want[32];
+    snprintf(want, sizeof(want), "entry %u", index - 1);
+    CHECK(strcmp(log.last_summary, want) == 0);
+    CHECK(journal.stats.enqueued == index && journal.stats.committed == index && journal.stats.dropped == 0);
+    CHECK(journal.stats.write_errors == 0);
+    // Coalescing: far fewer writes and syncs than submissions, none of them off a block boundary
+    CHECK(atomic_load(&s_io.writes) - atomic_load(&before.writes) == journal.stats.blocks_written + journal.stats.tail_writes);
+    CHECK(journal.stats.tail_writes < index / 4);
+    CHECK(journal.stats.blocks_written == expected_len / PORTAL_JOURNAL_BLOCK_SIZE);
+    CHECK(atomic_load(&s_io.unaligned_writes) == atomic_load(&before.unaligned_writes));
+    CHECK(atomic_load(&log.calls) <= journal.stats.syncs);
+    CHECK(atomic_load(&s_io.opens) - atomic_load(&before.opens) == 1);
+
+    // Idle: synced and closed after PORTAL_JOURNAL_IDLE_CLOSE_MS
+    vTaskDelay(pdMS_TO_TICKS(PORTAL_JOURNAL_SYNC_MS + PORTAL_JOURNAL_IDLE_CLOSE_MS + 500));
+    CHECK(journal.fd == -1);
+}
+
+// Appending to a file whose size is not block aligned: the partial block is read back and rewritten in place
+static void test_existing_tail(void)
+{
+    static commit_log_t log;
+    make_path(log.path, sizeof(log.path), "existing.txt");
+    static char expected[5000 + 64 * PORTAL_JOURNAL_ENTRY_MAX];
+    size_t expected_len = 5000;
+    for (size_t i = 0; i < expected_len; i++) {
+        expected[i] = i % 64 == 63 ? '\n' : (char)('a' + i % 26);
+    }
+    FILE *f = fopen(log.path, "wb");
+    fwrite(expected, 1, expected_len, f);
+    fclose(f);
+
+    static portal_journal_t journal;
+    CHECK(portal_journal_start(&journal, log.path, commit_cb, &log, 5));
+    io_counters_t before = s_io;
+    for (unsigned i = 0; i < 20; i++) {
+        submit(&journal, &log, i, expected, &expected_len);
+    }
+    CHECK(wait_committed(&log, 20, pdMS_TO_TICKS(5000)));
+
+    size_t len;
+    char *data = read_file(log.path, &len);
+    CHECK(data && len == expected_len && memcmp(data, expected, len) == 0);
+    free(data);
+    CHECK(atomic_load(&s_io.unaligned_writes) == atomic_load(&before.unaligned_writes));
+    CHECK(journal.stats.blocks_written == expected_len / PORTAL_JOURNAL_BLOCK_SIZE - 1);
+}
+
+static void test_record_format(void)
+{
+    static portal_journal_entry_t entry;
+    portal_journal_set_record(&entry, "Cafe", "email=a%40b.c&password=hunter2");
+    CHECK(strcmp(entry.text, "SSID: Cafe\nData: email=a%40b.c&password=hunter2\n---\n") == 0);
+    CHECK(entry.len == strlen(entry.text));
+
+    portal_journal_set_record(&entry, "", "");
+    CHECK(strcmp(entry.text, "SSID: \nData: \n---\n") == 0 && entry.len == strlen(entry.text));
+
+    // SSIDs stop at 32 characters, oversized forms lose their end but not the terminator
+    char ssid[64], form[3000];
+    memset(ssid, 'S', sizeof(ssid) - 1);
+    ssid[sizeof(ssid) - 1] = '\0';
+    memset(form, 'f', sizeof(form) - 1);
+    form[sizeof(form) - 1] = '\0';
+    portal_journal_set_record(&entry, ssid, form);
+    CHECK(entry.len == PORTAL_JOURNAL_ENTRY_MAX - 1);
+    CHECK(entry.len == strlen(entry.text));
+    CHECK(strncmp(entry.text, "SSID: ", 6) == 0 && entry.text[6 + 32] == '\n');
+    CHECK(memcmp(entry.text + entry.len - 5, "\n---\n", 5) == 0);
+    CHECK(strstr(entry.text + 6 + 32, "\nData: ffff") == entry.text + 6 + 32);
+
+    // One byte short of the limit still fits whole
+    size_t fixed = strlen("SSID: Cafe\nData: \n---\n");
+    memset(form, 'g', PORTAL_JOURNAL_ENTRY_MAX - 1 - fixed);
+    form[PORTAL_JOURNAL_ENTRY_MAX - 1 - fixed] = '\0';
+    portal_journal_set_record(&entry, "Cafe", form);
+    CHECK(entry.len == PORTAL_JOURNAL_ENTRY_MAX - 1);
+    CHECK(strstr(entry.text, form) != NULL);
+}
+
+static void test_full_ring(void)
+{
+    static commit_log_t log;
+    static char expected[64 * PORTAL_JOURNAL_ENTRY_MAX];
+    size_t expected_len = 0;
+    make_path(log.path, sizeof(log.path), "full.txt");
+    static portal_journal_t journal;
+    CHECK(portal_journal_start(&journal, log.path, commit_cb, &log, 5));
+
+    // The writer waits PORTAL_JOURNAL_COALESCE_MS before draining, so the ring fills up first
+    for (unsigned i = 0; i < PORTAL_JOURNAL_QUEUE_LEN; i++) {
+        submit(&journal, &log, i, expected, &expected_len);
+    }
+    CHECK(portal_journal_begin(&journal, 0) == NULL);
+    CHECK(journal.stats.dropped == 1);
+    // Waiting instead gets a slot once the batch is written
+    submit(&journal, &log, PORTAL_JOURNAL_QUEUE_LEN, expected, &expected_len);
+    CHECK(wait_committed(&log, PORTAL_JOURNAL_QUEUE_LEN + 1, pdMS_TO_TICKS(5000)));
+
+    size_t len;
+    char *data = read_file(log.path, &len);
+    CHECK(data && len == expected_len && memcmp(data, expected, len) == 0);
+    free(data);
+}
+
+static void test_open_error(void)
+{
+    static commit_log_t log;
+    static char expected[8 * PORTAL_JOURNAL_ENTRY_MAX];
+    size_t expected_len = 0;
+    make_path(log.path, sizeof(log.path), "missing-dir/portals.txt");
+    static portal_journal_t journal;
+    CHECK(portal_journal_start(&journal, log.path, commit_cb, &log, 5));
+    for (unsigned i = 0; i < 3; i++) {
+        submit(&journal, &log, i, expected, &expected_len);
+    }
+    vTaskDelay(pdMS_TO_TICKS(PORTAL_JOURNAL_COALESCE_MS + 200));
+    CHECK(journal.stats.write_errors >= 1);
+    CHECK(journal.stats.committed == 0);
+    CHECK(atomic_load(&log.calls) == 0);
+    // The slots are free again
+    CHECK(atomic_load(&journal.tail) == atomic_load(&journal.head));
+
+    CHECK(!portal_journal_start(&journal, NULL, commit_cb, &log, 5));
+    CHECK(portal_journal_begin(NULL, 0) == NULL);
+}
+
+static int run_functionality(void)
+{
+    test_record_format();
+    test_existing_tail();
+    test_full_ring();
+    test_open_error();
+    test_bursts();
+    return test_result();
+}
+
+#define BENCH_SUBMISSIONS   500
+
+static int run_benchmark(void)
+{
+    static char form[BENCH_SUBMISSIONS][256];
+    for (int i = 0; i < BENCH_SUBMISSIONS; i++) {
+        snprintf(form[i], sizeof(form[i]), "email=user%d%%40example.com&password=%08x", i, (unsigned)rng());
+    }
+    static portal_journal_entry_t record;
+    s_sd_model = true;
+    printf("%d submissions on a simulated SD card\n", BENCH_SUBMISSIONS);
+    printf("%-10s %10s %8s %8s %8s %8s\n", "writer", "records/s", "opens", "writes", "fsyncs", "closes");
+
+    // Per-record open/append/close, as the httpd task did it
+    char legacy_path[96];
+    make_path(legacy_path, sizeof(legacy_path), "bench-legacy.txt");
+    io_counters_t before = s_io;
+    int64_t start = now_ns();
+    for (int i = 0; i < BENCH_SUBMISSIONS; i++) {
+        portal_journal_set_record(&record, "Free WiFi", form[i]);
+        int fd = open(legacy_path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0 || write(fd, record.text, record.len) != record.len) {
+            printf("FAIL cannot write %s\n", legacy_path);
+            return EXIT_FAILURE;
+        }
+        close(fd);
+    }
+    double seconds = (double)(now_ns() - start) / 1e9;
+    printf("%-10s %10.0f %8u %8u %8u %8u\n", "legacy", BENCH_SUBMISSIONS / seconds,
+           atomic_load(&s_io.opens) - atomic_load(&before.opens), atomic_load(&s_io.writes) - atomic_load(&before.writes),
+           atomic_load(&s_io.fsyncs) - atomic_load(&before.fsyncs), atomic_load(&s_io.closes) - atomic_load(&before.closes));
+
+    // The journal, until the last submission is committed
+    static commit_log_t log;
+    make_path(log.path, sizeof(log.path), "bench-journal.txt");
+    static portal_journal_t journal;
+    portal_journal_start(&journal, log.path, commit_cb, &log, 5);
+    before = s_io;
+    start = now_ns();
+    for (int i = 0; i < BENCH_SUBMISSIONS; i++) {
+        portal_journal_entry_t *entry = portal_journal_begin(&journal, portMAX_DELAY);
+        portal_journal_set_record(entry, "Free WiFi", form[i]);
+        portal_journal_publish(&journal);
+    }
+    wait_committed(&log, BENCH_SUBMISSIONS, portMAX_DELAY);
+    seconds = (double)(now_ns() - start) / 1e9;
+    printf("%-10s %10.0f %8u %8u %8u %8u\n", "journal", BENCH_SUBMISSIONS / seconds,
+           atomic_load(&s_io.opens) - atomic_load(&before.opens), atomic_load(&s_io.writes) - atomic_load(&before.writes),
+           atomic_load(&s_io.fsyncs) - atomic_load(&before.fsyncs), atomic_load(&s_io.closes) - atomic_load(&before.closes));
+
+    size_t legacy_len, journal_len;
+    char *legacy = read_file(legacy_path, &legacy_len);
+    char *journal_data = read_file(log.path, &journal_len);
+    bool same = legacy && journal_data && legacy_len == journal_len && memcmp(legacy, journal_data, legacy_len) == 0;
+    free(legacy);
+    free(journal_data);
+    if (!same) {
+        printf("FAIL the two files differ\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    snprintf(s_dir, sizeof(s_dir), "/tmp/test_portal_journal.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    if (system(cmd) != 0) {
+        printf("could not remove %s\n", s_dir);
+    }
+    return rc;
+}
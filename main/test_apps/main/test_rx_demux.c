@@ -0,0 +1,364 @@
+/*
+ * Host test of the receive demultiplexer (rx_demux.c) on the pthread FreeRTOS shim.
+ *
+ *   test_rx_demux    replays a recorded JanOS session (data/janos_session.txt) through a fake transport in
+ *                    random chunk sizes while five subscribers read concurrently on their own tasks: every
+ *                    line, a prefix, two regular expressions and one uart_read_bytes() style byte stream.
+ *                    Each must see exactly its lines in order. Then: a subscriber that never reads loses
+ *                    lines without holding up the others or gluing lines together, rx_demux_clear() empties
+ *                    a subscription, and a late subscriber sees only what arrives after it subscribed.
+ */
+
+#include <regex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "rx_demux.h"
+#include "test_common.h"
+
+#define REPLAYS             200
+#define RING_SIZE           4096
+#define SUB_TIMEOUT_MS      5000
+#define CLIENT_PATTERN      "^ [0-9A-Fa-f]{2}(:[0-9A-Fa-f]{2}){5}$"
+#define HANDSHAKE_PATTERN   "[Hh]andshake"
+
+// Recorded session, split into lines
+static char *capture;
+static size_t capture_len;
+static char **capture_lines;
+static size_t capture_count;
+
+// Fake transport: hands out the replay buffer up to what the test released, pausing
+// a tick every PACE_BYTES so the subscribers get the CPU like on a real link
+#define PACE_BYTES          2048
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t pos;
+    size_t released;
+    size_t since_pause;
+} fake_transport_t;
+
+static int fake_read(void *user_data, uint8_t *dst, size_t len, uint32_t timeout)
+{
+    fake_transport_t *t = (fake_transport_t *)user_data;
+    size_t released = __atomic_load_n(&t->released, __ATOMIC_ACQUIRE);
+    if (t->pos >= released) {
+        vTaskDelay(timeout < 5 ? timeout : 5);
+        return 0;
+    }
+    size_t n = released - t->pos;
+    size_t chunk = rng_range(1, 256);
+    n = n < len ? n : len;
+    n = n < chunk ? n : chunk;
+    memcpy(dst, t->data + t->pos, n);
+    t->pos += n;
+    t->since_pause += n;
+    if (t->since_pause >= PACE_BYTES) {
+        t->since_pause = 0;
+        vTaskDelay(1);
+    }
+    return (int)n;
+}
+
+static void release(fake_transport_t *t, size_t len)
+{
+    __atomic_store_n(&t->released, len, __ATOMIC_RELEASE);
+}
+
+// The capture repeated, with CR LF line ends as the board sends them
+static fake_transport_t *transport_new(int replays)
+{
+    fake_transport_t *t = calloc(1, sizeof(*t));
+    t->data = malloc(capture_len * replays + 1);
+    for (int i = 0; i < replays; i++) {
+        memcpy(t->data + t->len, capture, capture_len);
+        t->len += capture_len;
+    }
+    return t;
+}
+
+static bool load_capture(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        printf("FAIL cannot open %s\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    capture_len = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    capture = malloc(capture_len + 1);
+    bool ok = fread(capture, 1, capture_len, f) == capture_len;
+    fclose(f);
+    capture[capture_len] = '\0';
+
+    // Split a copy, the replay keeps the original bytes
+    char *copy = strdup(capture);
+    capture_lines = calloc(capture_len, sizeof(char *));
+    for (char *save = NULL, *line = strtok_r(copy, "\r\n", &save); line; line = strtok_r(NULL, "\r\n", &save)) {
+        capture_lines[capture_count++] = line;
+    }
+    return ok && capture_count > 0;
+}
+
+typedef enum {
+    FILTER_ALL,
+    FILTER_PREFIX,
+    FILTER_REGEX,
+} filter_kind_t;
+
+typedef struct {
+    const char *name;
+    filter_kind_t kind;
+    const char *filter;
+    bool byte_stream;           // read with rx_demux_read() instead of rx_demux_next_line()
+    regex_t regex;
+    rx_demux_sub_t *sub;
+    size_t expected;            // lines per replay
+    size_t total;               // lines to expect in all
+    size_t got;
+    size_t mismatches;
+    SemaphoreHandle_t done;
+} subscriber_t;
+
+static bool filter_matches(subscriber_t *s, const char *line)
+{
+    switch (s->kind) {
+    case FILTER_PREFIX: return strncmp(line, s->filter, strlen(s->filter)) == 0;
+    case FILTER_REGEX: return regexec(&s->regex, line, 0, NULL, 0) == 0;
+    default: return true;
+    }
+}
+
+// The n-th line of the replay this subscriber should see
+static const char *expected_line(subscriber_t *s, size_t n)
+{
+    size_t want = n % s->expected;
+    for (size_t i = 0; i < capture_count; i++) {
+        if (filter_matches(s, capture_lines[i]) && want-- == 0) {
+            return capture_lines[i];
+        }
+    }
+    return NULL;
+}
+
+static void check_line(subscriber_t *s, const char *line)
+{
+    const char *want = expected_line(s, s->got);
+    if (!want || strcmp(want, line) != 0) {
+        if (s->mismatches++ == 0) {
+            printf("FAIL %s line %zu: '%s', expected '%s'\n", s->name, s->got, line, want ? want : "(none)");
+        }
+    }
+    s->got++;
+}
+
+// rx_demux_next_line() fills once: false may just mean half a line arrived, so retry until the time is up
+static bool next_line(rx_demux_sub_t *sub, line_view_t *line, TickType_t ticks)
+{
+    TickType_t start = xTaskGetTickCount();
+    do {
+        if (rx_demux_next_line(sub, line, ticks)) {
+            return true;
+        }
+    } while (xTaskGetTickCount() - start < ticks);
+    return false;
+}
+
+static void subscriber_task(void *arg)
+{
+    subscriber_t *s = (subscriber_t *)arg;
+    if (s->byte_stream) {
+        char buf[700];
+        char line[1024];
+        size_t line_len = 0;
+        // Short waits: like uart_read_bytes(), a read returns early only once it has all it asked for
+        TickType_t last = xTaskGetTickCount();
+        while (s->got < s->total && xTaskGetTickCount() - last < pdMS_TO_TICKS(SUB_TIMEOUT_MS)) {
+            int n = rx_demux_read(s->sub, buf, rng_range(1, sizeof(buf)), pdMS_TO_TICKS(10));
+            if (n > 0) {
+                last = xTaskGetTickCount();
+            }
+            for (int i = 0; i < n; i++) {
+                if (buf[i] == '\n') {
+                    line[line_len] = '\0';
+                    check_line(s, line);
+                    line_len = 0;
+                } else if (line_len < sizeof(line) - 1) {
+                    line[line_len++] = buf[i];
+                }
+            }
+        }
+    } else {
+        line_view_t line;
+        while (s->got < s->total && next_line(s->sub, &line, pdMS_TO_TICKS(SUB_TIMEOUT_MS))) {
+            check_line(s, line.text);
+        }
+    }
+    xSemaphoreGive(s->done);
+    vTaskDelete(NULL);
+}
+
+static rx_demux_t *demux_new(fake_transport_t *t)
+{
+    rx_demux_t *demux = calloc(1, sizeof(*demux));
+    uint8_t *ring = malloc(RING_SIZE + 1);
+    char *scratch = malloc(RING_SIZE + 1);
+    CHECK(rx_demux_start(demux, "replay", ring, scratch, RING_SIZE, fake_read, t, 5));
+    return demux;
+}
+
+static void wait_dispatched(rx_demux_t *demux, uint32_t lines)
+{
+    for (int i = 0; i < 5000 && __atomic_load_n(&demux->stats.lines, __ATOMIC_ACQUIRE) < lines; i++) {
+        vTaskDelay(1);
+    }
+}
+
+static void test_concurrent_replay(void)
+{
+    subscriber_t subs[] = {
+        {.name = "all", .kind = FILTER_ALL},
+        {.name = "scan rows", .kind = FILTER_PREFIX, .filter = "\""},
+        {.name = "sniffer clients", .kind = FILTER_REGEX, .filter = CLIENT_PATTERN},
+        {.name = "handshakes", .kind = FILTER_REGEX, .filter = HANDSHAKE_PATTERN},
+        {.name = "sd paths", .kind = FILTER_PREFIX, .filter = "/sdcard/", .byte_stream = true},
+    };
+    const size_t count = sizeof(subs) / sizeof(subs[0]);
+
+    fake_transport_t *t = transport_new(REPLAYS);
+    rx_demux_t *demux = demux_new(t);
+
+    // Everyone subscribes before the board starts talking
+    for (size_t i = 0; i < count; i++) {
+        subscriber_t *s = &subs[i];
+        if (s->kind == FILTER_REGEX) {
+            regcomp(&s->regex, s->filter, REG_EXTENDED | REG_NOSUB);
+            s->sub = rx_demux_subscribe_regex(demux, s->filter);
+        } else {
+            s->sub = rx_demux_subscribe(demux, s->filter);
+        }
+        CHECK(s->sub != NULL);
+        for (size_t l = 0; l < capture_count; l++) {
+            s->expected += filter_matches(s, capture_lines[l]);
+        }
+        s->total = s->expected * REPLAYS;
+        s->done = xSemaphoreCreateBinary();
+        CHECK(xTaskCreate(subscriber_task, s->name, 4096, s, 5, NULL) == pdPASS);
+    }
+    release(t, t->len);
+
+    for (size_t i = 0; i < count; i++) {
+        subscriber_t *s = &subs[i];
+        CHECK(xSemaphoreTake(s->done, pdMS_TO_TICKS(30 * 1000)) == pdTRUE);
+        printf("%-16s %6zu lines, %zu mismatched\n", s->name, s->got, s->mismatches);
+        CHECK(s->expected > 0);
+        CHECK(s->got == s->total);
+        CHECK(s->mismatches == 0);
+    }
+    CHECK(demux->stats.lines == capture_count * REPLAYS);
+    CHECK(demux->stats.dropped_lines == 0);
+    CHECK(demux->stats.unclaimed_lines == 0);
+
+    for (size_t i = 0; i < count; i++) {
+        rx_demux_unsubscribe(subs[i].sub);
+        if (subs[i].kind == FILTER_REGEX) {
+            regfree(&subs[i].regex);
+        }
+        vSemaphoreDelete(subs[i].done);
+    }
+}
+
+// A subscriber that stops reading loses lines, but only whole ones and only for itself
+static void test_slow_subscriber(void)
+{
+    fake_transport_t *t = transport_new(REPLAYS);
+    rx_demux_t *demux = demux_new(t);
+    subscriber_t fast = {.name = "fast", .kind = FILTER_ALL};
+    fast.sub = rx_demux_subscribe(demux, NULL);
+    fast.expected = capture_count;
+    fast.total = capture_count * REPLAYS;
+    fast.done = xSemaphoreCreateBinary();
+    rx_demux_sub_t *slow = rx_demux_subscribe(demux, NULL);
+    CHECK(xTaskCreate(subscriber_task, "fast", 4096, &fast, 5, NULL) == pdPASS);
+    release(t, t->len);
+
+    CHECK(xSemaphoreTake(fast.done, pdMS_TO_TICKS(30 * 1000)) == pdTRUE);
+    CHECK(fast.got == fast.total && fast.mismatches == 0);
+    CHECK(demux->stats.dropped_lines > 0);
+
+    size_t seen = 0;
+    size_t foreign = 0;
+    line_view_t line;
+    while (next_line(slow, &line, 1)) {
+        bool known = false;
+        for (size_t i = 0; i < capture_count && !known; i++) {
+            known = strcmp(capture_lines[i], line.text) == 0;
+        }
+        foreign += !known;
+        seen++;
+    }
+    printf("slow subscriber  %6zu lines kept, %u dropped\n", seen, (unsigned)demux->stats.dropped_lines);
+    CHECK(seen > 0);
+    CHECK(foreign == 0);
+    CHECK(seen + demux->stats.dropped_lines == capture_count * REPLAYS);
+
+    rx_demux_unsubscribe(fast.sub);
+    rx_demux_unsubscribe(slow);
+    vSemaphoreDelete(fast.done);
+}
+
+static void test_clear_and_late_subscribe(void)
+{
+    fake_transport_t *t = transport_new(2);
+    rx_demux_t *demux = demux_new(t);
+    rx_demux_sub_t *early = rx_demux_subscribe(demux, NULL);
+
+    release(t, capture_len);
+    wait_dispatched(demux, capture_count);
+    CHECK(demux->stats.lines == capture_count);
+
+    // Nothing of the first replay is left after a clear
+    line_view_t line;
+    rx_demux_clear(early);
+    CHECK(!next_line(early, &line, pdMS_TO_TICKS(20)));
+
+    // Subscribing replaces flushing: the late subscriber starts with the second replay
+    rx_demux_sub_t *late = rx_demux_subscribe(demux, NULL);
+    release(t, t->len);
+    size_t got = 0;
+    size_t early_got = 0;
+    bool in_order = true;
+    while (next_line(late, &line, pdMS_TO_TICKS(200))) {
+        in_order &= got < capture_count && strcmp(line.text, capture_lines[got]) == 0;
+        got++;
+    }
+    while (next_line(early, &line, 1)) {
+        early_got++;
+    }
+    CHECK(got == capture_count);
+    CHECK(in_order);
+    CHECK(early_got == capture_count);
+
+    rx_demux_unsubscribe(early);
+    rx_demux_unsubscribe(late);
+    CHECK(rx_demux_subscribe_regex(demux, "([") == NULL);
+}
+
+int main(void)
+{
+    if (!load_capture(TEST_DATA_DIR "/janos_session.txt")) {
+        return EXIT_FAILURE;
+    }
+    test_concurrent_replay();
+    test_slow_subscriber();
+    test_clear_and_late_subscribe();
+    return test_result();
+}
@@ -0,0 +1,565 @@
+/*
+ * Host test and benchmark of the transport trace ring (transport_trace.c) on the pthread FreeRTOS shim.
+ *
+ *   test_transport_trace          functionality test: random chunks on all channels against a model of
+ *                                 counters and ring contents, through many wraps, read back from the dump
+ *                                 file; levels and their clamps, clear, the log dump's record walk;
+ *                                 several tasks tracing while another dumps
+ *   test_transport_trace bench    ns per chunk of 16, 80 and 512 bytes at the counter and ring levels,
+ *                                 against formatting the hex/ASCII dump the USB read used to log
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "transport_trace.h"
+#include "test_common.h"
+
+#define MODEL_CHUNKS        20000
+#define MODEL_MAX_RECORDS   (TRANSPORT_TRACE_RING_SIZE / sizeof(transport_trace_record_t) + 1)
+#define CHUNK_MAX_TEST      2000    // longer than a record holds, so chunks get split
+
+static const char *const s_names[TRANSPORT_TRACE_CHANNELS] = {"Grove", "USB", "MBus"};
+static char s_dir[64];
+
+static void trace_free(transport_trace_t *trace)
+{
+    vSemaphoreDelete(trace->lock);
+    free(trace->ring);
+    memset(trace, 0, sizeof(*trace));
+}
+
+// JanOS-like bytes: printable text with line ends, now and then a binary byte
+static void random_chunk(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint32_t r = rng() % 32;
+        buf[i] = r == 0 ? '\n' : r == 1 ? (uint8_t)rng() : (uint8_t)rng_range(32, 126);
+    }
+}
+
+static uint32_t count_lines(const uint8_t *buf, size_t len)
+{
+    uint32_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        n += buf[i] == '\n';
+    }
+    return n;
+}
+
+// What the ring should hold: records oldest first, with their payloads
+typedef struct {
+    uint8_t channel;
+    uint8_t dir;
+    uint16_t len;
+    uint8_t data[TRANSPORT_TRACE_CHUNK_MAX];
+} model_record_t;
+
+typedef struct {
+    model_record_t *records;    // circular, MODEL_MAX_RECORDS
+    size_t first;
+    size_t count;
+    size_t used;                // ring bytes, headers included
+    uint32_t dropped;
+    transport_trace_counters_t counters[TRANSPORT_TRACE_CHANNELS];
+} model_t;
+
+static void model_push(model_t *m, uint8_t channel, uint8_t dir, const uint8_t *data, size_t len)
+{
+    size_t need = sizeof(transport_trace_record_t) + len;
+    while (m->used + need > TRANSPORT_TRACE_RING_SIZE) {
+        m->used -= sizeof(transport_trace_record_t) + m->records[m->first].len;
+        m->first = (m->first + 1) % MODEL_MAX_RECORDS;
+        m->count--;
+        m->dropped++;
+    }
+    model_record_t *r = &m->records[(m->first + m->count) % MODEL_MAX_RECORDS];
+    r->channel = channel;
+    r->dir = dir;
+    r->len = (uint16_t)len;
+    memcpy(r->data, data, len);
+    m->count++;
+    m->used += need;
+}
+
+static void model_trace(model_t *m, bool ring, uint8_t channel, uint8_t dir, const uint8_t *data, size_t len)
+{
+    transport_trace_counters_t *c = &m->counters[channel];
+    c->bytes[dir] += (uint32_t)len;
+    c->lines[dir] += count_lines(data, len);
+    c->chunks[dir]++;
+    for (size_t done = 0; ring && done < len; done += TRANSPORT_TRACE_CHUNK_MAX) {
+        size_t n = len - done < TRANSPORT_TRACE_CHUNK_MAX ? len - done : TRANSPORT_TRACE_CHUNK_MAX;
+        model_push(m, channel, dir, data + done, n);
+    }
+}
+
+static bool counters_match(transport_trace_t *trace, const model_t *m)
+{
+    bool ok = true;
+    for (uint8_t ch = 0; ch < TRANSPORT_TRACE_CHANNELS; ch++) {
+        transport_trace_counters_t c;
+        transport_trace_get_counters(trace, ch, &c);
+        ok = ok && memcmp(&c, &m->counters[ch], sizeof(c)) == 0;
+    }
+    return ok;
+}
+
+static void make_path(char *out, size_t size, const char *name)
+{
+    snprintf(out, size, "%s/%s", s_dir, name);
+}
+
+// Read a dump back and compare header and records with the model
+static bool dump_matches(transport_trace_t *trace, const model_t *m, const char *name)
+{
+    char path[128];
+    make_path(path, sizeof(path), name);
+    if (!transport_trace_dump_file(trace, path)) {
+        return false;
+    }
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    transport_trace_file_header_t h;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && h.magic == TRANSPORT_TRACE_FILE_MAGIC && h.version == 1 &&
+              h.channel_count == TRANSPORT_TRACE_CHANNELS && h.records == m->count && h.dropped == m->dropped;
+    for (int ch = 0; ok && ch < TRANSPORT_TRACE_CHANNELS; ch++) {
+        ok = strcmp(h.names[ch], s_names[ch]) == 0;
+    }
+    int64_t now = esp_timer_get_time();
+    ok = ok && h.dump_time_us <= (uint64_t)now && h.dump_time_us + 1000000 > (uint64_t)now;
+
+    uint32_t prev_time = 0;
+    for (size_t i = 0; ok && i < m->count; i++) {
+        const model_record_t *want = &m->records[(m->first + i) % MODEL_MAX_RECORDS];
+        transport_trace_record_t rec;
+        uint8_t data[TRANSPORT_TRACE_CHUNK_MAX];
+        ok = fread(&rec, sizeof(rec), 1, f) == 1 && rec.channel == want->channel && rec.dir == want->dir &&
+             rec.len == want->len && fread(data, 1, rec.len, f) == rec.len && memcmp(data, want->data, rec.len) == 0;
+        // The clock does not wrap within a test run
+        ok = ok && (i == 0 || rec.time_us >= prev_time);
+        prev_time = rec.time_us;
+    }
+    ok = ok && fgetc(f) == EOF;
+    fclose(f);
+    unlink(path);
+    return ok;
+}
+
+// Run the log dump into a file and compare its record lines with the newest max records of the model
+static bool log_matches(transport_trace_t *trace, const model_t *m, uint32_t max)
+{
+    char path[128];
+    make_path(path, sizeof(path), "log.txt");
+    fflush(stderr);
+    int saved = dup(2);
+    FILE *f = fopen(path, "w+");
+    if (saved < 0 || !f) {
+        return false;
+    }
+    dup2(fileno(f), 2);
+    esp_log_shim_level = ESP_LOG_INFO;
+    uint32_t logged = transport_trace_dump_log(trace, max);
+    esp_log_shim_level = ESP_LOG_WARN;
+    fflush(stderr);
+    dup2(saved, 2);
+    close(saved);
+
+    size_t first = m->count > max ? m->count - max : 0;
+    bool ok = logged == m->count - first;
+    rewind(f);
+    char line[512];
+    size_t i = first;
+    while (ok && fgets(line, sizeof(line), f)) {
+        unsigned long time_us;
+        char name[8];
+        char dir[3];
+        unsigned len;
+        if (sscanf(line, "I (transport_trace) %lu [%7[^]]] %2s %u:", &time_us, name, dir, &len) != 4) {
+            continue;   // the counter lines
+        }
+        const model_record_t *want = &m->records[(m->first + i++) % MODEL_MAX_RECORDS];
+        char hex[TRANSPORT_TRACE_LOG_BYTES * 3 + 1] = "";
+        for (size_t b = 0; b < want->len && b < TRANSPORT_TRACE_LOG_BYTES; b++) {
+            snprintf(hex + b * 3, 4, "%02X ", want->data[b]);
+        }
+        const char *shown = strstr(line, ": [");
+        ok = i <= m->count && len == want->len && strcmp(name, s_names[want->channel]) == 0 &&
+             strcmp(dir, want->dir == TRANSPORT_TRACE_RX ? "<<" : ">>") == 0 && shown &&
+             strncmp(shown + 3, hex, strlen(hex)) == 0 && shown[3 + strlen(hex)] == ']';
+    }
+    ok = ok && i == m->count;
+    fclose(f);
+    unlink(path);
+    return ok;
+}
+
+static void test_model(void)
+{
+    static model_t m;
+    memset(&m, 0, sizeof(m));
+    m.records = calloc(MODEL_MAX_RECORDS, sizeof(model_record_t));
+    transport_trace_t trace;
+    CHECK(transport_trace_init(&trace, s_names));
+    CHECK(trace.level == TRANSPORT_TRACE_RING && trace.ring != NULL);
+
+    static uint8_t chunk[CHUNK_MAX_TEST];
+    bool records_ok = true;
+    bool counters_ok = true;
+    int dumps = 0;
+    bool dumps_ok = true;
+    for (int i = 0; i < MODEL_CHUNKS; i++) {
+        uint32_t r = rng() % 100;
+        size_t len = r < 60 ? rng_range(1, 100) : r < 95 ? rng_range(100, 600) : rng_range(600, CHUNK_MAX_TEST);
+        uint8_t channel = (uint8_t)(rng() % TRANSPORT_TRACE_CHANNELS);
+        uint8_t dir = (uint8_t)(rng() % 4 == 0 ? TRANSPORT_TRACE_TX : TRANSPORT_TRACE_RX);
+        random_chunk(chunk, len);
+        transport_trace(&trace, channel, (transport_trace_dir_t)dir, chunk, len);
+        model_trace(&m, true, channel, dir, chunk, len);
+
+        records_ok = records_ok && trace.records == m.count && trace.dropped == m.dropped &&
+                     trace.head - trace.tail == m.used;
+        if (i % 1000 == 0) {
+            counters_ok = counters_ok && counters_match(&trace, &m);
+        }
+        if (i % 2500 == 1234) {
+            dumps_ok = dumps_ok && dump_matches(&trace, &m, "model.ttr");
+            dumps++;
+        }
+    }
+    CHECK(records_ok);
+    CHECK(counters_ok && counters_match(&trace, &m));
+    CHECK(dumps_ok && dumps == 8);
+    CHECK(dump_matches(&trace, &m, "model.ttr"));
+    // Many times round the ring
+    CHECK(trace.head > 20u * TRANSPORT_TRACE_RING_SIZE && m.dropped > 10000);
+
+    // The log dump walks the same records; the newest max come out, oldest of them first
+    CHECK(log_matches(&trace, &m, 64));
+    esp_log_shim_level = ESP_LOG_NONE;
+    CHECK(transport_trace_dump_log(&trace, 0) == 0);
+    CHECK(transport_trace_dump_log(&trace, UINT32_MAX) == m.count);
+    esp_log_shim_level = ESP_LOG_WARN;
+
+    // A chunk of exactly one record, and one a byte longer
+    memset(&m.counters, 0, sizeof(m.counters));
+    transport_trace_clear(&trace);
+    m.first = m.count = m.used = 0;
+    m.dropped = 0;
+    CHECK(trace.records == 0 && counters_match(&trace, &m));
+    random_chunk(chunk, TRANSPORT_TRACE_CHUNK_MAX + 1);
+    transport_trace(&trace, 1, TRANSPORT_TRACE_TX, chunk, TRANSPORT_TRACE_CHUNK_MAX);
+    model_trace(&m, true, 1, TRANSPORT_TRACE_TX, chunk, TRANSPORT_TRACE_CHUNK_MAX);
+    transport_trace(&trace, 2, TRANSPORT_TRACE_RX, chunk, TRANSPORT_TRACE_CHUNK_MAX + 1);
+    model_trace(&m, true, 2, TRANSPORT_TRACE_RX, chunk, TRANSPORT_TRACE_CHUNK_MAX + 1);
+    CHECK(trace.records == 3 && m.count == 3);
+    CHECK(counters_match(&trace, &m));
+    CHECK(dump_matches(&trace, &m, "edge.ttr"));
+
+    // Empty chunks and unknown channels are ignored
+    transport_trace(&trace, 0, TRANSPORT_TRACE_RX, chunk, 0);
+    transport_trace_record(&trace, TRANSPORT_TRACE_CHANNELS, TRANSPORT_TRACE_RX, chunk, 10);
+    transport_trace_counters_t c;
+    transport_trace_get_counters(&trace, TRANSPORT_TRACE_CHANNELS, &c);
+    CHECK(c.bytes[0] == 0 && c.chunks[0] == 0);
+    CHECK(trace.records == 3 && counters_match(&trace, &m));
+
+    trace_free(&trace);
+    free(m.records);
+}
+
+static void test_levels(void)
+{
+    static model_t m;
+    memset(&m, 0, sizeof(m));
+    m.records = calloc(MODEL_MAX_RECORDS, sizeof(model_record_t));
+    transport_trace_t trace;
+    CHECK(transport_trace_init(&trace, s_names));
+
+    uint8_t chunk[300];
+    random_chunk(chunk, sizeof(chunk));
+    chunk[0] = '\n';
+
+    // Off: nothing at all
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_OFF);
+    transport_trace(&trace, 0, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    CHECK(trace.records == 0 && counters_match(&trace, &m));
+
+    // Counters only
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_COUNT);
+    transport_trace(&trace, 0, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    model_trace(&m, false, 0, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    CHECK(trace.records == 0 && counters_match(&trace, &m));
+    CHECK(m.counters[0].lines[TRANSPORT_TRACE_RX] >= 1);
+
+    // The ring, and the log line on top of it
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_RING);
+    transport_trace(&trace, 1, TRANSPORT_TRACE_TX, chunk, sizeof(chunk));
+    model_trace(&m, true, 1, TRANSPORT_TRACE_TX, chunk, sizeof(chunk));
+    esp_log_shim_level = ESP_LOG_NONE;
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_LOG);
+    CHECK(trace.level == TRANSPORT_TRACE_LOG);
+    transport_trace(&trace, 2, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    model_trace(&m, true, 2, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    esp_log_shim_level = ESP_LOG_WARN;
+    CHECK(trace.records == 2 && counters_match(&trace, &m));
+    CHECK(dump_matches(&trace, &m, "levels.ttr"));
+
+    // Above the compile-time ceiling clamps to it
+    transport_trace_set_level(&trace, (transport_trace_level_t)7);
+    CHECK(trace.level == TRANSPORT_TRACE_MAX_LEVEL);
+
+    // Without a ring, anything from RING up falls back to counters, and there is nothing to dump
+    free(trace.ring);
+    trace.ring = NULL;
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_RING);
+    CHECK(trace.level == TRANSPORT_TRACE_COUNT);
+    transport_trace_set_level(&trace, TRANSPORT_TRACE_LOG);
+    CHECK(trace.level == TRANSPORT_TRACE_COUNT);
+    transport_trace(&trace, 0, TRANSPORT_TRACE_TX, chunk, sizeof(chunk));
+    model_trace(&m, false, 0, TRANSPORT_TRACE_TX, chunk, sizeof(chunk));
+    CHECK(counters_match(&trace, &m));
+    char path[128];
+    make_path(path, sizeof(path), "none.ttr");
+    CHECK(!transport_trace_dump_file(&trace, path));
+    CHECK(transport_trace_dump_log(&trace, 10) == 0);
+    CHECK(access(path, F_OK) != 0);
+
+    // A file that cannot be created
+    vSemaphoreDelete(trace.lock);
+    CHECK(transport_trace_init(&trace, s_names));
+    make_path(path, sizeof(path), "missing/dir.ttr");
+    esp_log_shim_level = ESP_LOG_NONE;
+    CHECK(!transport_trace_dump_file(&trace, path));
+    esp_log_shim_level = ESP_LOG_WARN;
+
+    // An uninitialised trace takes calls without crashing
+    transport_trace_t zero;
+    memset(&zero, 0, sizeof(zero));
+    zero.level = TRANSPORT_TRACE_RING;
+    transport_trace(&zero, 0, TRANSPORT_TRACE_RX, chunk, sizeof(chunk));
+    transport_trace_clear(&zero);
+    CHECK(transport_trace_dump_log(&zero, 10) == 0);
+    CHECK(!transport_trace_dump_file(&zero, path));
+
+    trace_free(&trace);
+    free(m.records);
+}
+
+// Reader and writers on their own tasks, a dumper walking the ring while they run
+#define TASK_CHUNKS     20000
+
+typedef struct {
+    transport_trace_t *trace;
+    uint8_t channel;
+    transport_trace_dir_t dir;
+    uint32_t seed;
+    uint64_t bytes;
+    uint32_t lines;
+    SemaphoreHandle_t done;
+} tracer_arg_t;
+
+static void tracer_task(void *arg)
+{
+    tracer_arg_t *t = arg;
+    rng_state = t->seed;
+    uint8_t chunk[700];
+    for (int i = 0; i < TASK_CHUNKS; i++) {
+        size_t len = rng_range(1, sizeof(chunk));
+        random_chunk(chunk, len);
+        transport_trace(t->trace, t->channel, t->dir, chunk, len);
+        t->bytes += len;
+        t->lines += count_lines(chunk, len);
+    }
+    xSemaphoreGive(t->done);
+    vTaskDelete(NULL);
+}
+
+// The records between tail and head must chain up exactly
+static bool ring_consistent(transport_trace_t *trace)
+{
+    char path[128];
+    make_path(path, sizeof(path), "walk.ttr");
+    if (!transport_trace_dump_file(trace, path)) {
+        return false;
+    }
+    FILE *f = fopen(path, "rb");
+    transport_trace_file_header_t h;
+    bool ok = f && fread(&h, sizeof(h), 1, f) == 1;
+    for (uint32_t i = 0; ok && i < h.records; i++) {
+        transport_trace_record_t rec;
+        ok = fread(&rec, sizeof(rec), 1, f) == 1 && rec.channel < TRANSPORT_TRACE_CHANNELS &&
+             rec.dir <= TRANSPORT_TRACE_TX && rec.len >= 1 && rec.len <= TRANSPORT_TRACE_CHUNK_MAX &&
+             fseek(f, rec.len, SEEK_CUR) == 0;
+    }
+    ok = ok && fgetc(f) == EOF;
+    if (f) {
+        fclose(f);
+    }
+    unlink(path);
+    return ok;
+}
+
+static void test_tasks(void)
+{
+    transport_trace_t trace;
+    CHECK(transport_trace_init(&trace, s_names));
+    tracer_arg_t args[] = {
+        {.trace = &trace, .channel = 0, .dir = TRANSPORT_TRACE_RX, .seed = 0x1111},
+        {.trace = &trace, .channel = 1, .dir = TRANSPORT_TRACE_RX, .seed = 0x2222},
+        {.trace = &trace, .channel = 1, .dir = TRANSPORT_TRACE_TX, .seed = 0x3333},
+        {.trace = &trace, .channel = 2, .dir = TRANSPORT_TRACE_TX, .seed = 0x4444},
+    };
+    const int n = sizeof(args) / sizeof(args[0]);
+    for (int i = 0; i < n; i++) {
+        args[i].done = xSemaphoreCreateBinary();
+        CHECK(xTaskCreate(tracer_task, "tracer", 4096, &args[i], 5, NULL) == pdPASS);
+    }
+    bool walks_ok = true;
+    int walks = 0;
+    esp_log_shim_level = ESP_LOG_NONE;
+    for (int w = 0; w < 20; w++) {
+        walks_ok = walks_ok && ring_consistent(&trace);
+        transport_trace_dump_log(&trace, 100);
+        walks++;
+    }
+    esp_log_shim_level = ESP_LOG_WARN;
+    for (int i = 0; i < n; i++) {
+        CHECK(xSemaphoreTake(args[i].done, pdMS_TO_TICKS(60 * 1000)) == pdTRUE);
+        vSemaphoreDelete(args[i].done);
+    }
+    CHECK(walks_ok && walks == 20);
+    CHECK(ring_consistent(&trace));
+
+    transport_trace_counters_t want[TRANSPORT_TRACE_CHANNELS];
+    memset(want, 0, sizeof(want));
+    for (int i = 0; i < n; i++) {
+        want[args[i].channel].bytes[args[i].dir] += (uint32_t)args[i].bytes;
+        want[args[i].channel].lines[args[i].dir] += args[i].lines;
+        want[args[i].channel].chunks[args[i].dir] += TASK_CHUNKS;
+    }
+    bool ok = true;
+    for (uint8_t ch = 0; ch < TRANSPORT_TRACE_CHANNELS; ch++) {
+        transport_trace_counters_t c;
+        transport_trace_get_counters(&trace, ch, &c);
+        ok = ok && memcmp(&c, &want[ch], sizeof(c)) == 0;
+    }
+    CHECK(ok);
+    trace_free(&trace);
+}
+
+static int run_functionality(void)
+{
+    test_model();
+    test_levels();
+    test_tasks();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+#define BENCH_CHUNKS    256
+
+static volatile uint64_t s_sink;
+
+// The dump usb_transport_read() formatted for every read, up to the log call
+static void legacy_dump(const uint8_t *data, size_t read_len, char *line, size_t line_size)
+{
+    char hex_buf[128];
+    char ascii_buf[64];
+    size_t log_len = read_len > 32 ? 32 : read_len;
+    for (size_t i = 0; i < log_len; i++) {
+        uint8_t b = data[i];
+        snprintf(hex_buf + i * 3, 4, "%02X ", b);
+        ascii_buf[i] = (b >= 32 && b < 127) ? (char)b : '.';
+    }
+    hex_buf[log_len * 3] = '\0';
+    ascii_buf[log_len] = '\0';
+    snprintf(line, line_size, "I (%lu) %s: [USB] Read %zu bytes: [%s] \"%s\"%s", 12345ul, "tab5", read_len,
+             hex_buf, ascii_buf, read_len > 32 ? "..." : "");
+}
+
+static double bench_trace(transport_trace_t *trace, uint8_t (*chunks)[TRANSPORT_TRACE_CHUNK_MAX], size_t len,
+                          int level)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t n = 0;
+        int64_t start = now_ns();
+        int64_t elapsed;
+        do {
+            for (int i = 0; i < BENCH_CHUNKS; i++) {
+                if (level < 0) {
+                    char line[256];
+                    legacy_dump(chunks[i], len, line, sizeof(line));
+                    s_sink += (uint8_t)line[40];
+                } else {
+                    transport_trace(trace, (uint8_t)(i % TRANSPORT_TRACE_CHANNELS), TRANSPORT_TRACE_RX, chunks[i], len);
+                }
+            }
+            n += BENCH_CHUNKS;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        double ns = (double)elapsed / (double)n;
+        best = r == 0 || ns < best ? ns : best;
+    }
+    return best;
+}
+
+static int run_benchmark(void)
+{
+    static uint8_t chunks[BENCH_CHUNKS][TRANSPORT_TRACE_CHUNK_MAX];
+    for (int i = 0; i < BENCH_CHUNKS; i++) {
+        random_chunk(chunks[i], TRANSPORT_TRACE_CHUNK_MAX);
+    }
+    transport_trace_t trace;
+    if (!transport_trace_init(&trace, s_names)) {
+        printf("FAIL cannot init the trace\n");
+        return EXIT_FAILURE;
+    }
+
+    static const size_t sizes[] = {16, 80, 512};
+    printf("ns per chunk, best of %d\n", BENCH_ROUNDS);
+    printf("%-8s %12s %12s %12s\n", "bytes", "old dump", "counters", "ring");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        double legacy = bench_trace(&trace, chunks, sizes[s], -1);
+        transport_trace_set_level(&trace, TRANSPORT_TRACE_COUNT);
+        double count = bench_trace(&trace, chunks, sizes[s], TRANSPORT_TRACE_COUNT);
+        transport_trace_set_level(&trace, TRANSPORT_TRACE_RING);
+        double ring = bench_trace(&trace, chunks, sizes[s], TRANSPORT_TRACE_RING);
+        printf("%-8zu %12.1f %12.1f %12.1f\n", sizes[s], legacy, count, ring);
+    }
+    bool ok = ring_consistent(&trace);
+    trace_free(&trace);
+    if (!ok) {
+        printf("FAIL the ring does not walk\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    snprintf(s_dir, sizeof(s_dir), "/tmp/test_transport_trace.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    if (system(cmd) != 0) {
+        printf("could not remove %s\n", s_dir);
+    }
+    return rc;
+}
@@ -0,0 +1,673 @@
+/*
+ * Host test and benchmark of the UI command queue (ui_cmd.c) on the pthread FreeRTOS shim and the
+ * headless LVGL display.
+ *
+ * A "taskLVGL" task stands in for esp_lvgl_port's, under the same name: it takes the display mutex, runs lv_timer_handler()
+ * (which drains the queue from ui_cmd's timer), optionally holds the mutex for a simulated render, lets
+ * go and sleeps a tick. Commands record what they saw into a log only the lvgl task writes; a
+ * ui_cmd_call() of an empty command is the barrier after which the test reads it.
+ *
+ *   test_ui_cmd          functionality test: refused before init; a call from the lvgl task before the
+ *                        first drain runs inline; commands run on the lvgl task with the
+ *                        display held, in posting order per poster, with their own copy of the data;
+ *                        invalid posts refused; a full queue drops and counts; ui_cmd_call() returns
+ *                        after its command ran and runs inline on the lvgl task; a drain stops after its
+ *                        slice; slow commands logged; stats
+ *   test_ui_cmd bench    a worker updating the UI while frames render: taking the display lock itself as
+ *                        it used to, against ui_cmd_post() and ui_cmd_call(); the cost of a post
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "lv_host.h"
+#include "lvgl.h"
+#include "test_common.h"
+#include "ui_cmd.h"
+
+#define LOG_MAX             2048
+#define POSTERS             3
+#define POSTS_EACH          300
+#define SLICE_CMDS          10
+#define SLICE_CMD_MS        3
+#define SLOW_CMD_MS         25
+#define BENCH_UPDATES       60
+#define BENCH_RENDER_MS     12      // display held per frame, a full-screen redraw on the Tab5
+#define BENCH_UPDATE_US     300     // the UI work of one update
+#define BENCH_POST_BATCHES  64      // of a queue's worth each; every batch waits a drain period
+
+// ---- simulated LVGL task ----
+
+static SemaphoreHandle_t s_display;
+static TaskHandle_t s_lvgl;
+static TaskHandle_t s_display_holder;
+static SemaphoreHandle_t s_lvgl_stopped;
+static volatile bool s_lvgl_stop;
+static volatile uint32_t s_render_ms;
+static volatile uint32_t s_frame;       // lv_timer_handler() calls so far
+
+static void display_lock(void)
+{
+    xSemaphoreTake(s_display, portMAX_DELAY);
+    s_display_holder = xTaskGetCurrentTaskHandle();
+}
+
+static void display_unlock(void)
+{
+    s_display_holder = NULL;
+    xSemaphoreGive(s_display);
+}
+
+static void lvgl_task(void *arg)
+{
+    (void)arg;
+    while (!s_lvgl_stop) {
+        display_lock();
+        s_frame++;
+        lv_timer_handler();
+        if (s_render_ms) {
+            vTaskDelay(pdMS_TO_TICKS(s_render_ms));
+        }
+        display_unlock();
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(s_lvgl_stopped);
+    vTaskDelete(NULL);
+}
+
+static void lvgl_start(void)
+{
+    s_lvgl_stop = false;
+    xTaskCreate(lvgl_task, "taskLVGL", 8192, NULL, 5, &s_lvgl);
+}
+
+static void lvgl_stop(void)
+{
+    s_lvgl_stop = true;
+    xSemaphoreTake(s_lvgl_stopped, portMAX_DELAY);
+}
+
+// ---- commands ----
+
+typedef struct {
+    uint32_t poster;
+    uint32_t seq;
+    char text[24];
+} entry_t;
+
+typedef struct {
+    entry_t e;
+    uint32_t frame;
+    bool on_lvgl;
+    bool display_held;
+    bool null_data;
+} log_entry_t;
+
+// Written by the lvgl task only; read after a barrier
+static log_entry_t s_log[LOG_MAX];
+static uint32_t s_log_len;
+
+static void log_cmd(void *data)
+{
+    if (s_log_len >= LOG_MAX) {
+        return;
+    }
+    log_entry_t *l = &s_log[s_log_len++];
+    memset(l, 0, sizeof(*l));
+    if (data) {
+        memcpy(&l->e, data, sizeof(l->e));
+    }
+    l->frame = s_frame;
+    l->on_lvgl = xTaskGetCurrentTaskHandle() == s_lvgl;
+    l->display_held = s_display_holder == s_lvgl;
+    l->null_data = data == NULL;
+}
+
+static void noop_cmd(void *data)
+{
+    (void)data;
+}
+
+// Everything posted before has run once this returns
+static void barrier(void)
+{
+    ui_cmd_call(noop_cmd, NULL, 0, portMAX_DELAY);
+}
+
+static void log_reset(void)
+{
+    barrier();
+    s_log_len = 0;
+}
+
+static bool post_entry(uint32_t poster, uint32_t seq, TickType_t wait)
+{
+    entry_t e = { .poster = poster, .seq = seq };
+    snprintf(e.text, sizeof(e.text), "cmd %lu.%lu", (unsigned long)poster, (unsigned long)seq);
+    bool ok = ui_cmd_post(log_cmd, &e, sizeof(e), wait);
+    // The queue holds a copy
+    memset(&e, 0xa5, sizeof(e));
+    return ok;
+}
+
+static bool entry_intact(const entry_t *e)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "cmd %lu.%lu", (unsigned long)e->poster, (unsigned long)e->seq);
+    return memchr(e->text, '\0', sizeof(e->text)) && strcmp(text, e->text) == 0;
+}
+
+// ---- functionality ----
+
+static void test_before_init(void)
+{
+    entry_t e = {0};
+    CHECK(!ui_cmd_post(log_cmd, &e, sizeof(e), 0));
+    CHECK(!ui_cmd_call(log_cmd, &e, sizeof(e), 0));
+    ui_cmd_stats_t st;
+    ui_cmd_get_stats(&st);
+    CHECK(st.posted == 0 && st.dropped == 0);
+}
+
+static void early_call_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    entry_t e = { .poster = 8, .seq = 0 };
+    snprintf(e.text, sizeof(e.text), "cmd 8.0");
+    ui_cmd_call(log_cmd, &e, sizeof(e), portMAX_DELAY);
+}
+
+// The lvgl task is running when ui_cmd starts, as on the Tab5. A timer created after ui_cmd's runs ahead
+// of the first drain; its call must run inline, not queue behind a drain that never comes.
+static void test_init(void)
+{
+    s_log_len = 0;
+    display_lock();
+    CHECK(ui_cmd_init());
+    CHECK(ui_cmd_init());       // a second init keeps the queue
+    CHECK(post_entry(8, 1, 0));
+    lv_timer_t *timer = lv_timer_create(early_call_timer_cb, 0, NULL);
+    lv_timer_set_repeat_count(timer, 1);
+    display_unlock();
+    barrier();
+
+    CHECK(s_log_len == 2);
+    CHECK(s_log[0].e.seq == 0 && s_log[0].on_lvgl && s_log[1].e.seq == 1);
+}
+
+// One poster: order and data copies; commands on the lvgl task with the display held
+static void test_order(void)
+{
+    log_reset();
+    bool posted = true;
+    for (uint32_t i = 0; i < 200; i++) {
+        posted &= post_entry(0, i, portMAX_DELAY);
+    }
+    barrier();
+    CHECK(posted);
+    CHECK(s_log_len == 200);
+    bool in_order = true;
+    bool intact = true;
+    bool context = true;
+    for (uint32_t i = 0; i < s_log_len; i++) {
+        in_order &= s_log[i].e.poster == 0 && s_log[i].e.seq == i;
+        intact &= entry_intact(&s_log[i].e) && !s_log[i].null_data;
+        context &= s_log[i].on_lvgl && s_log[i].display_held;
+    }
+    CHECK(in_order);
+    CHECK(intact);
+    CHECK(context);
+}
+
+static SemaphoreHandle_t s_posters_done;
+
+static void poster_task(void *arg)
+{
+    uint32_t poster = (uint32_t)(uintptr_t)arg;
+    rng_state = 0x9e3779b9u * (poster + 1);
+    for (uint32_t i = 0; i < POSTS_EACH; i++) {
+        post_entry(poster, i, portMAX_DELAY);
+        if (rng_range(0, 7) == 0) {
+            vTaskDelay(1);
+        }
+    }
+    xSemaphoreGive(s_posters_done);
+    vTaskDelete(NULL);
+}
+
+// Several posters at once: nothing lost, each poster's commands in its order
+static void test_posters(void)
+{
+    log_reset();
+    s_posters_done = xSemaphoreCreateCounting(POSTERS, 0);
+    for (uint32_t p = 1; p <= POSTERS; p++) {
+        xTaskCreate(poster_task, "poster", 4096, (void *)(uintptr_t)p, 4, NULL);
+    }
+    for (int p = 0; p < POSTERS; p++) {
+        xSemaphoreTake(s_posters_done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(s_posters_done);
+    barrier();
+
+    CHECK(s_log_len == POSTERS * POSTS_EACH);
+    uint32_t next[POSTERS + 1] = {0};
+    bool in_order = true;
+    bool intact = true;
+    for (uint32_t i = 0; i < s_log_len; i++) {
+        const entry_t *e = &s_log[i].e;
+        bool known = e->poster >= 1 && e->poster <= POSTERS;
+        in_order &= known && e->seq == next[known ? e->poster : 0]++;
+        intact &= entry_intact(e);
+    }
+    CHECK(in_order);
+    CHECK(intact);
+}
+
+// Up to UI_CMD_DATA_MAX bytes copied; nothing posted means NULL data; the rest refused and not counted
+static void test_data(void)
+{
+    log_reset();
+    ui_cmd_stats_t before;
+    ui_cmd_get_stats(&before);
+
+    uint8_t big[UI_CMD_DATA_MAX + 1];
+    for (size_t i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t)i;
+    }
+    entry_t e = { .poster = 9, .seq = 1 };
+    snprintf(e.text, sizeof(e.text), "cmd 9.1");
+    CHECK(ui_cmd_post(log_cmd, &e, 0, 0));
+    CHECK(ui_cmd_post(log_cmd, NULL, 0, 0));
+    CHECK(ui_cmd_post(log_cmd, big, UI_CMD_DATA_MAX, 0));
+    CHECK(!ui_cmd_post(NULL, &e, sizeof(e), 0));
+    CHECK(!ui_cmd_post(log_cmd, big, UI_CMD_DATA_MAX + 1, 0));
+    CHECK(!ui_cmd_post(log_cmd, NULL, sizeof(e), 0));
+    CHECK(!ui_cmd_call(NULL, NULL, 0, 0));
+    CHECK(!ui_cmd_call(log_cmd, big, UI_CMD_DATA_MAX + 1, 0));
+    barrier();
+
+    CHECK(s_log_len == 3);
+    CHECK(s_log[0].null_data && s_log[1].null_data && !s_log[2].null_data);
+    CHECK(memcmp(&s_log[2].e, big, sizeof(entry_t)) == 0);
+
+    ui_cmd_stats_t after;
+    ui_cmd_get_stats(&after);
+    CHECK(after.posted == before.posted + 4);   // the barrier included
+    CHECK(after.dropped == before.dropped);
+}
+
+// The display held elsewhere: the queue fills, posts that won't wait are dropped and counted
+static void test_overflow(void)
+{
+    log_reset();
+    ui_cmd_stats_t before;
+    ui_cmd_get_stats(&before);
+
+    display_lock();
+    bool posted = true;
+    for (uint32_t i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+        posted &= post_entry(0, i, 0);
+    }
+    CHECK(posted);
+    CHECK(!post_entry(0, 100, 0));
+    int64_t start = now_ns();
+    CHECK(!post_entry(0, 101, pdMS_TO_TICKS(20)));
+    CHECK(now_ns() - start >= 19 * 1000000LL);
+    vTaskDelay(pdMS_TO_TICKS(30));
+    display_unlock();
+    barrier();
+
+    CHECK(s_log_len == UI_CMD_QUEUE_LEN);
+    bool in_order = true;
+    for (uint32_t i = 0; i < s_log_len; i++) {
+        in_order &= s_log[i].e.seq == i;
+    }
+    CHECK(in_order);
+
+    ui_cmd_stats_t after;
+    ui_cmd_get_stats(&after);
+    CHECK(after.dropped == before.dropped + 2);
+    CHECK(after.max_depth == UI_CMD_QUEUE_LEN);
+    // The first command waited for the whole hold
+    CHECK(after.max_latency_us >= 50 * 1000);
+}
+
+typedef struct {
+    int *out;
+    int in;
+} square_args_t;
+
+static void square_cmd(void *data)
+{
+    square_args_t *a = data;
+    vTaskDelay(pdMS_TO_TICKS(2));
+    *a->out = a->in * a->in;
+}
+
+// ui_cmd_call() returns once its command has run, whatever was queued before it
+static void test_call(void)
+{
+    log_reset();
+    for (uint32_t i = 0; i < 20; i++) {
+        post_entry(0, i, portMAX_DELAY);
+    }
+    int result = 0;
+    square_args_t a = { .out = &result, .in = 12 };
+    CHECK(ui_cmd_call(square_cmd, &a, sizeof(a), portMAX_DELAY));
+    CHECK(result == 144);
+    CHECK(s_log_len == 20);
+}
+
+static uint32_t s_nested_result;
+
+static void nested_inner_cmd(void *data)
+{
+    log_cmd(data);
+    s_nested_result = 42;
+}
+
+static void nested_outer_cmd(void *data)
+{
+    (void)data;
+    entry_t e = { .poster = 7, .seq = 0 };
+    snprintf(e.text, sizeof(e.text), "cmd 7.0");
+    log_cmd(&e);
+
+    // Posted from the lvgl task: queued behind this command
+    e.seq = 3;
+    snprintf(e.text, sizeof(e.text), "cmd 7.3");
+    ui_cmd_post(log_cmd, &e, sizeof(e), 0);
+
+    // Called from the lvgl task: runs right here instead of waiting on itself
+    s_nested_result = 0;
+    e.seq = 1;
+    snprintf(e.text, sizeof(e.text), "cmd 7.1");
+    bool called = ui_cmd_call(nested_inner_cmd, &e, sizeof(e), portMAX_DELAY);
+    bool refused = !ui_cmd_call(NULL, NULL, 0, 0);
+
+    e.seq = called && refused && s_nested_result == 42 ? 2 : 99;
+    snprintf(e.text, sizeof(e.text), "cmd 7.%lu", (unsigned long)e.seq);
+    log_cmd(&e);
+}
+
+static void test_nested_call(void)
+{
+    log_reset();
+    CHECK(ui_cmd_post(nested_outer_cmd, NULL, 0, portMAX_DELAY));
+    barrier();
+    CHECK(s_log_len == 4);
+    bool in_order = true;
+    for (uint32_t i = 0; i < s_log_len; i++) {
+        in_order &= s_log[i].e.poster == 7 && s_log[i].e.seq == i && entry_intact(&s_log[i].e);
+    }
+    CHECK(in_order);
+}
+
+static void slice_cmd(void *data)
+{
+    log_cmd(data);
+    int64_t end = now_ns() + SLICE_CMD_MS * 1000000LL;
+    while (now_ns() < end) {
+    }
+}
+
+// A drain stops once its slice is used up; the rest run on later frames
+static void test_slice(void)
+{
+    log_reset();
+    display_lock();
+    for (uint32_t i = 0; i < SLICE_CMDS; i++) {
+        entry_t e = { .poster = 0, .seq = i };
+        snprintf(e.text, sizeof(e.text), "cmd 0.%lu", (unsigned long)i);
+        ui_cmd_post(slice_cmd, &e, sizeof(e), 0);
+    }
+    display_unlock();
+    barrier();
+
+    CHECK(s_log_len == SLICE_CMDS);
+    uint32_t per_frame_max = 0;
+    uint32_t frames = 0;
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < s_log_len; i++) {
+        run = i > 0 && s_log[i].frame == s_log[i - 1].frame ? run + 1 : 1;
+        frames += run == 1;
+        per_frame_max = run > per_frame_max ? run : per_frame_max;
+    }
+    // A drain stops after the first command to end past its slice
+    uint32_t slice_cmds = (UI_CMD_SLICE_US / 1000 + SLICE_CMD_MS - 1) / SLICE_CMD_MS;
+    CHECK(per_frame_max >= 1 && per_frame_max <= slice_cmds);
+    CHECK(frames >= (SLICE_CMDS + slice_cmds - 1) / slice_cmds);
+}
+
+static void slow_cmd(void *data)
+{
+    (void)data;
+    vTaskDelay(pdMS_TO_TICKS(SLOW_CMD_MS));
+}
+
+// A command longer than UI_CMD_SLOW_US is logged with its address; a fast one isn't
+static void test_slow(void)
+{
+    barrier();
+    FILE *f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) {
+        return;
+    }
+    fflush(stderr);
+    int saved = dup(2);
+    dup2(fileno(f), 2);
+    esp_log_shim_level = ESP_LOG_INFO;
+    ui_cmd_post(slow_cmd, NULL, 0, portMAX_DELAY);
+    ui_cmd_post(noop_cmd, NULL, 0, portMAX_DELAY);
+    barrier();
+    esp_log_shim_level = ESP_LOG_NONE;
+    fflush(stderr);
+    dup2(saved, 2);
+    close(saved);
+    rewind(f);
+
+    char line[256];
+    int lines = 0;
+    bool slow_logged = false;
+    while (fgets(line, sizeof(line), f)) {
+        lines++;
+        void *fn = NULL;
+        unsigned long ms = 0;
+        if (sscanf(line, "W (ui_cmd) Command %p ran %lu ms on the LVGL task", &fn, &ms) == 2) {
+            slow_logged = fn == (void *)slow_cmd && ms >= SLOW_CMD_MS;
+        }
+    }
+    fclose(f);
+    CHECK(lines == 1);
+    CHECK(slow_logged);
+
+    ui_cmd_stats_t st;
+    ui_cmd_get_stats(&st);
+    CHECK(st.max_run_us >= SLOW_CMD_MS * 1000);
+}
+
+static void test_stats(void)
+{
+    barrier();
+    ui_cmd_stats_t st;
+    ui_cmd_get_stats(&st);
+    // Everything queued has run; the pushes that found the queue full are the only drops
+    CHECK(st.posted == st.run);
+    CHECK(st.dropped == 2);
+}
+
+static int run_functionality(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    s_display = xSemaphoreCreateMutex();
+    s_lvgl_stopped = xSemaphoreCreateBinary();
+
+    test_before_init();
+
+    lv_host_init(720, 1280);
+    lvgl_start();
+
+    test_init();
+    test_order();
+    test_posters();
+    test_data();
+    test_overflow();
+    test_call();
+    test_nested_call();
+    test_slice();
+    test_slow();
+    test_stats();
+
+    lvgl_stop();
+    lv_host_deinit();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+typedef struct {
+    int64_t requested_ns;
+    int64_t *applied_ns;
+} bench_update_t;
+
+static void bench_update(void *data)
+{
+    bench_update_t *u = data;
+    int64_t end = now_ns() + BENCH_UPDATE_US * 1000LL;
+    while (now_ns() < end) {
+    }
+    *u->applied_ns = now_ns() - u->requested_ns;
+}
+
+typedef enum {
+    BENCH_LOCK,
+    BENCH_POST,
+    BENCH_CALL,
+} bench_mode_t;
+
+static const char *const s_mode_names[] = { "display lock", "ui_cmd_post", "ui_cmd_call" };
+
+typedef struct {
+    bench_mode_t mode;
+    int64_t blocked_ns[BENCH_UPDATES];
+    int64_t applied_ns[BENCH_UPDATES];
+    SemaphoreHandle_t done;
+} bench_worker_t;
+
+static void bench_worker_task(void *arg)
+{
+    bench_worker_t *w = arg;
+    rng_state = 0x2545f491;
+    for (int i = 0; i < BENCH_UPDATES; i++) {
+        vTaskDelay(pdMS_TO_TICKS(rng_range(0, 20)));
+        bench_update_t u = { .requested_ns = now_ns(), .applied_ns = &w->applied_ns[i] };
+        switch (w->mode) {
+        case BENCH_LOCK:
+            // Before: the worker took the display lock and updated the widgets itself
+            display_lock();
+            bench_update(&u);
+            display_unlock();
+            break;
+        case BENCH_POST:
+            ui_cmd_post(bench_update, &u, sizeof(u), portMAX_DELAY);
+            break;
+        case BENCH_CALL:
+            ui_cmd_call(bench_update, &u, sizeof(u), portMAX_DELAY);
+            break;
+        }
+        w->blocked_ns[i] = now_ns() - u.requested_ns;
+    }
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_row(const char *name, int64_t *ns)
+{
+    qsort(ns, BENCH_UPDATES, sizeof(ns[0]), cmp_i64);
+    int64_t sum = 0;
+    for (int i = 0; i < BENCH_UPDATES; i++) {
+        sum += ns[i];
+    }
+    printf("  %-14s avg %8.3f ms   p50 %8.3f ms   max %8.3f ms\n", name, (double)sum / BENCH_UPDATES / 1e6,
+           (double)ns[BENCH_UPDATES / 2] / 1e6, (double)ns[BENCH_UPDATES - 1] / 1e6);
+}
+
+static int run_benchmark(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    s_display = xSemaphoreCreateMutex();
+    s_lvgl_stopped = xSemaphoreCreateBinary();
+    lv_host_init(720, 1280);
+    lvgl_start();
+    display_lock();
+    ui_cmd_init();
+    display_unlock();
+
+    s_render_ms = BENCH_RENDER_MS;
+    printf("Worker updating the UI %d times, 0-20 ms apart, %d us of UI work each, while the LVGL task holds\n"
+           "the display %d ms per frame\n", BENCH_UPDATES, BENCH_UPDATE_US, BENCH_RENDER_MS);
+    static bench_worker_t w;
+    for (int mode = BENCH_LOCK; mode <= BENCH_CALL; mode++) {
+        memset(&w, 0, sizeof(w));
+        w.mode = (bench_mode_t)mode;
+        w.done = xSemaphoreCreateBinary();
+        xTaskCreate(bench_worker_task, "worker", 4096, &w, 4, NULL);
+        xSemaphoreTake(w.done, portMAX_DELAY);
+        vSemaphoreDelete(w.done);
+        barrier();
+        printf("%s\n", s_mode_names[mode]);
+        print_row("worker blocked", w.blocked_ns);
+        print_row("update applied", w.applied_ns);
+    }
+    s_render_ms = 0;
+
+    // The poster's side of ui_cmd_post(): the display held so nothing drains while timing
+    int64_t best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int64_t total = 0;
+        int64_t posts = 0;
+        int64_t applied;
+        bench_update_t u = { .applied_ns = &applied };
+        for (int b = 0; b < BENCH_POST_BATCHES; b++) {
+            display_lock();
+            int64_t start = now_ns();
+            for (int i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+                ui_cmd_post(noop_cmd, &u, sizeof(u), 0);
+            }
+            total += now_ns() - start;
+            posts += UI_CMD_QUEUE_LEN;
+            display_unlock();
+            barrier();
+        }
+        int64_t per_post = total / posts;
+        best = r == 0 || per_post < best ? per_post : best;
+    }
+    printf("ui_cmd_post, %u-byte arguments: %lld ns\n", (unsigned)sizeof(bench_update_t), (long long)best);
+
+    lvgl_stop();
+    lv_host_deinit();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
@@ -0,0 +1,508 @@
+/*
+ * Host test and benchmark of the USB CDC receive wait (usb_rx_wait.c), on the pthread FreeRTOS shim.
+ *
+ * A fake CDC driver keeps the received bytes in a ring and wakes the wait after each transfer, as main.c's
+ * receive callback does for iot_usbh_cdc on the USB host client task.
+ *
+ *   test_usb_rx_wait          functionality test: a random packet stream arrives complete and in order;
+ *                             data wakes a waiting read, silence times it out on time, a stale signal
+ *                             does not end a wait early, a disconnect ends it at once and a connect wakes
+ *                             the reader's no-device wait; without the signal the read still works
+ *   test_usb_rx_wait bench    ping->pong latency and the time to a complete scan dump, with the sleep-poll
+ *                             loop the reader used before against the signalled wait
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "usb_rx_wait.h"
+#include "test_common.h"
+
+#define FAKE_RING_SIZE      16384   // the driver's RX ring
+#define RX_TIMEOUT_MS       100     // what the transport reader passes while rx_demux waits for lines
+#define LATE_MS             30      // slack for a loaded host before a wake counts as late
+
+// The CDC driver: a byte ring that the USB host client task fills
+typedef struct fake_cdc {
+    pthread_mutex_t lock;
+    uint8_t ring[FAKE_RING_SIZE];
+    size_t head;
+    size_t used;
+    size_t dropped;
+} fake_cdc_t;
+
+typedef fake_cdc_t *usbh_cdc_handle_t;
+
+static fake_cdc_t s_cdc = {.lock = PTHREAD_MUTEX_INITIALIZER};
+static usbh_cdc_handle_t usb_cdc_handle;
+static volatile bool usb_cdc_connected;
+
+static esp_err_t usbh_cdc_get_rx_buffer_size(usbh_cdc_handle_t cdc, size_t *size)
+{
+    pthread_mutex_lock(&cdc->lock);
+    *size = cdc->used;
+    pthread_mutex_unlock(&cdc->lock);
+    return ESP_OK;
+}
+
+static esp_err_t usbh_cdc_read_bytes(usbh_cdc_handle_t cdc, uint8_t *buf, size_t *length, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    pthread_mutex_lock(&cdc->lock);
+    size_t n = *length < cdc->used ? *length : cdc->used;
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = cdc->ring[(cdc->head + i) % FAKE_RING_SIZE];
+    }
+    cdc->head = (cdc->head + n) % FAKE_RING_SIZE;
+    cdc->used -= n;
+    pthread_mutex_unlock(&cdc->lock);
+    *length = n;
+    return n ? ESP_OK : ESP_FAIL;
+}
+
+// The fake behind usb_rx_wait, as main.c puts iot_usbh_cdc behind it
+static bool fake_connected(void *ctx)
+{
+    (void)ctx;
+    return usb_cdc_handle && usb_cdc_connected;
+}
+
+static esp_err_t fake_rx_size(void *ctx, size_t *size)
+{
+    (void)ctx;
+    return usbh_cdc_get_rx_buffer_size(usb_cdc_handle, size);
+}
+
+static esp_err_t fake_read(void *ctx, uint8_t *buf, size_t *len)
+{
+    (void)ctx;
+    return usbh_cdc_read_bytes(usb_cdc_handle, buf, len, 0);
+}
+
+static const usb_rx_cdc_t s_fake_cdc = {
+    .connected = fake_connected,
+    .rx_size = fake_rx_size,
+    .read = fake_read,
+};
+
+static usb_rx_wait_t s_rx = {.cdc = &s_fake_cdc};
+
+static int usb_transport_read(void *data, size_t len, TickType_t ticks_to_wait)
+{
+    return usb_rx_wait_read(&s_rx, data, len, ticks_to_wait);
+}
+
+static int transport_rx_read_usb(uint8_t *dst, size_t len, uint32_t timeout)
+{
+    return usb_rx_wait_reader_read(&s_rx, dst, len, (TickType_t)timeout);
+}
+
+// The loop usb_transport_read() had before: an empty ring slept the whole timeout
+static int legacy_usb_transport_read(void *data, size_t len, TickType_t ticks_to_wait)
+{
+    if (!usb_cdc_handle || !usb_cdc_connected) {
+        return 0;
+    }
+    size_t rx_size = 0;
+    esp_err_t rx_err = usbh_cdc_get_rx_buffer_size(usb_cdc_handle, &rx_size);
+    if (rx_err == ESP_OK && rx_size == 0) {
+        if (ticks_to_wait > 0) {
+            vTaskDelay(ticks_to_wait);
+            rx_err = usbh_cdc_get_rx_buffer_size(usb_cdc_handle, &rx_size);
+        }
+        if (rx_err == ESP_OK && rx_size == 0) {
+            return 0;
+        }
+    }
+    size_t read_len = len;
+    if (usbh_cdc_read_bytes(usb_cdc_handle, (uint8_t *)data, &read_len, 0) != ESP_OK) {
+        return 0;
+    }
+    return (int)read_len;
+}
+
+typedef int (*read_fn_t)(void *data, size_t len, TickType_t ticks_to_wait);
+
+// One IN transfer: into the ring, then the receive callback
+static void device_send(const void *data, size_t len)
+{
+    pthread_mutex_lock(&s_cdc.lock);
+    size_t room = FAKE_RING_SIZE - s_cdc.used;
+    size_t n = len < room ? len : room;
+    for (size_t i = 0; i < n; i++) {
+        s_cdc.ring[(s_cdc.head + s_cdc.used + i) % FAKE_RING_SIZE] = ((const uint8_t *)data)[i];
+    }
+    s_cdc.used += n;
+    s_cdc.dropped += len - n;
+    pthread_mutex_unlock(&s_cdc.lock);
+    usb_rx_wait_notify(&s_rx);
+}
+
+static size_t device_room(void)
+{
+    pthread_mutex_lock(&s_cdc.lock);
+    size_t room = FAKE_RING_SIZE - s_cdc.used;
+    pthread_mutex_unlock(&s_cdc.lock);
+    return room;
+}
+
+static void device_connect(bool connected)
+{
+    usb_cdc_handle = connected ? &s_cdc : NULL;
+    usb_cdc_connected = connected;
+    usb_rx_wait_notify(&s_rx);
+}
+
+static void device_reset(void)
+{
+    pthread_mutex_lock(&s_cdc.lock);
+    s_cdc.head = 0;
+    s_cdc.used = 0;
+    s_cdc.dropped = 0;
+    pthread_mutex_unlock(&s_cdc.lock);
+    device_connect(true);
+    // Start without a pending signal
+    xSemaphoreTake(s_rx.signal, 0);
+}
+
+static int64_t elapsed_ms(int64_t start_ns)
+{
+    return (now_ns() - start_ns) / 1000000;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// ---- functionality ----
+
+#define STREAM_PACKETS      3000
+#define STREAM_MAX_PACKET   512
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    volatile bool done;
+} stream_t;
+
+// Bulk transfers of random size with random gaps, as a board printing scan results
+static void stream_task(void *arg)
+{
+    stream_t *s = arg;
+    size_t off = 0;
+    for (int i = 0; i < STREAM_PACKETS && off < s->len; i++) {
+        size_t n = rng_range(1, STREAM_MAX_PACKET);
+        n = n < s->len - off ? n : s->len - off;
+        // The driver stops fetching while its ring is full; the test must not lose bytes to overflow
+        while (device_room() < n) {
+            sleep_ms(1);
+        }
+        device_send(s->data + off, n);
+        off += n;
+        if (rng() % 4 == 0) {
+            sleep_ms(rng_range(0, 3));
+        }
+    }
+    s->done = true;
+    vTaskDelete(NULL);
+}
+
+static void test_stream(void)
+{
+    stream_t s = {.len = (size_t)STREAM_PACKETS * STREAM_MAX_PACKET / 4};
+    s.data = malloc(s.len);
+    uint8_t *got = malloc(s.len);
+    for (size_t i = 0; i < s.len; i++) {
+        s.data[i] = (uint8_t)rng();
+    }
+    device_reset();
+    CHECK(xTaskCreate(stream_task, "device", 4096, &s, 5, NULL) == pdPASS);
+
+    size_t off = 0;
+    bool sizes_ok = true;
+    int64_t start = now_ns();
+    while (off < s.len && elapsed_ms(start) < 20000) {
+        size_t want = rng_range(1, 1024);
+        want = want < s.len - off ? want : s.len - off;
+        int n = transport_rx_read_usb(got + off, want, RX_TIMEOUT_MS);
+        sizes_ok = sizes_ok && n >= 0 && (size_t)n <= want;
+        off += n > 0 ? (size_t)n : 0;
+    }
+    CHECK(sizes_ok);
+    while (!s.done) {
+        sleep_ms(1);
+    }
+    CHECK(off == s.len);
+    CHECK(memcmp(got, s.data, s.len) == 0);
+    CHECK(s_cdc.dropped == 0);
+    free(s.data);
+    free(got);
+}
+
+typedef struct {
+    uint32_t delay_ms;
+    const char *data;
+    int action;     // 0 send data, 1 disconnect, 2 connect, 3 signal only
+} delayed_t;
+
+static void delayed_task(void *arg)
+{
+    delayed_t *d = arg;
+    sleep_ms(d->delay_ms);
+    if (d->action == 0) {
+        device_send(d->data, strlen(d->data));
+    } else if (d->action == 3) {
+        usb_rx_wait_notify(&s_rx);
+    } else {
+        device_connect(d->action == 2);
+    }
+    vTaskDelete(NULL);
+}
+
+static void after(delayed_t *d)
+{
+    CHECK(xTaskCreate(delayed_task, "after", 4096, d, 5, NULL) == pdPASS);
+}
+
+static void test_wakes(void)
+{
+    char buf[64];
+
+    // Data that arrives during the wait ends it
+    device_reset();
+    delayed_t pong = {.delay_ms = 5, .data = "pong baud=3000000\n"};
+    after(&pong);
+    int64_t start = now_ns();
+    int n = usb_transport_read(buf, sizeof(buf), RX_TIMEOUT_MS);
+    int64_t took = elapsed_ms(start);
+    CHECK(n == (int)strlen(pong.data) && memcmp(buf, pong.data, (size_t)n) == 0);
+    CHECK(took >= 4 && took < 5 + LATE_MS);
+
+    // Silence runs the full timeout, no less
+    sleep_ms(2);
+    start = now_ns();
+    CHECK(usb_transport_read(buf, sizeof(buf), RX_TIMEOUT_MS) == 0);
+    took = elapsed_ms(start);
+    CHECK(took >= RX_TIMEOUT_MS - 1 && took < RX_TIMEOUT_MS + LATE_MS);
+
+    // No timeout, no wait
+    start = now_ns();
+    CHECK(usb_transport_read(buf, sizeof(buf), 0) == 0);
+    CHECK(elapsed_ms(start) < LATE_MS);
+
+    // Bytes already in the ring need no signal
+    device_send("abc", 3);
+    xSemaphoreTake(s_rx.signal, 0);
+    CHECK(usb_transport_read(buf, sizeof(buf), 0) == 3 && memcmp(buf, "abc", 3) == 0);
+
+    // A stale signal: the data that gave it was read without waiting. The next wait takes the signal,
+    // finds the ring empty and goes on waiting; data 40 ms later still wakes it.
+    device_send("x", 1);
+    CHECK(usb_transport_read(buf, 1, 0) == 1);
+    CHECK(uxSemaphoreGetCount(s_rx.signal) == 1);
+    delayed_t late = {.delay_ms = 40, .data = "late\n"};
+    after(&late);
+    start = now_ns();
+    n = usb_transport_read(buf, sizeof(buf), RX_TIMEOUT_MS);
+    took = elapsed_ms(start);
+    CHECK(n == 5 && memcmp(buf, "late\n", 5) == 0);
+    CHECK(took >= 39 && took < 40 + LATE_MS);
+
+    // A signal without data (a transfer someone else emptied) does not end the read early
+    delayed_t spurious = {.delay_ms = 10, .action = 3};
+    after(&spurious);
+    start = now_ns();
+    CHECK(usb_transport_read(buf, sizeof(buf), RX_TIMEOUT_MS) == 0);
+    took = elapsed_ms(start);
+    CHECK(took >= RX_TIMEOUT_MS - 1 && took < RX_TIMEOUT_MS + LATE_MS);
+
+    // A disconnect ends the wait at once
+    sleep_ms(2);
+    delayed_t unplug = {.delay_ms = 10, .action = 1};
+    after(&unplug);
+    start = now_ns();
+    CHECK(usb_transport_read(buf, sizeof(buf), RX_TIMEOUT_MS) == 0);
+    took = elapsed_ms(start);
+    CHECK(took >= 9 && took < 10 + LATE_MS);
+    sleep_ms(2);
+
+    // With no device, the reader's wait ends when one connects, then reads normally
+    xSemaphoreTake(s_rx.signal, 0);
+    delayed_t plug = {.delay_ms = 15, .action = 2};
+    after(&plug);
+    start = now_ns();
+    CHECK(transport_rx_read_usb((uint8_t *)buf, sizeof(buf), RX_TIMEOUT_MS) == 0);
+    took = elapsed_ms(start);
+    CHECK(took >= 14 && took < 15 + LATE_MS);
+    CHECK(usb_cdc_connected);
+    device_send("hello\n", 6);
+    CHECK(transport_rx_read_usb((uint8_t *)buf, sizeof(buf), RX_TIMEOUT_MS) == 6);
+
+    // Without a device and without data, the reader's wait lasts the timeout
+    device_connect(false);
+    xSemaphoreTake(s_rx.signal, 0);
+    start = now_ns();
+    CHECK(transport_rx_read_usb((uint8_t *)buf, sizeof(buf), 20) == 0);
+    took = elapsed_ms(start);
+    CHECK(took >= 19 && took < 20 + LATE_MS);
+}
+
+// Before usb_rx_wait_start() creates the signal, waits fall back to sleeping in slices
+static void test_no_signal(void)
+{
+    SemaphoreHandle_t signal = s_rx.signal;
+    char buf[16];
+
+    device_reset();
+    s_rx.signal = NULL;
+    int64_t start = now_ns();
+    CHECK(usb_transport_read(buf, sizeof(buf), 20) == 0);
+    int64_t took = elapsed_ms(start);
+    CHECK(took >= 19 && took < 20 + LATE_MS);
+    device_send("ok\n", 3);
+    CHECK(usb_transport_read(buf, sizeof(buf), 20) == 3);
+    s_rx.signal = signal;
+}
+
+static int run_functionality(void)
+{
+    CHECK(usb_rx_wait_start(&s_rx));
+    SemaphoreHandle_t signal = s_rx.signal;
+    CHECK(usb_rx_wait_start(&s_rx) && s_rx.signal == signal);
+    test_stream();
+    test_wakes();
+    test_no_signal();
+    device_connect(false);
+    return test_result();
+}
+
+// ---- benchmark ----
+
+#define BENCH_PINGS         40
+#define BENCH_DUMPS         8
+#define PONG_DELAY_MS       1
+#define DUMP_SILENCE_MS     236
+#define DUMP_PACKETS        10
+#define DUMP_PACKET_BYTES   400
+#define DUMP_GAP_MS         2
+
+// The transport reader: reads until stopped and notes when the bytes it waits for have all arrived
+typedef struct {
+    read_fn_t read;
+    atomic_bool stop;
+    atomic_llong received;
+    atomic_llong done_ns;
+    atomic_llong target;
+    volatile bool exited;
+} bench_reader_t;
+
+static void bench_reader_task(void *arg)
+{
+    bench_reader_t *r = arg;
+    uint8_t buf[512];
+    while (!atomic_load(&r->stop)) {
+        int n = r->read(buf, sizeof(buf), RX_TIMEOUT_MS);
+        if (n > 0) {
+            long long total = atomic_fetch_add(&r->received, n) + n;
+            if (total >= atomic_load(&r->target) && atomic_load(&r->done_ns) == 0) {
+                atomic_store(&r->done_ns, now_ns());
+            }
+        }
+    }
+    r->exited = true;
+    vTaskDelete(NULL);
+}
+
+// Arm the reader for the next total byte count; returns the start time
+static int64_t bench_arm(bench_reader_t *r, long long bytes)
+{
+    atomic_store(&r->done_ns, 0);
+    atomic_store(&r->target, atomic_load(&r->received) + bytes);
+    return now_ns();
+}
+
+static int64_t bench_wait_done(bench_reader_t *r)
+{
+    while (atomic_load(&r->done_ns) == 0) {
+        sleep_ms(1);
+    }
+    return atomic_load(&r->done_ns);
+}
+
+static void bench_loop(const char *name, read_fn_t read)
+{
+    bench_reader_t r = {.read = read};
+    device_reset();
+    xTaskCreate(bench_reader_task, "reader", 4096, &r, 5, NULL);
+
+    // Ping at a random point of the reader's wait; the board answers 1 ms later
+    double ping_sum = 0;
+    double ping_worst = 0;
+    for (int i = 0; i < BENCH_PINGS; i++) {
+        sleep_ms(rng_range(1, RX_TIMEOUT_MS));
+        int64_t start = bench_arm(&r, 5);
+        sleep_ms(PONG_DELAY_MS);
+        device_send("pong\n", 5);
+        double ms = (double)(bench_wait_done(&r) - start) / 1e6;
+        ping_sum += ms;
+        ping_worst = ms > ping_worst ? ms : ping_worst;
+    }
+
+    // A scan dump: silence while the board scans, then the results in quick bulk transfers
+    static uint8_t packet[DUMP_PACKET_BYTES];
+    memset(packet, 'n', sizeof(packet));
+    double dump_sum = 0;
+    double dump_worst = 0;
+    for (int i = 0; i < BENCH_DUMPS; i++) {
+        sleep_ms(rng_range(1, RX_TIMEOUT_MS));
+        int64_t start = bench_arm(&r, DUMP_PACKETS * DUMP_PACKET_BYTES);
+        sleep_ms(DUMP_SILENCE_MS);
+        for (int p = 0; p < DUMP_PACKETS; p++) {
+            if (p) {
+                sleep_ms(DUMP_GAP_MS);
+            }
+            device_send(packet, sizeof(packet));
+        }
+        double ms = (double)(bench_wait_done(&r) - start) / 1e6;
+        dump_sum += ms;
+        dump_worst = ms > dump_worst ? ms : dump_worst;
+    }
+
+    atomic_store(&r.stop, true);
+    device_send("", 0);
+    while (!r.exited) {
+        sleep_ms(1);
+    }
+    printf("%-12s %10.1f %10.1f %10.1f %10.1f\n", name, ping_sum / BENCH_PINGS, ping_worst, dump_sum / BENCH_DUMPS,
+           dump_worst);
+}
+
+static int run_benchmark(void)
+{
+    usb_rx_wait_start(&s_rx);
+    printf("%d pings (pong after %d ms), %d scan dumps (%d ms silence, %d x %d B, %d ms apart; floor %d ms)\n",
+           BENCH_PINGS, PONG_DELAY_MS, BENCH_DUMPS, DUMP_SILENCE_MS, DUMP_PACKETS, DUMP_PACKET_BYTES, DUMP_GAP_MS,
+           DUMP_SILENCE_MS + (DUMP_PACKETS - 1) * DUMP_GAP_MS);
+    printf("%-12s %10s %10s %10s %10s\n", "read", "ping avg", "ping max", "dump avg", "dump max");
+    bench_loop("sleep-poll", legacy_usb_transport_read);
+    bench_loop("signalled", usb_transport_read);
+    device_connect(false);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+    return run_functionality();
+}
@@ -0,0 +1,332 @@
+/*
+ * Host test of the recycled-row virtual list (ui_components.c) on LVGL 9 with a headless 720x1280 display.
+ *
+ *   test_vlist          functionality test: the row pool depends on the viewport only, rows sit at
+ *                       index * pitch and show their own item while the list scrolls, grows and shrinks,
+ *                       ui_comp_vlist_row_index() maps a row's children back to the item, and an update
+ *                       after the first bind doesn't grow the heap
+ *   test_vlist bench    update time, heap churn and object count at 50, 500 and 5000 items against
+ *                       cleaning the list and creating a row per item, as the tables did before
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lv_host.h"
+#include "ui_components.h"
+#include "ui_theme.h"
+#include "test_common.h"
+
+#define ROW_HEIGHT      64
+#define ROW_GAP         10
+#define ROW_PITCH       (ROW_HEIGHT + ROW_GAP)
+#define LIST_HEIGHT     1000
+#define MAX_ITEMS       5000
+#define BENCH_SLOW_NS   (1000 * 1000 * 1000LL)  // updates slower than this are timed once
+
+typedef struct {
+    char ssid[16];
+    char info[40];
+    char rssi[12];
+} item_t;
+
+// Two data sets, so the benchmark can alternate between them without regenerating one
+static item_t s_data[2][MAX_ITEMS];
+static item_t *s_items = s_data[0];
+static uint32_t s_item_count;
+
+// Same text lengths every round, so rebinding never needs a bigger label buffer
+static void fill_items(uint32_t count, uint32_t round)
+{
+    s_items = s_data[round & 1];
+    for (uint32_t i = 0; i < count; i++) {
+        item_t *it = &s_items[i];
+        snprintf(it->ssid, sizeof(it->ssid), "net-%05u", (unsigned)i);
+        snprintf(it->info, sizeof(it->info), "02:11:22:%02X:%02X:%02X  2.4 GHz  WPA2",
+                 (unsigned)(i >> 16) & 0xFF, (unsigned)(i >> 8) & 0xFF, (unsigned)i & 0xFF);
+        snprintf(it->rssi, sizeof(it->rssi), "-%02u dBm", (unsigned)(30 + (i * 7 + round) % 60));
+    }
+    s_item_count = count;
+}
+
+// A scan row: checkbox, SSID and info labels in a column, RSSI chip
+static void row_create_cb(lv_obj_t *item, void *user_data)
+{
+    (void)user_data;
+    ui_theme_apply_list_row(item);
+    lv_obj_set_flex_flow(item, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(item, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(item, 10, 0);
+    lv_obj_set_scrollbar_mode(item, LV_SCROLLBAR_MODE_OFF);
+
+    lv_obj_t *cb = lv_checkbox_create(item);
+    lv_checkbox_set_text(cb, "");
+    lv_obj_set_size(cb, 48, 48);
+
+    lv_obj_t *text_cont = lv_obj_create(item);
+    lv_obj_set_size(text_cont, 0, LV_SIZE_CONTENT);
+    lv_obj_set_flex_grow(text_cont, 1);
+    lv_obj_set_style_bg_opa(text_cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(text_cont, 0, 0);
+    lv_obj_set_style_pad_all(text_cont, 0, 0);
+    lv_obj_set_flex_flow(text_cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_clear_flag(text_cont, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *ssid_label = lv_label_create(text_cont);
+    lv_obj_set_style_text_font(ssid_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_width(ssid_label, lv_pct(100));
+    lv_label_set_long_mode(ssid_label, LV_LABEL_LONG_DOT);
+
+    lv_obj_t *info_label = lv_label_create(text_cont);
+    lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_width(info_label, lv_pct(100));
+    lv_label_set_long_mode(info_label, LV_LABEL_LONG_DOT);
+
+    lv_obj_t *rssi_chip = lv_obj_create(item);
+    ui_theme_apply_chip(rssi_chip, ui_theme_color(UI_COLOR_TEXT_MUTED));
+    lv_obj_set_width(rssi_chip, 110);
+    lv_obj_clear_flag(rssi_chip, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *rssi_label = lv_label_create(rssi_chip);
+    lv_obj_set_style_text_font(rssi_label, &lv_font_montserrat_12, 0);
+    lv_obj_center(rssi_label);
+}
+
+#define ROW_OBJECTS     7
+
+static void row_bind_cb(lv_obj_t *item, uint32_t index, void *user_data)
+{
+    (void)user_data;
+    if (index >= s_item_count) {
+        return;
+    }
+    const item_t *it = &s_items[index];
+    lv_obj_t *text_cont = lv_obj_get_child(item, 1);
+    lv_obj_t *rssi_chip = lv_obj_get_child(item, 2);
+    ui_comp_patch_label_text(lv_obj_get_child(text_cont, 0), it->ssid);
+    ui_comp_patch_label_text(lv_obj_get_child(text_cont, 1), it->info);
+    ui_comp_patch_label_text(lv_obj_get_child(rssi_chip, 0), it->rssi);
+}
+
+static lv_obj_t *create_list(void)
+{
+    lv_obj_t *list = ui_comp_create_vlist(lv_screen_active(), ROW_HEIGHT, ROW_GAP, row_create_cb, row_bind_cb, NULL);
+    lv_obj_set_size(list, lv_pct(100), LIST_HEIGHT);
+    lv_obj_set_style_pad_all(list, 0, 0);
+    lv_obj_set_style_border_width(list, 0, 0);
+    lv_obj_update_layout(list);
+    return list;
+}
+
+static const char *row_ssid(lv_obj_t *row)
+{
+    return lv_label_get_text(lv_obj_get_child(lv_obj_get_child(row, 1), 0));
+}
+
+// Every item in the viewport has exactly one visible row, at its position and showing its data
+static void check_visible_rows(lv_obj_t *list)
+{
+    int32_t scroll_y = lv_obj_get_scroll_y(list);
+    uint32_t first = (uint32_t)(scroll_y / ROW_PITCH);
+    uint32_t last = (uint32_t)((scroll_y + LIST_HEIGHT - 1) / ROW_PITCH) + 1;
+    if (last > s_item_count) {
+        last = s_item_count;
+    }
+
+    static uint8_t seen[MAX_ITEMS];
+    memset(seen, 0, sizeof(seen));
+    bool rows_ok = true;
+    uint32_t children = lv_obj_get_child_count(list);
+    for (uint32_t i = 0; i < children; i++) {
+        lv_obj_t *row = lv_obj_get_child(list, (int32_t)i);
+        if (lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN) || lv_obj_get_child_count(row) == 0) {
+            continue;
+        }
+        int32_t index = ui_comp_vlist_row_index(row);
+        if (index < 0 || (uint32_t)index >= s_item_count) {
+            rows_ok = false;
+            continue;
+        }
+        seen[index]++;
+        rows_ok &= lv_obj_get_y(row) == index * ROW_PITCH;
+        rows_ok &= strcmp(row_ssid(row), s_items[index].ssid) == 0;
+        rows_ok &= ui_comp_vlist_row_index(lv_obj_get_child(lv_obj_get_child(row, 1), 1)) == index;
+    }
+    CHECK(rows_ok);
+    bool covered = true;
+    for (uint32_t i = first; i < last; i++) {
+        covered &= seen[i] == 1;
+    }
+    CHECK(covered);
+}
+
+static void scroll_to(lv_obj_t *list, int32_t y)
+{
+    lv_obj_scroll_to_y(list, y, LV_ANIM_OFF);
+    lv_obj_update_layout(list);
+}
+
+static void test_pool_and_binding(void)
+{
+    lv_obj_t *list = create_list();
+    uint32_t pool = ui_comp_vlist_get_pool_size(list);
+    CHECK(pool == (LIST_HEIGHT + ROW_PITCH - 1) / ROW_PITCH + 2);
+
+    static const uint32_t counts[] = {0, 1, 5, 50, 500, 5000, 7, 0, 3000};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        fill_items(counts[c], (uint32_t)c);
+        ui_comp_vlist_set_count(list, counts[c]);
+        lv_obj_update_layout(list);
+        CHECK(ui_comp_vlist_get_count(list) == counts[c]);
+        CHECK(ui_comp_vlist_get_pool_size(list) == pool);
+        // The list itself, the spacer and the pool
+        CHECK(lv_host_count_objects(list) == 2 + pool * ROW_OBJECTS);
+        check_visible_rows(list);
+    }
+
+    // Scroll through the list in uneven steps, then jump around
+    int32_t max_y = (int32_t)(s_item_count * ROW_PITCH) - ROW_GAP - LIST_HEIGHT;
+    for (int32_t y = 0; y <= max_y; y += 997) {
+        scroll_to(list, y);
+        check_visible_rows(list);
+    }
+    for (int i = 0; i < 50; i++) {
+        scroll_to(list, (int32_t)rng_range(0, (uint32_t)max_y));
+        check_visible_rows(list);
+    }
+    scroll_to(list, max_y);
+    CHECK(lv_obj_get_scroll_y(list) == max_y);
+    check_visible_rows(list);
+
+    // Shrinking below the scroll position pulls the view back to the new end
+    fill_items(20, 1);
+    ui_comp_vlist_set_count(list, 20);
+    lv_obj_update_layout(list);
+    CHECK(lv_obj_get_scroll_y(list) == 20 * ROW_PITCH - ROW_GAP - LIST_HEIGHT);
+    check_visible_rows(list);
+
+    // New data for the same count is rebound in place
+    fill_items(20, 2);
+    ui_comp_vlist_refresh(list);
+    check_visible_rows(list);
+
+    CHECK(ui_comp_vlist_row_index(lv_screen_active()) == -1);
+    CHECK(ui_comp_vlist_row_index(NULL) == -1);
+    lv_obj_delete(list);
+}
+
+static void test_heap_steady(void)
+{
+    lv_obj_t *list = create_list();
+    fill_items(MAX_ITEMS, 0);
+    ui_comp_vlist_set_count(list, MAX_ITEMS);
+    lv_obj_update_layout(list);
+    scroll_to(list, 123456);
+
+    lv_host_heap_t before, after;
+    lv_host_get_heap(&before);
+    for (uint32_t round = 1; round <= 20; round++) {
+        fill_items(MAX_ITEMS - round, round);
+        ui_comp_vlist_set_count(list, MAX_ITEMS - round);
+        lv_obj_update_layout(list);
+    }
+    lv_host_get_heap(&after);
+    CHECK(after.bytes_live == before.bytes_live);
+    check_visible_rows(list);
+    lv_obj_delete(list);
+}
+
+static int run_functionality(void)
+{
+    test_pool_and_binding();
+    test_heap_steady();
+    return test_result();
+}
+
+typedef struct {
+    lv_obj_t *list;
+    bool virtual_list;
+} bench_list_t;
+
+static void bench_update(bench_list_t *b, uint32_t count, uint32_t round)
+{
+    s_items = s_data[round & 1];
+    if (b->virtual_list) {
+        ui_comp_vlist_set_count(b->list, count);
+    } else {
+        lv_obj_clean(b->list);
+        for (uint32_t i = 0; i < count; i++) {
+            lv_obj_t *row = lv_obj_create(b->list);
+            lv_obj_set_size(row, lv_pct(100), ROW_HEIGHT);
+            row_create_cb(row, NULL);
+            row_bind_cb(row, i, NULL);
+        }
+    }
+    lv_obj_update_layout(b->list);
+}
+
+static int run_benchmark(void)
+{
+    printf("update = switch data set, then set_count() or clean and recreate, then layout; best of %d\n", BENCH_ROUNDS);
+    printf("%-8s %6s %12s %14s %14s %9s\n", "list", "items", "us/update", "allocs/update", "KB/update", "objects");
+
+    static const uint32_t counts[] = {50, 500, 5000};
+    for (int kind = 0; kind < 2; kind++) {
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            bench_list_t b = {.virtual_list = kind == 1};
+            if (b.virtual_list) {
+                b.list = create_list();
+            } else {
+                b.list = lv_obj_create(lv_screen_active());
+                lv_obj_set_size(b.list, lv_pct(100), LIST_HEIGHT);
+                lv_obj_set_flex_flow(b.list, LV_FLEX_FLOW_COLUMN);
+                lv_obj_set_style_pad_row(b.list, ROW_GAP, 0);
+            }
+            fill_items(counts[c], 1);
+            fill_items(counts[c], 0);
+            uint32_t round = 0;
+            bench_update(&b, counts[c], round++);
+
+            double best = 0;
+            lv_host_heap_t h0, h1;
+            uint64_t updates = 0;
+            lv_host_get_heap(&h0);
+            for (int r = 0; r < BENCH_ROUNDS; r++) {
+                uint32_t n = 0;
+                int64_t start = now_ns();
+                int64_t elapsed;
+                do {
+                    bench_update(&b, counts[c], round++);
+                    n++;
+                    elapsed = now_ns() - start;
+                } while (elapsed < BENCH_MIN_NS);
+                double ns = (double)elapsed / n;
+                best = r == 0 || ns < best ? ns : best;
+                updates += n;
+                if (ns > BENCH_SLOW_NS) {
+                    break;
+                }
+            }
+            lv_host_get_heap(&h1);
+            printf("%-8s %6u %12.1f %14.1f %14.2f %9u\n", b.virtual_list ? "vlist" : "rebuild", (unsigned)counts[c],
+                   best / 1000.0, (double)(h1.allocs - h0.allocs) / updates,
+                   (double)(h1.bytes_allocated - h0.bytes_allocated) / updates / 1024.0,
+                   (unsigned)lv_host_count_objects(b.list));
+            lv_obj_delete(b.list);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    lv_display_t *disp = lv_host_init(720, 1280);
+    ui_theme_init(disp);
+    ui_comp_track_invalidations(disp);
+
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    lv_host_deinit();
+    return rc;
+}
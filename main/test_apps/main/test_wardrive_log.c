@@ -0,0 +1,811 @@
+/*
+ * Host test and benchmark of the wardrive session log (wardrive_log.c) on a temporary directory. write,
+ * fsync, open and close are wrapped at link time to count the log's file calls, check that its writes are
+ * block-aligned and, for the benchmark, add up what they would cost on the SD card.
+ *
+ *   test_wardrive_log          functionality test: append and read back across 4 KB blocks, in memory and in
+ *                              the file; duplicate BSSIDs dropped, also past the first index growth; the
+ *                              memory-only cap; timed and forced flushes; a new session resets; reads while
+ *                              a task appends; the line parser on board lines, commas in SSIDs and every
+ *                              truncation; the WiGLE export byte for byte, on file and in memory
+ *   test_wardrive_log bench    ingesting the board's lines with each BSSID sighted three times: the old
+ *                              100-network ring, a CSV line per new network with open/append/close, and the
+ *                              log; the SD time they would take (0.8 ms per write plus 10 MB/s, 1.5 ms more
+ *                              when unaligned to 512 bytes, 4 ms fsync or close, 2 ms open); paging reads
+ *                              and the export
+ */
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "mac48.h"
+#include "wardrive_log.h"
+#include "test_common.h"
+
+#define SESSION_RECORDS     1500    // past the 1024-slot index's first growth
+#define MEM_CAPACITY        (WARDRIVE_LOG_MEM_BLOCKS * WARDRIVE_LOG_BLOCK_RECORDS - 1)
+#define CONCURRENT_RECORDS  3000
+#define BENCH_NETWORKS      2000
+#define BENCH_SIGHTINGS     3
+
+// ---- file call wrappers ----
+
+typedef struct {
+    atomic_uint opens;
+    atomic_uint writes;
+    atomic_uint unaligned_writes;   // offset not a multiple of the log block
+    atomic_uint fsyncs;
+    atomic_uint closes;
+    atomic_uint_fast64_t sd_us;     // what the calls would have cost on the SD card
+} io_counters_t;
+
+static io_counters_t s_io;
+
+int __real_open(const char *path, int flags, ...);
+ssize_t __real_write(int fd, const void *buf, size_t len);
+int __real_fsync(int fd);
+int __real_close(int fd);
+
+int __wrap_open(const char *path, int flags, ...)
+{
+    mode_t mode = 0;
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = (mode_t)va_arg(args, int);
+        va_end(args);
+    }
+    atomic_fetch_add(&s_io.opens, 1);
+    atomic_fetch_add(&s_io.sd_us, 2000);
+    return __real_open(path, flags, mode);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t len)
+{
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    atomic_fetch_add(&s_io.writes, 1);
+    if (offset % WARDRIVE_LOG_BLOCK_SIZE != 0) {
+        atomic_fetch_add(&s_io.unaligned_writes, 1);
+    }
+    bool sector_aligned = offset % 512 == 0 && len % 512 == 0;
+    atomic_fetch_add(&s_io.sd_us, 800 + len / 10 + (sector_aligned ? 0 : 1500));
+    return __real_write(fd, buf, len);
+}
+
+int __wrap_fsync(int fd)
+{
+    atomic_fetch_add(&s_io.fsyncs, 1);
+    atomic_fetch_add(&s_io.sd_us, 4000);
+    return __real_fsync(fd);
+}
+
+int __wrap_close(int fd)
+{
+    atomic_fetch_add(&s_io.closes, 1);
+    atomic_fetch_add(&s_io.sd_us, 4000);
+    return __real_close(fd);
+}
+
+static char s_dir[64];
+
+static void make_path(char *out, size_t size, const char *name)
+{
+    snprintf(out, size, "%s/%s", s_dir, name);
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        *len = 0;
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    *len = fread(data, 1, (size_t)size, f);
+    data[*len] = '\0';
+    fclose(f);
+    return data;
+}
+
+static off_t file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+// ---- records ----
+
+// Network i of a session; every field depends on i
+static void make_record(uint32_t i, wardrive_record_t *rec)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->bssid = (mac48_t){{0x02, 0x1A, (uint8_t)(i >> 24), (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i}};
+    snprintf(rec->ssid, sizeof(rec->ssid), "net %lu", (unsigned long)i);
+    snprintf(rec->auth, sizeof(rec->auth), "%s", i % 3 == 0 ? "[WPA2_PSK]" : i % 3 == 1 ? "[OPEN]" : "[WPA3_SAE]");
+    snprintf(rec->first_seen, sizeof(rec->first_seen), "2026-10-15 18:%02u:%02u", (unsigned)(i / 60 % 60),
+             (unsigned)(i % 60));
+    rec->channel = (uint8_t)(1 + i % 13);
+    rec->rssi = (int8_t)(-30 - (int)(i % 60));
+    rec->lat = 52.2297 + i * 1e-6;
+    rec->lon = 21.0122 - i * 1e-6;
+    rec->altitude = 100.0f + (float)(i % 50);
+    rec->accuracy = 4.0f + (float)(i % 3);
+}
+
+static bool same_record(const wardrive_record_t *a, const wardrive_record_t *b)
+{
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+// The line the board prints for a record
+static int board_line(const wardrive_record_t *rec, char *out, size_t size)
+{
+    char bssid[MAC48_STR_SIZE];
+    return snprintf(out, size, "%s,%s,%s,%s,%u,%d,%.7f,%.7f,%.2f,%.2f,WIFI", mac48_format(&rec->bssid, bssid),
+                    rec->ssid, rec->auth, rec->first_seen, rec->channel, rec->rssi, rec->lat, rec->lon,
+                    rec->altitude, rec->accuracy);
+}
+
+// The WiGLE 1.4 row the export writes for a record, the SSID quoted only when it has to be
+static int wigle_row(const wardrive_record_t *rec, char *out, size_t size)
+{
+    char bssid[MAC48_STR_SIZE];
+    char ssid[80];
+    if (strpbrk(rec->ssid, ",\"\r\n")) {
+        size_t n = 0;
+        ssid[n++] = '"';
+        for (const char *p = rec->ssid; *p; p++) {
+            if (*p == '"') {
+                ssid[n++] = '"';
+            }
+            ssid[n++] = *p;
+        }
+        ssid[n++] = '"';
+        ssid[n] = '\0';
+    } else {
+        snprintf(ssid, sizeof(ssid), "%s", rec->ssid);
+    }
+    return snprintf(out, size, "%s,%s,%s,%s,%u,%d,%.7f,%.7f,%.1f,%.1f,WIFI\n", mac48_format(&rec->bssid, bssid),
+                    ssid, rec->auth, rec->first_seen, rec->channel, rec->rssi, rec->lat, rec->lon,
+                    rec->altitude, rec->accuracy);
+}
+
+static const char WIGLE_HEADER[] =
+    "WigleWifi-1.4,appRelease=1.0,model=Tab5,release=1.0,device=M5MonsterC5-Tab5,display=,board=ESP32-P4,"
+    "brand=M5Stack\n"
+    "MAC,SSID,AuthMode,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude,AltitudeMeters,AccuracyMeters,"
+    "Type\n";
+
+// ---- functionality ----
+
+static void test_closed(void)
+{
+    static wardrive_log_t log;
+    wardrive_record_t rec;
+    make_record(0, &rec);
+    // Before init, and before the first session
+    CHECK(!wardrive_log_append(&log, &rec));
+    CHECK(wardrive_log_init(&log));
+    CHECK(!wardrive_log_append(&log, &rec));
+    CHECK(wardrive_log_count(&log) == 0);
+    CHECK(!wardrive_log_read(&log, 0, &rec));
+    CHECK(!wardrive_log_persistent(&log));
+    wardrive_log_deinit(&log);
+}
+
+// Records come back the same from the tail, the cache and the file; the file has the header in slot 0,
+// record i at (i + 1) * 128, and saw only whole-block-aligned writes
+static void test_round_trip(void)
+{
+    static wardrive_log_t log;
+    char path[96];
+    make_path(path, sizeof(path), "session.bin");
+    CHECK(wardrive_log_init(&log));
+    io_counters_t before = s_io;
+    CHECK(wardrive_log_open(&log, path));
+    CHECK(wardrive_log_persistent(&log));
+
+    wardrive_record_t rec;
+    wardrive_record_t got;
+    bool appended = true;
+    bool read_back = true;
+    for (uint32_t i = 0; i < SESSION_RECORDS; i++) {
+        make_record(i, &rec);
+        appended &= wardrive_log_append(&log, &rec);
+        // The newest record, still in the tail block, and the first one of the session
+        read_back &= wardrive_log_read(&log, i, &got) && same_record(&rec, &got);
+        make_record(0, &rec);
+        read_back &= wardrive_log_read(&log, 0, &got) && same_record(&rec, &got);
+    }
+    CHECK(appended);
+    CHECK(read_back);
+    CHECK(wardrive_log_count(&log) == SESSION_RECORDS);
+    CHECK(!wardrive_log_read(&log, SESSION_RECORDS, &got));
+
+    // Every record, across each 31/32 block boundary, newest first as the table pages
+    bool all = true;
+    for (uint32_t i = SESSION_RECORDS; i-- > 0;) {
+        make_record(i, &rec);
+        all &= wardrive_log_read(&log, i, &got) && same_record(&rec, &got);
+    }
+    CHECK(all);
+
+    uint32_t slots = SESSION_RECORDS + 1;
+    uint32_t full_blocks = slots / WARDRIVE_LOG_BLOCK_RECORDS;
+    wardrive_log_stats_t stats;
+    wardrive_log_get_stats(&log, &stats);
+    CHECK(stats.blocks_written == full_blocks && stats.write_errors == 0 && stats.duplicates == 0);
+    CHECK(file_size(path) == (off_t)full_blocks * WARDRIVE_LOG_BLOCK_SIZE);
+
+    // The partial tail reaches the file on a forced flush
+    CHECK(wardrive_log_flush(&log, true));
+    size_t len;
+    uint8_t *data = (uint8_t *)read_file(path, &len);
+    CHECK(len == (size_t)slots * WARDRIVE_LOG_RECORD_SIZE);
+    CHECK(data && memcmp(data, "WDL1", 4) == 0 && data[6] == WARDRIVE_LOG_RECORD_SIZE);
+    bool in_file = data != NULL;
+    for (uint32_t i = 0; in_file && i < SESSION_RECORDS; i++) {
+        make_record(i, &rec);
+        in_file = memcmp(data + (size_t)(i + 1) * WARDRIVE_LOG_RECORD_SIZE, &rec, sizeof(rec)) == 0;
+    }
+    CHECK(in_file);
+    free(data);
+    CHECK(s_io.writes - before.writes == full_blocks + 1);
+    CHECK(s_io.unaligned_writes == before.unaligned_writes);
+    CHECK(s_io.fsyncs - before.fsyncs == 1);
+    CHECK(s_io.opens - before.opens == 1);
+    wardrive_log_deinit(&log);
+}
+
+// A BSSID already logged is counted and dropped, whatever else changed; also past the index growth
+static void test_duplicates(void)
+{
+    static wardrive_log_t log;
+    CHECK(wardrive_log_init(&log));
+    wardrive_log_open(&log, NULL);
+
+    wardrive_record_t rec;
+    for (uint32_t i = 0; i < SESSION_RECORDS; i++) {
+        make_record(i, &rec);
+        wardrive_log_append(&log, &rec);
+    }
+    bool dropped = true;
+    for (uint32_t i = 0; i < SESSION_RECORDS; i += 7) {
+        make_record(i, &rec);
+        snprintf(rec.ssid, sizeof(rec.ssid), "renamed %lu", (unsigned long)i);
+        rec.rssi = -20;
+        dropped &= !wardrive_log_append(&log, &rec);
+    }
+    CHECK(dropped);
+    CHECK(wardrive_log_count(&log) == SESSION_RECORDS);
+
+    // The first sighting is what stays
+    wardrive_record_t got;
+    make_record(7, &rec);
+    CHECK(wardrive_log_read(&log, 7, &got) && same_record(&rec, &got));
+
+    wardrive_log_stats_t stats;
+    wardrive_log_get_stats(&log, &stats);
+    CHECK(stats.duplicates == (SESSION_RECORDS + 6) / 7);
+    CHECK(stats.dropped == 0);
+    wardrive_log_deinit(&log);
+}
+
+// Without a path the session stays in memory up to WARDRIVE_LOG_MEM_BLOCKS blocks; the rest is counted
+static void test_memory_only(void)
+{
+    static wardrive_log_t log;
+    CHECK(wardrive_log_init(&log));
+    io_counters_t before = s_io;
+    CHECK(!wardrive_log_open(&log, NULL));
+    CHECK(!wardrive_log_persistent(&log));
+
+    wardrive_record_t rec;
+    uint32_t appended = 0;
+    for (uint32_t i = 0; i < MEM_CAPACITY + 100; i++) {
+        make_record(i, &rec);
+        appended += wardrive_log_append(&log, &rec);
+    }
+    CHECK(appended == MEM_CAPACITY);
+    CHECK(wardrive_log_count(&log) == MEM_CAPACITY);
+
+    wardrive_log_stats_t stats;
+    wardrive_log_get_stats(&log, &stats);
+    CHECK(stats.dropped == 100);
+    CHECK(stats.blocks_written == WARDRIVE_LOG_MEM_BLOCKS);
+
+    wardrive_record_t got;
+    bool all = true;
+    for (uint32_t i = 0; i < MEM_CAPACITY; i++) {
+        make_record(i, &rec);
+        all &= wardrive_log_read(&log, i, &got) && same_record(&rec, &got);
+    }
+    CHECK(all);
+    CHECK(!wardrive_log_read(&log, MEM_CAPACITY, &got));
+    // Flushing has nothing to write
+    CHECK(wardrive_log_flush(&log, true));
+    CHECK(s_io.opens == before.opens && s_io.writes == before.writes);
+
+    // A path that can't be created keeps the session in memory too
+    char path[96];
+    make_path(path, sizeof(path), "missing/session.bin");
+    CHECK(!wardrive_log_open(&log, path));
+    CHECK(wardrive_log_count(&log) == 0);
+    make_record(1, &rec);
+    CHECK(wardrive_log_append(&log, &rec));
+    CHECK(wardrive_log_read(&log, 0, &got) && same_record(&rec, &got));
+    wardrive_log_deinit(&log);
+}
+
+// The partial tail waits WARDRIVE_LOG_FLUSH_MS unless forced; a new session truncates and starts over
+static void test_flush_and_reopen(void)
+{
+    static wardrive_log_t log;
+    char path[96];
+    make_path(path, sizeof(path), "flush.bin");
+    CHECK(wardrive_log_init(&log));
+    CHECK(wardrive_log_open(&log, path));
+
+    wardrive_record_t rec;
+    for (uint32_t i = 0; i < 5; i++) {
+        make_record(i, &rec);
+        wardrive_log_append(&log, &rec);
+    }
+    CHECK(wardrive_log_flush(&log, false));
+    CHECK(file_size(path) == 0);
+    vTaskDelay(pdMS_TO_TICKS(WARDRIVE_LOG_FLUSH_MS + 50));
+    CHECK(wardrive_log_flush(&log, false));
+    CHECK(file_size(path) == 6 * WARDRIVE_LOG_RECORD_SIZE);
+
+    // Nothing new: no write
+    io_counters_t before = s_io;
+    CHECK(wardrive_log_flush(&log, true));
+    CHECK(s_io.writes == before.writes);
+
+    CHECK(wardrive_log_open(&log, path));
+    CHECK(wardrive_log_count(&log) == 0);
+    CHECK(file_size(path) == 0);
+    wardrive_log_stats_t stats;
+    wardrive_log_get_stats(&log, &stats);
+    CHECK(stats.blocks_written == 0 && stats.duplicates == 0);
+    // The BSSIDs of the last session are new again
+    make_record(0, &rec);
+    CHECK(wardrive_log_append(&log, &rec));
+    wardrive_log_deinit(&log);
+    // Deinit wrote the tail
+    CHECK(file_size(path) == 2 * WARDRIVE_LOG_RECORD_SIZE);
+}
+
+typedef struct {
+    wardrive_log_t *log;
+    SemaphoreHandle_t done;
+} appender_t;
+
+static void appender_task(void *arg)
+{
+    appender_t *a = arg;
+    wardrive_record_t rec;
+    for (uint32_t i = 0; i < CONCURRENT_RECORDS; i++) {
+        make_record(i, &rec);
+        wardrive_log_append(a->log, &rec);
+        if (i % 64 == 0) {
+            vTaskDelay(1);
+        }
+    }
+    xSemaphoreGive(a->done);
+    vTaskDelete(NULL);
+}
+
+// The UI reads and exports while the wardrive task appends
+static void test_concurrent(void)
+{
+    static wardrive_log_t log;
+    char path[96];
+    char csv[96];
+    make_path(path, sizeof(path), "concurrent.bin");
+    make_path(csv, sizeof(csv), "concurrent.csv");
+    CHECK(wardrive_log_init(&log));
+    CHECK(wardrive_log_open(&log, path));
+
+    appender_t a = { .log = &log, .done = xSemaphoreCreateBinary() };
+    xTaskCreate(appender_task, "wardrive", 4096, &a, 5, NULL);
+    bool reads_ok = true;
+    int exports = 0;
+    bool exports_ok = true;
+    wardrive_record_t rec;
+    wardrive_record_t got;
+    while (xSemaphoreTake(a.done, 0) != pdTRUE) {
+        uint32_t count = wardrive_log_count(&log);
+        for (int k = 0; k < 20 && count > 0; k++) {
+            uint32_t i = count - 1 - rng_range(0, count - 1);
+            make_record(i, &rec);
+            reads_ok &= wardrive_log_read(&log, i, &got) && same_record(&rec, &got);
+        }
+        if (rng_range(0, 15) == 0) {
+            int rows = wardrive_log_export_wigle(&log, csv);
+            exports_ok &= rows >= (int)count && rows <= CONCURRENT_RECORDS;
+            exports++;
+        }
+        vTaskDelay(1);
+    }
+    vSemaphoreDelete(a.done);
+    CHECK(reads_ok);
+    CHECK(exports_ok);
+    CHECK(wardrive_log_count(&log) == CONCURRENT_RECORDS);
+    CHECK(wardrive_log_export_wigle(&log, csv) == CONCURRENT_RECORDS);
+    wardrive_log_deinit(&log);
+}
+
+static void test_parse_line(void)
+{
+    wardrive_record_t rec;
+    const char *line = "c4:2b:44:12:29:21,HomeNet,[WPA2_PSK],2026-10-15 18:02:11,1,-53,52.2297000,21.0122000,"
+                       "110.50,4.20,WIFI";
+    CHECK(wardrive_log_parse_line(line, &rec));
+    CHECK(rec.bssid.b[0] == 0xC4 && rec.bssid.b[5] == 0x21);
+    CHECK(strcmp(rec.ssid, "HomeNet") == 0 && strcmp(rec.auth, "[WPA2_PSK]") == 0);
+    CHECK(strcmp(rec.first_seen, "2026-10-15 18:02:11") == 0);
+    CHECK(rec.channel == 1 && rec.rssi == -53);
+    CHECK(rec.lat == 52.2297 && rec.lon == 21.0122 && rec.altitude == 110.5f && rec.accuracy == 4.2f);
+
+    // As read off the wire, with the line ending and an uppercase BSSID
+    CHECK(wardrive_log_parse_line("C4:2B:44:12:29:21,HomeNet,[WPA2_PSK],2026-10-15 18:02:11,1,-53,52.2297000,"
+                                  "21.0122000,110.50,4.20,WIFI\r\n", &rec));
+    CHECK(rec.bssid.b[0] == 0xC4 && rec.rssi == -53);
+
+    // Commas in the SSID, and an empty one
+    CHECK(wardrive_log_parse_line("02:00:00:00:00:01,Cafe, Bar, Grill,[OPEN],2026-10-15 18:02:12,6,-70,1.5,-2.5,"
+                                  "3.00,5.00,WIFI", &rec));
+    CHECK(strcmp(rec.ssid, "Cafe, Bar, Grill") == 0 && strcmp(rec.auth, "[OPEN]") == 0 && rec.channel == 6);
+    CHECK(rec.lat == 1.5 && rec.lon == -2.5);
+    CHECK(wardrive_log_parse_line("02:00:00:00:00:02,,[OPEN],2026-10-15 18:02:12,6,-70,0,0,0,0,WIFI", &rec));
+    CHECK(rec.ssid[0] == '\0');
+
+    // An SSID longer than 32 bytes is cut
+    CHECK(wardrive_log_parse_line("02:00:00:00:00:03,0123456789012345678901234567890123456789,[OPEN],"
+                                  "2026-10-15 18:02:12,6,-70,0,0,0,0,WIFI", &rec));
+    CHECK(strcmp(rec.ssid, "01234567890123456789012345678901") == 0);
+
+    // Every cut of a board line is refused, as are lines that are not wardrive rows
+    wardrive_record_t full;
+    make_record(12345, &full);
+    char board[160];
+    int len = board_line(&full, board, sizeof(board));
+    bool cuts_refused = true;
+    for (int cut = 0; cut < len; cut++) {
+        char part[160];
+        snprintf(part, sizeof(part), "%.*s", cut, board);
+        cuts_refused &= !wardrive_log_parse_line(part, &rec);
+    }
+    CHECK(cuts_refused);
+    // The whole line gives the record back, coordinates to the 7 decimals the board prints
+    CHECK(wardrive_log_parse_line(board, &rec));
+    CHECK(mac48_equal(&rec.bssid, &full.bssid) && strcmp(rec.ssid, full.ssid) == 0);
+    CHECK(strcmp(rec.auth, full.auth) == 0 && strcmp(rec.first_seen, full.first_seen) == 0);
+    CHECK(rec.channel == full.channel && rec.rssi == full.rssi);
+    CHECK(fabs(rec.lat - full.lat) < 1e-7 && fabs(rec.lon - full.lon) < 1e-7);
+    CHECK(rec.altitude == full.altitude && rec.accuracy == full.accuracy);
+    CHECK(!wardrive_log_parse_line("c4:2b:44:12:29:21,HomeNet,WIFI", &rec));
+    CHECK(!wardrive_log_parse_line("c4:2b:44:12:29:21,HomeNet,[WPA2_PSK],2026-10-15 18:02:11,1,-53,52.2,110.50,4.20,"
+                                   "WIFI", &rec));
+    CHECK(!wardrive_log_parse_line("c4:2b:44:12:29,HomeNet,[WPA2_PSK],2026-10-15 18:02:11,1,-53,52.2,21.0,110.50,"
+                                   "4.20,WIFI", &rec));
+    CHECK(!wardrive_log_parse_line("I (163002) wardrive: 3 networks logged", &rec));
+    CHECK(!wardrive_log_parse_line("c4:2b:44:12:29:21,HomeNet,[WPA2_PSK],2026-10-15 18:02:11,1,-53,52.2,21.0,"
+                                   "110.50,4.20,BT", &rec));
+    CHECK(!wardrive_log_parse_line(NULL, &rec));
+}
+
+// The export is the WiGLE header and a row per record, oldest first, from the file or from memory
+static void test_export(void)
+{
+    static wardrive_log_t log;
+    char path[96];
+    char csv[96];
+    make_path(path, sizeof(path), "export.bin");
+    make_path(csv, sizeof(csv), "export.csv");
+    CHECK(wardrive_log_init(&log));
+
+    for (int persistent = 1; persistent >= 0; persistent--) {
+        wardrive_log_open(&log, persistent ? path : NULL);
+        // Empty
+        CHECK(wardrive_log_export_wigle(&log, csv) == 0);
+        size_t len;
+        char *data = read_file(csv, &len);
+        CHECK(data && strcmp(data, WIGLE_HEADER) == 0);
+        free(data);
+
+        uint32_t count = persistent ? SESSION_RECORDS : 100;
+        size_t cap = sizeof(WIGLE_HEADER) + (size_t)count * 160;
+        char *want = malloc(cap);
+        size_t want_len = (size_t)snprintf(want, cap, "%s", WIGLE_HEADER);
+        wardrive_record_t rec;
+        for (uint32_t i = 0; i < count; i++) {
+            make_record(i, &rec);
+            if (i == 3) {
+                snprintf(rec.ssid, sizeof(rec.ssid), "Cafe, \"Bar\"");
+            }
+            wardrive_log_append(&log, &rec);
+            want_len += (size_t)wigle_row(&rec, want + want_len, cap - want_len);
+        }
+        CHECK(wardrive_log_export_wigle(&log, csv) == (int)count);
+        data = read_file(csv, &len);
+        CHECK(data && len == want_len && memcmp(data, want, len) == 0);
+        CHECK(data && strstr(data, ",\"Cafe, \"\"Bar\"\"\",") != NULL);
+        free(data);
+        free(want);
+    }
+
+    make_path(csv, sizeof(csv), "missing/export.csv");
+    CHECK(wardrive_log_export_wigle(&log, csv) == -1);
+    wardrive_log_deinit(&log);
+}
+
+static int run_functionality(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+    test_closed();
+    test_round_trip();
+    test_duplicates();
+    test_memory_only();
+    test_flush_and_reopen();
+    test_concurrent();
+    test_parse_line();
+    test_export();
+    return test_result();
+}
+
+// ---- benchmark ----
+
+// ---- copied from main.c before the log (parse_wardrive_network_line() and its ring) ----
+#define WARDRIVE_MAX_NETWORKS 100
+typedef struct {
+    char ssid[33];
+    mac48_t bssid;
+    char security[28];
+    char lat[14];
+    char lon[14];
+} wardrive_network_t;
+
+typedef struct {
+    wardrive_network_t wardrive_networks[WARDRIVE_MAX_NETWORKS];
+    int wardrive_net_count;
+    int wardrive_net_head;
+} tab_context_t;
+
+// Parse a wardrive CSV network line and add to ring buffer
+// Format: BSSID,SSID,[SECURITY],timestamp,channel,rssi,lat,lon,alt,acc,WIFI
+static bool parse_wardrive_network_line(tab_context_t *ctx, const char *line)
+{
+    // Must end with ,WIFI
+    if (!strstr(line, ",WIFI")) return false;
+
+    // Quick validation: must start with a MAC (XX:XX:XX:XX:XX:XX)
+    mac48_t bssid;
+    if (!mac48_parse(line, &bssid)) return false;
+
+    char buf[512];
+    strncpy(buf, line, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    // Split by commas - we need fields: 0=BSSID, 1=SSID, 2=SECURITY, 6=lat, 7=lon
+    char *fields[12] = {0};
+    int field_count = 0;
+    char *p = buf;
+    fields[0] = p;
+    field_count = 1;
+
+    while (*p && field_count < 12) {
+        if (*p == ',') {
+            *p = '\0';
+            fields[field_count++] = p + 1;
+        }
+        p++;
+    }
+
+    // Need at least 11 fields (0..10)
+    if (field_count < 11) return false;
+
+    wardrive_network_t *net = &ctx->wardrive_networks[ctx->wardrive_net_head];
+
+    // BSSID (field 0)
+    net->bssid = bssid;
+
+    // SSID (field 1, may be empty) - max 32 chars + null
+    snprintf(net->ssid, sizeof(net->ssid), "%.32s", fields[1]);
+
+    // Security (field 2, strip brackets) - max 27 chars + null
+    char *sec = fields[2];
+    if (sec[0] == '[') sec++;
+    snprintf(net->security, sizeof(net->security), "%.27s", sec);
+    // Remove trailing ']'
+    char *bracket = strchr(net->security, ']');
+    if (bracket) *bracket = '\0';
+
+    // Lat (field 6) - max 13 chars + null
+    snprintf(net->lat, sizeof(net->lat), "%.13s", fields[6]);
+
+    // Lon (field 7) - max 13 chars + null
+    snprintf(net->lon, sizeof(net->lon), "%.13s", fields[7]);
+
+    // Advance ring buffer
+    ctx->wardrive_net_head = (ctx->wardrive_net_head + 1) % WARDRIVE_MAX_NETWORKS;
+    ctx->wardrive_net_count++;
+
+    return true;
+}
+// ---- end of copy ----
+
+typedef struct {
+    const char *name;
+    double ns_per_line;
+    uint32_t kept;
+    io_counters_t io;
+} bench_row_t;
+
+static void print_row(const bench_row_t *r)
+{
+    printf("  %-22s %9.0f %8u %7u %7u %7u %7u %10.1f\n", r->name, r->ns_per_line, (unsigned)r->kept,
+           (unsigned)r->io.opens, (unsigned)r->io.writes, (unsigned)r->io.fsyncs, (unsigned)r->io.closes,
+           (double)r->io.sd_us / 1000);
+}
+
+static io_counters_t io_since(const io_counters_t *before)
+{
+    io_counters_t d;
+    atomic_init(&d.opens, s_io.opens - before->opens);
+    atomic_init(&d.writes, s_io.writes - before->writes);
+    atomic_init(&d.unaligned_writes, s_io.unaligned_writes - before->unaligned_writes);
+    atomic_init(&d.fsyncs, s_io.fsyncs - before->fsyncs);
+    atomic_init(&d.closes, s_io.closes - before->closes);
+    atomic_init(&d.sd_us, s_io.sd_us - before->sd_us);
+    return d;
+}
+
+static int run_benchmark(void)
+{
+    esp_log_shim_level = ESP_LOG_NONE;
+
+    // The board reports each network again on later scans
+    uint32_t line_count = BENCH_NETWORKS * BENCH_SIGHTINGS;
+    char (*lines)[160] = malloc((size_t)line_count * sizeof(*lines));
+    for (uint32_t s = 0; s < BENCH_SIGHTINGS; s++) {
+        for (uint32_t i = 0; i < BENCH_NETWORKS; i++) {
+            wardrive_record_t rec;
+            make_record(i, &rec);
+            board_line(&rec, lines[s * BENCH_NETWORKS + i], sizeof(lines[0]));
+        }
+    }
+    printf("%u wardrive lines, %d networks each sighted %d times; SD time as the card would take it\n",
+           (unsigned)line_count, BENCH_NETWORKS, BENCH_SIGHTINGS);
+    printf("  %-22s %9s %8s %7s %7s %7s %7s %10s\n", "ingest", "ns/line", "kept", "opens", "writes", "fsyncs",
+           "closes", "SD ms");
+
+    // Before: the 100-network ring, nothing saved
+    static tab_context_t ctx;
+    bench_row_t row = { .name = "ring of 100 (before)" };
+    int64_t best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        memset(&ctx, 0, sizeof(ctx));
+        int64_t start = now_ns();
+        for (uint32_t i = 0; i < line_count; i++) {
+            parse_wardrive_network_line(&ctx, lines[i]);
+        }
+        int64_t ns = now_ns() - start;
+        best = r == 0 || ns < best ? ns : best;
+    }
+    row.ns_per_line = (double)best / line_count;
+    row.kept = WARDRIVE_MAX_NETWORKS;
+    print_row(&row);
+
+    // A CSV line per new network, opening and closing the file each time
+    char path[96];
+    make_path(path, sizeof(path), "bench.csv");
+    row = (bench_row_t){ .name = "CSV line per network" };
+    static wardrive_log_t dedup;
+    wardrive_log_init(&dedup);
+    wardrive_log_open(&dedup, NULL);
+    io_counters_t before = s_io;
+    int64_t start = now_ns();
+    for (uint32_t i = 0; i < line_count; i++) {
+        wardrive_record_t rec;
+        if (wardrive_log_parse_line(lines[i], &rec) && wardrive_log_append(&dedup, &rec)) {
+            int fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+            size_t len = strlen(lines[i]);
+            lines[i][len] = '\n';
+            if (fd < 0 || write(fd, lines[i], len + 1) != (ssize_t)(len + 1)) {
+                printf("FAIL cannot write %s\n", path);
+                return EXIT_FAILURE;
+            }
+            lines[i][len] = '\0';
+            close(fd);
+            row.kept++;
+        }
+    }
+    row.ns_per_line = (double)(now_ns() - start) / line_count;
+    row.io = io_since(&before);
+    wardrive_log_deinit(&dedup);
+    print_row(&row);
+
+    // The log, in memory and on the card
+    static wardrive_log_t log;
+    wardrive_log_init(&log);
+    make_path(path, sizeof(path), "bench.bin");
+    for (int persistent = 0; persistent <= 1; persistent++) {
+        row = (bench_row_t){ .name = persistent ? "wardrive_log, SD" : "wardrive_log, memory" };
+        best = 0;
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            before = s_io;
+            wardrive_log_open(&log, persistent ? path : NULL);
+            start = now_ns();
+            for (uint32_t i = 0; i < line_count; i++) {
+                wardrive_record_t rec;
+                if (wardrive_log_parse_line(lines[i], &rec)) {
+                    wardrive_log_append(&log, &rec);
+                }
+            }
+            // Stop flushes the tail
+            wardrive_log_flush(&log, true);
+            int64_t ns = now_ns() - start;
+            best = r == 0 || ns < best ? ns : best;
+            row.io = io_since(&before);
+        }
+        row.ns_per_line = (double)best / line_count;
+        row.kept = wardrive_log_count(&log);
+        print_row(&row);
+    }
+
+    // The table pages through the log newest first, a screen of rows at a time
+    wardrive_record_t rec;
+    uint32_t count = wardrive_log_count(&log);
+    best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        start = now_ns();
+        for (uint32_t i = count; i-- > 0;) {
+            wardrive_log_read(&log, i, &rec);
+        }
+        int64_t ns = now_ns() - start;
+        best = r == 0 || ns < best ? ns : best;
+    }
+    printf("Paging all %u networks newest first: %.0f ns per row\n", (unsigned)count, (double)best / count);
+
+    char csv[96];
+    make_path(csv, sizeof(csv), "bench-export.csv");
+    start = now_ns();
+    int rows = wardrive_log_export_wigle(&log, csv);
+    printf("WiGLE export of %d rows: %.1f ms\n", rows, (double)(now_ns() - start) / 1e6);
+    wardrive_log_deinit(&log);
+    free(lines);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    snprintf(s_dir, sizeof(s_dir), "/tmp/test_wardrive_log.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    int rc = argc > 1 && strcmp(argv[1], "bench") == 0 ? run_benchmark() : run_functionality();
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", s_dir);
+    if (system(cmd) != 0) {
+        printf("could not remove %s\n", s_dir);
+    }
+    return rc;
+}
@@ -0,0 +1,38 @@
+#ifndef SHIM_ESP_LOG_H
+#define SHIM_ESP_LOG_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+// Set from the test; warnings and errors by default
+extern esp_log_level_t esp_log_shim_level;
+
+#define ESP_LOG_SHIM(level, letter, tag, fmt, ...) do { \
+        if (esp_log_shim_level >= (level)) { \
+            fprintf(stderr, letter " (%s) " fmt "\n", tag, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) ESP_LOG_SHIM(ESP_LOG_ERROR, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_SHIM(ESP_LOG_WARN, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_SHIM(ESP_LOG_INFO, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_SHIM(ESP_LOG_DEBUG, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ESP_LOG_SHIM(ESP_LOG_VERBOSE, "V", tag, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
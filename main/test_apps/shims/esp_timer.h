@@ -0,0 +1,17 @@
+#ifndef SHIM_ESP_TIMER_H
+#define SHIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Microseconds of CLOCK_MONOTONIC since the first call
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
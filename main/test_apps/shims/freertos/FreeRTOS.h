@@ -0,0 +1,37 @@
+#ifndef SHIM_FREERTOS_H
+#define SHIM_FREERTOS_H
+
+/*
+ * Host shim of the FreeRTOS API used by main/, on top of pthreads.
+ *
+ * One tick is one millisecond of CLOCK_MONOTONIC. Tasks are detached
+ * threads; priorities and cores are recorded but not enforced. Only what
+ * the modules under test call is provided.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdFAIL                  pdFALSE
+#define pdPASS                  pdTRUE
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
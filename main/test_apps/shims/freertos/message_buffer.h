@@ -0,0 +1,26 @@
+#ifndef SHIM_FREERTOS_MESSAGE_BUFFER_H
+#define SHIM_FREERTOS_MESSAGE_BUFFER_H
+
+#include "freertos/stream_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef StreamBufferHandle_t MessageBufferHandle_t;
+typedef StaticStreamBuffer_t StaticMessageBuffer_t;
+
+#define xMessageBufferCreate(size)  shim_stream_create((size), 0, true, NULL, NULL)
+#define xMessageBufferCreateStatic(size, storage, control) \
+    shim_stream_create((size), 0, true, (storage), (control))
+#define xMessageBufferSend          xStreamBufferSend
+#define xMessageBufferReceive       xStreamBufferReceive
+#define xMessageBufferSpacesAvailable xStreamBufferSpacesAvailable
+#define xMessageBufferReset         xStreamBufferReset
+#define vMessageBufferDelete        vStreamBufferDelete
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SHIM_FREERTOS_SEMPHR_H
+#define SHIM_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mutexes are plain binary semaphores here: no priority inheritance, no owner check
+typedef struct shim_sem *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
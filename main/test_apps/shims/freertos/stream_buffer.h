@@ -0,0 +1,41 @@
+#ifndef SHIM_FREERTOS_STREAM_BUFFER_H
+#define SHIM_FREERTOS_STREAM_BUFFER_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Stream and message buffers share one implementation, like in FreeRTOS.
+ * A message is stored behind a size_t length, so a buffer of n bytes holds
+ * less than n bytes of messages. The static variants keep their storage
+ * and control block where the caller put them.
+ */
+
+typedef struct shim_stream *StreamBufferHandle_t;
+
+typedef struct {
+    void *impl[32];
+} StaticStreamBuffer_t;
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level);
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t size, size_t trigger_level, uint8_t *storage,
+                                               StaticStreamBuffer_t *control);
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks);
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks);
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t stream);
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream);
+BaseType_t xStreamBufferReset(StreamBufferHandle_t stream);
+void vStreamBufferDelete(StreamBufferHandle_t stream);
+
+// Internal, for message_buffer.h
+StreamBufferHandle_t shim_stream_create(size_t size, size_t trigger_level, bool messages, uint8_t *storage,
+                                        StaticStreamBuffer_t *control);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
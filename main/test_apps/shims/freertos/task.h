@@ -0,0 +1,42 @@
+#ifndef SHIM_FREERTOS_TASK_H
+#define SHIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+typedef struct {
+    TickType_t start;
+} TimeOut_t;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core);
+// Only NULL, the calling task, is supported
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char *pcTaskGetName(TaskHandle_t task);
+// The newest task with that name
+TaskHandle_t xTaskGetHandle(const char *name);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+BaseType_t xPortGetCoreID(void);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+void vTaskSetTimeOutState(TimeOut_t *timeout);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *timeout, TickType_t *remaining);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
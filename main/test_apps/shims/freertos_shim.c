@@ -0,0 +1,608 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/stream_buffer.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+esp_log_level_t esp_log_shim_level = ESP_LOG_WARN;
+
+// Time
+
+static pthread_once_t s_boot_once = PTHREAD_ONCE_INIT;
+static int64_t s_boot_us;
+
+static int64_t monotonic_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+static void set_boot(void)
+{
+    s_boot_us = monotonic_us();
+}
+
+int64_t esp_timer_get_time(void)
+{
+    pthread_once(&s_boot_once, set_boot);
+    return monotonic_us() - s_boot_us;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / (1000000 / configTICK_RATE_HZ));
+}
+
+// Every wait goes through here: a condition variable on CLOCK_MONOTONIC with a tick timeout
+
+typedef struct {
+    bool forever;
+    struct timespec at;
+} deadline_t;
+
+static deadline_t deadline_after(TickType_t ticks)
+{
+    deadline_t d = { .forever = ticks == portMAX_DELAY };
+    if (!d.forever) {
+        clock_gettime(CLOCK_MONOTONIC, &d.at);
+        int64_t ns = d.at.tv_nsec + (int64_t)ticks * (1000000000 / configTICK_RATE_HZ);
+        d.at.tv_sec += ns / 1000000000;
+        d.at.tv_nsec = ns % 1000000000;
+    }
+    return d;
+}
+
+static void cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// False once the deadline passed; the caller re-checks its condition either way
+static bool cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, const deadline_t *deadline)
+{
+    if (deadline->forever) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, &deadline->at) == 0;
+}
+
+// Tasks
+
+struct shim_task {
+    struct shim_task *next;     // every task ever created, so none looks leaked
+    pthread_t thread;
+    char name[16];
+    UBaseType_t priority;
+    BaseType_t core;
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;
+};
+
+static pthread_mutex_t s_tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct shim_task *s_tasks;
+static __thread struct shim_task *s_current;
+
+static struct shim_task *task_new(const char *name, UBaseType_t priority, BaseType_t core)
+{
+    struct shim_task *task = calloc(1, sizeof(*task));
+    if (!task) {
+        return NULL;
+    }
+    strncpy(task->name, name ? name : "", sizeof(task->name) - 1);
+    task->priority = priority;
+    task->core = core;
+    pthread_mutex_init(&task->lock, NULL);
+    cond_init(&task->cond);
+
+    pthread_mutex_lock(&s_tasks_lock);
+    task->next = s_tasks;
+    s_tasks = task;
+    pthread_mutex_unlock(&s_tasks_lock);
+    return task;
+}
+
+static struct shim_task *current_task(void)
+{
+    if (!s_current) {
+        // The main thread, or a thread the test started itself
+        s_current = task_new("main", 1, 0);
+    }
+    return s_current;
+}
+
+static void *task_entry(void *arg)
+{
+    s_current = (struct shim_task *)arg;
+    s_current->fn(s_current->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core)
+{
+    (void)stack_depth;
+    struct shim_task *task = task_new(name, priority, core < 0 ? 0 : core);
+    if (!task) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    // Handed out before the thread runs, as a task may be notified right away
+    if (created) {
+        *created = task;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int err = pthread_create(&task->thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        if (created) {
+            *created = NULL;
+        }
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, created, 0);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == s_current) {
+        pthread_exit(NULL);
+    }
+    abort();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    int64_t ns = (int64_t)ticks * (1000000000 / configTICK_RATE_HZ);
+    struct timespec t = { .tv_sec = ns / 1000000000, .tv_nsec = ns % 1000000000 };
+    nanosleep(&t, NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task();
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    return (task ? task : current_task())->name;
+}
+
+TaskHandle_t xTaskGetHandle(const char *name)
+{
+    pthread_mutex_lock(&s_tasks_lock);
+    struct shim_task *task = s_tasks;
+    while (task && strcmp(task->name, name) != 0) {
+        task = task->next;
+    }
+    pthread_mutex_unlock(&s_tasks_lock);
+    return task;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    return (task ? task : current_task())->priority;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return current_task()->core;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct shim_task *task = current_task();
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify == 0 && ticks > 0 && cond_wait(&task->cond, &task->lock, &deadline)) {
+    }
+    uint32_t value = task->notify;
+    if (value > 0) {
+        task->notify = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskSetTimeOutState(TimeOut_t *timeout)
+{
+    timeout->start = xTaskGetTickCount();
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *timeout, TickType_t *remaining)
+{
+    if (*remaining == portMAX_DELAY) {
+        return pdFALSE;
+    }
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now - timeout->start;
+    if (elapsed >= *remaining) {
+        *remaining = 0;
+        return pdTRUE;
+    }
+    *remaining -= elapsed;
+    timeout->start = now;
+    return pdFALSE;
+}
+
+// Semaphores
+
+struct shim_sem {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    struct shim_sem *sem = calloc(1, sizeof(*sem));
+    if (!sem) {
+        return NULL;
+    }
+    pthread_mutex_init(&sem->lock, NULL);
+    cond_init(&sem->cond);
+    sem->count = initial;
+    sem->max = max;
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0 && ticks > 0 && cond_wait(&sem->cond, &sem->lock, &deadline)) {
+    }
+    bool taken = sem->count > 0;
+    if (taken) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    bool given = sem->count < sem->max;
+    if (given) {
+        sem->count++;
+        pthread_cond_broadcast(&sem->cond);
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return given ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    UBaseType_t count = sem->count;
+    pthread_mutex_unlock(&sem->lock);
+    return count;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (!sem) {
+        return;
+    }
+    pthread_mutex_destroy(&sem->lock);
+    pthread_cond_destroy(&sem->cond);
+    free(sem);
+}
+
+// Queues
+
+struct shim_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;           // next to receive
+    UBaseType_t count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct shim_queue *queue = calloc(1, sizeof(*queue));
+    if (!queue) {
+        return NULL;
+    }
+    queue->items = malloc((size_t)length * item_size);
+    if (!queue->items) {
+        free(queue);
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    cond_init(&queue->cond);
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length && ticks > 0 && cond_wait(&queue->cond, &queue->lock, &deadline)) {
+    }
+    bool sent = queue->count < queue->length;
+    if (sent) {
+        UBaseType_t slot = (queue->head + queue->count) % queue->length;
+        memcpy(queue->items + (size_t)slot * queue->item_size, item, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return sent ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && ticks > 0 && cond_wait(&queue->cond, &queue->lock, &deadline)) {
+    }
+    bool received = queue->count > 0;
+    if (received) {
+        memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return received ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (!queue) {
+        return;
+    }
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+    free(queue->items);
+    free(queue);
+}
+
+// Stream and message buffers
+
+struct shim_stream {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t *buf;
+    size_t size;
+    size_t read;                // ring offset of the oldest byte
+    size_t used;
+    size_t trigger_level;
+    bool messages;
+    bool owns_buf;
+    bool owns_self;
+};
+
+_Static_assert(sizeof(struct shim_stream) <= sizeof(StaticStreamBuffer_t), "StaticStreamBuffer_t too small");
+
+StreamBufferHandle_t shim_stream_create(size_t size, size_t trigger_level, bool messages, uint8_t *storage,
+                                        StaticStreamBuffer_t *control)
+{
+    if (size == 0 || (messages && size <= sizeof(size_t))) {
+        return NULL;
+    }
+    struct shim_stream *stream = control ? (struct shim_stream *)control : calloc(1, sizeof(*stream));
+    if (!stream) {
+        return NULL;
+    }
+    memset(stream, 0, sizeof(*stream));
+    stream->owns_self = control == NULL;
+    stream->buf = storage;
+    if (!stream->buf) {
+        stream->buf = malloc(size);
+        stream->owns_buf = true;
+    }
+    if (!stream->buf) {
+        if (stream->owns_self) {
+            free(stream);
+        }
+        return NULL;
+    }
+    pthread_mutex_init(&stream->lock, NULL);
+    cond_init(&stream->cond);
+    stream->size = size;
+    stream->trigger_level = trigger_level > 0 ? trigger_level : 1;
+    stream->messages = messages;
+    return stream;
+}
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level)
+{
+    return shim_stream_create(size, trigger_level, false, NULL, NULL);
+}
+
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t size, size_t trigger_level, uint8_t *storage,
+                                               StaticStreamBuffer_t *control)
+{
+    return shim_stream_create(size, trigger_level, false, storage, control);
+}
+
+static void ring_put(struct shim_stream *stream, const void *data, size_t len)
+{
+    size_t at = (stream->read + stream->used) % stream->size;
+    size_t first = len < stream->size - at ? len : stream->size - at;
+    memcpy(stream->buf + at, data, first);
+    memcpy(stream->buf, (const uint8_t *)data + first, len - first);
+    stream->used += len;
+}
+
+static void ring_peek(const struct shim_stream *stream, void *data, size_t len)
+{
+    size_t first = len < stream->size - stream->read ? len : stream->size - stream->read;
+    memcpy(data, stream->buf + stream->read, first);
+    memcpy((uint8_t *)data + first, stream->buf, len - first);
+}
+
+static void ring_drop(struct shim_stream *stream, size_t len)
+{
+    stream->read = (stream->read + len) % stream->size;
+    stream->used -= len;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks)
+{
+    // A message goes in whole with its length or not at all; stream bytes go in as far as they fit
+    size_t need = stream->messages ? len + sizeof(size_t) : len;
+    if (stream->messages && need > stream->size) {
+        return 0;
+    }
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&stream->lock);
+    while (stream->size - stream->used < need && ticks > 0 && cond_wait(&stream->cond, &stream->lock, &deadline)) {
+    }
+    size_t space = stream->size - stream->used;
+    size_t sent = 0;
+    if (stream->messages) {
+        if (space >= need) {
+            ring_put(stream, &len, sizeof(len));
+            ring_put(stream, data, len);
+            sent = len;
+        }
+    } else {
+        sent = len < space ? len : space;
+        ring_put(stream, data, sent);
+    }
+    if (sent > 0) {
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks)
+{
+    size_t want = stream->messages ? sizeof(size_t) : stream->trigger_level;
+    deadline_t deadline = deadline_after(ticks);
+
+    pthread_mutex_lock(&stream->lock);
+    while (stream->used < want && ticks > 0 && cond_wait(&stream->cond, &stream->lock, &deadline)) {
+    }
+    size_t got = 0;
+    if (stream->messages) {
+        size_t msg_len = 0;
+        if (stream->used >= sizeof(size_t)) {
+            ring_peek(stream, &msg_len, sizeof(msg_len));
+            // Like FreeRTOS: a message that doesn't fit stays in the buffer
+            if (msg_len <= len) {
+                ring_drop(stream, sizeof(msg_len));
+                ring_peek(stream, data, msg_len);
+                ring_drop(stream, msg_len);
+                got = msg_len;
+            }
+        }
+    } else if (stream->used > 0) {
+        got = len < stream->used ? len : stream->used;
+        ring_peek(stream, data, got);
+        ring_drop(stream, got);
+    }
+    if (got > 0) {
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return got;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    size_t space = stream->size - stream->used;
+    pthread_mutex_unlock(&stream->lock);
+    return space;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    size_t used = stream->used;
+    pthread_mutex_unlock(&stream->lock);
+    return used;
+}
+
+BaseType_t xStreamBufferReset(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    stream->read = 0;
+    stream->used = 0;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->lock);
+    return pdPASS;
+}
+
+void vStreamBufferDelete(StreamBufferHandle_t stream)
+{
+    if (!stream) {
+        return;
+    }
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->cond);
+    if (stream->owns_buf) {
+        free(stream->buf);
+    }
+    if (stream->owns_self) {
+        free(stream);
+    }
+}
@@ -0,0 +1,396 @@
+#include "theme_icons.h"
+
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "src/draw/lv_image_decoder_private.h"
+
+static const char *TAG = "theme_icons";
+
+// RGB565 plane, then A8 plane
+#define CELL_BYTES(cell_px)     ((size_t)(cell_px) * (cell_px) * 3)
+
+typedef struct {
+    uint8_t *mem;
+    size_t bytes;
+    uint16_t cell_px;
+    bool used[THEME_ICONS_MAX_SLOTS];
+    lv_image_dsc_t cells[THEME_ICONS_MAX_SLOTS];
+} theme_icons_atlas_t;
+
+static theme_icons_atlas_t s_atlas;
+
+// Scale an ARGB8888 image (LVGL byte order: blue, green, red, alpha) to fit the cell, centered.
+// Every cell pixel averages the source pixels it covers, weighted by their alpha, so transparent
+// pixels don't darken the edges.
+static void scale_into_cell(const lv_draw_buf_t *img, uint8_t *cell, uint32_t cell_px)
+{
+    const uint32_t sw = img->header.w;
+    const uint32_t sh = img->header.h;
+    uint32_t dw = cell_px;
+    uint32_t dh = cell_px;
+    if (sw >= sh) {
+        dh = LV_MAX(1, sh * cell_px / sw);
+    } else {
+        dw = LV_MAX(1, sw * cell_px / sh);
+    }
+    const uint32_t x0 = (cell_px - dw) / 2;
+    const uint32_t y0 = (cell_px - dh) / 2;
+
+    memset(cell, 0, CELL_BYTES(cell_px));
+    uint16_t *rgb = (uint16_t *)cell;
+    uint8_t *alpha = cell + cell_px * cell_px * sizeof(uint16_t);
+
+    for (uint32_t dy = 0; dy < dh; dy++) {
+        uint32_t sy0 = dy * sh / dh;
+        uint32_t sy1 = LV_MAX(sy0 + 1, (dy + 1) * sh / dh);
+        for (uint32_t dx = 0; dx < dw; dx++) {
+            uint32_t sx0 = dx * sw / dw;
+            uint32_t sx1 = LV_MAX(sx0 + 1, (dx + 1) * sw / dw);
+            uint32_t a = 0, r = 0, g = 0, b = 0, n = 0;
+            for (uint32_t sy = sy0; sy < sy1; sy++) {
+                const uint8_t *px = img->data + sy * img->header.stride + sx0 * 4;
+                for (uint32_t sx = sx0; sx < sx1; sx++, px += 4) {
+                    b += px[0] * px[3];
+                    g += px[1] * px[3];
+                    r += px[2] * px[3];
+                    a += px[3];
+                    n++;
+                }
+            }
+
+            uint32_t i = (y0 + dy) * cell_px + x0 + dx;
+            alpha[i] = (uint8_t)(a / n);
+            if (a > 0) {
+                r /= a;
+                g /= a;
+                b /= a;
+                rgb[i] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+            }
+        }
+    }
+}
+
+static bool decode_into_cell(const char *src, uint8_t *cell, uint32_t cell_px)
+{
+    // Decoded straight into the cell; the full-size image isn't kept in the image cache
+    lv_image_decoder_args_t args = {
+        .no_cache = true,
+    };
+    lv_image_decoder_dsc_t dsc;
+    if (lv_image_decoder_open(&dsc, src, &args) != LV_RESULT_OK) {
+        ESP_LOGW(TAG, "Can't decode %s", src);
+        return false;
+    }
+
+    bool ok = false;
+    const lv_draw_buf_t *img = dsc.decoded;
+    if (!img || !img->data || img->header.w == 0 || img->header.h == 0) {
+        ESP_LOGW(TAG, "Nothing decoded from %s", src);
+    } else if (img->header.cf != LV_COLOR_FORMAT_ARGB8888) {
+        ESP_LOGW(TAG, "Unsupported color format %d: %s", (int)img->header.cf, src);
+    } else {
+        scale_into_cell(img, cell, cell_px);
+        ok = true;
+    }
+    lv_image_decoder_close(&dsc);
+    return ok;
+}
+
+size_t theme_icons_atlas_build(const char *const *srcs, size_t count, uint16_t cell_px)
+{
+    count = LV_MIN(count, THEME_ICONS_MAX_SLOTS);
+    cell_px = LV_CLAMP(1, cell_px, THEME_ICONS_MAX_CELL_PX);
+    if (count == 0) {
+        theme_icons_atlas_free();
+        return 0;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    size_t bytes = count * CELL_BYTES(cell_px);
+    uint8_t *mem = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!mem) {
+        ESP_LOGW(TAG, "No memory for a %u KB atlas, keeping the old one", (unsigned)(bytes / 1024));
+        return 0;
+    }
+
+    bool used[THEME_ICONS_MAX_SLOTS] = {0};
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *cell = mem + i * CELL_BYTES(cell_px);
+        if (srcs[i] && srcs[i][0] != '\0' && decode_into_cell(srcs[i], cell, cell_px)) {
+            used[i] = true;
+            decoded++;
+        }
+    }
+
+    theme_icons_atlas_free();
+    if (decoded == 0) {
+        heap_caps_free(mem);
+        return 0;
+    }
+
+    s_atlas.mem = mem;
+    s_atlas.bytes = bytes;
+    s_atlas.cell_px = cell_px;
+    for (size_t i = 0; i < count; i++) {
+        if (!used[i]) {
+            continue;
+        }
+        lv_image_dsc_t *cell = &s_atlas.cells[i];
+        cell->header.magic = LV_IMAGE_HEADER_MAGIC;
+        cell->header.cf = LV_COLOR_FORMAT_RGB565A8;
+        cell->header.w = cell_px;
+        cell->header.h = cell_px;
+        cell->header.stride = cell_px * sizeof(uint16_t);
+        cell->data_size = CELL_BYTES(cell_px);
+        cell->data = mem + i * CELL_BYTES(cell_px);
+        s_atlas.used[i] = true;
+    }
+    ESP_LOGI(TAG, "Atlas: %u of %u icons at %upx, %u KB, %lu ms", (unsigned)decoded, (unsigned)count,
+             (unsigned)cell_px, (unsigned)(bytes / 1024),
+             (unsigned long)((esp_timer_get_time() - start_us) / 1000));
+    return decoded;
+}
+
+const lv_image_dsc_t *theme_icons_atlas_get(size_t slot)
+{
+    if (slot >= THEME_ICONS_MAX_SLOTS || !s_atlas.used[slot]) {
+        return NULL;
+    }
+    return &s_atlas.cells[slot];
+}
+
+void theme_icons_atlas_free(void)
+{
+    for (size_t i = 0; i < THEME_ICONS_MAX_SLOTS; i++) {
+        if (s_atlas.used[i]) {
+            lv_image_cache_drop(&s_atlas.cells[i]);
+        }
+    }
+    heap_caps_free(s_atlas.mem);
+    memset(&s_atlas, 0, sizeof(s_atlas));
+}
+
+size_t theme_icons_atlas_bytes(void)
+{
+    return s_atlas.bytes;
+}
+
+void theme_icons_cache_enable(bool enable)
+{
+    lv_image_cache_resize(enable ? CONFIG_LV_CACHE_DEF_SIZE : 0, true);
+    lv_image_header_cache_resize(enable ? CONFIG_LV_IMAGE_HEADER_CACHE_DEF_CNT : 0, true);
+}
+
+// ---- File system traffic ----
+
+static lv_fs_drv_t *s_io_drv;
+static void *(*s_io_open)(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode);
+static lv_fs_res_t (*s_io_read)(lv_fs_drv_t *drv, void *file_p, void *buf, uint32_t btr, uint32_t *br);
+static theme_icons_io_t s_io;
+
+// Decoders run on the draw threads too, hence the atomics
+static void *io_open_cb(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode)
+{
+    __atomic_fetch_add(&s_io.opens, 1, __ATOMIC_RELAXED);
+    return s_io_open(drv, path, mode);
+}
+
+static lv_fs_res_t io_read_cb(lv_fs_drv_t *drv, void *file_p, void *buf, uint32_t btr, uint32_t *br)
+{
+    lv_fs_res_t res = s_io_read(drv, file_p, buf, btr, br);
+    __atomic_fetch_add(&s_io.reads, 1, __ATOMIC_RELAXED);
+    if (res == LV_FS_RES_OK && br) {
+        __atomic_fetch_add(&s_io.read_bytes, *br, __ATOMIC_RELAXED);
+    }
+    return res;
+}
+
+bool theme_icons_io_hook(char letter)
+{
+    lv_fs_drv_t *drv = lv_fs_get_drv(letter);
+    if (!drv || !drv->open_cb || !drv->read_cb) {
+        return false;
+    }
+    if (drv == s_io_drv) {
+        return true;
+    }
+    if (s_io_drv) {
+        s_io_drv->open_cb = s_io_open;
+        s_io_drv->read_cb = s_io_read;
+    }
+    s_io_drv = drv;
+    s_io_open = drv->open_cb;
+    s_io_read = drv->read_cb;
+    drv->open_cb = io_open_cb;
+    drv->read_cb = io_read_cb;
+    return true;
+}
+
+void theme_icons_io_get(theme_icons_io_t *io)
+{
+    io->opens = __atomic_load_n(&s_io.opens, __ATOMIC_RELAXED);
+    io->reads = __atomic_load_n(&s_io.reads, __ATOMIC_RELAXED);
+    io->read_bytes = __atomic_load_n(&s_io.read_bytes, __ATOMIC_RELAXED);
+}
+
+// ---- Benchmark ----
+
+typedef struct {
+    lv_display_t *disp;
+    lv_obj_t *scene;
+    lv_timer_t *timer;
+    theme_icons_bench_mode_cb_t mode;
+    theme_icons_bench_done_cb_t done;
+    void *user;
+    uint8_t run;
+    uint32_t frame;             // frames forced in this run
+    uint64_t redraw_total_us;
+    theme_icons_io_t io_start;
+    int64_t start_us;
+    theme_icons_bench_result_t result;
+} theme_icons_bench_t;
+
+static theme_icons_bench_t s_bench;
+
+// Runs go one after the other: each needs its own cache setting, and alternating frames would
+// have the file run empty the cache for the atlas run
+static void begin_run(uint8_t run)
+{
+    s_bench.run = run;
+    s_bench.frame = 0;
+    s_bench.redraw_total_us = 0;
+    s_bench.result.runs[run].atlas = run == 1;
+    theme_icons_cache_enable(run == 1);
+    if (s_bench.mode) {
+        s_bench.mode(s_bench.scene, run == 1, s_bench.user);
+    }
+}
+
+static void end_run(void)
+{
+    theme_icons_bench_run_t *run = &s_bench.result.runs[s_bench.run];
+    theme_icons_io_t now;
+    theme_icons_io_get(&now);
+    run->io.opens = now.opens - s_bench.io_start.opens;
+    run->io.reads = now.reads - s_bench.io_start.reads;
+    run->io.read_bytes = now.read_bytes - s_bench.io_start.read_bytes;
+    if (run->frames > 0) {
+        run->redraw_avg_us = (uint32_t)(s_bench.redraw_total_us / run->frames);
+    }
+}
+
+static void finish(void)
+{
+    lv_timer_delete(s_bench.timer);
+    s_bench.timer = NULL;
+    theme_icons_cache_enable(true);
+
+    theme_icons_bench_result_t *r = &s_bench.result;
+    r->atlas_bytes = (uint32_t)theme_icons_atlas_bytes();
+    r->speedup_x100 = r->runs[1].redraw_avg_us > 0
+                      ? (uint32_t)((uint64_t)r->runs[0].redraw_avg_us * 100 / r->runs[1].redraw_avg_us) : 100;
+    r->elapsed_ms = (uint32_t)((esp_timer_get_time() - s_bench.start_us) / 1000);
+
+    theme_icons_bench_done_cb_t done = s_bench.done;
+    lv_obj_t *scene = s_bench.scene;
+    void *user = s_bench.user;
+    s_bench.scene = NULL;
+    if (done) {
+        done(scene, r, user);
+    }
+}
+
+static void bench_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    if (!lv_obj_is_valid(s_bench.scene)) {
+        ESP_LOGW(TAG, "Scene deleted, benchmark stopped");
+        s_bench.scene = NULL;
+        finish();
+        return;
+    }
+    if (s_bench.frame >= THEME_ICONS_BENCH_WARMUP_FRAMES + THEME_ICONS_BENCH_FRAMES) {
+        end_run();
+        if (s_bench.run == 0) {
+            begin_run(1);
+        } else {
+            finish();
+        }
+        return;
+    }
+
+    bool measuring = s_bench.frame >= THEME_ICONS_BENCH_WARMUP_FRAMES;
+    if (s_bench.frame == THEME_ICONS_BENCH_WARMUP_FRAMES) {
+        theme_icons_io_get(&s_bench.io_start);
+    }
+    s_bench.frame++;
+
+    int64_t t0 = esp_timer_get_time();
+    lv_obj_invalidate(s_bench.scene);
+    lv_refr_now(s_bench.disp);
+    uint32_t redraw_us = (uint32_t)(esp_timer_get_time() - t0);
+    if (!measuring) {
+        return;
+    }
+
+    theme_icons_bench_run_t *run = &s_bench.result.runs[s_bench.run];
+    if (run->frames == 0 || redraw_us < run->redraw_min_us) {
+        run->redraw_min_us = redraw_us;
+    }
+    run->redraw_max_us = LV_MAX(run->redraw_max_us, redraw_us);
+    run->frames++;
+    s_bench.redraw_total_us += redraw_us;
+}
+
+bool theme_icons_bench_start(lv_display_t *disp, lv_obj_t *scene, theme_icons_bench_mode_cb_t mode,
+                             theme_icons_bench_done_cb_t done, void *user)
+{
+    if (s_bench.timer || !disp || !scene) {
+        return false;
+    }
+    memset(&s_bench, 0, sizeof(s_bench));
+    s_bench.disp = disp;
+    s_bench.scene = scene;
+    s_bench.mode = mode;
+    s_bench.done = done;
+    s_bench.user = user;
+    s_bench.start_us = esp_timer_get_time();
+    if (!s_io_drv) {
+        ESP_LOGW(TAG, "File system traffic not counted, no drive hooked");
+    }
+
+    begin_run(0);
+    s_bench.timer = lv_timer_create(bench_timer_cb, THEME_ICONS_BENCH_PERIOD_MS, NULL);
+    ESP_LOGI(TAG, "Redrawing the tiles %d times with icons from files, then from the atlas",
+             THEME_ICONS_BENCH_WARMUP_FRAMES + THEME_ICONS_BENCH_FRAMES);
+    return true;
+}
+
+bool theme_icons_bench_running(void)
+{
+    return s_bench.timer != NULL;
+}
+
+void theme_icons_bench_log(const theme_icons_bench_result_t *r)
+{
+    ESP_LOGI(TAG, "Atlas %lu KB, image cache %lu KB, %lu ms", (unsigned long)(r->atlas_bytes / 1024),
+             (unsigned long)(CONFIG_LV_CACHE_DEF_SIZE / 1024), (unsigned long)r->elapsed_ms);
+    ESP_LOGI(TAG, "  %-6s %6s %10s %10s %10s %9s %9s %12s", "icons", "frames", "redraw_avg", "redraw_min",
+             "redraw_max", "opens/fr", "reads/fr", "bytes/fr");
+    for (size_t i = 0; i < 2; i++) {
+        const theme_icons_bench_run_t *run = &r->runs[i];
+        uint32_t frames = LV_MAX(run->frames, 1);
+        ESP_LOGI(TAG, "  %-6s %6lu %10lu %10lu %10lu %7lu.%lu %7lu.%lu %12llu", run->atlas ? "atlas" : "files",
+                 (unsigned long)run->frames, (unsigned long)run->redraw_avg_us, (unsigned long)run->redraw_min_us,
+                 (unsigned long)run->redraw_max_us, (unsigned long)(run->io.opens / frames),
+                 (unsigned long)(run->io.opens * 10 / frames % 10), (unsigned long)(run->io.reads / frames),
+                 (unsigned long)(run->io.reads * 10 / frames % 10),
+                 (unsigned long long)(run->io.read_bytes / frames));
+    }
+    ESP_LOGI(TAG, "Redraw speedup %lu.%02lux from the atlas", (unsigned long)(r->speedup_x100 / 100),
+             (unsigned long)(r->speedup_x100 % 100));
+}
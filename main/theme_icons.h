@@ -0,0 +1,106 @@
+#ifndef THEME_ICONS_H
+#define THEME_ICONS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Theme tile icons, decoded once.
+ *
+ * Theme icons are PNGs on the SD card. Pointing lv_image widgets at the files
+ * makes LodePNG read and decode them again whenever a tile is redrawn, since
+ * LVGL's image cache is only as large as CONFIG_LV_CACHE_DEF_SIZE allows.
+ * Instead the active theme's icons are decoded once into an atlas: one PSRAM
+ * block of square RGB565A8 cells, each icon scaled to fit its cell
+ * (premultiplied box filter) and centered. Every cell is a complete RGB565A8
+ * image (color plane, then alpha plane), because LVGL finds the alpha plane
+ * of an RGB565A8 image right after its color plane; theme_icons_atlas_get()
+ * hands out image descriptors pointing into the block. The cell is the icon
+ * box of the tiles, so their icons draw as a plain blend; a tile with another
+ * box scales its icon from memory.
+ *
+ * Everything else (the theme background, other images by path) goes through
+ * LVGL's image cache, bounded by CONFIG_LV_CACHE_DEF_SIZE.
+ *
+ * The I/O counter wraps the open and read callbacks of an LVGL file system
+ * drive, so every file opened or read through LVGL on that drive is counted.
+ *
+ * The benchmark redraws a scene of themed tiles the way render_bench does,
+ * first with the icons loaded from their files and the image cache off (the
+ * old behavior), then from the atlas with the cache on, and reports redraw
+ * time and file system traffic per frame for both. The caller switches the
+ * scene between the two through the mode callback.
+ *
+ * All functions run on the LVGL task or with the display locked.
+ */
+
+#define THEME_ICONS_MAX_CELL_PX             68      // largest icon box a tile asks for
+#define THEME_ICONS_MAX_SLOTS               12
+
+#define THEME_ICONS_BENCH_WARMUP_FRAMES     2       // per run, not measured
+#define THEME_ICONS_BENCH_FRAMES            24      // measured per run
+#define THEME_ICONS_BENCH_PERIOD_MS         5
+
+// Decode the icons into a new atlas of cell_px cells, slot i from srcs[i] (an LVGL image source
+// path, NULL or "" for none), and replace the current one. Icons that fail to decode are left
+// empty. Returns how many were decoded; the old atlas is kept if the new one can't be allocated.
+size_t theme_icons_atlas_build(const char *const *srcs, size_t count, uint16_t cell_px);
+// NULL if the slot is empty
+const lv_image_dsc_t *theme_icons_atlas_get(size_t slot);
+void theme_icons_atlas_free(void);
+size_t theme_icons_atlas_bytes(void);
+
+// Image cache at CONFIG_LV_CACHE_DEF_SIZE bytes and CONFIG_LV_IMAGE_HEADER_CACHE_DEF_CNT headers, or off
+void theme_icons_cache_enable(bool enable);
+
+typedef struct {
+    uint32_t opens;
+    uint32_t reads;
+    uint64_t read_bytes;
+} theme_icons_io_t;
+
+// Start counting on an LVGL drive (letter as in "A:"); only one drive is counted
+bool theme_icons_io_hook(char letter);
+void theme_icons_io_get(theme_icons_io_t *io);
+
+typedef struct {
+    bool atlas;
+    uint32_t frames;
+    uint32_t redraw_avg_us;
+    uint32_t redraw_min_us;
+    uint32_t redraw_max_us;
+    theme_icons_io_t io;        // over the measured frames
+} theme_icons_bench_run_t;
+
+typedef struct {
+    theme_icons_bench_run_t runs[2];    // files first, then atlas
+    uint32_t atlas_bytes;
+    uint32_t speedup_x100;      // redraw time from files over from the atlas
+    uint32_t elapsed_ms;
+} theme_icons_bench_result_t;
+
+// Rebuild the scene's icons from the files (atlas false) or the atlas (atlas true)
+typedef void (*theme_icons_bench_mode_cb_t)(lv_obj_t *scene, bool atlas, void *user);
+// Called on the LVGL task when the run is over; the scene is still there for the callback to
+// delete, or NULL if it was deleted during the run
+typedef void (*theme_icons_bench_done_cb_t)(lv_obj_t *scene, const theme_icons_bench_result_t *result,
+                                            void *user);
+
+// Start measuring scene on disp. Call with the display locked. False if a run is in progress.
+bool theme_icons_bench_start(lv_display_t *disp, lv_obj_t *scene, theme_icons_bench_mode_cb_t mode,
+                             theme_icons_bench_done_cb_t done, void *user);
+bool theme_icons_bench_running(void);
+
+void theme_icons_bench_log(const theme_icons_bench_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,269 @@
+#include "transport_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "transport_trace";
+
+#define RING_MASK   (TRANSPORT_TRACE_RING_SIZE - 1)
+#define RECORD_SIZE sizeof(transport_trace_record_t)
+
+_Static_assert((TRANSPORT_TRACE_RING_SIZE & RING_MASK) == 0, "trace ring size must be a power of two");
+
+bool transport_trace_init(transport_trace_t *trace, const char *const names[TRANSPORT_TRACE_CHANNELS])
+{
+    memset(trace, 0, sizeof(*trace));
+    for (int i = 0; i < TRANSPORT_TRACE_CHANNELS; i++) {
+        trace->names[i] = names[i];
+    }
+    trace->lock = xSemaphoreCreateMutex();
+    if (!trace->lock) {
+        return false;
+    }
+    trace->ring = heap_caps_malloc(TRANSPORT_TRACE_RING_SIZE, MALLOC_CAP_SPIRAM);
+    if (!trace->ring) {
+        ESP_LOGW(TAG, "No memory for the trace ring, counters only");
+    }
+    uint8_t level = trace->ring ? TRANSPORT_TRACE_RING : TRANSPORT_TRACE_COUNT;
+    trace->level = level < TRANSPORT_TRACE_MAX_LEVEL ? level : TRANSPORT_TRACE_MAX_LEVEL;
+    return true;
+}
+
+void transport_trace_set_level(transport_trace_t *trace, transport_trace_level_t level)
+{
+    if (level > TRANSPORT_TRACE_MAX_LEVEL) {
+        level = TRANSPORT_TRACE_MAX_LEVEL;
+    }
+    if (level >= TRANSPORT_TRACE_RING && !trace->ring) {
+        level = TRANSPORT_TRACE_COUNT;
+    }
+    trace->level = (uint8_t)level;
+}
+
+static void ring_write(transport_trace_t *trace, uint32_t pos, const void *src, size_t len)
+{
+    uint32_t off = pos & RING_MASK;
+    size_t first = TRANSPORT_TRACE_RING_SIZE - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(trace->ring + off, src, first);
+    memcpy(trace->ring, (const uint8_t *)src + first, len - first);
+}
+
+static void ring_read(const transport_trace_t *trace, uint32_t pos, void *dst, size_t len)
+{
+    uint32_t off = pos & RING_MASK;
+    size_t first = TRANSPORT_TRACE_RING_SIZE - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(dst, trace->ring + off, first);
+    memcpy((uint8_t *)dst + first, trace->ring, len - first);
+}
+
+static void ring_push(transport_trace_t *trace, const transport_trace_record_t *rec, const uint8_t *data)
+{
+    uint32_t need = (uint32_t)(RECORD_SIZE + rec->len);
+    while (trace->head - trace->tail + need > TRANSPORT_TRACE_RING_SIZE) {
+        transport_trace_record_t old;
+        ring_read(trace, trace->tail, &old, RECORD_SIZE);
+        trace->tail += (uint32_t)(RECORD_SIZE + old.len);
+        trace->records--;
+        trace->dropped++;
+    }
+    ring_write(trace, trace->head, rec, RECORD_SIZE);
+    ring_write(trace, trace->head + RECORD_SIZE, data, rec->len);
+    trace->head += need;
+    trace->records++;
+}
+
+static void format_chunk(const uint8_t *data, size_t len, char *hex, char *ascii)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    size_t n = len > TRANSPORT_TRACE_LOG_BYTES ? TRANSPORT_TRACE_LOG_BYTES : len;
+    for (size_t i = 0; i < n; i++) {
+        hex[i * 3] = digits[data[i] >> 4];
+        hex[i * 3 + 1] = digits[data[i] & 0x0F];
+        hex[i * 3 + 2] = ' ';
+        ascii[i] = (data[i] >= 32 && data[i] < 127) ? (char)data[i] : '.';
+    }
+    hex[n * 3] = '\0';
+    ascii[n] = '\0';
+}
+
+static const char *channel_name(const transport_trace_t *trace, uint8_t channel)
+{
+    return (channel < TRANSPORT_TRACE_CHANNELS && trace->names[channel]) ? trace->names[channel] : "?";
+}
+
+void transport_trace_record(transport_trace_t *trace, uint8_t channel, transport_trace_dir_t dir,
+                            const void *data, size_t len)
+{
+    if (channel >= TRANSPORT_TRACE_CHANNELS || !trace->lock) {
+        return;
+    }
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t lines = 0;
+    for (const uint8_t *p = bytes, *end = bytes + len; (p = memchr(p, '\n', (size_t)(end - p))) != NULL; p++) {
+        lines++;
+    }
+    uint8_t level = trace->level;
+
+    xSemaphoreTake(trace->lock, portMAX_DELAY);
+    transport_trace_counters_t *c = &trace->counters[channel];
+    c->bytes[dir] += (uint32_t)len;
+    c->lines[dir] += lines;
+    c->chunks[dir]++;
+    if (level >= TRANSPORT_TRACE_RING && trace->ring) {
+        transport_trace_record_t rec = {
+            .time_us = (uint32_t)esp_timer_get_time(),
+            .channel = channel,
+            .dir = (uint8_t)dir,
+        };
+        for (size_t done = 0; done < len; done += rec.len) {
+            rec.len = (uint16_t)((len - done) > TRANSPORT_TRACE_CHUNK_MAX ? TRANSPORT_TRACE_CHUNK_MAX : (len - done));
+            ring_push(trace, &rec, bytes + done);
+        }
+    }
+    xSemaphoreGive(trace->lock);
+
+#if TRANSPORT_TRACE_MAX_LEVEL >= TRANSPORT_TRACE_LOG
+    if (level >= TRANSPORT_TRACE_LOG) {
+        char hex[TRANSPORT_TRACE_LOG_BYTES * 3 + 1];
+        char ascii[TRANSPORT_TRACE_LOG_BYTES + 1];
+        format_chunk(bytes, len, hex, ascii);
+        ESP_LOGI(TAG, "[%s] %s %u bytes: [%s] \"%s\"%s", channel_name(trace, channel),
+                 dir == TRANSPORT_TRACE_RX ? "<<" : ">>", (unsigned)len, hex, ascii,
+                 len > TRANSPORT_TRACE_LOG_BYTES ? "..." : "");
+    }
+#endif
+}
+
+void transport_trace_get_counters(transport_trace_t *trace, uint8_t channel, transport_trace_counters_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (channel >= TRANSPORT_TRACE_CHANNELS || !trace->lock) {
+        return;
+    }
+    xSemaphoreTake(trace->lock, portMAX_DELAY);
+    *out = trace->counters[channel];
+    xSemaphoreGive(trace->lock);
+}
+
+void transport_trace_clear(transport_trace_t *trace)
+{
+    if (!trace->lock) {
+        return;
+    }
+    xSemaphoreTake(trace->lock, portMAX_DELAY);
+    trace->tail = trace->head;
+    trace->records = 0;
+    trace->dropped = 0;
+    memset(trace->counters, 0, sizeof(trace->counters));
+    xSemaphoreGive(trace->lock);
+}
+
+uint32_t transport_trace_dump_log(transport_trace_t *trace, uint32_t max_records)
+{
+    if (!trace->lock || !trace->ring) {
+        return 0;
+    }
+
+    xSemaphoreTake(trace->lock, portMAX_DELAY);
+    uint32_t pos = trace->tail;
+    uint32_t skip = trace->records > max_records ? trace->records - max_records : 0;
+    for (uint32_t i = 0; i < skip; i++) {
+        transport_trace_record_t rec;
+        ring_read(trace, pos, &rec, RECORD_SIZE);
+        pos += (uint32_t)(RECORD_SIZE + rec.len);
+    }
+    xSemaphoreGive(trace->lock);
+
+    // One record per lock hold, so the transports keep running while the log drains
+    uint32_t logged = 0;
+    for (;;) {
+        transport_trace_record_t rec;
+        uint8_t data[TRANSPORT_TRACE_LOG_BYTES];
+        xSemaphoreTake(trace->lock, portMAX_DELAY);
+        if ((int32_t)(pos - trace->tail) < 0) {
+            pos = trace->tail;      // overwritten while we were logging
+        }
+        bool more = pos != trace->head && logged < max_records;
+        if (more) {
+            ring_read(trace, pos, &rec, RECORD_SIZE);
+            ring_read(trace, pos + RECORD_SIZE, data, rec.len < sizeof(data) ? rec.len : sizeof(data));
+            pos += (uint32_t)(RECORD_SIZE + rec.len);
+        }
+        xSemaphoreGive(trace->lock);
+        if (!more) {
+            break;
+        }
+
+        char hex[TRANSPORT_TRACE_LOG_BYTES * 3 + 1];
+        char ascii[TRANSPORT_TRACE_LOG_BYTES + 1];
+        format_chunk(data, rec.len, hex, ascii);
+        ESP_LOGI(TAG, "%10lu [%s] %s %3u: [%s] \"%s\"%s", (unsigned long)rec.time_us,
+                 channel_name(trace, rec.channel), rec.dir == TRANSPORT_TRACE_RX ? "<<" : ">>",
+                 (unsigned)rec.len, hex, ascii, rec.len > TRANSPORT_TRACE_LOG_BYTES ? "..." : "");
+        logged++;
+    }
+
+    for (int ch = 0; ch < TRANSPORT_TRACE_CHANNELS; ch++) {
+        transport_trace_counters_t c;
+        transport_trace_get_counters(trace, (uint8_t)ch, &c);
+        ESP_LOGI(TAG, "[%s] rx %lu B / %lu lines / %lu chunks, tx %lu B / %lu lines / %lu chunks",
+                 channel_name(trace, (uint8_t)ch),
+                 (unsigned long)c.bytes[TRANSPORT_TRACE_RX], (unsigned long)c.lines[TRANSPORT_TRACE_RX],
+                 (unsigned long)c.chunks[TRANSPORT_TRACE_RX], (unsigned long)c.bytes[TRANSPORT_TRACE_TX],
+                 (unsigned long)c.lines[TRANSPORT_TRACE_TX], (unsigned long)c.chunks[TRANSPORT_TRACE_TX]);
+    }
+    return logged;
+}
+
+bool transport_trace_dump_file(transport_trace_t *trace, const char *path)
+{
+    if (!trace->lock || !trace->ring) {
+        return false;
+    }
+    // Snapshot first so the SD write doesn't stall the transports
+    uint8_t *copy = heap_caps_malloc(TRANSPORT_TRACE_RING_SIZE, MALLOC_CAP_SPIRAM);
+    if (!copy) {
+        return false;
+    }
+
+    transport_trace_file_header_t header = {
+        .magic = TRANSPORT_TRACE_FILE_MAGIC,
+        .version = 1,
+        .channel_count = TRANSPORT_TRACE_CHANNELS,
+    };
+    for (int ch = 0; ch < TRANSPORT_TRACE_CHANNELS; ch++) {
+        strncpy(header.names[ch], channel_name(trace, (uint8_t)ch), sizeof(header.names[ch]) - 1);
+    }
+
+    xSemaphoreTake(trace->lock, portMAX_DELAY);
+    uint32_t used = trace->head - trace->tail;
+    ring_read(trace, trace->tail, copy, used);
+    header.records = trace->records;
+    header.dropped = trace->dropped;
+    header.dump_time_us = (uint64_t)esp_timer_get_time();
+    xSemaphoreGive(trace->lock);
+
+    FILE *f = fopen(path, "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(copy, 1, used, f) == used;
+        ok = (fclose(f) == 0) && ok;
+    }
+    heap_caps_free(copy);
+    if (ok) {
+        ESP_LOGI(TAG, "Wrote %lu records (%lu bytes) to %s", (unsigned long)header.records,
+                 (unsigned long)used, path);
+    } else {
+        ESP_LOGW(TAG, "Failed to write trace to %s", path);
+    }
+    return ok;
+}
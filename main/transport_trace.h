@@ -0,0 +1,121 @@
+#ifndef TRANSPORT_TRACE_H
+#define TRANSPORT_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Byte-level trace of the board transports (Grove, USB, MBus).
+ *
+ * Every chunk read from or written to a transport is counted per channel
+ * (bytes, lines, chunks). At TRANSPORT_TRACE_RING and above the chunk is
+ * also copied into a binary ring in PSRAM, oldest records overwritten
+ * first. Nothing is formatted on the hot path. The ring is decoded only
+ * when it is dumped: to the log, or to a file on SD for offline reading.
+ * TRANSPORT_TRACE_LOG additionally logs each chunk as it passes (hex +
+ * ASCII). That is the old inline dump, meant for bench debugging only.
+ *
+ * TRANSPORT_TRACE_MAX_LEVEL is the compile-time ceiling. Below
+ * TRANSPORT_TRACE_COUNT the calls compile to nothing. The runtime level
+ * can only lower it.
+ *
+ * Dump file: transport_trace_file_header_t, then the records oldest
+ * first, each a transport_trace_record_t followed by len payload bytes.
+ */
+
+typedef enum {
+    TRANSPORT_TRACE_OFF     = 0,
+    TRANSPORT_TRACE_COUNT   = 1,    // counters only
+    TRANSPORT_TRACE_RING    = 2,    // counters + binary ring
+    TRANSPORT_TRACE_LOG     = 3,    // all of the above + a log line per chunk
+} transport_trace_level_t;
+
+#ifndef TRANSPORT_TRACE_MAX_LEVEL
+#define TRANSPORT_TRACE_MAX_LEVEL       TRANSPORT_TRACE_LOG
+#endif
+
+#define TRANSPORT_TRACE_CHANNELS        3
+#define TRANSPORT_TRACE_RING_SIZE       (64 * 1024)    // power of two
+#define TRANSPORT_TRACE_CHUNK_MAX       512            // longer chunks are split into several records
+#define TRANSPORT_TRACE_LOG_BYTES       32             // bytes shown per chunk or record in the log
+#define TRANSPORT_TRACE_FILE_MAGIC      0x31525454u    // "TTR1"
+
+typedef enum {
+    TRANSPORT_TRACE_RX = 0,
+    TRANSPORT_TRACE_TX = 1,
+} transport_trace_dir_t;
+
+typedef struct {
+    uint32_t time_us;       // esp_timer, low 32 bits
+    uint8_t channel;
+    uint8_t dir;            // transport_trace_dir_t
+    uint16_t len;
+} transport_trace_record_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t channel_count;
+    uint64_t dump_time_us;  // esp_timer at dump time, to unwrap record times
+    uint32_t records;
+    uint32_t dropped;       // records overwritten since init
+    char names[TRANSPORT_TRACE_CHANNELS][8];
+} transport_trace_file_header_t;
+
+typedef struct {
+    uint32_t bytes[2];      // by transport_trace_dir_t
+    uint32_t lines[2];
+    uint32_t chunks[2];
+} transport_trace_counters_t;
+
+typedef struct {
+    SemaphoreHandle_t lock;
+    volatile uint8_t level;
+    uint8_t *ring;          // PSRAM, TRANSPORT_TRACE_RING_SIZE
+    uint32_t head;          // byte positions, free running
+    uint32_t tail;
+    uint32_t records;
+    uint32_t dropped;
+    const char *names[TRANSPORT_TRACE_CHANNELS];
+    transport_trace_counters_t counters[TRANSPORT_TRACE_CHANNELS];
+} transport_trace_t;
+
+// names[i] labels channel i in dumps. Without the ring buffer the trace falls back to counters.
+bool transport_trace_init(transport_trace_t *trace, const char *const names[TRANSPORT_TRACE_CHANNELS]);
+void transport_trace_set_level(transport_trace_t *trace, transport_trace_level_t level);
+
+void transport_trace_record(transport_trace_t *trace, uint8_t channel, transport_trace_dir_t dir,
+                            const void *data, size_t len);
+
+static inline void transport_trace(transport_trace_t *trace, uint8_t channel, transport_trace_dir_t dir,
+                                   const void *data, size_t len)
+{
+#if TRANSPORT_TRACE_MAX_LEVEL >= TRANSPORT_TRACE_COUNT
+    if (len > 0 && trace->level >= TRANSPORT_TRACE_COUNT) {
+        transport_trace_record(trace, channel, dir, data, len);
+    }
+#else
+    (void)trace; (void)channel; (void)dir; (void)data; (void)len;
+#endif
+}
+
+void transport_trace_get_counters(transport_trace_t *trace, uint8_t channel, transport_trace_counters_t *out);
+void transport_trace_clear(transport_trace_t *trace);
+
+// Log the newest max_records records, oldest of them first. Returns how many were logged.
+uint32_t transport_trace_dump_log(transport_trace_t *trace, uint32_t max_records);
+// Write the ring to path (see the file format above).
+bool transport_trace_dump_file(transport_trace_t *trace, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+#include "ui_cmd.h"
+
+#include <string.h>
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+
+static const char *TAG = "ui_cmd";
+
+#define LVGL_TASK_NAME  "taskLVGL"      // esp_lvgl_port's
+
+typedef struct {
+    ui_cmd_fn_t fn;
+    int64_t posted_us;
+    SemaphoreHandle_t done;     // ui_cmd_call() only
+    uint8_t len;
+    uint8_t data[UI_CMD_DATA_MAX] __attribute__((aligned(8)));
+} ui_cmd_t;
+
+static QueueHandle_t s_queue;
+static TaskHandle_t s_lvgl_task;
+static ui_cmd_stats_t s_stats;
+
+static void run_cmd(ui_cmd_t *cmd)
+{
+    int64_t start_us = esp_timer_get_time();
+    cmd->fn(cmd->len ? cmd->data : NULL);
+    int64_t end_us = esp_timer_get_time();
+
+    uint32_t latency_us = (uint32_t)(start_us - cmd->posted_us);
+    uint32_t run_us = (uint32_t)(end_us - start_us);
+    s_stats.run++;
+    if (latency_us > s_stats.max_latency_us) {
+        s_stats.max_latency_us = latency_us;
+    }
+    if (run_us > s_stats.max_run_us) {
+        s_stats.max_run_us = run_us;
+    }
+    if (run_us > UI_CMD_SLOW_US) {
+        ESP_LOGW(TAG, "Command %p ran %lu ms on the LVGL task", (void *)cmd->fn, (unsigned long)(run_us / 1000));
+    }
+    if (cmd->done) {
+        xSemaphoreGive(cmd->done);
+    }
+}
+
+static void drain_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    s_lvgl_task = xTaskGetCurrentTaskHandle();
+
+    UBaseType_t depth = uxQueueMessagesWaiting(s_queue);
+    if (depth > s_stats.max_depth) {
+        s_stats.max_depth = (uint8_t)depth;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    ui_cmd_t cmd;
+    while (xQueueReceive(s_queue, &cmd, 0) == pdTRUE) {
+        run_cmd(&cmd);
+        if (esp_timer_get_time() - start_us >= UI_CMD_SLICE_US) {
+            break;
+        }
+    }
+}
+
+bool ui_cmd_init(void)
+{
+    if (s_queue) {
+        return true;
+    }
+    s_queue = xQueueCreate(UI_CMD_QUEUE_LEN, sizeof(ui_cmd_t));
+    if (!s_queue) {
+        ESP_LOGE(TAG, "No memory for the UI command queue");
+        return false;
+    }
+    // Event and timer callbacks can run before the first drain; a call from one must not queue and wait on
+    // its own task. The drain still takes the task it runs on, for a port that names it differently.
+    s_lvgl_task = xTaskGetHandle(LVGL_TASK_NAME);
+    if (!s_lvgl_task) {
+        ESP_LOGW(TAG, "No %s task yet, calls from the LVGL task block until the first drain", LVGL_TASK_NAME);
+    }
+    lv_timer_t *timer = lv_timer_create(drain_timer_cb, UI_CMD_PERIOD_MS, NULL);
+    lv_timer_ready(timer);
+    return true;
+}
+
+static bool enqueue(ui_cmd_fn_t fn, const void *data, size_t len, TickType_t wait, SemaphoreHandle_t done)
+{
+    if (!s_queue || !fn || len > UI_CMD_DATA_MAX || (len > 0 && !data)) {
+        ESP_LOGE(TAG, "Can't post command %p (%u bytes)", (void *)fn, (unsigned)len);
+        return false;
+    }
+    ui_cmd_t cmd = {
+        .fn = fn,
+        .posted_us = esp_timer_get_time(),
+        .done = done,
+        .len = (uint8_t)len,
+    };
+    if (len > 0) {
+        memcpy(cmd.data, data, len);
+    }
+    if (xQueueSend(s_queue, &cmd, wait) != pdTRUE) {
+        __atomic_fetch_add(&s_stats.dropped, 1, __ATOMIC_RELAXED);
+        ESP_LOGW(TAG, "UI command queue full, command %p dropped", (void *)fn);
+        return false;
+    }
+    __atomic_fetch_add(&s_stats.posted, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+bool ui_cmd_post(ui_cmd_fn_t fn, const void *data, size_t len, TickType_t wait)
+{
+    return enqueue(fn, data, len, wait, NULL);
+}
+
+bool ui_cmd_call(ui_cmd_fn_t fn, const void *data, size_t len, TickType_t wait)
+{
+    if (s_lvgl_task && xTaskGetCurrentTaskHandle() == s_lvgl_task) {
+        // Queuing would wait on ourselves
+        if (!fn || len > UI_CMD_DATA_MAX || (len > 0 && !data)) {
+            return false;
+        }
+        ui_cmd_t cmd = { .fn = fn, .posted_us = esp_timer_get_time(), .len = (uint8_t)len };
+        if (len > 0) {
+            memcpy(cmd.data, data, len);
+        }
+        __atomic_fetch_add(&s_stats.posted, 1, __ATOMIC_RELAXED);
+        run_cmd(&cmd);
+        return true;
+    }
+
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    if (!done) {
+        return false;
+    }
+    bool queued = enqueue(fn, data, len, wait, done);
+    if (queued) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+    return queued;
+}
+
+void ui_cmd_get_stats(ui_cmd_stats_t *out)
+{
+    if (out) {
+        *out = s_stats;
+    }
+}
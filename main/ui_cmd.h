@@ -0,0 +1,60 @@
+#ifndef UI_CMD_H
+#define UI_CMD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * UI command queue: run small pieces of UI work on the LVGL task.
+ *
+ * A worker that only needs to show a result posts a function and up to
+ * UI_CMD_DATA_MAX bytes of arguments, which are copied into the queue. A
+ * timer on the LVGL task runs queued commands in order, with the display
+ * already locked, and stops after UI_CMD_SLICE_US so touch input and
+ * rendering get their turn; the rest wait for the next tick. The worker
+ * never takes the display lock and never waits for a frame to finish.
+ *
+ * ui_cmd_call() waits until the command has run, for callers that need
+ * its effect before going on; never call it while holding the display
+ * lock. Posting from the LVGL task itself is allowed; calling from it runs
+ * the command right away.
+ */
+
+#define UI_CMD_QUEUE_LEN        32
+#define UI_CMD_DATA_MAX         48
+#define UI_CMD_PERIOD_MS        10
+#define UI_CMD_SLICE_US         (8 * 1000)
+#define UI_CMD_SLOW_US          (20 * 1000)     // a command running longer than this is logged
+
+// data points to the command's copy of what was posted; NULL when nothing was
+typedef void (*ui_cmd_fn_t)(void *data);
+
+typedef struct {
+    uint32_t posted;
+    uint32_t run;
+    uint32_t dropped;           // queue full for longer than the poster would wait
+    uint32_t max_latency_us;    // posted until started
+    uint32_t max_run_us;
+    uint8_t max_depth;
+} ui_cmd_stats_t;
+
+// Create the queue and the draining timer. Call with the display locked, once the LVGL port has started.
+bool ui_cmd_init(void);
+
+// wait: how long to wait for room in the queue. False if the command was not queued.
+bool ui_cmd_post(ui_cmd_fn_t fn, const void *data, size_t len, TickType_t wait);
+bool ui_cmd_call(ui_cmd_fn_t fn, const void *data, size_t len, TickType_t wait);
+
+void ui_cmd_get_stats(ui_cmd_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,6 +1,8 @@
 #include "ui_components.h"
 
+#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
 static lv_color_t badge_tint(ui_badge_type_t type)
 {
@@ -350,3 +352,412 @@ void ui_comp_show_toast(lv_obj_t *parent, const char *message, uint32_t duration
 
     lv_timer_create(toast_timer_cb, duration_ms ? duration_ms : 1800, toast);
 }
+
+#define UI_VLIST_FLAG           LV_OBJ_FLAG_USER_1
+#define UI_VLIST_SPARE_ROWS     2
+
+typedef struct {
+    lv_coord_t row_height;
+    lv_coord_t row_pitch;
+    ui_comp_vlist_create_cb_t create_row_cb;
+    ui_comp_vlist_bind_cb_t bind_row_cb;
+    void *user_data;
+    uint32_t count;
+    lv_obj_t *spacer;           // last child of the content, gives the list its scroll height
+    lv_obj_t **rows;
+    int32_t *bound;             // item index bound to each pool slot, -1 when unused
+    uint32_t pool_size;
+} ui_vlist_t;
+
+static ui_vlist_t *vlist_get(lv_obj_t *list)
+{
+    if (!list || !lv_obj_has_flag(list, UI_VLIST_FLAG)) {
+        return NULL;
+    }
+    return (ui_vlist_t *)lv_obj_get_user_data(list);
+}
+
+static void vlist_grow_pool(lv_obj_t *list, ui_vlist_t *vl)
+{
+    lv_coord_t viewport = lv_obj_get_content_height(list);
+    uint32_t wanted = (uint32_t)((viewport + vl->row_pitch - 1) / vl->row_pitch) + UI_VLIST_SPARE_ROWS;
+    if (wanted <= vl->pool_size) {
+        return;
+    }
+
+    lv_obj_t **rows = lv_realloc(vl->rows, wanted * sizeof(lv_obj_t *));
+    int32_t *bound = lv_realloc(vl->bound, wanted * sizeof(int32_t));
+    if (rows) {
+        vl->rows = rows;
+    }
+    if (bound) {
+        vl->bound = bound;
+    }
+    if (!rows || !bound) {
+        return;
+    }
+
+    // Slots are addressed as index % pool_size, so a resize invalidates every binding
+    for (uint32_t i = 0; i < vl->pool_size; i++) {
+        vl->bound[i] = -1;
+        lv_obj_add_flag(vl->rows[i], LV_OBJ_FLAG_HIDDEN);
+    }
+
+    for (uint32_t i = vl->pool_size; i < wanted; i++) {
+        lv_obj_t *row = lv_obj_create(list);
+        lv_obj_set_size(row, lv_pct(100), vl->row_height);
+        lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+        if (vl->create_row_cb) {
+            vl->create_row_cb(row, vl->user_data);
+        }
+        vl->rows[i] = row;
+        vl->bound[i] = -1;
+    }
+    vl->pool_size = wanted;
+}
+
+static void vlist_sync(lv_obj_t *list, ui_vlist_t *vl, bool rebind)
+{
+    if (vl->pool_size == 0) {
+        return;
+    }
+
+    lv_coord_t scroll_y = lv_obj_get_scroll_y(list);
+    uint32_t first = scroll_y > 0 ? (uint32_t)(scroll_y / vl->row_pitch) : 0;
+    uint32_t last = first + vl->pool_size;
+    if (last > vl->count) {
+        last = vl->count;
+    }
+    if (first > last) {
+        first = last;
+    }
+
+    for (uint32_t slot = 0; slot < vl->pool_size; slot++) {
+        int32_t index = vl->bound[slot];
+        if (index >= 0 && ((uint32_t)index < first || (uint32_t)index >= last)) {
+            lv_obj_add_flag(vl->rows[slot], LV_OBJ_FLAG_HIDDEN);
+            vl->bound[slot] = -1;
+        }
+    }
+
+    for (uint32_t index = first; index < last; index++) {
+        uint32_t slot = index % vl->pool_size;
+        lv_obj_t *row = vl->rows[slot];
+        if (vl->bound[slot] == (int32_t)index && !rebind) {
+            continue;
+        }
+        if (vl->bound[slot] != (int32_t)index) {
+            lv_obj_set_y(row, (lv_coord_t)index * vl->row_pitch);
+            lv_obj_clear_flag(row, LV_OBJ_FLAG_HIDDEN);
+            vl->bound[slot] = (int32_t)index;
+        }
+        if (vl->bind_row_cb) {
+            vl->bind_row_cb(row, index, vl->user_data);
+        }
+    }
+}
+
+static void vlist_event_cb(lv_event_t *e)
+{
+    lv_obj_t *list = lv_event_get_current_target(e);
+    ui_vlist_t *vl = vlist_get(list);
+    if (!vl) {
+        return;
+    }
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_SCROLL:
+            vlist_sync(list, vl, false);
+            break;
+        case LV_EVENT_SIZE_CHANGED:
+            vlist_grow_pool(list, vl);
+            vlist_sync(list, vl, false);
+            break;
+        case LV_EVENT_DELETE:
+            lv_obj_set_user_data(list, NULL);
+            lv_obj_clear_flag(list, UI_VLIST_FLAG);
+            lv_free(vl->rows);
+            lv_free(vl->bound);
+            lv_free(vl);
+            break;
+        default:
+            break;
+    }
+}
+
+lv_obj_t *ui_comp_create_vlist(
+    lv_obj_t *parent,
+    lv_coord_t row_height,
+    lv_coord_t row_gap,
+    ui_comp_vlist_create_cb_t create_row_cb,
+    ui_comp_vlist_bind_cb_t bind_row_cb,
+    void *user_data)
+{
+    ui_vlist_t *vl = lv_malloc_zeroed(sizeof(ui_vlist_t));
+    if (!vl) {
+        return NULL;
+    }
+    vl->row_height = row_height > 0 ? row_height : 1;
+    vl->row_pitch = vl->row_height + (row_gap > 0 ? row_gap : 0);
+    vl->create_row_cb = create_row_cb;
+    vl->bind_row_cb = bind_row_cb;
+    vl->user_data = user_data;
+
+    lv_obj_t *list = lv_obj_create(parent);
+    lv_obj_set_layout(list, LV_LAYOUT_NONE);
+    lv_obj_set_scroll_dir(list, LV_DIR_VER);
+    lv_obj_set_user_data(list, vl);
+    lv_obj_add_flag(list, UI_VLIST_FLAG);
+
+    vl->spacer = lv_obj_create(list);
+    lv_obj_remove_style_all(vl->spacer);
+    lv_obj_set_size(vl->spacer, 1, 1);
+    lv_obj_clear_flag(vl->spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(vl->spacer, LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_add_event_cb(list, vlist_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(list, vlist_event_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_add_event_cb(list, vlist_event_cb, LV_EVENT_DELETE, NULL);
+
+    return list;
+}
+
+void ui_comp_vlist_set_count(lv_obj_t *list, uint32_t count)
+{
+    ui_vlist_t *vl = vlist_get(list);
+    if (!vl) {
+        return;
+    }
+
+    vl->count = count;
+    if (count > 0) {
+        lv_obj_set_y(vl->spacer, (lv_coord_t)(count - 1) * vl->row_pitch + vl->row_height - 1);
+        lv_obj_clear_flag(vl->spacer, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(vl->spacer, LV_OBJ_FLAG_HIDDEN);
+    }
+    // Pull the scroll position back in range if the list got shorter. The spacer's
+    // new position is not laid out yet, so compute the limit instead of asking LVGL.
+    lv_coord_t content = count > 0 ? (lv_coord_t)(count - 1) * vl->row_pitch + vl->row_height : 0;
+    lv_coord_t max_scroll = content - lv_obj_get_content_height(list);
+    if (max_scroll < 0) {
+        max_scroll = 0;
+    }
+    lv_coord_t scroll_y = lv_obj_get_scroll_y(list);
+    if (scroll_y > max_scroll) {
+        lv_obj_scroll_by(list, 0, scroll_y - max_scroll, LV_ANIM_OFF);
+    }
+
+    vlist_grow_pool(list, vl);
+    vlist_sync(list, vl, true);
+}
+
+uint32_t ui_comp_vlist_get_count(lv_obj_t *list)
+{
+    ui_vlist_t *vl = vlist_get(list);
+    return vl ? vl->count : 0;
+}
+
+void ui_comp_vlist_refresh(lv_obj_t *list)
+{
+    ui_vlist_t *vl = vlist_get(list);
+    if (vl) {
+        vlist_sync(list, vl, true);
+    }
+}
+
+int32_t ui_comp_vlist_row_index(lv_obj_t *obj)
+{
+    while (obj) {
+        lv_obj_t *parent = lv_obj_get_parent(obj);
+        ui_vlist_t *vl = vlist_get(parent);
+        if (vl) {
+            for (uint32_t slot = 0; slot < vl->pool_size; slot++) {
+                if (vl->rows[slot] == obj) {
+                    return vl->bound[slot];
+                }
+            }
+            return -1;
+        }
+        obj = parent;
+    }
+    return -1;
+}
+
+uint32_t ui_comp_vlist_get_pool_size(lv_obj_t *list)
+{
+    ui_vlist_t *vl = vlist_get(list);
+    return vl ? vl->pool_size : 0;
+}
+
+static ui_comp_update_counters_t s_update_counters;
+static bool s_rendering;
+
+static void row_key_delete_cb(lv_event_t *e)
+{
+    lv_obj_t *row = lv_event_get_current_target(e);
+    lv_free(lv_obj_get_user_data(row));
+    lv_obj_set_user_data(row, NULL);
+}
+
+static const char *row_key(lv_obj_t *row)
+{
+    const char *key = (const char *)lv_obj_get_user_data(row);
+    return key ? key : "";
+}
+
+void ui_comp_keyed_list_sync(
+    lv_obj_t *list,
+    uint32_t count,
+    ui_comp_keyed_key_cb_t key_cb,
+    ui_comp_vlist_create_cb_t create_row_cb,
+    ui_comp_vlist_bind_cb_t bind_row_cb,
+    void *user_data,
+    ui_comp_keyed_stats_t *stats_out)
+{
+    ui_comp_keyed_stats_t stats = {0};
+    if (!list || !key_cb) {
+        if (stats_out) {
+            *stats_out = stats;
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const char *key = key_cb(i, user_data);
+        if (!key) {
+            key = "";
+        }
+
+        // Rows before i are already reconciled, so only look at the tail
+        lv_obj_t *row = NULL;
+        uint32_t child_count = lv_obj_get_child_count(list);
+        for (uint32_t j = i; j < child_count; j++) {
+            lv_obj_t *child = lv_obj_get_child(list, (int32_t)j);
+            if (strcmp(row_key(child), key) == 0) {
+                row = child;
+                if (j != i) {
+                    lv_obj_move_to_index(row, (int32_t)i);
+                    stats.moved++;
+                }
+                break;
+            }
+        }
+
+        if (!row) {
+            row = lv_obj_create(list);
+            lv_obj_set_user_data(row, lv_strdup(key));
+            lv_obj_add_event_cb(row, row_key_delete_cb, LV_EVENT_DELETE, NULL);
+            if (create_row_cb) {
+                create_row_cb(row, user_data);
+            }
+            lv_obj_move_to_index(row, (int32_t)i);
+            stats.created++;
+        }
+
+        if (bind_row_cb) {
+            bind_row_cb(row, i, user_data);
+        }
+    }
+
+    while (lv_obj_get_child_count(list) > count) {
+        lv_obj_delete(lv_obj_get_child(list, -1));
+        stats.deleted++;
+    }
+
+    s_update_counters.objects_touched += stats.created + stats.moved + stats.deleted;
+    if (stats_out) {
+        *stats_out = stats;
+    }
+}
+
+bool ui_comp_patch_label_text(lv_obj_t *label, const char *text)
+{
+    if (!label) {
+        return false;
+    }
+    const char *current = lv_label_get_text(label);
+    if (!text) {
+        text = "";
+    }
+    if (current && strcmp(current, text) == 0) {
+        return false;
+    }
+    lv_label_set_text(label, text);
+    s_update_counters.objects_touched++;
+    return true;
+}
+
+bool ui_comp_patch_label_text_fmt(lv_obj_t *label, const char *fmt, ...)
+{
+    char text[160];
+    va_list args;
+    va_start(args, fmt);
+    lv_vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return ui_comp_patch_label_text(label, text);
+}
+
+bool ui_comp_patch_text_color(lv_obj_t *obj, lv_color_t color)
+{
+    if (!obj || lv_color_eq(lv_obj_get_style_text_color(obj, LV_PART_MAIN), color)) {
+        return false;
+    }
+    lv_obj_set_style_text_color(obj, color, 0);
+    s_update_counters.objects_touched++;
+    return true;
+}
+
+bool ui_comp_patch_flag(lv_obj_t *obj, lv_obj_flag_t flag, bool set)
+{
+    if (!obj || lv_obj_has_flag(obj, flag) == set) {
+        return false;
+    }
+    if (set) {
+        lv_obj_add_flag(obj, flag);
+    } else {
+        lv_obj_clear_flag(obj, flag);
+    }
+    s_update_counters.objects_touched++;
+    return true;
+}
+
+static void invalidation_event_cb(lv_event_t *e)
+{
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_RENDER_START:
+            s_rendering = true;
+            break;
+        case LV_EVENT_RENDER_READY:
+            s_rendering = false;
+            break;
+        case LV_EVENT_INVALIDATE_AREA: {
+            // The renderer probes buffer rounding with this event too, skip those
+            const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+            if (!s_rendering && area) {
+                s_update_counters.invalidated_px += lv_area_get_size(area);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ui_comp_track_invalidations(lv_display_t *disp)
+{
+    if (!disp) {
+        return;
+    }
+    lv_display_add_event_cb(disp, invalidation_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, invalidation_event_cb, LV_EVENT_RENDER_READY, NULL);
+    lv_display_add_event_cb(disp, invalidation_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+}
+
+void ui_comp_get_update_counters(ui_comp_update_counters_t *out)
+{
+    if (out) {
+        *out = s_update_counters;
+    }
+}
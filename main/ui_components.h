@@ -47,6 +47,71 @@ lv_obj_t *ui_comp_create_list_row(
 void ui_comp_create_modal(lv_obj_t *parent, lv_coord_t width, lv_coord_t height, lv_obj_t **overlay_out, lv_obj_t **card_out);
 void ui_comp_show_toast(lv_obj_t *parent, const char *message, uint32_t duration_ms);
 
+/*
+ * Virtual list: a scrollable container with a fixed pool of equally tall rows,
+ * sized to the viewport. Rows are built once by create_row_cb and rebound to
+ * item data by bind_row_cb as the list scrolls, so the object count does not
+ * depend on the number of items. The container uses no layout; style it like
+ * any other object but leave its flex flow alone.
+ */
+typedef void (*ui_comp_vlist_create_cb_t)(lv_obj_t *row, void *user_data);
+typedef void (*ui_comp_vlist_bind_cb_t)(lv_obj_t *row, uint32_t index, void *user_data);
+
+lv_obj_t *ui_comp_create_vlist(
+    lv_obj_t *parent,
+    lv_coord_t row_height,
+    lv_coord_t row_gap,
+    ui_comp_vlist_create_cb_t create_row_cb,
+    ui_comp_vlist_bind_cb_t bind_row_cb,
+    void *user_data);
+// Set the item count and rebind every visible row.
+void ui_comp_vlist_set_count(lv_obj_t *list, uint32_t count);
+uint32_t ui_comp_vlist_get_count(lv_obj_t *list);
+// Rebind visible rows after items changed in place.
+void ui_comp_vlist_refresh(lv_obj_t *list);
+// Item index of the row containing obj (the row itself or any child), -1 if none.
+int32_t ui_comp_vlist_row_index(lv_obj_t *obj);
+uint32_t ui_comp_vlist_get_pool_size(lv_obj_t *list);
+
+/*
+ * Keyed list: reconciles the rows of a flex container with an item array by a
+ * stable string key (BSSID, MAC, ...). Rows whose key is still present are kept
+ * and moved into place, new keys get a row from create_row_cb and rows of keys
+ * that disappeared are deleted. bind_row_cb runs for every item and should use
+ * the ui_comp_patch_* helpers so unchanged rows are not invalidated.
+ */
+typedef const char *(*ui_comp_keyed_key_cb_t)(uint32_t index, void *user_data);
+
+typedef struct {
+    uint32_t created;
+    uint32_t moved;
+    uint32_t deleted;
+} ui_comp_keyed_stats_t;
+
+void ui_comp_keyed_list_sync(
+    lv_obj_t *list,
+    uint32_t count,
+    ui_comp_keyed_key_cb_t key_cb,
+    ui_comp_vlist_create_cb_t create_row_cb,
+    ui_comp_vlist_bind_cb_t bind_row_cb,
+    void *user_data,
+    ui_comp_keyed_stats_t *stats_out);
+
+// Patch helpers: only touch (and invalidate) the object when the value differs.
+bool ui_comp_patch_label_text(lv_obj_t *label, const char *text);
+bool ui_comp_patch_label_text_fmt(lv_obj_t *label, const char *fmt, ...) LV_FORMAT_ATTRIBUTE(2, 3);
+bool ui_comp_patch_text_color(lv_obj_t *obj, lv_color_t color);
+bool ui_comp_patch_flag(lv_obj_t *obj, lv_obj_flag_t flag, bool set);
+
+// Counters for measuring how much of the screen an update dirties.
+typedef struct {
+    uint32_t objects_touched;   // objects changed through the patch helpers or created/moved/deleted by a sync
+    uint32_t invalidated_px;    // area passed to lv_inv_area() outside of rendering
+} ui_comp_update_counters_t;
+
+void ui_comp_track_invalidations(lv_display_t *disp);
+void ui_comp_get_update_counters(ui_comp_update_counters_t *out);
+
 #ifdef __cplusplus
 }
 #endif
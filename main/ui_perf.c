@@ -0,0 +1,552 @@
+#include "ui_perf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "bsp/m5stack_tab5.h"
+#include "ui_components.h"
+#include "render_cores.h"
+
+static const char *TAG = "ui_perf";
+
+const uint16_t ui_perf_lock_bucket_ms[UI_PERF_LOCK_BUCKETS - 1] = { 1, 2, 5, 10, 20, 50, 100, 200, 500 };
+
+#define UI_PERF_LOG_QUEUE_LEN       4
+#define UI_PERF_LOG_FLUSH_ROWS      10
+#define UI_PERF_OVERLAY_LOCK_ROWS   2
+
+typedef struct {
+    int64_t refr_start_us;
+    int64_t flush_start_us;
+    int64_t frame_flush_us;     // flush time of the frame being refreshed
+    int64_t window_start_us;
+    uint32_t frames;
+    uint32_t over_budget;
+    int64_t frame_total_us;
+    int64_t render_total_us;
+    int64_t flush_total_us;
+    uint32_t frame_max_us;
+    uint32_t render_max_us;
+    uint32_t flush_max_us;
+    uint32_t invalidated_base;
+} ui_perf_frames_t;
+
+// Written only by the lock's holder; sampled by the LVGL task, which holds it while sampling
+typedef struct {
+    TaskHandle_t holder;
+    uint32_t depth;
+    int64_t since_us;
+    const char *site;
+    uint8_t count;
+    ui_perf_lock_stat_t tasks[UI_PERF_LOCK_TASKS];
+    ui_perf_lock_hist_t hist;
+    int64_t last_warn_us;
+    uint32_t warn_suppressed;
+} ui_perf_locks_t;
+
+typedef struct {
+    QueueHandle_t queue;
+    TaskHandle_t task;          // set until the writer has closed the file
+    FILE *file;
+    ui_perf_sample_t row;       // the writer's copy of the sample being written
+    volatile bool active;
+    uint32_t dropped;
+} ui_perf_log_t;
+
+static ui_perf_frames_t s_frames;
+static ui_perf_locks_t s_locks;
+static ui_perf_log_t s_log;
+static ui_perf_sample_t s_sample;
+static const char *volatile s_page = "";
+static lv_obj_t *s_overlay;
+static ui_perf_sample_cb_t s_sample_cb;
+static void *s_sample_user;
+static ui_perf_frame_cb_t s_frame_cb;
+static void *s_frame_user;
+
+static uint32_t to_u32(int64_t us)
+{
+    return us < 0 ? 0 : us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static void refr_event_cb(lv_event_t *e)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            s_frames.refr_start_us = now_us;
+            s_frames.frame_flush_us = 0;
+            break;
+        case LV_EVENT_FLUSH_START:
+        case LV_EVENT_FLUSH_WAIT_START:
+            s_frames.flush_start_us = now_us;
+            break;
+        case LV_EVENT_FLUSH_FINISH:
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            if (s_frames.flush_start_us != 0) {
+                s_frames.frame_flush_us += now_us - s_frames.flush_start_us;
+                s_frames.flush_start_us = 0;
+            }
+            break;
+        case LV_EVENT_REFR_READY: {
+            if (s_frames.refr_start_us == 0) {
+                break;
+            }
+            uint32_t frame_us = to_u32(now_us - s_frames.refr_start_us);
+            uint32_t flush_us = to_u32(s_frames.frame_flush_us);
+            uint32_t render_us = frame_us > flush_us ? frame_us - flush_us : 0;
+            s_frames.refr_start_us = 0;
+
+            s_frames.frames++;
+            s_frames.frame_total_us += frame_us;
+            s_frames.render_total_us += render_us;
+            s_frames.flush_total_us += flush_us;
+            s_frames.frame_max_us = LV_MAX(s_frames.frame_max_us, frame_us);
+            s_frames.render_max_us = LV_MAX(s_frames.render_max_us, render_us);
+            s_frames.flush_max_us = LV_MAX(s_frames.flush_max_us, flush_us);
+            if (frame_us > UI_PERF_FRAME_BUDGET_US) {
+                s_frames.over_budget++;
+            }
+            if (s_frame_cb) {
+                ui_perf_frame_t frame = { .frame_us = frame_us, .render_us = render_us, .flush_us = flush_us };
+                s_frame_cb(&frame, s_frame_user);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static ui_perf_lock_stat_t *lock_stat_for(const char *task)
+{
+    for (uint8_t i = 0; i < s_locks.count; i++) {
+        if (strncmp(s_locks.tasks[i].task, task, UI_PERF_TASK_NAME - 1) == 0) {
+            return &s_locks.tasks[i];
+        }
+    }
+    // The last row is shared by everyone who didn't get one of their own
+    ui_perf_lock_stat_t *stat = &s_locks.tasks[s_locks.count < UI_PERF_LOCK_TASKS ? s_locks.count : UI_PERF_LOCK_TASKS - 1];
+    if (s_locks.count < UI_PERF_LOCK_TASKS) {
+        s_locks.count++;
+        memset(stat, 0, sizeof(*stat));
+        snprintf(stat->task, sizeof(stat->task), "%s",
+                 s_locks.count == UI_PERF_LOCK_TASKS ? "other" : task);
+    }
+    return stat;
+}
+
+static const char *current_task_name(void)
+{
+    const char *task = pcTaskGetName(NULL);
+    return task ? task : "?";
+}
+
+static int lock_bucket(uint32_t us)
+{
+    int i = 0;
+    while (i < UI_PERF_LOCK_BUCKETS - 1 && us >= ui_perf_lock_bucket_ms[i] * 1000u) {
+        i++;
+    }
+    return i;
+}
+
+bool ui_perf_lock_at(uint32_t timeout_ms, const char *site)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (render_cores_is_worker(self)) {
+        ESP_LOGE(TAG, "%s: display lock taken on draw thread %s", site ? site : "?", current_task_name());
+        return false;
+    }
+    if (s_locks.depth > 0 && s_locks.holder == self) {
+        // Nested: already ours, nothing to wait for or time separately
+        if (!bsp_display_lock(timeout_ms)) {
+            return false;
+        }
+        s_locks.depth++;
+        return true;
+    }
+
+    int64_t wait_start_us = esp_timer_get_time();
+    if (!bsp_display_lock(timeout_ms)) {
+        return false;
+    }
+    int64_t now_us = esp_timer_get_time();
+    uint32_t wait_us = to_u32(now_us - wait_start_us);
+
+    s_locks.holder = self;
+    s_locks.depth = 1;
+    s_locks.since_us = now_us;
+    s_locks.site = site;
+
+    const char *task = current_task_name();
+    ui_perf_lock_stat_t *stat = lock_stat_for(task);
+    stat->waited_us += wait_us;
+    stat->max_wait_us = LV_MAX(stat->max_wait_us, wait_us);
+    s_locks.hist.wait[lock_bucket(wait_us)]++;
+    if (wait_us > s_locks.hist.max_wait_us) {
+        s_locks.hist.max_wait_us = wait_us;
+        s_locks.hist.max_wait_site = site;
+        snprintf(s_locks.hist.max_wait_task, sizeof(s_locks.hist.max_wait_task), "%s", task);
+    }
+    return true;
+}
+
+void ui_perf_unlock(void)
+{
+    if (s_locks.depth == 0 || --s_locks.depth > 0) {
+        bsp_display_unlock();
+        return;
+    }
+
+    uint32_t held_us = to_u32(esp_timer_get_time() - s_locks.since_us);
+    const char *task = current_task_name();
+    const char *site = s_locks.site;
+    ui_perf_lock_stat_t *stat = lock_stat_for(task);
+    stat->holds++;
+    stat->held_us += held_us;
+    stat->max_hold_us = LV_MAX(stat->max_hold_us, held_us);
+    s_locks.hist.hold[lock_bucket(held_us)]++;
+    if (held_us > s_locks.hist.max_hold_us) {
+        s_locks.hist.max_hold_us = held_us;
+        s_locks.hist.max_hold_site = site;
+        snprintf(s_locks.hist.max_hold_task, sizeof(s_locks.hist.max_hold_task), "%s", task);
+    }
+
+    bool warn = false;
+    uint32_t suppressed = 0;
+    if (held_us > UI_PERF_LOCK_BUDGET_US) {
+        s_locks.hist.over_budget++;
+        int64_t now_us = esp_timer_get_time();
+        if (now_us - s_locks.last_warn_us >= UI_PERF_LOCK_WARN_MS * 1000LL) {
+            s_locks.last_warn_us = now_us;
+            suppressed = s_locks.warn_suppressed;
+            s_locks.warn_suppressed = 0;
+            warn = true;
+        } else {
+            s_locks.warn_suppressed++;
+        }
+    }
+    s_locks.holder = NULL;
+    bsp_display_unlock();
+
+    // Logged after releasing, so the warning doesn't add to the hold
+    if (warn) {
+        ESP_LOGW(TAG, "%s held the display lock %lu ms in %s (budget %d ms)%s",
+                 task, (unsigned long)(held_us / 1000), site ? site : "?", UI_PERF_LOCK_BUDGET_US / 1000,
+                 suppressed ? ", more since last warning" : "");
+    }
+}
+
+ui_perf_lock_scope_t ui_perf_lock_scope_begin(const char *site)
+{
+    return (ui_perf_lock_scope_t){ .locked = ui_perf_lock_at(0, site) };
+}
+
+void ui_perf_lock_scope_end(ui_perf_lock_scope_t *scope)
+{
+    if (scope->locked) {
+        scope->locked = false;
+        ui_perf_unlock();
+    }
+}
+
+void ui_perf_get_lock_hist(ui_perf_lock_hist_t *out)
+{
+    if (out) {
+        *out = s_locks.hist;
+    }
+}
+
+void ui_perf_log_lock_hist(void)
+{
+    ui_perf_lock_hist_t h;
+    ui_perf_get_lock_hist(&h);
+
+    ESP_LOGI(TAG, "Display lock since boot: %lu holds over %d ms", (unsigned long)h.over_budget,
+             UI_PERF_LOCK_BUDGET_US / 1000);
+    ESP_LOGI(TAG, "  longest hold %lu ms by %s in %s, longest wait %lu ms by %s in %s",
+             (unsigned long)(h.max_hold_us / 1000), h.max_hold_task[0] ? h.max_hold_task : "-",
+             h.max_hold_site ? h.max_hold_site : "-",
+             (unsigned long)(h.max_wait_us / 1000), h.max_wait_task[0] ? h.max_wait_task : "-",
+             h.max_wait_site ? h.max_wait_site : "-");
+    ESP_LOGI(TAG, "  %9s %8s %8s", "ms", "waits", "holds");
+    for (int i = 0; i < UI_PERF_LOCK_BUCKETS; i++) {
+        char range[16];
+        if (i < UI_PERF_LOCK_BUCKETS - 1) {
+            snprintf(range, sizeof(range), "<%u", ui_perf_lock_bucket_ms[i]);
+        } else {
+            snprintf(range, sizeof(range), ">=%u", ui_perf_lock_bucket_ms[i - 1]);
+        }
+        ESP_LOGI(TAG, "  %9s %8lu %8lu", range, (unsigned long)h.wait[i], (unsigned long)h.hold[i]);
+    }
+}
+
+void ui_perf_set_page(const char *page)
+{
+    s_page = page ? page : "";
+}
+
+static lv_obj_tree_walk_res_t count_object_cb(lv_obj_t *obj, void *user)
+{
+    (void)obj;
+    (*(uint32_t *)user)++;
+    return LV_OBJ_TREE_WALK_NEXT;
+}
+
+static int compare_held(const void *a, const void *b)
+{
+    uint32_t ha = ((const ui_perf_lock_stat_t *)a)->held_us;
+    uint32_t hb = ((const ui_perf_lock_stat_t *)b)->held_us;
+    return ha < hb ? 1 : ha > hb ? -1 : 0;
+}
+
+static void take_sample(ui_perf_sample_t *s)
+{
+    int64_t now_us = esp_timer_get_time();
+    uint32_t frames = s_frames.frames;
+
+    memset(s, 0, sizeof(*s));
+    s->time_us = now_us;
+    s->window_us = to_u32(now_us - s_frames.window_start_us);
+    s->page = s_page;
+    s->frames = frames;
+    s->over_budget = s_frames.over_budget;
+    if (frames > 0) {
+        s->frame_avg_us = (uint32_t)(s_frames.frame_total_us / frames);
+        s->render_avg_us = (uint32_t)(s_frames.render_total_us / frames);
+        s->flush_avg_us = (uint32_t)(s_frames.flush_total_us / frames);
+    }
+    s->frame_max_us = s_frames.frame_max_us;
+    s->render_max_us = s_frames.render_max_us;
+    s->flush_max_us = s_frames.flush_max_us;
+
+    ui_comp_update_counters_t counters;
+    ui_comp_get_update_counters(&counters);
+    s->invalidated_px = counters.invalidated_px - s_frames.invalidated_base;
+
+    if (s_overlay || s_log.active) {
+        lv_obj_tree_walk(lv_screen_active(), count_object_cb, &s->objects);
+        lv_obj_tree_walk(lv_layer_top(), count_object_cb, &s->objects);
+    }
+    s->heap_internal_free = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    s->heap_internal_min = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    s->heap_psram_free = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    s->lock_count = s_locks.count;
+    memcpy(s->locks, s_locks.tasks, s_locks.count * sizeof(s_locks.tasks[0]));
+    qsort(s->locks, s->lock_count, sizeof(s->locks[0]), compare_held);
+
+    int64_t refr_start_us = s_frames.refr_start_us;
+    memset(&s_frames, 0, sizeof(s_frames));
+    s_frames.refr_start_us = refr_start_us;
+    s_frames.window_start_us = now_us;
+    s_frames.invalidated_base = counters.invalidated_px;
+    s_locks.count = 0;
+}
+
+static void update_overlay(const ui_perf_sample_t *s)
+{
+    char text[320];
+    uint32_t fps10 = s->window_us > 0 ? (uint32_t)((uint64_t)s->frames * 10000000ULL / s->window_us) : 0;
+    int len = snprintf(text, sizeof(text),
+                       "%s\n"
+                       "%lu.%lu fps  %lu over %lu ms\n"
+                       "frame %lu.%lu / %lu.%lu ms\n"
+                       "render %lu.%lu  flush %lu.%lu ms\n"
+                       "inv %lu kpx  obj %lu\n"
+                       "heap %lu k int  %lu k ps",
+                       s->page[0] ? s->page : "-",
+                       (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10),
+                       (unsigned long)s->over_budget, (unsigned long)(UI_PERF_FRAME_BUDGET_US / 1000),
+                       (unsigned long)(s->frame_avg_us / 1000), (unsigned long)(s->frame_avg_us / 100 % 10),
+                       (unsigned long)(s->frame_max_us / 1000), (unsigned long)(s->frame_max_us / 100 % 10),
+                       (unsigned long)(s->render_avg_us / 1000), (unsigned long)(s->render_avg_us / 100 % 10),
+                       (unsigned long)(s->flush_avg_us / 1000), (unsigned long)(s->flush_avg_us / 100 % 10),
+                       (unsigned long)(s->invalidated_px / 1000), (unsigned long)s->objects,
+                       (unsigned long)(s->heap_internal_free / 1024), (unsigned long)(s->heap_psram_free / 1024));
+    for (uint8_t i = 0; i < s->lock_count && i < UI_PERF_OVERLAY_LOCK_ROWS && len > 0 && len < (int)sizeof(text); i++) {
+        len += snprintf(text + len, sizeof(text) - len, "\nlock %s %lu ms/%lu, wait %lu ms",
+                        s->locks[i].task, (unsigned long)(s->locks[i].held_us / 1000),
+                        (unsigned long)s->locks[i].holds, (unsigned long)(s->locks[i].waited_us / 1000));
+    }
+    lv_label_set_text(s_overlay, text);
+}
+
+static void sample_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    take_sample(&s_sample);
+
+    if (s_overlay) {
+        update_overlay(&s_sample);
+    }
+    if (s_log.active && xQueueSend(s_log.queue, &s_sample, 0) != pdTRUE) {
+        s_log.dropped++;
+    }
+    if (s_sample_cb) {
+        s_sample_cb(&s_sample, s_sample_user);
+    }
+}
+
+void ui_perf_init(lv_display_t *disp)
+{
+    if (!disp) {
+        return;
+    }
+    static const lv_event_code_t codes[] = {
+        LV_EVENT_REFR_START, LV_EVENT_REFR_READY,
+        LV_EVENT_FLUSH_START, LV_EVENT_FLUSH_FINISH,
+        LV_EVENT_FLUSH_WAIT_START, LV_EVENT_FLUSH_WAIT_FINISH,
+    };
+    for (size_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++) {
+        lv_display_add_event_cb(disp, refr_event_cb, codes[i], NULL);
+    }
+    ui_comp_track_invalidations(disp);
+    s_frames.window_start_us = esp_timer_get_time();
+    lv_timer_create(sample_timer_cb, UI_PERF_SAMPLE_MS, NULL);
+}
+
+void ui_perf_set_sample_cb(ui_perf_sample_cb_t cb, void *user)
+{
+    s_sample_cb = cb;
+    s_sample_user = user;
+}
+
+void ui_perf_set_frame_cb(ui_perf_frame_cb_t cb, void *user)
+{
+    s_frame_cb = cb;
+    s_frame_user = user;
+}
+
+void ui_perf_show_overlay(bool show)
+{
+    if (!show) {
+        if (s_overlay) {
+            lv_obj_delete(s_overlay);
+            s_overlay = NULL;
+        }
+        return;
+    }
+    if (s_overlay) {
+        return;
+    }
+    s_overlay = lv_label_create(lv_layer_top());
+    lv_obj_remove_flag(s_overlay, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_bg_color(s_overlay, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(s_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_text_color(s_overlay, lv_color_hex(0x7CFC00), 0);
+    lv_obj_set_style_text_font(s_overlay, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_pad_all(s_overlay, 6, 0);
+    lv_obj_set_style_radius(s_overlay, 6, 0);
+    lv_obj_align(s_overlay, LV_ALIGN_BOTTOM_RIGHT, -8, -8);
+    lv_label_set_text(s_overlay, "sampling...");
+}
+
+bool ui_perf_overlay_shown(void)
+{
+    return s_overlay != NULL;
+}
+
+static void write_row(FILE *f, const ui_perf_sample_t *s)
+{
+    uint32_t fps10 = s->window_us > 0 ? (uint32_t)((uint64_t)s->frames * 10000000ULL / s->window_us) : 0;
+    fprintf(f, "%lld,%s,%lu,%lu.%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,\"",
+            (long long)(s->time_us / 1000), s->page,
+            (unsigned long)s->frames, (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10),
+            (unsigned long)s->over_budget,
+            (unsigned long)s->frame_avg_us, (unsigned long)s->frame_max_us,
+            (unsigned long)s->render_avg_us, (unsigned long)s->render_max_us,
+            (unsigned long)s->flush_avg_us, (unsigned long)s->flush_max_us,
+            (unsigned long)s->invalidated_px, (unsigned long)s->objects,
+            (unsigned long)s->heap_internal_free, (unsigned long)s->heap_internal_min,
+            (unsigned long)s->heap_psram_free);
+    for (uint8_t i = 0; i < s->lock_count; i++) {
+        fprintf(f, "%s%s:%lu:%lu:%lu:%lu", i ? ";" : "", s->locks[i].task, (unsigned long)s->locks[i].holds,
+                (unsigned long)s->locks[i].held_us, (unsigned long)s->locks[i].max_hold_us,
+                (unsigned long)s->locks[i].waited_us);
+    }
+    fputs("\"\n", f);
+}
+
+static void log_writer_task(void *arg)
+{
+    (void)arg;
+    uint32_t rows = 0;
+
+    while (1) {
+        if (xQueueReceive(s_log.queue, &s_log.row, pdMS_TO_TICKS(UI_PERF_SAMPLE_MS)) == pdTRUE) {
+            write_row(s_log.file, &s_log.row);
+            if (++rows % UI_PERF_LOG_FLUSH_ROWS == 0) {
+                fflush(s_log.file);
+            }
+        } else if (!s_log.active) {
+            break;
+        }
+    }
+
+    fclose(s_log.file);
+    s_log.file = NULL;
+    ESP_LOGI(TAG, "Frame log closed: %lu rows, %lu dropped", (unsigned long)rows, (unsigned long)s_log.dropped);
+    s_log.task = NULL;
+    vTaskDelete(NULL);
+}
+
+bool ui_perf_log_start(const char *path)
+{
+    if (s_log.active || s_log.task) {
+        ESP_LOGW(TAG, "Frame log already running");
+        return false;
+    }
+    if (!s_log.queue) {
+        s_log.queue = xQueueCreate(UI_PERF_LOG_QUEUE_LEN, sizeof(ui_perf_sample_t));
+        if (!s_log.queue) {
+            return false;
+        }
+    }
+    xQueueReset(s_log.queue);
+
+    struct stat st;
+    bool exists = stat(path, &st) == 0;
+    s_log.file = fopen(path, "a");
+    if (!s_log.file) {
+        ESP_LOGE(TAG, "Can't open %s", path);
+        return false;
+    }
+    if (!exists) {
+        fputs("time_ms,page,frames,fps,over_budget,frame_avg_us,frame_max_us,render_avg_us,render_max_us,"
+              "flush_avg_us,flush_max_us,invalidated_px,objects,heap_internal_free,heap_internal_min,"
+              "heap_psram_free,lock_holds\n", s_log.file);
+    }
+
+    s_log.dropped = 0;
+    s_log.active = true;
+    if (xTaskCreate(log_writer_task, "ui_perf_log", 4096, NULL, 2, &s_log.task) != pdPASS) {
+        s_log.active = false;
+        s_log.task = NULL;
+        fclose(s_log.file);
+        s_log.file = NULL;
+        return false;
+    }
+    ESP_LOGI(TAG, "Logging frame stats to %s", path);
+    return true;
+}
+
+void ui_perf_log_stop(void)
+{
+    // The writer drains what's queued and closes the file
+    s_log.active = false;
+}
+
+bool ui_perf_logging(void)
+{
+    return s_log.active;
+}
@@ -0,0 +1,151 @@
+#ifndef UI_PERF_H
+#define UI_PERF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Render-budget monitor for the LVGL display.
+ *
+ * Every refresh cycle is a frame. Its flush time is what the display's flush
+ * callback took (LV_EVENT_FLUSH_START..FINISH) plus the wait for the previous
+ * flush to complete; render time is the rest of the cycle. A frame longer
+ * than UI_PERF_FRAME_BUDGET_US misses the 30 FPS budget.
+ *
+ * Once a second the frames are folded into a sample, together with the area
+ * invalidated (ui_comp_track_invalidations), heap use, the page the app last
+ * named with ui_perf_set_page() and how long each task waited for and held
+ * the display lock. Lock use is only seen when taken through ui_perf_lock()/
+ * ui_perf_unlock() or UI_LOCK_SCOPE(); the LVGL task's own hold is the frame
+ * itself, and shows up as other tasks' wait. Counting the objects on
+ * screen walks the whole tree, so it only happens while the overlay or the
+ * log is on.
+ *
+ * The overlay is a label on the top layer. The log appends one CSV row per
+ * sample; rows are written by a low-priority task, never on the LVGL task.
+ * Its last column lists task:holds:held_us:max_hold_us:waited_us per task,
+ * ';' separated. Both are off until enabled.
+ *
+ * Lock contention: every wait and hold also goes into a histogram kept since
+ * boot. A hold over UI_PERF_LOCK_BUDGET_US stalls touch input and the next
+ * frame; it is logged with the task and the function that took the lock.
+ * Work that doesn't need a result is better posted with ui_cmd_post().
+ */
+
+#define UI_PERF_FRAME_BUDGET_US     (1000 * 1000 / 30)
+#define UI_PERF_SAMPLE_MS           1000
+#define UI_PERF_LOCK_TASKS          12      // tasks tracked by name; the rest share one row
+#define UI_PERF_TASK_NAME           16
+#define UI_PERF_LOCK_BUDGET_US      (20 * 1000)
+#define UI_PERF_LOCK_BUCKETS        10      // see ui_perf_lock_bucket_ms
+#define UI_PERF_LOCK_WARN_MS        1000    // at most one over-budget warning per this many ms
+
+typedef struct {
+    char task[UI_PERF_TASK_NAME];
+    uint32_t holds;
+    uint32_t held_us;
+    uint32_t max_hold_us;
+    uint32_t waited_us;
+    uint32_t max_wait_us;
+} ui_perf_lock_stat_t;
+
+// Upper bounds of the histogram buckets in ms; the last bucket is open-ended
+extern const uint16_t ui_perf_lock_bucket_ms[UI_PERF_LOCK_BUCKETS - 1];
+
+typedef struct {
+    uint32_t wait[UI_PERF_LOCK_BUCKETS];
+    uint32_t hold[UI_PERF_LOCK_BUCKETS];
+    uint32_t over_budget;
+    uint32_t max_hold_us;
+    const char *max_hold_site;
+    char max_hold_task[UI_PERF_TASK_NAME];
+    uint32_t max_wait_us;
+    const char *max_wait_site;
+    char max_wait_task[UI_PERF_TASK_NAME];
+} ui_perf_lock_hist_t;
+
+typedef struct {
+    int64_t time_us;                // esp_timer at the end of the sample
+    uint32_t window_us;
+    const char *page;
+    uint32_t frames;
+    uint32_t over_budget;
+    uint32_t frame_avg_us;
+    uint32_t frame_max_us;
+    uint32_t render_avg_us;
+    uint32_t render_max_us;
+    uint32_t flush_avg_us;
+    uint32_t flush_max_us;
+    uint32_t invalidated_px;
+    uint32_t objects;               // 0 while neither overlay nor log is on
+    uint32_t heap_internal_free;    // LVGL allocates through the C heap
+    uint32_t heap_psram_free;
+    uint32_t heap_internal_min;
+    uint8_t lock_count;
+    ui_perf_lock_stat_t locks[UI_PERF_LOCK_TASKS];  // tasks that held the lock this sample, longest first
+} ui_perf_sample_t;
+
+typedef void (*ui_perf_sample_cb_t)(const ui_perf_sample_t *sample, void *user);
+
+typedef struct {
+    uint32_t frame_us;
+    uint32_t render_us;
+    uint32_t flush_us;
+} ui_perf_frame_t;
+
+typedef void (*ui_perf_frame_cb_t)(const ui_perf_frame_t *frame, void *user);
+
+// Hook the display's refresh events and start sampling. Call with the display locked.
+void ui_perf_init(lv_display_t *disp);
+// Called on the LVGL task after each sample, whether or not overlay or log are on
+void ui_perf_set_sample_cb(ui_perf_sample_cb_t cb, void *user);
+// Called on the LVGL task at the end of every frame; NULL to stop
+void ui_perf_set_frame_cb(ui_perf_frame_cb_t cb, void *user);
+
+// Name of the page being shown, for the overlay and the log. Must outlive the page.
+void ui_perf_set_page(const char *page);
+
+// bsp_display_lock()/bsp_display_unlock() with wait and hold time charged to the
+// calling task and to site (a function name) in warnings. Fails on LVGL's draw
+// threads, which would wait on the frame they are drawing.
+bool ui_perf_lock_at(uint32_t timeout_ms, const char *site);
+void ui_perf_unlock(void);
+#define ui_perf_lock(timeout_ms)    ui_perf_lock_at((timeout_ms), __func__)
+
+// Hold the display lock (waiting forever) until the end of the enclosing block
+typedef struct {
+    bool locked;
+} ui_perf_lock_scope_t;
+
+ui_perf_lock_scope_t ui_perf_lock_scope_begin(const char *site);
+void ui_perf_lock_scope_end(ui_perf_lock_scope_t *scope);
+#define UI_PERF_CONCAT_(a, b)       a##b
+#define UI_PERF_CONCAT(a, b)        UI_PERF_CONCAT_(a, b)
+#define UI_LOCK_SCOPE() \
+    ui_perf_lock_scope_t UI_PERF_CONCAT(ui_lock_scope_, __LINE__) \
+        __attribute__((cleanup(ui_perf_lock_scope_end))) = ui_perf_lock_scope_begin(__func__)
+
+// Histograms since boot. Call with the display locked for a consistent copy.
+void ui_perf_get_lock_hist(ui_perf_lock_hist_t *out);
+void ui_perf_log_lock_hist(void);
+
+// Call with the display locked
+void ui_perf_show_overlay(bool show);
+bool ui_perf_overlay_shown(void);
+
+// Append a row per sample to path (created with a header if new) until stopped
+bool ui_perf_log_start(const char *path);
+void ui_perf_log_stop(void);
+bool ui_perf_logging(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
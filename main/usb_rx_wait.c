@@ -0,0 +1,67 @@
+#include "usb_rx_wait.h"
+
+#include "freertos/task.h"
+
+bool usb_rx_wait_start(usb_rx_wait_t *w)
+{
+    if (!w->signal) {
+        w->signal = xSemaphoreCreateBinary();
+    }
+    return w->signal != NULL;
+}
+
+void usb_rx_wait_notify(usb_rx_wait_t *w)
+{
+    if (w->signal) {
+        xSemaphoreGive(w->signal);
+    }
+}
+
+void usb_rx_wait(usb_rx_wait_t *w, TickType_t ticks_to_wait)
+{
+    if (w->signal) {
+        xSemaphoreTake(w->signal, ticks_to_wait);
+    } else {
+        vTaskDelay(ticks_to_wait > 0 ? ticks_to_wait : 1);
+    }
+}
+
+int usb_rx_wait_read(usb_rx_wait_t *w, void *data, size_t len, TickType_t ticks_to_wait)
+{
+    const usb_rx_cdc_t *cdc = w->cdc;
+    if (!cdc->connected(cdc->ctx)) {
+        return 0;
+    }
+
+    TimeOut_t timeout;
+    TickType_t remaining = ticks_to_wait;
+    size_t rx_size = 0;
+    vTaskSetTimeOutState(&timeout);
+    for (;;) {
+        if (cdc->rx_size(cdc->ctx, &rx_size) != ESP_OK || rx_size > 0) {
+            break;
+        }
+        if (remaining == 0 || xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            return 0;
+        }
+        usb_rx_wait(w, remaining);
+        if (!cdc->connected(cdc->ctx)) {
+            return 0;
+        }
+    }
+
+    size_t read_len = len;
+    if (cdc->read(cdc->ctx, (uint8_t *)data, &read_len) != ESP_OK) {
+        return 0;
+    }
+    return (int)read_len;
+}
+
+int usb_rx_wait_reader_read(usb_rx_wait_t *w, void *data, size_t len, TickType_t ticks_to_wait)
+{
+    if (!w->cdc->connected(w->cdc->ctx)) {
+        usb_rx_wait(w, ticks_to_wait);
+        return 0;
+    }
+    return usb_rx_wait_read(w, data, len, ticks_to_wait);
+}
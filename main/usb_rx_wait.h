@@ -0,0 +1,59 @@
+#ifndef USB_RX_WAIT_H
+#define USB_RX_WAIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Receive wait for the USB CDC transport.
+ *
+ * The CDC driver fills its RX ring on the USB host client task and calls
+ * the receive callback afterwards. A read with an empty ring sleeps on a
+ * binary semaphore given by that callback, and on connect and disconnect,
+ * rather than for the whole timeout, so a line is handed on as soon as it
+ * lands. A stale signal, left by data an earlier read already took, just
+ * costs one more look at the ring.
+ *
+ * The driver is reached through usb_rx_cdc_t: main.c backs it with
+ * iot_usbh_cdc, the host test with a fake ring.
+ */
+
+typedef struct {
+    bool (*connected)(void *ctx);                               // a CDC device is open for reading
+    esp_err_t (*rx_size)(void *ctx, size_t *size);              // bytes waiting in the RX ring
+    esp_err_t (*read)(void *ctx, uint8_t *buf, size_t *len);    // take up to *len bytes without blocking
+    void *ctx;
+} usb_rx_cdc_t;
+
+// Statically initialized with .cdc set, so it can be used before the USB host is up
+typedef struct {
+    const usb_rx_cdc_t *cdc;
+    SemaphoreHandle_t signal;   // NULL until usb_rx_wait_start(); waits sleep instead
+} usb_rx_wait_t;
+
+// Create the signal; false if it could not be. Calling again is harmless.
+bool usb_rx_wait_start(usb_rx_wait_t *w);
+
+// From the driver's receive, connect and disconnect callbacks, on any task.
+void usb_rx_wait_notify(usb_rx_wait_t *w);
+// Sleep until the driver signals, at most ticks_to_wait.
+void usb_rx_wait(usb_rx_wait_t *w, TickType_t ticks_to_wait);
+
+// Bytes read, 0 on timeout, driver error or without a device, which returns at once.
+int usb_rx_wait_read(usb_rx_wait_t *w, void *data, size_t len, TickType_t ticks_to_wait);
+// For the transport reader: as usb_rx_wait_read(), but without a device it waits for a connect.
+int usb_rx_wait_reader_read(usb_rx_wait_t *w, void *data, size_t len, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,554 @@
+#include "wardrive_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "wardrive_log";
+
+#define LOG_MAGIC           0x314C4457u     // "WDL1"
+#define LOG_VERSION         1
+#define INITIAL_SLOTS       1024
+#define KEY_PRESENT         (1ULL << 48)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint8_t reserved[WARDRIVE_LOG_RECORD_SIZE - 8];
+} log_header_t;
+
+_Static_assert(sizeof(log_header_t) == WARDRIVE_LOG_RECORD_SIZE, "header must fill one slot");
+
+static uint32_t hash_key(uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static uint32_t slot_block(uint32_t slot)
+{
+    return slot / WARDRIVE_LOG_BLOCK_RECORDS;
+}
+
+static size_t slot_offset(uint32_t slot)
+{
+    return (size_t)(slot % WARDRIVE_LOG_BLOCK_RECORDS) * WARDRIVE_LOG_RECORD_SIZE;
+}
+
+// Slots in use in the tail block, header included
+static size_t tail_bytes(const wardrive_log_t *log)
+{
+    uint32_t slots = log->record_count + 1 - log->tail_block * WARDRIVE_LOG_BLOCK_RECORDS;
+    return (size_t)slots * WARDRIVE_LOG_RECORD_SIZE;
+}
+
+static bool write_block(wardrive_log_t *log, uint32_t block, const uint8_t *data, size_t len)
+{
+    off_t offset = (off_t)block * WARDRIVE_LOG_BLOCK_SIZE;
+    if (lseek(log->fd, offset, SEEK_SET) != offset || write(log->fd, data, len) != (ssize_t)len) {
+        log->stats.write_errors++;
+        ESP_LOGE(TAG, "Write of block %u to %s failed: %s", (unsigned)block, log->path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool read_block(wardrive_log_t *log, uint32_t block, uint8_t *out)
+{
+    if (block == log->tail_block) {
+        memcpy(out, log->tail, WARDRIVE_LOG_BLOCK_SIZE);
+        return true;
+    }
+    if (log->fd < 0) {
+        if (block >= WARDRIVE_LOG_MEM_BLOCKS || !log->mem_blocks[block]) {
+            return false;
+        }
+        memcpy(out, log->mem_blocks[block], WARDRIVE_LOG_BLOCK_SIZE);
+        return true;
+    }
+
+    off_t offset = (off_t)block * WARDRIVE_LOG_BLOCK_SIZE;
+    if (lseek(log->fd, offset, SEEK_SET) != offset ||
+        read(log->fd, out, WARDRIVE_LOG_BLOCK_SIZE) != WARDRIVE_LOG_BLOCK_SIZE) {
+        ESP_LOGW(TAG, "Read of block %u from %s failed", (unsigned)block, log->path);
+        return false;
+    }
+    return true;
+}
+
+// Full blocks are immutable, so cached copies never go stale within a session
+static const uint8_t *cached_block(wardrive_log_t *log, uint32_t block)
+{
+    int victim = 0;
+    for (int i = 0; i < WARDRIVE_LOG_CACHE_BLOCKS; i++) {
+        if (log->cache_block[i] == (int32_t)block) {
+            log->cache_used[i] = ++log->cache_clock;
+            return log->cache + (size_t)i * WARDRIVE_LOG_BLOCK_SIZE;
+        }
+        if (log->cache_used[i] < log->cache_used[victim]) {
+            victim = i;
+        }
+    }
+
+    uint8_t *data = log->cache + (size_t)victim * WARDRIVE_LOG_BLOCK_SIZE;
+    if (!read_block(log, block, data)) {
+        log->cache_block[victim] = -1;
+        log->cache_used[victim] = 0;
+        return NULL;
+    }
+    log->cache_block[victim] = (int32_t)block;
+    log->cache_used[victim] = ++log->cache_clock;
+    return data;
+}
+
+static void reset_cache(wardrive_log_t *log)
+{
+    for (int i = 0; i < WARDRIVE_LOG_CACHE_BLOCKS; i++) {
+        log->cache_block[i] = -1;
+        log->cache_used[i] = 0;
+    }
+    log->cache_clock = 0;
+}
+
+static bool index_insert(uint64_t *slots, uint32_t mask, uint64_t key)
+{
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint32_t slot = (hash_key(key) + probe) & mask;
+        if (slots[slot] == 0) {
+            slots[slot] = key;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool index_contains(const wardrive_log_t *log, uint64_t key)
+{
+    uint32_t mask = log->bssid_slot_mask;
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        uint64_t value = log->bssid_slots[(hash_key(key) + probe) & mask];
+        if (value == 0) {
+            return false;
+        }
+        if (value == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Keep the set at most half full; a failed grow just runs fuller until no slot is left
+static bool index_reserve(wardrive_log_t *log)
+{
+    uint32_t slots = log->bssid_slot_mask + 1;
+    if ((log->record_count + 1) * 2 <= slots) {
+        return true;
+    }
+
+    uint32_t new_slots = slots * 2;
+    uint64_t *grown = heap_caps_calloc(new_slots, sizeof(uint64_t), MALLOC_CAP_SPIRAM);
+    if (!grown) {
+        ESP_LOGW(TAG, "Could not grow BSSID index to %u slots", (unsigned)new_slots);
+        return log->record_count + 1 < slots;
+    }
+    for (uint32_t i = 0; i < slots; i++) {
+        if (log->bssid_slots[i] != 0) {
+            index_insert(grown, new_slots - 1, log->bssid_slots[i]);
+        }
+    }
+    heap_caps_free(log->bssid_slots);
+    log->bssid_slots = grown;
+    log->bssid_slot_mask = new_slots - 1;
+    return true;
+}
+
+static bool commit_tail(wardrive_log_t *log)
+{
+    bool ok;
+    if (log->fd >= 0) {
+        ok = write_block(log, log->tail_block, log->tail, WARDRIVE_LOG_BLOCK_SIZE);
+    } else {
+        uint8_t *copy = heap_caps_malloc(WARDRIVE_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        ok = copy != NULL;
+        if (copy) {
+            memcpy(copy, log->tail, WARDRIVE_LOG_BLOCK_SIZE);
+            log->mem_blocks[log->tail_block] = copy;
+        } else {
+            log->stats.write_errors++;
+        }
+    }
+    if (ok) {
+        log->stats.blocks_written++;
+    }
+
+    log->tail_block++;
+    memset(log->tail, 0, WARDRIVE_LOG_BLOCK_SIZE);
+    log->tail_dirty = false;
+    return ok;
+}
+
+static void flush_locked(wardrive_log_t *log, bool force)
+{
+    if (!log->open || !log->tail_dirty || log->fd < 0) {
+        return;
+    }
+    if (!force && (xTaskGetTickCount() - log->tail_dirty_since) < pdMS_TO_TICKS(WARDRIVE_LOG_FLUSH_MS)) {
+        return;
+    }
+
+    // Rewrite the partial block at its aligned offset; the next flush or fill overwrites it again
+    if (write_block(log, log->tail_block, log->tail, tail_bytes(log))) {
+        fsync(log->fd);
+    }
+    log->tail_dirty = false;
+}
+
+static void close_locked(wardrive_log_t *log)
+{
+    if (!log->open) {
+        return;
+    }
+    flush_locked(log, true);
+    if (log->fd >= 0) {
+        close(log->fd);
+        log->fd = -1;
+    }
+    log->open = false;
+}
+
+bool wardrive_log_init(wardrive_log_t *log)
+{
+    if (!log) {
+        return false;
+    }
+
+    memset(log, 0, sizeof(*log));
+    log->fd = -1;
+    log->lock = xSemaphoreCreateMutex();
+    // Internal DMA-capable memory lets the SD driver write the block without bouncing it
+    log->tail = heap_caps_malloc(WARDRIVE_LOG_BLOCK_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    log->cache = heap_caps_malloc((size_t)WARDRIVE_LOG_CACHE_BLOCKS * WARDRIVE_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+    log->bssid_slots = heap_caps_calloc(INITIAL_SLOTS, sizeof(uint64_t), MALLOC_CAP_SPIRAM);
+    log->bssid_slot_mask = INITIAL_SLOTS - 1;
+    if (!log->lock || !log->tail || !log->cache || !log->bssid_slots) {
+        ESP_LOGE(TAG, "Failed to allocate wardrive log");
+        wardrive_log_deinit(log);
+        return false;
+    }
+    reset_cache(log);
+    return true;
+}
+
+void wardrive_log_deinit(wardrive_log_t *log)
+{
+    if (!log) {
+        return;
+    }
+    if (log->lock) {
+        close_locked(log);
+        vSemaphoreDelete(log->lock);
+    }
+    for (int i = 0; i < WARDRIVE_LOG_MEM_BLOCKS; i++) {
+        heap_caps_free(log->mem_blocks[i]);
+    }
+    heap_caps_free(log->tail);
+    heap_caps_free(log->cache);
+    heap_caps_free(log->bssid_slots);
+    memset(log, 0, sizeof(*log));
+    log->fd = -1;
+}
+
+bool wardrive_log_open(wardrive_log_t *log, const char *path)
+{
+    if (!log || !log->lock) {
+        return false;
+    }
+
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    close_locked(log);
+
+    for (int i = 0; i < WARDRIVE_LOG_MEM_BLOCKS; i++) {
+        heap_caps_free(log->mem_blocks[i]);
+        log->mem_blocks[i] = NULL;
+    }
+    memset(log->bssid_slots, 0, (log->bssid_slot_mask + 1) * sizeof(uint64_t));
+    memset(&log->stats, 0, sizeof(log->stats));
+    reset_cache(log);
+    log->record_count = 0;
+    log->tail_block = 0;
+    log->path[0] = '\0';
+
+    log_header_t header = {
+        .magic = LOG_MAGIC,
+        .version = LOG_VERSION,
+        .record_size = WARDRIVE_LOG_RECORD_SIZE,
+    };
+    memset(log->tail, 0, WARDRIVE_LOG_BLOCK_SIZE);
+    memcpy(log->tail, &header, sizeof(header));
+    log->tail_dirty = true;
+    log->tail_dirty_since = xTaskGetTickCount();
+
+    bool persistent = false;
+    if (path) {
+        snprintf(log->path, sizeof(log->path), "%s", path);
+        log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (log->fd < 0) {
+            ESP_LOGE(TAG, "Cannot create %s: %s, keeping session in memory", path, strerror(errno));
+        } else {
+            persistent = true;
+        }
+    }
+    log->open = true;
+    xSemaphoreGive(log->lock);
+    return persistent;
+}
+
+bool wardrive_log_flush(wardrive_log_t *log, bool force)
+{
+    if (!log || !log->lock) {
+        return false;
+    }
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    uint32_t errors = log->stats.write_errors;
+    flush_locked(log, force);
+    bool ok = log->stats.write_errors == errors;
+    xSemaphoreGive(log->lock);
+    return ok;
+}
+
+bool wardrive_log_append(wardrive_log_t *log, const wardrive_record_t *rec)
+{
+    if (!log || !log->lock || !rec) {
+        return false;
+    }
+
+    uint64_t key = mac48_to_u64(&rec->bssid) | KEY_PRESENT;
+    bool appended = false;
+
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    if (!log->open) {
+        // No session opened yet
+    } else if (index_contains(log, key)) {
+        log->stats.duplicates++;
+    } else if ((log->fd < 0 && log->tail_block >= WARDRIVE_LOG_MEM_BLOCKS) || !index_reserve(log)) {
+        log->stats.dropped++;
+    } else {
+        index_insert(log->bssid_slots, log->bssid_slot_mask, key);
+
+        uint32_t slot = log->record_count + 1;
+        memcpy(log->tail + slot_offset(slot), rec, sizeof(*rec));
+        log->record_count++;
+        if (!log->tail_dirty) {
+            log->tail_dirty = true;
+            log->tail_dirty_since = xTaskGetTickCount();
+        }
+        if (slot_offset(slot) + WARDRIVE_LOG_RECORD_SIZE == WARDRIVE_LOG_BLOCK_SIZE) {
+            commit_tail(log);
+        }
+        appended = true;
+    }
+    xSemaphoreGive(log->lock);
+    return appended;
+}
+
+uint32_t wardrive_log_count(wardrive_log_t *log)
+{
+    if (!log || !log->lock) {
+        return 0;
+    }
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    uint32_t count = log->record_count;
+    xSemaphoreGive(log->lock);
+    return count;
+}
+
+bool wardrive_log_persistent(wardrive_log_t *log)
+{
+    if (!log || !log->lock) {
+        return false;
+    }
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    bool persistent = log->open && log->fd >= 0;
+    xSemaphoreGive(log->lock);
+    return persistent;
+}
+
+bool wardrive_log_read(wardrive_log_t *log, uint32_t index, wardrive_record_t *out)
+{
+    if (!log || !log->lock || !out) {
+        return false;
+    }
+
+    bool ok = false;
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    if (log->open && index < log->record_count) {
+        uint32_t slot = index + 1;
+        uint32_t block = slot_block(slot);
+        const uint8_t *data = (block == log->tail_block) ? log->tail : cached_block(log, block);
+        if (data) {
+            memcpy(out, data + slot_offset(slot), sizeof(*out));
+            ok = true;
+        }
+    }
+    xSemaphoreGive(log->lock);
+    return ok;
+}
+
+void wardrive_log_get_stats(wardrive_log_t *log, wardrive_log_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!log || !log->lock) {
+        return;
+    }
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    *out = log->stats;
+    xSemaphoreGive(log->lock);
+}
+
+// WiGLE fields are plain CSV; quote the SSID only when it needs it
+static void write_csv_field(FILE *f, const char *text)
+{
+    if (!strpbrk(text, ",\"\r\n")) {
+        fputs(text, f);
+        return;
+    }
+    fputc('"', f);
+    for (const char *p = text; *p; p++) {
+        if (*p == '"') {
+            fputc('"', f);
+        }
+        fputc(*p, f);
+    }
+    fputc('"', f);
+}
+
+int wardrive_log_export_wigle(wardrive_log_t *log, const char *csv_path)
+{
+    if (!log || !log->lock || !csv_path) {
+        return -1;
+    }
+
+    uint8_t *block = heap_caps_malloc(WARDRIVE_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+    char *out_buf = heap_caps_malloc(WARDRIVE_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+    FILE *f = (block && out_buf) ? fopen(csv_path, "w") : NULL;
+    if (!f) {
+        ESP_LOGE(TAG, "Cannot export to %s", csv_path);
+        heap_caps_free(block);
+        heap_caps_free(out_buf);
+        return -1;
+    }
+    setvbuf(f, out_buf, _IOFBF, WARDRIVE_LOG_BLOCK_SIZE);
+
+    fputs("WigleWifi-1.4,appRelease=1.0,model=Tab5,release=1.0,device=M5MonsterC5-Tab5,"
+          "display=,board=ESP32-P4,brand=M5Stack\n", f);
+    fputs("MAC,SSID,AuthMode,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude,"
+          "AltitudeMeters,AccuracyMeters,Type\n", f);
+
+    // Hold the lock per block only, so the wardrive task keeps appending during an export
+    int rows = 0;
+    bool ok = true;
+    for (uint32_t b = 0; ok; b++) {
+        xSemaphoreTake(log->lock, portMAX_DELAY);
+        uint32_t count = log->open ? log->record_count : 0;
+        bool have = slot_block(count) >= b && read_block(log, b, block);
+        xSemaphoreGive(log->lock);
+        if (!have) {
+            ok = slot_block(count) < b;
+            break;
+        }
+
+        uint32_t first = (b == 0) ? 1 : 0;
+        for (uint32_t i = first; i < WARDRIVE_LOG_BLOCK_RECORDS; i++) {
+            uint32_t slot = b * WARDRIVE_LOG_BLOCK_RECORDS + i;
+            if (slot > count) {
+                break;
+            }
+            const wardrive_record_t *rec = (const wardrive_record_t *)(block + slot_offset(slot));
+            char bssid[MAC48_STR_SIZE];
+            fputs(mac48_format(&rec->bssid, bssid), f);
+            fputc(',', f);
+            write_csv_field(f, rec->ssid);
+            fprintf(f, ",%s,%s,%u,%d,%.7f,%.7f,%.1f,%.1f,WIFI\n",
+                    rec->auth, rec->first_seen, rec->channel, rec->rssi,
+                    rec->lat, rec->lon, rec->altitude, rec->accuracy);
+            rows++;
+        }
+        ok = !ferror(f);
+    }
+
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    heap_caps_free(block);
+    heap_caps_free(out_buf);
+    if (!ok) {
+        ESP_LOGE(TAG, "Export to %s failed after %d rows", csv_path, rows);
+        return -1;
+    }
+    ESP_LOGI(TAG, "Exported %d networks to %s", rows, csv_path);
+    return rows;
+}
+
+static void copy_field(char *dst, size_t size, const char *start, const char *end)
+{
+    size_t len = (size_t)(end - start);
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(dst, start, len);
+    dst[len] = '\0';
+}
+
+bool wardrive_log_parse_line(const char *line, wardrive_record_t *out)
+{
+    if (!line || !out) {
+        return false;
+    }
+
+    mac48_t bssid;
+    if (!mac48_parse(line, &bssid) || line[17] != ',') {
+        return false;
+    }
+
+    size_t len = strlen(line);
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == '\n' || line[len - 1] == ' ')) {
+        len--;
+    }
+    if (len < 5 || strncmp(line + len - 5, ",WIFI", 5) != 0) {
+        return false;
+    }
+
+    // commas[0] precedes Type, commas[8] precedes AuthMode
+    const char *commas[9];
+    int found = 0;
+    for (const char *p = line + len - 1; p > line + 17 && found < 9; p--) {
+        if (*p == ',') {
+            commas[found++] = p;
+        }
+    }
+    if (found < 9) {
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->bssid = bssid;
+    copy_field(out->ssid, sizeof(out->ssid), line + 18, commas[8]);
+    copy_field(out->auth, sizeof(out->auth), commas[8] + 1, commas[7]);
+    copy_field(out->first_seen, sizeof(out->first_seen), commas[7] + 1, commas[6]);
+    out->channel = (uint8_t)strtol(commas[6] + 1, NULL, 10);
+    out->rssi = (int8_t)strtol(commas[5] + 1, NULL, 10);
+    out->lat = strtod(commas[4] + 1, NULL);
+    out->lon = strtod(commas[3] + 1, NULL);
+    out->altitude = strtof(commas[2] + 1, NULL);
+    out->accuracy = strtof(commas[1] + 1, NULL);
+    return true;
+}
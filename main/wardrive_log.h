@@ -0,0 +1,119 @@
+#ifndef WARDRIVE_LOG_H
+#define WARDRIVE_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "mac48.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Wardrive session log: every unique network reported by the wardrive
+ * command, appended to a fixed-record binary file on the internal SD card.
+ *
+ * Records are 128 bytes and the file header fills the first record slot,
+ * so record i lives at offset (i + 1) * 128 and every 4 KB block holds 32
+ * slots. Appends go to an in-memory tail block that is written whole when
+ * it fills; a partial tail is rewritten in place on a timed flush, so the
+ * file only ever sees block-aligned writes through one open descriptor.
+ * A BSSID hash set in PSRAM drops repeat sightings. Full blocks never change
+ * again, which lets readers cache them without invalidation.
+ *
+ * Without an SD card the log keeps up to WARDRIVE_LOG_MEM_BLOCKS blocks in
+ * PSRAM instead and counts what it had to drop.
+ *
+ * All calls are serialised by an internal mutex, so one task can append
+ * while the UI reads.
+ */
+
+#define WARDRIVE_LOG_DIR            "/sdcard/WARDRIVE"
+#define WARDRIVE_LOG_RECORD_SIZE    128
+#define WARDRIVE_LOG_BLOCK_SIZE     4096
+#define WARDRIVE_LOG_BLOCK_RECORDS  (WARDRIVE_LOG_BLOCK_SIZE / WARDRIVE_LOG_RECORD_SIZE)
+#define WARDRIVE_LOG_CACHE_BLOCKS   4       // full blocks kept for reads
+#define WARDRIVE_LOG_MEM_BLOCKS     64      // 2047 records when there is no SD card
+#define WARDRIVE_LOG_FLUSH_MS       2000    // longest a partial tail block stays unwritten
+
+typedef struct {
+    double lat;
+    double lon;
+    float altitude;         // m
+    float accuracy;         // m
+    mac48_t bssid;
+    uint8_t channel;
+    int8_t rssi;            // dBm
+    char ssid[33];
+    char auth[31];          // WiGLE AuthMode, brackets kept, e.g. "[WPA2_PSK]"
+    char first_seen[20];    // "YYYY-MM-DD HH:MM:SS" as sent by the board
+    uint8_t reserved[12];
+} wardrive_record_t;
+
+_Static_assert(sizeof(wardrive_record_t) == WARDRIVE_LOG_RECORD_SIZE, "wardrive record must fill one slot");
+
+typedef struct {
+    uint32_t duplicates;    // sightings of a BSSID already in the log
+    uint32_t dropped;       // memory-only log was full
+    uint32_t write_errors;
+    uint32_t blocks_written;
+} wardrive_log_stats_t;
+
+typedef struct {
+    SemaphoreHandle_t lock;
+    int fd;                         // -1 when the log is memory-only or closed
+    bool open;
+    char path[64];
+
+    uint32_t record_count;
+    uint8_t *tail;                  // block tail_block, internal DMA-capable RAM
+    uint32_t tail_block;
+    bool tail_dirty;
+    TickType_t tail_dirty_since;
+
+    uint64_t *bssid_slots;          // mac48 | 1 << 48, 0 = empty; PSRAM
+    uint32_t bssid_slot_mask;
+
+    uint8_t *mem_blocks[WARDRIVE_LOG_MEM_BLOCKS];
+
+    uint8_t *cache;                 // WARDRIVE_LOG_CACHE_BLOCKS blocks, PSRAM
+    int32_t cache_block[WARDRIVE_LOG_CACHE_BLOCKS];
+    uint32_t cache_used[WARDRIVE_LOG_CACHE_BLOCKS];
+    uint32_t cache_clock;
+
+    wardrive_log_stats_t stats;
+} wardrive_log_t;
+
+// Allocate buffers; the log starts closed.
+bool wardrive_log_init(wardrive_log_t *log);
+void wardrive_log_deinit(wardrive_log_t *log);
+
+// Start a new session, truncating path. NULL path keeps the session in PSRAM only.
+// The previous session is flushed and closed; it stays readable until then, after stop too.
+bool wardrive_log_open(wardrive_log_t *log, const char *path);
+// Write the partial tail block. Without force only when it has waited WARDRIVE_LOG_FLUSH_MS.
+bool wardrive_log_flush(wardrive_log_t *log, bool force);
+
+// Returns true when rec was new and appended, false for duplicates and errors.
+bool wardrive_log_append(wardrive_log_t *log, const wardrive_record_t *rec);
+uint32_t wardrive_log_count(wardrive_log_t *log);
+bool wardrive_log_persistent(wardrive_log_t *log);
+bool wardrive_log_read(wardrive_log_t *log, uint32_t index, wardrive_record_t *out);
+void wardrive_log_get_stats(wardrive_log_t *log, wardrive_log_stats_t *out);
+
+// Write the session as a WiGLE 1.4 CSV, streaming the log a block at a time.
+// Returns the number of rows written, or -1 on error.
+int wardrive_log_export_wigle(wardrive_log_t *log, const char *csv_path);
+
+// Parse "BSSID,SSID,[AUTH],first_seen,channel,rssi,lat,lon,alt,acc,WIFI".
+// Fields after the SSID are located from the end, so SSIDs may contain commas.
+bool wardrive_log_parse_line(const char *line, wardrive_record_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
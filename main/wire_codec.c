@@ -0,0 +1,591 @@
+#include "wire_codec.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// CRC-16/CCITT-FALSE, one table step per byte. The bitwise loop cost more per frame than
+// parsing the text line the frame replaces; the table is 512 bytes of rodata.
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t wire_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+//==================================================================================
+// Encoding
+//==================================================================================
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+    bool overflow;
+} tlv_writer_t;
+
+static void put_tlv(tlv_writer_t *w, uint8_t tag, const void *value, size_t len)
+{
+    if (len > 255 || w->len + 2 + len > w->cap) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->len++] = tag;
+    w->buf[w->len++] = (uint8_t)len;
+    memcpy(w->buf + w->len, value, len);
+    w->len += len;
+}
+
+static void put_u8(tlv_writer_t *w, uint8_t tag, uint8_t value)
+{
+    put_tlv(w, tag, &value, 1);
+}
+
+static void put_u16(tlv_writer_t *w, uint8_t tag, uint16_t value)
+{
+    uint8_t le[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    put_tlv(w, tag, le, sizeof(le));
+}
+
+static void put_i32(tlv_writer_t *w, uint8_t tag, int32_t value)
+{
+    uint32_t v = (uint32_t)value;
+    uint8_t le[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    put_tlv(w, tag, le, sizeof(le));
+}
+
+static void put_str(tlv_writer_t *w, uint8_t tag, const char *text, size_t max)
+{
+    size_t len = strnlen(text, max);
+    if (len > 0) {
+        put_tlv(w, tag, text, len);
+    }
+}
+
+static void encode_payload(const wire_record_t *rec, tlv_writer_t *w)
+{
+    switch (rec->type) {
+    case WIRE_TYPE_SCAN_NETWORK: {
+        const wire_scan_network_t *s = &rec->u.scan;
+        put_u16(w, WIRE_TAG_INDEX, s->index);
+        put_str(w, WIRE_TAG_SSID, s->ssid, sizeof(s->ssid) - 1);
+        put_str(w, WIRE_TAG_VENDOR, s->vendor, sizeof(s->vendor) - 1);
+        put_tlv(w, WIRE_TAG_BSSID, s->bssid.b, 6);
+        put_u8(w, WIRE_TAG_CHANNEL, s->channel);
+        put_str(w, WIRE_TAG_SECURITY, s->security, sizeof(s->security) - 1);
+        put_u8(w, WIRE_TAG_RSSI, (uint8_t)s->rssi);
+        put_u8(w, WIRE_TAG_BAND, s->band);
+        break;
+    }
+    case WIRE_TYPE_SNIFFER_AP: {
+        const wire_sniffer_ap_t *s = &rec->u.sniffer;
+        put_str(w, WIRE_TAG_SSID, s->ssid, sizeof(s->ssid) - 1);
+        put_u8(w, WIRE_TAG_CHANNEL, s->channel);
+        put_u16(w, WIRE_TAG_CLIENT_COUNT, s->client_count);
+        for (uint8_t i = 0; i < s->clients_listed && i < WIRE_SNIFFER_CLIENTS_MAX; i++) {
+            put_tlv(w, WIRE_TAG_CLIENT, s->clients[i].b, 6);
+        }
+        break;
+    }
+    case WIRE_TYPE_BT_DEVICE: {
+        const wire_bt_device_t *s = &rec->u.bt;
+        put_u16(w, WIRE_TAG_INDEX, s->index);
+        put_tlv(w, WIRE_TAG_BSSID, s->mac.b, 6);
+        put_u8(w, WIRE_TAG_RSSI, (uint8_t)s->rssi);
+        put_str(w, WIRE_TAG_NAME, s->name, sizeof(s->name) - 1);
+        break;
+    }
+    case WIRE_TYPE_WARDRIVE: {
+        const wire_wardrive_t *s = &rec->u.wardrive;
+        put_tlv(w, WIRE_TAG_BSSID, s->bssid.b, 6);
+        put_str(w, WIRE_TAG_SSID, s->ssid, sizeof(s->ssid) - 1);
+        put_str(w, WIRE_TAG_SECURITY, s->auth, sizeof(s->auth) - 1);
+        put_str(w, WIRE_TAG_FIRST_SEEN, s->first_seen, sizeof(s->first_seen) - 1);
+        put_u8(w, WIRE_TAG_CHANNEL, s->channel);
+        put_u8(w, WIRE_TAG_RSSI, (uint8_t)s->rssi);
+        put_i32(w, WIRE_TAG_LAT, s->lat_e7);
+        put_i32(w, WIRE_TAG_LON, s->lon_e7);
+        put_i32(w, WIRE_TAG_ALTITUDE, s->altitude_cm);
+        put_i32(w, WIRE_TAG_ACCURACY, s->accuracy_cm);
+        break;
+    }
+    case WIRE_TYPE_TEXT:
+        put_str(w, WIRE_TAG_TEXT, rec->u.text, 255);
+        break;
+    default:
+        w->overflow = true;
+        break;
+    }
+}
+
+size_t wire_encode_record(const wire_record_t *rec, uint8_t seq, uint8_t *out, size_t cap)
+{
+    if (!rec || !out || cap < WIRE_HEADER_SIZE + WIRE_CRC_SIZE) {
+        return 0;
+    }
+
+    size_t room = cap - WIRE_HEADER_SIZE - WIRE_CRC_SIZE;
+    tlv_writer_t w = {
+        .buf = out + WIRE_HEADER_SIZE,
+        .cap = room < WIRE_PAYLOAD_MAX ? room : WIRE_PAYLOAD_MAX,
+    };
+    encode_payload(rec, &w);
+    if (w.overflow) {
+        return 0;
+    }
+
+    out[0] = WIRE_SOF0;
+    out[1] = WIRE_SOF1;
+    out[2] = rec->type;
+    out[3] = seq;
+    out[4] = (uint8_t)w.len;
+    out[5] = (uint8_t)(w.len >> 8);
+    uint16_t crc = wire_crc16(0xFFFF, out + 2, WIRE_HEADER_SIZE - 2 + w.len);
+    out[WIRE_HEADER_SIZE + w.len] = (uint8_t)crc;
+    out[WIRE_HEADER_SIZE + w.len + 1] = (uint8_t)(crc >> 8);
+    return WIRE_HEADER_SIZE + w.len + WIRE_CRC_SIZE;
+}
+
+//==================================================================================
+// Decoding
+//==================================================================================
+
+static void get_str(char *dst, size_t dst_size, const uint8_t *value, size_t len)
+{
+    if (len >= dst_size) {
+        len = dst_size - 1;
+    }
+    memcpy(dst, value, len);
+    dst[len] = '\0';
+}
+
+static uint32_t get_le(const uint8_t *value, size_t len)
+{
+    uint32_t v = 0;
+    for (size_t i = len; i > 0; i--) {
+        v = (v << 8) | value[i - 1];
+    }
+    return v;
+}
+
+// Fixed-size fields with the wrong length are ignored like unknown tags
+static void decode_field(wire_record_t *out, uint8_t tag, const uint8_t *value, size_t len)
+{
+    switch (out->type) {
+    case WIRE_TYPE_SCAN_NETWORK: {
+        wire_scan_network_t *s = &out->u.scan;
+        if (tag == WIRE_TAG_INDEX && len == 2) s->index = (uint16_t)get_le(value, 2);
+        else if (tag == WIRE_TAG_SSID) get_str(s->ssid, sizeof(s->ssid), value, len);
+        else if (tag == WIRE_TAG_VENDOR) get_str(s->vendor, sizeof(s->vendor), value, len);
+        else if (tag == WIRE_TAG_BSSID && len == 6) memcpy(s->bssid.b, value, 6);
+        else if (tag == WIRE_TAG_CHANNEL && len == 1) s->channel = value[0];
+        else if (tag == WIRE_TAG_SECURITY) get_str(s->security, sizeof(s->security), value, len);
+        else if (tag == WIRE_TAG_RSSI && len == 1) s->rssi = (int8_t)value[0];
+        else if (tag == WIRE_TAG_BAND && len == 1) s->band = value[0];
+        break;
+    }
+    case WIRE_TYPE_SNIFFER_AP: {
+        wire_sniffer_ap_t *s = &out->u.sniffer;
+        if (tag == WIRE_TAG_SSID) get_str(s->ssid, sizeof(s->ssid), value, len);
+        else if (tag == WIRE_TAG_CHANNEL && len == 1) s->channel = value[0];
+        else if (tag == WIRE_TAG_CLIENT_COUNT && len == 2) s->client_count = (uint16_t)get_le(value, 2);
+        else if (tag == WIRE_TAG_CLIENT && len == 6 && s->clients_listed < WIRE_SNIFFER_CLIENTS_MAX) {
+            memcpy(s->clients[s->clients_listed++].b, value, 6);
+        }
+        break;
+    }
+    case WIRE_TYPE_BT_DEVICE: {
+        wire_bt_device_t *s = &out->u.bt;
+        if (tag == WIRE_TAG_INDEX && len == 2) s->index = (uint16_t)get_le(value, 2);
+        else if (tag == WIRE_TAG_BSSID && len == 6) memcpy(s->mac.b, value, 6);
+        else if (tag == WIRE_TAG_RSSI && len == 1) s->rssi = (int8_t)value[0];
+        else if (tag == WIRE_TAG_NAME) get_str(s->name, sizeof(s->name), value, len);
+        break;
+    }
+    case WIRE_TYPE_WARDRIVE: {
+        wire_wardrive_t *s = &out->u.wardrive;
+        if (tag == WIRE_TAG_BSSID && len == 6) memcpy(s->bssid.b, value, 6);
+        else if (tag == WIRE_TAG_SSID) get_str(s->ssid, sizeof(s->ssid), value, len);
+        else if (tag == WIRE_TAG_SECURITY) get_str(s->auth, sizeof(s->auth), value, len);
+        else if (tag == WIRE_TAG_FIRST_SEEN) get_str(s->first_seen, sizeof(s->first_seen), value, len);
+        else if (tag == WIRE_TAG_CHANNEL && len == 1) s->channel = value[0];
+        else if (tag == WIRE_TAG_RSSI && len == 1) s->rssi = (int8_t)value[0];
+        else if (tag == WIRE_TAG_LAT && len == 4) s->lat_e7 = (int32_t)get_le(value, 4);
+        else if (tag == WIRE_TAG_LON && len == 4) s->lon_e7 = (int32_t)get_le(value, 4);
+        else if (tag == WIRE_TAG_ALTITUDE && len == 4) s->altitude_cm = (int32_t)get_le(value, 4);
+        else if (tag == WIRE_TAG_ACCURACY && len == 4) s->accuracy_cm = (int32_t)get_le(value, 4);
+        break;
+    }
+    case WIRE_TYPE_TEXT:
+        if (tag == WIRE_TAG_TEXT) get_str(out->u.text, sizeof(out->u.text), value, len);
+        break;
+    default:
+        break;
+    }
+}
+
+static bool wire_type_known(uint8_t type)
+{
+    switch (type) {
+    case WIRE_TYPE_TEXT:
+    case WIRE_TYPE_SCAN_NETWORK:
+    case WIRE_TYPE_SNIFFER_AP:
+    case WIRE_TYPE_BT_DEVICE:
+    case WIRE_TYPE_WARDRIVE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool wire_decode_record(uint8_t type, const uint8_t *payload, size_t len, wire_record_t *out)
+{
+    if (!out || (len > 0 && !payload) || !wire_type_known(type)) {
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->type = type;
+    size_t pos = 0;
+    while (pos < len) {
+        if (len - pos < 2 || len - pos - 2 < payload[pos + 1]) {
+            return false;
+        }
+        uint8_t tag = payload[pos];
+        uint8_t field_len = payload[pos + 1];
+        decode_field(out, tag, payload + pos + 2, field_len);
+        pos += 2 + (size_t)field_len;
+    }
+    return true;
+}
+
+//==================================================================================
+// Text rendering
+//==================================================================================
+
+// Append one formatted line only if it fits completely
+static bool __attribute__((format(printf, 4, 5))) append_line(char *out, size_t cap, size_t *len, const char *fmt, ...)
+{
+    if (*len >= cap) {
+        return false;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(out + *len, cap - *len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= cap - *len) {
+        out[*len] = '\0';
+        return false;
+    }
+    *len += (size_t)n;
+    return true;
+}
+
+size_t wire_record_size(const wire_record_t *rec)
+{
+    size_t body;
+    switch (rec->type) {
+    case WIRE_TYPE_SCAN_NETWORK: body = sizeof(rec->u.scan); break;
+    case WIRE_TYPE_SNIFFER_AP: {
+        size_t listed = rec->u.sniffer.clients_listed;
+        if (listed > WIRE_SNIFFER_CLIENTS_MAX) {
+            listed = WIRE_SNIFFER_CLIENTS_MAX;
+        }
+        body = offsetof(wire_sniffer_ap_t, clients) + listed * sizeof(mac48_t);
+        break;
+    }
+    case WIRE_TYPE_BT_DEVICE: body = sizeof(rec->u.bt); break;
+    case WIRE_TYPE_WARDRIVE: body = sizeof(rec->u.wardrive); break;
+    default: body = sizeof(rec->u); break;
+    }
+    return offsetof(wire_record_t, u) + body;
+}
+
+const char *wire_band_text(uint8_t band)
+{
+    switch (band) {
+    case WIRE_BAND_5G: return "5GHz";
+    case WIRE_BAND_6G: return "6GHz";
+    default: return "2.4GHz";
+    }
+}
+
+size_t wire_record_to_text(const wire_record_t *rec, char *out, size_t cap)
+{
+    if (!rec || !out || cap == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    size_t len = 0;
+
+    switch (rec->type) {
+    case WIRE_TYPE_SCAN_NETWORK: {
+        // "1","SSID","","c4:2b:44:12:29:21","1","WPA2","-53","2.4GHz", MACs as the board's MACSTR
+        const wire_scan_network_t *s = &rec->u.scan;
+        append_line(out, cap, &len, "\"%u\",\"%s\",\"%s\",\"" MAC48_FMT "\",\"%u\",\"%s\",\"%d\",\"%s\"\n",
+                    s->index, s->ssid, s->vendor, MAC48_ARGS(s->bssid), s->channel, s->security, s->rssi,
+                    wire_band_text(s->band));
+        break;
+    }
+    case WIRE_TYPE_SNIFFER_AP: {
+        // "SSID, CH6: 2" followed by one " aa:bb:cc:dd:ee:ff" line per client
+        const wire_sniffer_ap_t *s = &rec->u.sniffer;
+        if (append_line(out, cap, &len, "%s, CH%u: %u\n", s->ssid, s->channel, s->client_count)) {
+            for (uint8_t i = 0; i < s->clients_listed; i++) {
+                if (!append_line(out, cap, &len, " " MAC48_FMT "\n", MAC48_ARGS(s->clients[i]))) {
+                    break;
+                }
+            }
+        }
+        break;
+    }
+    case WIRE_TYPE_BT_DEVICE: {
+        // "  N. XX:XX:XX:XX:XX:XX  RSSI: X dBm  Name: optional"
+        const wire_bt_device_t *s = &rec->u.bt;
+        append_line(out, cap, &len, "  %u. " MAC48_FMT "  RSSI: %d dBm%s%s\n", s->index, MAC48_ARGS(s->mac), s->rssi,
+                    s->name[0] ? "  Name: " : "", s->name);
+        break;
+    }
+    case WIRE_TYPE_WARDRIVE: {
+        // BSSID,SSID,[AUTH],first_seen,channel,rssi,lat,lon,alt,acc,WIFI
+        const wire_wardrive_t *s = &rec->u.wardrive;
+        append_line(out, cap, &len, MAC48_FMT ",%s,%s,%s,%u,%d,%.7f,%.7f,%.2f,%.2f,WIFI\n",
+                    MAC48_ARGS(s->bssid), s->ssid, s->auth, s->first_seen, s->channel, s->rssi,
+                    s->lat_e7 / 1e7, s->lon_e7 / 1e7, s->altitude_cm / 100.0, s->accuracy_cm / 100.0);
+        break;
+    }
+    case WIRE_TYPE_TEXT:
+        append_line(out, cap, &len, "%s\n", rec->u.text);
+        break;
+    default:
+        break;
+    }
+    return len;
+}
+
+//==================================================================================
+// Receive filter
+//==================================================================================
+
+void wire_rx_init(wire_rx_t *rx)
+{
+    memset(rx, 0, sizeof(*rx));
+}
+
+void wire_rx_set_record_fn(wire_rx_t *rx, wire_record_fn_t fn, void *ctx)
+{
+    rx->record_fn = fn;
+    rx->record_ctx = ctx;
+}
+
+// Hand the start marker of a broken frame on as text and scan the bytes after it again
+static void frame_fail(wire_rx_t *rx)
+{
+    size_t keep = rx->frame_len;
+    size_t rest = rx->replay_len - rx->replay_pos;
+    // frame_len never exceeds replay_pos, so the unread replay bytes sit after the frame
+    memmove(rx->frame + keep, rx->frame + rx->replay_pos, rest);
+    rx->replay_pos = 0;
+    rx->replay_len = keep + rest;
+    rx->replay_literal = true;
+    rx->frame_len = 0;
+    rx->frame_need = 0;
+}
+
+static void frame_complete(wire_rx_t *rx)
+{
+    size_t need = rx->frame_need;
+    uint16_t crc = wire_crc16(0xFFFF, rx->frame + 2, need - 2 - WIRE_CRC_SIZE);
+    uint16_t sent = (uint16_t)(rx->frame[need - 2] | (rx->frame[need - 1] << 8));
+    if (crc != sent) {
+        rx->stats.crc_errors++;
+        frame_fail(rx);
+        return;
+    }
+
+    uint8_t type = rx->frame[2];
+    uint8_t seq = rx->frame[3];
+    rx->stats.frames++;
+    rx->stats.frame_bytes += (uint32_t)need;
+    if (rx->have_seq && seq != rx->next_seq) {
+        rx->stats.lost_frames += (uint8_t)(seq - rx->next_seq);
+    }
+    rx->have_seq = true;
+    rx->next_seq = (uint8_t)(seq + 1);
+
+    if (wire_decode_record(type, rx->frame + WIRE_HEADER_SIZE, need - WIRE_HEADER_SIZE - WIRE_CRC_SIZE, &rx->record)) {
+        if (rx->record_fn) {
+            rx->record_ready = true;
+        } else {
+            rx->pending_len = wire_record_to_text(&rx->record, rx->pending, sizeof(rx->pending));
+            rx->pending_pos = 0;
+        }
+    } else {
+        rx->stats.bad_frames++;
+    }
+    rx->frame_len = 0;
+    rx->frame_need = 0;
+}
+
+size_t wire_rx_process(wire_rx_t *rx, const uint8_t *in, size_t len, size_t *used, uint8_t *out, size_t cap)
+{
+    size_t produced = 0;
+    size_t pos = 0;
+
+    for (;;) {
+        // Rendered records go out before anything that followed them on the wire
+        if (rx->pending_pos < rx->pending_len) {
+            size_t n = rx->pending_len - rx->pending_pos;
+            if (n > cap - produced) {
+                n = cap - produced;
+            }
+            memcpy(out + produced, rx->pending + rx->pending_pos, n);
+            produced += n;
+            rx->pending_pos += n;
+            if (rx->pending_pos < rx->pending_len) {
+                break;
+            }
+        }
+
+        if (rx->record_ready) {
+            // Text that came before the record has to reach the reader first
+            if (produced > 0) {
+                break;
+            }
+            rx->record_ready = false;
+            if (rx->record_fn(rx->record_ctx, &rx->record)) {
+                rx->stats.records++;
+            } else {
+                rx->pending_len = wire_record_to_text(&rx->record, rx->pending, sizeof(rx->pending));
+                rx->pending_pos = 0;
+            }
+            continue;
+        }
+
+        bool replaying = rx->replay_pos < rx->replay_len;
+        uint8_t b;
+        if (replaying) {
+            b = rx->frame[rx->replay_pos];
+        } else if (pos < len) {
+            b = in[pos];
+        } else {
+            break;
+        }
+
+        if (rx->frame_len == 0) {
+            if (b != WIRE_SOF0 || (replaying && rx->replay_pos == 0 && rx->replay_literal)) {
+                if (produced == cap) {
+                    break;
+                }
+                if (replaying) {
+                    out[produced++] = b;
+                    rx->replay_pos++;
+                    rx->replay_literal = false;
+                    rx->stats.text_bytes++;
+                } else {
+                    // Plain text: copy up to the next possible start marker in one go
+                    const uint8_t *sof = memchr(in + pos, WIRE_SOF0, len - pos);
+                    size_t n = (sof ? (size_t)(sof - in) : len) - pos;
+                    if (n > cap - produced) {
+                        n = cap - produced;
+                    }
+                    memcpy(out + produced, in + pos, n);
+                    produced += n;
+                    pos += n;
+                    rx->stats.text_bytes += (uint32_t)n;
+                }
+                continue;
+            }
+        } else if (rx->frame_len == 1 && b != WIRE_SOF1) {
+            // A lone 0xA5 is text (e.g. inside a UTF-8 SSID); b is looked at again below
+            if (produced == cap) {
+                break;
+            }
+            out[produced++] = WIRE_SOF0;
+            rx->stats.text_bytes++;
+            rx->frame_len = 0;
+            continue;
+        }
+
+        if (!replaying && rx->frame_need > 0) {
+            // Header known: take the rest of the frame in one copy
+            size_t n = rx->frame_need - rx->frame_len;
+            if (n > len - pos) {
+                n = len - pos;
+            }
+            memcpy(rx->frame + rx->frame_len, in + pos, n);
+            rx->frame_len += n;
+            pos += n;
+        } else {
+            rx->frame[rx->frame_len++] = b;
+            if (replaying) {
+                rx->replay_pos++;
+            } else {
+                pos++;
+            }
+        }
+
+        if (rx->frame_len == 3 && !wire_type_known(rx->frame[2])) {
+            // Cheap early reject, so "A5 5A" inside text does not hold back the lines after it
+            frame_fail(rx);
+            continue;
+        }
+        if (rx->frame_len == WIRE_HEADER_SIZE) {
+            size_t payload_len = (size_t)rx->frame[4] | ((size_t)rx->frame[5] << 8);
+            if (payload_len > WIRE_PAYLOAD_MAX) {
+                rx->stats.bad_frames++;
+                frame_fail(rx);
+                continue;
+            }
+            rx->frame_need = WIRE_HEADER_SIZE + payload_len + WIRE_CRC_SIZE;
+        }
+        if (rx->frame_need > 0 && rx->frame_len == rx->frame_need) {
+            frame_complete(rx);
+        }
+        if (rx->replay_pos == rx->replay_len) {
+            rx->replay_pos = 0;
+            rx->replay_len = 0;
+        }
+    }
+
+    if (used) {
+        *used = pos;
+    }
+    return produced;
+}
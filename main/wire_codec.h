@@ -0,0 +1,194 @@
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mac48.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Framed binary records between the Tab5 and a JanOS board ("wire v1").
+ *
+ *     A5 5A | type | seq | len (u16 LE) | payload[len] | CRC-16 (LE)
+ *
+ * The CRC (CCITT-FALSE) covers type, seq, len and payload. seq counts up
+ * per frame and wraps; a jump is counted as lost frames. The payload is a
+ * TLV list (tag u8, len u8, value), integers little endian, strings
+ * without terminator. Unknown tags are skipped, so fields can be added
+ * without bumping the version.
+ *
+ * Text stays the default. A board that speaks the protocol appends
+ * "wire=<version>" to its pong; the Tab5 then sends "wire <version>" and
+ * the board starts framing scan results, sniffer updates, BT devices and
+ * wardrive rows. Everything else stays text, so the receive filter passes
+ * plain bytes through and only takes out frames. A record handler can take
+ * decoded records as they are; whatever it declines is rendered as the text
+ * lines the board would otherwise have sent, so consumers that only read
+ * text keep working in either mode.
+ *
+ * No RTOS dependencies; the same code builds for host tests.
+ */
+
+#define WIRE_VERSION            1
+#define WIRE_PONG_CAPABILITY    "wire="
+#define WIRE_SOF0               0xA5
+#define WIRE_SOF1               0x5A
+#define WIRE_HEADER_SIZE        6
+#define WIRE_CRC_SIZE           2
+#define WIRE_PAYLOAD_MAX        1024
+#define WIRE_FRAME_MAX          (WIRE_HEADER_SIZE + WIRE_PAYLOAD_MAX + WIRE_CRC_SIZE)
+#define WIRE_TEXT_MAX           2048    // rendered text of one frame
+#define WIRE_SNIFFER_CLIENTS_MAX 64
+
+typedef enum {
+    WIRE_TYPE_TEXT          = 0x01,     // one text line, for boards that frame everything
+    WIRE_TYPE_SCAN_NETWORK  = 0x10,
+    WIRE_TYPE_SNIFFER_AP    = 0x11,
+    WIRE_TYPE_BT_DEVICE     = 0x12,
+    WIRE_TYPE_WARDRIVE      = 0x13,
+} wire_type_t;
+
+typedef enum {
+    WIRE_TAG_INDEX          = 0x01,     // u16
+    WIRE_TAG_SSID           = 0x02,     // string, up to 32
+    WIRE_TAG_BSSID          = 0x03,     // 6 bytes
+    WIRE_TAG_CHANNEL        = 0x04,     // u8
+    WIRE_TAG_SECURITY       = 0x05,     // string
+    WIRE_TAG_RSSI           = 0x06,     // i8
+    WIRE_TAG_BAND           = 0x07,     // u8, wire_band_t
+    WIRE_TAG_VENDOR         = 0x08,     // string
+    WIRE_TAG_CLIENT         = 0x09,     // 6 bytes, repeated
+    WIRE_TAG_CLIENT_COUNT   = 0x0A,     // u16
+    WIRE_TAG_NAME           = 0x0B,     // string
+    WIRE_TAG_FIRST_SEEN     = 0x0C,     // string, "YYYY-MM-DD HH:MM:SS"
+    WIRE_TAG_LAT            = 0x0D,     // i32, 1e-7 degrees
+    WIRE_TAG_LON            = 0x0E,     // i32, 1e-7 degrees
+    WIRE_TAG_ALTITUDE       = 0x0F,     // i32, centimetres
+    WIRE_TAG_ACCURACY       = 0x10,     // i32, centimetres
+    WIRE_TAG_TEXT           = 0x11,     // string
+} wire_tag_t;
+
+typedef enum {
+    WIRE_BAND_2G4 = 0,
+    WIRE_BAND_5G = 1,
+    WIRE_BAND_6G = 2,
+} wire_band_t;
+
+typedef struct {
+    uint16_t index;
+    char ssid[33];
+    char vendor[24];
+    mac48_t bssid;
+    uint8_t channel;
+    char security[24];
+    int8_t rssi;
+    uint8_t band;
+} wire_scan_network_t;
+
+typedef struct {
+    char ssid[33];
+    uint8_t channel;
+    uint16_t client_count;          // as reported, may exceed the listed clients
+    uint8_t clients_listed;
+    mac48_t clients[WIRE_SNIFFER_CLIENTS_MAX];
+} wire_sniffer_ap_t;
+
+typedef struct {
+    uint16_t index;
+    mac48_t mac;
+    int8_t rssi;
+    char name[64];
+} wire_bt_device_t;
+
+typedef struct {
+    mac48_t bssid;
+    char ssid[33];
+    char auth[32];
+    char first_seen[20];
+    uint8_t channel;
+    int8_t rssi;
+    int32_t lat_e7;
+    int32_t lon_e7;
+    int32_t altitude_cm;
+    int32_t accuracy_cm;
+} wire_wardrive_t;
+
+typedef struct {
+    uint8_t type;                   // wire_type_t
+    union {
+        wire_scan_network_t scan;
+        wire_sniffer_ap_t sniffer;
+        wire_bt_device_t bt;
+        wire_wardrive_t wardrive;
+        char text[256];
+    } u;
+} wire_record_t;
+
+uint16_t wire_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+// Frame a record. Returns the frame size, 0 if it does not fit into cap.
+size_t wire_encode_record(const wire_record_t *rec, uint8_t seq, uint8_t *out, size_t cap);
+// Decode a frame payload. false for unknown types; missing fields stay zero.
+bool wire_decode_record(uint8_t type, const uint8_t *payload, size_t len, wire_record_t *out);
+// Leading bytes of rec that hold its type's fields, e.g. to copy it into a queue.
+size_t wire_record_size(const wire_record_t *rec);
+// "2.4GHz", "5GHz" or "6GHz", as in the text output.
+const char *wire_band_text(uint8_t band);
+// Render the text line(s) the board sends for this record in text mode, '\n' terminated.
+// Returns the length written (truncated to whole lines), 0 if nothing fits.
+size_t wire_record_to_text(const wire_record_t *rec, char *out, size_t cap);
+
+typedef struct {
+    uint32_t frames;
+    uint32_t frame_bytes;
+    uint32_t text_bytes;            // passed through unframed
+    uint32_t crc_errors;
+    uint32_t bad_frames;            // oversized, or valid CRC with a malformed payload
+    uint32_t lost_frames;           // sequence gaps
+    uint32_t records;               // taken by the record handler, not rendered
+} wire_rx_stats_t;
+
+// Takes a decoded record; return false to have it rendered as text instead.
+typedef bool (*wire_record_fn_t)(void *ctx, const wire_record_t *rec);
+
+/*
+ * Receive filter: split a byte stream into pass-through text and frames.
+ * When a frame fails its checks, its start marker is passed on as text and
+ * the bytes after it are scanned again, so text that merely looked like a
+ * frame survives and a frame hidden in the garbage is still found.
+ */
+typedef struct {
+    uint8_t frame[WIRE_FRAME_MAX];
+    size_t frame_len;
+    size_t frame_need;              // total size once the header is known, 0 before
+    size_t replay_pos;              // bytes of frame[] still to rescan after an error
+    size_t replay_len;
+    bool replay_literal;            // first replayed byte is the failed start marker, pass it as text
+    char pending[WIRE_TEXT_MAX];    // rendered text not yet handed out
+    size_t pending_len;
+    size_t pending_pos;
+    bool have_seq;
+    uint8_t next_seq;
+    wire_record_t record;
+    bool record_ready;              // record waits for the text before it to be handed out
+    wire_record_fn_t record_fn;
+    void *record_ctx;
+    wire_rx_stats_t stats;
+} wire_rx_t;
+
+void wire_rx_init(wire_rx_t *rx);
+// Called from wire_rx_process() for each decoded record, in stream order with the text.
+void wire_rx_set_record_fn(wire_rx_t *rx, wire_record_fn_t fn, void *ctx);
+// Filter in[0..len) into out. *used is set to the input bytes consumed, which is less
+// than len only when out filled up. Returns the bytes written to out.
+size_t wire_rx_process(wire_rx_t *rx, const uint8_t *in, size_t len, size_t *used, uint8_t *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
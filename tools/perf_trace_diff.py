@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Compare two timeline traces exported by the firmware (Chrome trace JSON,
+/sdcard/PERF on the device: boot.json, boot_prev.json, perf_*.json).
+
+Spans are matched by name. For each name the script prints the total time
+in both traces, the call count and the difference; markers such as
+"interactive" are compared by the time they were reached. Use --fail-above
+to turn regressions into a non-zero exit code.
+
+Usage:
+    python tools/perf_trace_diff.py boot_prev.json boot.json [--min-ms 1] [--fail-above 10]
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("before", type=Path, help="Baseline trace")
+    parser.add_argument("after", type=Path, help="Trace to compare against the baseline")
+    parser.add_argument(
+        "--min-ms",
+        type=float,
+        default=0.5,
+        help="Hide spans below this total in both traces (default: 0.5)",
+    )
+    parser.add_argument(
+        "--fail-above",
+        type=float,
+        metavar="PERCENT",
+        help="Exit with 1 if a span or marker got slower by more than this",
+    )
+    return parser.parse_args()
+
+
+def load_trace(path: Path) -> dict:
+    with path.open(encoding="utf-8") as f:
+        data = json.load(f)
+    if isinstance(data, list):
+        data = {"traceEvents": data}
+
+    spans = {}
+    markers = {}
+    for event in data.get("traceEvents", []):
+        name = event.get("name", "?")
+        if event.get("ph") == "X":
+            total, count = spans.get(name, (0.0, 0))
+            spans[name] = (total + event.get("dur", 0) / 1000.0, count + 1)
+        elif event.get("ph") in ("i", "I"):
+            # The first time a marker is reached is the one that matters
+            ts = event.get("ts", 0) / 1000.0
+            markers[name] = min(ts, markers.get(name, ts))
+    return {"spans": spans, "markers": markers, "meta": data.get("otherData", {})}
+
+
+def describe(path: Path, trace: dict) -> str:
+    meta = trace["meta"]
+    parts = [str(path)]
+    if meta.get("version"):
+        parts.append(f"version {meta['version']}")
+    if meta.get("label"):
+        parts.append(meta["label"])
+    if meta.get("recorded", 0) > meta.get("exported", 0):
+        parts.append(f"ring wrapped: {meta['exported']} of {meta['recorded']} spans")
+    return ", ".join(parts)
+
+
+def percent(before: float, after: float) -> float:
+    if before <= 0:
+        return 0.0 if after <= 0 else float("inf")
+    return (after - before) * 100.0 / before
+
+
+def format_row(name: str, before, after, count_before: str, count_after: str) -> tuple:
+    b = "-" if before is None else f"{before:.1f}"
+    a = "-" if after is None else f"{after:.1f}"
+    if before is None or after is None:
+        delta = "new" if before is None else "gone"
+        pct = ""
+    else:
+        delta = f"{after - before:+.1f}"
+        p = percent(before, after)
+        pct = "" if p == float("inf") else f"{p:+.0f}%"
+    return (name, b, a, delta, pct, f"{count_before}/{count_after}")
+
+
+def print_table(title: str, header: tuple, rows: list) -> None:
+    if not rows:
+        return
+    widths = [max(len(str(row[i])) for row in rows + [header]) for i in range(len(header))]
+    print(f"\n{title}")
+    line = "  ".join(str(h).rjust(w) if i else str(h).ljust(w) for i, (h, w) in enumerate(zip(header, widths)))
+    print(line)
+    print("-" * len(line))
+    for row in rows:
+        print("  ".join(str(c).rjust(w) if i else str(c).ljust(w) for i, (c, w) in enumerate(zip(row, widths))))
+
+
+def main() -> int:
+    args = parse_args()
+    try:
+        before = load_trace(args.before)
+        after = load_trace(args.after)
+    except (OSError, ValueError) as exc:
+        print(f"Failed to read trace: {exc}", file=sys.stderr)
+        return 2
+
+    print(f"before: {describe(args.before, before)}")
+    print(f"after:  {describe(args.after, after)}")
+
+    regressions = []
+
+    span_rows = []
+    names = set(before["spans"]) | set(after["spans"])
+    for name in names:
+        b_total, b_count = before["spans"].get(name, (None, 0))
+        a_total, a_count = after["spans"].get(name, (None, 0))
+        if max(b_total or 0, a_total or 0) < args.min_ms:
+            continue
+        delta = (a_total or 0) - (b_total or 0)
+        span_rows.append((abs(delta), format_row(name, b_total, a_total, str(b_count), str(a_count))))
+        if args.fail_above is not None and b_total and a_total and percent(b_total, a_total) > args.fail_above:
+            regressions.append(name)
+    span_rows.sort(key=lambda r: r[0], reverse=True)
+    print_table("Spans (total ms, largest change first)",
+                ("span", "before", "after", "delta", "", "calls"), [r[1] for r in span_rows])
+
+    marker_rows = []
+    names = set(before["markers"]) | set(after["markers"])
+    for name in sorted(names, key=lambda n: after["markers"].get(n, before["markers"].get(n, 0))):
+        b_ts = before["markers"].get(name)
+        a_ts = after["markers"].get(name)
+        marker_rows.append(format_row(name, b_ts, a_ts, "1" if b_ts is not None else "0",
+                                      "1" if a_ts is not None else "0"))
+        if args.fail_above is not None and b_ts and a_ts and percent(b_ts, a_ts) > args.fail_above:
+            regressions.append(name)
+    print_table("Markers (ms after reset)", ("marker", "before", "after", "delta", "", "seen"), marker_rows)
+
+    if regressions:
+        print(f"\nSlower by more than {args.fail_above:g}%: {', '.join(sorted(regressions))}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())